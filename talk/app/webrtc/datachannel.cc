@@ -27,6 +27,7 @@
 
 #include "talk/app/webrtc/datachannel.h"
 
+#include <algorithm>
 #include <string>
 
 #include "talk/app/webrtc/mediastreamprovider.h"
@@ -39,11 +40,28 @@ namespace webrtc {
 
 static size_t kMaxQueuedReceivedDataBytes = 16 * 1024 * 1024;
 static size_t kMaxQueuedSendDataBytes = 16 * 1024 * 1024;
+// The number of queued messages handed to the provider at once, to send them
+// with one hop to the worker thread.
+static const size_t kMaxSendBatchSize = 64;
+static const size_t kInitialPacketQueueCapacity = 16;
 
 enum {
   MSG_CHANNELREADY,
 };
 
+size_t DataChannelProviderInterface::SendDataBatch(
+    const std::vector<cricket::SendDataParams>& params,
+    const std::vector<const rtc::Buffer*>& payloads,
+    cricket::SendDataResult* result) {
+  ASSERT(params.size() == payloads.size());
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    if (!SendData(params[i], *payloads[i], result)) {
+      return i;
+    }
+  }
+  return payloads.size();
+}
+
 bool SctpSidAllocator::AllocateSid(rtc::SSLRole role, int* sid) {
   int potential_sid = (role == rtc::SSL_CLIENT) ? 0 : 1;
   while (!IsSidAvailable(potential_sid)) {
@@ -80,48 +98,68 @@ bool SctpSidAllocator::IsSidAvailable(int sid) const {
   return used_sids_.find(sid) == used_sids_.end();
 }
 
-DataChannel::PacketQueue::PacketQueue() : byte_count_(0) {}
-
-DataChannel::PacketQueue::~PacketQueue() {
-  Clear();
-}
+DataChannel::PacketQueue::PacketQueue()
+    : head_(0), size_(0), byte_count_(0) {}
 
 bool DataChannel::PacketQueue::Empty() const {
-  return packets_.empty();
+  return size_ == 0;
 }
 
-DataBuffer* DataChannel::PacketQueue::Front() {
-  return packets_.front();
+DataBuffer* DataChannel::PacketQueue::At(size_t index) {
+  ASSERT(index < size_);
+  return &packets_[(head_ + index) & (packets_.size() - 1)];
 }
 
 void DataChannel::PacketQueue::Pop() {
-  if (packets_.empty()) {
+  if (size_ == 0) {
     return;
   }
 
-  byte_count_ -= packets_.front()->size();
-  packets_.pop_front();
+  DataBuffer* packet = Front();
+  byte_count_ -= packet->size();
+  packet->data.Clear();
+  head_ = (head_ + 1) & (packets_.size() - 1);
+  --size_;
 }
 
 void DataChannel::PacketQueue::Push(DataBuffer* packet) {
-  byte_count_ += packet->size();
-  packets_.push_back(packet);
+  if (size_ == packets_.size()) {
+    Grow();
+  }
+  ++size_;
+  DataBuffer* back = At(size_ - 1);
+  back->data = packet->data.Pass();
+  back->binary = packet->binary;
+  packet->data.Clear();
+  byte_count_ += back->size();
 }
 
 void DataChannel::PacketQueue::Clear() {
-  while (!packets_.empty()) {
-    delete packets_.front();
-    packets_.pop_front();
+  while (size_ > 0) {
+    Pop();
   }
   byte_count_ = 0;
 }
 
 void DataChannel::PacketQueue::Swap(PacketQueue* other) {
-  size_t other_byte_count = other->byte_count_;
-  other->byte_count_ = byte_count_;
-  byte_count_ = other_byte_count;
+  std::swap(head_, other->head_);
+  std::swap(size_, other->size_);
+  std::swap(byte_count_, other->byte_count_);
+  packets_.swap(other->packets_);
+}
 
-  other->packets_.swap(packets_);
+void DataChannel::PacketQueue::Grow() {
+  const size_t capacity = packets_.empty() ? kInitialPacketQueueCapacity
+                                           : 2 * packets_.size();
+  std::vector<DataBuffer> packets;
+  packets.reserve(capacity);
+  for (size_t i = 0; i < size_; ++i) {
+    DataBuffer* packet = At(i);
+    packets.push_back(DataBuffer(packet->data.Pass(), packet->binary));
+  }
+  packets.resize(capacity, DataBuffer(rtc::Buffer(), false));
+  packets_.swap(packets);
+  head_ = 0;
 }
 
 rtc::scoped_refptr<DataChannel> DataChannel::Create(
@@ -152,7 +190,8 @@ DataChannel::DataChannel(
       receive_ssrc_set_(false),
       writable_(false),
       send_ssrc_(0),
-      receive_ssrc_(0) {
+      receive_ssrc_(0),
+      buffered_amount_low_threshold_(0) {
 }
 
 bool DataChannel::Init(const InternalDataChannelInit& config) {
@@ -234,6 +273,10 @@ uint64_t DataChannel::buffered_amount() const {
   return queued_send_data_.byte_count();
 }
 
+void DataChannel::set_buffered_amount_low_threshold(uint64_t threshold) {
+  buffered_amount_low_threshold_ = threshold;
+}
+
 void DataChannel::Close() {
   if (state_ == kClosed)
     return;
@@ -244,6 +287,15 @@ void DataChannel::Close() {
 }
 
 bool DataChannel::Send(const DataBuffer& buffer) {
+  return SendOrQueue(buffer, NULL);
+}
+
+bool DataChannel::TakeAndSend(DataBuffer* buffer) {
+  return SendOrQueue(*buffer, buffer);
+}
+
+bool DataChannel::SendOrQueue(const DataBuffer& buffer,
+                              DataBuffer* owned_buffer) {
   if (state_ != kOpen) {
     return false;
   }
@@ -261,13 +313,13 @@ bool DataChannel::Send(const DataBuffer& buffer) {
     // Only SCTP DataChannel queues the outgoing data when the transport is
     // blocked.
     ASSERT(data_channel_type_ == cricket::DCT_SCTP);
-    if (!QueueSendDataMessage(buffer)) {
+    if (!QueueSendDataMessage(buffer, owned_buffer)) {
       Close();
     }
     return true;
   }
 
-  bool success = SendDataMessage(buffer, true);
+  bool success = SendDataMessage(buffer, owned_buffer, true);
   if (data_channel_type_ == cricket::DCT_RTP) {
     return success;
   }
@@ -341,7 +393,7 @@ void DataChannel::OnMessage(rtc::Message* msg) {
 
 void DataChannel::OnDataReceived(cricket::DataChannel* channel,
                                  const cricket::ReceiveDataParams& params,
-                                 const rtc::Buffer& payload) {
+                                 rtc::Buffer* payload) {
   uint32_t expected_ssrc =
       (data_channel_type_ == cricket::DCT_RTP) ? receive_ssrc_ : config_.id;
   if (params.ssrc != expected_ssrc) {
@@ -356,7 +408,7 @@ void DataChannel::OnDataReceived(cricket::DataChannel* channel,
                       << "sid = " << params.ssrc;
       return;
     }
-    if (ParseDataChannelOpenAckMessage(payload)) {
+    if (ParseDataChannelOpenAckMessage(*payload)) {
       // We can send unordered as soon as we receive the ACK message.
       handshake_state_ = kHandshakeReady;
       LOG(LS_INFO) << "DataChannel received OPEN_ACK message, sid = "
@@ -380,11 +432,14 @@ void DataChannel::OnDataReceived(cricket::DataChannel* channel,
   }
 
   bool binary = (params.type == cricket::DMT_BINARY);
-  rtc::scoped_ptr<DataBuffer> buffer(new DataBuffer(payload, binary));
+  // This is the only channel with this ssrc, so take the payload instead of
+  // copying it.
+  DataBuffer buffer(payload->Pass(), binary);
+  payload->Clear();
   if (state_ == kOpen && observer_) {
-    observer_->OnMessage(*buffer.get());
+    observer_->OnMessage(buffer);
   } else {
-    if (queued_received_data_.byte_count() + payload.size() >
+    if (queued_received_data_.byte_count() + buffer.size() >
         kMaxQueuedReceivedDataBytes) {
       LOG(LS_ERROR) << "Queued received data exceeds the max buffer size.";
 
@@ -395,7 +450,7 @@ void DataChannel::OnDataReceived(cricket::DataChannel* channel,
 
       return;
     }
-    queued_received_data_.Push(buffer.release());
+    queued_received_data_.Push(&buffer);
   }
 }
 
@@ -511,8 +566,7 @@ void DataChannel::DeliverQueuedReceivedData() {
   }
 
   while (!queued_received_data_.Empty()) {
-    rtc::scoped_ptr<DataBuffer> buffer(queued_received_data_.Front());
-    observer_->OnMessage(*buffer);
+    observer_->OnMessage(*queued_received_data_.Front());
     queued_received_data_.Pop();
   }
 }
@@ -525,23 +579,41 @@ void DataChannel::SendQueuedDataMessages() {
   ASSERT(state_ == kOpen || state_ == kClosing);
 
   uint64_t start_buffered_amount = buffered_amount();
+  std::vector<cricket::SendDataParams> params;
+  std::vector<const rtc::Buffer*> payloads;
   while (!queued_send_data_.Empty()) {
-    DataBuffer* buffer = queued_send_data_.Front();
-    if (!SendDataMessage(*buffer, false)) {
-      // Leave the message in the queue if sending is aborted.
+    const size_t batch_size =
+        std::min(queued_send_data_.size(), kMaxSendBatchSize);
+    params.clear();
+    payloads.clear();
+    for (size_t i = 0; i < batch_size; ++i) {
+      const DataBuffer* buffer = queued_send_data_.At(i);
+      params.push_back(GetSendDataParams(*buffer));
+      payloads.push_back(&buffer->data);
+    }
+
+    cricket::SendDataResult send_result = cricket::SDR_SUCCESS;
+    const size_t sent =
+        provider_->SendDataBatch(params, payloads, &send_result);
+    for (size_t i = 0; i < sent; ++i) {
+      queued_send_data_.Pop();
+    }
+    if (sent < batch_size) {
+      // Leave the rest in the queue if the transport is blocked.
+      if (send_result != cricket::SDR_BLOCK) {
+        LOG(LS_ERROR) << "Closing the DataChannel due to a failure to send "
+                      << "queued data, send_result = " << send_result;
+        Close();
+      }
       break;
     }
-    queued_send_data_.Pop();
-    delete buffer;
   }
 
-  if (observer_ && buffered_amount() < start_buffered_amount) {
-    observer_->OnBufferedAmountChange(start_buffered_amount);
-  }
+  OnBufferedAmountDecreased(start_buffered_amount);
 }
 
-bool DataChannel::SendDataMessage(const DataBuffer& buffer,
-                                  bool queue_if_blocked) {
+cricket::SendDataParams DataChannel::GetSendDataParams(
+    const DataBuffer& buffer) const {
   cricket::SendDataParams send_params;
 
   if (data_channel_type_ == cricket::DCT_SCTP) {
@@ -560,9 +632,15 @@ bool DataChannel::SendDataMessage(const DataBuffer& buffer,
     send_params.ssrc = send_ssrc_;
   }
   send_params.type = buffer.binary ? cricket::DMT_BINARY : cricket::DMT_TEXT;
+  return send_params;
+}
 
+bool DataChannel::SendDataMessage(const DataBuffer& buffer,
+                                  DataBuffer* owned_buffer,
+                                  bool queue_if_blocked) {
   cricket::SendDataResult send_result = cricket::SDR_SUCCESS;
-  bool success = provider_->SendData(send_params, buffer.data, &send_result);
+  bool success = provider_->SendData(GetSendDataParams(buffer), buffer.data,
+                                     &send_result);
 
   if (success) {
     return true;
@@ -573,7 +651,7 @@ bool DataChannel::SendDataMessage(const DataBuffer& buffer,
   }
 
   if (send_result == cricket::SDR_BLOCK) {
-    if (!queue_if_blocked || QueueSendDataMessage(buffer)) {
+    if (!queue_if_blocked || QueueSendDataMessage(buffer, owned_buffer)) {
       return false;
     }
   }
@@ -586,13 +664,20 @@ bool DataChannel::SendDataMessage(const DataBuffer& buffer,
   return false;
 }
 
-bool DataChannel::QueueSendDataMessage(const DataBuffer& buffer) {
+bool DataChannel::QueueSendDataMessage(const DataBuffer& buffer,
+                                       DataBuffer* owned_buffer) {
   size_t start_buffered_amount = buffered_amount();
   if (start_buffered_amount >= kMaxQueuedSendDataBytes) {
     LOG(LS_ERROR) << "Can't buffer any more data for the data channel.";
     return false;
   }
-  queued_send_data_.Push(new DataBuffer(buffer));
+  if (owned_buffer) {
+    ASSERT(owned_buffer == &buffer);
+    queued_send_data_.Push(owned_buffer);
+  } else {
+    DataBuffer copy(buffer);
+    queued_send_data_.Push(&copy);
+  }
 
   // The buffer can have length zero, in which case there is no change.
   if (observer_ && buffered_amount() > start_buffered_amount) {
@@ -601,19 +686,31 @@ bool DataChannel::QueueSendDataMessage(const DataBuffer& buffer) {
   return true;
 }
 
+void DataChannel::OnBufferedAmountDecreased(uint64_t previous_amount) {
+  const uint64_t amount = buffered_amount();
+  if (!observer_ || amount >= previous_amount) {
+    return;
+  }
+  observer_->OnBufferedAmountChange(previous_amount);
+  if (observer_ && previous_amount > buffered_amount_low_threshold_ &&
+      amount <= buffered_amount_low_threshold_) {
+    observer_->OnBufferedAmountLow();
+  }
+}
+
 void DataChannel::SendQueuedControlMessages() {
   PacketQueue control_packets;
   control_packets.Swap(&queued_control_data_);
 
   while (!control_packets.Empty()) {
-    rtc::scoped_ptr<DataBuffer> buf(control_packets.Front());
-    SendControlMessage(buf->data);
+    SendControlMessage(control_packets.Front()->data);
     control_packets.Pop();
   }
 }
 
 void DataChannel::QueueControlMessage(const rtc::Buffer& buffer) {
-  queued_control_data_.Push(new DataBuffer(buffer, true));
+  DataBuffer packet(buffer, true);
+  queued_control_data_.Push(&packet);
 }
 
 bool DataChannel::SendControlMessage(const rtc::Buffer& buffer) {
@@ -28,9 +28,9 @@
 #ifndef TALK_APP_WEBRTC_DATACHANNEL_H_
 #define TALK_APP_WEBRTC_DATACHANNEL_H_
 
-#include <deque>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "talk/app/webrtc/datachannelinterface.h"
 #include "talk/app/webrtc/proxy.h"
@@ -50,6 +50,14 @@ class DataChannelProviderInterface {
   virtual bool SendData(const cricket::SendDataParams& params,
                         const rtc::Buffer& payload,
                         cricket::SendDataResult* result) = 0;
+  // Sends |payloads| in order with the matching |params|, stopping at the
+  // first one that fails, whose result is returned in |result|. Returns the
+  // number of payloads sent. Providers that hop to another thread to send
+  // should override this to hop once for the whole batch.
+  virtual size_t SendDataBatch(
+      const std::vector<cricket::SendDataParams>& params,
+      const std::vector<const rtc::Buffer*>& payloads,
+      cricket::SendDataResult* result);
   // Connects to the transport signals.
   virtual bool ConnectDataChannel(DataChannel* data_channel) = 0;
   // Disconnects from the transport signals.
@@ -145,9 +153,14 @@ class DataChannel : public DataChannelInterface,
   virtual bool negotiated() const { return config_.negotiated; }
   virtual int id() const { return config_.id; }
   virtual uint64_t buffered_amount() const;
+  virtual void set_buffered_amount_low_threshold(uint64_t threshold);
+  virtual uint64_t buffered_amount_low_threshold() const {
+    return buffered_amount_low_threshold_;
+  }
   virtual void Close();
   virtual DataState state() const { return state_; }
   virtual bool Send(const DataBuffer& buffer);
+  virtual bool TakeAndSend(DataBuffer* buffer);
 
   // rtc::MessageHandler override.
   virtual void OnMessage(rtc::Message* msg);
@@ -160,7 +173,7 @@ class DataChannel : public DataChannelInterface,
   // Sigslots from cricket::DataChannel
   void OnDataReceived(cricket::DataChannel* channel,
                       const cricket::ReceiveDataParams& params,
-                      const rtc::Buffer& payload);
+                      rtc::Buffer* payload);
   void OnStreamClosedRemotely(uint32_t sid);
 
   // The remote peer request that this channel should be closed.
@@ -203,23 +216,30 @@ class DataChannel : public DataChannelInterface,
   virtual ~DataChannel();
 
  private:
-  // A packet queue which tracks the total queued bytes. Queued packets are
-  // owned by this class.
+  // A packet queue which tracks the total queued bytes. The packets are
+  // stored by value in a ring buffer, which only allocates when it grows, and
+  // pushing a packet moves its data into the queue instead of copying it.
   class PacketQueue {
    public:
     PacketQueue();
-    ~PacketQueue();
 
     size_t byte_count() const {
       return byte_count_;
     }
 
+    size_t size() const { return size_; }
+
     bool Empty() const;
 
-    DataBuffer* Front();
+    DataBuffer* Front() { return At(0); }
+
+    // The |index|th packet from the front, which must be less than size().
+    DataBuffer* At(size_t index);
 
     void Pop();
 
+    // Moves the contents of |packet| to the back of the queue, leaving
+    // |packet| empty.
     void Push(DataBuffer* packet);
 
     void Clear();
@@ -227,7 +247,14 @@ class DataChannel : public DataChannelInterface,
     void Swap(PacketQueue* other);
 
    private:
-    std::deque<DataBuffer*> packets_;
+    // Doubles the capacity of |packets_|.
+    void Grow();
+
+    // A ring buffer whose size is a power of two, with the packets at
+    // |head_| and after, wrapping around.
+    std::vector<DataBuffer> packets_;
+    size_t head_;
+    size_t size_;
     size_t byte_count_;
   };
 
@@ -248,9 +275,20 @@ class DataChannel : public DataChannelInterface,
 
   void DeliverQueuedReceivedData();
 
+  // Sends |buffer|, or queues it if there is queued data already or the
+  // transport is blocked. If |owned_buffer| is not NULL it is |buffer|, and
+  // its contents are taken instead of copied when queuing.
+  bool SendOrQueue(const DataBuffer& buffer, DataBuffer* owned_buffer);
   void SendQueuedDataMessages();
-  bool SendDataMessage(const DataBuffer& buffer, bool queue_if_blocked);
-  bool QueueSendDataMessage(const DataBuffer& buffer);
+  cricket::SendDataParams GetSendDataParams(const DataBuffer& buffer) const;
+  bool SendDataMessage(const DataBuffer& buffer,
+                       DataBuffer* owned_buffer,
+                       bool queue_if_blocked);
+  bool QueueSendDataMessage(const DataBuffer& buffer,
+                            DataBuffer* owned_buffer);
+  // Notifies the observer that buffered_amount dropped from
+  // |previous_amount|.
+  void OnBufferedAmountDecreased(uint64_t previous_amount);
 
   void SendQueuedControlMessages();
   void QueueControlMessage(const rtc::Buffer& buffer);
@@ -269,6 +307,7 @@ class DataChannel : public DataChannelInterface,
   bool writable_;
   uint32_t send_ssrc_;
   uint32_t receive_ssrc_;
+  uint64_t buffered_amount_low_threshold_;
   // Control messages that always have to get sent out before any queued
   // data.
   PacketQueue queued_control_data_;
@@ -290,8 +329,11 @@ BEGIN_PROXY_MAP(DataChannel)
   PROXY_CONSTMETHOD0(int, id)
   PROXY_CONSTMETHOD0(DataState, state)
   PROXY_CONSTMETHOD0(uint64_t, buffered_amount)
+  PROXY_METHOD1(void, set_buffered_amount_low_threshold, uint64_t)
+  PROXY_CONSTMETHOD0(uint64_t, buffered_amount_low_threshold)
   PROXY_METHOD0(void, Close)
   PROXY_METHOD1(bool, Send, const DataBuffer&)
+  PROXY_METHOD1(bool, TakeAndSend, DataBuffer*)
 END_PROXY()
 
 }  // namespace webrtc
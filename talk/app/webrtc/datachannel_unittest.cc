@@ -26,9 +26,16 @@
  */
 
 #include "talk/app/webrtc/datachannel.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
 #include "talk/app/webrtc/sctputils.h"
 #include "talk/app/webrtc/test/fakedatachannelprovider.h"
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/timeutils.h"
 
 using webrtc::DataChannel;
 using webrtc::SctpSidAllocator;
@@ -38,7 +45,8 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
   FakeDataChannelObserver()
       : messages_received_(0),
         on_state_change_count_(0),
-        on_buffered_amount_change_count_(0) {}
+        on_buffered_amount_change_count_(0),
+        on_buffered_amount_low_count_(0) {}
 
   void OnStateChange() {
     ++on_state_change_count_;
@@ -48,6 +56,10 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
     ++on_buffered_amount_change_count_;
   }
 
+  void OnBufferedAmountLow() {
+    ++on_buffered_amount_low_count_;
+  }
+
   void OnMessage(const webrtc::DataBuffer& buffer) {
     ++messages_received_;
   }
@@ -72,10 +84,15 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
     return on_buffered_amount_change_count_;
   }
 
+  size_t on_buffered_amount_low_count() const {
+    return on_buffered_amount_low_count_;
+  }
+
  private:
   size_t messages_received_;
   size_t on_state_change_count_;
   size_t on_buffered_amount_change_count_;
+  size_t on_buffered_amount_low_count_;
 };
 
 class SctpDataChannelTest : public testing::Test {
@@ -207,6 +224,68 @@ TEST_F(SctpDataChannelTest, BlockedWhenSendQueuedDataNoCrash) {
   EXPECT_EQ(2U, observer_->on_buffered_amount_change_count());
 }
 
+// Tests that TakeAndSend takes the data of a queued message instead of
+// copying it.
+TEST_F(SctpDataChannelTest, TakeAndSendTakesQueuedData) {
+  AddObserver();
+  SetChannelReady();
+  provider_.set_send_blocked(true);
+  const size_t sent_messages = provider_.num_sent_messages();
+  webrtc::DataBuffer buffer("abcd");
+  EXPECT_TRUE(webrtc_data_channel_->TakeAndSend(&buffer));
+  EXPECT_EQ(0U, buffer.size());
+  EXPECT_EQ(4U, webrtc_data_channel_->buffered_amount());
+
+  provider_.set_send_blocked(false);
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(sent_messages + 1, provider_.num_sent_messages());
+}
+
+// Tests that OnBufferedAmountLow is fired when the queue drains to the
+// threshold, and not when it was at or below the threshold already.
+TEST_F(SctpDataChannelTest, BufferedAmountLowWhenQueueDrains) {
+  AddObserver();
+  SetChannelReady();
+  webrtc_data_channel_->set_buffered_amount_low_threshold(4);
+  webrtc::DataBuffer buffer("abcd");
+  provider_.set_send_blocked(true);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  }
+  EXPECT_EQ(0U, observer_->on_buffered_amount_low_count());
+
+  provider_.set_send_blocked(false);
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(1U, observer_->on_buffered_amount_low_count());
+
+  provider_.set_send_blocked(true);
+  EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  provider_.set_send_blocked(false);
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(1U, observer_->on_buffered_amount_low_count());
+}
+
+// Tests that queued data is sent to the provider in batches.
+TEST_F(SctpDataChannelTest, QueuedDataSentInBatches) {
+  AddObserver();
+  SetChannelReady();
+  provider_.set_send_blocked(true);
+  const size_t sent_messages = provider_.num_sent_messages();
+  const size_t kNumMessages = 100;
+  for (size_t i = 0; i < kNumMessages; ++i) {
+    webrtc::DataBuffer buffer("abcd");
+    EXPECT_TRUE(webrtc_data_channel_->TakeAndSend(&buffer));
+  }
+  EXPECT_EQ(4 * kNumMessages, webrtc_data_channel_->buffered_amount());
+
+  provider_.set_send_blocked(false);
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(sent_messages + kNumMessages, provider_.num_sent_messages());
+  EXPECT_EQ(2U, provider_.num_send_batches());
+  EXPECT_EQ(webrtc::DataChannelInterface::kOpen,
+            webrtc_data_channel_->state());
+}
+
 // Tests that the queued control message is sent when channel is ready.
 TEST_F(SctpDataChannelTest, OpenMessageSent) {
   // Initially the id is unassigned.
@@ -265,7 +344,7 @@ TEST_F(SctpDataChannelTest, SendUnorderedAfterReceivesOpenAck) {
   params.type = cricket::DMT_CONTROL;
   rtc::Buffer payload;
   webrtc::WriteDataChannelOpenAckMessage(&payload);
-  dc->OnDataReceived(NULL, params, payload);
+  dc->OnDataReceived(NULL, params, &payload);
 
   // Sends another message and verifies it's unordered.
   ASSERT_TRUE(dc->Send(buffer));
@@ -289,7 +368,8 @@ TEST_F(SctpDataChannelTest, SendUnorderedAfterReceiveData) {
   params.ssrc = init.id;
   params.type = cricket::DMT_TEXT;
   webrtc::DataBuffer buffer("data");
-  dc->OnDataReceived(NULL, params, buffer.data);
+  rtc::Buffer payload(buffer.data);
+  dc->OnDataReceived(NULL, params, &payload);
 
   // Sends a message and verifies it's unordered.
   ASSERT_TRUE(dc->Send(buffer));
@@ -350,7 +430,7 @@ TEST_F(SctpDataChannelTest, ReceiveDataWithInvalidSsrc) {
   cricket::ReceiveDataParams params;
   params.ssrc = 0;
   webrtc::DataBuffer buffer("abcd");
-  webrtc_data_channel_->OnDataReceived(NULL, params, buffer.data);
+  webrtc_data_channel_->OnDataReceived(NULL, params, &buffer.data);
 
   EXPECT_EQ(0U, observer_->messages_received());
 }
@@ -366,7 +446,7 @@ TEST_F(SctpDataChannelTest, ReceiveDataWithValidSsrc) {
   params.ssrc = 1;
   webrtc::DataBuffer buffer("abcd");
 
-  webrtc_data_channel_->OnDataReceived(NULL, params, buffer.data);
+  webrtc_data_channel_->OnDataReceived(NULL, params, &buffer.data);
   EXPECT_EQ(1U, observer_->messages_received());
 }
 
@@ -482,7 +562,8 @@ TEST_F(SctpDataChannelTest, ClosedWhenReceivedBufferFull) {
 
   // Receiving data without having an observer will overflow the buffer.
   for (size_t i = 0; i < 16 * 1024 + 1; ++i) {
-    webrtc_data_channel_->OnDataReceived(NULL, params, buffer);
+    rtc::Buffer payload(buffer);
+    webrtc_data_channel_->OnDataReceived(NULL, params, &payload);
   }
   EXPECT_EQ(webrtc::DataChannelInterface::kClosed,
             webrtc_data_channel_->state());
@@ -508,6 +589,83 @@ TEST_F(SctpDataChannelTest, NeverOpened) {
   webrtc_data_channel_->Close();
 }
 
+// Delivers the messages sent on a DataChannel back to the DataChannel, with
+// a copy of the payload, like the SCTP stack makes.
+class LoopbackDataChannelProvider : public FakeDataChannelProvider {
+ public:
+  LoopbackDataChannelProvider() : data_channel_(NULL) {}
+
+  void set_data_channel(DataChannel* data_channel) {
+    data_channel_ = data_channel;
+  }
+
+  bool SendData(const cricket::SendDataParams& params,
+                const rtc::Buffer& payload,
+                cricket::SendDataResult* result) override {
+    if (!FakeDataChannelProvider::SendData(params, payload, result)) {
+      return false;
+    }
+    cricket::ReceiveDataParams receive_params;
+    receive_params.ssrc = params.ssrc;
+    receive_params.type = params.type;
+    rtc::Buffer received(payload);
+    data_channel_->OnDataReceived(NULL, receive_params, &received);
+    return true;
+  }
+
+ private:
+  DataChannel* data_channel_;
+};
+
+// Sends messages through a loopback transport that blocks after every
+// |kMessagesPerBurst| messages, with Send and with TakeAndSend, and reports
+// the throughput.
+TEST(DataChannelBenchmarkTest, DISABLED_LoopbackThroughput) {
+  const size_t kMessageSize = 64 * 1024;
+  const size_t kMessagesPerBurst = 128;
+  const int kBursts = 200;
+
+  for (bool take : {false, true}) {
+    LoopbackDataChannelProvider provider;
+    FakeDataChannelObserver observer;
+    webrtc::InternalDataChannelInit init;
+    init.id = 0;
+    rtc::scoped_refptr<DataChannel> dc = DataChannel::Create(
+        &provider, cricket::DCT_SCTP, "benchmark", init);
+    provider.set_data_channel(dc.get());
+    provider.set_transport_available(true);
+    dc->OnTransportChannelCreated();
+    provider.set_ready_to_send(true);
+    dc->RegisterObserver(&observer);
+    ASSERT_EQ(webrtc::DataChannelInterface::kOpen, dc->state());
+
+    const uint32_t start_ms = rtc::Time();
+    for (int burst = 0; burst < kBursts; ++burst) {
+      provider.set_send_blocked(true);
+      for (size_t i = 0; i < kMessagesPerBurst; ++i) {
+        rtc::Buffer data(kMessageSize);
+        memset(data.data(), i, data.size());
+        webrtc::DataBuffer buffer(data.Pass(), true);
+        if (take) {
+          ASSERT_TRUE(dc->TakeAndSend(&buffer));
+        } else {
+          ASSERT_TRUE(dc->Send(buffer));
+        }
+      }
+      provider.set_send_blocked(false);
+    }
+    const uint32_t elapsed_ms = std::max(rtc::TimeSince(start_ms), 1);
+    ASSERT_EQ(kBursts * kMessagesPerBurst, observer.messages_received());
+    dc->UnregisterObserver();
+    dc->Close();
+
+    const double megabytes =
+        kBursts * kMessagesPerBurst * kMessageSize / (1024.0 * 1024.0);
+    printf("%s: %.0f MB/s\n", take ? "TakeAndSend" : "Send",
+           megabytes * 1000 / elapsed_ms);
+  }
+}
+
 class SctpSidAllocatorTest : public testing::Test {
  protected:
   SctpSidAllocator allocator_;
@@ -71,6 +71,11 @@ struct DataBuffer {
       : data(data),
         binary(binary) {
   }
+  // Takes the contents of |data| instead of copying them.
+  DataBuffer(rtc::Buffer&& data, bool binary)
+      : data(data.Pass()),
+        binary(binary) {
+  }
   // For convenience for unit tests.
   explicit DataBuffer(const std::string& text)
       : data(text.data(), text.length()),
@@ -93,6 +98,10 @@ class DataChannelObserver {
   virtual void OnMessage(const DataBuffer& buffer) = 0;
   // The data channel's buffered_amount has changed.
   virtual void OnBufferedAmountChange(uint64_t previous_amount){};
+  // The data channel's buffered_amount has dropped to or below its
+  // buffered_amount_low_threshold, after being above it. Applications that
+  // stop sending while the queue is full can resume here.
+  virtual void OnBufferedAmountLow() {}
 
  protected:
   virtual ~DataChannelObserver() {}
@@ -146,9 +155,16 @@ class DataChannelInterface : public rtc::RefCountInterface {
   // (UTF-8 text and binary data) that have been queued using SendBuffer but
   // have not yet been transmitted to the network.
   virtual uint64_t buffered_amount() const = 0;
+  // The buffered_amount at or below which OnBufferedAmountLow is fired.
+  // Implementations without OnBufferedAmountLow support keep these defaults.
+  virtual void set_buffered_amount_low_threshold(uint64_t threshold) {}
+  virtual uint64_t buffered_amount_low_threshold() const { return 0; }
   virtual void Close() = 0;
   // Sends |data| to the remote peer.
   virtual bool Send(const DataBuffer& buffer) = 0;
+  // Like Send, but may take the contents of |buffer| instead of copying them
+  // when the data has to be queued, leaving |buffer| empty.
+  virtual bool TakeAndSend(DataBuffer* buffer) { return Send(*buffer); }
 
  protected:
   virtual ~DataChannelInterface() {}
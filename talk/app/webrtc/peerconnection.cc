@@ -556,8 +556,10 @@ bool ParseIceServers(const PeerConnectionInterface::IceServers& servers,
   return true;
 }
 
-PeerConnection::PeerConnection(PeerConnectionFactory* factory)
+PeerConnection::PeerConnection(PeerConnectionFactory* factory,
+                               rtc::Thread* worker_thread)
     : factory_(factory),
+      worker_thread_(worker_thread),
       observer_(NULL),
       uma_observer_(NULL),
       signaling_state_(kStable),
@@ -577,6 +579,7 @@ PeerConnection::~PeerConnection() {
   for (const auto& receiver : receivers_) {
     receiver->Stop();
   }
+  factory_->ReleaseWorkerThread(worker_thread_);
 }
 
 bool PeerConnection::Initialize(
@@ -625,14 +628,14 @@ bool PeerConnection::Initialize(
   // No step delay is used while allocating ports.
   port_allocator_->set_step_delay(cricket::kMinimumStepDelay);
 
-  media_controller_.reset(factory_->CreateMediaController());
+  media_controller_.reset(factory_->CreateMediaController(worker_thread_));
 
   remote_stream_factory_.reset(new RemoteMediaStreamFactory(
       factory_->signaling_thread(), media_controller_->channel_manager()));
 
   session_.reset(
       new WebRtcSession(media_controller_.get(), factory_->signaling_thread(),
-                        factory_->worker_thread(), port_allocator_.get()));
+                        worker_thread_, port_allocator_.get()));
   stats_.reset(new StatsCollector(this));
 
   // Initialize the WebRtcSession. It creates transport channels etc.
@@ -73,7 +73,10 @@ class PeerConnection : public PeerConnectionInterface,
                        public rtc::MessageHandler,
                        public sigslot::has_slots<> {
  public:
-  explicit PeerConnection(PeerConnectionFactory* factory);
+  // |worker_thread| runs the channels and transports of this
+  // PeerConnection; it is either the factory's worker thread or a thread of
+  // its worker thread pool.
+  PeerConnection(PeerConnectionFactory* factory, rtc::Thread* worker_thread);
 
   bool Initialize(
       const PeerConnectionInterface::RTCConfiguration& configuration,
@@ -214,6 +217,8 @@ class PeerConnection : public PeerConnectionInterface,
     return factory_->signaling_thread();
   }
 
+  rtc::Thread* worker_thread() const { return worker_thread_; }
+
   void PostSetSessionDescriptionFailure(SetSessionDescriptionObserver* observer,
                                         const std::string& error);
   void PostCreateSessionDescriptionFailure(
@@ -350,6 +355,7 @@ class PeerConnection : public PeerConnectionInterface,
   // PeerConnectionFactoryInterface all instances created using the raw pointer
   // will refer to the same reference count.
   rtc::scoped_refptr<PeerConnectionFactory> factory_;
+  rtc::Thread* const worker_thread_;
   PeerConnectionObserver* observer_;
   UMAObserver* uma_observer_;
   SignalingState signaling_state_;
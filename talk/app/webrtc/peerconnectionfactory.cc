@@ -154,6 +154,7 @@ PeerConnectionFactory::~PeerConnectionFactory() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   channel_manager_.reset(nullptr);
   default_allocator_factory_ = nullptr;
+  worker_thread_pool_.reset();
 
   // Make sure |worker_thread_| and |signaling_thread_| outlive
   // |dtls_identity_store_|.
@@ -253,10 +254,23 @@ PeerConnectionFactory::CreatePeerConnection(
 
   PortAllocatorFactoryInterface* chosen_allocator_factory =
       allocator_factory ? allocator_factory : default_allocator_factory_.get();
+  rtc::Thread* pc_worker_thread = worker_thread_;
+  // An external allocator factory has its sockets on a thread of its own
+  // choosing, so only PeerConnections with the default one can be moved to
+  // the pool.
+  if (!allocator_factory && options_.worker_thread_pool_size > 0) {
+    if (!worker_thread_pool_) {
+      worker_thread_pool_.reset(
+          new WorkerThreadPool(options_.worker_thread_pool_size));
+    }
+    pc_worker_thread = worker_thread_pool_->AddPeerConnection();
+    chosen_allocator_factory =
+        worker_thread_pool_->allocator_factory(pc_worker_thread);
+  }
   chosen_allocator_factory->SetNetworkIgnoreMask(options_.network_ignore_mask);
 
   rtc::scoped_refptr<PeerConnection> pc(
-      new rtc::RefCountedObject<PeerConnection>(this));
+      new rtc::RefCountedObject<PeerConnection>(this, pc_worker_thread));
   if (!pc->Initialize(
       configuration,
       constraints,
@@ -294,10 +308,10 @@ PeerConnectionFactory::CreateAudioTrack(const std::string& id,
   return AudioTrackProxy::Create(signaling_thread_, track);
 }
 
-webrtc::MediaControllerInterface* PeerConnectionFactory::CreateMediaController()
-    const {
+webrtc::MediaControllerInterface* PeerConnectionFactory::CreateMediaController(
+    rtc::Thread* worker_thread) const {
   RTC_DCHECK(signaling_thread_->IsCurrent());
-  return MediaControllerInterface::Create(worker_thread_,
+  return MediaControllerInterface::Create(worker_thread,
                                           channel_manager_.get());
 }
 
@@ -312,6 +326,14 @@ rtc::Thread* PeerConnectionFactory::worker_thread() {
   return worker_thread_;
 }
 
+void PeerConnectionFactory::ReleaseWorkerThread(rtc::Thread* worker_thread) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  if (worker_thread != worker_thread_) {
+    RTC_DCHECK(worker_thread_pool_);
+    worker_thread_pool_->RemovePeerConnection(worker_thread);
+  }
+}
+
 cricket::MediaEngineInterface* PeerConnectionFactory::CreateMediaEngine_w() {
   ASSERT(worker_thread_ == rtc::Thread::Current());
   return cricket::WebRtcMediaEngineFactory::Create(
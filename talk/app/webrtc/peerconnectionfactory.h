@@ -34,6 +34,7 @@
 #include "talk/app/webrtc/mediacontroller.h"
 #include "talk/app/webrtc/mediastreaminterface.h"
 #include "talk/app/webrtc/peerconnectioninterface.h"
+#include "talk/app/webrtc/workerthreadpool.h"
 #include "talk/session/media/channelmanager.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/scoped_ref_ptr.h"
@@ -84,11 +85,15 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   bool StartRtcEventLog(rtc::PlatformFile file) override;
   void StopRtcEventLog() override;
 
-  virtual webrtc::MediaControllerInterface* CreateMediaController() const;
+  virtual webrtc::MediaControllerInterface* CreateMediaController(
+      rtc::Thread* worker_thread) const;
   virtual rtc::Thread* signaling_thread();
   virtual rtc::Thread* worker_thread();
   const Options& options() const { return options_; }
 
+  // Called by a PeerConnection that goes away, with the thread it ran on.
+  void ReleaseWorkerThread(rtc::Thread* worker_thread);
+
  protected:
   PeerConnectionFactory();
   PeerConnectionFactory(
@@ -106,6 +111,8 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   bool wraps_current_thread_;
   rtc::Thread* signaling_thread_;
   rtc::Thread* worker_thread_;
+  // Created with the first PeerConnection if |options_| asks for a pool.
+  rtc::scoped_ptr<WorkerThreadPool> worker_thread_pool_;
   Options options_;
   rtc::scoped_refptr<PortAllocatorFactoryInterface> default_allocator_factory_;
   // External Audio device used for audio playback.
@@ -543,7 +543,8 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
       disable_sctp_data_channels(false),
       disable_network_monitor(false),
       network_ignore_mask(rtc::kDefaultNetworkIgnoreMask),
-      ssl_max_version(rtc::SSL_PROTOCOL_DTLS_10) {
+      ssl_max_version(rtc::SSL_PROTOCOL_DTLS_10),
+      worker_thread_pool_size(0) {
     }
     bool disable_encryption;
     bool disable_sctp_data_channels;
@@ -558,6 +559,14 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
     // supported by both ends will be used for the connection, i.e. if one
     // party supports DTLS 1.0 and the other DTLS 1.2, DTLS 1.0 will be used.
     rtc::SSLProtocolVersion ssl_max_version;
+
+    // If greater than 0, the factory runs PeerConnections on a pool of this
+    // many worker threads of its own instead of on its worker thread. Each
+    // PeerConnection created with the default port allocator factory goes to
+    // the thread with the fewest PeerConnections, where its channels,
+    // transports and ports run. The pool is created with the first such
+    // PeerConnection, so later changes of the size have no effect.
+    int worker_thread_pool_size;
   };
 
   virtual void SetOptions(const Options& options) = 0;
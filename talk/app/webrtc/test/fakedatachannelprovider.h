@@ -36,7 +36,9 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
       : send_blocked_(false),
         transport_available_(false),
         ready_to_send_(false),
-        transport_error_(false) {}
+        transport_error_(false),
+        num_sent_messages_(0),
+        num_send_batches_(0) {}
   virtual ~FakeDataChannelProvider() {}
 
   bool SendData(const cricket::SendDataParams& params,
@@ -54,9 +56,18 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
     }
 
     last_send_data_params_ = params;
+    ++num_sent_messages_;
     return true;
   }
 
+  size_t SendDataBatch(const std::vector<cricket::SendDataParams>& params,
+                       const std::vector<const rtc::Buffer*>& payloads,
+                       cricket::SendDataResult* result) override {
+    ++num_send_batches_;
+    return webrtc::DataChannelProviderInterface::SendDataBatch(
+        params, payloads, result);
+  }
+
   bool ConnectDataChannel(webrtc::DataChannel* data_channel) override {
     ASSERT(connected_channels_.find(data_channel) == connected_channels_.end());
     if (!transport_available_) {
@@ -136,6 +147,12 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
     return last_send_data_params_;
   }
 
+  // The number of messages sent successfully.
+  size_t num_sent_messages() const { return num_sent_messages_; }
+
+  // The number of times queued messages were sent in a batch.
+  size_t num_send_batches() const { return num_send_batches_; }
+
   bool IsConnected(webrtc::DataChannel* data_channel) const {
     return connected_channels_.find(data_channel) != connected_channels_.end();
   }
@@ -154,6 +171,8 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
   bool transport_available_;
   bool ready_to_send_;
   bool transport_error_;
+  size_t num_sent_messages_;
+  size_t num_send_batches_;
   std::set<webrtc::DataChannel*> connected_channels_;
   std::set<uint32_t> send_ssrcs_;
   std::set<uint32_t> recv_ssrcs_;
@@ -1431,6 +1431,17 @@ bool WebRtcSession::SendData(const cricket::SendDataParams& params,
   return data_channel_->SendData(params, payload, result);
 }
 
+size_t WebRtcSession::SendDataBatch(
+    const std::vector<cricket::SendDataParams>& params,
+    const std::vector<const rtc::Buffer*>& payloads,
+    cricket::SendDataResult* result) {
+  if (!data_channel_) {
+    LOG(LS_ERROR) << "SendDataBatch called when data_channel_ is NULL.";
+    return 0;
+  }
+  return data_channel_->SendDataBatch(params, payloads, result);
+}
+
 bool WebRtcSession::ConnectDataChannel(DataChannel* webrtc_data_channel) {
   if (!data_channel_) {
     LOG(LS_ERROR) << "ConnectDataChannel called when data_channel_ is NULL.";
@@ -1890,15 +1901,15 @@ void WebRtcSession::OnDtlsSetupFailure(cricket::BaseChannel*, bool rtcp) {
 void WebRtcSession::OnDataChannelMessageReceived(
     cricket::DataChannel* channel,
     const cricket::ReceiveDataParams& params,
-    const rtc::Buffer& payload) {
+    rtc::Buffer* payload) {
   RTC_DCHECK(data_channel_type_ == cricket::DCT_SCTP);
-  if (params.type == cricket::DMT_CONTROL && IsOpenMessage(payload)) {
+  if (params.type == cricket::DMT_CONTROL && IsOpenMessage(*payload)) {
     // Received OPEN message; parse and signal that a new data channel should
     // be created.
     std::string label;
     InternalDataChannelInit config;
     config.id = params.ssrc;
-    if (!ParseDataChannelOpenMessage(payload, &label, &config)) {
+    if (!ParseDataChannelOpenMessage(*payload, &label, &config)) {
       LOG(LS_WARNING) << "Failed to parse the OPEN message for sid "
                       << params.ssrc;
       return;
@@ -270,6 +270,9 @@ class WebRtcSession : public AudioProviderInterface,
   bool SendData(const cricket::SendDataParams& params,
                 const rtc::Buffer& payload,
                 cricket::SendDataResult* result) override;
+  size_t SendDataBatch(const std::vector<cricket::SendDataParams>& params,
+                       const std::vector<const rtc::Buffer*>& payloads,
+                       cricket::SendDataResult* result) override;
   bool ConnectDataChannel(DataChannel* webrtc_data_channel) override;
   void DisconnectDataChannel(DataChannel* webrtc_data_channel) override;
   void AddSctpDataStream(int sid) override;
@@ -411,7 +414,7 @@ class WebRtcSession : public AudioProviderInterface,
   // messages.
   void OnDataChannelMessageReceived(cricket::DataChannel* channel,
                                     const cricket::ReceiveDataParams& params,
-                                    const rtc::Buffer& payload);
+                                    rtc::Buffer* payload);
 
   std::string BadStateErrMsg(State state);
   void SetIceConnectionState(PeerConnectionInterface::IceConnectionState state);
@@ -3835,7 +3835,7 @@ TEST_P(WebRtcSessionTest, TestSctpDataChannelOpenMessage) {
   params.type = cricket::DMT_CONTROL;
 
   cricket::DataChannel* data_channel = session_->data_channel();
-  data_channel->SignalDataReceived(data_channel, params, payload);
+  data_channel->SignalDataReceived(data_channel, params, &payload);
 
   EXPECT_EQ("a", last_data_channel_label_);
   EXPECT_EQ(config.id, last_data_channel_config_.id);
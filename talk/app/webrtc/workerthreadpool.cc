@@ -0,0 +1,95 @@
+/*
+ * libjingle
+ * Copyright 2015 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "talk/app/webrtc/workerthreadpool.h"
+
+#include "talk/app/webrtc/portallocatorfactory.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/stringencode.h"
+#include "webrtc/base/thread.h"
+
+namespace webrtc {
+
+WorkerThreadPool::WorkerThreadPool(size_t size) {
+  RTC_DCHECK_GT(size, 0u);
+  for (size_t i = 0; i < size; ++i) {
+    Worker worker;
+    worker.thread = new rtc::Thread();
+    worker.thread->SetName("PeerConnectionWorker" + rtc::ToString(i),
+                           nullptr);
+    worker.thread->Start();
+    worker.allocator_factory = PortAllocatorFactory::Create(worker.thread);
+    worker.num_peer_connections = 0;
+    workers_.push_back(worker);
+  }
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+  for (Worker& worker : workers_) {
+    RTC_DCHECK_EQ(0, worker.num_peer_connections);
+    // The ports and sockets go away with the PeerConnections, so the
+    // allocator factory can go before its thread.
+    worker.allocator_factory = nullptr;
+    delete worker.thread;
+  }
+}
+
+rtc::Thread* WorkerThreadPool::AddPeerConnection() {
+  Worker* least_loaded = &workers_[0];
+  for (Worker& worker : workers_) {
+    if (worker.num_peer_connections < least_loaded->num_peer_connections)
+      least_loaded = &worker;
+  }
+  ++least_loaded->num_peer_connections;
+  return least_loaded->thread;
+}
+
+void WorkerThreadPool::RemovePeerConnection(rtc::Thread* thread) {
+  Worker& worker = workers_[FindWorker(thread)];
+  RTC_DCHECK_GT(worker.num_peer_connections, 0);
+  --worker.num_peer_connections;
+}
+
+int WorkerThreadPool::num_peer_connections(rtc::Thread* thread) const {
+  return workers_[FindWorker(thread)].num_peer_connections;
+}
+
+PortAllocatorFactoryInterface* WorkerThreadPool::allocator_factory(
+    rtc::Thread* thread) const {
+  return workers_[FindWorker(thread)].allocator_factory.get();
+}
+
+size_t WorkerThreadPool::FindWorker(rtc::Thread* thread) const {
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (workers_[i].thread == thread)
+      return i;
+  }
+  RTC_CHECK(false) << "Not a thread of the pool";
+  return 0;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,86 @@
+/*
+ * libjingle
+ * Copyright 2015 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// WorkerThreadPool owns the worker threads that PeerConnectionFactory spreads
+// PeerConnections over, when it is configured with a worker thread pool. Each
+// PeerConnection runs its channels, transports and ports on one thread of the
+// pool, picked by how many PeerConnections each thread already has.
+
+#ifndef TALK_APP_WEBRTC_WORKERTHREADPOOL_H_
+#define TALK_APP_WEBRTC_WORKERTHREADPOOL_H_
+
+#include <vector>
+
+#include "talk/app/webrtc/peerconnectioninterface.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ref_ptr.h"
+
+namespace rtc {
+class Thread;
+}
+
+namespace webrtc {
+
+// Not thread safe; used on the signaling thread.
+class WorkerThreadPool {
+ public:
+  // Creates and starts |size| threads.
+  explicit WorkerThreadPool(size_t size);
+  ~WorkerThreadPool();
+
+  size_t size() const { return workers_.size(); }
+
+  // Assigns a new PeerConnection to the thread with the fewest
+  // PeerConnections, and returns that thread.
+  rtc::Thread* AddPeerConnection();
+  // Removes a PeerConnection that AddPeerConnection() assigned to |thread|.
+  void RemovePeerConnection(rtc::Thread* thread);
+
+  // The number of PeerConnections on |thread|.
+  int num_peer_connections(rtc::Thread* thread) const;
+
+  // The port allocator factory whose sockets belong to |thread|.
+  PortAllocatorFactoryInterface* allocator_factory(rtc::Thread* thread) const;
+
+ private:
+  struct Worker {
+    rtc::Thread* thread;
+    rtc::scoped_refptr<PortAllocatorFactoryInterface> allocator_factory;
+    int num_peer_connections;
+  };
+
+  // The index of the worker that runs |thread|.
+  size_t FindWorker(rtc::Thread* thread) const;
+
+  std::vector<Worker> workers_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(WorkerThreadPool);
+};
+
+}  // namespace webrtc
+
+#endif  // TALK_APP_WEBRTC_WORKERTHREADPOOL_H_
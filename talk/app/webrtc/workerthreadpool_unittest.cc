@@ -0,0 +1,163 @@
+/*
+ * libjingle
+ * Copyright 2015 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "talk/app/webrtc/workerthreadpool.h"
+
+#include <stdio.h>
+
+#include <set>
+#include <vector>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/messagedigest.h"
+#include "webrtc/base/messagehandler.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
+
+namespace webrtc {
+namespace {
+
+// The media of one PeerConnection: authenticates each packet like SRTP does,
+// on the worker thread of the PeerConnection.
+class FakeMediaConnection : public rtc::MessageHandler {
+ public:
+  FakeMediaConnection(rtc::Thread* worker_thread,
+                      volatile int* packets_left,
+                      rtc::Event* done)
+      : worker_thread_(worker_thread),
+        packets_left_(packets_left),
+        done_(done),
+        packet_(kPacketSize, 0x5a) {}
+
+  void SendPackets(int count) {
+    for (int i = 0; i < count; ++i)
+      worker_thread_->Post(this);
+  }
+
+  void OnMessage(rtc::Message* msg) override {
+    char key[20] = {0};
+    char mac[20];
+    rtc::ComputeHmac(rtc::DIGEST_SHA_1, key, sizeof(key), &packet_[0],
+                     packet_.size(), mac, sizeof(mac));
+    packet_[0] = mac[0];
+    if (rtc::AtomicOps::Decrement(packets_left_) == 0)
+      done_->Set();
+  }
+
+ private:
+  static const size_t kPacketSize = 1200;
+
+  rtc::Thread* const worker_thread_;
+  volatile int* const packets_left_;
+  rtc::Event* const done_;
+  std::vector<char> packet_;
+};
+
+// Returns the packets per second that |num_connections| connections get
+// through, when spread over a pool of |pool_size| threads.
+double MeasurePacketsPerSecond(size_t pool_size, int num_connections) {
+  const int kPacketsPerConnection = 2000;
+  WorkerThreadPool pool(pool_size);
+  volatile int packets_left = num_connections * kPacketsPerConnection;
+  rtc::Event done(false, false);
+  std::vector<rtc::Thread*> threads;
+  std::vector<FakeMediaConnection*> connections;
+  for (int i = 0; i < num_connections; ++i) {
+    threads.push_back(pool.AddPeerConnection());
+    connections.push_back(
+        new FakeMediaConnection(threads.back(), &packets_left, &done));
+  }
+
+  const uint64_t start = rtc::TimeNanos();
+  for (FakeMediaConnection* connection : connections)
+    connection->SendPackets(kPacketsPerConnection);
+  EXPECT_TRUE(done.Wait(rtc::Event::kForever));
+  const double seconds = (rtc::TimeNanos() - start) / 1.0e9;
+
+  for (size_t i = 0; i < connections.size(); ++i) {
+    pool.RemovePeerConnection(threads[i]);
+    delete connections[i];
+  }
+  return num_connections * kPacketsPerConnection / seconds;
+}
+
+}  // namespace
+
+TEST(WorkerThreadPoolTest, SpreadsPeerConnectionsByLoad) {
+  WorkerThreadPool pool(3);
+  EXPECT_EQ(3u, pool.size());
+  std::vector<rtc::Thread*> threads;
+  for (int i = 0; i < 6; ++i)
+    threads.push_back(pool.AddPeerConnection());
+  std::set<rtc::Thread*> distinct_threads(threads.begin(), threads.end());
+  EXPECT_EQ(3u, distinct_threads.size());
+  for (rtc::Thread* thread : distinct_threads)
+    EXPECT_EQ(2, pool.num_peer_connections(thread));
+
+  // New PeerConnections go where others went away.
+  rtc::Thread* thread = threads[0];
+  pool.RemovePeerConnection(thread);
+  pool.RemovePeerConnection(thread);
+  EXPECT_EQ(0, pool.num_peer_connections(thread));
+  EXPECT_EQ(thread, pool.AddPeerConnection());
+  EXPECT_EQ(thread, pool.AddPeerConnection());
+  EXPECT_EQ(2, pool.num_peer_connections(thread));
+
+  for (rtc::Thread* thread : threads)
+    pool.RemovePeerConnection(thread);
+}
+
+TEST(WorkerThreadPoolTest, ThreadsRunWithTheirOwnAllocatorFactory) {
+  WorkerThreadPool pool(2);
+  rtc::Thread* thread1 = pool.AddPeerConnection();
+  rtc::Thread* thread2 = pool.AddPeerConnection();
+  EXPECT_NE(thread1, thread2);
+  EXPECT_TRUE(thread1->RunningForTest());
+  EXPECT_TRUE(thread2->RunningForTest());
+  EXPECT_NE(rtc::Thread::Current(), thread1);
+  ASSERT_TRUE(pool.allocator_factory(thread1) != nullptr);
+  ASSERT_TRUE(pool.allocator_factory(thread2) != nullptr);
+  EXPECT_NE(pool.allocator_factory(thread1), pool.allocator_factory(thread2));
+  pool.RemovePeerConnection(thread1);
+  pool.RemovePeerConnection(thread2);
+}
+
+// Measures how the throughput of many connections, each doing the per-packet
+// work of SRTP on its worker thread, scales with the size of the pool.
+TEST(WorkerThreadPoolTest, DISABLED_ThroughputBenchmark) {
+  const int kNumConnections = 200;
+  for (size_t pool_size : {1u, 2u, 4u, 8u}) {
+    printf("%d connections on %d threads: %.0f packets/s.\n", kNumConnections,
+           static_cast<int>(pool_size),
+           MeasurePacketsPerSecond(pool_size, kNumConnections));
+  }
+}
+
+}  // namespace webrtc
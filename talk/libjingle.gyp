@@ -788,6 +788,8 @@
         'app/webrtc/webrtcsession.h',
         'app/webrtc/webrtcsessiondescriptionfactory.cc',
         'app/webrtc/webrtcsessiondescriptionfactory.h',
+        'app/webrtc/workerthreadpool.cc',
+        'app/webrtc/workerthreadpool.h',
       ],
       'conditions': [
         ['OS=="android" and build_with_chromium==0', {
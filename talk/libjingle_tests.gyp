@@ -226,6 +226,7 @@
         'app/webrtc/videotrack_unittest.cc',
         'app/webrtc/webrtcsdp_unittest.cc',
         'app/webrtc/webrtcsession_unittest.cc',
+        'app/webrtc/workerthreadpool_unittest.cc',
       ],
       'conditions': [
         ['OS=="android"', {
@@ -44,6 +44,7 @@
 #include "talk/media/base/streamparams.h"
 #include "talk/media/webrtc/webrtcvoe.h"
 #include "webrtc/base/base64.h"
+#include "webrtc/base/bind.h"
 #include "webrtc/base/byteorder.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/helpers.h"
@@ -601,7 +602,13 @@ VoiceMediaChannel* WebRtcVoiceEngine::CreateChannel(webrtc::Call* call,
   return new WebRtcVoiceMediaChannel(this, options, call);
 }
 
+AudioOptions WebRtcVoiceEngine::GetOptions() const {
+  rtc::CritScope lock(&options_cs_);
+  return options_;
+}
+
 bool WebRtcVoiceEngine::SetOptions(const AudioOptions& options) {
+  rtc::CritScope lock(&options_cs_);
   if (!ApplyOptions(options)) {
     return false;
   }
@@ -612,6 +619,7 @@ bool WebRtcVoiceEngine::SetOptions(const AudioOptions& options) {
 // AudioOptions defaults are set in InitInternal (for options with corresponding
 // MediaEngineInterface flags) and in SetOptions(int) for flagless options.
 bool WebRtcVoiceEngine::ApplyOptions(const AudioOptions& options_in) {
+  rtc::CritScope lock(&options_cs_);
   LOG(LS_INFO) << "ApplyOptions: " << options_in.ToString();
   AudioOptions options = options_in;  // The options are modified below.
   // kEcConference is AEC with high suppression.
@@ -917,15 +925,19 @@ bool WebRtcVoiceEngine::SetDevices(const Device* in_device,
             << ") and speaker to (id=" << out_id << ", name=" << out_name
             << ")";
 
-  // Must also pause all audio playback and capture.
-  bool ret = true;
-  for (WebRtcVoiceMediaChannel* channel : channels_) {
-    if (!channel->PausePlayout()) {
-      LOG(LS_WARNING) << "Failed to pause playout";
-      ret = false;
+  // Must also pause all audio playback and capture. The channels run on the
+  // worker threads that created them, so they are paused there; take a copy
+  // of the list as it may change meanwhile.
+  std::vector<std::pair<WebRtcVoiceMediaChannel*, rtc::Thread*>> channels;
+  {
+    rtc::CritScope lock(&channels_cs_);
+    for (WebRtcVoiceMediaChannel* channel : channels_) {
+      channels.push_back(std::make_pair(channel, channel->worker_thread()));
     }
-    if (!channel->PauseSend()) {
-      LOG(LS_WARNING) << "Failed to pause send";
+  }
+  bool ret = true;
+  for (const auto& channel : channels) {
+    if (!PauseOrResumeChannel(channel.second, channel.first, true)) {
       ret = false;
     }
   }
@@ -957,13 +969,8 @@ bool WebRtcVoiceEngine::SetDevices(const Device* in_device,
   }
 
   // Resume all audio playback and capture.
-  for (WebRtcVoiceMediaChannel* channel : channels_) {
-    if (!channel->ResumePlayout()) {
-      LOG(LS_WARNING) << "Failed to resume playout";
-      ret = false;
-    }
-    if (!channel->ResumeSend()) {
-      LOG(LS_WARNING) << "Failed to resume send";
+  for (const auto& channel : channels) {
+    if (!PauseOrResumeChannel(channel.second, channel.first, false)) {
       ret = false;
     }
   }
@@ -980,6 +987,35 @@ bool WebRtcVoiceEngine::SetDevices(const Device* in_device,
 #endif  // !IOS
 }
 
+bool WebRtcVoiceEngine::PauseOrResumeChannel(rtc::Thread* thread,
+                                             WebRtcVoiceMediaChannel* channel,
+                                             bool pause) {
+  if (thread && !thread->IsCurrent()) {
+    return thread->Invoke<bool>(rtc::Bind(
+        &WebRtcVoiceEngine::PauseOrResumeChannel, this, thread, channel, pause));
+  }
+  {
+    // Channels are destroyed on their own thread, so a channel that is still
+    // registered here stays alive until this call returns.
+    rtc::CritScope lock(&channels_cs_);
+    if (std::find(channels_.begin(), channels_.end(), channel) ==
+        channels_.end()) {
+      return true;
+    }
+  }
+  bool ret = true;
+  if (!(pause ? channel->PausePlayout() : channel->ResumePlayout())) {
+    LOG(LS_WARNING) << "Failed to " << (pause ? "pause" : "resume")
+                    << " playout";
+    ret = false;
+  }
+  if (!(pause ? channel->PauseSend() : channel->ResumeSend())) {
+    LOG(LS_WARNING) << "Failed to " << (pause ? "pause" : "resume") << " send";
+    ret = false;
+  }
+  return ret;
+}
+
 bool WebRtcVoiceEngine::FindWebRtcAudioDeviceId(
   bool is_input, const std::string& dev_name, int dev_id, int* rtc_id) {
   // In Linux, VoiceEngine uses the same device dev_id as the device manager.
@@ -1229,6 +1265,7 @@ void WebRtcVoiceEngine::UnregisterChannel(WebRtcVoiceMediaChannel* channel) {
 // NB: If we start messing with other config fields, we'll want
 // to save the current webrtc::AgcConfig as well.
 bool WebRtcVoiceEngine::AdjustAgcLevel(int delta) {
+  rtc::CritScope lock(&options_cs_);
   webrtc::AgcConfig config = default_agc_config_;
   config.targetLeveldBOv -= delta;
 
@@ -1267,6 +1304,7 @@ bool WebRtcVoiceEngine::StartAecDump(rtc::PlatformFile file) {
       LOG(LS_WARNING) << "Could not close file.";
     return false;
   }
+  rtc::CritScope lock(&options_cs_);
   StopAecDump();
   if (voe_wrapper_->processing()->StartDebugRecording(aec_dump_file_stream) !=
       webrtc::AudioProcessing::kNoError) {
@@ -1279,6 +1317,7 @@ bool WebRtcVoiceEngine::StartAecDump(rtc::PlatformFile file) {
 }
 
 void WebRtcVoiceEngine::StartAecDump(const std::string& filename) {
+  rtc::CritScope lock(&options_cs_);
   if (!is_dumping_aec_) {
     // Start dumping AEC when we are not dumping.
     if (voe_wrapper_->processing()->StartDebugRecording(
@@ -1291,6 +1330,7 @@ void WebRtcVoiceEngine::StartAecDump(const std::string& filename) {
 }
 
 void WebRtcVoiceEngine::StopAecDump() {
+  rtc::CritScope lock(&options_cs_);
   if (is_dumping_aec_) {
     // Stop dumping AEC when we are dumping.
     if (voe_wrapper_->processing()->StopDebugRecording() !=
@@ -1310,6 +1350,7 @@ void WebRtcVoiceEngine::StopRtcEventLog() {
 }
 
 int WebRtcVoiceEngine::CreateVoEChannel() {
+  rtc::CritScope lock(&options_cs_);
   return voe_wrapper_->base()->CreateChannel(voe_config_);
 }
 
@@ -1432,7 +1473,8 @@ WebRtcVoiceMediaChannel::WebRtcVoiceMediaChannel(WebRtcVoiceEngine* engine,
       typing_noise_detected_(false),
       desired_send_(SEND_NOTHING),
       send_(SEND_NOTHING),
-      call_(call) {
+      call_(call),
+      worker_thread_(rtc::Thread::Current()) {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   LOG(LS_VERBOSE) << "WebRtcVoiceMediaChannel::WebRtcVoiceMediaChannel";
   RTC_DCHECK(nullptr != call);
@@ -74,7 +74,7 @@ class WebRtcVoiceEngine
   VoiceMediaChannel* CreateChannel(webrtc::Call* call,
                                    const AudioOptions& options);
 
-  AudioOptions GetOptions() const { return options_; }
+  AudioOptions GetOptions() const;
   bool SetOptions(const AudioOptions& options);
   bool SetDevices(const Device* in_device, const Device* out_device);
   bool GetOutputVolume(int* level);
@@ -140,6 +140,11 @@ class WebRtcVoiceEngine
   // set the output parameter rtc_id if successful.
   bool FindWebRtcAudioDeviceId(
       bool is_input, const std::string& dev_name, int dev_id, int* rtc_id);
+  // Pauses or resumes playout and send of |channel| on |thread|, the channel's
+  // worker thread. Does nothing if the channel has been destroyed.
+  bool PauseOrResumeChannel(rtc::Thread* thread,
+                            WebRtcVoiceMediaChannel* channel,
+                            bool pause);
 
   void StartAecDump(const std::string& filename);
   int CreateVoEChannel();
@@ -165,6 +170,9 @@ class WebRtcVoiceEngine
   webrtc::Config voe_config_;
 
   bool initialized_;
+  // Guards |options_| and the engine state that ApplyOptions() changes, as
+  // channels running on different worker threads apply options concurrently.
+  mutable rtc::CriticalSection options_cs_;
   AudioOptions options_;
 
   // Cache received extended_filter_aec, delay_agnostic_aec and experimental_ns
@@ -189,6 +197,7 @@ class WebRtcVoiceMediaChannel : public VoiceMediaChannel,
   ~WebRtcVoiceMediaChannel() override;
 
   const AudioOptions& options() const { return options_; }
+  rtc::Thread* worker_thread() const { return worker_thread_; }
 
   bool SetSendParameters(const AudioSendParameters& params) override;
   bool SetRecvParameters(const AudioRecvParameters& params) override;
@@ -317,6 +326,8 @@ class WebRtcVoiceMediaChannel : public VoiceMediaChannel,
   SendFlags desired_send_;
   SendFlags send_;
   webrtc::Call* const call_;
+  // The thread the channel was created on, and is used and destroyed on.
+  rtc::Thread* const worker_thread_;
 
   // SSRC of unsignalled receive stream, or -1 if there isn't one.
   int64_t default_recv_ssrc_ = -1;
@@ -25,6 +25,7 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "webrtc/base/bind.h"
 #include "webrtc/base/byteorder.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/call.h"
@@ -132,6 +133,28 @@ class WebRtcVoiceEngineTestFake : public testing::Test {
     // Verify the channel does not exist.
     EXPECT_EQ(-1, voe_.GetLocalSSRC(default_channel_num, default_send_ssrc));
   }
+  // Creates |channel_| with a send and a receive stream, and starts sending
+  // and playout. Used to create the channel on a thread other than the test
+  // thread.
+  bool CreateSendingChannel(int* send_channel, int* recv_channel) {
+    channel_ = engine_.CreateChannel(&call_, cricket::AudioOptions());
+    if (!channel_ ||
+        !channel_->AddSendStream(cricket::StreamParams::CreateLegacy(kSsrc1))) {
+      return false;
+    }
+    *send_channel = voe_.GetLastChannel();
+    if (!channel_->AddRecvStream(cricket::StreamParams::CreateLegacy(2))) {
+      return false;
+    }
+    *recv_channel = voe_.GetLastChannel();
+    return channel_->SetSendParameters(send_parameters_) &&
+           channel_->SetSend(cricket::SEND_MICROPHONE) &&
+           channel_->SetPlayout(true);
+  }
+  void DeleteChannel() {
+    delete channel_;
+    channel_ = nullptr;
+  }
   void DeliverPacket(const void* data, int len) {
     rtc::Buffer packet(reinterpret_cast<const uint8_t*>(data), len);
     channel_->OnPacketReceived(&packet, rtc::PacketTime());
@@ -2173,6 +2196,39 @@ TEST_F(WebRtcVoiceEngineTestFake, SetDevices) {
   EXPECT_TRUE(voe_.GetPlayout(recv_channel));
 }
 
+// Test that SetDevices() pauses and resumes a channel on the thread the
+// channel was created on.
+TEST_F(WebRtcVoiceEngineTestFake, SetDevicesWithChannelOnOtherThread) {
+  EXPECT_TRUE(engine_.Init(rtc::Thread::Current()));
+  rtc::Thread thread;
+  thread.Start();
+  WebRtcVoiceEngineTestFake* const fixture = this;
+  int send_channel = -1;
+  int recv_channel = -1;
+  EXPECT_TRUE(thread.Invoke<bool>(
+      rtc::Bind(&WebRtcVoiceEngineTestFake::CreateSendingChannel, fixture,
+                &send_channel, &recv_channel)));
+
+  cricket::Device default_dev(cricket::kFakeDefaultDeviceName,
+                              cricket::kFakeDefaultDeviceId);
+  cricket::Device dev(cricket::kFakeDeviceName,
+                      cricket::kFakeDeviceId);
+
+  EXPECT_TRUE(engine_.SetDevices(&dev, &dev));
+  EXPECT_TRUE(voe_.GetSend(send_channel));
+  EXPECT_TRUE(voe_.GetPlayout(recv_channel));
+
+  voe_.set_playout_fail_channel(recv_channel);
+  voe_.set_send_fail_channel(send_channel);
+  EXPECT_FALSE(engine_.SetDevices(&default_dev, &default_dev));
+  EXPECT_FALSE(voe_.GetSend(send_channel));
+  EXPECT_FALSE(voe_.GetPlayout(recv_channel));
+
+  thread.Invoke<void>(
+      rtc::Bind(&WebRtcVoiceEngineTestFake::DeleteChannel, fixture));
+  thread.Stop();
+}
+
 // Test that we can set the devices to use even if we failed to
 // open the initial ones.
 TEST_F(WebRtcVoiceEngineTestFake, SetDevicesWithInitiallyBadDevices) {
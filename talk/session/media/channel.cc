@@ -2017,6 +2017,28 @@ bool DataChannel::SendData(const SendDataParams& params,
                              media_channel(), params, payload, result));
 }
 
+size_t DataChannel::SendDataBatch(
+    const std::vector<SendDataParams>& params,
+    const std::vector<const rtc::Buffer*>& payloads,
+    SendDataResult* result) {
+  return worker_thread()->Invoke<size_t>(Bind(
+      &DataChannel::SendDataBatch_w, this, params, payloads, result));
+}
+
+size_t DataChannel::SendDataBatch_w(
+    const std::vector<SendDataParams>& params,
+    const std::vector<const rtc::Buffer*>& payloads,
+    SendDataResult* result) {
+  ASSERT(worker_thread() == rtc::Thread::Current());
+  ASSERT(params.size() == payloads.size());
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    if (!media_channel()->SendData(params[i], *payloads[i], result)) {
+      return i;
+    }
+  }
+  return payloads.size();
+}
+
 const ContentInfo* DataChannel::GetFirstContent(
     const SessionDescription* sdesc) {
   return GetFirstDataContent(sdesc);
@@ -2207,7 +2229,7 @@ void DataChannel::OnMessage(rtc::Message *pmsg) {
     case MSG_DATARECEIVED: {
       DataReceivedMessageData* data =
           static_cast<DataReceivedMessageData*>(pmsg->pdata);
-      SignalDataReceived(this, data->params, data->payload);
+      SignalDataReceived(this, data->params, &data->payload);
       delete data;
       break;
     }
@@ -532,6 +532,12 @@ class DataChannel : public BaseChannel {
   virtual bool SendData(const SendDataParams& params,
                         const rtc::Buffer& payload,
                         SendDataResult* result);
+  // Sends |payloads| with the matching |params| in one call to the worker
+  // thread, stopping at the first one that fails. Returns the number of
+  // payloads sent.
+  size_t SendDataBatch(const std::vector<SendDataParams>& params,
+                       const std::vector<const rtc::Buffer*>& payloads,
+                       SendDataResult* result);
 
   void StartMediaMonitor(int cms);
   void StopMediaMonitor();
@@ -544,7 +550,10 @@ class DataChannel : public BaseChannel {
   sigslot::signal2<DataChannel*, const DataMediaInfo&> SignalMediaMonitor;
   sigslot::signal2<DataChannel*, const std::vector<ConnectionInfo>&>
       SignalConnectionMonitor;
-  sigslot::signal3<DataChannel*, const ReceiveDataParams&, const rtc::Buffer&>
+  // The slot handling a data message may take the contents of the payload
+  // instead of copying them; slots that only look at control messages must
+  // not rely on the payload of data messages.
+  sigslot::signal3<DataChannel*, const ReceiveDataParams&, rtc::Buffer*>
       SignalDataReceived;
   // Signal for notifying when the channel becomes ready to send data.
   // That occurs when the channel is enabled, the transport is writable,
@@ -586,11 +595,15 @@ class DataChannel : public BaseChannel {
           payload(data, len) {
     }
     const ReceiveDataParams params;
-    const rtc::Buffer payload;
+    rtc::Buffer payload;
   };
 
   typedef rtc::TypedMessageData<bool> DataChannelReadyToSendMessageData;
 
+  size_t SendDataBatch_w(const std::vector<SendDataParams>& params,
+                         const std::vector<const rtc::Buffer*>& payloads,
+                         SendDataResult* result);
+
   // overrides from BaseChannel
   virtual const ContentInfo* GetFirstContent(const SessionDescription* sdesc);
   // If data_channel_type_ is DCT_NONE, set it.  Otherwise, check that
@@ -236,6 +236,19 @@ void ChannelManager::Terminate() {
   if (!initialized_) {
     return;
   }
+  // The channels are destroyed on their own worker threads, which may differ
+  // from |worker_thread_|.
+  VideoChannels video_channels;
+  VoiceChannels voice_channels;
+  {
+    rtc::CritScope cs(&channels_crit_);
+    video_channels = video_channels_;
+    voice_channels = voice_channels_;
+  }
+  for (auto it = video_channels.rbegin(); it != video_channels.rend(); ++it)
+    DestroyVideoChannel(*it);
+  for (auto it = voice_channels.rbegin(); it != voice_channels.rend(); ++it)
+    DestroyVoiceChannel(*it);
   worker_thread_->Invoke<void>(Bind(&ChannelManager::Terminate_w, this));
   initialized_ = false;
 }
@@ -248,13 +261,6 @@ void ChannelManager::DestructorDeletes_w() {
 
 void ChannelManager::Terminate_w() {
   ASSERT(worker_thread_ == rtc::Thread::Current());
-  // Need to destroy the voice/video channels
-  while (!video_channels_.empty()) {
-    DestroyVideoChannel_w(video_channels_.back());
-  }
-  while (!voice_channels_.empty()) {
-    DestroyVoiceChannel_w(voice_channels_.back());
-  }
   media_engine_->Terminate();
 }
 
@@ -264,7 +270,7 @@ VoiceChannel* ChannelManager::CreateVoiceChannel(
     const std::string& content_name,
     bool rtcp,
     const AudioOptions& options) {
-  return worker_thread_->Invoke<VoiceChannel*>(
+  return transport_controller->worker_thread()->Invoke<VoiceChannel*>(
       Bind(&ChannelManager::CreateVoiceChannel_w, this, media_controller,
            transport_controller, content_name, rtcp, options));
 }
@@ -276,7 +282,7 @@ VoiceChannel* ChannelManager::CreateVoiceChannel_w(
     bool rtcp,
     const AudioOptions& options) {
   ASSERT(initialized_);
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+  ASSERT(transport_controller->worker_thread() == rtc::Thread::Current());
   ASSERT(nullptr != media_controller);
   VoiceMediaChannel* media_channel =
       media_engine_->CreateChannel(media_controller->call_w(), options);
@@ -284,19 +290,21 @@ VoiceChannel* ChannelManager::CreateVoiceChannel_w(
     return nullptr;
 
   VoiceChannel* voice_channel =
-      new VoiceChannel(worker_thread_, media_engine_.get(), media_channel,
+      new VoiceChannel(transport_controller->worker_thread(),
+                       media_engine_.get(), media_channel,
                        transport_controller, content_name, rtcp);
   if (!voice_channel->Init()) {
     delete voice_channel;
     return nullptr;
   }
+  rtc::CritScope cs(&channels_crit_);
   voice_channels_.push_back(voice_channel);
   return voice_channel;
 }
 
 void ChannelManager::DestroyVoiceChannel(VoiceChannel* voice_channel) {
   if (voice_channel) {
-    worker_thread_->Invoke<void>(
+    voice_channel->worker_thread()->Invoke<void>(
         Bind(&ChannelManager::DestroyVoiceChannel_w, this, voice_channel));
   }
 }
@@ -304,13 +312,16 @@ void ChannelManager::DestroyVoiceChannel(VoiceChannel* voice_channel) {
 void ChannelManager::DestroyVoiceChannel_w(VoiceChannel* voice_channel) {
   // Destroy voice channel.
   ASSERT(initialized_);
-  ASSERT(worker_thread_ == rtc::Thread::Current());
-  VoiceChannels::iterator it = std::find(voice_channels_.begin(),
-      voice_channels_.end(), voice_channel);
-  ASSERT(it != voice_channels_.end());
-  if (it == voice_channels_.end())
-    return;
-  voice_channels_.erase(it);
+  ASSERT(voice_channel->worker_thread() == rtc::Thread::Current());
+  {
+    rtc::CritScope cs(&channels_crit_);
+    VoiceChannels::iterator it = std::find(voice_channels_.begin(),
+        voice_channels_.end(), voice_channel);
+    ASSERT(it != voice_channels_.end());
+    if (it == voice_channels_.end())
+      return;
+    voice_channels_.erase(it);
+  }
   delete voice_channel;
 }
 
@@ -320,7 +331,7 @@ VideoChannel* ChannelManager::CreateVideoChannel(
     const std::string& content_name,
     bool rtcp,
     const VideoOptions& options) {
-  return worker_thread_->Invoke<VideoChannel*>(
+  return transport_controller->worker_thread()->Invoke<VideoChannel*>(
       Bind(&ChannelManager::CreateVideoChannel_w, this, media_controller,
            transport_controller, content_name, rtcp, options));
 }
@@ -332,7 +343,7 @@ VideoChannel* ChannelManager::CreateVideoChannel_w(
     bool rtcp,
     const VideoOptions& options) {
   ASSERT(initialized_);
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+  ASSERT(transport_controller->worker_thread() == rtc::Thread::Current());
   ASSERT(nullptr != media_controller);
   VideoMediaChannel* media_channel =
       media_engine_->CreateVideoChannel(media_controller->call_w(), options);
@@ -340,19 +351,21 @@ VideoChannel* ChannelManager::CreateVideoChannel_w(
     return NULL;
   }
 
-  VideoChannel* video_channel = new VideoChannel(
-      worker_thread_, media_channel, transport_controller, content_name, rtcp);
+  VideoChannel* video_channel =
+      new VideoChannel(transport_controller->worker_thread(), media_channel,
+                       transport_controller, content_name, rtcp);
   if (!video_channel->Init()) {
     delete video_channel;
     return NULL;
   }
+  rtc::CritScope cs(&channels_crit_);
   video_channels_.push_back(video_channel);
   return video_channel;
 }
 
 void ChannelManager::DestroyVideoChannel(VideoChannel* video_channel) {
   if (video_channel) {
-    worker_thread_->Invoke<void>(
+    video_channel->worker_thread()->Invoke<void>(
         Bind(&ChannelManager::DestroyVideoChannel_w, this, video_channel));
   }
 }
@@ -360,14 +373,16 @@ void ChannelManager::DestroyVideoChannel(VideoChannel* video_channel) {
 void ChannelManager::DestroyVideoChannel_w(VideoChannel* video_channel) {
   // Destroy video channel.
   ASSERT(initialized_);
-  ASSERT(worker_thread_ == rtc::Thread::Current());
-  VideoChannels::iterator it = std::find(video_channels_.begin(),
-      video_channels_.end(), video_channel);
-  ASSERT(it != video_channels_.end());
-  if (it == video_channels_.end())
-    return;
-
-  video_channels_.erase(it);
+  ASSERT(video_channel->worker_thread() == rtc::Thread::Current());
+  {
+    rtc::CritScope cs(&channels_crit_);
+    VideoChannels::iterator it = std::find(video_channels_.begin(),
+        video_channels_.end(), video_channel);
+    ASSERT(it != video_channels_.end());
+    if (it == video_channels_.end())
+      return;
+    video_channels_.erase(it);
+  }
   delete video_channel;
 }
 
@@ -376,7 +391,7 @@ DataChannel* ChannelManager::CreateDataChannel(
     const std::string& content_name,
     bool rtcp,
     DataChannelType channel_type) {
-  return worker_thread_->Invoke<DataChannel*>(
+  return transport_controller->worker_thread()->Invoke<DataChannel*>(
       Bind(&ChannelManager::CreateDataChannel_w, this, transport_controller,
            content_name, rtcp, channel_type));
 }
@@ -396,20 +411,22 @@ DataChannel* ChannelManager::CreateDataChannel_w(
     return NULL;
   }
 
-  DataChannel* data_channel = new DataChannel(
-      worker_thread_, media_channel, transport_controller, content_name, rtcp);
+  DataChannel* data_channel =
+      new DataChannel(transport_controller->worker_thread(), media_channel,
+                      transport_controller, content_name, rtcp);
   if (!data_channel->Init()) {
     LOG(LS_WARNING) << "Failed to init data channel.";
     delete data_channel;
     return NULL;
   }
+  rtc::CritScope cs(&channels_crit_);
   data_channels_.push_back(data_channel);
   return data_channel;
 }
 
 void ChannelManager::DestroyDataChannel(DataChannel* data_channel) {
   if (data_channel) {
-    worker_thread_->Invoke<void>(
+    data_channel->worker_thread()->Invoke<void>(
         Bind(&ChannelManager::DestroyDataChannel_w, this, data_channel));
   }
 }
@@ -417,13 +434,15 @@ void ChannelManager::DestroyDataChannel(DataChannel* data_channel) {
 void ChannelManager::DestroyDataChannel_w(DataChannel* data_channel) {
   // Destroy data channel.
   ASSERT(initialized_);
-  DataChannels::iterator it = std::find(data_channels_.begin(),
-      data_channels_.end(), data_channel);
-  ASSERT(it != data_channels_.end());
-  if (it == data_channels_.end())
-    return;
-
-  data_channels_.erase(it);
+  {
+    rtc::CritScope cs(&channels_crit_);
+    DataChannels::iterator it = std::find(data_channels_.begin(),
+        data_channels_.end(), data_channel);
+    ASSERT(it != data_channels_.end());
+    if (it == data_channels_.end())
+      return;
+    data_channels_.erase(it);
+  }
   delete data_channel;
 }
 
@@ -595,15 +614,47 @@ bool ChannelManager::IsScreencastRunning() const {
 }
 
 bool ChannelManager::IsScreencastRunning_w() const {
-  VideoChannels::const_iterator it = video_channels_.begin();
-  for ( ; it != video_channels_.end(); ++it) {
-    if ((*it) && (*it)->IsScreencasting()) {
+  // VideoChannel::IsScreencasting() blocks on the worker thread of the
+  // channel, which may be waiting for |channels_crit_| to create or destroy
+  // a channel. So the channels are checked on their worker threads, without
+  // holding the lock.
+  std::vector<rtc::Thread*> threads;
+  {
+    rtc::CritScope cs(&channels_crit_);
+    for (VideoChannel* channel : video_channels_) {
+      if (channel && std::find(threads.begin(), threads.end(),
+                               channel->worker_thread()) == threads.end()) {
+        threads.push_back(channel->worker_thread());
+      }
+    }
+  }
+  for (rtc::Thread* thread : threads) {
+    if (thread->Invoke<bool>(
+            Bind(&ChannelManager::IsScreencastRunningOnThread_w, this))) {
       return true;
     }
   }
   return false;
 }
 
+bool ChannelManager::IsScreencastRunningOnThread_w() const {
+  // The channels of this thread are also destroyed on it, so they stay
+  // valid after the lock is released.
+  VideoChannels channels;
+  {
+    rtc::CritScope cs(&channels_crit_);
+    for (VideoChannel* channel : video_channels_) {
+      if (channel && channel->worker_thread() == rtc::Thread::Current())
+        channels.push_back(channel);
+    }
+  }
+  for (VideoChannel* channel : channels) {
+    if (channel->IsScreencasting())
+      return true;
+  }
+  return false;
+}
+
 void ChannelManager::OnVideoCaptureStateChange(VideoCapturer* capturer,
                                                CaptureState result) {
   // TODO(whyuan): Check capturer and signal failure only for camera video, not
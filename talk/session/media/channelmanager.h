@@ -95,7 +95,9 @@ class ChannelManager : public rtc::MessageHandler,
   // Shuts down the media engine.
   void Terminate();
 
-  // The operations below all occur on the worker thread.
+  // The operations below all occur on the worker thread of the
+  // |transport_controller|, which may differ from the worker thread of the
+  // ChannelManager when PeerConnections are spread over several threads.
   // Creates a voice channel, to be associated with the specified session.
   VoiceChannel* CreateVoiceChannel(
       webrtc::MediaControllerInterface* media_controller,
@@ -124,6 +126,7 @@ class ChannelManager : public rtc::MessageHandler,
 
   // Indicates whether any channels exist.
   bool has_channels() const {
+    rtc::CritScope cs(&channels_crit_);
     return (!voice_channels_.empty() || !video_channels_.empty());
   }
 
@@ -225,6 +228,8 @@ class ChannelManager : public rtc::MessageHandler,
       VideoCapturer* capturer,
       std::vector<cricket::VideoFormat>* out_formats) const;
   bool IsScreencastRunning_w() const;
+  // Checks the video channels whose worker thread is the current thread.
+  bool IsScreencastRunningOnThread_w() const;
   virtual void OnMessage(rtc::Message *message);
 
   rtc::scoped_ptr<MediaEngineInterface> media_engine_;
@@ -234,9 +239,12 @@ class ChannelManager : public rtc::MessageHandler,
   rtc::Thread* main_thread_;
   rtc::Thread* worker_thread_;
 
-  VoiceChannels voice_channels_;
-  VideoChannels video_channels_;
-  DataChannels data_channels_;
+  // Guards the channel lists, which are changed on the worker threads of
+  // the channels.
+  mutable rtc::CriticalSection channels_crit_;
+  VoiceChannels voice_channels_ GUARDED_BY(channels_crit_);
+  VideoChannels video_channels_ GUARDED_BY(channels_crit_);
+  DataChannels data_channels_ GUARDED_BY(channels_crit_);
 
   AudioOptions audio_options_;
   int audio_output_volume_;
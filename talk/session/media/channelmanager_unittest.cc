@@ -159,6 +159,31 @@ TEST_F(ChannelManagerTest, CreateDestroyChannelsOnThread) {
   cm_->Terminate();
 }
 
+// Test that channels on another thread than the worker thread of the
+// ChannelManager are checked and destroyed on their own thread.
+TEST_F(ChannelManagerTest, ChannelsOnOtherThread) {
+  worker_.Start();
+  EXPECT_TRUE(cm_->Init());
+  delete transport_controller_;
+  transport_controller_ =
+      new cricket::FakeTransportController(&worker_, ICEROLE_CONTROLLING);
+  cricket::VoiceChannel* voice_channel =
+      cm_->CreateVoiceChannel(&fake_mc_, transport_controller_,
+                              cricket::CN_AUDIO, false, AudioOptions());
+  ASSERT_TRUE(voice_channel != nullptr);
+  EXPECT_EQ(&worker_, voice_channel->worker_thread());
+  cricket::VideoChannel* video_channel =
+      cm_->CreateVideoChannel(&fake_mc_, transport_controller_,
+                              cricket::CN_VIDEO, false, VideoOptions());
+  ASSERT_TRUE(video_channel != nullptr);
+  EXPECT_EQ(&worker_, video_channel->worker_thread());
+  EXPECT_FALSE(cm_->IsScreencastRunning());
+  EXPECT_TRUE(cm_->has_channels());
+  // Destroys the channels that are left.
+  cm_->Terminate();
+  EXPECT_FALSE(cm_->has_channels());
+}
+
 // Test that we fail to create a voice/video channel if the session is unable
 // to create a cricket::TransportChannel
 TEST_F(ChannelManagerTest, NoTransportChannelTest) {
@@ -163,6 +163,9 @@ webrtc::AudioReceiveStream::Stats AudioReceiveStream::GetStats() const {
 
   stats.capture_start_ntp_time_ms = cs.capture_start_ntp_time_ms_;
 
+  neteq->GetAudioPipelineStatistics(config_.voe_channel_id,
+                                    &stats.pipeline_delays);
+
   return stats;
 }
 
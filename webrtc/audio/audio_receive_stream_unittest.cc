@@ -136,6 +136,16 @@ TEST(AudioReceiveStreamTest, GetStats) {
   EXPECT_EQ(decode_stats.decoded_plc_cng, stats.decoding_plc_cng);
   EXPECT_EQ(call_stats.capture_start_ntp_time_ms_,
             stats.capture_start_ntp_time_ms);
+  const AudioPipelineStatistics& pipeline_stats =
+      voice_engine.GetRecvAudioPipelineStatistics();
+  for (int i = 0; i < kAudioStageCount; ++i) {
+    EXPECT_EQ(pipeline_stats.stages[i].num_blocks,
+              stats.pipeline_delays.stages[i].num_blocks);
+    EXPECT_EQ(pipeline_stats.stages[i].average_us,
+              stats.pipeline_delays.stages[i].average_us);
+    EXPECT_EQ(pipeline_stats.stages[i].max_us,
+              stats.pipeline_delays.stages[i].max_us);
+  }
 }
 }  // namespace test
 }  // namespace webrtc
@@ -51,6 +51,9 @@ class AudioReceiveStream : public ReceiveStream {
     int32_t decoding_cng = 0;
     int32_t decoding_plc_cng = 0;
     int64_t capture_start_ntp_time_ms = 0;
+    // Time spent in each stage of the audio pipeline of the underlying voice
+    // engine channel.
+    AudioPipelineStatistics pipeline_delays;
   };
 
   struct Config {
@@ -12,6 +12,7 @@
 #define WEBRTC_BASE_ASYNCPACKETSOCKET_H_
 
 #include "webrtc/base/dscp.h"
+#include "webrtc/base/fastsignal.h"
 #include "webrtc/base/sigslot.h"
 #include "webrtc/base/socket.h"
 #include "webrtc/base/timeutils.h"
@@ -106,12 +107,13 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
 
   // Emitted each time a packet is read. Used only for UDP and
   // connected TCP sockets.
-  sigslot::signal5<AsyncPacketSocket*, const char*, size_t,
-                   const SocketAddress&,
-                   const PacketTime&> SignalReadPacket;
+  sigslot::fast_signal<AsyncPacketSocket*, const char*, size_t,
+                       const SocketAddress&,
+                       const PacketTime&> SignalReadPacket;
 
   // Emitted each time a packet is sent.
-  sigslot::signal2<AsyncPacketSocket*, const SentPacket&> SignalSentPacket;
+  sigslot::fast_signal<AsyncPacketSocket*, const SentPacket&>
+      SignalSentPacket;
 
   // Emitted when the socket is currently able to send.
   sigslot::signal1<AsyncPacketSocket*> SignalReadyToSend;
@@ -145,6 +145,7 @@
         'diskcache.h',
         'diskcache_win32.cc',
         'diskcache_win32.h',
+        'fastsignal.h',
         'filerotatingstream.cc',
         'filerotatingstream.h',
         'fileutils.cc',
@@ -218,6 +219,8 @@
         'nattypes.h',
         'nethelpers.cc',
         'nethelpers.h',
+        'netlinknetworkmonitor.cc',
+        'netlinknetworkmonitor.h',
         'network.cc',
         'network.h',
         'networkmonitor.cc',
@@ -555,6 +558,8 @@
             'libdbusglibsymboltable.cc',
             'libdbusglibsymboltable.h',
             'linuxfdwalk.c',
+            'netlinknetworkmonitor.cc',
+            'netlinknetworkmonitor.h',
           ],
         }],
         ['OS=="mac"', {
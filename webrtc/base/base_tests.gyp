@@ -62,6 +62,7 @@
           'event_tracer_unittest.cc',
           'event_unittest.cc',
           'exp_filter_unittest.cc',
+          'fastsignal_unittest.cc',
           'filerotatingstream_unittest.cc',
           'fileutils_unittest.cc',
           'helpers_unittest.cc',
@@ -121,6 +122,7 @@
               # TODO(ronghuawu): Reenable this test.
               # 'linux_unittest.cc',
               'linuxfdwalk_unittest.cc',
+              'netlinknetworkmonitor_unittest.cc',
             ],
           }],
           ['OS=="win"', {
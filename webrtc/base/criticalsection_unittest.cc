@@ -220,6 +220,16 @@ TEST(AtomicOpsTest, Simple) {
   EXPECT_EQ(0, value);
 }
 
+TEST(AtomicOpsTest, SimplePtr) {
+  int a = 1;
+  int b = 2;
+  int* volatile ptr = &a;
+  EXPECT_EQ(&a, AtomicOps::AcquireLoadPtr(&ptr));
+  AtomicOps::ReleaseStorePtr(&ptr, &b);
+  EXPECT_EQ(&b, AtomicOps::AcquireLoadPtr(&ptr));
+  EXPECT_EQ(2, *AtomicOps::AcquireLoadPtr(&ptr));
+}
+
 TEST(AtomicOpsTest, Increment) {
   // Create and start lots of threads.
   AtomicOpRunner<IncrementOp, UniqueValueVerifier> runner(0);
@@ -0,0 +1,266 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_FASTSIGNAL_H_
+#define WEBRTC_BASE_FASTSIGNAL_H_
+
+// fast_signal is a drop-in replacement for sigslot::signalN intended for
+// signals that fire on a per-packet basis (e.g. SignalReadPacket).
+//
+// It keeps the sigslot programming model: slots are methods on objects that
+// derive from sigslot::has_slots<>, connected with connect(this, &T::OnFoo)
+// and automatically disconnected when either side is destroyed. What differs
+// is the cost of an emit:
+//  - The first connected slot is stored inline in the signal, so the common
+//    single-subscriber case involves no heap allocation and no list walk.
+//  - A slot is invoked through a plain function pointer rather than through
+//    the two virtual calls (emit + member function) of a sigslot connection.
+//  - With the single_threaded policy (the default in our tree) emitting takes
+//    no lock at all, not even the no-op virtual lock()/unlock() pair.
+//
+// Additional subscribers are kept in a vector and invoked in connection order
+// after the inline slot. Slots may disconnect themselves, or other slots,
+// while the signal is being emitted.
+
+#include <string.h>
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/sigslot.h"
+
+namespace sigslot {
+
+// Scoped lock held while emitting. Specialized below so that single threaded
+// signals don't pay for the (virtual, no-op) lock()/unlock() calls.
+template <class mt_policy>
+class fast_emit_lock {
+ public:
+  explicit fast_emit_lock(mt_policy* mutex) : mutex_(mutex) { mutex_->lock(); }
+  ~fast_emit_lock() { mutex_->unlock(); }
+
+ private:
+  mt_policy* mutex_;
+};
+
+template <>
+class fast_emit_lock<single_threaded> {
+ public:
+  explicit fast_emit_lock(single_threaded* mutex) {}
+};
+
+template <class mt_policy, typename... Args>
+class fast_signal_with_thread_policy : public _signal_base<mt_policy> {
+ public:
+  fast_signal_with_thread_policy() : emit_depth_(0), has_tombstones_(false) {}
+
+  ~fast_signal_with_thread_policy() { disconnect_all(); }
+
+  template <class desttype>
+  void connect(desttype* pclass, void (desttype::*pmemfun)(Args...)) {
+    lock_block<mt_policy> lock(this);
+    static_assert(sizeof(pmemfun) <= sizeof(slot().method),
+                  "Member function pointer too large for inline storage.");
+    slot s;
+    s.dest = pclass;
+    s.object = pclass;
+    memcpy(s.method, &pmemfun, sizeof(pmemfun));
+    s.invoke = &invoke_slot<desttype>;
+    s.rebind = &rebind_slot<desttype>;
+    if (!first_.dest && !emit_depth_) {
+      first_ = s;
+    } else {
+      others_.push_back(s);
+    }
+    pclass->signal_connect(this);
+  }
+
+  void emit(Args... args) {
+    fast_emit_lock<mt_policy> lock(this);
+    if (others_.empty()) {
+      // Fast path. For single threaded signals nothing in |this| is touched
+      // after the slot returns, so the slot may disconnect itself or even
+      // delete the signal's owner.
+      if (first_.dest)
+        first_.invoke(first_, args...);
+      return;
+    }
+
+    ++emit_depth_;
+    if (first_.dest)
+      first_.invoke(first_, args...);
+    // Slots connected from within a callback are not invoked until the next
+    // emit. Use indices since the vector may grow while iterating.
+    const size_t count = others_.size();
+    for (size_t i = 0; i < count; ++i) {
+      if (others_[i].dest)
+        others_[i].invoke(others_[i], args...);
+    }
+    if (--emit_depth_ == 0 && has_tombstones_)
+      compact();
+  }
+
+  void operator()(Args... args) { emit(args...); }
+
+  bool is_empty() {
+    lock_block<mt_policy> lock(this);
+    if (first_.dest)
+      return false;
+    for (size_t i = 0; i < others_.size(); ++i) {
+      if (others_[i].dest)
+        return false;
+    }
+    return true;
+  }
+
+#ifdef _DEBUG
+  bool connected(has_slots_interface* pclass) {
+    lock_block<mt_policy> lock(this);
+    return find(pclass) != NULL;
+  }
+#endif
+
+  void disconnect(has_slots_interface* pclass) {
+    lock_block<mt_policy> lock(this);
+    slot* s = find(pclass);
+    if (!s)
+      return;
+    s->dest = NULL;
+    remove_dead_slots();
+    if (!find(pclass))
+      pclass->signal_disconnect(this);
+  }
+
+  void disconnect_all() {
+    lock_block<mt_policy> lock(this);
+    if (first_.dest) {
+      first_.dest->signal_disconnect(this);
+      first_.dest = NULL;
+    }
+    for (size_t i = 0; i < others_.size(); ++i) {
+      if (others_[i].dest) {
+        others_[i].dest->signal_disconnect(this);
+        others_[i].dest = NULL;
+      }
+    }
+    remove_dead_slots();
+  }
+
+  // _signal_base_interface implementation, called by has_slots.
+  void slot_disconnect(has_slots_interface* pslot) override {
+    lock_block<mt_policy> lock(this);
+    if (first_.dest == pslot)
+      first_.dest = NULL;
+    for (size_t i = 0; i < others_.size(); ++i) {
+      if (others_[i].dest == pslot)
+        others_[i].dest = NULL;
+    }
+    remove_dead_slots();
+  }
+
+  void slot_duplicate(const has_slots_interface* oldtarget,
+                      has_slots_interface* newtarget) override {
+    lock_block<mt_policy> lock(this);
+    std::vector<slot> duplicates;
+    if (first_.dest == oldtarget)
+      duplicates.push_back(first_.duplicate(newtarget));
+    for (size_t i = 0; i < others_.size(); ++i) {
+      if (others_[i].dest == oldtarget)
+        duplicates.push_back(others_[i].duplicate(newtarget));
+    }
+    others_.insert(others_.end(), duplicates.begin(), duplicates.end());
+  }
+
+ private:
+  struct slot {
+    slot() : dest(NULL), object(NULL), invoke(NULL), rebind(NULL) {}
+
+    slot duplicate(has_slots_interface* newdest) const {
+      slot s = *this;
+      s.dest = newdest;
+      s.object = rebind(newdest);
+      return s;
+    }
+
+    has_slots_interface* dest;
+    // |dest| converted to the type the method was connected with.
+    void* object;
+    void (*invoke)(const slot&, Args...);
+    void* (*rebind)(has_slots_interface*);
+    // Room for a pointer to member function, which can be larger than a
+    // regular pointer (e.g. with multiple or virtual inheritance).
+    union {
+      char method[4 * sizeof(void*)];
+      void* aligner;
+    };
+  };
+
+  template <class desttype>
+  static void invoke_slot(const slot& s, Args... args) {
+    void (desttype::*pmemfun)(Args...);
+    memcpy(&pmemfun, s.method, sizeof(pmemfun));
+    (static_cast<desttype*>(s.object)->*pmemfun)(args...);
+  }
+
+  template <class desttype>
+  static void* rebind_slot(has_slots_interface* dest) {
+    return static_cast<desttype*>(dest);
+  }
+
+  slot* find(has_slots_interface* pclass) {
+    if (first_.dest == pclass)
+      return &first_;
+    for (size_t i = 0; i < others_.size(); ++i) {
+      if (others_[i].dest == pclass)
+        return &others_[i];
+    }
+    return NULL;
+  }
+
+  // While emitting, disconnected slots are only marked as dead and cleaned up
+  // once the outermost emit() has finished.
+  void remove_dead_slots() {
+    if (emit_depth_) {
+      has_tombstones_ = true;
+      return;
+    }
+    compact();
+  }
+
+  void compact() {
+    has_tombstones_ = false;
+    size_t live = 0;
+    for (size_t i = 0; i < others_.size(); ++i) {
+      if (others_[i].dest)
+        others_[live++] = others_[i];
+    }
+    others_.resize(live);
+    if (!first_.dest && !others_.empty()) {
+      first_ = others_.front();
+      others_.erase(others_.begin());
+    }
+  }
+
+  slot first_;
+  std::vector<slot> others_;
+  int emit_depth_;
+  bool has_tombstones_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(fast_signal_with_thread_policy);
+};
+
+// Alias with the default threading policy, analogous to sigslot::signalN.
+template <typename... Args>
+using fast_signal =
+    fast_signal_with_thread_policy<SIGSLOT_DEFAULT_MT_POLICY, Args...>;
+
+}  // namespace sigslot
+
+#endif  // WEBRTC_BASE_FASTSIGNAL_H_
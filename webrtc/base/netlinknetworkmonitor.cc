@@ -0,0 +1,494 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/netlinknetworkmonitor.h"
+
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/physicalsocketserver.h"
+#include "webrtc/base/thread.h"
+
+namespace rtc {
+namespace {
+
+// Link changes, and address changes for IPv4 and IPv6.
+const uint32_t kNetlinkGroups =
+    RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+
+// Large enough for any datagram the kernel sends on a NETLINK_ROUTE socket.
+const size_t kReceiveBufferSize = 32 * 1024;
+
+// Socket buffer size, so that bursts of notifications, e.g. when an interface
+// with many addresses goes away, don't overflow the socket.
+const int kSocketBufferSize = 1024 * 1024;
+
+// Returns a NETLINK_ROUTE socket subscribed to |groups|, or -1.
+int OpenNetlinkSocket(uint32_t groups) {
+  int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (fd < 0) {
+    LOG_ERR(LS_WARNING) << "Failed to open netlink socket";
+    return -1;
+  }
+  sockaddr_nl addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.nl_family = AF_NETLINK;
+  addr.nl_groups = groups;
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    LOG_ERR(LS_WARNING) << "Failed to bind netlink socket";
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+bool IsSameAddress(const InterfaceAddressInfo& a,
+                   const InterfaceAddressInfo& b) {
+  return a.interface_name == b.interface_name && a.ip == b.ip &&
+         a.prefix_length == b.prefix_length && a.scope_id == b.scope_id &&
+         a.loopback == b.loopback;
+}
+
+}  // namespace
+
+// Owns the netlink socket and the process-wide copy of the interface
+// addresses, and notifies the monitors when the addresses change.
+class NetlinkAddressTracker : public Dispatcher {
+ public:
+  // Registers |monitor|, creating the shared tracker for the first one.
+  // Returns null if netlink is unavailable.
+  static NetlinkAddressTracker* AddMonitor(NetlinkNetworkMonitor* monitor);
+  // Unregisters |monitor|, which is not notified anymore once this returns.
+  // The tracker goes away with the last monitor.
+  static void RemoveMonitor(NetlinkNetworkMonitor* monitor);
+
+  void GetAddresses(InterfaceAddressList* addresses) const;
+
+  // Dispatcher implementation.
+  uint32_t GetRequestedEvents() override { return DE_READ; }
+  void OnPreEvent(uint32_t ff) override {}
+  void OnEvent(uint32_t ff, int err) override;
+  int GetDescriptor() override { return fd_; }
+  bool IsDescriptorClosed() override { return false; }
+
+ private:
+  struct Link {
+    std::string name;
+    bool loopback;
+  };
+  struct Address {
+    std::string label;
+    int prefix_length;
+  };
+  // Interface index and IP.
+  typedef std::pair<int, IPAddress> AddressKey;
+
+  NetlinkAddressTracker();
+  ~NetlinkAddressTracker() override;
+
+  // Opens the socket, reads the current state and starts the thread.
+  bool Start();
+
+  // Replaces the tables with a dump of the current state.
+  bool Resync();
+  bool ReadDump(int fd, uint16_t type);
+
+  // Applies the netlink messages in the first |size| bytes of |buffer_|.
+  // Sets |done| at the end of a dump. Returns false if the kernel reported
+  // an error.
+  bool HandleMessages(size_t size, bool* done);
+  void HandleLinkMessage(const nlmsghdr* header);
+  void HandleAddressMessage(const nlmsghdr* header);
+
+  // Rebuilds |addresses_| from the tables. Returns true if it changed.
+  bool UpdateAddresses();
+
+  int fd_;
+  uint32_t sequence_number_;
+  scoped_ptr<char[]> buffer_;
+  scoped_ptr<PhysicalSocketServer> socket_server_;
+  scoped_ptr<Thread> thread_;
+
+  // Only accessed on |thread_|, or before it is started.
+  std::map<int, Link> links_;
+  std::map<AddressKey, Address> address_table_;
+
+  mutable CriticalSection crit_;
+  InterfaceAddressList addresses_ GUARDED_BY(crit_);
+  std::set<NetlinkNetworkMonitor*> monitors_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetlinkAddressTracker);
+};
+
+namespace {
+
+// The tracker shared by all monitors, guarded by |g_tracker_lock|.
+GlobalLockPod g_tracker_lock;
+NetlinkAddressTracker* g_tracker = nullptr;
+
+}  // namespace
+
+NetlinkAddressTracker* NetlinkAddressTracker::AddMonitor(
+    NetlinkNetworkMonitor* monitor) {
+  GlobalLockScope ls(&g_tracker_lock);
+  if (!g_tracker) {
+    NetlinkAddressTracker* tracker = new NetlinkAddressTracker();
+    if (!tracker->Start()) {
+      delete tracker;
+      return nullptr;
+    }
+    g_tracker = tracker;
+  }
+  CritScope cs(&g_tracker->crit_);
+  g_tracker->monitors_.insert(monitor);
+  return g_tracker;
+}
+
+void NetlinkAddressTracker::RemoveMonitor(NetlinkNetworkMonitor* monitor) {
+  GlobalLockScope ls(&g_tracker_lock);
+  RTC_DCHECK(g_tracker);
+  bool last_monitor;
+  {
+    CritScope cs(&g_tracker->crit_);
+    g_tracker->monitors_.erase(monitor);
+    last_monitor = g_tracker->monitors_.empty();
+  }
+  if (last_monitor) {
+    delete g_tracker;
+    g_tracker = nullptr;
+  }
+}
+
+NetlinkAddressTracker::NetlinkAddressTracker()
+    : fd_(-1),
+      sequence_number_(0),
+      buffer_(new char[kReceiveBufferSize]) {}
+
+NetlinkAddressTracker::~NetlinkAddressTracker() {
+  if (thread_) {
+    thread_->Stop();
+    socket_server_->Remove(this);
+  }
+  if (fd_ >= 0)
+    close(fd_);
+}
+
+bool NetlinkAddressTracker::Start() {
+  // Subscribe before reading the current state, so that no change is missed.
+  // Notifications of changes that the dump already reflects are harmless.
+  fd_ = OpenNetlinkSocket(kNetlinkGroups);
+  if (fd_ < 0)
+    return false;
+  if (setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &kSocketBufferSize,
+                 sizeof(kSocketBufferSize)) < 0) {
+    LOG_ERR(LS_WARNING) << "Failed to set netlink socket buffer size";
+  }
+  if (!Resync())
+    return false;
+  UpdateAddresses();
+
+  socket_server_.reset(new PhysicalSocketServer());
+  thread_.reset(new Thread(socket_server_.get()));
+  thread_->SetName("NetlinkAddressTracker", this);
+  socket_server_->Add(this);
+  thread_->Start();
+  return true;
+}
+
+void NetlinkAddressTracker::GetAddresses(
+    InterfaceAddressList* addresses) const {
+  CritScope cs(&crit_);
+  *addresses = addresses_;
+}
+
+void NetlinkAddressTracker::OnEvent(uint32_t ff, int err) {
+  bool resync = false;
+  while (true) {
+    sockaddr_nl from;
+    socklen_t from_length = sizeof(from);
+    ssize_t length = recvfrom(fd_, buffer_.get(), kReceiveBufferSize,
+                              MSG_DONTWAIT, reinterpret_cast<sockaddr*>(&from),
+                              &from_length);
+    if (length < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == ENOBUFS) {
+        // Notifications were lost; read the whole state again afterwards.
+        LOG(LS_WARNING) << "Netlink socket overflowed, resyncing.";
+        resync = true;
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        LOG_ERR(LS_WARNING) << "Failed to read from netlink socket";
+      break;
+    }
+    // Only the kernel is trusted.
+    if (from.nl_pid != 0)
+      continue;
+    bool done = false;
+    HandleMessages(static_cast<size_t>(length), &done);
+  }
+  if (resync && !Resync())
+    LOG(LS_ERROR) << "Failed to resync the network interfaces.";
+
+  if (UpdateAddresses()) {
+    CritScope cs(&crit_);
+    for (NetlinkNetworkMonitor* monitor : monitors_)
+      monitor->OnNetworksChanged();
+  }
+}
+
+bool NetlinkAddressTracker::Resync() {
+  int fd = OpenNetlinkSocket(0);
+  if (fd < 0)
+    return false;
+  links_.clear();
+  address_table_.clear();
+  bool success = ReadDump(fd, RTM_GETLINK) && ReadDump(fd, RTM_GETADDR);
+  close(fd);
+  return success;
+}
+
+bool NetlinkAddressTracker::ReadDump(int fd, uint16_t type) {
+  struct {
+    nlmsghdr header;
+    rtgenmsg message;
+  } request;
+  memset(&request, 0, sizeof(request));
+  request.header.nlmsg_len = NLMSG_LENGTH(sizeof(request.message));
+  request.header.nlmsg_type = type;
+  request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  request.header.nlmsg_seq = ++sequence_number_;
+  request.message.rtgen_family = AF_UNSPEC;
+  if (send(fd, &request, request.header.nlmsg_len, 0) < 0) {
+    LOG_ERR(LS_WARNING) << "Failed to request netlink dump";
+    return false;
+  }
+
+  bool done = false;
+  while (!done) {
+    ssize_t length = recv(fd, buffer_.get(), kReceiveBufferSize, 0);
+    if (length < 0) {
+      if (errno == EINTR)
+        continue;
+      LOG_ERR(LS_WARNING) << "Failed to read netlink dump";
+      return false;
+    }
+    if (!HandleMessages(static_cast<size_t>(length), &done))
+      return false;
+  }
+  return true;
+}
+
+bool NetlinkAddressTracker::HandleMessages(size_t size, bool* done) {
+  int remaining = static_cast<int>(size);
+  for (const nlmsghdr* header = reinterpret_cast<nlmsghdr*>(buffer_.get());
+       NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+    switch (header->nlmsg_type) {
+      case NLMSG_DONE:
+        *done = true;
+        return true;
+      case NLMSG_ERROR: {
+        const nlmsgerr* error =
+            static_cast<const nlmsgerr*>(NLMSG_DATA(header));
+        if (header->nlmsg_len >= NLMSG_LENGTH(sizeof(nlmsgerr)) &&
+            error->error != 0) {
+          LOG(LS_WARNING) << "Netlink error: " << -error->error;
+          *done = true;
+          return false;
+        }
+        break;
+      }
+      case RTM_NEWLINK:
+      case RTM_DELLINK:
+        HandleLinkMessage(header);
+        break;
+      case RTM_NEWADDR:
+      case RTM_DELADDR:
+        HandleAddressMessage(header);
+        break;
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+void NetlinkAddressTracker::HandleLinkMessage(const nlmsghdr* header) {
+  if (header->nlmsg_len < NLMSG_LENGTH(sizeof(ifinfomsg)))
+    return;
+  const ifinfomsg* info = static_cast<const ifinfomsg*>(NLMSG_DATA(header));
+  if (header->nlmsg_type == RTM_DELLINK) {
+    links_.erase(info->ifi_index);
+    for (auto it = address_table_.begin(); it != address_table_.end();) {
+      if (it->first.first == info->ifi_index)
+        it = address_table_.erase(it);
+      else
+        ++it;
+    }
+    return;
+  }
+
+  Link link;
+  link.loopback = (info->ifi_flags & IFF_LOOPBACK) != 0;
+  int remaining = IFLA_PAYLOAD(header);
+  for (const rtattr* attr = IFLA_RTA(info); RTA_OK(attr, remaining);
+       attr = RTA_NEXT(attr, remaining)) {
+    if (attr->rta_type == IFLA_IFNAME) {
+      const char* name = static_cast<const char*>(RTA_DATA(attr));
+      link.name.assign(name, strnlen(name, RTA_PAYLOAD(attr)));
+    }
+  }
+  links_[info->ifi_index] = link;
+}
+
+void NetlinkAddressTracker::HandleAddressMessage(const nlmsghdr* header) {
+  if (header->nlmsg_len < NLMSG_LENGTH(sizeof(ifaddrmsg)))
+    return;
+  const ifaddrmsg* message =
+      static_cast<const ifaddrmsg*>(NLMSG_DATA(header));
+  const int family = message->ifa_family;
+  if (family != AF_INET && family != AF_INET6)
+    return;
+
+  const rtattr* address_attr = nullptr;
+  const rtattr* local_attr = nullptr;
+  std::string label;
+  int remaining = IFA_PAYLOAD(header);
+  for (const rtattr* attr = IFA_RTA(message); RTA_OK(attr, remaining);
+       attr = RTA_NEXT(attr, remaining)) {
+    switch (attr->rta_type) {
+      case IFA_ADDRESS:
+        address_attr = attr;
+        break;
+      case IFA_LOCAL:
+        local_attr = attr;
+        break;
+      case IFA_LABEL: {
+        const char* name = static_cast<const char*>(RTA_DATA(attr));
+        label.assign(name, strnlen(name, RTA_PAYLOAD(attr)));
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  // Matches getifaddrs(): IPv4 uses the local address, which differs from
+  // IFA_ADDRESS on point-to-point links, and labels like "eth0:1".
+  const rtattr* ip_attr = address_attr;
+  if (family == AF_INET) {
+    if (local_attr)
+      ip_attr = local_attr;
+  } else {
+    label.clear();
+    if (!ip_attr)
+      ip_attr = local_attr;
+  }
+  if (!ip_attr)
+    return;
+
+  IPAddress ip;
+  if (family == AF_INET) {
+    in_addr addr;
+    if (RTA_PAYLOAD(ip_attr) < sizeof(addr))
+      return;
+    memcpy(&addr, RTA_DATA(ip_attr), sizeof(addr));
+    ip = IPAddress(addr);
+  } else {
+    in6_addr addr;
+    if (RTA_PAYLOAD(ip_attr) < sizeof(addr))
+      return;
+    memcpy(&addr, RTA_DATA(ip_attr), sizeof(addr));
+    ip = IPAddress(addr);
+  }
+
+  AddressKey key(static_cast<int>(message->ifa_index), ip);
+  if (header->nlmsg_type == RTM_DELADDR) {
+    address_table_.erase(key);
+    return;
+  }
+  Address& address = address_table_[key];
+  address.label = label;
+  address.prefix_length = message->ifa_prefixlen;
+}
+
+bool NetlinkAddressTracker::UpdateAddresses() {
+  InterfaceAddressList addresses;
+  for (const auto& kv : address_table_) {
+    auto link = links_.find(kv.first.first);
+    // Left out until the interface is known.
+    if (link == links_.end())
+      continue;
+    InterfaceAddressInfo address;
+    address.interface_name =
+        kv.second.label.empty() ? link->second.name : kv.second.label;
+    address.ip = kv.first.second;
+    address.prefix_length = kv.second.prefix_length;
+    // getifaddrs() sets the scope of link-local addresses too.
+    if (address.ip.family() == AF_INET6 && IPIsLinkLocal(address.ip))
+      address.scope_id = kv.first.first;
+    address.loopback = link->second.loopback;
+    addresses.push_back(address);
+  }
+
+  CritScope cs(&crit_);
+  if (addresses.size() == addresses_.size() &&
+      std::equal(addresses.begin(), addresses.end(), addresses_.begin(),
+                 IsSameAddress)) {
+    return false;
+  }
+  addresses_.swap(addresses);
+  return true;
+}
+
+NetlinkNetworkMonitor::NetlinkNetworkMonitor() : tracker_(nullptr) {}
+
+NetlinkNetworkMonitor::~NetlinkNetworkMonitor() {
+  Stop();
+}
+
+void NetlinkNetworkMonitor::Start() {
+  if (!tracker_)
+    tracker_ = NetlinkAddressTracker::AddMonitor(this);
+}
+
+void NetlinkNetworkMonitor::Stop() {
+  if (tracker_) {
+    NetlinkAddressTracker::RemoveMonitor(this);
+    tracker_ = nullptr;
+  }
+}
+
+bool NetlinkNetworkMonitor::TracksInterfaceAddresses() const {
+  return tracker_ != nullptr;
+}
+
+void NetlinkNetworkMonitor::GetInterfaceAddresses(
+    InterfaceAddressList* addresses) const {
+  if (tracker_)
+    tracker_->GetAddresses(addresses);
+}
+
+}  // namespace rtc
@@ -0,0 +1,53 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_NETLINKNETWORKMONITOR_H_
+#define WEBRTC_BASE_NETLINKNETWORKMONITOR_H_
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/networkmonitor.h"
+
+namespace rtc {
+
+class NetlinkAddressTracker;
+
+// Network monitor for Linux that learns about link and address changes from
+// the kernel over a NETLINK_ROUTE socket.
+//
+// All monitors in a process share one socket, read on one thread, and one
+// copy of the interface addresses. That copy is read with a netlink dump when
+// the first monitor starts and afterwards kept up to date from the netlink
+// notifications, so network managers neither enumerate the interfaces nor
+// poll them. Each monitor fires SignalNetworksChanged on the thread it was
+// created on.
+//
+// If the netlink socket can't be opened, e.g. in a sandbox, the monitor
+// doesn't track the addresses and the network manager falls back to polling.
+class NetlinkNetworkMonitor : public NetworkMonitorBase {
+ public:
+  NetlinkNetworkMonitor();
+  ~NetlinkNetworkMonitor() override;
+
+  void Start() override;
+  void Stop() override;
+
+  bool TracksInterfaceAddresses() const override;
+  void GetInterfaceAddresses(InterfaceAddressList* addresses) const override;
+
+ private:
+  // The shared tracker while started, or null if netlink is unavailable.
+  NetlinkAddressTracker* tracker_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetlinkNetworkMonitor);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_NETLINKNETWORKMONITOR_H_
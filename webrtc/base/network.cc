@@ -48,6 +48,9 @@
 #include <algorithm>
 
 #include "webrtc/base/logging.h"
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+#include "webrtc/base/netlinknetworkmonitor.h"
+#endif
 #include "webrtc/base/networkmonitor.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/socket.h"  // includes something that makes windows happy
@@ -348,81 +351,42 @@ bool BasicNetworkManager::CreateNetworks(bool include_ignored,
 void BasicNetworkManager::ConvertIfAddrs(struct ifaddrs* interfaces,
                                          bool include_ignored,
                                          NetworkList* networks) const {
-  NetworkMap current_networks;
+  InterfaceAddressList addresses;
   for (struct ifaddrs* cursor = interfaces;
        cursor != NULL; cursor = cursor->ifa_next) {
-    IPAddress prefix;
-    IPAddress mask;
-    IPAddress ip;
-    int scope_id = 0;
-
     // Some interfaces may not have address assigned.
     if (!cursor->ifa_addr || !cursor->ifa_netmask)
       continue;
 
+    InterfaceAddressInfo address;
+    IPAddress mask;
     switch (cursor->ifa_addr->sa_family) {
       case AF_INET: {
-        ip = IPAddress(
+        address.ip = IPAddress(
             reinterpret_cast<sockaddr_in*>(cursor->ifa_addr)->sin_addr);
         mask = IPAddress(
             reinterpret_cast<sockaddr_in*>(cursor->ifa_netmask)->sin_addr);
         break;
       }
       case AF_INET6: {
-        if (ipv6_enabled()) {
-          ip = IPAddress(
-              reinterpret_cast<sockaddr_in6*>(cursor->ifa_addr)->sin6_addr);
-
-          if (IsIgnoredIPv6(ip)) {
-            continue;
-          }
-
-          mask = IPAddress(
-              reinterpret_cast<sockaddr_in6*>(cursor->ifa_netmask)->sin6_addr);
-          scope_id =
-              reinterpret_cast<sockaddr_in6*>(cursor->ifa_addr)->sin6_scope_id;
-          break;
-        } else {
-          continue;
-        }
+        address.ip = IPAddress(
+            reinterpret_cast<sockaddr_in6*>(cursor->ifa_addr)->sin6_addr);
+        mask = IPAddress(
+            reinterpret_cast<sockaddr_in6*>(cursor->ifa_netmask)->sin6_addr);
+        address.scope_id =
+            reinterpret_cast<sockaddr_in6*>(cursor->ifa_addr)->sin6_scope_id;
+        break;
       }
       default: {
         continue;
       }
     }
-
-    int prefix_length = CountIPMaskBits(mask);
-    prefix = TruncateIP(ip, prefix_length);
-    std::string key = MakeNetworkKey(std::string(cursor->ifa_name),
-                                     prefix, prefix_length);
-    auto existing_network = current_networks.find(key);
-    if (existing_network == current_networks.end()) {
-      AdapterType adapter_type = ADAPTER_TYPE_UNKNOWN;
-      if (cursor->ifa_flags & IFF_LOOPBACK) {
-        adapter_type = ADAPTER_TYPE_LOOPBACK;
-      }
-#if defined(WEBRTC_IOS)
-      // Cell networks are pdp_ipN on iOS.
-      if (strncmp(cursor->ifa_name, "pdp_ip", 6) == 0) {
-        adapter_type = ADAPTER_TYPE_CELLULAR;
-      }
-#endif
-      // TODO(phoglund): Need to recognize other types as well.
-      scoped_ptr<Network> network(new Network(cursor->ifa_name,
-                                              cursor->ifa_name,
-                                              prefix,
-                                              prefix_length,
-                                              adapter_type));
-      network->set_scope_id(scope_id);
-      network->AddIP(ip);
-      network->set_ignored(IsIgnoredNetwork(*network));
-      if (include_ignored || !network->ignored()) {
-        networks->push_back(network.release());
-      }
-    } else {
-      (*existing_network).second->AddIP(ip);
-    }
+    address.interface_name = cursor->ifa_name;
+    address.prefix_length = CountIPMaskBits(mask);
+    address.loopback = (cursor->ifa_flags & IFF_LOOPBACK) != 0;
+    addresses.push_back(address);
   }
+  ConvertInterfaceAddresses(addresses, include_ignored, networks);
 }
 
 bool BasicNetworkManager::CreateNetworks(bool include_ignored,
@@ -616,6 +580,50 @@ bool IsDefaultRoute(const std::string& network_name) {
 }
 #endif
 
+void BasicNetworkManager::ConvertInterfaceAddresses(
+    const InterfaceAddressList& addresses,
+    bool include_ignored,
+    NetworkList* networks) const {
+  NetworkMap current_networks;
+  for (const InterfaceAddressInfo& address : addresses) {
+    if (address.ip.family() == AF_INET6 &&
+        (!ipv6_enabled() || IsIgnoredIPv6(address.ip))) {
+      continue;
+    }
+
+    IPAddress prefix = TruncateIP(address.ip, address.prefix_length);
+    std::string key = MakeNetworkKey(address.interface_name, prefix,
+                                     address.prefix_length);
+    auto existing_network = current_networks.find(key);
+    if (existing_network == current_networks.end()) {
+      AdapterType adapter_type = ADAPTER_TYPE_UNKNOWN;
+      if (address.loopback) {
+        adapter_type = ADAPTER_TYPE_LOOPBACK;
+      }
+#if defined(WEBRTC_IOS)
+      // Cell networks are pdp_ipN on iOS.
+      if (strncmp(address.interface_name.c_str(), "pdp_ip", 6) == 0) {
+        adapter_type = ADAPTER_TYPE_CELLULAR;
+      }
+#endif
+      // TODO(phoglund): Need to recognize other types as well.
+      scoped_ptr<Network> network(new Network(address.interface_name,
+                                              address.interface_name,
+                                              prefix,
+                                              address.prefix_length,
+                                              adapter_type));
+      network->set_scope_id(address.scope_id);
+      network->AddIP(address.ip);
+      network->set_ignored(IsIgnoredNetwork(*network));
+      if (include_ignored || !network->ignored()) {
+        networks->push_back(network.release());
+      }
+    } else {
+      (*existing_network).second->AddIP(address.ip);
+    }
+  }
+}
+
 bool BasicNetworkManager::IsIgnoredNetwork(const Network& network) const {
   // Ignore networks on the explicit ignore list.
   for (const std::string& ignored_name : network_ignore_list_) {
@@ -689,10 +697,16 @@ void BasicNetworkManager::StopUpdating() {
 
 void BasicNetworkManager::StartNetworkMonitor() {
   NetworkMonitorFactory* factory = NetworkMonitorFactory::GetFactory();
+  if (factory != nullptr) {
+    network_monitor_.reset(factory->CreateNetworkMonitor());
+  }
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  // Without a platform monitor, learn about changes from the kernel rather
+  // than by polling.
   if (factory == nullptr) {
-    return;
+    network_monitor_.reset(new NetlinkNetworkMonitor());
   }
-  network_monitor_.reset(factory->CreateNetworkMonitor());
+#endif
   if (!network_monitor_) {
     return;
   }
@@ -731,7 +745,15 @@ void BasicNetworkManager::UpdateNetworksOnce() {
   ASSERT(Thread::Current() == thread_);
 
   NetworkList list;
-  if (!CreateNetworks(false, &list)) {
+  bool created = true;
+  if (MonitorTracksAddresses()) {
+    InterfaceAddressList addresses;
+    network_monitor_->GetInterfaceAddresses(&addresses);
+    ConvertInterfaceAddresses(addresses, false, &list);
+  } else {
+    created = CreateNetworks(false, &list);
+  }
+  if (!created) {
     SignalError();
   } else {
     bool changed;
@@ -745,7 +767,22 @@ void BasicNetworkManager::UpdateNetworksOnce() {
 
 void BasicNetworkManager::UpdateNetworksContinually() {
   UpdateNetworksOnce();
-  thread_->PostDelayed(kNetworksUpdateIntervalMs, this, kUpdateNetworksMessage);
+  // The monitor signals all changes when it tracks the addresses.
+  if (!MonitorTracksAddresses()) {
+    thread_->PostDelayed(kNetworksUpdateIntervalMs, this,
+                         kUpdateNetworksMessage);
+  }
+}
+
+bool BasicNetworkManager::MonitorTracksAddresses() const {
+  if (!network_monitor_ || !network_monitor_->TracksInterfaceAddresses())
+    return false;
+#if defined(WEBRTC_LINUX)
+  // Route changes are not monitored.
+  if (ignore_non_default_routes_)
+    return false;
+#endif
+  return true;
 }
 
 void BasicNetworkManager::DumpNetworks(bool include_ignored) {
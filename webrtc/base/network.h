@@ -19,6 +19,7 @@
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/ipaddress.h"
 #include "webrtc/base/messagehandler.h"
+#include "webrtc/base/networkmonitor.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/sigslot.h"
 
@@ -29,7 +30,6 @@ struct ifaddrs;
 namespace rtc {
 
 class Network;
-class NetworkMonitorInterface;
 class Thread;
 
 enum AdapterType {
@@ -216,6 +216,12 @@ class BasicNetworkManager : public NetworkManagerBase,
   // Creates a network object for each network available on the machine.
   bool CreateNetworks(bool include_ignored, NetworkList* networks) const;
 
+  // Creates the network objects for the interface |addresses|, as reported
+  // by a network monitor.
+  void ConvertInterfaceAddresses(const InterfaceAddressList& addresses,
+                                 bool include_ignored,
+                                 NetworkList* networks) const;
+
   // Determines if a network should be ignored. This should only be determined
   // based on the network's property instead of any individual IP.
   bool IsIgnoredNetwork(const Network& network) const;
@@ -229,6 +235,9 @@ class BasicNetworkManager : public NetworkManagerBase,
   void StopNetworkMonitor();
   // Called when it receives updates from the network monitor.
   void OnNetworksChanged();
+  // True if the network monitor reports all address changes, so that the
+  // networks don't need to be polled.
+  bool MonitorTracksAddresses() const;
 
   // Updates the networks and reschedules the next update.
   void UpdateNetworksContinually();
@@ -11,12 +11,29 @@
 #ifndef WEBRTC_BASE_NETWORKMONITOR_H_
 #define WEBRTC_BASE_NETWORKMONITOR_H_
 
+#include <string>
+#include <vector>
+
+#include "webrtc/base/ipaddress.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/sigslot.h"
 #include "webrtc/base/thread.h"
 
 namespace rtc {
+
+// An address of a network interface, as tracked by a network monitor.
+struct InterfaceAddressInfo {
+  InterfaceAddressInfo() : prefix_length(0), scope_id(0), loopback(false) {}
+
+  std::string interface_name;
+  IPAddress ip;
+  int prefix_length;
+  int scope_id;
+  bool loopback;
+};
+typedef std::vector<InterfaceAddressInfo> InterfaceAddressList;
+
 /*
  * Receives network-change events via |OnNetworksChanged| and signals the
  * networks changed event.
@@ -49,6 +66,13 @@ class NetworkMonitorInterface {
   // Implementations should call this method on the base when networks change,
   // and the base will fire SignalNetworksChanged on the right thread.
   virtual void OnNetworksChanged() = 0;
+
+  // Returns true if the monitor keeps track of the interface addresses
+  // itself. The network manager then reads them with GetInterfaceAddresses()
+  // when SignalNetworksChanged fires, instead of enumerating the interfaces
+  // and polling them for changes.
+  virtual bool TracksInterfaceAddresses() const { return false; }
+  virtual void GetInterfaceAddresses(InterfaceAddressList* addresses) const {}
 };
 
 class NetworkMonitorBase : public NetworkMonitorInterface,
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_BASE_PHYSICALSOCKETSERVER_H__
 #define WEBRTC_BASE_PHYSICALSOCKETSERVER_H__
 
+#include <set>
 #include <vector>
 
 #include "webrtc/base/asyncfile.h"
@@ -22,6 +23,14 @@
 typedef int SOCKET;
 #endif // WEBRTC_POSIX
 
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// Wait with epoll instead of select, so that the number of sockets is not
+// limited by FD_SETSIZE and a wait only costs time for the sockets that are
+// ready.
+#define WEBRTC_USE_EPOLL 1
+#include <sys/epoll.h>
+#endif
+
 namespace rtc {
 
 // Event constants for the Dispatcher class.
@@ -76,6 +85,9 @@ class PhysicalSocketServer : public SocketServer {
 
   void Add(Dispatcher* dispatcher);
   void Remove(Dispatcher* dispatcher);
+  // Called by a dispatcher that has been added when the events it requests
+  // have changed.
+  void Update(Dispatcher* dispatcher);
 
 #if defined(WEBRTC_POSIX)
   AsyncFile* CreateFile(int fd);
@@ -103,7 +115,24 @@ class PhysicalSocketServer : public SocketServer {
 #if defined(WEBRTC_POSIX)
   static bool InstallSignal(int signum, void (*handler)(int));
 
+  bool WaitSelect(int cms, bool process_io);
+
   scoped_ptr<PosixSignalDispatcher> signal_dispatcher_;
+#endif
+#if defined(WEBRTC_USE_EPOLL)
+  void AddEpoll(Dispatcher* dispatcher);
+  void RemoveEpoll(Dispatcher* dispatcher);
+  void UpdateEpoll(Dispatcher* dispatcher);
+  bool WaitEpoll(int cms);
+  bool WaitPoll(int cms, Dispatcher* dispatcher);
+
+  int epoll_fd_;
+  std::vector<struct epoll_event> epoll_events_;
+  // Dispatchers removed while the events returned by epoll_wait() are being
+  // processed. Their pending events must not be delivered, even if they are
+  // added again in the same round.
+  std::set<Dispatcher*> pending_remove_dispatchers_;
+  bool processing_dispatchers_;
 #endif
   DispatcherList dispatchers_;
   IteratorList iterators_;
@@ -10,6 +10,13 @@
 
 #include <signal.h>
 #include <stdarg.h>
+#if defined(WEBRTC_POSIX)
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <vector>
 
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/logging.h"
@@ -237,6 +244,122 @@ TEST_F(PhysicalSocketTest, TestGetSetOptionsIPv6) {
   SocketTest::TestGetSetOptionsIPv6();
 }
 
+#if defined(WEBRTC_USE_EPOLL)
+class ReadEventSink : public sigslot::has_slots<> {
+ public:
+  ReadEventSink() : signaled_(false) {}
+  void OnReadEvent(AsyncSocket* socket) { signaled_ = true; }
+  bool signaled_;
+};
+
+// With epoll, sockets can be waited for even when their descriptors do not
+// fit in an fd_set.
+TEST_F(PhysicalSocketTest, TestDescriptorAboveFdSetSize) {
+  struct rlimit limit;
+  ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &limit));
+  if (limit.rlim_cur < FD_SETSIZE + 16) {
+    LOG(LS_WARNING) << "Skipping test, open file limit too low.";
+    return;
+  }
+  std::vector<int> fillers;
+  for (int i = 0; i < FD_SETSIZE; ++i) {
+    int fd = open("/dev/null", O_RDONLY);
+    ASSERT_NE(-1, fd);
+    fillers.push_back(fd);
+  }
+
+  PhysicalSocketServer ss;
+  scoped_ptr<AsyncSocket> receiver(ss.CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  scoped_ptr<AsyncSocket> sender(ss.CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_TRUE(receiver);
+  ASSERT_TRUE(sender);
+  ASSERT_EQ(0, receiver->Bind(SocketAddress("127.0.0.1", 0)));
+  ReadEventSink sink;
+  receiver->SignalReadEvent.connect(&sink, &ReadEventSink::OnReadEvent);
+
+  const char kData[] = "data";
+  EXPECT_EQ(static_cast<int>(sizeof(kData)),
+            sender->SendTo(kData, sizeof(kData), receiver->GetLocalAddress()));
+  for (int i = 0; i < 10 && !sink.signaled_; ++i)
+    EXPECT_TRUE(ss.Wait(100, true));
+  EXPECT_TRUE(sink.signaled_);
+
+  for (size_t i = 0; i < fillers.size(); ++i)
+    close(fillers[i]);
+}
+
+// A dispatcher for the read end of a pipe, which removes and adds back
+// another dispatcher on its first event.
+class PipeDispatcher : public Dispatcher {
+ public:
+  PipeDispatcher() : server_(NULL), readd_(NULL), num_events_(0) {
+    fds_[0] = fds_[1] = -1;
+  }
+  ~PipeDispatcher() override {
+    close(fds_[0]);
+    close(fds_[1]);
+  }
+
+  bool Init(PhysicalSocketServer* server) {
+    server_ = server;
+    return pipe(fds_) == 0;
+  }
+  void MakeReadable() { EXPECT_EQ(1, write(fds_[1], "x", 1)); }
+  void ReaddOnEvent(PipeDispatcher* dispatcher) { readd_ = dispatcher; }
+  int num_events() const { return num_events_; }
+
+  uint32_t GetRequestedEvents() override { return DE_READ; }
+  void OnPreEvent(uint32_t ff) override {}
+  void OnEvent(uint32_t ff, int err) override {
+    char c;
+    EXPECT_EQ(1, read(fds_[0], &c, 1));
+    ++num_events_;
+    if (readd_) {
+      server_->Remove(readd_);
+      server_->Add(readd_);
+      readd_ = NULL;
+    }
+  }
+  int GetDescriptor() override { return fds_[0]; }
+  bool IsDescriptorClosed() override { return false; }
+
+ private:
+  PhysicalSocketServer* server_;
+  PipeDispatcher* readd_;
+  int fds_[2];
+  int num_events_;
+};
+
+// The events returned for a dispatcher removed while they are being
+// delivered are dropped even if it is added again, as it may be a new
+// dispatcher at the same address.
+TEST_F(PhysicalSocketTest, TestNoStaleEventsAfterReadd) {
+  PhysicalSocketServer ss;
+  PipeDispatcher first;
+  PipeDispatcher second;
+  ASSERT_TRUE(first.Init(&ss));
+  ASSERT_TRUE(second.Init(&ss));
+  ss.Add(&first);
+  ss.Add(&second);
+  first.MakeReadable();
+  second.MakeReadable();
+  first.ReaddOnEvent(&second);
+  second.ReaddOnEvent(&first);
+
+  // Whichever is delivered first removes and adds back the other one, which
+  // gets no event in this round.
+  EXPECT_TRUE(ss.Wait(0, true));
+  EXPECT_EQ(1, first.num_events() + second.num_events());
+  // The other one is still readable, which the next wait reports.
+  EXPECT_TRUE(ss.Wait(0, true));
+  EXPECT_EQ(1, first.num_events());
+  EXPECT_EQ(1, second.num_events());
+
+  ss.Remove(&first);
+  ss.Remove(&second);
+}
+#endif  // WEBRTC_USE_EPOLL
+
 #if defined(WEBRTC_POSIX)
 
 class PosixSignalDeliveryTest : public testing::Test {
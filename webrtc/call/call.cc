@@ -10,11 +10,14 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 #include "webrtc/audio/audio_receive_stream.h"
 #include "webrtc/audio/audio_send_stream.h"
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread_annotations.h"
@@ -27,15 +30,17 @@
 #include "webrtc/config.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
 #include "webrtc/modules/utility/interface/process_thread.h"
 #include "webrtc/system_wrappers/interface/cpu_info.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
-#include "webrtc/system_wrappers/interface/rw_lock_wrapper.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 #include "webrtc/video/video_receive_stream.h"
 #include "webrtc/video/video_send_stream.h"
 #include "webrtc/video_engine/call_stats.h"
+#include "webrtc/video_engine/vie_sync_service.h"
 #include "webrtc/voice_engine/include/voe_codec.h"
 
 namespace webrtc {
@@ -44,6 +49,18 @@ const int Call::Config::kDefaultStartBitrateBps = 300000;
 
 namespace internal {
 
+// Immutable snapshot of the SSRC routing state of a Call. A new table is
+// built and swapped in whenever a stream is created or destroyed, which lets
+// packets be routed without taking a lock.
+struct RoutingTable {
+  std::unordered_map<uint32_t, AudioReceiveStream*> audio_receive_ssrcs;
+  // Media and RTX SSRCs.
+  std::unordered_map<uint32_t, VideoReceiveStream*> video_receive_ssrcs;
+  std::unordered_map<uint32_t, VideoSendStream*> video_send_ssrcs;
+  std::vector<VideoReceiveStream*> video_receive_streams;
+  std::vector<VideoSendStream*> video_send_streams;
+};
+
 class Call : public webrtc::Call, public PacketReceiver {
  public:
   explicit Call(const Call::Config& config);
@@ -91,38 +108,65 @@ class Call : public webrtc::Call, public PacketReceiver {
                             size_t length,
                             const PacketTime& packet_time);
 
-  void ConfigureSync(const std::string& sync_group)
-      EXCLUSIVE_LOCKS_REQUIRED(receive_crit_);
+  void ConfigureSync(const std::string& sync_group);
+
+  // Keeps the current routing table from being deleted for as long as it is
+  // in scope.
+  class ScopedRoutingRead {
+   public:
+    explicit ScopedRoutingRead(const Call* call);
+    ~ScopedRoutingRead();
+
+    const RoutingTable& table() const { return *table_; }
+
+   private:
+    const Call* const call_;
+    int slot_;
+    const RoutingTable* table_;
+  };
+
+  // Builds a routing table from the streams of the call and swaps it in.
+  // Returns once no thread delivers packets using the previous table anymore.
+  void UpdateRoutingTable();
 
   const int num_cpu_cores_;
   const rtc::scoped_ptr<ProcessThread> module_process_thread_;
   const rtc::scoped_ptr<CallStats> call_stats_;
+  // Updates the audio/video sync of all receive streams.
+  const rtc::scoped_ptr<ViESyncService> sync_service_;
   const rtc::scoped_ptr<CongestionController> congestion_controller_;
   Call::Config config_;
   rtc::ThreadChecker configuration_thread_checker_;
 
-  // Needs to be held while write-locking |receive_crit_| or |send_crit_|. This
+  // Needs to be held while adding streams and signalling network state. This
   // ensures that we have a consistent network state signalled to all senders
   // and receivers.
   rtc::CriticalSection network_enabled_crit_;
   bool network_enabled_ GUARDED_BY(network_enabled_crit_);
 
-  rtc::scoped_ptr<RWLockWrapper> receive_crit_;
+  // The stream maps below are only accessed on the configuration thread.
+  // Packet delivery uses |routing_table_| instead.
   // Audio and Video receive streams are owned by the client that creates them.
-  std::map<uint32_t, AudioReceiveStream*> audio_receive_ssrcs_
-      GUARDED_BY(receive_crit_);
-  std::map<uint32_t, VideoReceiveStream*> video_receive_ssrcs_
-      GUARDED_BY(receive_crit_);
-  std::set<VideoReceiveStream*> video_receive_streams_
-      GUARDED_BY(receive_crit_);
-  std::map<std::string, AudioReceiveStream*> sync_stream_mapping_
-      GUARDED_BY(receive_crit_);
-
-  rtc::scoped_ptr<RWLockWrapper> send_crit_;
+  std::map<uint32_t, AudioReceiveStream*> audio_receive_ssrcs_;
+  std::map<uint32_t, VideoReceiveStream*> video_receive_ssrcs_;
+  std::set<VideoReceiveStream*> video_receive_streams_;
+  std::map<std::string, AudioReceiveStream*> sync_stream_mapping_;
+
   // Audio and Video send streams are owned by the client that creates them.
-  std::map<uint32_t, AudioSendStream*> audio_send_ssrcs_ GUARDED_BY(send_crit_);
-  std::map<uint32_t, VideoSendStream*> video_send_ssrcs_ GUARDED_BY(send_crit_);
-  std::set<VideoSendStream*> video_send_streams_ GUARDED_BY(send_crit_);
+  std::map<uint32_t, AudioSendStream*> audio_send_ssrcs_;
+  std::map<uint32_t, VideoSendStream*> video_send_ssrcs_;
+  // Media and RTX SSRCs, for routing RTCP.
+  std::map<uint32_t, VideoSendStream*> video_send_rtcp_ssrcs_;
+  std::set<VideoSendStream*> video_send_streams_;
+
+  // Current routing table. Replaced, never modified, on the configuration
+  // thread. A replaced table is deleted once the read sections that may use
+  // it have ended: a read section is counted in |routing_readers_| at the
+  // parity of |routing_epoch_| it started in, and the epoch is advanced after
+  // each replacement.
+  const RoutingTable* volatile routing_table_;
+  mutable volatile int routing_readers_[2];
+  volatile int routing_epoch_;
 
   VideoSendStream::RtpStateMap suspended_video_send_ssrcs_;
 
@@ -143,12 +187,14 @@ Call::Call(const Call::Config& config)
     : num_cpu_cores_(CpuInfo::DetectNumberOfCores()),
       module_process_thread_(ProcessThread::Create("ModuleProcessThread")),
       call_stats_(new CallStats()),
+      sync_service_(new ViESyncService()),
       congestion_controller_(new CongestionController(
           module_process_thread_.get(), call_stats_.get())),
       config_(config),
       network_enabled_(true),
-      receive_crit_(RWLockWrapper::CreateRWLock()),
-      send_crit_(RWLockWrapper::CreateRWLock()) {
+      routing_table_(new RoutingTable()),
+      routing_readers_(),
+      routing_epoch_(0) {
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
   RTC_DCHECK_GE(config.bitrate_config.min_bitrate_bps, 0);
   RTC_DCHECK_GE(config.bitrate_config.start_bitrate_bps,
@@ -168,6 +214,7 @@ Call::Call(const Call::Config& config)
   Trace::CreateTrace();
   module_process_thread_->Start();
   module_process_thread_->RegisterModule(call_stats_.get());
+  module_process_thread_->RegisterModule(sync_service_.get());
 
   congestion_controller_->SetBweBitrates(
       config_.bitrate_config.min_bitrate_bps,
@@ -183,7 +230,9 @@ Call::~Call() {
   RTC_CHECK(audio_receive_ssrcs_.empty());
   RTC_CHECK(video_receive_ssrcs_.empty());
   RTC_CHECK(video_receive_streams_.empty());
+  delete routing_table_;
 
+  module_process_thread_->DeRegisterModule(sync_service_.get());
   module_process_thread_->DeRegisterModule(call_stats_.get());
   module_process_thread_->Stop();
   Trace::ReturnTrace();
@@ -206,7 +255,6 @@ webrtc::AudioSendStream* Call::CreateAudioSendStream(
   AudioSendStream* send_stream = new AudioSendStream(config);
   {
     rtc::CritScope lock(&network_enabled_crit_);
-    WriteLockScoped write_lock(*send_crit_);
     RTC_DCHECK(audio_send_ssrcs_.find(config.rtp.ssrc) ==
                audio_send_ssrcs_.end());
     audio_send_ssrcs_[config.rtp.ssrc] = send_stream;
@@ -226,12 +274,9 @@ void Call::DestroyAudioSendStream(webrtc::AudioSendStream* send_stream) {
 
   webrtc::internal::AudioSendStream* audio_send_stream =
       static_cast<webrtc::internal::AudioSendStream*>(send_stream);
-  {
-    WriteLockScoped write_lock(*send_crit_);
-    size_t num_deleted = audio_send_ssrcs_.erase(
-        audio_send_stream->config().rtp.ssrc);
-    RTC_DCHECK(num_deleted == 1);
-  }
+  size_t num_deleted =
+      audio_send_ssrcs_.erase(audio_send_stream->config().rtp.ssrc);
+  RTC_DCHECK(num_deleted == 1);
   delete audio_send_stream;
 }
 
@@ -242,13 +287,11 @@ webrtc::AudioReceiveStream* Call::CreateAudioReceiveStream(
   AudioReceiveStream* receive_stream = new AudioReceiveStream(
       congestion_controller_->GetRemoteBitrateEstimator(false), config,
       config_.voice_engine);
-  {
-    WriteLockScoped write_lock(*receive_crit_);
-    RTC_DCHECK(audio_receive_ssrcs_.find(config.rtp.remote_ssrc) ==
-               audio_receive_ssrcs_.end());
-    audio_receive_ssrcs_[config.rtp.remote_ssrc] = receive_stream;
-    ConfigureSync(config.sync_group);
-  }
+  RTC_DCHECK(audio_receive_ssrcs_.find(config.rtp.remote_ssrc) ==
+             audio_receive_ssrcs_.end());
+  audio_receive_ssrcs_[config.rtp.remote_ssrc] = receive_stream;
+  ConfigureSync(config.sync_group);
+  UpdateRoutingTable();
   return receive_stream;
 }
 
@@ -259,19 +302,17 @@ void Call::DestroyAudioReceiveStream(
   RTC_DCHECK(receive_stream != nullptr);
   webrtc::internal::AudioReceiveStream* audio_receive_stream =
       static_cast<webrtc::internal::AudioReceiveStream*>(receive_stream);
-  {
-    WriteLockScoped write_lock(*receive_crit_);
-    size_t num_deleted = audio_receive_ssrcs_.erase(
-        audio_receive_stream->config().rtp.remote_ssrc);
-    RTC_DCHECK(num_deleted == 1);
-    const std::string& sync_group = audio_receive_stream->config().sync_group;
-    const auto it = sync_stream_mapping_.find(sync_group);
-    if (it != sync_stream_mapping_.end() &&
-        it->second == audio_receive_stream) {
-      sync_stream_mapping_.erase(it);
-      ConfigureSync(sync_group);
-    }
+  size_t num_deleted = audio_receive_ssrcs_.erase(
+      audio_receive_stream->config().rtp.remote_ssrc);
+  RTC_DCHECK(num_deleted == 1);
+  const std::string& sync_group = audio_receive_stream->config().sync_group;
+  const auto it = sync_stream_mapping_.find(sync_group);
+  if (it != sync_stream_mapping_.end() &&
+      it->second == audio_receive_stream) {
+    sync_stream_mapping_.erase(it);
+    ConfigureSync(sync_group);
   }
+  UpdateRoutingTable();
   delete audio_receive_stream;
 }
 
@@ -288,15 +329,16 @@ webrtc::VideoSendStream* Call::CreateVideoSendStream(
       congestion_controller_.get(), config, encoder_config,
       suspended_video_send_ssrcs_);
 
-  // This needs to be taken before send_crit_ as both locks need to be held
-  // while changing network state.
   rtc::CritScope lock(&network_enabled_crit_);
-  WriteLockScoped write_lock(*send_crit_);
   for (uint32_t ssrc : config.rtp.ssrcs) {
     RTC_DCHECK(video_send_ssrcs_.find(ssrc) == video_send_ssrcs_.end());
     video_send_ssrcs_[ssrc] = send_stream;
+    video_send_rtcp_ssrcs_[ssrc] = send_stream;
   }
+  for (uint32_t ssrc : config.rtp.rtx.ssrcs)
+    video_send_rtcp_ssrcs_[ssrc] = send_stream;
   video_send_streams_.insert(send_stream);
+  UpdateRoutingTable();
 
   if (event_log_)
     event_log_->LogVideoSendStreamConfig(config);
@@ -314,28 +356,30 @@ void Call::DestroyVideoSendStream(webrtc::VideoSendStream* send_stream) {
   send_stream->Stop();
 
   VideoSendStream* send_stream_impl = nullptr;
-  {
-    WriteLockScoped write_lock(*send_crit_);
-    auto it = video_send_ssrcs_.begin();
-    while (it != video_send_ssrcs_.end()) {
-      if (it->second == static_cast<VideoSendStream*>(send_stream)) {
-        send_stream_impl = it->second;
-        video_send_ssrcs_.erase(it++);
-      } else {
-        ++it;
-      }
+  auto it = video_send_ssrcs_.begin();
+  while (it != video_send_ssrcs_.end()) {
+    if (it->second == static_cast<VideoSendStream*>(send_stream)) {
+      send_stream_impl = it->second;
+      video_send_ssrcs_.erase(it++);
+    } else {
+      ++it;
     }
-    video_send_streams_.erase(send_stream_impl);
   }
   RTC_CHECK(send_stream_impl != nullptr);
+  it = video_send_rtcp_ssrcs_.begin();
+  while (it != video_send_rtcp_ssrcs_.end()) {
+    if (it->second == send_stream_impl)
+      video_send_rtcp_ssrcs_.erase(it++);
+    else
+      ++it;
+  }
+  video_send_streams_.erase(send_stream_impl);
+  UpdateRoutingTable();
 
   VideoSendStream::RtpStateMap rtp_state = send_stream_impl->GetRtpStates();
 
-  for (VideoSendStream::RtpStateMap::iterator it = rtp_state.begin();
-       it != rtp_state.end();
-       ++it) {
-    suspended_video_send_ssrcs_[it->first] = it->second;
-  }
+  for (const auto& kv : rtp_state)
+    suspended_video_send_ssrcs_[kv.first] = kv.second;
 
   delete send_stream_impl;
 }
@@ -346,12 +390,10 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
   VideoReceiveStream* receive_stream = new VideoReceiveStream(
       num_cpu_cores_, congestion_controller_.get(), config,
-      config_.voice_engine, module_process_thread_.get(), call_stats_.get());
+      config_.voice_engine, module_process_thread_.get(), call_stats_.get(),
+      sync_service_.get());
 
-  // This needs to be taken before receive_crit_ as both locks need to be held
-  // while changing network state.
   rtc::CritScope lock(&network_enabled_crit_);
-  WriteLockScoped write_lock(*receive_crit_);
   RTC_DCHECK(video_receive_ssrcs_.find(config.rtp.remote_ssrc) ==
              video_receive_ssrcs_.end());
   video_receive_ssrcs_[config.rtp.remote_ssrc] = receive_stream;
@@ -363,6 +405,7 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
   video_receive_streams_.insert(receive_stream);
 
   ConfigureSync(config.sync_group);
+  UpdateRoutingTable();
 
   if (!network_enabled_)
     receive_stream->SignalNetworkState(kNetworkDown);
@@ -379,25 +422,23 @@ void Call::DestroyVideoReceiveStream(
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
   RTC_DCHECK(receive_stream != nullptr);
   VideoReceiveStream* receive_stream_impl = nullptr;
-  {
-    WriteLockScoped write_lock(*receive_crit_);
-    // Remove all ssrcs pointing to a receive stream. As RTX retransmits on a
-    // separate SSRC there can be either one or two.
-    auto it = video_receive_ssrcs_.begin();
-    while (it != video_receive_ssrcs_.end()) {
-      if (it->second == static_cast<VideoReceiveStream*>(receive_stream)) {
-        if (receive_stream_impl != nullptr)
-          RTC_DCHECK(receive_stream_impl == it->second);
-        receive_stream_impl = it->second;
-        video_receive_ssrcs_.erase(it++);
-      } else {
-        ++it;
-      }
+  // Remove all ssrcs pointing to a receive stream. As RTX retransmits on a
+  // separate SSRC there can be either one or two.
+  auto it = video_receive_ssrcs_.begin();
+  while (it != video_receive_ssrcs_.end()) {
+    if (it->second == static_cast<VideoReceiveStream*>(receive_stream)) {
+      if (receive_stream_impl != nullptr)
+        RTC_DCHECK(receive_stream_impl == it->second);
+      receive_stream_impl = it->second;
+      video_receive_ssrcs_.erase(it++);
+    } else {
+      ++it;
     }
-    video_receive_streams_.erase(receive_stream_impl);
-    RTC_CHECK(receive_stream_impl != nullptr);
-    ConfigureSync(receive_stream_impl->config().sync_group);
   }
+  video_receive_streams_.erase(receive_stream_impl);
+  RTC_CHECK(receive_stream_impl != nullptr);
+  ConfigureSync(receive_stream_impl->config().sync_group);
+  UpdateRoutingTable();
   delete receive_stream_impl;
 }
 
@@ -418,10 +459,10 @@ Call::Stats Call::GetStats() const {
   stats.recv_bandwidth_bps = recv_bandwidth;
   stats.pacer_delay_ms = congestion_controller_->GetPacerQueuingDelayMs();
   {
-    ReadLockScoped read_lock(*send_crit_);
+    ScopedRoutingRead read(this);
     // TODO(solenberg): Add audio send streams.
-    for (const auto& kv : video_send_ssrcs_) {
-      int rtt_ms = kv.second->GetRtt();
+    for (VideoSendStream* stream : read.table().video_send_streams) {
+      int rtt_ms = stream->GetRtt();
       if (rtt_ms > 0)
         stats.rtt_ms = rtt_ms;
     }
@@ -459,20 +500,14 @@ void Call::SignalNetworkState(NetworkState state) {
   rtc::CritScope lock(&network_enabled_crit_);
   network_enabled_ = state == kNetworkUp;
   congestion_controller_->SignalNetworkState(state);
-  {
-    ReadLockScoped write_lock(*send_crit_);
-    for (auto& kv : audio_send_ssrcs_) {
-      kv.second->SignalNetworkState(state);
-    }
-    for (auto& kv : video_send_ssrcs_) {
-      kv.second->SignalNetworkState(state);
-    }
+  for (auto& kv : audio_send_ssrcs_) {
+    kv.second->SignalNetworkState(state);
   }
-  {
-    ReadLockScoped write_lock(*receive_crit_);
-    for (auto& kv : video_receive_ssrcs_) {
-      kv.second->SignalNetworkState(state);
-    }
+  for (auto& kv : video_send_ssrcs_) {
+    kv.second->SignalNetworkState(state);
+  }
+  for (auto& kv : video_receive_ssrcs_) {
+    kv.second->SignalNetworkState(state);
   }
 }
 
@@ -529,32 +564,99 @@ void Call::ConfigureSync(const std::string& sync_group) {
   }
 }
 
+Call::ScopedRoutingRead::ScopedRoutingRead(const Call* call) : call_(call) {
+  // Register in the current epoch. If the epoch advanced meanwhile, the
+  // writer may already have stopped waiting for that slot, so try again.
+  while (true) {
+    slot_ = rtc::AtomicOps::AcquireLoad(&call_->routing_epoch_) & 1;
+    rtc::AtomicOps::Increment(&call_->routing_readers_[slot_]);
+    if ((rtc::AtomicOps::AcquireLoad(&call_->routing_epoch_) & 1) == slot_)
+      break;
+    rtc::AtomicOps::Decrement(&call_->routing_readers_[slot_]);
+  }
+  table_ = rtc::AtomicOps::AcquireLoadPtr(&call_->routing_table_);
+}
+
+Call::ScopedRoutingRead::~ScopedRoutingRead() {
+  rtc::AtomicOps::Decrement(&call_->routing_readers_[slot_]);
+}
+
+void Call::UpdateRoutingTable() {
+  RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
+  RoutingTable* table = new RoutingTable();
+  table->audio_receive_ssrcs.insert(audio_receive_ssrcs_.begin(),
+                                    audio_receive_ssrcs_.end());
+  table->video_receive_ssrcs.insert(video_receive_ssrcs_.begin(),
+                                    video_receive_ssrcs_.end());
+  table->video_send_ssrcs.insert(video_send_rtcp_ssrcs_.begin(),
+                                 video_send_rtcp_ssrcs_.end());
+  table->video_receive_streams.assign(video_receive_streams_.begin(),
+                                      video_receive_streams_.end());
+  table->video_send_streams.assign(video_send_streams_.begin(),
+                                   video_send_streams_.end());
+
+  const RoutingTable* old_table = routing_table_;
+  rtc::AtomicOps::ReleaseStorePtr(&routing_table_,
+                                  static_cast<const RoutingTable*>(table));
+  // Read sections starting from here on see the new table. Advance the epoch
+  // and wait for the read sections of the previous one to end.
+  int slot = (rtc::AtomicOps::Increment(&routing_epoch_) - 1) & 1;
+  while (rtc::AtomicOps::AcquireLoad(&routing_readers_[slot]) != 0)
+    SleepMs(0);
+  delete old_table;
+}
+
 PacketReceiver::DeliveryStatus Call::DeliverRtcp(MediaType media_type,
                                                  const uint8_t* packet,
                                                  size_t length) {
-  // TODO(pbos): Figure out what channel needs it actually.
-  //             Do NOT broadcast! Also make sure it's a valid packet.
-  //             Return DELIVERY_UNKNOWN_SSRC if it can be determined that
-  //             there's no receiver of the packet.
-  bool rtcp_delivered = false;
-  if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
-    ReadLockScoped read_lock(*receive_crit_);
-    for (VideoReceiveStream* stream : video_receive_streams_) {
-      if (stream->DeliverRtcp(packet, length)) {
-        rtcp_delivered = true;
-        if (event_log_)
-          event_log_->LogRtcpPacket(true, media_type, packet, length);
+  // TODO(pbos): Make sure it's a valid packet.
+  if (media_type != MediaType::ANY && media_type != MediaType::VIDEO)
+    return DELIVERY_PACKET_ERROR;
+
+  std::vector<uint32_t> ssrcs;
+  bool parsed = RTCPUtility::RtcpParseSsrcs(packet, length, &ssrcs);
+
+  ScopedRoutingRead read(this);
+  const RoutingTable& table = read.table();
+  // Only deliver the packet to the streams it refers to.
+  std::vector<VideoReceiveStream*> receive_streams;
+  std::vector<VideoSendStream*> send_streams;
+  if (parsed) {
+    for (uint32_t ssrc : ssrcs) {
+      auto receive_it = table.video_receive_ssrcs.find(ssrc);
+      if (receive_it != table.video_receive_ssrcs.end() &&
+          std::find(receive_streams.begin(), receive_streams.end(),
+                    receive_it->second) == receive_streams.end()) {
+        receive_streams.push_back(receive_it->second);
+      }
+      auto send_it = table.video_send_ssrcs.find(ssrc);
+      if (send_it != table.video_send_ssrcs.end() &&
+          std::find(send_streams.begin(), send_streams.end(),
+                    send_it->second) == send_streams.end()) {
+        send_streams.push_back(send_it->second);
       }
     }
   }
-  if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
-    ReadLockScoped read_lock(*send_crit_);
-    for (VideoSendStream* stream : video_send_streams_) {
-      if (stream->DeliverRtcp(packet, length)) {
-        rtcp_delivered = true;
-        if (event_log_)
-          event_log_->LogRtcpPacket(false, media_type, packet, length);
-      }
+  // Broadcast packets that don't refer to any stream, e.g. receiver reports
+  // without report blocks, as the streams may still make use of them.
+  if (receive_streams.empty() && send_streams.empty()) {
+    receive_streams = table.video_receive_streams;
+    send_streams = table.video_send_streams;
+  }
+
+  bool rtcp_delivered = false;
+  for (VideoReceiveStream* stream : receive_streams) {
+    if (stream->DeliverRtcp(packet, length)) {
+      rtcp_delivered = true;
+      if (event_log_)
+        event_log_->LogRtcpPacket(true, media_type, packet, length);
+    }
+  }
+  for (VideoSendStream* stream : send_streams) {
+    if (stream->DeliverRtcp(packet, length)) {
+      rtcp_delivered = true;
+      if (event_log_)
+        event_log_->LogRtcpPacket(false, media_type, packet, length);
     }
   }
   return rtcp_delivered ? DELIVERY_OK : DELIVERY_PACKET_ERROR;
@@ -570,10 +672,11 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
 
   uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(&packet[8]);
 
-  ReadLockScoped read_lock(*receive_crit_);
+  ScopedRoutingRead read(this);
+  const RoutingTable& table = read.table();
   if (media_type == MediaType::ANY || media_type == MediaType::AUDIO) {
-    auto it = audio_receive_ssrcs_.find(ssrc);
-    if (it != audio_receive_ssrcs_.end()) {
+    auto it = table.audio_receive_ssrcs.find(ssrc);
+    if (it != table.audio_receive_ssrcs.end()) {
       auto status = it->second->DeliverRtp(packet, length, packet_time)
                         ? DELIVERY_OK
                         : DELIVERY_PACKET_ERROR;
@@ -583,8 +686,8 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
     }
   }
   if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
-    auto it = video_receive_ssrcs_.find(ssrc);
-    if (it != video_receive_ssrcs_.end()) {
+    auto it = table.video_receive_ssrcs.find(ssrc);
+    if (it != table.video_receive_ssrcs.end()) {
       auto status = it->second->DeliverRtp(packet, length, packet_time)
                         ? DELIVERY_OK
                         : DELIVERY_PACKET_ERROR;
@@ -0,0 +1,218 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/stringencode.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/call.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/test/fake_decoder.h"
+#include "webrtc/test/fake_voice_engine.h"
+#include "webrtc/test/null_transport.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kNumStreams[] = {1, 10, 100, 1000};
+const size_t kNumThreads[] = {1, 4};
+const size_t kPacketsPerThread = 200000;
+const size_t kRtpPacketSize = 172;
+const uint32_t kFirstRemoteSsrc = 1000;
+const uint32_t kLocalSsrc = 1;
+const uint8_t kAudioPayloadType = 0;
+const int kVideoPayloadType = 123;
+
+// Delivers |kPacketsPerThread| packets, taken from |packets| round robin.
+class DeliveryThread {
+ public:
+  DeliveryThread(PacketReceiver* receiver,
+                 MediaType media_type,
+                 const std::vector<std::vector<uint8_t>>* packets,
+                 size_t first_packet)
+      : receiver_(receiver),
+        media_type_(media_type),
+        packets_(packets),
+        first_packet_(first_packet),
+        packets_delivered_(0),
+        thread_(ThreadWrapper::CreateThread(&Run, this, "DeliveryThread")) {}
+
+  void Start() { thread_->Start(); }
+  void Stop() { thread_->Stop(); }
+  size_t packets_delivered() const { return packets_delivered_; }
+
+ private:
+  static bool Run(void* obj) {
+    static_cast<DeliveryThread*>(obj)->DeliverPackets();
+    return false;
+  }
+
+  void DeliverPackets() {
+    size_t index = first_packet_ % packets_->size();
+    for (size_t i = 0; i < kPacketsPerThread; ++i) {
+      const std::vector<uint8_t>& packet = (*packets_)[index];
+      if (receiver_->DeliverPacket(media_type_, &packet[0], packet.size(),
+                                   PacketTime()) ==
+          PacketReceiver::DELIVERY_OK) {
+        ++packets_delivered_;
+      }
+      if (++index == packets_->size())
+        index = 0;
+    }
+  }
+
+  PacketReceiver* const receiver_;
+  const MediaType media_type_;
+  const std::vector<std::vector<uint8_t>>* const packets_;
+  const size_t first_packet_;
+  size_t packets_delivered_;
+  rtc::scoped_ptr<ThreadWrapper> thread_;
+};
+
+class PacketDeliveryPerfTest : public ::testing::Test {
+ protected:
+  PacketDeliveryPerfTest() : voice_engine_(new test::FakeVoiceEngine()) {
+    Call::Config config;
+    config.voice_engine = voice_engine_.get();
+    call_.reset(Call::Create(config));
+  }
+
+  ~PacketDeliveryPerfTest() {
+    for (AudioReceiveStream* stream : audio_streams_)
+      call_->DestroyAudioReceiveStream(stream);
+    for (VideoReceiveStream* stream : video_streams_)
+      call_->DestroyVideoReceiveStream(stream);
+  }
+
+  void SetNumAudioStreams(size_t num_streams) {
+    for (size_t i = audio_streams_.size(); i < num_streams; ++i) {
+      AudioReceiveStream::Config config;
+      config.rtp.remote_ssrc = kFirstRemoteSsrc + i;
+      config.voe_channel_id = static_cast<int>(i);
+      audio_streams_.push_back(call_->CreateAudioReceiveStream(config));
+    }
+  }
+
+  void SetNumVideoStreams(size_t num_streams) {
+    for (size_t i = video_streams_.size(); i < num_streams; ++i) {
+      VideoReceiveStream::Config config(&transport_);
+      config.rtp.remote_ssrc = kFirstRemoteSsrc + i;
+      config.rtp.local_ssrc = kLocalSsrc;
+      VideoReceiveStream::Decoder decoder;
+      decoder.decoder = &decoder_;
+      decoder.payload_type = kVideoPayloadType;
+      decoder.payload_name = "FAKE";
+      config.decoders.push_back(decoder);
+      video_streams_.push_back(call_->CreateVideoReceiveStream(config));
+    }
+  }
+
+  // Builds one RTP packet for each of |num_streams| remote SSRCs.
+  static std::vector<std::vector<uint8_t>> CreateRtpPackets(
+      size_t num_streams) {
+    std::vector<std::vector<uint8_t>> packets;
+    for (size_t i = 0; i < num_streams; ++i) {
+      std::vector<uint8_t> packet(kRtpPacketSize);
+      packet[0] = 0x80;
+      packet[1] = kAudioPayloadType;
+      ByteWriter<uint16_t>::WriteBigEndian(&packet[2],
+                                           static_cast<uint16_t>(i));
+      ByteWriter<uint32_t>::WriteBigEndian(&packet[4], 160 * i);
+      ByteWriter<uint32_t>::WriteBigEndian(&packet[8], kFirstRemoteSsrc + i);
+      packets.push_back(packet);
+    }
+    return packets;
+  }
+
+  // Builds one sender report for each of |num_streams| remote SSRCs.
+  static std::vector<std::vector<uint8_t>> CreateRtcpPackets(
+      size_t num_streams) {
+    std::vector<std::vector<uint8_t>> packets;
+    for (size_t i = 0; i < num_streams; ++i) {
+      rtcp::SenderReport sr;
+      sr.From(kFirstRemoteSsrc + i);
+      sr.WithNtpSec(static_cast<uint32_t>(i));
+      rtcp::Sdes sdes;
+      sdes.WithCName(kFirstRemoteSsrc + i, "perf");
+      sr.Append(&sdes);
+      rtc::scoped_ptr<rtcp::RawPacket> packet(sr.Build());
+      packets.push_back(std::vector<uint8_t>(
+          packet->Buffer(), packet->Buffer() + packet->Length()));
+    }
+    return packets;
+  }
+
+  // Delivers |kPacketsPerThread| packets, taken from |packets| round robin,
+  // on each of |num_threads| threads. Returns the time spent per packet.
+  size_t MeasureDeliveryNs(MediaType media_type,
+                           const std::vector<std::vector<uint8_t>>& packets,
+                           size_t num_threads) {
+    std::vector<DeliveryThread*> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads.push_back(
+          new DeliveryThread(call_->Receiver(), media_type, &packets, i));
+    }
+    uint64_t start_ns = rtc::TimeNanos();
+    for (DeliveryThread* thread : threads)
+      thread->Start();
+    for (DeliveryThread* thread : threads) {
+      thread->Stop();
+      EXPECT_EQ(kPacketsPerThread, thread->packets_delivered());
+      delete thread;
+    }
+    uint64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+    return static_cast<size_t>(elapsed_ns / (kPacketsPerThread * num_threads));
+  }
+
+  rtc::scoped_ptr<test::FakeVoiceEngine> voice_engine_;
+  rtc::scoped_ptr<Call> call_;
+  test::NullTransport transport_;
+  test::FakeDecoder decoder_;
+  std::vector<AudioReceiveStream*> audio_streams_;
+  std::vector<VideoReceiveStream*> video_streams_;
+};
+
+TEST_F(PacketDeliveryPerfTest, DeliverRtp) {
+  for (size_t num_streams : kNumStreams) {
+    SetNumAudioStreams(num_streams);
+    std::vector<std::vector<uint8_t>> packets = CreateRtpPackets(num_streams);
+    for (size_t num_threads : kNumThreads) {
+      test::PrintResult(
+          "call_deliver_rtp", "_" + rtc::ToString(num_threads) + "_threads",
+          rtc::ToString(num_streams) + "_streams",
+          MeasureDeliveryNs(MediaType::AUDIO, packets, num_threads),
+          "ns/packet", false);
+    }
+  }
+}
+
+TEST_F(PacketDeliveryPerfTest, DeliverRtcp) {
+  for (size_t num_streams : kNumStreams) {
+    SetNumVideoStreams(num_streams);
+    std::vector<std::vector<uint8_t>> packets = CreateRtcpPackets(num_streams);
+    for (size_t num_threads : kNumThreads) {
+      test::PrintResult(
+          "call_deliver_rtcp", "_" + rtc::ToString(num_threads) + "_threads",
+          rtc::ToString(num_streams) + "_streams",
+          MeasureDeliveryNs(MediaType::VIDEO, packets, num_threads),
+          "ns/packet", false);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -51,6 +51,7 @@
         'real_fourier.h',
         'real_fourier_ooura.cc',
         'real_fourier_ooura.h',
+        'real_fourier_sse.h',
         'resampler/include/push_resampler.h',
         'resampler/include/resampler.h',
         'resampler/push_resampler.cc',
@@ -198,7 +199,13 @@
           'type': 'static_library',
           'sources': [
             'fir_filter_sse.cc',
+            'real_fourier_sse.cc',
             'resampler/sinc_resampler_sse.cc',
+            'signal_processing/cross_correlation_sse2.c',
+            'signal_processing/dot_product_with_scale_sse2.c',
+            'signal_processing/downsample_fast_sse2.c',
+            'signal_processing/min_max_operations_sse2.c',
+            'signal_processing/vector_scaling_operations_sse2.c',
           ],
           'conditions': [
             ['os_posix==1', {
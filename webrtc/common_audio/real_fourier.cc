@@ -13,7 +13,9 @@
 #include "webrtc/base/checks.h"
 #include "webrtc/common_audio/real_fourier_ooura.h"
 #include "webrtc/common_audio/real_fourier_openmax.h"
+#include "webrtc/common_audio/real_fourier_sse.h"
 #include "webrtc/common_audio/signal_processing/include/spl_inl.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 namespace webrtc {
 
@@ -25,6 +27,16 @@ rtc::scoped_ptr<RealFourier> RealFourier::Create(int fft_order) {
 #if defined(RTC_USE_OPENMAX_DL)
   return rtc::scoped_ptr<RealFourier>(new RealFourierOpenmax(fft_order));
 #else
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  return rtc::scoped_ptr<RealFourier>(new RealFourierSSE2(fft_order));
+#else
+  // x86 CPU detection required.
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    return rtc::scoped_ptr<RealFourier>(new RealFourierSSE2(fft_order));
+  }
+#endif
+#endif
   return rtc::scoped_ptr<RealFourier>(new RealFourierOoura(fft_order));
 #endif
 }
@@ -12,8 +12,10 @@
 
 #include <cmath>
 #include <algorithm>
+#include <vector>
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/common_audio/fft4g.h"
 
 namespace webrtc {
@@ -32,17 +34,45 @@ size_t ComputeWorkIpSize(size_t fft_length) {
       static_cast<float>(fft_length))));
 }
 
+// Work arrays initialized by a first transform, so that the instances only
+// need to copy them.
+struct WorkArrays {
+  explicit WorkArrays(size_t fft_length)
+      : ip(ComputeWorkIpSize(fft_length)), w(fft_length / 2 + 1) {
+    std::vector<float> zeros(fft_length);
+    WebRtc_rdft(fft_length, 1, &zeros[0], &ip[0], &w[0]);
+  }
+
+  std::vector<size_t> ip;
+  std::vector<float> w;
+};
+
+// Returns the work arrays for |fft_order|, computed once and never freed.
+const WorkArrays& GetWorkArrays(int fft_order) {
+  static rtc::GlobalLockPod lock;
+  static const WorkArrays* work_arrays[31];
+  RTC_CHECK_GE(fft_order, 1);
+  RTC_CHECK_LT(fft_order, 31);
+  rtc::GlobalLockScope scope(&lock);
+  if (!work_arrays[fft_order]) {
+    work_arrays[fft_order] =
+        new WorkArrays(RealFourier::FftLength(fft_order));
+  }
+  return *work_arrays[fft_order];
+}
+
 }  // namespace
 
 RealFourierOoura::RealFourierOoura(int fft_order)
     : order_(fft_order),
       length_(FftLength(order_)),
       complex_length_(ComplexLength(order_)),
-      // Zero-initializing work_ip_ will cause rdft to initialize these work
-      // arrays on the first call.
-      work_ip_(new size_t[ComputeWorkIpSize(length_)]()),
-      work_w_(new float[complex_length_]()) {
+      work_ip_(new size_t[ComputeWorkIpSize(length_)]),
+      work_w_(new float[complex_length_]) {
   RTC_CHECK_GE(fft_order, 1);
+  const WorkArrays& work_arrays = GetWorkArrays(fft_order);
+  std::copy(work_arrays.ip.begin(), work_arrays.ip.end(), work_ip_.get());
+  std::copy(work_arrays.w.begin(), work_arrays.w.end(), work_w_.get());
 }
 
 void RealFourierOoura::Forward(const float* src, complex<float>* dest) const {
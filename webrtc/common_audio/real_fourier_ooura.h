@@ -34,7 +34,8 @@ class RealFourierOoura : public RealFourier {
   const size_t length_;
   const size_t complex_length_;
   // These are work arrays for Ooura. The names are based on the comments in
-  // fft4g.c.
+  // fft4g.c. Both start as copies of the arrays shared by all the instances
+  // of the same order, as Ooura writes to them.
   const rtc::scoped_ptr<size_t[]> work_ip_;
   const rtc::scoped_ptr<float[]> work_w_;
 };
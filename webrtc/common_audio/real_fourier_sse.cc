@@ -0,0 +1,314 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/real_fourier_sse.h"
+
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
+
+namespace webrtc {
+
+using std::complex;
+
+struct RealFourierSSE2::Twiddles {
+  explicit Twiddles(int order);
+
+  // exp(-2 pi i p / n) for the n / 2 butterflies of each Stockham pass over n
+  // points, one pass after the other.
+  std::vector<float> pass_re;
+  std::vector<float> pass_im;
+  // exp(-2 pi i k / N), for the FFT length N, to split the complex DFT into
+  // the real one.
+  std::vector<float> split_re;
+  std::vector<float> split_im;
+};
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Returns the twiddle factors for |order|, computed once and never freed.
+const RealFourierSSE2::Twiddles& GetTwiddles(int order) {
+  static rtc::GlobalLockPod lock;
+  static const RealFourierSSE2::Twiddles* twiddles[31];
+  RTC_CHECK_GE(order, 1);
+  RTC_CHECK_LT(order, 31);
+  rtc::GlobalLockScope scope(&lock);
+  if (!twiddles[order]) {
+    twiddles[order] = new RealFourierSSE2::Twiddles(order);
+  }
+  return *twiddles[order];
+}
+
+__m128 Reverse(__m128 v) {
+  return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+// Radix-2 butterfly: s = a + b and t = (a - b) * w.
+void Butterfly(__m128 a_re, __m128 a_im, __m128 b_re, __m128 b_im,
+               __m128 w_re, __m128 w_im, __m128* s_re, __m128* s_im,
+               __m128* t_re, __m128* t_im) {
+  const __m128 d_re = _mm_sub_ps(a_re, b_re);
+  const __m128 d_im = _mm_sub_ps(a_im, b_im);
+  *s_re = _mm_add_ps(a_re, b_re);
+  *s_im = _mm_add_ps(a_im, b_im);
+  *t_re = _mm_sub_ps(_mm_mul_ps(d_re, w_re), _mm_mul_ps(d_im, w_im));
+  *t_im = _mm_add_ps(_mm_mul_ps(d_re, w_im), _mm_mul_ps(d_im, w_re));
+}
+
+// One Stockham pass over 2 * |half| * |stride| points, in aligned arrays.
+// Butterfly p combines the |stride| points starting at |stride| * p with
+// those |half| * |stride| points later, and writes them to 2 * |stride| * p
+// and |stride| points later. The first two passes have too short runs of
+// points, so they run over four butterflies at a time instead.
+void Pass(const float* x_re, const float* x_im, float* y_re, float* y_im,
+          size_t half, size_t stride, const float* w_re, const float* w_im) {
+  const size_t span = half * stride;
+  __m128 s_re, s_im, t_re, t_im;
+  if (stride >= 4) {
+    for (size_t p = 0; p < half; ++p) {
+      const __m128 wr = _mm_set1_ps(w_re[p]);
+      const __m128 wi = _mm_set1_ps(w_im[p]);
+      const size_t in = stride * p;
+      const size_t out = 2 * stride * p;
+      for (size_t q = 0; q < stride; q += 4) {
+        Butterfly(_mm_load_ps(&x_re[in + q]), _mm_load_ps(&x_im[in + q]),
+                  _mm_load_ps(&x_re[in + span + q]),
+                  _mm_load_ps(&x_im[in + span + q]), wr, wi, &s_re, &s_im,
+                  &t_re, &t_im);
+        _mm_store_ps(&y_re[out + q], s_re);
+        _mm_store_ps(&y_im[out + q], s_im);
+        _mm_store_ps(&y_re[out + stride + q], t_re);
+        _mm_store_ps(&y_im[out + stride + q], t_im);
+      }
+    }
+  } else if (stride == 1 && half >= 4) {
+    for (size_t p = 0; p < half; p += 4) {
+      Butterfly(_mm_load_ps(&x_re[p]), _mm_load_ps(&x_im[p]),
+                _mm_load_ps(&x_re[p + span]), _mm_load_ps(&x_im[p + span]),
+                _mm_loadu_ps(&w_re[p]), _mm_loadu_ps(&w_im[p]), &s_re, &s_im,
+                &t_re, &t_im);
+      _mm_store_ps(&y_re[2 * p], _mm_unpacklo_ps(s_re, t_re));
+      _mm_store_ps(&y_im[2 * p], _mm_unpacklo_ps(s_im, t_im));
+      _mm_store_ps(&y_re[2 * p + 4], _mm_unpackhi_ps(s_re, t_re));
+      _mm_store_ps(&y_im[2 * p + 4], _mm_unpackhi_ps(s_im, t_im));
+    }
+  } else if (stride == 2 && half >= 2) {
+    for (size_t p = 0; p < half; p += 2) {
+      // The twiddle factors of butterflies p and p + 1, twice each.
+      const __m128 wr = _mm_castpd_ps(
+          _mm_load_sd(reinterpret_cast<const double*>(&w_re[p])));
+      const __m128 wi = _mm_castpd_ps(
+          _mm_load_sd(reinterpret_cast<const double*>(&w_im[p])));
+      Butterfly(_mm_load_ps(&x_re[2 * p]), _mm_load_ps(&x_im[2 * p]),
+                _mm_load_ps(&x_re[2 * p + span]),
+                _mm_load_ps(&x_im[2 * p + span]), _mm_unpacklo_ps(wr, wr),
+                _mm_unpacklo_ps(wi, wi), &s_re, &s_im, &t_re, &t_im);
+      _mm_store_ps(&y_re[4 * p], _mm_movelh_ps(s_re, t_re));
+      _mm_store_ps(&y_im[4 * p], _mm_movelh_ps(s_im, t_im));
+      _mm_store_ps(&y_re[4 * p + 4], _mm_movehl_ps(t_re, s_re));
+      _mm_store_ps(&y_im[4 * p + 4], _mm_movehl_ps(t_im, s_im));
+    }
+  } else {
+    for (size_t p = 0; p < half; ++p) {
+      for (size_t q = 0; q < stride; ++q) {
+        const size_t in = stride * p + q;
+        const size_t out = 2 * stride * p + q;
+        const float d_re = x_re[in] - x_re[in + span];
+        const float d_im = x_im[in] - x_im[in + span];
+        y_re[out] = x_re[in] + x_re[in + span];
+        y_im[out] = x_im[in] + x_im[in + span];
+        y_re[out + stride] = d_re * w_re[p] - d_im * w_im[p];
+        y_im[out + stride] = d_re * w_im[p] + d_im * w_re[p];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+RealFourierSSE2::Twiddles::Twiddles(int order) {
+  const size_t length = FftLength(order);
+  for (size_t n = length / 2; n > 1; n /= 2) {
+    for (size_t p = 0; p < n / 2; ++p) {
+      const double angle = -2 * kPi * p / n;
+      pass_re.push_back(static_cast<float>(std::cos(angle)));
+      pass_im.push_back(static_cast<float>(std::sin(angle)));
+    }
+  }
+  for (size_t k = 0; k < length / 2; ++k) {
+    const double angle = -2 * kPi * k / length;
+    split_re.push_back(static_cast<float>(std::cos(angle)));
+    split_im.push_back(static_cast<float>(std::sin(angle)));
+  }
+}
+
+RealFourierSSE2::RealFourierSSE2(int fft_order)
+    : order_(fft_order),
+      half_length_(FftLength(fft_order) / 2),
+      twiddles_(GetTwiddles(fft_order)),
+      re_(AllocRealBuffer(static_cast<int>(half_length_))),
+      im_(AllocRealBuffer(static_cast<int>(half_length_))),
+      re_work_(AllocRealBuffer(static_cast<int>(half_length_))),
+      im_work_(AllocRealBuffer(static_cast<int>(half_length_))) {
+}
+
+void RealFourierSSE2::ComplexForward(float** re, float** im) const {
+  float* x_re = re_.get();
+  float* x_im = im_.get();
+  float* y_re = re_work_.get();
+  float* y_im = im_work_.get();
+  const float* w_re = twiddles_.pass_re.data();
+  const float* w_im = twiddles_.pass_im.data();
+  for (size_t half = half_length_ / 2, stride = 1; half > 0;
+       half /= 2, stride *= 2) {
+    Pass(x_re, x_im, y_re, y_im, half, stride, w_re, w_im);
+    w_re += half;
+    w_im += half;
+    std::swap(x_re, y_re);
+    std::swap(x_im, y_im);
+  }
+  *re = x_re;
+  *im = x_im;
+}
+
+void RealFourierSSE2::Forward(const float* src, complex<float>* dest) const {
+  const size_t n = half_length_;
+  float* z_re = re_.get();
+  float* z_im = im_.get();
+
+  // The even samples become the real parts and the odd ones the imaginary
+  // parts of the complex DFT input.
+  size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    const __m128 a = _mm_loadu_ps(&src[2 * k]);
+    const __m128 b = _mm_loadu_ps(&src[2 * k + 4]);
+    _mm_store_ps(&z_re[k], _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_store_ps(&z_im[k], _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  for (; k < n; ++k) {
+    z_re[k] = src[2 * k];
+    z_im[k] = src[2 * k + 1];
+  }
+
+  ComplexForward(&z_re, &z_im);
+
+  // With E and O the DFTs of the even and odd samples, Z = E + iO and
+  // X[k] = E[k] + exp(-2 pi i k / N) O[k], where
+  // E[k] = (Z[k] + conj(Z[n - k])) / 2 and O[k] = (Z[k] - conj(Z[n - k])) / 2i.
+  float* out = reinterpret_cast<float*>(dest);
+  out[0] = z_re[0] + z_im[0];
+  out[1] = 0.0f;
+  out[2 * n] = z_re[0] - z_im[0];
+  out[2 * n + 1] = 0.0f;
+  const float* w_re = twiddles_.split_re.data();
+  const float* w_im = twiddles_.split_im.data();
+  const __m128 half = _mm_set1_ps(0.5f);
+  k = 1;
+  for (; k + 4 <= n; k += 4) {
+    const __m128 a_re = _mm_loadu_ps(&z_re[k]);
+    const __m128 a_im = _mm_loadu_ps(&z_im[k]);
+    const __m128 b_re = Reverse(_mm_loadu_ps(&z_re[n - k - 3]));
+    const __m128 b_im = Reverse(_mm_loadu_ps(&z_im[n - k - 3]));
+    const __m128 wr = _mm_loadu_ps(&w_re[k]);
+    const __m128 wi = _mm_loadu_ps(&w_im[k]);
+    const __m128 e_re = _mm_mul_ps(_mm_add_ps(a_re, b_re), half);
+    const __m128 e_im = _mm_mul_ps(_mm_sub_ps(a_im, b_im), half);
+    const __m128 o_re = _mm_mul_ps(_mm_add_ps(a_im, b_im), half);
+    const __m128 o_im = _mm_mul_ps(_mm_sub_ps(b_re, a_re), half);
+    const __m128 x_re = _mm_add_ps(
+        e_re, _mm_sub_ps(_mm_mul_ps(wr, o_re), _mm_mul_ps(wi, o_im)));
+    const __m128 x_im = _mm_add_ps(
+        e_im, _mm_add_ps(_mm_mul_ps(wr, o_im), _mm_mul_ps(wi, o_re)));
+    _mm_storeu_ps(&out[2 * k], _mm_unpacklo_ps(x_re, x_im));
+    _mm_storeu_ps(&out[2 * k + 4], _mm_unpackhi_ps(x_re, x_im));
+  }
+  for (; k < n; ++k) {
+    const float e_re = 0.5f * (z_re[k] + z_re[n - k]);
+    const float e_im = 0.5f * (z_im[k] - z_im[n - k]);
+    const float o_re = 0.5f * (z_im[k] + z_im[n - k]);
+    const float o_im = 0.5f * (z_re[n - k] - z_re[k]);
+    out[2 * k] = e_re + w_re[k] * o_re - w_im[k] * o_im;
+    out[2 * k + 1] = e_im + w_re[k] * o_im + w_im[k] * o_re;
+  }
+}
+
+void RealFourierSSE2::Inverse(const complex<float>* src, float* dest) const {
+  const size_t n = half_length_;
+  const float* in = reinterpret_cast<const float*>(src);
+  float* z_re = re_.get();
+  float* z_im = im_.get();
+
+  // Undoes the split in Forward(), up to a factor of 2: 2Z[k] = E'[k] + iO'[k]
+  // with E'[k] = X[k] + conj(X[n - k]) and
+  // O'[k] = exp(2 pi i k / N) (X[k] - conj(X[n - k])). Z is conjugated, to get
+  // the inverse DFT from the forward one.
+  z_re[0] = in[0] + in[2 * n];
+  z_im[0] = in[2 * n] - in[0];
+  const float* w_re = twiddles_.split_re.data();
+  const float* w_im = twiddles_.split_im.data();
+  size_t k = 1;
+  for (; k + 4 <= n; k += 4) {
+    const __m128 a0 = _mm_loadu_ps(&in[2 * k]);
+    const __m128 a1 = _mm_loadu_ps(&in[2 * k + 4]);
+    const __m128 b0 = _mm_loadu_ps(&in[2 * (n - k - 3)]);
+    const __m128 b1 = _mm_loadu_ps(&in[2 * (n - k - 3) + 4]);
+    const __m128 a_re = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 a_im = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1));
+    const __m128 b_re =
+        Reverse(_mm_shuffle_ps(b0, b1, _MM_SHUFFLE(2, 0, 2, 0)));
+    const __m128 b_im =
+        Reverse(_mm_shuffle_ps(b0, b1, _MM_SHUFFLE(3, 1, 3, 1)));
+    const __m128 wr = _mm_loadu_ps(&w_re[k]);
+    const __m128 wi = _mm_loadu_ps(&w_im[k]);
+    const __m128 d_re = _mm_sub_ps(a_re, b_re);
+    const __m128 d_im = _mm_add_ps(a_im, b_im);
+    const __m128 o_re = _mm_add_ps(_mm_mul_ps(d_re, wr), _mm_mul_ps(d_im, wi));
+    const __m128 o_im = _mm_sub_ps(_mm_mul_ps(d_im, wr), _mm_mul_ps(d_re, wi));
+    _mm_storeu_ps(&z_re[k], _mm_sub_ps(_mm_add_ps(a_re, b_re), o_im));
+    _mm_storeu_ps(&z_im[k], _mm_sub_ps(_mm_sub_ps(b_im, a_im), o_re));
+  }
+  for (; k < n; ++k) {
+    const float d_re = in[2 * k] - in[2 * (n - k)];
+    const float d_im = in[2 * k + 1] + in[2 * (n - k) + 1];
+    const float o_re = d_re * w_re[k] + d_im * w_im[k];
+    const float o_im = d_im * w_re[k] - d_re * w_im[k];
+    z_re[k] = in[2 * k] + in[2 * (n - k)] - o_im;
+    z_im[k] = in[2 * (n - k) + 1] - in[2 * k + 1] - o_re;
+  }
+
+  ComplexForward(&z_re, &z_im);
+
+  // Conjugates and scales the result, and interleaves it into the even and
+  // odd samples.
+  const float scale = 1.0f / (2 * n);
+  const __m128 re_scale = _mm_set1_ps(scale);
+  const __m128 im_scale = _mm_set1_ps(-scale);
+  k = 0;
+  for (; k + 4 <= n; k += 4) {
+    const __m128 x_re = _mm_mul_ps(_mm_load_ps(&z_re[k]), re_scale);
+    const __m128 x_im = _mm_mul_ps(_mm_load_ps(&z_im[k]), im_scale);
+    _mm_storeu_ps(&dest[2 * k], _mm_unpacklo_ps(x_re, x_im));
+    _mm_storeu_ps(&dest[2 * k + 4], _mm_unpackhi_ps(x_re, x_im));
+  }
+  for (; k < n; ++k) {
+    dest[2 * k] = z_re[k] * scale;
+    dest[2 * k + 1] = -z_im[k] * scale;
+  }
+}
+
+}  // namespace webrtc
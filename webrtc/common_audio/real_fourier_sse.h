@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_REAL_FOURIER_SSE_H_
+#define WEBRTC_COMMON_AUDIO_REAL_FOURIER_SSE_H_
+
+#include <complex>
+
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_audio/real_fourier.h"
+#include "webrtc/system_wrappers/interface/aligned_malloc.h"
+
+namespace webrtc {
+
+// Real DFT through a complex DFT of half the length, computed with radix-2
+// Stockham passes on separate real and imaginary arrays, four butterflies at
+// a time.
+class RealFourierSSE2 : public RealFourier {
+ public:
+  explicit RealFourierSSE2(int fft_order);
+
+  void Forward(const float* src, std::complex<float>* dest) const override;
+  void Inverse(const std::complex<float>* src, float* dest) const override;
+
+  int order() const override {
+    return order_;
+  }
+
+  // Twiddle factors for one order, shared by all the instances of that order.
+  struct Twiddles;
+
+ private:
+  // Transforms the complex points in |re_| and |im_|, and returns the arrays
+  // holding the result through |re| and |im|.
+  void ComplexForward(float** re, float** im) const;
+
+  const int order_;
+  // The length of the complex DFT.
+  const size_t half_length_;
+  const Twiddles& twiddles_;
+  // Work arrays; the Stockham passes alternate between the two pairs.
+  const rtc::scoped_ptr<float[], AlignedFreeDeleter> re_;
+  const rtc::scoped_ptr<float[], AlignedFreeDeleter> im_;
+  const rtc::scoped_ptr<float[], AlignedFreeDeleter> re_work_;
+  const rtc::scoped_ptr<float[], AlignedFreeDeleter> im_work_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_REAL_FOURIER_SSE_H_
@@ -10,12 +10,16 @@
 
 #include "webrtc/common_audio/real_fourier.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_audio/real_fourier_openmax.h"
 #include "webrtc/common_audio/real_fourier_ooura.h"
+#include "webrtc/common_audio/real_fourier_sse.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 
 namespace webrtc {
 
@@ -73,6 +77,9 @@ class RealFourierTest : public ::testing::Test {
 using FftTypes = ::testing::Types<
 #if defined(RTC_USE_OPENMAX_DL)
     RealFourierOpenmax,
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    RealFourierSSE2,
 #endif
     RealFourierOoura>;
 TYPED_TEST_CASE(RealFourierTest, FftTypes);
@@ -106,5 +113,87 @@ TYPED_TEST(RealFourierTest, SimpleBackwardTransform) {
   EXPECT_NEAR(this->real_buffer_[3], 4.0f, 1e-8f);
 }
 
-}  // namespace webrtc
+namespace {
 
+void FillRandom(float* buffer, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    buffer[i] = static_cast<float>(rand()) / RAND_MAX * 2.0f - 1.0f;
+  }
+}
+
+}  // namespace
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(RealFourierSSE2Test, MatchesOoura) {
+  if (WebRtc_GetCPUInfo(kSSE2) == 0)
+    return;
+  srand(42);
+  for (int order = 1; order <= 10; ++order) {
+    const size_t length = RealFourier::FftLength(order);
+    const size_t complex_length = RealFourier::ComplexLength(order);
+    RealFourierOoura ooura(order);
+    RealFourierSSE2 sse2(order);
+    RealFourier::fft_real_scoper real(RealFourier::AllocRealBuffer(length));
+    RealFourier::fft_real_scoper real_out(
+        RealFourier::AllocRealBuffer(length));
+    RealFourier::fft_cplx_scoper expected(
+        RealFourier::AllocCplxBuffer(complex_length));
+    RealFourier::fft_cplx_scoper actual(
+        RealFourier::AllocCplxBuffer(complex_length));
+    FillRandom(real.get(), length);
+
+    ooura.Forward(real.get(), expected.get());
+    sse2.Forward(real.get(), actual.get());
+    const float tolerance = 1e-5f * length;
+    for (size_t i = 0; i < complex_length; ++i) {
+      EXPECT_NEAR(expected[i].real(), actual[i].real(), tolerance)
+          << "order " << order << ", bin " << i;
+      EXPECT_NEAR(expected[i].imag(), actual[i].imag(), tolerance)
+          << "order " << order << ", bin " << i;
+    }
+
+    // Both ignore the imaginary parts of the DC and Nyquist bins.
+    actual[0] = complex<float>(actual[0].real(), 1.0f);
+    actual[complex_length - 1] =
+        complex<float>(actual[complex_length - 1].real(), -1.0f);
+    sse2.Inverse(actual.get(), real_out.get());
+    for (size_t i = 0; i < length; ++i) {
+      EXPECT_NEAR(real[i], real_out[i], 1e-5f)
+          << "order " << order << ", sample " << i;
+    }
+  }
+}
+
+// Prints the time per forward and inverse transform of each implementation.
+TEST(RealFourierSSE2Test, DISABLED_Benchmark) {
+  if (WebRtc_GetCPUInfo(kSSE2) == 0)
+    return;
+  const int kIterations = 100000;
+  for (int order = 7; order <= 10; ++order) {
+    const size_t length = RealFourier::FftLength(order);
+    const size_t complex_length = RealFourier::ComplexLength(order);
+    RealFourier::fft_real_scoper real(RealFourier::AllocRealBuffer(length));
+    RealFourier::fft_cplx_scoper cplx(
+        RealFourier::AllocCplxBuffer(complex_length));
+    srand(42);
+    FillRandom(real.get(), length);
+    RealFourierOoura ooura(order);
+    RealFourierSSE2 sse2(order);
+    const RealFourier* const ffts[] = {&ooura, &sse2};
+    const char* const names[] = {"Ooura", "SSE2"};
+    for (size_t i = 0; i < 2; ++i) {
+      TickTime start = TickTime::Now();
+      for (int j = 0; j < kIterations; ++j) {
+        ffts[i]->Forward(real.get(), cplx.get());
+        ffts[i]->Inverse(cplx.get(), real.get());
+      }
+      printf("Order %d, %-5s: %.3f us per forward and inverse transform\n",
+             order, names[i],
+             (TickTime::Now() - start).Microseconds() /
+                 static_cast<double>(kIterations));
+    }
+  }
+}
+#endif
+
+}  // namespace webrtc
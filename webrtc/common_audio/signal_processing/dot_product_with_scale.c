@@ -17,6 +17,14 @@ int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
   int32_t sum = 0;
   size_t i = 0;
 
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+  /* Not a function pointer, since many callers never run WebRtcSpl_Init(). */
+  if (length >= 8) {
+    return WebRtcSpl_DotProductWithScaleSSE2(vector1, vector2, length,
+                                             scaling);
+  }
+#endif
+
   /* Unroll the loop to improve performance. */
   for (i = 0; i + 3 < length; i += 4) {
     sum += (vector1[i + 0] * vector2[i + 0]) >> scaling;
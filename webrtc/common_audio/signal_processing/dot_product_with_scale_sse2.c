@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// SSE2 version of WebRtcSpl_DotProductWithScale(), bit-exact with the C
+// version: the products are shifted one by one before they are added.
+int32_t WebRtcSpl_DotProductWithScaleSSE2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          size_t length,
+                                          int scaling) {
+  __m128i sum = _mm_setzero_si128();
+  size_t i = 0;
+  int32_t result = 0;
+
+  if (scaling == 0) {
+    // Without shifts, adding pairs of products first makes no difference,
+    // as all the additions wrap around the same way.
+    __m128i sum2 = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(
+          _mm_loadu_si128((const __m128i*)&vector1[i]),
+          _mm_loadu_si128((const __m128i*)&vector2[i])));
+      sum2 = _mm_add_epi32(sum2, _mm_madd_epi16(
+          _mm_loadu_si128((const __m128i*)&vector1[i + 8]),
+          _mm_loadu_si128((const __m128i*)&vector2[i + 8])));
+    }
+    sum = _mm_add_epi32(sum, sum2);
+    for (; i + 8 <= length; i += 8) {
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(
+          _mm_loadu_si128((const __m128i*)&vector1[i]),
+          _mm_loadu_si128((const __m128i*)&vector2[i])));
+    }
+  } else {
+    const __m128i shift = _mm_cvtsi32_si128(scaling);
+    for (; i + 8 <= length; i += 8) {
+      const __m128i a = _mm_loadu_si128((const __m128i*)&vector1[i]);
+      const __m128i b = _mm_loadu_si128((const __m128i*)&vector2[i]);
+      const __m128i low = _mm_mullo_epi16(a, b);
+      const __m128i high = _mm_mulhi_epi16(a, b);
+      sum = _mm_add_epi32(
+          sum, _mm_sra_epi32(_mm_unpacklo_epi16(low, high), shift));
+      sum = _mm_add_epi32(
+          sum, _mm_sra_epi32(_mm_unpackhi_epi16(low, high), shift));
+    }
+  }
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  result = _mm_cvtsi128_si32(sum);
+
+  for (; i < length; i++) {
+    result += (vector1[i] * vector2[i]) >> scaling;
+  }
+  return result;
+}
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// Filters longer than this many blocks of 8 coefficients use the C loop.
+enum { kMaxCoefficientBlocks = 8 };
+
+// Filters the output sample at input position |i|.
+static __inline int16_t DownsampleOne(const int16_t* data_in,
+                                      size_t i,
+                                      const int16_t* coefficients,
+                                      size_t coefficients_length) {
+  int32_t out_s32 = 2048;  // Round value, 0.5 in Q12.
+  size_t j = 0;
+
+  for (j = 0; j < coefficients_length; j++) {
+    out_s32 += coefficients[j] * data_in[i - j];  // Q12.
+  }
+  return WebRtcSpl_SatW32ToW16(out_s32 >> 12);
+}
+
+// Sum of the products of 8 * |num_blocks| samples, starting at |data_in|,
+// and the coefficient blocks.
+static __inline __m128i MultiplyBlocks(const int16_t* data_in,
+                                       const __m128i* blocks,
+                                       size_t num_blocks) {
+  __m128i sum = _mm_madd_epi16(_mm_loadu_si128((const __m128i*)data_in),
+                               blocks[0]);
+  size_t b = 0;
+
+  for (b = 1; b < num_blocks; b++) {
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(
+        _mm_loadu_si128((const __m128i*)&data_in[8 * b]), blocks[b]));
+  }
+  return sum;
+}
+
+// SSE2 version of WebRtcSpl_DownsampleFast(), bit-exact with the C version.
+// Filters four output samples at a time.
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  size_t i = 0;
+  size_t k = 0;
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+
+  if (coefficients_length <= 8 * kMaxCoefficientBlocks) {
+    const size_t num_blocks = (coefficients_length + 7) / 8;
+    const size_t padded_length = 8 * num_blocks;
+    int16_t reversed[8 * kMaxCoefficientBlocks];
+    __m128i blocks[kMaxCoefficientBlocks];
+
+    // Reverse the coefficients, to multiply samples in increasing order, and
+    // pad them with zeros in front.
+    for (i = 0; i < padded_length; i++) {
+      const size_t j = padded_length - 1 - i;
+      reversed[i] = j < coefficients_length ? coefficients[j] : 0;
+    }
+    for (i = 0; i < num_blocks; i++) {
+      blocks[i] = _mm_loadu_si128((const __m128i*)&reversed[8 * i]);
+    }
+
+    // The padding reads samples before the filter state for the first output
+    // samples, which are filtered one by one.
+    for (; k < data_out_length &&
+         delay + k * factor + coefficients_length < padded_length; k++) {
+      data_out[k] = DownsampleOne(data_in, delay + k * factor, coefficients,
+                                  coefficients_length);
+    }
+
+    for (; k + 4 <= data_out_length; k += 4) {
+      const int16_t* in = &data_in[delay + k * factor + 1 - padded_length];
+      const __m128i sum0 = MultiplyBlocks(in, blocks, num_blocks);
+      const __m128i sum1 = MultiplyBlocks(in + factor, blocks, num_blocks);
+      const __m128i sum2 = MultiplyBlocks(in + 2 * factor, blocks, num_blocks);
+      const __m128i sum3 = MultiplyBlocks(in + 3 * factor, blocks, num_blocks);
+      // Add up the lanes of each sum, into one lane per output sample.
+      const __m128i sum01 = _mm_add_epi32(_mm_unpacklo_epi32(sum0, sum1),
+                                          _mm_unpackhi_epi32(sum0, sum1));
+      const __m128i sum23 = _mm_add_epi32(_mm_unpacklo_epi32(sum2, sum3),
+                                          _mm_unpackhi_epi32(sum2, sum3));
+      __m128i out = _mm_add_epi32(_mm_unpacklo_epi64(sum01, sum23),
+                                  _mm_unpackhi_epi64(sum01, sum23));
+      out = _mm_srai_epi32(_mm_add_epi32(out, _mm_set1_epi32(2048)), 12);
+      // Saturate and store the output.
+      _mm_storel_epi64((__m128i*)&data_out[k], _mm_packs_epi32(out, out));
+    }
+  }
+
+  for (; k < data_out_length; k++) {
+    data_out[k] = DownsampleOne(data_in, delay + k * factor, coefficients,
+                                coefficients_length);
+  }
+
+  return 0;
+}
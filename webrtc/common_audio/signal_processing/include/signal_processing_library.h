@@ -108,7 +108,8 @@ extern "C" {
 // If the underlying platform is known to be ARM-Neon (WEBRTC_HAS_NEON defined),
 // the pointers will be assigned to code optimized for Neon; otherwise
 // if run-time Neon detection (WEBRTC_DETECT_NEON) is enabled, the pointers
-// will be assigned to either Neon code or generic C code; otherwise, generic C
+// will be assigned to either Neon code or generic C code; on x86, the pointers
+// will be assigned to SSE2 code if the CPU supports it; otherwise, generic C
 // code will be assigned.
 // Note that this function MUST be called in any application that uses SPL
 // functions.
@@ -159,6 +160,9 @@ int16_t WebRtcSpl_MaxAbsValueW16Neon(const int16_t* vector, size_t length);
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MaxAbsValueW16_mips(const int16_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, size_t length);
+#endif
 
 // Returns the largest absolute value in a signed 32-bit vector.
 //
@@ -176,6 +180,9 @@ int32_t WebRtcSpl_MaxAbsValueW32Neon(const int32_t* vector, size_t length);
 #if defined(MIPS_DSP_R1_LE)
 int32_t WebRtcSpl_MaxAbsValueW32_mips(const int32_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MaxAbsValueW32SSE2(const int32_t* vector, size_t length);
+#endif
 
 // Returns the maximum value of a 16-bit vector.
 //
@@ -193,6 +200,9 @@ int16_t WebRtcSpl_MaxValueW16Neon(const int16_t* vector, size_t length);
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MaxValueW16_mips(const int16_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MaxValueW16SSE2(const int16_t* vector, size_t length);
+#endif
 
 // Returns the maximum value of a 32-bit vector.
 //
@@ -210,6 +220,9 @@ int32_t WebRtcSpl_MaxValueW32Neon(const int32_t* vector, size_t length);
 #if defined(MIPS32_LE)
 int32_t WebRtcSpl_MaxValueW32_mips(const int32_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MaxValueW32SSE2(const int32_t* vector, size_t length);
+#endif
 
 // Returns the minimum value of a 16-bit vector.
 //
@@ -227,6 +240,9 @@ int16_t WebRtcSpl_MinValueW16Neon(const int16_t* vector, size_t length);
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MinValueW16_mips(const int16_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MinValueW16SSE2(const int16_t* vector, size_t length);
+#endif
 
 // Returns the minimum value of a 32-bit vector.
 //
@@ -244,6 +260,9 @@ int32_t WebRtcSpl_MinValueW32Neon(const int32_t* vector, size_t length);
 #if defined(MIPS32_LE)
 int32_t WebRtcSpl_MinValueW32_mips(const int32_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MinValueW32SSE2(const int32_t* vector, size_t length);
+#endif
 
 // Returns the vector index to the largest absolute value of a 16-bit vector.
 //
@@ -373,6 +392,15 @@ int WebRtcSpl_ScaleAndAddVectorsWithRound_mips(const int16_t* in_vector1,
                                                int16_t* out_vector,
                                                size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(const int16_t* in_vector1,
+                                              int16_t in_vector1_scale,
+                                              const int16_t* in_vector2,
+                                              int16_t in_vector2_scale,
+                                              int right_shifts,
+                                              int16_t* out_vector,
+                                              size_t length);
+#endif
 // End: Vector scaling operations.
 
 // iLBC specific functions. Implementations in ilbc_specific_functions.c.
@@ -549,6 +577,15 @@ void WebRtcSpl_CrossCorrelation_mips(int32_t* cross_correlation,
                                      int right_shifts,
                                      int step_seq2);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2);
+#endif
 
 // Creates (the first half of) a Hanning window. Size must be at least 1 and
 // at most 512.
@@ -615,6 +652,12 @@ int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
                                       const int16_t* vector2,
                                       size_t length,
                                       int scaling);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_DotProductWithScaleSSE2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          size_t length,
+                                          int scaling);
+#endif
 
 // Filter operations.
 size_t WebRtcSpl_FilterAR(const int16_t* ar_coef,
@@ -718,6 +761,16 @@ int WebRtcSpl_DownsampleFast_mips(const int16_t* data_in,
                                   int factor,
                                   size_t delay);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay);
+#endif
 
 // End: Filter operations.
 
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// SSE2 has no 32-bit minimum and maximum, these select with a comparison.
+static __inline __m128i MaxW32(__m128i a, __m128i b) {
+  const __m128i greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(greater, a),
+                      _mm_andnot_si128(greater, b));
+}
+
+static __inline __m128i MinW32(__m128i a, __m128i b) {
+  const __m128i greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(greater, b),
+                      _mm_andnot_si128(greater, a));
+}
+
+// The maximum and minimum of the lanes, in all the lanes.
+static __inline __m128i HorizontalMaxW16(__m128i v) {
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_max_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+static __inline __m128i HorizontalMinW16(__m128i v) {
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_min_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+static __inline __m128i HorizontalMaxW32(__m128i v) {
+  v = MaxW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  return MaxW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+static __inline __m128i HorizontalMinW32(__m128i v) {
+  v = MinW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  return MinW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+// Maximum absolute value of word16 vector. SSE2 version for x86.
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, size_t length) {
+  // SSE2 has no 16-bit absolute value, and it couldn't hold abs(-32768)
+  // anyway, so look for both the maximum and the minimum.
+  __m128i max_v = _mm_setzero_si128();
+  __m128i min_v = _mm_setzero_si128();
+  size_t i = 0;
+  int maximum = 0;
+  int minimum = 0;
+
+  assert(length > 0);
+
+  for (; i + 8 <= length; i += 8) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)&vector[i]);
+    max_v = _mm_max_epi16(max_v, v);
+    min_v = _mm_min_epi16(min_v, v);
+  }
+  maximum = (int16_t)_mm_extract_epi16(HorizontalMaxW16(max_v), 0);
+  minimum = (int16_t)_mm_extract_epi16(HorizontalMinW16(min_v), 0);
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+
+  maximum = WEBRTC_SPL_MAX(maximum, -minimum);
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
+
+// Maximum absolute value of word32 vector. SSE2 version for x86.
+int32_t WebRtcSpl_MaxAbsValueW32SSE2(const int32_t* vector, size_t length) {
+  __m128i max_v = _mm_setzero_si128();
+  __m128i min_v = _mm_setzero_si128();
+  size_t i = 0;
+  int64_t maximum = 0;
+  int64_t minimum = 0;
+
+  assert(length > 0);
+
+  for (; i + 4 <= length; i += 4) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)&vector[i]);
+    max_v = MaxW32(max_v, v);
+    min_v = MinW32(min_v, v);
+  }
+  maximum = _mm_cvtsi128_si32(HorizontalMaxW32(max_v));
+  minimum = _mm_cvtsi128_si32(HorizontalMinW32(min_v));
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+
+  maximum = WEBRTC_SPL_MAX(maximum, -minimum);
+  maximum = WEBRTC_SPL_MIN(maximum, WEBRTC_SPL_WORD32_MAX);
+
+  return (int32_t)maximum;
+}
+
+// Maximum value of word16 vector. SSE2 version for x86.
+int16_t WebRtcSpl_MaxValueW16SSE2(const int16_t* vector, size_t length) {
+  __m128i max_v = _mm_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+  int16_t maximum = WEBRTC_SPL_WORD16_MIN;
+  size_t i = 0;
+
+  assert(length > 0);
+
+  for (; i + 8 <= length; i += 8) {
+    max_v = _mm_max_epi16(max_v,
+                          _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  maximum = (int16_t)_mm_extract_epi16(HorizontalMaxW16(max_v), 0);
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Maximum value of word32 vector. SSE2 version for x86.
+int32_t WebRtcSpl_MaxValueW32SSE2(const int32_t* vector, size_t length) {
+  __m128i max_v = _mm_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  int32_t maximum = WEBRTC_SPL_WORD32_MIN;
+  size_t i = 0;
+
+  assert(length > 0);
+
+  for (; i + 4 <= length; i += 4) {
+    max_v = MaxW32(max_v, _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  maximum = _mm_cvtsi128_si32(HorizontalMaxW32(max_v));
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Minimum value of word16 vector. SSE2 version for x86.
+int16_t WebRtcSpl_MinValueW16SSE2(const int16_t* vector, size_t length) {
+  __m128i min_v = _mm_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+  int16_t minimum = WEBRTC_SPL_WORD16_MAX;
+  size_t i = 0;
+
+  assert(length > 0);
+
+  for (; i + 8 <= length; i += 8) {
+    min_v = _mm_min_epi16(min_v,
+                          _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  minimum = (int16_t)_mm_extract_epi16(HorizontalMinW16(min_v), 0);
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+// Minimum value of word32 vector. SSE2 version for x86.
+int32_t WebRtcSpl_MinValueW32SSE2(const int32_t* vector, size_t length) {
+  __m128i min_v = _mm_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+  int32_t minimum = WEBRTC_SPL_WORD32_MAX;
+  size_t i = 0;
+
+  assert(length > 0);
+
+  for (; i + 4 <= length; i += 4) {
+    min_v = MinW32(min_v, _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  minimum = _mm_cvtsi128_si32(HorizontalMinW32(min_v));
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
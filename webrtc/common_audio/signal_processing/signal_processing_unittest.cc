@@ -8,8 +8,16 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 
 static const size_t kVector16Size = 9;
 static const int16_t vector16[kVector16Size] = {1, -15511, 4323, 1963,
@@ -447,7 +455,7 @@ TEST_F(SplTest, CrossCorrelationTest) {
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if defined(WEBRTC_DETECT_NEON) || defined(WEBRTC_HAS_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
   if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
@@ -577,3 +585,297 @@ TEST_F(SplTest, Resample48WithSaturationTest) {
     EXPECT_EQ(kRefValue16kHz2, out_vector_w16[i]);
   }
 }
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// The SSE2 versions must be bit-exact with the C versions.
+namespace {
+
+const size_t kSSE2TestLengths[] = {1, 7, 8, 9, 15, 16, 17, 31, 64, 160, 481};
+
+void FillRandom(int16_t* vector, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    vector[i] = static_cast<int16_t>(rand());
+  }
+}
+
+void FillRandom(int32_t* vector, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    vector[i] = static_cast<int32_t>((static_cast<uint32_t>(rand()) << 16) ^
+                                     static_cast<uint32_t>(rand()));
+  }
+}
+
+}  // namespace
+
+TEST_F(SplTest, MinMaxOperationsSSE2Test) {
+  if (WebRtc_GetCPUInfo(kSSE2) == 0)
+    return;
+  srand(42);
+  for (size_t length : kSSE2TestLengths) {
+    std::vector<int16_t> vector16(length);
+    std::vector<int32_t> vector32(length);
+    for (int trial = 0; trial < 4; ++trial) {
+      FillRandom(&vector16[0], length);
+      FillRandom(&vector32[0], length);
+      if (trial == 1) {
+        // The extreme values at the last position, which may be in the tail.
+        vector16[length - 1] = WEBRTC_SPL_WORD16_MIN;
+        vector32[length - 1] = WEBRTC_SPL_WORD32_MIN;
+      } else if (trial == 2) {
+        vector16[length / 2] = WEBRTC_SPL_WORD16_MAX;
+        vector32[length / 2] = WEBRTC_SPL_WORD32_MAX;
+      } else if (trial == 3) {
+        std::fill(vector16.begin(), vector16.end(), WEBRTC_SPL_WORD16_MIN);
+        std::fill(vector32.begin(), vector32.end(), WEBRTC_SPL_WORD32_MIN);
+      }
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(&vector16[0], length),
+                WebRtcSpl_MaxAbsValueW16SSE2(&vector16[0], length));
+      if (trial == 1 || trial == 3) {
+        // The C version takes abs(WEBRTC_SPL_WORD32_MIN), which is undefined.
+        EXPECT_EQ(WEBRTC_SPL_WORD32_MAX,
+                  WebRtcSpl_MaxAbsValueW32SSE2(&vector32[0], length));
+      } else {
+        EXPECT_EQ(WebRtcSpl_MaxAbsValueW32C(&vector32[0], length),
+                  WebRtcSpl_MaxAbsValueW32SSE2(&vector32[0], length));
+      }
+      EXPECT_EQ(WebRtcSpl_MaxValueW16C(&vector16[0], length),
+                WebRtcSpl_MaxValueW16SSE2(&vector16[0], length));
+      EXPECT_EQ(WebRtcSpl_MaxValueW32C(&vector32[0], length),
+                WebRtcSpl_MaxValueW32SSE2(&vector32[0], length));
+      EXPECT_EQ(WebRtcSpl_MinValueW16C(&vector16[0], length),
+                WebRtcSpl_MinValueW16SSE2(&vector16[0], length));
+      EXPECT_EQ(WebRtcSpl_MinValueW32C(&vector32[0], length),
+                WebRtcSpl_MinValueW32SSE2(&vector32[0], length));
+    }
+  }
+}
+
+TEST_F(SplTest, DotProductWithScaleSSE2Test) {
+  if (WebRtc_GetCPUInfo(kSSE2) == 0)
+    return;
+  const int kScalings[] = {0, 1, 2, 6, 15, 31};
+  srand(42);
+  for (size_t length : kSSE2TestLengths) {
+    std::vector<int16_t> vector1(length);
+    std::vector<int16_t> vector2(length);
+    for (int scaling : kScalings) {
+      FillRandom(&vector1[0], length);
+      FillRandom(&vector2[0], length);
+      if (scaling == 1) {
+        std::fill(vector1.begin(), vector1.end(), WEBRTC_SPL_WORD16_MIN);
+        std::fill(vector2.begin(), vector2.end(), WEBRTC_SPL_WORD16_MIN);
+      }
+      int32_t expected = 0;
+      WebRtcSpl_CrossCorrelationC(&expected, &vector1[0], &vector2[0], length,
+                                  1, scaling, 1);
+      EXPECT_EQ(expected, WebRtcSpl_DotProductWithScaleSSE2(
+          &vector1[0], &vector2[0], length, scaling));
+      EXPECT_EQ(expected, WebRtcSpl_DotProductWithScale(
+          &vector1[0], &vector2[0], length, scaling));
+    }
+
+    // WebRtcSpl_Energy() is the dot product of the vector with itself.
+    int scale_factor = 0;
+    const int32_t energy =
+        WebRtcSpl_Energy(&vector1[0], length, &scale_factor);
+    int32_t expected = 0;
+    WebRtcSpl_CrossCorrelationC(&expected, &vector1[0], &vector1[0], length,
+                                1, scale_factor, 1);
+    EXPECT_EQ(expected, energy);
+  }
+}
+
+TEST_F(SplTest, CrossCorrelationSSE2Test) {
+  if (WebRtc_GetCPUInfo(kSSE2) == 0)
+    return;
+  const size_t kDimCrossCorrelation = 5;
+  const int kSteps[] = {-1, 1, 2};
+  srand(42);
+  for (size_t length : kSSE2TestLengths) {
+    for (int step : kSteps) {
+      const size_t span = (kDimCrossCorrelation - 1) * abs(step);
+      std::vector<int16_t> seq1(length);
+      std::vector<int16_t> seq2(length + span);
+      FillRandom(&seq1[0], length);
+      FillRandom(&seq2[0], length + span);
+      const int16_t* start = step < 0 ? &seq2[span] : &seq2[0];
+      int32_t expected[kDimCrossCorrelation];
+      int32_t actual[kDimCrossCorrelation];
+      WebRtcSpl_CrossCorrelationC(expected, &seq1[0], start, length,
+                                  kDimCrossCorrelation, 3, step);
+      WebRtcSpl_CrossCorrelationSSE2(actual, &seq1[0], start, length,
+                                     kDimCrossCorrelation, 3, step);
+      for (size_t i = 0; i < kDimCrossCorrelation; ++i) {
+        EXPECT_EQ(expected[i], actual[i]);
+      }
+    }
+  }
+}
+
+TEST_F(SplTest, DownsampleFastSSE2Test) {
+  if (WebRtc_GetCPUInfo(kSSE2) == 0)
+    return;
+  // The longest filter is beyond the length the SSE2 version filters itself.
+  const size_t kCoefficientsLengths[] = {1, 5, 8, 9, 12, 32, 64, 65};
+  const int kFactors[] = {1, 2, 3, 6};
+  srand(42);
+  for (size_t coefficients_length : kCoefficientsLengths) {
+    for (int factor : kFactors) {
+      for (size_t out_length : kSSE2TestLengths) {
+        // Includes the filter state before the input.
+        const size_t order = coefficients_length - 1;
+        const size_t delay = out_length % coefficients_length;
+        const size_t in_length = delay + factor * (out_length - 1) + 1;
+        std::vector<int16_t> coefficients(coefficients_length);
+        std::vector<int16_t> in(order + in_length);
+        std::vector<int16_t> expected(out_length);
+        std::vector<int16_t> actual(out_length);
+        FillRandom(&coefficients[0], coefficients_length);
+        FillRandom(&in[0], order + in_length);
+        EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(
+            &in[order], in_length, &expected[0], out_length,
+            &coefficients[0], coefficients_length, factor, delay));
+        EXPECT_EQ(0, WebRtcSpl_DownsampleFastSSE2(
+            &in[order], in_length, &actual[0], out_length,
+            &coefficients[0], coefficients_length, factor, delay));
+        EXPECT_EQ(expected, actual);
+      }
+    }
+  }
+
+  // Input too short.
+  int16_t in[8] = {0};
+  int16_t out[4];
+  const int16_t coefficients[2] = {4096, 4096};
+  EXPECT_EQ(-1, WebRtcSpl_DownsampleFastSSE2(in, 6, out, 4, coefficients, 2,
+                                             2, 0));
+}
+
+TEST_F(SplTest, ScaleAndAddVectorsWithRoundSSE2Test) {
+  if (WebRtc_GetCPUInfo(kSSE2) == 0)
+    return;
+  const int kRightShifts[] = {0, 1, 7, 14, 15};
+  srand(42);
+  for (size_t length : kSSE2TestLengths) {
+    std::vector<int16_t> vector1(length);
+    std::vector<int16_t> vector2(length);
+    std::vector<int16_t> expected(length);
+    std::vector<int16_t> actual(length);
+    for (int right_shifts : kRightShifts) {
+      FillRandom(&vector1[0], length);
+      FillRandom(&vector2[0], length);
+      int16_t scales[2];
+      FillRandom(scales, 2);
+      if (right_shifts == 15) {
+        std::fill(vector1.begin(), vector1.end(), WEBRTC_SPL_WORD16_MIN);
+        std::fill(vector2.begin(), vector2.end(), WEBRTC_SPL_WORD16_MIN);
+        scales[0] = scales[1] = WEBRTC_SPL_WORD16_MIN;
+      }
+      EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundC(
+          &vector1[0], scales[0], &vector2[0], scales[1], right_shifts,
+          &expected[0], length));
+      EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(
+          &vector1[0], scales[0], &vector2[0], scales[1], right_shifts,
+          &actual[0], length));
+      EXPECT_EQ(expected, actual);
+    }
+  }
+}
+
+// Prints the time per call of the C and SSE2 versions.
+TEST_F(SplTest, DISABLED_SSE2Benchmark) {
+  if (WebRtc_GetCPUInfo(kSSE2) == 0)
+    return;
+  const int kIterations = 100000;
+  // 10 ms at 48 kHz.
+  const size_t kLength = 480;
+  const size_t kCoefficientsLength = 32;
+  const size_t kDimCrossCorrelation = 16;
+  std::vector<int16_t> vector1(kLength + kDimCrossCorrelation);
+  std::vector<int16_t> vector2(kLength + kDimCrossCorrelation);
+  std::vector<int32_t> vector32(kLength);
+  std::vector<int16_t> out(kLength);
+  std::vector<int32_t> cross_correlation(kDimCrossCorrelation);
+  std::vector<int16_t> coefficients(kCoefficientsLength);
+  srand(42);
+  FillRandom(&vector1[0], vector1.size());
+  FillRandom(&vector2[0], vector2.size());
+  FillRandom(&vector32[0], vector32.size());
+  FillRandom(&coefficients[0], kCoefficientsLength);
+  // Keep the results, so the calls aren't optimized away.
+  volatile int32_t sink = 0;
+
+#define BENCHMARK(name, call)                                          \
+  do {                                                                 \
+    webrtc::TickTime start = webrtc::TickTime::Now();                  \
+    for (int i = 0; i < kIterations; ++i) {                            \
+      sink = sink + (call);                                            \
+    }                                                                  \
+    printf("%-40s %8.3f us\n", name,                                   \
+           (webrtc::TickTime::Now() - start).Microseconds() /          \
+               static_cast<double>(kIterations));                      \
+  } while (0)
+
+  BENCHMARK("MaxAbsValueW16C",
+            WebRtcSpl_MaxAbsValueW16C(&vector1[0], kLength));
+  BENCHMARK("MaxAbsValueW16SSE2",
+            WebRtcSpl_MaxAbsValueW16SSE2(&vector1[0], kLength));
+  BENCHMARK("MaxAbsValueW32C",
+            WebRtcSpl_MaxAbsValueW32C(&vector32[0], kLength));
+  BENCHMARK("MaxAbsValueW32SSE2",
+            WebRtcSpl_MaxAbsValueW32SSE2(&vector32[0], kLength));
+  BENCHMARK("MaxValueW16C", WebRtcSpl_MaxValueW16C(&vector1[0], kLength));
+  BENCHMARK("MaxValueW16SSE2",
+            WebRtcSpl_MaxValueW16SSE2(&vector1[0], kLength));
+  BENCHMARK("MinValueW32C", WebRtcSpl_MinValueW32C(&vector32[0], kLength));
+  BENCHMARK("MinValueW32SSE2",
+            WebRtcSpl_MinValueW32SSE2(&vector32[0], kLength));
+  for (int scaling = 0; scaling < 2; ++scaling) {
+    printf("scaling %d:\n", scaling);
+    BENCHMARK("CrossCorrelationC (dot product)",
+              (WebRtcSpl_CrossCorrelationC(&cross_correlation[0], &vector1[0],
+                                           &vector2[0], kLength, 1, scaling,
+                                           1),
+               cross_correlation[0]));
+    BENCHMARK("DotProductWithScaleSSE2",
+              WebRtcSpl_DotProductWithScaleSSE2(&vector1[0], &vector2[0],
+                                                kLength, scaling));
+  }
+  BENCHMARK("CrossCorrelationC",
+            (WebRtcSpl_CrossCorrelationC(&cross_correlation[0], &vector1[0],
+                                         &vector2[0], kLength,
+                                         kDimCrossCorrelation, 2, 1),
+             cross_correlation[0]));
+  BENCHMARK("CrossCorrelationSSE2",
+            (WebRtcSpl_CrossCorrelationSSE2(&cross_correlation[0],
+                                            &vector1[0], &vector2[0], kLength,
+                                            kDimCrossCorrelation, 2, 1),
+             cross_correlation[0]));
+  BENCHMARK("DownsampleFastC",
+            WebRtcSpl_DownsampleFastC(&vector1[kCoefficientsLength],
+                                      kLength - kCoefficientsLength, &out[0],
+                                      (kLength - kCoefficientsLength) / 2,
+                                      &coefficients[0], kCoefficientsLength,
+                                      2, 0));
+  BENCHMARK("DownsampleFastSSE2",
+            WebRtcSpl_DownsampleFastSSE2(&vector1[kCoefficientsLength],
+                                         kLength - kCoefficientsLength,
+                                         &out[0],
+                                         (kLength - kCoefficientsLength) / 2,
+                                         &coefficients[0],
+                                         kCoefficientsLength, 2, 0));
+  BENCHMARK("ScaleAndAddVectorsWithRoundC",
+            WebRtcSpl_ScaleAndAddVectorsWithRoundC(
+                &vector1[0], 12345, &vector2[0], -5432, 14, &out[0], kLength));
+  BENCHMARK("ScaleAndAddVectorsWithRoundSSE2",
+            WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(
+                &vector1[0], 12345, &vector2[0], -5432, 14, &out[0], kLength));
+  // Recursive, so it stays scalar; for comparison with the others.
+  BENCHMARK("FilterARFastQ12",
+            (WebRtcSpl_FilterARFastQ12(&vector1[0], &out[kCoefficientsLength],
+                                       &coefficients[0], kCoefficientsLength,
+                                       kLength - kCoefficientsLength),
+             out[kCoefficientsLength]));
+#undef BENCHMARK
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// SSE2 version of WebRtcSpl_ScaleAndAddVectorsWithRound(), bit-exact with
+// the C version.
+int WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(const int16_t* in_vector1,
+                                              int16_t in_vector1_scale,
+                                              const int16_t* in_vector2,
+                                              int16_t in_vector2_scale,
+                                              int right_shifts,
+                                              int16_t* out_vector,
+                                              size_t length) {
+  size_t i = 0;
+  int round_value = (1 << right_shifts) >> 1;
+
+  if (in_vector1 == NULL || in_vector2 == NULL || out_vector == NULL ||
+      length == 0 || right_shifts < 0) {
+    return -1;
+  }
+
+  {
+    // Interleaves the samples of the two vectors, to get both products and
+    // their sum from one multiplication per pair.
+    const __m128i scales = _mm_set1_epi32(
+        (int32_t)(((uint32_t)(uint16_t)in_vector2_scale << 16) |
+                  (uint16_t)in_vector1_scale));
+    const __m128i round = _mm_set1_epi32(round_value);
+    const __m128i shift = _mm_cvtsi32_si128(right_shifts);
+    for (; i + 8 <= length; i += 8) {
+      const __m128i a = _mm_loadu_si128((const __m128i*)&in_vector1[i]);
+      const __m128i b = _mm_loadu_si128((const __m128i*)&in_vector2[i]);
+      __m128i low = _mm_madd_epi16(_mm_unpacklo_epi16(a, b), scales);
+      __m128i high = _mm_madd_epi16(_mm_unpackhi_epi16(a, b), scales);
+      low = _mm_sra_epi32(_mm_add_epi32(low, round), shift);
+      high = _mm_sra_epi32(_mm_add_epi32(high, round), shift);
+      // Keep the low 16 bits, like the cast in the C version, rather than
+      // saturating.
+      low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+      high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+      _mm_storeu_si128((__m128i*)&out_vector[i], _mm_packs_epi32(low, high));
+    }
+  }
+
+  for (; i < length; i++) {
+    out_vector[i] = (int16_t)((
+        in_vector1[i] * in_vector1_scale + in_vector2[i] * in_vector2_scale +
+        round_value) >> right_shifts);
+  }
+
+  return 0;
+}
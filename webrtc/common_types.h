@@ -187,6 +187,18 @@ class RtcpStatisticsCallback {
   virtual void CNameChanged(const char* cname, uint32_t ssrc) = 0;
 };
 
+// Callback, called for each RTCP sender report received from the remote SSRC
+// of an RTP module.
+class RtcpSenderReportObserver {
+ public:
+  virtual ~RtcpSenderReportObserver() {}
+
+  virtual void OnSenderReport(uint32_t ssrc,
+                              uint32_t ntp_secs,
+                              uint32_t ntp_frac,
+                              uint32_t rtp_timestamp) = 0;
+};
+
 // Statistics for RTCP packet types.
 struct RtcpPacketTypeCounter {
   RtcpPacketTypeCounter()
@@ -281,6 +293,45 @@ class SendSideDelayObserver {
                                     uint32_t ssrc) = 0;
 };
 
+// Points in the video pipeline at which frames are time-stamped to find where
+// latency accumulates, in pipeline order.
+enum VideoFrameStage {
+  // Send side.
+  kVideoFrameCaptured = 0,   // Delivered to the send stream.
+  kVideoFrameEncodeStart,    // Handed to the encoder.
+  kVideoFrameEncoded,        // Returned by the encoder.
+  kVideoFramePacketized,     // Packetized and queued in the pacer.
+  kVideoFrameSent,           // Last packet sent to the transport.
+  // Receive side.
+  kVideoFrameReceived,       // First packet inserted into the jitter buffer.
+  kVideoFrameComplete,       // All packets in the jitter buffer.
+  kVideoFrameDecodeStart,    // Handed to the decoder.
+  kVideoFrameDecoded,        // Returned by the decoder.
+  kVideoFrameRendered,       // Delivered to the renderer.
+  kVideoFrameStageCount
+};
+
+// Callback, used to notify an observer whenever a video frame reaches a stage
+// of the pipeline. On the send side frames are identified by their capture
+// time in ms, on the receive side by their RTP timestamp.
+class VideoFrameStageObserver {
+ public:
+  virtual ~VideoFrameStageObserver() {}
+  virtual void OnFrameStage(VideoFrameStage stage, int64_t frame_id) = 0;
+};
+
+// Distribution of the time frames spent getting from the previous tracked
+// stage of the pipeline to a stage.
+struct FrameStageLatency {
+  FrameStageLatency()
+      : num_frames(0), avg_ms(0), median_ms(0), p95_ms(0), max_ms(0) {}
+  int num_frames;
+  int avg_ms;
+  int median_ms;
+  int p95_ms;
+  int max_ms;
+};
+
 // ==================================================================
 // Voice specific types
 // ==================================================================
@@ -390,6 +441,42 @@ struct AudioDecodingCallStats {
   int decoded_plc_cng;  // Number of calls resulted where PLC faded to CNG.
 };
 
+// Stages of the audio pipeline, in the order 10 ms blocks of audio pass
+// through them from the microphone to the speaker.
+enum AudioPipelineStage {
+  // Capture and playout buffering reported by the audio device, i.e. the
+  // stream delay given to the APM.
+  kAudioStageDeviceBuffers = 0,
+  // Near-end processing in the TransmitMixer, including the APM.
+  kAudioStageCaptureProcessing,
+  // Waiting in the ACM for a full packet, including encoding.
+  kAudioStageEncoderBuffer,
+  // Packetization and hand-over to the transport.
+  kAudioStageSend,
+  // Audio buffered by NetEq (packet buffer and sync buffer).
+  kAudioStageJitterBuffer,
+  // Getting 10 ms of audio out of NetEq, including decoding.
+  kAudioStageDecode,
+  // Processing of the mixed signal in the OutputMixer, including far-end
+  // APM analysis and resampling to the device rate.
+  kAudioStagePlayoutProcessing,
+  kAudioStageCount
+};
+
+// Time 10 ms blocks of audio spent in a stage of the audio pipeline.
+struct AudioStageDelay {
+  AudioStageDelay() : num_blocks(0), average_us(0), max_us(0) {}
+
+  int num_blocks;  // Number of blocks measured, 0 if the stage is not used.
+  int average_us;
+  int max_us;
+};
+
+// Breakdown of the delay from the microphone to the speaker, per stage.
+struct AudioPipelineStatistics {
+  AudioStageDelay stages[kAudioStageCount];
+};
+
 typedef struct
 {
     int min;              // minumum
@@ -11,18 +11,43 @@
 #include "webrtc/examples/peerconnection/server/data_socket.h"
 
 #include <ctype.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#if defined(WEBRTC_POSIX)
-#include <unistd.h>
-#endif
 
+#include <algorithm>
+
+#include "webrtc/base/stringutils.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/examples/peerconnection/server/utils.h"
 
 static const char kHeaderTerminator[] = "\r\n\r\n";
 static const int kHeaderTerminatorLength = sizeof(kHeaderTerminator) - 1;
 
+// Connections buffering more unhandled request data than this are closed.
+static const size_t kMaxBufferedRequestData = 1024 * 1024;
+
+// Requests with a larger body than this are rejected.
+static const size_t kMaxContentLength = kMaxBufferedRequestData;
+
+// Parses the value of a Content-Length header, which must be a decimal number
+// no larger than kMaxContentLength. Returns false if it is not.
+static bool ParseContentLength(const char* value, size_t* content_length) {
+  if (!isdigit(value[0]))
+    return false;  // Also rejects the signs accepted by strtoul().
+  char* value_end = NULL;
+  errno = 0;
+  unsigned long length = strtoul(value, &value_end, 10);
+  if (errno != 0 || length > kMaxContentLength)
+    return false;
+  if (!isspace(value_end[0]))
+    return false;  // The headers always end with "\r\n".
+  *content_length = length;
+  return true;
+}
+
 // static
 const char DataSocket::kCrossOriginAllowHeaders[] =
     "Access-Control-Allow-Origin: *\r\n"
@@ -32,42 +57,30 @@ const char DataSocket::kCrossOriginAllowHeaders[] =
         "Content-Length, Connection, Cache-Control\r\n"
     "Access-Control-Expose-Headers: Content-Length, X-Peer-Id\r\n";
 
-#if defined(WIN32)
-class WinsockInitializer {
-  static WinsockInitializer singleton;
-
-  WinsockInitializer() {
-    WSADATA data;
-    WSAStartup(MAKEWORD(1, 0), &data);
-  }
-
- public:
-  ~WinsockInitializer() { WSACleanup(); }
-};
-WinsockInitializer WinsockInitializer::singleton;
-#endif
-
 //
-// SocketBase
+// DataSocket
 //
 
-bool SocketBase::Create() {
-  assert(!valid());
-  socket_ = ::socket(AF_INET, SOCK_STREAM, 0);
-  return valid();
+DataSocket::DataSocket(rtc::AsyncSocket* socket)
+    : socket_(socket),
+      closed_(false),
+      close_after_send_(false),
+      processing_buffer_(false),
+      responded_(false),
+      last_activity_(rtc::Time()),
+      method_(INVALID),
+      keep_alive_(false),
+      content_length_(0) {
+  assert(socket);
+  socket_->SignalReadEvent.connect(this, &DataSocket::OnReadEvent);
+  socket_->SignalWriteEvent.connect(this, &DataSocket::OnWriteEvent);
+  socket_->SignalCloseEvent.connect(this, &DataSocket::OnCloseEvent);
 }
 
-void SocketBase::Close() {
-  if (socket_ != INVALID_SOCKET) {
-    closesocket(socket_);
-    socket_ = INVALID_SOCKET;
-  }
+DataSocket::~DataSocket() {
+  rtc::Thread::Current()->Clear(this);
 }
 
-//
-// DataSocket
-//
-
 std::string DataSocket::request_arguments() const {
   size_t args = request_path_.find('?');
   if (args != std::string::npos)
@@ -83,54 +96,23 @@ bool DataSocket::PathEquals(const char* path) const {
   return request_path_.compare(path) == 0;
 }
 
-bool DataSocket::OnDataAvailable(bool* close_socket) {
-  assert(valid());
-  char buffer[0xfff] = {0};
-  int bytes = recv(socket_, buffer, sizeof(buffer), 0);
-  if (bytes == SOCKET_ERROR || bytes == 0) {
-    *close_socket = true;
-    return false;
-  }
-
-  *close_socket = false;
-
-  bool ret = true;
-  if (headers_received()) {
-    if (method_ != POST) {
-      // unexpectedly received data.
-      ret = false;
-    } else {
-      data_.append(buffer, bytes);
-    }
-  } else {
-    request_headers_.append(buffer, bytes);
-    size_t found = request_headers_.find(kHeaderTerminator);
-    if (found != std::string::npos) {
-      data_ = request_headers_.substr(found + kHeaderTerminatorLength);
-      request_headers_.resize(found + kHeaderTerminatorLength);
-      ret = ParseHeaders();
-    }
-  }
-  return ret;
-}
-
-bool DataSocket::Send(const std::string& data) const {
-  return send(socket_, data.data(), static_cast<int>(data.length()), 0) !=
-      SOCKET_ERROR;
-}
-
-bool DataSocket::Send(const std::string& status, bool connection_close,
+bool DataSocket::Send(const std::string& status,
                       const std::string& content_type,
                       const std::string& extra_headers,
-                      const std::string& data) const {
-  assert(valid());
+                      const std::string& data) {
   assert(!status.empty());
+  assert(request_received() && !responded_);
+  if (closed_)
+    return false;
+
   std::string buffer("HTTP/1.1 " + status + "\r\n");
 
   buffer += "Server: PeerConnectionTestServer/0.1\r\n"
             "Cache-Control: no-cache\r\n";
 
-  if (connection_close)
+  if (keep_alive_)
+    buffer += "Connection: keep-alive\r\n";
+  else
     buffer += "Connection: close\r\n";
 
   if (!content_type.empty())
@@ -149,10 +131,124 @@ bool DataSocket::Send(const std::string& status, bool connection_close,
   buffer += "\r\n";
   buffer += data;
 
-  return Send(buffer);
+  outgoing_ += buffer;
+  last_activity_ = rtc::Time();
+  close_after_send_ = !keep_alive_;
+  // The request stays available to the caller until the next one is parsed.
+  responded_ = true;
+
+  if (!Flush()) {
+    Close();
+    return false;
+  }
+
+  // Responses to hanging GETs are sent from the handling of other sockets,
+  // so continue with the next request from the message loop.
+  if (!close_after_send_ && !buffer_.empty() && !processing_buffer_)
+    rtc::Thread::Current()->Post(this, MSG_PROCESS_BUFFER);
+  return true;
+}
+
+void DataSocket::Close() {
+  if (closed_)
+    return;
+  closed_ = true;
+  socket_->Close();
+  SignalClosed(this);
+}
+
+void DataSocket::OnMessage(rtc::Message* msg) {
+  assert(msg->message_id == MSG_PROCESS_BUFFER);
+  ProcessBuffer();
+}
+
+void DataSocket::OnReadEvent(rtc::AsyncSocket* socket) {
+  char buffer[0xfff];
+  do {
+    int bytes = socket_->Recv(buffer, sizeof(buffer));
+    if (bytes <= 0) {
+      if (!socket_->IsBlocking()) {
+        Close();
+        return;
+      }
+      break;
+    }
+    buffer_.append(buffer, bytes);
+  } while (true);
+
+  if (buffer_.size() > kMaxBufferedRequestData) {
+    printf("Too much request data buffered, closing connection\n");
+    Close();
+    return;
+  }
+
+  last_activity_ = rtc::Time();
+  ProcessBuffer();
+}
+
+void DataSocket::OnWriteEvent(rtc::AsyncSocket* socket) {
+  if (!Flush())
+    Close();
+}
+
+void DataSocket::OnCloseEvent(rtc::AsyncSocket* socket, int error) {
+  Close();
+}
+
+void DataSocket::ProcessBuffer() {
+  processing_buffer_ = true;
+  while (!closed_ && !close_after_send_) {
+    if (responded_)
+      Clear();
+    if (request_received())
+      break;  // Waiting for the response to the current request.
+
+    if (!headers_received()) {
+      size_t found = buffer_.find(kHeaderTerminator);
+      if (found == std::string::npos)
+        break;
+      request_headers_.assign(buffer_, 0, found + kHeaderTerminatorLength);
+      buffer_.erase(0, found + kHeaderTerminatorLength);
+      if (!ParseHeaders()) {
+        printf("Received an invalid request, closing connection\n");
+        Close();
+        break;
+      }
+    }
+
+    if (method_ == POST) {
+      size_t missing = content_length_ - data_.length();
+      size_t available = std::min(missing, buffer_.length());
+      data_.append(buffer_, 0, available);
+      buffer_.erase(0, available);
+    }
+
+    if (!request_received())
+      break;
+
+    // If the handler answers right away, the loop goes on with the next
+    // request.
+    SignalRequestReceived(this);
+  }
+  processing_buffer_ = false;
+}
+
+bool DataSocket::Flush() {
+  while (!outgoing_.empty()) {
+    int sent = socket_->Send(outgoing_.data(), outgoing_.length());
+    if (sent <= 0) {
+      // Continued from OnWriteEvent() when the socket is writable again.
+      return socket_->IsBlocking();
+    }
+    outgoing_.erase(0, sent);
+  }
+  if (close_after_send_)
+    Close();
+  return true;
 }
 
 void DataSocket::Clear() {
+  responded_ = false;
   method_ = INVALID;
   content_length_ = 0;
   content_type_.clear();
@@ -174,9 +270,11 @@ bool DataSocket::ParseHeaders() {
   assert(method_ != INVALID);
   assert(!request_path_.empty());
 
+  const char* headers = request_headers_.data() + i + 2;
+  size_t len = request_headers_.length() - i - 2;
+  ParseKeepAlive(request_headers_.data(), i, headers, len);
+
   if (method_ == POST) {
-    const char* headers = request_headers_.data() + i + 2;
-    size_t len = request_headers_.length() - i - 2;
     if (!ParseContentLengthAndType(headers, len))
       return false;
   }
@@ -236,7 +334,8 @@ bool DataSocket::ParseContentLengthAndType(const char* headers, size_t length) {
         headers += ARRAYSIZE(kContentLength) - 1;
         while (headers[0] == ' ')
           ++headers;
-        content_length_ = atoi(headers);
+        if (!ParseContentLength(headers, &content_length_))
+          return false;
       } else if ((headers + ARRAYSIZE(kContentType)) < end &&
                  strncmp(headers, kContentType,
                          ARRAYSIZE(kContentType) - 1) == 0) {
@@ -259,35 +358,86 @@ bool DataSocket::ParseContentLengthAndType(const char* headers, size_t length) {
   return !content_type_.empty() && content_length_ != 0;
 }
 
+void DataSocket::ParseKeepAlive(const char* request_line,
+                                size_t request_line_length,
+                                const char* headers, size_t length) {
+  static const char kHttp11[] = "HTTP/1.1";
+  static const size_t kHttp11Length = ARRAYSIZE(kHttp11) - 1;
+  bool http11 = request_line_length >= kHttp11Length &&
+                strncmp(request_line + request_line_length - kHttp11Length,
+                        kHttp11, kHttp11Length) == 0;
+
+  std::string connection;
+  const char* end = headers + length;
+  while (headers && headers < end) {
+    static const char kConnection[] = "Connection:";
+    if ((headers + ARRAYSIZE(kConnection)) < end &&
+        _strnicmp(headers, kConnection, ARRAYSIZE(kConnection) - 1) == 0) {
+      headers += ARRAYSIZE(kConnection) - 1;
+      while (headers[0] == ' ')
+        ++headers;
+      const char* value_end = strstr(headers, "\r\n");
+      if (value_end == NULL)
+        value_end = end;
+      connection.assign(headers, value_end);
+      break;
+    }
+    headers = strstr(headers, "\r\n");
+    if (headers)
+      headers += 2;
+  }
+
+  // HTTP/1.1 connections are persistent unless the client says otherwise,
+  // HTTP/1.0 ones only when the client asks for it.
+  if (http11) {
+    keep_alive_ = _stricmp(connection.c_str(), "close") != 0;
+  } else {
+    keep_alive_ = _stricmp(connection.c_str(), "keep-alive") == 0;
+  }
+}
+
 //
 // ListeningSocket
 //
 
-bool ListeningSocket::Listen(unsigned short port) {
-  assert(valid());
+bool ListeningSocket::Create(rtc::PhysicalSocketServer* ss) {
+  assert(!valid());
+  // The socket is created here to allow reusing the address of an earlier
+  // server, which rtc::Socket has no option for.
+  SOCKET s = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (s == INVALID_SOCKET)
+    return false;
   int enabled = 1;
-  setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR,
+  setsockopt(s, SOL_SOCKET, SO_REUSEADDR,
       reinterpret_cast<const char*>(&enabled), sizeof(enabled));
-  struct sockaddr_in addr = {0};
-  addr.sin_family = AF_INET;
-  addr.sin_addr.s_addr = htonl(INADDR_ANY);
-  addr.sin_port = htons(port);
-  if (bind(socket_, reinterpret_cast<const sockaddr*>(&addr),
-           sizeof(addr)) == SOCKET_ERROR) {
+  socket_.reset(ss->WrapSocket(s));
+  if (!socket_)
+    return false;
+  socket_->SignalReadEvent.connect(this, &ListeningSocket::OnReadEvent);
+  return true;
+}
+
+bool ListeningSocket::Listen(unsigned short port) {
+  assert(valid());
+  if (socket_->Bind(rtc::SocketAddress(INADDR_ANY, port)) == SOCKET_ERROR) {
     printf("bind failed\n");
     return false;
   }
-  return listen(socket_, 5) != SOCKET_ERROR;
+  return socket_->Listen(SOMAXCONN) != SOCKET_ERROR;
+}
+
+void ListeningSocket::Close() {
+  socket_.reset();
 }
 
-DataSocket* ListeningSocket::Accept() const {
+void ListeningSocket::OnReadEvent(rtc::AsyncSocket* socket) {
   assert(valid());
-  struct sockaddr_in addr = {0};
-  socklen_t size = sizeof(addr);
-  NativeSocket client =
-      accept(socket_, reinterpret_cast<sockaddr*>(&addr), &size);
-  if (client == INVALID_SOCKET)
-    return NULL;
-
-  return new DataSocket(client);
+  // Accept all pending connections instead of one per wait of the socket
+  // server.
+  while (valid()) {
+    rtc::AsyncSocket* client = socket_->Accept(NULL);
+    if (!client)
+      break;
+    SignalConnectionAccepted(new DataSocket(client));
+  }
 }
@@ -12,46 +12,19 @@
 #define TALK_EXAMPLES_PEERCONNECTION_SERVER_DATA_SOCKET_H_
 #pragma once
 
-#ifdef WIN32
-#include <winsock2.h>
-typedef int socklen_t;
-typedef SOCKET NativeSocket;
-#else
-#include <netinet/in.h>
-#include <sys/select.h>
-#include <sys/socket.h>
-#define closesocket close
-typedef int NativeSocket;
-
-#ifndef SOCKET_ERROR
-#define SOCKET_ERROR (-1)
-#endif
-
-#ifndef INVALID_SOCKET
-#define INVALID_SOCKET  static_cast<NativeSocket>(-1)
-#endif
-#endif
-
 #include <string>
 
-class SocketBase {
- public:
-  SocketBase() : socket_(INVALID_SOCKET) { }
-  explicit SocketBase(NativeSocket socket) : socket_(socket) { }
-  ~SocketBase() { Close(); }
-
-  NativeSocket socket() const { return socket_; }
-  bool valid() const { return socket_ != INVALID_SOCKET; }
-
-  bool Create();
-  void Close();
-
- protected:
-  NativeSocket socket_;
-};
-
-// Represents an HTTP server socket.
-class DataSocket : public SocketBase {
+#include "webrtc/base/asyncsocket.h"
+#include "webrtc/base/messagehandler.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/sigslot.h"
+#include "webrtc/base/physicalsocketserver.h"
+
+// Represents an HTTP server connection.  Connections are kept alive between
+// requests when the client allows it.  Requests are handled one at a time:
+// data of pipelined requests is kept until the current request has been
+// answered, which for a hanging GET can be long after it was received.
+class DataSocket : public sigslot::has_slots<>, public rtc::MessageHandler {
  public:
   enum RequestMethod {
     INVALID,
@@ -60,17 +33,14 @@ class DataSocket : public SocketBase {
     OPTIONS,
   };
 
-  explicit DataSocket(NativeSocket socket)
-      : SocketBase(socket),
-        method_(INVALID),
-        content_length_(0) {
-  }
-
-  ~DataSocket() {
-  }
+  // Takes ownership of |socket|.
+  explicit DataSocket(rtc::AsyncSocket* socket);
+  ~DataSocket() override;
 
   static const char kCrossOriginAllowHeaders[];
 
+  bool valid() const { return !closed_; }
+
   bool headers_received() const { return method_ != INVALID; }
 
   RequestMethod method() const { return method_; }
@@ -92,33 +62,69 @@ class DataSocket : public SocketBase {
     return method_ != POST || data_.length() >= content_length_;
   }
 
-  // Checks if the request path (minus arguments) matches a given path.
-  bool PathEquals(const char* path) const;
+  // True if the connection stays open after the current request.
+  bool keep_alive() const { return keep_alive_; }
 
-  // Called when we have received some data from clients.
-  // Returns false if an error occurred.
-  bool OnDataAvailable(bool* close_socket);
+  // True if no request is being received, waits for its response or is
+  // being answered.
+  bool idle() const {
+    return (!headers_received() || responded_) && buffer_.empty() &&
+           outgoing_.empty();
+  }
+
+  // The time of the last request or response, in milliseconds.
+  uint32_t last_activity() const { return last_activity_; }
 
-  // Send a raw buffer of bytes.
-  bool Send(const std::string& data) const;
+  // Checks if the request path (minus arguments) matches a given path.
+  bool PathEquals(const char* path) const;
 
-  // Send an HTTP response.  The |status| should start with a valid HTTP
-  // response code, followed by a string.  E.g. "200 OK".
-  // If |connection_close| is set to true, an extra "Connection: close" HTTP
-  // header will be included.  |content_type| is the mime content type, not
-  // including the "Content-Type: " string.
+  // Send an HTTP response to the current request.  The |status| should start
+  // with a valid HTTP response code, followed by a string.  E.g. "200 OK".
+  // |content_type| is the mime content type, not including the
+  // "Content-Type: " string.
   // |extra_headers| should be either empty or a list of headers where each
   // header terminates with "\r\n".
   // |data| is the body of the message.  It's length will be specified via
   // a "Content-Length" header.
-  bool Send(const std::string& status, bool connection_close,
-            const std::string& content_type,
-            const std::string& extra_headers, const std::string& data) const;
+  // Afterwards the next pipelined request is handled, or the connection is
+  // closed if it is not kept alive.
+  bool Send(const std::string& status, const std::string& content_type,
+            const std::string& extra_headers, const std::string& data);
 
-  // Clears all held state and prepares the socket for receiving a new request.
-  void Clear();
+  // Closes the connection.  SignalClosed is emitted unless it was closed
+  // already.
+  void Close();
+
+  // Emitted when a complete request has been received.  The request must be
+  // answered with Send(), right away or later.
+  sigslot::signal1<DataSocket*> SignalRequestReceived;
+  // Emitted when the connection has been closed, by either side.  The
+  // DataSocket must not be deleted from within the handler.
+  sigslot::signal1<DataSocket*> SignalClosed;
 
  protected:
+  enum {
+    MSG_PROCESS_BUFFER,
+  };
+
+  // rtc::MessageHandler implementation.
+  void OnMessage(rtc::Message* msg) override;
+
+  void OnReadEvent(rtc::AsyncSocket* socket);
+  void OnWriteEvent(rtc::AsyncSocket* socket);
+  void OnCloseEvent(rtc::AsyncSocket* socket, int error);
+
+  // Parses requests from the received data, until a request is waiting for
+  // its response or more data is needed.
+  void ProcessBuffer();
+
+  // Sends as much of the outgoing data as the socket takes.
+  // Returns false if an error occurred.
+  bool Flush();
+
+  // Clears all held state of the current request.
+  void Clear();
+
   // A fairly relaxed HTTP header parser.  Parses the method, path and
   // content length (POST only) of a request.
   // Returns true if a valid request was received and no errors occurred.
@@ -131,8 +137,25 @@ class DataSocket : public SocketBase {
   // Determines the length of the body and it's mime type.
   bool ParseContentLengthAndType(const char* headers, size_t length);
 
+  // Determines whether the connection is kept alive after the request.
+  void ParseKeepAlive(const char* request_line, size_t request_line_length,
+                      const char* headers, size_t length);
+
  protected:
+  rtc::scoped_ptr<rtc::AsyncSocket> socket_;
+  bool closed_;
+  // Received data that hasn't been parsed yet.
+  std::string buffer_;
+  // Response data that the socket hasn't taken yet.
+  std::string outgoing_;
+  bool close_after_send_;
+  bool processing_buffer_;
+  // Set when the current request has been answered.
+  bool responded_;
+  uint32_t last_activity_;
+
   RequestMethod method_;
+  bool keep_alive_;
   size_t content_length_;
   std::string content_type_;
   std::string request_path_;
@@ -142,12 +165,23 @@ class DataSocket : public SocketBase {
 
 // The server socket.  Accepts connections and generates DataSocket instances
 // for each new connection.
-class ListeningSocket : public SocketBase {
+class ListeningSocket : public sigslot::has_slots<> {
  public:
   ListeningSocket() {}
 
+  bool valid() const { return socket_.get() != NULL; }
+
+  bool Create(rtc::PhysicalSocketServer* ss);
   bool Listen(unsigned short port);
-  DataSocket* Accept() const;
+  void Close();
+
+  // Emitted for each accepted connection.  The receiver takes ownership.
+  sigslot::signal1<DataSocket*> SignalConnectionAccepted;
+
+ protected:
+  void OnReadEvent(rtc::AsyncSocket* socket);
+
+  rtc::scoped_ptr<rtc::AsyncSocket> socket_;
 };
 
 #endif  // TALK_EXAMPLES_PEERCONNECTION_SERVER_DATA_SOCKET_H_
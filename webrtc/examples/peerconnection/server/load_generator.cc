@@ -0,0 +1,475 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Simulates many peerconnection_client-style peers against a
+// peerconnection_server.  Each peer signs in, keeps a hanging GET pending on
+// /wait and sends messages to random other peers at a fixed interval, over
+// keep-alive connections.  Message delivery latency is measured from the
+// time the message was sent until the hanging GET of the target returns it.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/flags.h"
+#include "webrtc/base/physicalsocketserver.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/stringencode.h"
+#include "webrtc/base/stringutils.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
+
+DEFINE_bool(help, false, "Prints this message");
+DEFINE_string(server, "127.0.0.1", "The IP address of the server.");
+DEFINE_int(port, 8888, "The port of the server.");
+DEFINE_int(clients, 1000, "The number of simulated peers.");
+DEFINE_int(connect_rate, 500, "The number of peers signing in per second.");
+DEFINE_int(message_interval, 1000,
+           "Milliseconds between messages sent by each peer.");
+DEFINE_int(pipeline, 1,
+           "The number of messages a peer pipelines on its connection per "
+           "interval.");
+DEFINE_int(duration, 30, "Seconds to run after all peers have signed in.");
+
+namespace {
+
+const int kReportIntervalMs = 5000;
+const int kSignInStepMs = 100;
+
+struct Stats {
+  Stats()
+      : signed_in(0),
+        sign_in_time_ms(0),
+        max_sign_in_time_ms(0),
+        messages_sent(0),
+        messages_delivered(0),
+        delivery_time_ms(0),
+        max_delivery_time_ms(0),
+        notifications(0),
+        errors(0),
+        connections_lost(0) {}
+
+  int signed_in;
+  int64_t sign_in_time_ms;
+  int max_sign_in_time_ms;
+  int messages_sent;
+  int messages_delivered;
+  int64_t delivery_time_ms;
+  int max_delivery_time_ms;
+  int notifications;
+  int errors;
+  int connections_lost;
+};
+
+struct HttpResponse {
+  int status;
+  int peer_id;
+  std::string body;
+};
+
+// A keep-alive HTTP/1.1 client connection.  Requests are sent without waiting
+// for the responses to earlier ones.
+class HttpConnection : public sigslot::has_slots<> {
+ public:
+  HttpConnection(rtc::SocketFactory* factory,
+                 const rtc::SocketAddress& server)
+      : factory_(factory), server_(server), connected_(false) {}
+
+  void SendRequest(const std::string& request) {
+    if (!socket_ && !Connect())
+      return;
+    outgoing_ += request;
+    Flush();
+  }
+
+  void Close() {
+    if (socket_) {
+      // Closing happens from within the callbacks of the socket.
+      socket_->Close();
+      rtc::Thread::Current()->Dispose(socket_.release());
+    }
+    connected_ = false;
+    outgoing_.clear();
+    incoming_.clear();
+  }
+
+  sigslot::signal2<HttpConnection*, const HttpResponse&> SignalResponse;
+  sigslot::signal1<HttpConnection*> SignalClosed;
+
+ private:
+  bool Connect() {
+    socket_.reset(factory_->CreateAsyncSocket(server_.family(), SOCK_STREAM));
+    if (!socket_)
+      return false;
+    socket_->SignalConnectEvent.connect(this, &HttpConnection::OnConnect);
+    socket_->SignalReadEvent.connect(this, &HttpConnection::OnRead);
+    socket_->SignalWriteEvent.connect(this, &HttpConnection::OnWrite);
+    socket_->SignalCloseEvent.connect(this, &HttpConnection::OnCloseEvent);
+    if (socket_->Connect(server_) == SOCKET_ERROR) {
+      socket_.reset();
+      return false;
+    }
+    return true;
+  }
+
+  void Flush() {
+    while (connected_ && !outgoing_.empty()) {
+      int sent = socket_->Send(outgoing_.data(), outgoing_.length());
+      if (sent <= 0)
+        return;  // Continued from OnWrite().
+      outgoing_.erase(0, sent);
+    }
+  }
+
+  void OnConnect(rtc::AsyncSocket* socket) {
+    connected_ = true;
+    Flush();
+  }
+
+  void OnWrite(rtc::AsyncSocket* socket) { Flush(); }
+
+  void OnRead(rtc::AsyncSocket* socket) {
+    char buffer[0xffff];
+    do {
+      int bytes = socket_->Recv(buffer, sizeof(buffer));
+      if (bytes <= 0)
+        break;
+      incoming_.append(buffer, bytes);
+    } while (true);
+
+    while (socket_) {
+      size_t eoh = incoming_.find("\r\n\r\n");
+      if (eoh == std::string::npos)
+        return;
+      size_t content_length = 0;
+      GetHeaderValue(eoh, "\r\nContent-Length: ", &content_length);
+      size_t total = eoh + 4 + content_length;
+      if (incoming_.length() < total)
+        return;
+
+      HttpResponse response;
+      response.status = atoi(incoming_.c_str() + incoming_.find(' ') + 1);
+      size_t peer_id = 0;
+      response.peer_id = GetHeaderValue(eoh, "\r\nPragma: ", &peer_id) ?
+          static_cast<int>(peer_id) : -1;
+      response.body = incoming_.substr(eoh + 4, content_length);
+      bool close = incoming_.find("\r\nConnection: close") < eoh;
+      incoming_.erase(0, total);
+
+      if (close)
+        Close();
+      SignalResponse(this, response);
+    }
+  }
+
+  void OnCloseEvent(rtc::AsyncSocket* socket, int error) {
+    Close();
+    SignalClosed(this);
+  }
+
+  bool GetHeaderValue(size_t eoh, const char* header, size_t* value) const {
+    size_t found = incoming_.find(header);
+    if (found == std::string::npos || found >= eoh)
+      return false;
+    *value = atoi(&incoming_[found + strlen(header)]);
+    return true;
+  }
+
+  rtc::SocketFactory* const factory_;
+  const rtc::SocketAddress server_;
+  rtc::scoped_ptr<rtc::AsyncSocket> socket_;
+  bool connected_;
+  std::string outgoing_;
+  std::string incoming_;
+};
+
+// Registry of the ids of the peers that have signed in, to pick message
+// targets from.
+class PeerIds {
+ public:
+  void Add(int id) { ids_.push_back(id); }
+  void Remove(int id) {
+    std::vector<int>::iterator it = std::find(ids_.begin(), ids_.end(), id);
+    if (it != ids_.end()) {
+      *it = ids_.back();
+      ids_.pop_back();
+    }
+  }
+  // Returns a random id other than |id|, or -1.
+  int PickOther(int id) const {
+    if (ids_.size() < 2)
+      return -1;
+    int other = ids_[rand() % ids_.size()];
+    return other != id ? other : -1;
+  }
+
+ private:
+  std::vector<int> ids_;
+};
+
+// A simulated peer, using one connection for sign in, messages and sign out,
+// and one for its hanging GET, like peerconnection_client.
+class SimulatedClient : public sigslot::has_slots<>,
+                        public rtc::MessageHandler {
+ public:
+  SimulatedClient(int index,
+                  rtc::Thread* thread,
+                  const rtc::SocketAddress& server,
+                  PeerIds* peers,
+                  Stats* stats)
+      : index_(index),
+        thread_(thread),
+        peers_(peers),
+        stats_(stats),
+        control_(thread->socketserver(), server),
+        hanging_get_(thread->socketserver(), server),
+        id_(-1),
+        sign_in_time_(0),
+        signing_out_(false) {
+    control_.SignalResponse.connect(this, &SimulatedClient::OnControlResponse);
+    control_.SignalClosed.connect(this, &SimulatedClient::OnConnectionLost);
+    hanging_get_.SignalResponse.connect(this,
+                                        &SimulatedClient::OnWaitResponse);
+    hanging_get_.SignalClosed.connect(this,
+                                      &SimulatedClient::OnConnectionLost);
+  }
+
+  ~SimulatedClient() override { thread_->Clear(this); }
+
+  void SignIn() {
+    char request[128];
+    rtc::sprintfn(request, sizeof(request),
+                  "GET /sign_in?load_%d HTTP/1.1\r\n\r\n", index_);
+    sign_in_time_ = rtc::Time();
+    control_.SendRequest(request);
+  }
+
+  void SignOut() {
+    if (id_ == -1 || signing_out_)
+      return;
+    signing_out_ = true;
+    thread_->Clear(this);
+    peers_->Remove(id_);
+    hanging_get_.Close();
+    char request[128];
+    rtc::sprintfn(request, sizeof(request),
+                  "GET /sign_out?peer_id=%d HTTP/1.1\r\n\r\n", id_);
+    control_.SendRequest(request);
+  }
+
+ private:
+  void Wait() {
+    char request[128];
+    rtc::sprintfn(request, sizeof(request),
+                  "GET /wait?peer_id=%d HTTP/1.1\r\n\r\n", id_);
+    hanging_get_.SendRequest(request);
+  }
+
+  void SendMessage() {
+    int target = peers_->PickOther(id_);
+    if (target == -1)
+      return;
+    // The body carries the send time, to measure the delivery latency.
+    std::string body = rtc::ToString(rtc::Time());
+    char request[256];
+    rtc::sprintfn(request, sizeof(request),
+                  "POST /message?peer_id=%d&to=%d HTTP/1.1\r\n"
+                  "Content-Length: %d\r\n"
+                  "Content-Type: text/plain\r\n"
+                  "\r\n", id_, target, static_cast<int>(body.length()));
+    control_.SendRequest(request + body);
+    ++stats_->messages_sent;
+  }
+
+  // Sends the messages of one interval.
+  void OnMessage(rtc::Message* msg) override {
+    for (int i = 0; i < FLAG_pipeline; ++i)
+      SendMessage();
+    thread_->PostDelayed(FLAG_message_interval, this);
+  }
+
+  void OnControlResponse(HttpConnection* connection,
+                         const HttpResponse& response) {
+    if (response.status != 200) {
+      ++stats_->errors;
+      return;
+    }
+    if (id_ == -1) {
+      id_ = response.peer_id;
+      int elapsed = rtc::TimeSince(sign_in_time_);
+      ++stats_->signed_in;
+      stats_->sign_in_time_ms += elapsed;
+      stats_->max_sign_in_time_ms =
+          std::max(stats_->max_sign_in_time_ms, elapsed);
+      peers_->Add(id_);
+      Wait();
+      // Spread the messages of the peers over the interval.
+      thread_->PostDelayed(rand() % FLAG_message_interval + 1, this);
+    } else if (signing_out_) {
+      control_.Close();
+    }
+  }
+
+  void OnWaitResponse(HttpConnection* connection,
+                      const HttpResponse& response) {
+    if (signing_out_)
+      return;
+    if (response.status != 200) {
+      ++stats_->errors;
+    } else if (response.peer_id == id_) {
+      // A notification about a peer that signed in or out.
+      ++stats_->notifications;
+    } else {
+      uint32_t sent = static_cast<uint32_t>(strtoul(response.body.c_str(),
+                                                    NULL, 10));
+      int elapsed = rtc::TimeSince(sent);
+      ++stats_->messages_delivered;
+      stats_->delivery_time_ms += elapsed;
+      stats_->max_delivery_time_ms =
+          std::max(stats_->max_delivery_time_ms, elapsed);
+    }
+    Wait();
+  }
+
+  void OnConnectionLost(HttpConnection* connection) {
+    if (!signing_out_)
+      ++stats_->connections_lost;
+  }
+
+  const int index_;
+  rtc::Thread* const thread_;
+  PeerIds* const peers_;
+  Stats* const stats_;
+  HttpConnection control_;
+  HttpConnection hanging_get_;
+  int id_;
+  uint32_t sign_in_time_;
+  bool signing_out_;
+};
+
+// Signs in the peers at the configured rate, reports the statistics
+// periodically and signs all peers out at the end.
+class LoadGenerator : public rtc::MessageHandler {
+ public:
+  LoadGenerator(rtc::Thread* thread, const rtc::SocketAddress& server)
+      : thread_(thread), server_(server), start_time_(rtc::Time()) {}
+
+  ~LoadGenerator() override {
+    thread_->Clear(this);
+    for (size_t i = 0; i < clients_.size(); ++i)
+      delete clients_[i];
+  }
+
+  void Start() {
+    thread_->Post(this, MSG_SIGN_IN);
+    thread_->PostDelayed(kReportIntervalMs, this, MSG_REPORT);
+  }
+
+ private:
+  enum {
+    MSG_SIGN_IN,
+    MSG_REPORT,
+    MSG_SIGN_OUT,
+    MSG_QUIT,
+  };
+
+  void OnMessage(rtc::Message* msg) override {
+    switch (msg->message_id) {
+      case MSG_SIGN_IN: {
+        int count = std::max(1, FLAG_connect_rate * kSignInStepMs / 1000);
+        for (int i = 0; i < count && static_cast<int>(clients_.size()) <
+                                         FLAG_clients; ++i) {
+          SimulatedClient* client = new SimulatedClient(
+              static_cast<int>(clients_.size()), thread_, server_, &peers_,
+              &stats_);
+          clients_.push_back(client);
+          client->SignIn();
+        }
+        if (static_cast<int>(clients_.size()) < FLAG_clients) {
+          thread_->PostDelayed(kSignInStepMs, this, MSG_SIGN_IN);
+        } else {
+          thread_->PostDelayed(FLAG_duration * 1000, this, MSG_SIGN_OUT);
+        }
+        break;
+      }
+      case MSG_REPORT:
+        Report();
+        thread_->PostDelayed(kReportIntervalMs, this, MSG_REPORT);
+        break;
+      case MSG_SIGN_OUT:
+        printf("Signing out\n");
+        for (size_t i = 0; i < clients_.size(); ++i)
+          clients_[i]->SignOut();
+        thread_->PostDelayed(2000, this, MSG_QUIT);
+        break;
+      case MSG_QUIT:
+        Report();
+        thread_->Quit();
+        break;
+    }
+  }
+
+  void Report() {
+    int sent = stats_.messages_sent;
+    int delivered = stats_.messages_delivered;
+    printf("%5.1fs: %d/%d signed in (avg %d ms, max %d ms), "
+           "%d messages sent, %d delivered (avg %d ms, max %d ms), "
+           "%d notifications, %d errors, %d connections lost\n",
+           rtc::TimeSince(start_time_) / 1000.0, stats_.signed_in,
+           static_cast<int>(clients_.size()),
+           stats_.signed_in ? static_cast<int>(stats_.sign_in_time_ms /
+                                               stats_.signed_in) : 0,
+           stats_.max_sign_in_time_ms, sent, delivered,
+           delivered ? static_cast<int>(stats_.delivery_time_ms / delivered)
+                     : 0,
+           stats_.max_delivery_time_ms, stats_.notifications, stats_.errors,
+           stats_.connections_lost);
+  }
+
+  rtc::Thread* const thread_;
+  const rtc::SocketAddress server_;
+  const uint32_t start_time_;
+  PeerIds peers_;
+  Stats stats_;
+  std::vector<SimulatedClient*> clients_;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+  if (FLAG_help) {
+    rtc::FlagList::Print(NULL, false);
+    return 0;
+  }
+
+  if ((FLAG_port < 1) || (FLAG_port > 65535)) {
+    printf("Error: %i is not a valid port.\n", FLAG_port);
+    return -1;
+  }
+
+  rtc::SocketAddress server(FLAG_server, FLAG_port);
+  if (server.IsUnresolvedIP()) {
+    printf("Error: %s is not an IP address.\n", FLAG_server);
+    return -1;
+  }
+
+  rtc::PhysicalSocketServer socket_server;
+  rtc::AutoThread thread(&socket_server);
+  LoadGenerator generator(&thread, server);
+  generator.Start();
+  thread.Run();
+
+  return 0;
+}
@@ -12,17 +12,23 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include <vector>
+#include <unordered_set>
 
 #include "webrtc/examples/peerconnection/server/data_socket.h"
 #include "webrtc/examples/peerconnection/server/peer_channel.h"
 #include "webrtc/examples/peerconnection/server/utils.h"
 #include "webrtc/base/flags.h"
+#include "webrtc/base/physicalsocketserver.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 
 DEFINE_bool(help, false, "Prints this message");
 DEFINE_int(port, 8888, "The port on which to listen.");
+DEFINE_int(idle_timeout, 60,
+           "Seconds after which idle keep-alive connections are closed.");
 
-static const size_t kMaxConnections = (FD_SETSIZE - 2);
+// How often timed out peers and idle connections are looked for.
+static const int kTimeoutCheckIntervalMs = 10000;
 
 void HandleBrowserRequest(DataSocket* ds, bool* quit) {
   assert(ds && ds->valid());
@@ -33,141 +39,153 @@ void HandleBrowserRequest(DataSocket* ds, bool* quit) {
   *quit = (path.compare("/quit") == 0);
 
   if (*quit) {
-    ds->Send("200 OK", true, "text/html", "",
+    ds->Send("200 OK", "text/html", "",
              "<html><body>Quitting...</body></html>");
   } else if (ds->method() == DataSocket::OPTIONS) {
     // We'll get this when a browsers do cross-resource-sharing requests.
     // The headers to allow cross-origin script support will be set inside
     // Send.
-    ds->Send("200 OK", true, "", "", "");
+    ds->Send("200 OK", "", "", "");
   } else {
     // Here we could write some useful output back to the browser depending on
     // the path.
     printf("Received an invalid request: %s\n", ds->request_path().c_str());
-    ds->Send("500 Sorry", true, "text/html", "",
+    ds->Send("500 Sorry", "text/html", "",
              "<html><body>Sorry, not yet implemented</body></html>");
   }
 }
 
-int main(int argc, char** argv) {
-  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
-  if (FLAG_help) {
-    rtc::FlagList::Print(NULL, false);
-    return 0;
+// Handles the requests of all connections as they arrive.  Everything runs
+// on the thread of the socket server, which waits for the sockets with epoll
+// on Linux, so the number of connections isn't bounded by FD_SETSIZE.
+class SignalingServer : public sigslot::has_slots<>,
+                        public rtc::MessageHandler {
+ public:
+  SignalingServer(rtc::Thread* thread, rtc::PhysicalSocketServer* ss)
+      : thread_(thread), socket_server_(ss) {
+    listener_.SignalConnectionAccepted.connect(
+        this, &SignalingServer::OnConnectionAccepted);
   }
 
-  // Abort if the user specifies a port that is outside the allowed
-  // range [1, 65535].
-  if ((FLAG_port < 1) || (FLAG_port > 65535)) {
-    printf("Error: %i is not a valid port.\n", FLAG_port);
-    return -1;
+  ~SignalingServer() override {
+    thread_->Clear(this);
+    for (Sockets::iterator i = sockets_.begin(); i != sockets_.end(); ++i)
+      delete (*i);
   }
 
-  ListeningSocket listener;
-  if (!listener.Create()) {
-    printf("Failed to create server socket\n");
-    return -1;
-  } else if (!listener.Listen(FLAG_port)) {
-    printf("Failed to listen on server socket\n");
-    return -1;
+  bool Start(int port) {
+    if (!listener_.Create(socket_server_)) {
+      printf("Failed to create server socket\n");
+      return false;
+    } else if (!listener_.Listen(port)) {
+      printf("Failed to listen on server socket\n");
+      return false;
+    }
+    thread_->PostDelayed(kTimeoutCheckIntervalMs, this);
+    return true;
   }
 
-  printf("Server listening on port %i\n", FLAG_port);
+ private:
+  typedef std::unordered_set<DataSocket*> Sockets;
 
-  PeerChannel clients;
-  typedef std::vector<DataSocket*> SocketArray;
-  SocketArray sockets;
-  bool quit = false;
-  while (!quit) {
-    fd_set socket_set;
-    FD_ZERO(&socket_set);
-    if (listener.valid())
-      FD_SET(listener.socket(), &socket_set);
-
-    for (SocketArray::iterator i = sockets.begin(); i != sockets.end(); ++i)
-      FD_SET((*i)->socket(), &socket_set);
-
-    struct timeval timeout = { 10, 0 };
-    if (select(FD_SETSIZE, &socket_set, NULL, NULL, &timeout) == SOCKET_ERROR) {
-      printf("select failed\n");
-      break;
-    }
+  void OnConnectionAccepted(DataSocket* ds) {
+    ds->SignalRequestReceived.connect(this,
+                                      &SignalingServer::OnRequestReceived);
+    ds->SignalClosed.connect(this, &SignalingServer::OnConnectionClosed);
+    sockets_.insert(ds);
+  }
 
-    for (SocketArray::iterator i = sockets.begin(); i != sockets.end(); ++i) {
-      DataSocket* s = *i;
-      bool socket_done = true;
-      if (FD_ISSET(s->socket(), &socket_set)) {
-        if (s->OnDataAvailable(&socket_done) && s->request_received()) {
-          ChannelMember* member = clients.Lookup(s);
-          if (member || PeerChannel::IsPeerConnection(s)) {
-            if (!member) {
-              if (s->PathEquals("/sign_in")) {
-                clients.AddMember(s);
-              } else {
-                printf("No member found for: %s\n",
-                    s->request_path().c_str());
-                s->Send("500 Error", true, "text/plain", "",
-                        "Peer most likely gone.");
-              }
-            } else if (member->is_wait_request(s)) {
-              // no need to do anything.
-              socket_done = false;
-            } else {
-              ChannelMember* target = clients.IsTargetedRequest(s);
-              if (target) {
-                member->ForwardRequestToPeer(s, target);
-              } else if (s->PathEquals("/sign_out")) {
-                s->Send("200 OK", true, "text/plain", "", "");
-              } else {
-                printf("Couldn't find target for request: %s\n",
-                    s->request_path().c_str());
-                s->Send("500 Error", true, "text/plain", "",
-                        "Peer most likely gone.");
-              }
-            }
-          } else {
-            HandleBrowserRequest(s, &quit);
-            if (quit) {
-              printf("Quitting...\n");
-              FD_CLR(listener.socket(), &socket_set);
-              listener.Close();
-              clients.CloseAll();
-            }
-          }
+  void OnRequestReceived(DataSocket* s) {
+    ChannelMember* member = clients_.Lookup(s);
+    if (member || PeerChannel::IsPeerConnection(s)) {
+      if (!member) {
+        if (s->PathEquals("/sign_in")) {
+          clients_.AddMember(s);
+        } else {
+          printf("No member found for: %s\n", s->request_path().c_str());
+          s->Send("500 Error", "text/plain", "", "Peer most likely gone.");
         }
+      } else if (member->is_wait_request(s)) {
+        // no need to do anything.
       } else {
-        socket_done = false;
+        ChannelMember* target = clients_.IsTargetedRequest(s);
+        if (target) {
+          member->ForwardRequestToPeer(s, target);
+        } else if (s->PathEquals("/sign_out")) {
+          s->Send("200 OK", "text/plain", "", "");
+          clients_.RemoveMember(member);
+        } else {
+          printf("Couldn't find target for request: %s\n",
+              s->request_path().c_str());
+          s->Send("500 Error", "text/plain", "", "Peer most likely gone.");
+        }
       }
-
-      if (socket_done) {
-        printf("Disconnecting socket\n");
-        clients.OnClosing(s);
-        assert(s->valid());  // Close must not have been called yet.
-        FD_CLR(s->socket(), &socket_set);
-        delete (*i);
-        i = sockets.erase(i);
-        if (i == sockets.end())
-          break;
+    } else {
+      bool quit = false;
+      HandleBrowserRequest(s, &quit);
+      if (quit) {
+        printf("Quitting...\n");
+        listener_.Close();
+        clients_.CloseAll();
+        thread_->Quit();
       }
     }
+  }
 
-    clients.CheckForTimeout();
+  void OnConnectionClosed(DataSocket* ds) {
+    clients_.OnClosing(ds);
+    sockets_.erase(ds);
+    // The socket is still in use by the caller.
+    thread_->Dispose(ds);
+  }
 
-    if (FD_ISSET(listener.socket(), &socket_set)) {
-      DataSocket* s = listener.Accept();
-      if (sockets.size() >= kMaxConnections) {
-        delete s;  // sorry, that's all we can take.
-        printf("Connection limit reached\n");
-      } else {
-        sockets.push_back(s);
-        printf("New connection...\n");
+  // Periodically removes timed out peers and closes idle connections.
+  void OnMessage(rtc::Message* msg) override {
+    clients_.CheckForTimeout();
+
+    std::vector<DataSocket*> idle_sockets;
+    for (Sockets::iterator i = sockets_.begin(); i != sockets_.end(); ++i) {
+      if ((*i)->idle() &&
+          rtc::TimeSince((*i)->last_activity()) > FLAG_idle_timeout * 1000) {
+        idle_sockets.push_back(*i);
       }
     }
+    for (size_t i = 0; i < idle_sockets.size(); ++i)
+      idle_sockets[i]->Close();
+
+    thread_->PostDelayed(kTimeoutCheckIntervalMs, this);
   }
 
-  for (SocketArray::iterator i = sockets.begin(); i != sockets.end(); ++i)
-    delete (*i);
-  sockets.clear();
+  rtc::Thread* const thread_;
+  rtc::PhysicalSocketServer* const socket_server_;
+  ListeningSocket listener_;
+  PeerChannel clients_;
+  Sockets sockets_;
+};
+
+int main(int argc, char** argv) {
+  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+  if (FLAG_help) {
+    rtc::FlagList::Print(NULL, false);
+    return 0;
+  }
+
+  // Abort if the user specifies a port that is outside the allowed
+  // range [1, 65535].
+  if ((FLAG_port < 1) || (FLAG_port > 65535)) {
+    printf("Error: %i is not a valid port.\n", FLAG_port);
+    return -1;
+  }
+
+  rtc::PhysicalSocketServer socket_server;
+  rtc::AutoThread thread(&socket_server);
+  SignalingServer server(&thread, &socket_server);
+  if (!server.Start(FLAG_port))
+    return -1;
+
+  printf("Server listening on port %i\n", FLAG_port);
+
+  thread.Run();
 
   return 0;
 }
@@ -47,6 +47,16 @@ enum RequestPathIndex {
 
 const size_t kMaxNameLength = 512;
 
+// Returns the value of the "peer_id" argument of the request, or -1.
+static int GetPeerId(const DataSocket* ds) {
+  std::string args(ds->request_arguments());
+  static const char kPeerId[] = "peer_id=";
+  size_t found = args.find(kPeerId);
+  if (found == std::string::npos)
+    return -1;
+  return atoi(&args[found + ARRAYSIZE(kPeerId) - 1]);
+}
+
 //
 // ChannelMember
 //
@@ -109,14 +119,13 @@ void ChannelMember::ForwardRequestToPeer(DataSocket* ds, ChannelMember* peer) {
   std::string extra_headers(GetPeerIdHeader());
 
   if (peer == this) {
-    ds->Send("200 OK", true, ds->content_type(), extra_headers,
-             ds->data());
+    ds->Send("200 OK", ds->content_type(), extra_headers, ds->data());
   } else {
     printf("Client %s sending to %s\n",
         name_.c_str(), peer->name().c_str());
     peer->QueueResponse("200 OK", ds->content_type(), extra_headers,
                         ds->data());
-    ds->Send("200 OK", true, "text/plain", "", "");
+    ds->Send("200 OK", "text/plain", "", "");
   }
 }
 
@@ -134,13 +143,14 @@ void ChannelMember::QueueResponse(const std::string& status,
   if (waiting_socket_) {
     assert(queue_.size() == 0);
     assert(waiting_socket_->method() == DataSocket::GET);
-    bool ok = waiting_socket_->Send(status, true, content_type, extra_headers,
-                                    data);
+    // Sending may close the socket, which ends up in OnClosing().
+    DataSocket* ds = waiting_socket_;
+    waiting_socket_ = NULL;
+    timestamp_ = time(NULL);
+    bool ok = ds->Send(status, content_type, extra_headers, data);
     if (!ok) {
       printf("Failed to deliver data to waiting socket\n");
     }
-    waiting_socket_ = NULL;
-    timestamp_ = time(NULL);
   } else {
     QueuedResponse qr;
     qr.status = status;
@@ -155,10 +165,10 @@ void ChannelMember::SetWaitingSocket(DataSocket* ds) {
   assert(ds->method() == DataSocket::GET);
   if (ds && !queue_.empty()) {
     assert(waiting_socket_ == NULL);
-    const QueuedResponse& response = queue_.front();
-    ds->Send(response.status, true, response.content_type,
-             response.extra_headers, response.data);
+    QueuedResponse response = queue_.front();
     queue_.pop();
+    ds->Send(response.status, response.content_type, response.extra_headers,
+             response.data);
   } else {
     waiting_socket_ = ds;
   }
@@ -190,25 +200,19 @@ ChannelMember* PeerChannel::Lookup(DataSocket* ds) const {
   if (i == ARRAYSIZE(kRequestPaths))
     return NULL;
 
-  std::string args(ds->request_arguments());
-  static const char kPeerId[] = "peer_id=";
-  size_t found = args.find(kPeerId);
-  if (found == std::string::npos)
-    return NULL;
-
-  int id = atoi(&args[found + ARRAYSIZE(kPeerId) - 1]);
-  Members::const_iterator iter = members_.begin();
-  for (; iter != members_.end(); ++iter) {
-    if (id == (*iter)->id()) {
-      if (i == kWait)
-        (*iter)->SetWaitingSocket(ds);
-      if (i == kSignOut)
-        (*iter)->set_disconnected();
-      return *iter;
-    }
+  ChannelMember* member = Find(GetPeerId(ds));
+  if (member) {
+    if (i == kWait)
+      member->SetWaitingSocket(ds);
+    if (i == kSignOut)
+      member->set_disconnected();
   }
+  return member;
+}
 
-  return NULL;
+ChannelMember* PeerChannel::Find(int id) const {
+  Members::const_iterator it = members_.find(id);
+  return it != members_.end() ? it->second : NULL;
 }
 
 ChannelMember* PeerChannel::IsTargetedRequest(const DataSocket* ds) const {
@@ -231,23 +235,16 @@ ChannelMember* PeerChannel::IsTargetedRequest(const DataSocket* ds) const {
     }
     args = found + ARRAYSIZE(kTargetPeerIdParam) - 1;
   } while (true);
-  int id = atoi(&path[found]);
-  Members::const_iterator i = members_.begin();
-  for (; i != members_.end(); ++i) {
-    if ((*i)->id() == id) {
-      return *i;
-    }
-  }
-  return NULL;
+  return Find(atoi(&path[found]));
 }
 
 bool PeerChannel::AddMember(DataSocket* ds) {
   assert(IsPeerConnection(ds));
   ChannelMember* new_guy = new ChannelMember(ds);
-  Members failures;
+  MemberList failures;
   BroadcastChangedState(*new_guy, &failures);
   HandleDeliveryFailures(&failures);
-  members_.push_back(new_guy);
+  members_[new_guy->id()] = new_guy;
 
   printf("New member added (total=%s): %s\n",
       size_t2str(members_.size()).c_str(), new_guy->name().c_str());
@@ -255,61 +252,61 @@ bool PeerChannel::AddMember(DataSocket* ds) {
   // Let the newly connected peer know about other members of the channel.
   std::string content_type;
   std::string response = BuildResponseForNewMember(*new_guy, &content_type);
-  ds->Send("200 Added", true, content_type, new_guy->GetPeerIdHeader(),
-           response);
+  ds->Send("200 Added", content_type, new_guy->GetPeerIdHeader(), response);
   return true;
 }
 
 void PeerChannel::CloseAll() {
   Members::const_iterator i = members_.begin();
   for (; i != members_.end(); ++i) {
-    (*i)->QueueResponse("200 OK", "text/plain", "", "Server shutting down");
+    i->second->QueueResponse("200 OK", "text/plain", "",
+                             "Server shutting down");
   }
   DeleteAll();
 }
 
 void PeerChannel::OnClosing(DataSocket* ds) {
-  for (Members::iterator i = members_.begin(); i != members_.end(); ++i) {
-    ChannelMember* m = (*i);
+  // Only a socket with a pending wait request can be held by a member, and
+  // that request names the member.
+  if (!ds->headers_received() || !ds->PathEquals(kRequestPaths[kWait]))
+    return;
+  ChannelMember* m = Find(GetPeerId(ds));
+  if (m)
     m->OnClosing(ds);
-    if (!m->connected()) {
-      i = members_.erase(i);
-      Members failures;
-      BroadcastChangedState(*m, &failures);
-      HandleDeliveryFailures(&failures);
-      delete m;
-      if (i == members_.end())
-        break;
-    }
-  }
+}
+
+void PeerChannel::RemoveMember(ChannelMember* member) {
+  assert(!member->connected());
+  members_.erase(member->id());
+  MemberList failures;
+  BroadcastChangedState(*member, &failures);
+  HandleDeliveryFailures(&failures);
+  delete member;
   printf("Total connected: %s\n", size_t2str(members_.size()).c_str());
 }
 
 void PeerChannel::CheckForTimeout() {
+  MemberList timed_out;
   for (Members::iterator i = members_.begin(); i != members_.end(); ++i) {
+    if (i->second->TimedOut())
+      timed_out.push_back(i->second);
+  }
+  for (MemberList::iterator i = timed_out.begin(); i != timed_out.end(); ++i) {
     ChannelMember* m = (*i);
-    if (m->TimedOut()) {
-      printf("Timeout: %s\n", m->name().c_str());
-      m->set_disconnected();
-      i = members_.erase(i);
-      Members failures;
-      BroadcastChangedState(*m, &failures);
-      HandleDeliveryFailures(&failures);
-      delete m;
-      if (i == members_.end())
-        break;
-    }
+    printf("Timeout: %s\n", m->name().c_str());
+    m->set_disconnected();
+    RemoveMember(m);
   }
 }
 
 void PeerChannel::DeleteAll() {
   for (Members::iterator i = members_.begin(); i != members_.end(); ++i)
-    delete (*i);
+    delete i->second;
   members_.clear();
 }
 
 void PeerChannel::BroadcastChangedState(const ChannelMember& member,
-                                        Members* delivery_failures) {
+                                        MemberList* delivery_failures) {
   // This function should be called prior to DataSocket::Close().
   assert(delivery_failures);
 
@@ -318,24 +315,23 @@ void PeerChannel::BroadcastChangedState(const ChannelMember& member,
   }
 
   Members::iterator i = members_.begin();
-  for (; i != members_.end(); ++i) {
-    if (&member != (*i)) {
-      if (!(*i)->NotifyOfOtherMember(member)) {
-        (*i)->set_disconnected();
-        delivery_failures->push_back(*i);
-        i = members_.erase(i);
-        if (i == members_.end())
-          break;
-      }
+  while (i != members_.end()) {
+    ChannelMember* other = i->second;
+    if (&member != other && !other->NotifyOfOtherMember(member)) {
+      other->set_disconnected();
+      delivery_failures->push_back(other);
+      i = members_.erase(i);
+    } else {
+      ++i;
     }
   }
 }
 
-void PeerChannel::HandleDeliveryFailures(Members* failures) {
+void PeerChannel::HandleDeliveryFailures(MemberList* failures) {
   assert(failures);
 
   while (!failures->empty()) {
-    Members::iterator i = failures->begin();
+    MemberList::iterator i = failures->begin();
     ChannelMember* member = *i;
     assert(!member->connected());
     failures->erase(i);
@@ -353,9 +349,9 @@ std::string PeerChannel::BuildResponseForNewMember(const ChannelMember& member,
   // The peer itself will always be the first entry.
   std::string response(member.GetEntry());
   for (Members::iterator i = members_.begin(); i != members_.end(); ++i) {
-    if (member.id() != (*i)->id()) {
-      assert((*i)->connected());
-      response += (*i)->GetEntry();
+    if (member.id() != i->first) {
+      assert(i->second->connected());
+      response += i->second->GetEntry();
     }
   }
 
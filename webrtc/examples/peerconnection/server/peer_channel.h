@@ -16,6 +16,7 @@
 
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class DataSocket;
@@ -50,6 +51,8 @@ class ChannelMember {
 
   void SetWaitingSocket(DataSocket* ds);
 
+  DataSocket* waiting_socket() const { return waiting_socket_; }
+
  protected:
   struct QueuedResponse {
     std::string status, content_type, extra_headers, data;
@@ -64,10 +67,12 @@ class ChannelMember {
   static int s_member_id_;
 };
 
-// Manages all currently connected peers.
+// Manages all currently connected peers.  Peers are looked up by id, so the
+// cost of handling a request does not grow with the number of peers.
 class PeerChannel {
  public:
-  typedef std::vector<ChannelMember*> Members;
+  typedef std::unordered_map<int, ChannelMember*> Members;
+  typedef std::vector<ChannelMember*> MemberList;
 
   PeerChannel() {
   }
@@ -85,6 +90,9 @@ class PeerChannel {
   // Finds a connected peer that's associated with the |ds| socket.
   ChannelMember* Lookup(DataSocket* ds) const;
 
+  // Finds a connected peer by id.
+  ChannelMember* Find(int id) const;
+
   // Checks if the request has a "peer_id" parameter and if so, looks up the
   // peer for which the request is targeted at.
   ChannelMember* IsTargetedRequest(const DataSocket* ds) const;
@@ -101,13 +109,16 @@ class PeerChannel {
   // connection went dead).
   void OnClosing(DataSocket* ds);
 
+  // Removes a member that has signed out and lets the others know.
+  void RemoveMember(ChannelMember* member);
+
   void CheckForTimeout();
 
  protected:
   void DeleteAll();
   void BroadcastChangedState(const ChannelMember& member,
-                             Members* delivery_failures);
-  void HandleDeliveryFailures(Members* failures);
+                             MemberList* delivery_failures);
+  void HandleDeliveryFailures(MemberList* failures);
 
   // Builds a simple list of "name,id\n" entries for each member.
   std::string BuildResponseForNewMember(const ChannelMember& member,
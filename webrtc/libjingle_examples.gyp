@@ -64,6 +64,17 @@
       # TODO(ronghuawu): crbug.com/167187 fix size_t to int truncations.
       'msvs_disabled_warnings': [ 4309, ],
     }, # target peerconnection_server
+    {
+      'target_name': 'peerconnection_load_generator',
+      'type': 'executable',
+      'sources': [
+        'examples/peerconnection/server/load_generator.cc',
+      ],
+      'dependencies': [
+        '<(webrtc_root)/common.gyp:webrtc_common',
+        '../talk/libjingle.gyp:libjingle',
+      ],
+    }, # target peerconnection_load_generator
   ],
   'conditions': [
     ['OS=="linux" or OS=="win"', {
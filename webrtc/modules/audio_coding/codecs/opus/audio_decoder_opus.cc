@@ -15,9 +15,19 @@
 namespace webrtc {
 
 AudioDecoderOpus::AudioDecoderOpus(size_t num_channels)
+    : AudioDecoderOpus(num_channels, 0) {}
+
+AudioDecoderOpus::AudioDecoderOpus(size_t num_channels,
+                                   int channel_mapping_family)
     : channels_(num_channels) {
-  RTC_DCHECK(num_channels == 1 || num_channels == 2);
-  WebRtcOpus_DecoderCreate(&dec_state_, static_cast<int>(channels_));
+  if (channel_mapping_family == 0) {
+    RTC_DCHECK(num_channels == 1 || num_channels == 2);
+    WebRtcOpus_DecoderCreate(&dec_state_, static_cast<int>(channels_));
+  } else {
+    RTC_CHECK_EQ(0, WebRtcOpus_MultistreamDecoderCreate(
+                        &dec_state_, static_cast<int>(channels_),
+                        channel_mapping_family));
+  }
   WebRtcOpus_DecoderInit(dec_state_);
 }
 
@@ -82,6 +92,10 @@ int AudioDecoderOpus::PacketDurationRedundant(const uint8_t* encoded,
 
 bool AudioDecoderOpus::PacketHasFec(const uint8_t* encoded,
                                     size_t encoded_len) const {
+  // Only the first stream of a multistream packet could be parsed, so its
+  // FEC is not used.
+  if (WebRtcOpus_DecoderIsMultistream(dec_state_))
+    return false;
   int fec;
   fec = WebRtcOpus_PacketHasFec(encoded, encoded_len);
   return (fec == 1);
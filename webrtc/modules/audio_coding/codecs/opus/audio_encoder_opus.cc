@@ -34,6 +34,15 @@ AudioEncoderOpus::Config CreateConfig(const CodecInst& codec_inst) {
   return config;
 }
 
+// Ambisonics have (1 + order)^2 channels, optionally plus a stereo pair.
+bool IsAmbisonicChannelCount(int num_channels) {
+  for (int n = 1; n * n <= num_channels; ++n) {
+    if (n * n == num_channels || n * n + 2 == num_channels)
+      return true;
+  }
+  return false;
+}
+
 // Optimize the loss rate to configure Opus. Basically, optimized loss rate is
 // the input loss rate rounded down to various levels, because a robustly good
 // audio quality is achieved by lowering the packet loss down.
@@ -79,8 +88,23 @@ double OptimizePacketLossRate(double new_loss_rate, double old_loss_rate) {
 bool AudioEncoderOpus::Config::IsOk() const {
   if (frame_size_ms <= 0 || frame_size_ms % 10 != 0)
     return false;
-  if (num_channels != 1 && num_channels != 2)
-    return false;
+  switch (channel_mapping_family) {
+    case 0:
+      if (num_channels != 1 && num_channels != 2)
+        return false;
+      break;
+    case kWebRtcOpusMappingFamilySurround:
+      if (num_channels < 1 || num_channels > kMaxChannels || dtx_enabled)
+        return false;
+      break;
+    case kWebRtcOpusMappingFamilyAmbisonics:
+      if (num_channels > kMaxChannels ||
+          !IsAmbisonicChannelCount(num_channels) || dtx_enabled)
+        return false;
+      break;
+    default:
+      return false;
+  }
   if (bitrate_bps < kMinBitrateBps || bitrate_bps > kMaxBitrateBps)
     return false;
   if (complexity < 0 || complexity > 10)
@@ -232,8 +256,14 @@ bool AudioEncoderOpus::RecreateEncoderInstance(const Config& config) {
     RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
   input_buffer_.clear();
   input_buffer_.reserve(Num10msFramesPerPacket() * SamplesPer10msFrame());
-  RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, config.num_channels,
-                                           config.application));
+  if (config.channel_mapping_family == 0) {
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, config.num_channels,
+                                             config.application));
+  } else {
+    RTC_CHECK_EQ(0, WebRtcOpus_MultistreamEncoderCreate(
+                        &inst_, config.num_channels,
+                        config.channel_mapping_family, config.application));
+  }
   RTC_CHECK_EQ(0, WebRtcOpus_SetBitRate(inst_, config.bitrate_bps));
   if (config.fec_enabled) {
     RTC_CHECK_EQ(0, WebRtcOpus_EnableFec(inst_));
@@ -149,4 +149,19 @@ TEST_F(AudioEncoderOpusTest, PacketLossRateOptimized) {
   // clang-format on
 }
 
+TEST(AudioEncoderOpusConfigTest, ChannelMappingFamilyIsExplicit) {
+  AudioEncoderOpus::Config config;
+  config.num_channels = 4;
+  // Without a mapping family, only mono and stereo are valid.
+  EXPECT_FALSE(config.IsOk());
+  // Four channels are quadraphonic in the surround family...
+  config.channel_mapping_family = kWebRtcOpusMappingFamilySurround;
+  EXPECT_TRUE(config.IsOk());
+  // ...and first order ambisonics in the ambisonics family.
+  config.channel_mapping_family = kWebRtcOpusMappingFamilyAmbisonics;
+  EXPECT_TRUE(config.IsOk());
+  config.num_channels = 5;
+  EXPECT_FALSE(config.IsOk());
+}
+
 }  // namespace webrtc
@@ -19,6 +19,9 @@ namespace webrtc {
 class AudioDecoderOpus final : public AudioDecoder {
  public:
   explicit AudioDecoderOpus(size_t num_channels);
+  // Decodes the multistream packets of the channel mapping family
+  // |channel_mapping_family|, or single stream packets if it is 0.
+  AudioDecoderOpus(size_t num_channels, int channel_mapping_family);
   ~AudioDecoderOpus() override;
 
   void Reset() override;
@@ -28,10 +28,19 @@ class AudioEncoderOpus final : public AudioEncoder {
     kAudio = 1,
   };
 
+  // The most channels of a multistream encoder, 7.1 surround.
+  static const int kMaxChannels = 8;
+
   struct Config {
     bool IsOk() const;
     int frame_size_ms = 20;
     int num_channels = 1;
+    // 0 codes one mono or stereo stream. kWebRtcOpusMappingFamilySurround and
+    // kWebRtcOpusMappingFamilyAmbisonics code up to kMaxChannels channels in
+    // one multistream packet, without DTX. The family must be set explicitly,
+    // as e.g. 4 channels are quadraphonic in one and ambisonics in the other;
+    // a CodecInst always gives family 0.
+    int channel_mapping_family = 0;
     int payload_type = 120;
     ApplicationMode application = kVoip;
     int bitrate_bps = 64000;
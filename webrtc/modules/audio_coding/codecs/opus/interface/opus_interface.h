@@ -23,6 +23,17 @@ extern "C" {
 typedef struct WebRtcOpusEncInst OpusEncInst;
 typedef struct WebRtcOpusDecInst OpusDecInst;
 
+// Channel mapping families of multistream Opus, from RFC 7845 section 5.1.1.
+// Family 0 is the single mono or stereo stream of WebRtcOpus_EncoderCreate()
+// and WebRtcOpus_DecoderCreate().
+enum {
+  // Vorbis channel order, 1 to 8 channels, e.g. 6 for 5.1 and 8 for 7.1.
+  kWebRtcOpusMappingFamilySurround = 1,
+  // Ambisonics in ACN order, (1 + order)^2 channels, optionally followed by a
+  // non-diegetic stereo pair.
+  kWebRtcOpusMappingFamilyAmbisonics = 2
+};
+
 /****************************************************************************
  * WebRtcOpus_EncoderCreate(...)
  *
@@ -46,6 +57,35 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
                                  int32_t channels,
                                  int32_t application);
 
+/****************************************************************************
+ * WebRtcOpus_MultistreamEncoderCreate(...)
+ *
+ * This function creates a multistream Opus encoder, coding |channels| in the
+ * streams given by the channel mapping family. The other encoder functions
+ * apply to it as well, except DTX, which is only supported for a single
+ * stream.
+ *
+ * Input:
+ *      - channels           : number of channels.
+ *      - mapping_family     : kWebRtcOpusMappingFamilySurround or
+ *                             kWebRtcOpusMappingFamilyAmbisonics.
+ *      - application        : 0 - VOIP applications.
+ *                                 Favor speech intelligibility.
+ *                             1 - Audio applications.
+ *                                 Favor faithfulness to the original input.
+ *
+ * Output:
+ *      - inst               : a pointer to Encoder context that is created
+ *                             if success.
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_MultistreamEncoderCreate(OpusEncInst** inst,
+                                            int channels,
+                                            int mapping_family,
+                                            int32_t application);
+
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst);
 
 /****************************************************************************
@@ -196,8 +236,31 @@ int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst);
 int16_t WebRtcOpus_SetComplexity(OpusEncInst* inst, int32_t complexity);
 
 int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, int channels);
+
+/****************************************************************************
+ * WebRtcOpus_MultistreamDecoderCreate(...)
+ *
+ * This function creates a decoder for the packets of a multistream encoder
+ * with the same |channels| and |mapping_family|.
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_MultistreamDecoderCreate(OpusDecInst** inst,
+                                            int channels,
+                                            int mapping_family);
+
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst);
 
+/****************************************************************************
+ * WebRtcOpus_DecoderIsMultistream(...)
+ *
+ * This function returns 1 if the decoder was created by
+ * WebRtcOpus_MultistreamDecoderCreate(), and 0 otherwise. The packets of a
+ * multistream decoder can't be parsed by WebRtcOpus_PacketHasFec().
+ */
+int WebRtcOpus_DecoderIsMultistream(OpusDecInst* inst);
+
 /****************************************************************************
  * WebRtcOpus_DecoderChannels(...)
  *
@@ -12,14 +12,18 @@
 #define WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_INST_H_
 
 #include "opus.h"
+#include "opus_multistream.h"
 
+// Exactly one of the single stream and the multistream states is created.
 struct WebRtcOpusEncInst {
   OpusEncoder* encoder;
+  OpusMSEncoder* multistream_encoder;
   int in_dtx_mode;
 };
 
 struct WebRtcOpusDecInst {
   OpusDecoder* decoder;
+  OpusMSDecoder* multistream_decoder;
   int prev_decoded_samples;
   int channels;
   int in_dtx_mode;
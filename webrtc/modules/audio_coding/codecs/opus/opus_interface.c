@@ -29,8 +29,107 @@ enum {
 
   /* Default frame size, 20 ms @ 48 kHz, in samples (for one channel). */
   kWebRtcOpusDefaultFrameSize = 960,
+
+  /* Maximum number of channels of a multistream state. */
+  kWebRtcOpusMaxMultistreamChannels = 255,
+};
+
+/* The single stream and the multistream states take the same requests. */
+#define ENCODER_CTL(inst, vargs)                                  \
+    ((inst)->encoder ?                                            \
+     opus_encoder_ctl((inst)->encoder, vargs) :                   \
+     opus_multistream_encoder_ctl((inst)->multistream_encoder, vargs))
+
+#define DECODER_CTL(inst, vargs)                                  \
+    ((inst)->decoder ?                                            \
+     opus_decoder_ctl((inst)->decoder, vargs) :                   \
+     opus_multistream_decoder_ctl((inst)->multistream_decoder, vargs))
+
+/* Streams, coupled streams and the mapping of the channels to them, of the
+ * Vorbis channel orders. From RFC 7845 section 5.1.1.2. */
+static const struct {
+  int streams;
+  int coupled_streams;
+  unsigned char mapping[8];
+} kVorbisLayouts[8] = {
+  {1, 0, {0}},                       /* Mono. */
+  {1, 1, {0, 1}},                    /* Stereo. */
+  {2, 1, {0, 2, 1}},                 /* Linear surround. */
+  {2, 2, {0, 1, 2, 3}},              /* Quadraphonic. */
+  {3, 2, {0, 4, 1, 2, 3}},           /* 5.0 surround. */
+  {4, 2, {0, 4, 1, 2, 3, 5}},        /* 5.1 surround. */
+  {4, 3, {0, 4, 1, 2, 3, 5, 6}},     /* 6.1 surround. */
+  {5, 3, {0, 6, 1, 2, 3, 4, 5, 7}},  /* 7.1 surround. */
 };
 
+/* Gets the streams, coupled streams and channel mapping of |channels| in the
+ * channel mapping family |mapping_family|. Returns 0 on success and -1 if the
+ * family doesn't define that number of channels. */
+static int16_t MultistreamLayout(int channels,
+                                 int mapping_family,
+                                 int* streams,
+                                 int* coupled_streams,
+                                 unsigned char* channel_mapping) {
+  int i;
+
+  if (channels < 1 || channels > kWebRtcOpusMaxMultistreamChannels) {
+    return -1;
+  }
+
+  switch (mapping_family) {
+    case kWebRtcOpusMappingFamilySurround: {
+      if (channels > 8) {
+        return -1;
+      }
+      *streams = kVorbisLayouts[channels - 1].streams;
+      *coupled_streams = kVorbisLayouts[channels - 1].coupled_streams;
+      memcpy(channel_mapping, kVorbisLayouts[channels - 1].mapping, channels);
+      return 0;
+    }
+    case kWebRtcOpusMappingFamilyAmbisonics: {
+      /* (1 + order)^2 channels, coded as separate mono streams, optionally
+       * followed by a non-diegetic stereo pair, coded as one coupled stream
+       * ahead of the others. */
+      int ambisonic_channels = 1;
+      int non_diegetic_channels;
+      while ((ambisonic_channels + 1) * (ambisonic_channels + 1) <= channels) {
+        ambisonic_channels++;
+      }
+      ambisonic_channels *= ambisonic_channels;
+      non_diegetic_channels = channels - ambisonic_channels;
+      if (non_diegetic_channels != 0 && non_diegetic_channels != 2) {
+        return -1;
+      }
+      *coupled_streams = non_diegetic_channels / 2;
+      *streams = ambisonic_channels + *coupled_streams;
+      for (i = 0; i < ambisonic_channels; i++) {
+        channel_mapping[i] = (unsigned char)(i + 2 * *coupled_streams);
+      }
+      for (i = 0; i < non_diegetic_channels; i++) {
+        channel_mapping[ambisonic_channels + i] = (unsigned char)i;
+      }
+      return 0;
+    }
+    default: {
+      return -1;
+    }
+  }
+}
+
+static int ApplicationMode(int32_t application) {
+  switch (application) {
+    case 0: {
+      return OPUS_APPLICATION_VOIP;
+    }
+    case 1: {
+      return OPUS_APPLICATION_AUDIO;
+    }
+    default: {
+      return -1;
+    }
+  }
+}
+
 int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
                                  int32_t channels,
                                  int32_t application) {
@@ -38,20 +137,10 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
   if (inst != NULL) {
     state = (OpusEncInst*) calloc(1, sizeof(OpusEncInst));
     if (state) {
-      int opus_app;
-      switch (application) {
-        case 0: {
-          opus_app = OPUS_APPLICATION_VOIP;
-          break;
-        }
-        case 1: {
-          opus_app = OPUS_APPLICATION_AUDIO;
-          break;
-        }
-        default: {
-          free(state);
-          return -1;
-        }
+      int opus_app = ApplicationMode(application);
+      if (opus_app == -1) {
+        free(state);
+        return -1;
       }
 
       int error;
@@ -68,9 +157,57 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
   return -1;
 }
 
+int16_t WebRtcOpus_MultistreamEncoderCreate(OpusEncInst** inst,
+                                            int channels,
+                                            int mapping_family,
+                                            int32_t application) {
+  OpusEncInst* state;
+  int opus_app = ApplicationMode(application);
+  int streams;
+  int coupled_streams;
+  unsigned char channel_mapping[kWebRtcOpusMaxMultistreamChannels];
+  int error = OPUS_BAD_ARG;
+
+  if (inst == NULL || opus_app == -1 ||
+      MultistreamLayout(channels, mapping_family, &streams, &coupled_streams,
+                        channel_mapping) != 0) {
+    return -1;
+  }
+
+  state = (OpusEncInst*) calloc(1, sizeof(OpusEncInst));
+  if (state == NULL) {
+    return -1;
+  }
+
+  if (mapping_family == kWebRtcOpusMappingFamilySurround) {
+    /* The surround encoder gives the same layout, and shares the bits
+     * between the streams by the masking across the channels. */
+    state->multistream_encoder = opus_multistream_surround_encoder_create(
+        48000, channels, mapping_family, &streams, &coupled_streams,
+        channel_mapping, opus_app, &error);
+  } else {
+    state->multistream_encoder = opus_multistream_encoder_create(
+        48000, channels, streams, coupled_streams, channel_mapping, opus_app,
+        &error);
+  }
+  if (error == OPUS_OK && state->multistream_encoder != NULL) {
+    *inst = state;
+    return 0;
+  }
+  if (state->multistream_encoder) {
+    opus_multistream_encoder_destroy(state->multistream_encoder);
+  }
+  free(state);
+  return -1;
+}
+
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   if (inst) {
-    opus_encoder_destroy(inst->encoder);
+    if (inst->encoder) {
+      opus_encoder_destroy(inst->encoder);
+    } else {
+      opus_multistream_encoder_destroy(inst->multistream_encoder);
+    }
     free(inst);
     return 0;
   } else {
@@ -89,11 +226,19 @@ int WebRtcOpus_Encode(OpusEncInst* inst,
     return -1;
   }
 
-  res = opus_encode(inst->encoder,
-                    (const opus_int16*)audio_in,
-                    (int)samples,
-                    encoded,
-                    (opus_int32)length_encoded_buffer);
+  if (inst->encoder) {
+    res = opus_encode(inst->encoder,
+                      (const opus_int16*)audio_in,
+                      (int)samples,
+                      encoded,
+                      (opus_int32)length_encoded_buffer);
+  } else {
+    res = opus_multistream_encode(inst->multistream_encoder,
+                                  (const opus_int16*)audio_in,
+                                  (int)samples,
+                                  encoded,
+                                  (opus_int32)length_encoded_buffer);
+  }
 
   if (res == 1) {
     // Indicates DTX since the packet has nothing but a header. In principle,
@@ -115,7 +260,7 @@ int WebRtcOpus_Encode(OpusEncInst* inst,
 
 int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_BITRATE(rate));
+    return ENCODER_CTL(inst, OPUS_SET_BITRATE(rate));
   } else {
     return -1;
   }
@@ -123,8 +268,7 @@ int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
 
 int16_t WebRtcOpus_SetPacketLossRate(OpusEncInst* inst, int32_t loss_rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder,
-                            OPUS_SET_PACKET_LOSS_PERC(loss_rate));
+    return ENCODER_CTL(inst, OPUS_SET_PACKET_LOSS_PERC(loss_rate));
   } else {
     return -1;
   }
@@ -147,13 +291,12 @@ int16_t WebRtcOpus_SetMaxPlaybackRate(OpusEncInst* inst, int32_t frequency_hz) {
   } else {
     set_bandwidth = OPUS_BANDWIDTH_FULLBAND;
   }
-  return opus_encoder_ctl(inst->encoder,
-                          OPUS_SET_MAX_BANDWIDTH(set_bandwidth));
+  return ENCODER_CTL(inst, OPUS_SET_MAX_BANDWIDTH(set_bandwidth));
 }
 
 int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(1));
+    return ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(1));
   } else {
     return -1;
   }
@@ -161,14 +304,15 @@ int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_DisableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(0));
+    return ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(0));
   } else {
     return -1;
   }
 }
 
 int16_t WebRtcOpus_EnableDtx(OpusEncInst* inst) {
-  if (!inst) {
+  // Only a single stream packet of one byte signals DTX.
+  if (!inst || !inst->encoder) {
     return -1;
   }
 
@@ -177,21 +321,19 @@ int16_t WebRtcOpus_EnableDtx(OpusEncInst* inst) {
   // last long during a pure silence, if the signal type is not forced.
   // TODO(minyue): Remove the signal type forcing when Opus DTX works properly
   // without it.
-  int ret = opus_encoder_ctl(inst->encoder,
-                             OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+  int ret = ENCODER_CTL(inst, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
   if (ret != OPUS_OK)
     return ret;
 
-  return opus_encoder_ctl(inst->encoder, OPUS_SET_DTX(1));
+  return ENCODER_CTL(inst, OPUS_SET_DTX(1));
 }
 
 int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst) {
   if (inst) {
-    int ret = opus_encoder_ctl(inst->encoder,
-                               OPUS_SET_SIGNAL(OPUS_AUTO));
+    int ret = ENCODER_CTL(inst, OPUS_SET_SIGNAL(OPUS_AUTO));
     if (ret != OPUS_OK)
       return ret;
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_DTX(0));
+    return ENCODER_CTL(inst, OPUS_SET_DTX(0));
   } else {
     return -1;
   }
@@ -199,7 +341,7 @@ int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_SetComplexity(OpusEncInst* inst, int32_t complexity) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_COMPLEXITY(complexity));
+    return ENCODER_CTL(inst, OPUS_SET_COMPLEXITY(complexity));
   } else {
     return -1;
   }
@@ -236,9 +378,54 @@ int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, int channels) {
   return -1;
 }
 
+int16_t WebRtcOpus_MultistreamDecoderCreate(OpusDecInst** inst,
+                                            int channels,
+                                            int mapping_family) {
+  OpusDecInst* state;
+  int streams;
+  int coupled_streams;
+  unsigned char channel_mapping[kWebRtcOpusMaxMultistreamChannels];
+  int error;
+
+  if (inst == NULL ||
+      MultistreamLayout(channels, mapping_family, &streams, &coupled_streams,
+                        channel_mapping) != 0) {
+    return -1;
+  }
+
+  state = (OpusDecInst*) calloc(1, sizeof(OpusDecInst));
+  if (state == NULL) {
+    return -1;
+  }
+
+  state->multistream_decoder = opus_multistream_decoder_create(
+      48000, channels, streams, coupled_streams, channel_mapping, &error);
+  if (error == OPUS_OK && state->multistream_decoder != NULL) {
+    state->channels = channels;
+    state->prev_decoded_samples = kWebRtcOpusDefaultFrameSize;
+    state->in_dtx_mode = 0;
+    *inst = state;
+    return 0;
+  }
+
+  if (state->multistream_decoder) {
+    opus_multistream_decoder_destroy(state->multistream_decoder);
+  }
+  free(state);
+  return -1;
+}
+
+int WebRtcOpus_DecoderIsMultistream(OpusDecInst* inst) {
+  return inst->multistream_decoder != NULL;
+}
+
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst) {
   if (inst) {
-    opus_decoder_destroy(inst->decoder);
+    if (inst->decoder) {
+      opus_decoder_destroy(inst->decoder);
+    } else {
+      opus_multistream_decoder_destroy(inst->multistream_decoder);
+    }
     free(inst);
     return 0;
   } else {
@@ -251,7 +438,7 @@ int WebRtcOpus_DecoderChannels(OpusDecInst* inst) {
 }
 
 void WebRtcOpus_DecoderInit(OpusDecInst* inst) {
-  opus_decoder_ctl(inst->decoder, OPUS_RESET_STATE);
+  DECODER_CTL(inst, OPUS_RESET_STATE);
   inst->in_dtx_mode = 0;
 }
 
@@ -276,8 +463,16 @@ static int16_t DetermineAudioType(OpusDecInst* inst, size_t encoded_bytes) {
 static int DecodeNative(OpusDecInst* inst, const uint8_t* encoded,
                         size_t encoded_bytes, int frame_size,
                         int16_t* decoded, int16_t* audio_type, int decode_fec) {
-  int res = opus_decode(inst->decoder, encoded, (opus_int32)encoded_bytes,
-                        (opus_int16*)decoded, frame_size, decode_fec);
+  int res;
+  if (inst->decoder) {
+    res = opus_decode(inst->decoder, encoded, (opus_int32)encoded_bytes,
+                      (opus_int16*)decoded, frame_size, decode_fec);
+  } else {
+    res = opus_multistream_decode(inst->multistream_decoder, encoded,
+                                  (opus_int32)encoded_bytes,
+                                  (opus_int16*)decoded, frame_size,
+                                  decode_fec);
+  }
 
   if (res <= 0)
     return -1;
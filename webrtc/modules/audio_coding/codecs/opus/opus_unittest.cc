@@ -7,6 +7,10 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
 #include <string>
 
 #include "testing/gtest/include/gtest/gtest.h"
@@ -622,5 +626,180 @@ INSTANTIATE_TEST_CASE_P(VariousMode,
                         OpusTest,
                         Combine(Values(1, 2), Values(0, 1)));
 
+namespace {
+
+// Fills |samples_per_channel| interleaved samples of |channels| channels with
+// a different tone in each channel, continuing from |*phase|.
+void GenerateTones(int channels,
+                   size_t samples_per_channel,
+                   size_t* phase,
+                   int16_t* audio) {
+  for (size_t i = 0; i < samples_per_channel; ++i, ++*phase) {
+    for (int c = 0; c < channels; ++c) {
+      audio[i * channels + c] = static_cast<int16_t>(
+          8000 * sin(2 * M_PI * (200 + 100 * c) * *phase / 48000.0));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(OpusMultistreamTest, CreateFailsForUndefinedLayouts) {
+  WebRtcOpusEncInst* encoder = NULL;
+  WebRtcOpusDecInst* decoder = NULL;
+  // Surround layouts have at most 8 channels.
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(
+                    &encoder, 9, kWebRtcOpusMappingFamilySurround, 1));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamDecoderCreate(
+                    &decoder, 9, kWebRtcOpusMappingFamilySurround));
+  // Ambisonics need a square number of channels, optionally plus two.
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(
+                    &encoder, 5, kWebRtcOpusMappingFamilyAmbisonics, 1));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamDecoderCreate(
+                    &decoder, 7, kWebRtcOpusMappingFamilyAmbisonics));
+  // Family 0 is not multistream.
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(&encoder, 2, 0, 1));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamDecoderCreate(&decoder, 2, 0));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(
+                    NULL, 6, kWebRtcOpusMappingFamilySurround, 1));
+}
+
+class OpusMultistreamTest
+    : public TestWithParam<::testing::tuple<int, int>> {
+ protected:
+  OpusMultistreamTest()
+      : channels_(::testing::get<0>(GetParam())),
+        mapping_family_(::testing::get<1>(GetParam())) {}
+
+  const int channels_;
+  const int mapping_family_;
+};
+
+TEST_P(OpusMultistreamTest, EncodeDecode) {
+  WebRtcOpusEncInst* encoder = NULL;
+  WebRtcOpusDecInst* decoder = NULL;
+  ASSERT_EQ(0, WebRtcOpus_MultistreamEncoderCreate(&encoder, channels_,
+                                                   mapping_family_, 1));
+  ASSERT_EQ(0, WebRtcOpus_MultistreamDecoderCreate(&decoder, channels_,
+                                                   mapping_family_));
+  EXPECT_EQ(channels_, WebRtcOpus_DecoderChannels(decoder));
+  EXPECT_EQ(1, WebRtcOpus_DecoderIsMultistream(decoder));
+  EXPECT_EQ(0, WebRtcOpus_SetBitRate(encoder, 64000 * channels_));
+  EXPECT_EQ(0, WebRtcOpus_EnableFec(encoder));
+  // A single stream packet of one byte signals DTX, so there is no DTX.
+  EXPECT_EQ(-1, WebRtcOpus_EnableDtx(encoder));
+  EXPECT_EQ(0, WebRtcOpus_DisableDtx(encoder));
+
+  rtc::scoped_ptr<int16_t[]> input(
+      new int16_t[kOpus20msFrameSamples * channels_]);
+  rtc::scoped_ptr<int16_t[]> output(
+      new int16_t[kOpus20msFrameSamples * channels_]);
+  uint8_t bitstream[kMaxBytes * 8];
+  size_t phase = 0;
+  int16_t audio_type;
+  for (int packet = 0; packet < 10; ++packet) {
+    GenerateTones(channels_, kOpus20msFrameSamples, &phase, input.get());
+    const int encoded_bytes = WebRtcOpus_Encode(
+        encoder, input.get(), kOpus20msFrameSamples, sizeof(bitstream),
+        bitstream);
+    ASSERT_GT(encoded_bytes, 1);
+    EXPECT_EQ(kOpus20msFrameSamples,
+              static_cast<size_t>(WebRtcOpus_DurationEst(
+                  decoder, bitstream, static_cast<size_t>(encoded_bytes))));
+    EXPECT_EQ(kOpus20msFrameSamples,
+              static_cast<size_t>(WebRtcOpus_Decode(
+                  decoder, bitstream, static_cast<size_t>(encoded_bytes),
+                  output.get(), &audio_type)));
+    EXPECT_EQ(0, audio_type);
+  }
+  EXPECT_EQ(kOpus20msFrameSamples,
+            static_cast<size_t>(WebRtcOpus_DecodePlc(decoder, output.get(),
+                                                     1)));
+  WebRtcOpus_DecoderInit(decoder);
+
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(encoder));
+  EXPECT_EQ(0, WebRtcOpus_DecoderFree(decoder));
+}
+
+INSTANTIATE_TEST_CASE_P(
+    VariousLayouts,
+    OpusMultistreamTest,
+    Values(::testing::make_tuple(4, kWebRtcOpusMappingFamilySurround),
+           ::testing::make_tuple(6, kWebRtcOpusMappingFamilySurround),
+           ::testing::make_tuple(8, kWebRtcOpusMappingFamilySurround),
+           ::testing::make_tuple(4, kWebRtcOpusMappingFamilyAmbisonics),
+           ::testing::make_tuple(6, kWebRtcOpusMappingFamilyAmbisonics)));
+
+// Prints the time to encode and decode 5.1 surround as one multistream, and
+// as three independent stereo streams of the same total bitrate.
+TEST(OpusMultistreamTest, DISABLED_MultistreamVersusStereoStreamsSpeed) {
+  const int kChannels = 6;
+  const int kStereoStreams = kChannels / 2;
+  const int kBitRate = 64000 * kChannels;
+  const int kPackets = 2500;  // 50 seconds.
+  WebRtcOpusEncInst* multistream_encoder = NULL;
+  WebRtcOpusDecInst* multistream_decoder = NULL;
+  WebRtcOpusEncInst* stereo_encoders[kStereoStreams];
+  WebRtcOpusDecInst* stereo_decoders[kStereoStreams];
+  ASSERT_EQ(0, WebRtcOpus_MultistreamEncoderCreate(
+                   &multistream_encoder, kChannels,
+                   kWebRtcOpusMappingFamilySurround, 1));
+  ASSERT_EQ(0, WebRtcOpus_MultistreamDecoderCreate(
+                   &multistream_decoder, kChannels,
+                   kWebRtcOpusMappingFamilySurround));
+  EXPECT_EQ(0, WebRtcOpus_SetBitRate(multistream_encoder, kBitRate));
+  for (int n = 0; n < kStereoStreams; ++n) {
+    ASSERT_EQ(0, WebRtcOpus_EncoderCreate(&stereo_encoders[n], 2, 1));
+    ASSERT_EQ(0, WebRtcOpus_DecoderCreate(&stereo_decoders[n], 2));
+    EXPECT_EQ(0, WebRtcOpus_SetBitRate(stereo_encoders[n],
+                                       kBitRate / kStereoStreams));
+  }
+
+  int16_t input[kOpus20msFrameSamples * kChannels];
+  int16_t stereo_input[kOpus20msFrameSamples * 2];
+  int16_t output[kOpus20msFrameSamples * kChannels];
+  uint8_t bitstream[kMaxBytes * 8];
+  size_t phase = 0;
+  int16_t audio_type;
+  clock_t multistream_clocks = 0;
+  clock_t stereo_clocks = 0;
+  for (int packet = 0; packet < kPackets; ++packet) {
+    GenerateTones(kChannels, kOpus20msFrameSamples, &phase, input);
+
+    clock_t clocks = clock();
+    int encoded_bytes = WebRtcOpus_Encode(multistream_encoder, input,
+                                          kOpus20msFrameSamples,
+                                          sizeof(bitstream), bitstream);
+    WebRtcOpus_Decode(multistream_decoder, bitstream,
+                      static_cast<size_t>(encoded_bytes), output, &audio_type);
+    multistream_clocks += clock() - clocks;
+
+    for (int n = 0; n < kStereoStreams; ++n) {
+      for (size_t i = 0; i < kOpus20msFrameSamples; ++i) {
+        stereo_input[2 * i] = input[i * kChannels + 2 * n];
+        stereo_input[2 * i + 1] = input[i * kChannels + 2 * n + 1];
+      }
+      clocks = clock();
+      encoded_bytes = WebRtcOpus_Encode(stereo_encoders[n], stereo_input,
+                                        kOpus20msFrameSamples,
+                                        sizeof(bitstream), bitstream);
+      WebRtcOpus_Decode(stereo_decoders[n], bitstream,
+                        static_cast<size_t>(encoded_bytes), output,
+                        &audio_type);
+      stereo_clocks += clock() - clocks;
+    }
+  }
+  printf("5.1 as one multistream: %.1f ms, as %d stereo streams: %.1f ms\n",
+         1000.0 * multistream_clocks / CLOCKS_PER_SEC, kStereoStreams,
+         1000.0 * stereo_clocks / CLOCKS_PER_SEC);
+
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(multistream_encoder));
+  EXPECT_EQ(0, WebRtcOpus_DecoderFree(multistream_decoder));
+  for (int n = 0; n < kStereoStreams; ++n) {
+    EXPECT_EQ(0, WebRtcOpus_EncoderFree(stereo_encoders[n]));
+    EXPECT_EQ(0, WebRtcOpus_DecoderFree(stereo_decoders[n]));
+  }
+}
+
 
 }  // namespace webrtc
@@ -60,7 +60,7 @@ bool IsOpusRateValid(int rate) {
 }  // namespace
 
 // Not yet used payload-types.
-// 83,  82,  81, 80, 79,  78,  77,  76,  75,  74,  73,  72,  71,  70,  69, 68,
+// 80, 79,  78,  77,  76,  75,  74,  73,  72,  71,  70,  69, 68,
 // 67, 66, 65
 
 const CodecInst ACMCodecDB::database_[] = {
@@ -98,6 +98,12 @@ const CodecInst ACMCodecDB::database_[] = {
   // Opus internally supports 48, 24, 16, 12, 8 kHz.
   // Mono and stereo.
   {120, "opus", 48000, 960, 2, 64000},
+  // Multistream, receive only. "multiopus" is 5.1 or 7.1 surround in Vorbis
+  // channel order (mapping family 1), "opus-ambisonics" is first order
+  // ambisonics (mapping family 2).
+  {83, "multiopus", 48000, 960, 6, 64000},
+  {82, "multiopus", 48000, 960, 8, 64000},
+  {81, "opus-ambisonics", 48000, 960, 4, 64000},
 #endif
   // Comfort noise for four different sampling frequencies.
   {13, "CN", 8000, 240, 1, 0},
@@ -154,6 +160,10 @@ const ACMCodecDB::CodecSettings ACMCodecDB::codec_settings_[] = {
     // but it doesn't help us to use them.
     // Mono and stereo.
     {4, {480, 960, 1920, 2880}, 0, 2},
+    // Multistream, receive only.
+    {4, {480, 960, 1920, 2880}, 0, 0},
+    {4, {480, 960, 1920, 2880}, 0, 0},
+    {4, {480, 960, 1920, 2880}, 0, 0},
 #endif
     // Comfort noise for three different sampling frequencies.
     {1, {240}, 240, 1},
@@ -205,6 +215,10 @@ const NetEqDecoder ACMCodecDB::neteq_decoders_[] = {
 #ifdef WEBRTC_CODEC_OPUS
     // Mono and stereo.
     kDecoderOpus,
+    // Multistream.
+    kDecoderOpus_6ch,
+    kDecoderOpus_8ch,
+    kDecoderOpusAmbisonics_4ch,
 #endif
     // Comfort noise for three different sampling frequencies.
     kDecoderCNGnb,
@@ -63,6 +63,10 @@ class ACMCodecDB {
 #ifdef WEBRTC_CODEC_OPUS
     // Mono and stereo
     , kOpus
+    // Multistream, receive only. The entry gives the channel mapping family.
+    , kMultiOpus_6ch
+    , kMultiOpus_8ch
+    , kOpusAmbisonics_4ch
 #endif
     , kCNNB
     , kCNWB
@@ -98,6 +102,10 @@ class ACMCodecDB {
 #ifndef WEBRTC_CODEC_OPUS
   // Mono and stereo
   enum {kOpus = -1};
+  // Multistream
+  enum {kMultiOpus_6ch = -1};
+  enum {kMultiOpus_8ch = -1};
+  enum {kOpusAmbisonics_4ch = -1};
 #endif
 #ifndef WEBRTC_CODEC_RED
   enum {kRED = -1};
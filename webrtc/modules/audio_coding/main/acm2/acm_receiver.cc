@@ -208,6 +208,10 @@ int AcmReceiver::LeastRequiredDelayMs() const {
   return neteq_->LeastRequiredDelayMs();
 }
 
+int AcmReceiver::CurrentDelayMs() const {
+  return neteq_->CurrentDelayMs();
+}
+
 int AcmReceiver::current_sample_rate_hz() const {
   CriticalSectionScoped lock(crit_sect_.get());
   return current_sample_rate_hz_;
@@ -152,6 +152,11 @@ class AcmReceiver {
   //
   int LeastRequiredDelayMs() const;
 
+  //
+  // Returns the amount of audio, in milliseconds, buffered by NetEq.
+  //
+  int CurrentDelayMs() const;
+
   //
   // Sets an initial delay of |delay_ms| milliseconds. This introduces a playout
   // delay. Silence (zero signal) is played out until equivalent of |delay_ms|
@@ -37,6 +37,39 @@ bool CodecsEqual(const CodecInst& codec_a, const CodecInst& codec_b) {
     return true;
 }
 
+// Decodes each packet to 10 ms of 48 kHz audio with a constant level per
+// channel, as multistream Opus would for 5.1 surround.
+class FakeMultichannelDecoder : public AudioDecoder {
+ public:
+  static const size_t kNumChannels = 6;
+  static const size_t kSamplesPerChannel = 480;
+
+  void Reset() override {}
+  size_t Channels() const override { return kNumChannels; }
+  int PacketDuration(const uint8_t* encoded,
+                     size_t encoded_len) const override {
+    return kSamplesPerChannel;
+  }
+
+  static int16_t Level(size_t channel) {
+    return static_cast<int16_t>(1000 * (channel + 1));
+  }
+
+ protected:
+  int DecodeInternal(const uint8_t* encoded,
+                     size_t encoded_len,
+                     int sample_rate_hz,
+                     int16_t* decoded,
+                     SpeechType* speech_type) override {
+    for (size_t i = 0; i < kSamplesPerChannel; ++i) {
+      for (size_t channel = 0; channel < kNumChannels; ++channel)
+        decoded[i * kNumChannels + channel] = Level(channel);
+    }
+    *speech_type = kSpeech;
+    return static_cast<int>(kSamplesPerChannel * kNumChannels);
+  }
+};
+
 }  // namespace
 
 class AcmReceiverTestOldApi : public AudioPacketizationCallback,
@@ -365,6 +398,50 @@ TEST_F(AcmReceiverTestOldApi,
   }
 }
 
+#ifdef WEBRTC_CODEC_OPUS
+#define IF_OPUS(x) x
+#else
+#define IF_OPUS(x) DISABLED_##x
+#endif
+
+// Checks that all channels of a multistream Opus codec are played out, also
+// when resampled.
+TEST_F(AcmReceiverTestOldApi,
+       DISABLED_ON_ANDROID(IF_OPUS(PlaysOutMultistreamOpus))) {
+  const int id = ACMCodecDB::kMultiOpus_6ch;
+  ASSERT_EQ(static_cast<int>(FakeMultichannelDecoder::kNumChannels),
+            codecs_[id].channels);
+  FakeMultichannelDecoder decoder;
+  ASSERT_EQ(0, receiver_->AddCodec(id, codecs_[id].pltype,
+                                   codecs_[id].channels, codecs_[id].plfreq,
+                                   &decoder));
+
+  const uint8_t kPayload[10] = {0};
+  const int kOutSampleRateHz = 16000;
+  rtp_header_.header.payloadType = codecs_[id].pltype;
+  AudioFrame frame;
+  for (int n = 0; n < 20; ++n) {
+    ASSERT_EQ(0, receiver_->InsertPacket(rtp_header_, kPayload,
+                                         sizeof(kPayload)));
+    rtp_header_.header.sequenceNumber++;
+    rtp_header_.header.timestamp += FakeMultichannelDecoder::kSamplesPerChannel;
+    ASSERT_EQ(0, receiver_->GetAudio(kOutSampleRateHz, &frame));
+    EXPECT_EQ(codecs_[id].channels, frame.num_channels_);
+    EXPECT_EQ(static_cast<size_t>(kOutSampleRateHz / 100),
+              frame.samples_per_channel_);
+  }
+  EXPECT_EQ(AudioFrame::kNormalSpeech, frame.speech_type_);
+  for (size_t i = 0; i < frame.samples_per_channel_; ++i) {
+    for (size_t channel = 0; channel < FakeMultichannelDecoder::kNumChannels;
+         ++channel) {
+      EXPECT_NEAR(FakeMultichannelDecoder::Level(channel),
+                  frame.data_[i * FakeMultichannelDecoder::kNumChannels +
+                              channel],
+                  10);
+    }
+  }
+}
+
 }  // namespace acm2
 
 }  // namespace webrtc
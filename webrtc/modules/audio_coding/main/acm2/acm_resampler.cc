@@ -19,6 +19,11 @@
 namespace webrtc {
 namespace acm2 {
 
+namespace {
+// 10 ms of one channel at 48 kHz.
+const size_t kMaxSamplesPerChannel10Ms = 480;
+}  // namespace
+
 ACMResampler::ACMResampler() {
 }
 
@@ -42,6 +47,12 @@ int ACMResampler::Resample10Msec(const int16_t* in_audio,
     return static_cast<int>(in_length / num_audio_channels);
   }
 
+  if (num_audio_channels > 2) {
+    return ResamplePerChannel(in_audio, in_freq_hz, out_freq_hz,
+                              num_audio_channels, out_capacity_samples,
+                              out_audio);
+  }
+
   if (resampler_.InitializeIfNeeded(in_freq_hz, out_freq_hz,
                                     num_audio_channels) != 0) {
     LOG_FERR3(LS_ERROR, InitializeIfNeeded, in_freq_hz, out_freq_hz,
@@ -64,5 +75,50 @@ int ACMResampler::Resample10Msec(const int16_t* in_audio,
   return out_length / num_audio_channels;
 }
 
+int ACMResampler::ResamplePerChannel(const int16_t* in_audio,
+                                     int in_freq_hz,
+                                     int out_freq_hz,
+                                     int num_audio_channels,
+                                     size_t out_capacity_samples,
+                                     int16_t* out_audio) {
+  const size_t in_length = static_cast<size_t>(in_freq_hz / 100);
+  const size_t out_length = static_cast<size_t>(out_freq_hz / 100);
+  if (in_length > kMaxSamplesPerChannel10Ms ||
+      out_length > kMaxSamplesPerChannel10Ms ||
+      out_capacity_samples < out_length * num_audio_channels) {
+    LOG_FERR3(LS_ERROR, ResamplePerChannel, in_freq_hz, out_freq_hz,
+              num_audio_channels);
+    return -1;
+  }
+
+  while (channel_resamplers_.size() <
+         static_cast<size_t>(num_audio_channels)) {
+    channel_resamplers_.push_back(new PushResampler<int16_t>);
+  }
+
+  int16_t in_channel[kMaxSamplesPerChannel10Ms];
+  int16_t out_channel[kMaxSamplesPerChannel10Ms];
+  for (int channel = 0; channel < num_audio_channels; ++channel) {
+    PushResampler<int16_t>* resampler = channel_resamplers_[channel];
+    if (resampler->InitializeIfNeeded(in_freq_hz, out_freq_hz, 1) != 0) {
+      LOG_FERR3(LS_ERROR, InitializeIfNeeded, in_freq_hz, out_freq_hz, 1);
+      return -1;
+    }
+    for (size_t i = 0; i < in_length; ++i)
+      in_channel[i] = in_audio[i * num_audio_channels + channel];
+    if (resampler->Resample(in_channel, in_length, out_channel,
+                            kMaxSamplesPerChannel10Ms) !=
+        static_cast<int>(out_length)) {
+      LOG_FERR4(LS_ERROR, Resample, in_channel, in_length, out_channel,
+                kMaxSamplesPerChannel10Ms);
+      return -1;
+    }
+    for (size_t i = 0; i < out_length; ++i)
+      out_audio[i * num_audio_channels + channel] = out_channel[i];
+  }
+
+  return static_cast<int>(out_length);
+}
+
 }  // namespace acm2
 }  // namespace webrtc
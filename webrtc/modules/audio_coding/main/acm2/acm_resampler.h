@@ -12,6 +12,7 @@
 #define WEBRTC_MODULES_AUDIO_CODING_MAIN_ACM2_ACM_RESAMPLER_H_
 
 #include "webrtc/common_audio/resampler/include/push_resampler.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -30,7 +31,17 @@ class ACMResampler {
                      int16_t* out_audio);
 
  private:
+  // Resamples audio with more than two channels, e.g. from multistream Opus,
+  // one channel at a time. PushResampler only handles mono and stereo.
+  int ResamplePerChannel(const int16_t* in_audio,
+                         int in_freq_hz,
+                         int out_freq_hz,
+                         int num_audio_channels,
+                         size_t out_capacity_samples,
+                         int16_t* out_audio);
+
   PushResampler<int16_t> resampler_;
+  ScopedVector<PushResampler<int16_t> > channel_resamplers_;
 };
 
 }  // namespace acm2
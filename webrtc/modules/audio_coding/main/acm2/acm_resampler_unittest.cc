@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/main/acm2/acm_resampler.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace webrtc {
+
+namespace acm2 {
+
+namespace {
+
+const int kInFreqHz = 48000;
+const int kOutFreqHz = 16000;
+const int kNumChannels = 6;  // 5.1 surround from multistream Opus.
+const size_t kInSamplesPerChannel = kInFreqHz / 100;
+const size_t kOutSamplesPerChannel = kOutFreqHz / 100;
+
+// Fills |audio| with a constant value per channel.
+void FillChannels(size_t samples_per_channel, int16_t* audio) {
+  for (size_t i = 0; i < samples_per_channel; ++i) {
+    for (int channel = 0; channel < kNumChannels; ++channel)
+      audio[i * kNumChannels + channel] = 1000 * (channel + 1);
+  }
+}
+
+}  // namespace
+
+TEST(ACMResamplerTest, ResamplesEachOfMoreThanTwoChannels) {
+  ACMResampler resampler;
+  int16_t in_audio[kInSamplesPerChannel * kNumChannels];
+  int16_t out_audio[kOutSamplesPerChannel * kNumChannels];
+  FillChannels(kInSamplesPerChannel, in_audio);
+
+  // Let the resampler settle before checking the levels.
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(static_cast<int>(kOutSamplesPerChannel),
+              resampler.Resample10Msec(in_audio, kInFreqHz, kOutFreqHz,
+                                       kNumChannels,
+                                       kOutSamplesPerChannel * kNumChannels,
+                                       out_audio));
+  }
+  for (size_t i = 0; i < kOutSamplesPerChannel; ++i) {
+    for (int channel = 0; channel < kNumChannels; ++channel) {
+      EXPECT_NEAR(1000 * (channel + 1), out_audio[i * kNumChannels + channel],
+                  10) << "sample " << i << ", channel " << channel;
+    }
+  }
+}
+
+TEST(ACMResamplerTest, FailsIfOutputDoesNotFitForMoreThanTwoChannels) {
+  ACMResampler resampler;
+  int16_t in_audio[kInSamplesPerChannel * kNumChannels];
+  int16_t out_audio[kOutSamplesPerChannel * kNumChannels];
+  FillChannels(kInSamplesPerChannel, in_audio);
+  EXPECT_EQ(-1, resampler.Resample10Msec(
+                    in_audio, kInFreqHz, kOutFreqHz, kNumChannels,
+                    kOutSamplesPerChannel * kNumChannels - 1, out_audio));
+}
+
+}  // namespace acm2
+
+}  // namespace webrtc
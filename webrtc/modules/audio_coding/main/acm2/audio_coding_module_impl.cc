@@ -556,11 +556,13 @@ int AudioCodingModuleImpl::PlayoutFrequency() const {
 int AudioCodingModuleImpl::RegisterReceiveCodec(const CodecInst& codec) {
   CriticalSectionScoped lock(acm_crit_sect_.get());
   RTC_DCHECK(receiver_initialized_);
-  if (codec.channels > 2 || codec.channels < 0) {
+  if (codec.channels < 0) {
     LOG_F(LS_ERROR) << "Unsupported number of channels: " << codec.channels;
     return -1;
   }
 
+  // The number of channels must match a database entry. Only the multistream
+  // Opus entries have more than two.
   int codec_id = ACMCodecDB::ReceiverCodecNumber(codec);
   if (codec_id < 0 || codec_id >= ACMCodecDB::kNumCodecs) {
     LOG_F(LS_ERROR) << "Wrong codec params to be registered as receive codec";
@@ -797,6 +799,10 @@ int AudioCodingModuleImpl::LeastRequiredDelayMs() const {
   return receiver_.LeastRequiredDelayMs();
 }
 
+int AudioCodingModuleImpl::CurrentDelayMs() const {
+  return receiver_.CurrentDelayMs();
+}
+
 void AudioCodingModuleImpl::GetDecodingCallStatistics(
       AudioDecodingCallStats* call_stats) const {
   receiver_.GetDecodingCallStatistics(call_stats);
@@ -1054,6 +1060,21 @@ bool AudioCodingImpl::MapCodecTypeToParameters(int codec_type,
       *sample_rate_hz = 48000;
       *channels = 2;
       break;
+    case acm2::ACMCodecDB::kMultiOpus_6ch:
+      *codec_name = "multiopus";
+      *sample_rate_hz = 48000;
+      *channels = 6;
+      break;
+    case acm2::ACMCodecDB::kMultiOpus_8ch:
+      *codec_name = "multiopus";
+      *sample_rate_hz = 48000;
+      *channels = 8;
+      break;
+    case acm2::ACMCodecDB::kOpusAmbisonics_4ch:
+      *codec_name = "opus-ambisonics";
+      *sample_rate_hz = 48000;
+      *channels = 4;
+      break;
 #endif
     case acm2::ACMCodecDB::kCNNB:
       *codec_name = "CN";
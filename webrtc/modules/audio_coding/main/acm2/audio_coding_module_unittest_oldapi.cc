@@ -325,6 +325,30 @@ TEST_F(AudioCodingModuleTestOldApi, FailOnZeroDesiredFrequency) {
   EXPECT_EQ(-1, acm_->PlayoutData10Ms(0, &audio_frame));
 }
 
+#ifdef WEBRTC_CODEC_OPUS
+#define IF_OPUS(x) x
+#else
+#define IF_OPUS(x) DISABLED_##x
+#endif
+
+// Multistream Opus has its own receive-only codec entries. Their names give
+// the channel mapping, so plain Opus stays mono or stereo.
+TEST_F(AudioCodingModuleTestOldApi, IF_OPUS(RegisterMultistreamOpus)) {
+  CodecInst codec;
+  ASSERT_EQ(0, AudioCodingModule::Codec("multiopus", &codec, 48000, 6));
+  EXPECT_EQ(0, acm_->RegisterReceiveCodec(codec));
+  EXPECT_EQ(-1, acm_->RegisterSendCodec(codec));
+  ASSERT_EQ(0, AudioCodingModule::Codec("multiopus", &codec, 48000, 8));
+  EXPECT_EQ(0, acm_->RegisterReceiveCodec(codec));
+  ASSERT_EQ(0, AudioCodingModule::Codec("opus-ambisonics", &codec, 48000, 4));
+  EXPECT_EQ(0, acm_->RegisterReceiveCodec(codec));
+
+  EXPECT_EQ(-1, AudioCodingModule::Codec("multiopus", &codec, 48000, 4));
+  ASSERT_EQ(0, AudioCodingModule::Codec("opus", &codec, 48000, 2));
+  codec.channels = 6;
+  EXPECT_EQ(-1, acm_->RegisterReceiveCodec(codec));
+}
+
 // Checks that the transport callback is invoked once for each speech packet.
 // Also checks that the frame type is kAudioFrameSpeech.
 TEST_F(AudioCodingModuleTestOldApi, TransportCallbackIsInvokedForEachPacket) {
@@ -460,6 +460,11 @@ class AudioCodingModule {
   // Register possible decoders, can be called multiple times for
   // codecs, CNG-NB, CNG-WB, CNG-SWB, AVT and RED.
   //
+  // Multistream Opus is receive only. It is registered as "multiopus" with 6
+  // or 8 channels for 5.1 or 7.1 surround, or as "opus-ambisonics" with 4
+  // channels for first order ambisonics. PlayoutData10Ms() then returns all
+  // of the channels.
+  //
   // Input:
   //   -receive_codec      : parameters of the codec to be registered, c.f.
   //                         common_types.h for the definition of
@@ -589,6 +594,13 @@ class AudioCodingModule {
   //
   virtual int LeastRequiredDelayMs() const = 0;
 
+  //
+  // The amount of audio, in milliseconds, currently buffered by the jitter
+  // buffer, i.e. in NetEq's packet buffer and not yet played out of its sync
+  // buffer.
+  //
+  virtual int CurrentDelayMs() const = 0;
+
   ///////////////////////////////////////////////////////////////////////////
   // int32_t PlayoutTimestamp()
   // The send timestamp of an RTP packet is associated with the decoded
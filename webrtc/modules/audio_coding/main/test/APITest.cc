@@ -1089,7 +1089,8 @@ void APITest::ChangeCodec(char side) {
     AudioCodingModule::Codec(*codecCntr, &myCodec);
   } while (!STR_CASE_CMP(myCodec.plname, "CN")
       || !STR_CASE_CMP(myCodec.plname, "telephone-event")
-      || !STR_CASE_CMP(myCodec.plname, "RED"));
+      || !STR_CASE_CMP(myCodec.plname, "RED")
+      || myCodec.channels > 2);  // Multistream Opus is receive only.
 
   if (!_randomTest) {
     fprintf(stdout,"\n=====================================================\n");
@@ -284,7 +284,7 @@ void EncodeDecodeTest::Perform() {
         numPars[n] = 0;
       } else if (STR_CASE_CMP(sendCodecTmp.plname, "red") == 0) {
         numPars[n] = 0;
-      } else if (sendCodecTmp.channels == 2) {
+      } else if (sendCodecTmp.channels >= 2) {
         numPars[n] = 0;
       } else {
         numPars[n] = 1;
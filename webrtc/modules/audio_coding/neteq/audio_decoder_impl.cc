@@ -104,6 +104,9 @@ bool CodecSupported(NetEqDecoder codec_type) {
 #ifdef WEBRTC_CODEC_OPUS
     case kDecoderOpus:
     case kDecoderOpus_2ch:
+    case kDecoderOpus_6ch:
+    case kDecoderOpus_8ch:
+    case kDecoderOpusAmbisonics_4ch:
 #endif
     case kDecoderRED:
     case kDecoderAVT:
@@ -161,7 +164,10 @@ int CodecSampleRateHz(NetEqDecoder codec_type) {
     }
 #ifdef WEBRTC_CODEC_OPUS
     case kDecoderOpus:
-    case kDecoderOpus_2ch: {
+    case kDecoderOpus_2ch:
+    case kDecoderOpus_6ch:
+    case kDecoderOpus_8ch:
+    case kDecoderOpusAmbisonics_4ch: {
       return 48000;
     }
 #endif
@@ -223,6 +229,12 @@ AudioDecoder* CreateAudioDecoder(NetEqDecoder codec_type) {
       return new AudioDecoderOpus(1);
     case kDecoderOpus_2ch:
       return new AudioDecoderOpus(2);
+    case kDecoderOpus_6ch:
+      return new AudioDecoderOpus(6, kWebRtcOpusMappingFamilySurround);
+    case kDecoderOpus_8ch:
+      return new AudioDecoderOpus(8, kWebRtcOpusMappingFamilySurround);
+    case kDecoderOpusAmbisonics_4ch:
+      return new AudioDecoderOpus(4, kWebRtcOpusMappingFamilyAmbisonics);
 #endif
     case kDecoderCNGnb:
     case kDecoderCNGwb:
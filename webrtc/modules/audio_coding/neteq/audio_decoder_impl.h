@@ -84,6 +84,10 @@ enum NetEqDecoder {
   kDecoderArbitrary,
   kDecoderOpus,
   kDecoderOpus_2ch,
+  // Multistream Opus. The channel mapping family is part of the type.
+  kDecoderOpus_6ch,  // 5.1 surround, mapping family 1.
+  kDecoderOpus_8ch,  // 7.1 surround, mapping family 1.
+  kDecoderOpusAmbisonics_4ch,  // First order ambisonics, mapping family 2.
 };
 
 // Returns true if |codec_type| is supported.
@@ -705,6 +705,10 @@ TEST(AudioDecoder, CodecSampleRateHz) {
   EXPECT_EQ(32000, CodecSampleRateHz(kDecoderCNGswb32kHz));
   EXPECT_EQ(has_opus ? 48000 : -1, CodecSampleRateHz(kDecoderOpus));
   EXPECT_EQ(has_opus ? 48000 : -1, CodecSampleRateHz(kDecoderOpus_2ch));
+  EXPECT_EQ(has_opus ? 48000 : -1, CodecSampleRateHz(kDecoderOpus_6ch));
+  EXPECT_EQ(has_opus ? 48000 : -1, CodecSampleRateHz(kDecoderOpus_8ch));
+  EXPECT_EQ(has_opus ? 48000 : -1,
+            CodecSampleRateHz(kDecoderOpusAmbisonics_4ch));
   // TODO(tlegrand): Change 32000 to 48000 below once ACM has 48 kHz support.
   EXPECT_EQ(32000, CodecSampleRateHz(kDecoderCNGswb48kHz));
   EXPECT_EQ(-1, CodecSampleRateHz(kDecoderArbitrary));
@@ -738,6 +742,9 @@ TEST(AudioDecoder, CodecSupported) {
   EXPECT_TRUE(CodecSupported(kDecoderArbitrary));
   EXPECT_EQ(has_opus, CodecSupported(kDecoderOpus));
   EXPECT_EQ(has_opus, CodecSupported(kDecoderOpus_2ch));
+  EXPECT_EQ(has_opus, CodecSupported(kDecoderOpus_6ch));
+  EXPECT_EQ(has_opus, CodecSupported(kDecoderOpus_8ch));
+  EXPECT_EQ(has_opus, CodecSupported(kDecoderOpusAmbisonics_4ch));
 }
 
 }  // namespace webrtc
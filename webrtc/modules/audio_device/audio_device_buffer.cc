@@ -440,7 +440,51 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
 int32_t AudioDeviceBuffer::DeliverRecordedData()
 {
     CriticalSectionScoped lock(&_critSectCb);
+    return DeliverRecordedDataLocked(&_recBuffer[0]);
+}
+
+// ----------------------------------------------------------------------------
+//  DeliverRecordedBuffer
+//
+//  Delivers the caller's buffer without copying it to |_recBuffer| when
+//  both channels are recorded, which is the common case.
+// ----------------------------------------------------------------------------
 
+int32_t AudioDeviceBuffer::DeliverRecordedBuffer(const void* audioBuffer,
+                                                 size_t nSamples)
+{
+    bool direct = false;
+    {
+        CriticalSectionScoped lock(&_critSect);
+        if (_recChannel == AudioDeviceModule::kChannelBoth &&
+            _recBytesPerSample != 0)
+        {
+            direct = true;
+            _recSamples = nSamples;
+            _recSize = _recBytesPerSample * nSamples;
+            if (_recFile.Open())
+            {
+                _recFile.Write(audioBuffer, _recSize);
+            }
+        }
+    }
+
+    if (!direct)
+    {
+        // Extract the selected channel into |_recBuffer|.
+        if (SetRecordedBuffer(audioBuffer, nSamples) != 0)
+        {
+            return -1;
+        }
+        return DeliverRecordedData();
+    }
+
+    CriticalSectionScoped lock(&_critSectCb);
+    return DeliverRecordedDataLocked(audioBuffer);
+}
+
+int32_t AudioDeviceBuffer::DeliverRecordedDataLocked(const void* audioBuffer)
+{
     // Ensure that user has initialized all essential members
     if ((_recSampleRate == 0)     ||
         (_recSamples == 0)        ||
@@ -461,7 +505,7 @@ int32_t AudioDeviceBuffer::DeliverRecordedData()
     uint32_t newMicLevel(0);
     uint32_t totalDelayMS = _playDelayMS +_recDelayMS;
 
-    res = _ptrCbAudioTransport->RecordedDataIsAvailable(&_recBuffer[0],
+    res = _ptrCbAudioTransport->RecordedDataIsAvailable(audioBuffer,
                                                         _recSamples,
                                                         _recBytesPerSample,
                                                         _recChannels,
@@ -484,6 +528,32 @@ int32_t AudioDeviceBuffer::DeliverRecordedData()
 // ----------------------------------------------------------------------------
 
 int32_t AudioDeviceBuffer::RequestPlayoutData(size_t nSamples)
+{
+    return RequestPlayout(nSamples, &_playBuffer[0]);
+}
+
+// ----------------------------------------------------------------------------
+//  RequestPlayoutBuffer
+//
+//  Lets the AudioTransport write to the caller's buffer instead of to
+//  |_playBuffer|, saving the copy made by GetPlayoutData().
+// ----------------------------------------------------------------------------
+
+int32_t AudioDeviceBuffer::RequestPlayoutBuffer(void* audioBuffer,
+                                                size_t nSamples)
+{
+    int32_t samplesOut = RequestPlayout(nSamples, audioBuffer);
+
+    CriticalSectionScoped lock(&_critSect);
+    if (samplesOut > 0 && _playFile.Open())
+    {
+        // write to binary file in mono or stereo (interleaved)
+        _playFile.Write(audioBuffer, _playBytesPerSample * samplesOut);
+    }
+    return samplesOut;
+}
+
+int32_t AudioDeviceBuffer::RequestPlayout(size_t nSamples, void* audioBuffer)
 {
     uint32_t playSampleRate = 0;
     size_t playBytesPerSample = 0;
@@ -540,7 +610,7 @@ int32_t AudioDeviceBuffer::RequestPlayoutData(size_t nSamples)
                                                      playBytesPerSample,
                                                      playChannels,
                                                      playSampleRate,
-                                                     &_playBuffer[0],
+                                                     audioBuffer,
                                                      nSamplesOut,
                                                      &elapsed_time_ms,
                                                      &ntp_time_ms);
@@ -58,9 +58,20 @@ public:
     virtual int32_t DeliverRecordedData();
     uint32_t NewMicLevel() const;
 
+    // Same as SetRecordedBuffer() followed by DeliverRecordedData(), but
+    // |audioBuffer| is handed to the AudioTransport as is instead of being
+    // copied, unless only one channel of stereo audio is to be recorded.
+    virtual int32_t DeliverRecordedBuffer(const void* audioBuffer,
+                                          size_t nSamples);
+
     virtual int32_t RequestPlayoutData(size_t nSamples);
     virtual int32_t GetPlayoutData(void* audioBuffer);
 
+    // Same as RequestPlayoutData() followed by GetPlayoutData(), but the
+    // AudioTransport writes the audio directly to |audioBuffer|. Returns the
+    // number of samples written. Not to be mixed with GetPlayoutData().
+    virtual int32_t RequestPlayoutBuffer(void* audioBuffer, size_t nSamples);
+
     int32_t StartInputFileRecording(
         const char fileName[kAdmMaxFileNameSize]);
     int32_t StopInputFileRecording();
@@ -71,6 +82,11 @@ public:
     int32_t SetTypingStatus(bool typingStatus);
 
 private:
+    // Requires |_critSectCb| to be held.
+    int32_t DeliverRecordedDataLocked(const void* audioBuffer);
+    // Asks the AudioTransport for |nSamples| of audio written to |audioBuffer|.
+    int32_t RequestPlayout(size_t nSamples, void* audioBuffer);
+
     int32_t                   _id;
     CriticalSectionWrapper&         _critSect;
     CriticalSectionWrapper&         _critSectCb;
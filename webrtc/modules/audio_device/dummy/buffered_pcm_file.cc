@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/dummy/buffered_pcm_file.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/common_audio/wav_header.h"
+
+namespace webrtc {
+
+namespace {
+
+// Doesn't take ownership of the file handle and won't close it.
+class ReadableWavFile : public ReadableWav {
+ public:
+  explicit ReadableWavFile(FILE* file) : file_(file) {}
+  size_t Read(void* buf, size_t num_bytes) override {
+    return fread(buf, 1, num_bytes, file_);
+  }
+
+ private:
+  FILE* file_;
+};
+
+size_t FramesInMs(int sample_rate_hz, int buffer_ms) {
+  return static_cast<size_t>(std::max(sample_rate_hz / 1000 * buffer_ms, 1));
+}
+
+}  // namespace
+
+BufferedPcmFileReader* BufferedPcmFileReader::Create(
+    const std::string& filename,
+    int sample_rate_hz,
+    int num_channels,
+    int buffer_ms) {
+  FILE* file = fopen(filename.c_str(), "rb");
+  if (!file)
+    return NULL;
+  rtc::scoped_ptr<BufferedPcmFileReader> reader(new BufferedPcmFileReader(
+      file, num_channels, FramesInMs(sample_rate_hz, buffer_ms)));
+
+  // Check for a WAV header matching the requested format.
+  char riff[4];
+  if (fread(riff, 1, sizeof(riff), file) == sizeof(riff) &&
+      memcmp(riff, "RIFF", sizeof(riff)) == 0) {
+    rewind(file);
+    ReadableWavFile readable(file);
+    int wav_channels = 0;
+    int wav_sample_rate = 0;
+    WavFormat format;
+    int bytes_per_sample = 0;
+    uint32_t num_samples = 0;
+    if (!ReadWavHeader(&readable, &wav_channels, &wav_sample_rate, &format,
+                       &bytes_per_sample, &num_samples) ||
+        format != kWavFormatPcm || bytes_per_sample != 2 ||
+        wav_channels != num_channels || wav_sample_rate != sample_rate_hz ||
+        num_samples == 0) {
+      return NULL;
+    }
+    reader->data_offset_ = ftell(file);
+    reader->data_size_ = num_samples * sizeof(int16_t);
+  } else {
+    rewind(file);
+  }
+  return reader.release();
+}
+
+BufferedPcmFileReader::BufferedPcmFileReader(FILE* file,
+                                             int num_channels,
+                                             size_t buffer_frames)
+    : file_(file),
+      num_channels_(num_channels),
+      buffer_frames_(buffer_frames),
+      buffer_(new int16_t[buffer_frames * num_channels]),
+      position_(0),
+      available_(0),
+      data_offset_(0),
+      data_size_(0),
+      data_read_(0) {}
+
+BufferedPcmFileReader::~BufferedPcmFileReader() {
+  fclose(file_);
+}
+
+bool BufferedPcmFileReader::Read(int16_t* destination, size_t num_frames) {
+  while (num_frames > 0) {
+    if (position_ == available_ && !Fill())
+      return false;
+    const size_t frames = std::min(num_frames, available_ - position_);
+    memcpy(destination, &buffer_[position_ * num_channels_],
+           frames * num_channels_ * sizeof(int16_t));
+    destination += frames * num_channels_;
+    position_ += frames;
+    num_frames -= frames;
+  }
+  return true;
+}
+
+bool BufferedPcmFileReader::Fill() {
+  const size_t frame_bytes = num_channels_ * sizeof(int16_t);
+  // A second attempt is made after rewinding, which only fails if there is
+  // no audio at all.
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    size_t max_frames = buffer_frames_;
+    if (data_size_ > 0) {
+      // There may be other chunks after the audio data in a WAV file.
+      max_frames =
+          std::min(max_frames, (data_size_ - data_read_) / frame_bytes);
+    }
+    const size_t frames =
+        max_frames > 0 ? fread(buffer_.get(), frame_bytes, max_frames, file_)
+                       : 0;
+    if (frames > 0) {
+      data_read_ += frames * frame_bytes;
+      position_ = 0;
+      available_ = frames;
+      return true;
+    }
+    if (fseek(file_, data_offset_, SEEK_SET) != 0)
+      return false;
+    data_read_ = 0;
+  }
+  return false;
+}
+
+BufferedPcmFileWriter* BufferedPcmFileWriter::Create(
+    const std::string& filename,
+    int sample_rate_hz,
+    int num_channels,
+    int buffer_ms) {
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (!file)
+    return NULL;
+  return new BufferedPcmFileWriter(file, num_channels,
+                                   FramesInMs(sample_rate_hz, buffer_ms));
+}
+
+BufferedPcmFileWriter::BufferedPcmFileWriter(FILE* file,
+                                             int num_channels,
+                                             size_t buffer_frames)
+    : file_(file),
+      num_channels_(num_channels),
+      buffer_frames_(buffer_frames),
+      buffer_(new int16_t[buffer_frames * num_channels]),
+      buffered_(0) {}
+
+BufferedPcmFileWriter::~BufferedPcmFileWriter() {
+  Flush();
+  fclose(file_);
+}
+
+bool BufferedPcmFileWriter::Write(const int16_t* source, size_t num_frames) {
+  while (num_frames > 0) {
+    if (buffered_ == buffer_frames_ && !Flush())
+      return false;
+    const size_t frames = std::min(num_frames, buffer_frames_ - buffered_);
+    memcpy(&buffer_[buffered_ * num_channels_], source,
+           frames * num_channels_ * sizeof(int16_t));
+    source += frames * num_channels_;
+    buffered_ += frames;
+    num_frames -= frames;
+  }
+  return true;
+}
+
+bool BufferedPcmFileWriter::Flush() {
+  const size_t frame_bytes = num_channels_ * sizeof(int16_t);
+  const bool ok =
+      fwrite(buffer_.get(), frame_bytes, buffered_, file_) == buffered_;
+  buffered_ = 0;
+  return fflush(file_) == 0 && ok;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_AUDIO_DEVICE_BUFFERED_PCM_FILE_H
+#define WEBRTC_AUDIO_DEVICE_BUFFERED_PCM_FILE_H
+
+#include <stdio.h>
+
+#include <string>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Reads 16-bit interleaved audio from a raw PCM or WAV file in large chunks,
+// so that audio can be consumed in 10 ms blocks without a file system call
+// per block. The file is played in a loop.
+class BufferedPcmFileReader {
+ public:
+  // Returns NULL if the file can't be opened, or if it is a WAV file that
+  // isn't 16-bit PCM with the given sample rate and number of channels. Files
+  // without a WAV header are assumed to be raw PCM of the given format.
+  // |buffer_ms| is the amount of audio read from the file at a time.
+  static BufferedPcmFileReader* Create(const std::string& filename,
+                                       int sample_rate_hz,
+                                       int num_channels,
+                                       int buffer_ms);
+  ~BufferedPcmFileReader();
+
+  // Copies the next |num_frames| frames into |destination|, continuing from
+  // the start of the file when reaching the end. Returns false if the file
+  // contains no audio or can't be read.
+  bool Read(int16_t* destination, size_t num_frames);
+
+ private:
+  BufferedPcmFileReader(FILE* file, int num_channels, size_t buffer_frames);
+
+  // Refills |buffer_| from the file, rewinding at the end of the audio data.
+  bool Fill();
+
+  FILE* file_;
+  const int num_channels_;
+  const size_t buffer_frames_;
+  rtc::scoped_ptr<int16_t[]> buffer_;
+  // Read position and number of valid frames in |buffer_|.
+  size_t position_;
+  size_t available_;
+  // Offset and size in bytes of the audio data in the file. |data_size_| is
+  // 0 if the audio extends to the end of the file.
+  long data_offset_;
+  size_t data_size_;
+  size_t data_read_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BufferedPcmFileReader);
+};
+
+// Writes 16-bit interleaved audio to a raw PCM file, collecting it in memory
+// until |buffer_ms| of audio is available.
+class BufferedPcmFileWriter {
+ public:
+  // Returns NULL if the file can't be opened for writing.
+  static BufferedPcmFileWriter* Create(const std::string& filename,
+                                       int sample_rate_hz,
+                                       int num_channels,
+                                       int buffer_ms);
+  // Writes any buffered audio.
+  ~BufferedPcmFileWriter();
+
+  bool Write(const int16_t* source, size_t num_frames);
+  bool Flush();
+
+ private:
+  BufferedPcmFileWriter(FILE* file, int num_channels, size_t buffer_frames);
+
+  FILE* file_;
+  const int num_channels_;
+  const size_t buffer_frames_;
+  rtc::scoped_ptr<int16_t[]> buffer_;
+  size_t buffered_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BufferedPcmFileWriter);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_AUDIO_DEVICE_BUFFERED_PCM_FILE_H
@@ -9,6 +9,8 @@
  */
 #include <iostream>
 #include "webrtc/modules/audio_device/dummy/file_audio_device.h"
+#include "webrtc/modules/audio_device/dummy/buffered_pcm_file.h"
+#include "webrtc/modules/audio_device/dummy/file_audio_device_driver.h"
 #include "webrtc/system_wrappers/interface/sleep.h"
 #include "webrtc/system_wrappers/interface/thread_wrapper.h"
 
@@ -22,10 +24,19 @@ int kPlayoutBufferSize = kPlayoutFixedSampleRate / 100
                          * kPlayoutNumChannels * 2;
 int kRecordingBufferSize = kRecordingFixedSampleRate / 100
                            * kRecordingNumChannels * 2;
+// Amount of audio read from or written to file at a time.
+const int kFileBufferMs = 1000;
 
 FileAudioDevice::FileAudioDevice(const int32_t id,
                                  const char* inputFilename,
-                                 const char* outputFilename):
+                                 const char* outputFilename)
+    : FileAudioDevice(id, inputFilename, outputFilename, NULL) {
+}
+
+FileAudioDevice::FileAudioDevice(const int32_t id,
+                                 const char* inputFilename,
+                                 const char* outputFilename,
+                                 FileAudioDeviceDriver* driver):
     _ptrAudioBuffer(NULL),
     _recordingBuffer(NULL),
     _playoutBuffer(NULL),
@@ -39,24 +50,16 @@ FileAudioDevice::FileAudioDevice(const int32_t id,
     _recording(false),
     _lastCallPlayoutMillis(0),
     _lastCallRecordMillis(0),
-    _outputFile(*FileWrapper::Create()),
-    _inputFile(*FileWrapper::Create()),
     _outputFilename(outputFilename),
     _inputFilename(inputFilename),
-    _clock(Clock::GetRealTimeClock()) {
+    _clock(Clock::GetRealTimeClock()),
+    _driver(driver) {
 }
 
 FileAudioDevice::~FileAudioDevice() {
-  if (_outputFile.Open()) {
-      _outputFile.Flush();
-      _outputFile.CloseFile();
-  }
-  delete &_outputFile;
-  if (_inputFile.Open()) {
-      _inputFile.Flush();
-      _inputFile.CloseFile();
-  }
-  delete &_inputFile;
+  if (_driver)
+    _driver->RemoveDevice(this);
+  delete &_critSect;
 }
 
 int32_t FileAudioDevice::ActiveAudioLayer(
@@ -205,13 +208,24 @@ int32_t FileAudioDevice::StartPlayout() {
   }
 
   // PLAYOUT
-  if (!_outputFilename.empty() && _outputFile.OpenFile(
-        _outputFilename.c_str(), false, false, false) == -1) {
-    printf("Failed to open playout file %s!\n", _outputFilename.c_str());
-    _playing = false;
-    delete [] _playoutBuffer;
-    _playoutBuffer = NULL;
-    return -1;
+  if (!_outputFilename.empty()) {
+    BufferedPcmFileWriter* outputFile = BufferedPcmFileWriter::Create(
+        _outputFilename, kPlayoutFixedSampleRate, kPlayoutNumChannels,
+        kFileBufferMs);
+    CriticalSectionScoped lock(&_critSect);
+    _outputFile.reset(outputFile);
+    if (!_outputFile) {
+      printf("Failed to open playout file %s!\n", _outputFilename.c_str());
+      _playing = false;
+      delete [] _playoutBuffer;
+      _playoutBuffer = NULL;
+      return -1;
+    }
+  }
+
+  if (_driver) {
+    _driver->AddDevice(this);
+    return 0;
   }
 
   const char* threadName = "webrtc_audio_module_play_thread";
@@ -239,16 +253,15 @@ int32_t FileAudioDevice::StopPlayout() {
       _ptrThreadPlay->Stop();
       _ptrThreadPlay.reset();
   }
+  MaybeRemoveFromDriver();
 
   CriticalSectionScoped lock(&_critSect);
 
   _playoutFramesLeft = 0;
   delete [] _playoutBuffer;
   _playoutBuffer = NULL;
-  if (_outputFile.Open()) {
-      _outputFile.Flush();
-      _outputFile.CloseFile();
-  }
+  // Writes any buffered audio.
+  _outputFile.reset();
    return 0;
 }
 
@@ -267,14 +280,25 @@ int32_t FileAudioDevice::StartRecording() {
       _recordingBuffer = new int8_t[_recordingBufferSizeIn10MS];
   }
 
-  if (!_inputFilename.empty() && _inputFile.OpenFile(
-        _inputFilename.c_str(), true, true, false) == -1) {
-    printf("Failed to open audio input file %s!\n",
-           _inputFilename.c_str());
-    _recording = false;
-    delete[] _recordingBuffer;
-    _recordingBuffer = NULL;
-    return -1;
+  if (!_inputFilename.empty()) {
+    BufferedPcmFileReader* inputFile = BufferedPcmFileReader::Create(
+        _inputFilename, kRecordingFixedSampleRate, kRecordingNumChannels,
+        kFileBufferMs);
+    CriticalSectionScoped lock(&_critSect);
+    _inputFile.reset(inputFile);
+    if (!_inputFile) {
+      printf("Failed to open audio input file %s!\n",
+             _inputFilename.c_str());
+      _recording = false;
+      delete[] _recordingBuffer;
+      _recordingBuffer = NULL;
+      return -1;
+    }
+  }
+
+  if (_driver) {
+    _driver->AddDevice(this);
+    return 0;
   }
 
   const char* threadName = "webrtc_audio_module_capture_thread";
@@ -303,6 +327,7 @@ int32_t FileAudioDevice::StopRecording() {
       _ptrThreadRec->Stop();
       _ptrThreadRec.reset();
   }
+  MaybeRemoveFromDriver();
 
   CriticalSectionScoped lock(&_critSect);
   _recordingFramesLeft = 0;
@@ -310,6 +335,7 @@ int32_t FileAudioDevice::StopRecording() {
       delete [] _recordingBuffer;
       _recordingBuffer = NULL;
   }
+  _inputFile.reset();
   return 0;
 }
 
@@ -500,16 +526,7 @@ bool FileAudioDevice::PlayThreadProcess()
 
     if (_lastCallPlayoutMillis == 0 ||
         currentTime - _lastCallPlayoutMillis >= 10) {
-        _critSect.Leave();
-        _ptrAudioBuffer->RequestPlayoutData(_playoutFramesIn10MS);
-        _critSect.Enter();
-
-        _playoutFramesLeft = _ptrAudioBuffer->GetPlayoutData(_playoutBuffer);
-        assert(_playoutFramesLeft == _playoutFramesIn10MS);
-        if (_outputFile.Open()) {
-          _outputFile.Write(_playoutBuffer, kPlayoutBufferSize);
-          _outputFile.Flush();
-        }
+        PlayoutProcess();
         _lastCallPlayoutMillis = currentTime;
     }
     _playoutFramesLeft = 0;
@@ -529,18 +546,8 @@ bool FileAudioDevice::RecThreadProcess()
 
     if (_lastCallRecordMillis == 0 ||
         currentTime - _lastCallRecordMillis >= 10) {
-      if (_inputFile.Open()) {
-        if (_inputFile.Read(_recordingBuffer, kRecordingBufferSize) > 0) {
-          _ptrAudioBuffer->SetRecordedBuffer(_recordingBuffer,
-                                             _recordingFramesIn10MS);
-        } else {
-          _inputFile.Rewind();
-        }
-        _lastCallRecordMillis = currentTime;
-        _critSect.Leave();
-        _ptrAudioBuffer->DeliverRecordedData();
-        _critSect.Enter();
-      }
+      RecordingProcess();
+      _lastCallRecordMillis = currentTime;
     }
 
     _critSect.Leave();
@@ -548,4 +555,58 @@ bool FileAudioDevice::RecThreadProcess()
     return true;
 }
 
+void FileAudioDevice::Process10ms() {
+  CriticalSectionScoped lock(&_critSect);
+  // The device may already be processed for one direction while the other is
+  // being started.
+  if (_playing && _playoutBuffer) {
+    PlayoutProcess();
+    _playoutFramesLeft = 0;
+  }
+  if (_recording && _recordingBuffer)
+    RecordingProcess();
+}
+
+void FileAudioDevice::PlayoutProcess() {
+  _critSect.Leave();
+  _ptrAudioBuffer->RequestPlayoutData(_playoutFramesIn10MS);
+  _critSect.Enter();
+
+  _playoutFramesLeft = _ptrAudioBuffer->GetPlayoutData(_playoutBuffer);
+  assert(_playoutFramesLeft == _playoutFramesIn10MS);
+  if (_outputFile) {
+    _outputFile->Write(reinterpret_cast<const int16_t*>(_playoutBuffer),
+                       _playoutFramesIn10MS);
+  }
+}
+
+void FileAudioDevice::RecordingProcess() {
+  if (!_inputFile)
+    return;
+  if (_inputFile->Read(reinterpret_cast<int16_t*>(_recordingBuffer),
+                       _recordingFramesIn10MS)) {
+    _ptrAudioBuffer->SetRecordedBuffer(_recordingBuffer,
+                                       _recordingFramesIn10MS);
+  }
+  _critSect.Leave();
+  _ptrAudioBuffer->DeliverRecordedData();
+  _critSect.Enter();
+}
+
+void FileAudioDevice::MaybeRemoveFromDriver() {
+  if (!_driver)
+    return;
+  // Removing the device waits for a Process10ms() call in progress, after
+  // which the buffers of the stopped direction can be freed. Must not hold
+  // |_critSect|, see FileAudioDeviceDriver::Process().
+  _driver->RemoveDevice(this);
+  bool active;
+  {
+    CriticalSectionScoped lock(&_critSect);
+    active = _playing || _recording;
+  }
+  if (active)
+    _driver->AddDevice(this);
+}
+
 }  // namespace webrtc
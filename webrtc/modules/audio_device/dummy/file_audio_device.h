@@ -15,13 +15,16 @@
 
 #include <string>
 
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/audio_device/audio_device_generic.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
-#include "webrtc/system_wrappers/interface/file_wrapper.h"
 #include "webrtc/system_wrappers/interface/clock.h"
 
 namespace webrtc {
+class BufferedPcmFileReader;
+class BufferedPcmFileWriter;
 class EventWrapper;
+class FileAudioDeviceDriver;
 class ThreadWrapper;
 
 // This is a fake audio device which plays audio from a file as its microphone
@@ -31,12 +34,18 @@ class FileAudioDevice : public AudioDeviceGeneric {
   // Constructs a file audio device with |id|. It will read audio from
   // |inputFilename| and record output audio to |outputFilename|.
   //
-  // The input file should be a readable 48k stereo raw file, and the output
-  // file should point to a writable location. The output format will also be
-  // 48k stereo raw audio.
+  // The input file should be a readable 48k stereo raw or WAV file, and the
+  // output file should point to a writable location. The output format will
+  // be 48k stereo raw audio.
   FileAudioDevice(const int32_t id,
                   const char* inputFilename,
                   const char* outputFilename);
+  // As above, but playout and recording run on the thread of |driver| rather
+  // than on threads of the device's own. |driver| must outlive the device.
+  FileAudioDevice(const int32_t id,
+                  const char* inputFilename,
+                  const char* outputFilename,
+                  FileAudioDeviceDriver* driver);
   virtual ~FileAudioDevice();
 
   // Retrieve the currently utilized audio layer
@@ -159,11 +168,23 @@ class FileAudioDevice : public AudioDeviceGeneric {
   void AttachAudioBuffer(AudioDeviceBuffer* audioBuffer) override;
 
  private:
+  friend class FileAudioDeviceDriver;
+
   static bool RecThreadFunc(void*);
   static bool PlayThreadFunc(void*);
   bool RecThreadProcess();
   bool PlayThreadProcess();
 
+  // Called by |_driver| every 10 ms.
+  void Process10ms();
+  // Play out or record 10 ms of audio. Must be called with |_critSect| held,
+  // which is released while calling into |_ptrAudioBuffer|.
+  void PlayoutProcess();
+  void RecordingProcess();
+  // Waits for |_driver| to finish processing the device, and stops it from
+  // being processed any further if neither playing nor recording.
+  void MaybeRemoveFromDriver();
+
   int32_t _playout_index;
   int32_t _record_index;
   AudioDeviceModule::BufferType _playBufType;
@@ -186,12 +207,13 @@ class FileAudioDevice : public AudioDeviceGeneric {
   uint64_t _lastCallPlayoutMillis;
   uint64_t _lastCallRecordMillis;
 
-  FileWrapper& _outputFile;
-  FileWrapper& _inputFile;
+  rtc::scoped_ptr<BufferedPcmFileWriter> _outputFile;
+  rtc::scoped_ptr<BufferedPcmFileReader> _inputFile;
   std::string _outputFilename;
   std::string _inputFilename;
 
   Clock* _clock;
+  FileAudioDeviceDriver* _driver;
 };
 
 }  // namespace webrtc
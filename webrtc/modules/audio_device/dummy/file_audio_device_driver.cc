@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/dummy/file_audio_device_driver.h"
+
+#include <algorithm>
+
+#include "webrtc/modules/audio_device/dummy/file_audio_device.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+
+namespace {
+const unsigned long kProcessIntervalMs = 10;
+}  // namespace
+
+FileAudioDeviceDriver::FileAudioDeviceDriver()
+    : crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      timer_(EventTimerWrapper::Create()),
+      thread_(ThreadWrapper::CreateThread(&Run, this,
+                                          "webrtc_file_audio_driver")) {
+  timer_->StartTimer(true, kProcessIntervalMs);
+  thread_->Start();
+  thread_->SetPriority(kRealtimePriority);
+}
+
+FileAudioDeviceDriver::~FileAudioDeviceDriver() {
+  thread_->Stop();
+  timer_->StopTimer();
+}
+
+void FileAudioDeviceDriver::AddDevice(FileAudioDevice* device) {
+  CriticalSectionScoped lock(crit_sect_.get());
+  if (std::find(devices_.begin(), devices_.end(), device) == devices_.end())
+    devices_.push_back(device);
+}
+
+void FileAudioDeviceDriver::RemoveDevice(FileAudioDevice* device) {
+  // Devices are processed with |crit_sect_| held, so once the lock is taken
+  // |device| is not in use.
+  CriticalSectionScoped lock(crit_sect_.get());
+  std::vector<FileAudioDevice*>::iterator it =
+      std::find(devices_.begin(), devices_.end(), device);
+  if (it != devices_.end())
+    devices_.erase(it);
+}
+
+bool FileAudioDeviceDriver::Run(void* obj) {
+  return static_cast<FileAudioDeviceDriver*>(obj)->Process();
+}
+
+bool FileAudioDeviceDriver::Process() {
+  timer_->Wait(kProcessIntervalMs * 2);
+  CriticalSectionScoped lock(crit_sect_.get());
+  for (size_t i = 0; i < devices_.size(); ++i)
+    devices_[i]->Process10ms();
+  return true;
+}
+
+}  // namespace webrtc
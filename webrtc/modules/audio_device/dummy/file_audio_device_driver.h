@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_AUDIO_DEVICE_FILE_AUDIO_DEVICE_DRIVER_H
+#define WEBRTC_AUDIO_DEVICE_FILE_AUDIO_DEVICE_DRIVER_H
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+
+namespace webrtc {
+class CriticalSectionWrapper;
+class EventTimerWrapper;
+class FileAudioDevice;
+class ThreadWrapper;
+
+// Runs the 10 ms playout and recording of any number of FileAudioDevices on a
+// single thread, instead of on two threads per device. Intended for test rigs
+// running hundreds of file based audio devices in one process.
+//
+// A device is processed from when playout or recording is started until both
+// have been stopped. The driver must outlive the devices using it.
+class FileAudioDeviceDriver {
+ public:
+  FileAudioDeviceDriver();
+  ~FileAudioDeviceDriver();
+
+  // Called by FileAudioDevice. After RemoveDevice() has returned, |device|
+  // will not be processed again.
+  void AddDevice(FileAudioDevice* device);
+  void RemoveDevice(FileAudioDevice* device);
+
+ private:
+  static bool Run(void* obj);
+  bool Process();
+
+  rtc::scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  rtc::scoped_ptr<EventTimerWrapper> timer_;
+  rtc::scoped_ptr<ThreadWrapper> thread_;
+  std::vector<FileAudioDevice*> devices_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(FileAudioDeviceDriver);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_AUDIO_DEVICE_FILE_AUDIO_DEVICE_DRIVER_H
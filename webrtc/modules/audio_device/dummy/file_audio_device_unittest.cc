@@ -0,0 +1,300 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_audio/wav_file.h"
+#include "webrtc/modules/audio_device/audio_device_buffer.h"
+#include "webrtc/modules/audio_device/dummy/buffered_pcm_file.h"
+#include "webrtc/modules/audio_device/dummy/file_audio_device.h"
+#include "webrtc/modules/audio_device/dummy/file_audio_device_driver.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kSampleRate = 48000;
+const int kChannels = 2;
+const size_t kFramesPer10Ms = kSampleRate / 100;
+
+// Writes |num_frames| stereo frames where the left sample of frame i is i and
+// the right sample is -i.
+void WriteRampFile(const std::string& filename, size_t num_frames) {
+  FILE* file = fopen(filename.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+  for (size_t i = 0; i < num_frames; ++i) {
+    int16_t frame[kChannels] = {static_cast<int16_t>(i),
+                                static_cast<int16_t>(-static_cast<int>(i))};
+    ASSERT_EQ(1u, fwrite(frame, sizeof(frame), 1, file));
+  }
+  fclose(file);
+}
+
+size_t FileSize(const std::string& filename) {
+  FILE* file = fopen(filename.c_str(), "rb");
+  if (!file)
+    return 0;
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fclose(file);
+  return static_cast<size_t>(size);
+}
+
+class CountingAudioTransport : public AudioTransport {
+ public:
+  CountingAudioTransport() : recorded_(0), played_(0) {}
+
+  int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                  const size_t nSamples,
+                                  const size_t nBytesPerSample,
+                                  const uint8_t nChannels,
+                                  const uint32_t samplesPerSec,
+                                  const uint32_t totalDelayMS,
+                                  const int32_t clockDrift,
+                                  const uint32_t currentMicLevel,
+                                  const bool keyPressed,
+                                  uint32_t& newMicLevel) override {
+    ++recorded_;
+    return 0;
+  }
+
+  int32_t NeedMorePlayData(const size_t nSamples,
+                           const size_t nBytesPerSample,
+                           const uint8_t nChannels,
+                           const uint32_t samplesPerSec,
+                           void* audioSamples,
+                           size_t& nSamplesOut,
+                           int64_t* elapsed_time_ms,
+                           int64_t* ntp_time_ms) override {
+    memset(audioSamples, 0, nSamples * nBytesPerSample);
+    nSamplesOut = nSamples;
+    ++played_;
+    return 0;
+  }
+
+  // Only accessed once the devices have been stopped.
+  int recorded_;
+  int played_;
+};
+
+// A FileAudioDevice together with the buffer and transport it feeds.
+class FileFedDevice {
+ public:
+  FileFedDevice(const std::string& input_filename,
+                const std::string& output_filename,
+                FileAudioDeviceDriver* driver)
+      : device_(0, input_filename.c_str(), output_filename.c_str(), driver) {
+    buffer_.RegisterAudioCallback(&transport_);
+    device_.AttachAudioBuffer(&buffer_);
+  }
+
+  bool Start() {
+    return device_.InitPlayout() == 0 && device_.InitRecording() == 0 &&
+           device_.StartPlayout() == 0 && device_.StartRecording() == 0;
+  }
+
+  void Stop() {
+    device_.StopRecording();
+    device_.StopPlayout();
+  }
+
+  const CountingAudioTransport& transport() const { return transport_; }
+
+ private:
+  CountingAudioTransport transport_;
+  AudioDeviceBuffer buffer_;
+  FileAudioDevice device_;
+};
+
+}  // namespace
+
+TEST(BufferedPcmFileTest, ReaderLoopsRawFile) {
+  const std::string filename =
+      test::TempFilename(test::OutputPath(), "buffered_pcm_raw");
+  const size_t kFileFrames = 100;
+  WriteRampFile(filename, kFileFrames);
+
+  // Use a buffer smaller than the file to exercise refilling.
+  rtc::scoped_ptr<BufferedPcmFileReader> reader(
+      BufferedPcmFileReader::Create(filename, kSampleRate, kChannels, 1));
+  ASSERT_TRUE(reader.get() != NULL);
+  const size_t kReadFrames = 250;
+  std::vector<int16_t> audio(kReadFrames * kChannels);
+  ASSERT_TRUE(reader->Read(&audio[0], kReadFrames));
+  for (size_t i = 0; i < kReadFrames; ++i) {
+    EXPECT_EQ(static_cast<int>(i % kFileFrames), audio[i * kChannels]);
+    EXPECT_EQ(-static_cast<int>(i % kFileFrames), audio[i * kChannels + 1]);
+  }
+  reader.reset();
+  remove(filename.c_str());
+}
+
+TEST(BufferedPcmFileTest, ReaderSkipsWavHeader) {
+  const std::string filename =
+      test::TempFilename(test::OutputPath(), "buffered_pcm_wav");
+  const size_t kFileFrames = 30;
+  {
+    WavWriter writer(filename, kSampleRate, kChannels);
+    for (size_t i = 0; i < kFileFrames; ++i) {
+      int16_t frame[kChannels] = {static_cast<int16_t>(i + 1000),
+                                  static_cast<int16_t>(i + 2000)};
+      writer.WriteSamples(frame, kChannels);
+    }
+  }
+
+  rtc::scoped_ptr<BufferedPcmFileReader> reader(
+      BufferedPcmFileReader::Create(filename, kSampleRate, kChannels, 10));
+  ASSERT_TRUE(reader.get() != NULL);
+  const size_t kReadFrames = 2 * kFileFrames + 5;
+  std::vector<int16_t> audio(kReadFrames * kChannels);
+  ASSERT_TRUE(reader->Read(&audio[0], kReadFrames));
+  for (size_t i = 0; i < kReadFrames; ++i) {
+    EXPECT_EQ(static_cast<int>(i % kFileFrames + 1000), audio[i * kChannels]);
+    EXPECT_EQ(static_cast<int>(i % kFileFrames + 2000),
+              audio[i * kChannels + 1]);
+  }
+
+  // A WAV file of another format is rejected.
+  EXPECT_TRUE(BufferedPcmFileReader::Create(filename, 16000, kChannels, 10) ==
+              NULL);
+  EXPECT_TRUE(BufferedPcmFileReader::Create(filename, kSampleRate, 1, 10) ==
+              NULL);
+  reader.reset();
+  remove(filename.c_str());
+}
+
+TEST(BufferedPcmFileTest, ReaderFailsOnEmptyFile) {
+  const std::string filename =
+      test::TempFilename(test::OutputPath(), "buffered_pcm_empty");
+  WriteRampFile(filename, 0);
+  rtc::scoped_ptr<BufferedPcmFileReader> reader(
+      BufferedPcmFileReader::Create(filename, kSampleRate, kChannels, 10));
+  ASSERT_TRUE(reader.get() != NULL);
+  int16_t audio[kChannels];
+  EXPECT_FALSE(reader->Read(audio, 1));
+  reader.reset();
+  remove(filename.c_str());
+}
+
+TEST(BufferedPcmFileTest, WriterBuffersUntilFlushed) {
+  const std::string filename =
+      test::TempFilename(test::OutputPath(), "buffered_pcm_out");
+  rtc::scoped_ptr<BufferedPcmFileWriter> writer(
+      BufferedPcmFileWriter::Create(filename, kSampleRate, kChannels, 25));
+  ASSERT_TRUE(writer.get() != NULL);
+  std::vector<int16_t> audio(kFramesPer10Ms * kChannels);
+  for (size_t i = 0; i < audio.size(); ++i)
+    audio[i] = static_cast<int16_t>(i);
+  const size_t kBytesPer10Ms = audio.size() * sizeof(int16_t);
+
+  // 20 ms fit into the buffer, the third block makes it spill 25 ms.
+  ASSERT_TRUE(writer->Write(&audio[0], kFramesPer10Ms));
+  ASSERT_TRUE(writer->Write(&audio[0], kFramesPer10Ms));
+  EXPECT_EQ(0u, FileSize(filename));
+  ASSERT_TRUE(writer->Write(&audio[0], kFramesPer10Ms));
+  EXPECT_EQ(5 * kBytesPer10Ms / 2, FileSize(filename));
+  writer.reset();
+  EXPECT_EQ(3 * kBytesPer10Ms, FileSize(filename));
+
+  rtc::scoped_ptr<BufferedPcmFileReader> reader(
+      BufferedPcmFileReader::Create(filename, kSampleRate, kChannels, 10));
+  ASSERT_TRUE(reader.get() != NULL);
+  std::vector<int16_t> read(audio.size());
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(reader->Read(&read[0], kFramesPer10Ms));
+    EXPECT_EQ(audio, read);
+  }
+  reader.reset();
+  remove(filename.c_str());
+}
+
+TEST(FileAudioDeviceDriverTest, DrivesMultipleDevices) {
+  const std::string input =
+      test::TempFilename(test::OutputPath(), "file_audio_device_in");
+  WriteRampFile(input, kSampleRate / 10);
+  std::vector<std::string> outputs;
+  FileAudioDeviceDriver driver;
+  std::vector<FileFedDevice*> devices;
+  for (int i = 0; i < 3; ++i) {
+    outputs.push_back(
+        test::TempFilename(test::OutputPath(), "file_audio_device_out"));
+    devices.push_back(new FileFedDevice(input, outputs.back(), &driver));
+    ASSERT_TRUE(devices.back()->Start());
+  }
+  SleepMs(300);
+  for (size_t i = 0; i < devices.size(); ++i) {
+    devices[i]->Stop();
+    EXPECT_GT(devices[i]->transport().recorded_, 0);
+    EXPECT_GT(devices[i]->transport().played_, 0);
+    // Everything played out has been written when playout is stopped.
+    EXPECT_EQ(devices[i]->transport().played_ * kFramesPer10Ms * kChannels *
+                  sizeof(int16_t),
+              FileSize(outputs[i]));
+    delete devices[i];
+    remove(outputs[i].c_str());
+  }
+  remove(input.c_str());
+}
+
+// Runs 500 file fed devices for a few seconds, each with its own playout and
+// recording thread and with a shared FileAudioDeviceDriver, and prints the
+// CPU time used and the share of the expected 10 ms callbacks made.
+TEST(FileAudioDeviceDriverTest, DISABLED_FileFedDevicesBenchmark) {
+  const int kNumDevices = 500;
+  const int kRunTimeMs = 5000;
+  const std::string input =
+      test::TempFilename(test::OutputPath(), "file_audio_device_in");
+  WriteRampFile(input, kSampleRate * 2);
+
+  for (int shared = 0; shared < 2; ++shared) {
+    rtc::scoped_ptr<FileAudioDeviceDriver> driver(
+        shared ? new FileAudioDeviceDriver() : NULL);
+    std::vector<FileFedDevice*> devices;
+    std::vector<std::string> outputs;
+    for (int i = 0; i < kNumDevices; ++i) {
+      outputs.push_back(
+          test::TempFilename(test::OutputPath(), "file_audio_device_out"));
+      devices.push_back(new FileFedDevice(input, outputs.back(), driver.get()));
+    }
+
+    const clock_t start_cpu = clock();
+    for (int i = 0; i < kNumDevices; ++i)
+      ASSERT_TRUE(devices[i]->Start());
+    SleepMs(kRunTimeMs);
+    for (int i = 0; i < kNumDevices; ++i)
+      devices[i]->Stop();
+    const double cpu_ms =
+        1000.0 * (clock() - start_cpu) / CLOCKS_PER_SEC;
+
+    int callbacks = 0;
+    for (int i = 0; i < kNumDevices; ++i) {
+      callbacks += devices[i]->transport().recorded_ +
+                   devices[i]->transport().played_;
+      delete devices[i];
+      remove(outputs[i].c_str());
+    }
+    const int expected_callbacks = 2 * kNumDevices * kRunTimeMs / 10;
+    printf("%d devices, %s: %.0f ms CPU time for %d ms of audio, "
+           "%.1f%% of the expected callbacks made.\n",
+           kNumDevices, shared ? "shared driver thread" : "own threads",
+           cpu_ms, kRunTimeMs, 100.0 * callbacks / expected_callbacks);
+  }
+  remove(input.c_str());
+}
+
+}  // namespace webrtc
@@ -0,0 +1,423 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/dummy/virtual_audio_device.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/audio_device/dummy/buffered_pcm_file.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+
+namespace {
+const unsigned long kTickIntervalMs = 10;
+const int kFileBufferMs = 1000;
+// Nothing is done in Process(), so ask to be called rarely.
+const int64_t kProcessIntervalMs = 1000;
+}  // namespace
+
+MemoryAudioSource::MemoryAudioSource(const int16_t* audio,
+                                     size_t num_frames,
+                                     int num_channels)
+    : audio_(audio, audio + num_frames * num_channels),
+      num_channels_(num_channels),
+      position_(0) {}
+
+bool MemoryAudioSource::Read(int16_t* destination, size_t num_frames) {
+  if (audio_.empty())
+    return false;
+  size_t samples = num_frames * num_channels_;
+  while (samples > 0) {
+    const size_t chunk = std::min(samples, audio_.size() - position_);
+    memcpy(destination, &audio_[position_], chunk * sizeof(int16_t));
+    destination += chunk;
+    samples -= chunk;
+    position_ = (position_ + chunk) % audio_.size();
+  }
+  return true;
+}
+
+MemoryAudioSink::MemoryAudioSink(int num_channels, size_t max_frames)
+    : num_channels_(num_channels), max_frames_(max_frames), frames_written_(0) {
+  audio_.reserve(max_frames * num_channels);
+}
+
+void MemoryAudioSink::Write(const int16_t* source, size_t num_frames) {
+  rtc::CritScope cs(&lock_);
+  const size_t stored = audio_.size() / num_channels_;
+  const size_t frames = std::min(num_frames, max_frames_ - stored);
+  audio_.insert(audio_.end(), source, source + frames * num_channels_);
+  frames_written_ += num_frames;
+}
+
+std::vector<int16_t> MemoryAudioSink::audio() const {
+  rtc::CritScope cs(&lock_);
+  return audio_;
+}
+
+size_t MemoryAudioSink::frames_written() const {
+  rtc::CritScope cs(&lock_);
+  return frames_written_;
+}
+
+FileAudioSource* FileAudioSource::Create(const std::string& filename,
+                                         int sample_rate_hz,
+                                         int num_channels) {
+  BufferedPcmFileReader* reader = BufferedPcmFileReader::Create(
+      filename, sample_rate_hz, num_channels, kFileBufferMs);
+  return reader ? new FileAudioSource(reader) : NULL;
+}
+
+FileAudioSource::FileAudioSource(BufferedPcmFileReader* reader)
+    : reader_(reader) {}
+
+FileAudioSource::~FileAudioSource() {}
+
+bool FileAudioSource::Read(int16_t* destination, size_t num_frames) {
+  return reader_->Read(destination, num_frames);
+}
+
+FileAudioSink* FileAudioSink::Create(const std::string& filename,
+                                     int sample_rate_hz,
+                                     int num_channels) {
+  BufferedPcmFileWriter* writer = BufferedPcmFileWriter::Create(
+      filename, sample_rate_hz, num_channels, kFileBufferMs);
+  return writer ? new FileAudioSink(writer) : NULL;
+}
+
+FileAudioSink::FileAudioSink(BufferedPcmFileWriter* writer)
+    : writer_(writer) {}
+
+FileAudioSink::~FileAudioSink() {}
+
+void FileAudioSink::Write(const int16_t* source, size_t num_frames) {
+  writer_->Write(source, num_frames);
+}
+
+VirtualAudioScheduler::VirtualAudioScheduler()
+    : crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      timer_(EventTimerWrapper::Create()),
+      thread_(ThreadWrapper::CreateThread(&Run, this,
+                                          "webrtc_virtual_audio")),
+      next_device_(0),
+      processing_device_(NULL),
+      device_processed_(true, false) {
+  timer_->StartTimer(true, kTickIntervalMs);
+  thread_->Start();
+  thread_->SetPriority(kRealtimePriority);
+}
+
+VirtualAudioScheduler::~VirtualAudioScheduler() {
+  thread_->Stop();
+  timer_->StopTimer();
+}
+
+VirtualAudioScheduler::Stats VirtualAudioScheduler::GetStats() const {
+  CriticalSectionScoped lock(crit_sect_.get());
+  return stats_;
+}
+
+void VirtualAudioScheduler::AddDevice(VirtualAudioDevice* device) {
+  CriticalSectionScoped lock(crit_sect_.get());
+  devices_.push_back(device);
+}
+
+void VirtualAudioScheduler::RemoveDevice(VirtualAudioDevice* device) {
+  crit_sect_->Enter();
+  std::vector<VirtualAudioDevice*>::iterator it =
+      std::find(devices_.begin(), devices_.end(), device);
+  if (it != devices_.end()) {
+    if (static_cast<size_t>(it - devices_.begin()) < next_device_)
+      --next_device_;
+    devices_.erase(it);
+  }
+  // Devices are processed without |crit_sect_| held; wait for a
+  // Process10ms() call in progress on |device| to return.
+  while (processing_device_ == device) {
+    device_processed_.Reset();
+    crit_sect_->Leave();
+    device_processed_.Wait(rtc::Event::kForever);
+    crit_sect_->Enter();
+  }
+  crit_sect_->Leave();
+}
+
+bool VirtualAudioScheduler::Run(void* obj) {
+  return static_cast<VirtualAudioScheduler*>(obj)->Process();
+}
+
+bool VirtualAudioScheduler::Process() {
+  timer_->Wait(kTickIntervalMs * 2);
+  const uint64_t start_us = rtc::TimeMicros();
+  int64_t device_ticks = 0;
+  CriticalSectionScoped lock(crit_sect_.get());
+  // |next_device_| is adjusted by RemoveDevice(), so that devices can come and
+  // go while the lock is released to process one.
+  for (next_device_ = 0; next_device_ < devices_.size();) {
+    VirtualAudioDevice* device = devices_[next_device_++];
+    processing_device_ = device;
+    crit_sect_->Leave();
+    device->Process10ms();
+    crit_sect_->Enter();
+    processing_device_ = NULL;
+    device_processed_.Set();
+    ++device_ticks;
+  }
+  const int64_t tick_time_us =
+      static_cast<int64_t>(rtc::TimeMicros() - start_us);
+
+  ++stats_.ticks;
+  if (tick_time_us > static_cast<int64_t>(kTickIntervalMs) * 1000)
+    ++stats_.late_ticks;
+  stats_.device_ticks += device_ticks;
+  stats_.total_tick_time_us += tick_time_us;
+  stats_.max_tick_time_us = std::max(stats_.max_tick_time_us, tick_time_us);
+  return true;
+}
+
+VirtualAudioDevice::VirtualAudioDevice(VirtualAudioScheduler* scheduler,
+                                       int sample_rate_hz,
+                                       int num_channels)
+    : scheduler_(scheduler),
+      sample_rate_hz_(sample_rate_hz),
+      num_channels_(num_channels),
+      frames_per_10ms_(static_cast<size_t>(sample_rate_hz / 100)),
+      audio_callback_(NULL),
+      initialized_(false),
+      playout_initialized_(false),
+      recording_initialized_(false),
+      playing_(false),
+      recording_(false),
+      record_buffer_(frames_per_10ms_ * num_channels),
+      playout_buffer_(frames_per_10ms_ * num_channels) {
+  RTC_DCHECK(num_channels == 1 || num_channels == 2);
+  RTC_DCHECK_GT(frames_per_10ms_, 0u);
+  scheduler_->AddDevice(this);
+}
+
+VirtualAudioDevice::~VirtualAudioDevice() {
+  scheduler_->RemoveDevice(this);
+}
+
+void VirtualAudioDevice::SetSource(VirtualAudioSource* source) {
+  rtc::CritScope cs(&lock_);
+  source_.reset(source);
+}
+
+void VirtualAudioDevice::SetSink(VirtualAudioSink* sink) {
+  rtc::CritScope cs(&lock_);
+  sink_.reset(sink);
+}
+
+int64_t VirtualAudioDevice::TimeUntilNextProcess() {
+  return kProcessIntervalMs;
+}
+
+int32_t VirtualAudioDevice::RegisterAudioCallback(
+    AudioTransport* audio_callback) {
+  rtc::CritScope cs(&lock_);
+  audio_callback_ = audio_callback;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::Init() {
+  rtc::CritScope cs(&lock_);
+  initialized_ = true;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::Terminate() {
+  rtc::CritScope cs(&lock_);
+  playing_ = recording_ = false;
+  playout_initialized_ = recording_initialized_ = false;
+  initialized_ = false;
+  return 0;
+}
+
+bool VirtualAudioDevice::Initialized() const {
+  rtc::CritScope cs(&lock_);
+  return initialized_;
+}
+
+int32_t VirtualAudioDevice::PlayoutIsAvailable(bool* available) {
+  *available = true;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::InitPlayout() {
+  rtc::CritScope cs(&lock_);
+  if (playing_)
+    return -1;
+  playout_initialized_ = true;
+  return 0;
+}
+
+bool VirtualAudioDevice::PlayoutIsInitialized() const {
+  rtc::CritScope cs(&lock_);
+  return playout_initialized_;
+}
+
+int32_t VirtualAudioDevice::StartPlayout() {
+  rtc::CritScope cs(&lock_);
+  if (!playout_initialized_)
+    return -1;
+  playing_ = true;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::StopPlayout() {
+  rtc::CritScope cs(&lock_);
+  playing_ = false;
+  playout_initialized_ = false;
+  return 0;
+}
+
+bool VirtualAudioDevice::Playing() const {
+  rtc::CritScope cs(&lock_);
+  return playing_;
+}
+
+int32_t VirtualAudioDevice::RecordingIsAvailable(bool* available) {
+  *available = true;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::InitRecording() {
+  rtc::CritScope cs(&lock_);
+  if (recording_)
+    return -1;
+  recording_initialized_ = true;
+  return 0;
+}
+
+bool VirtualAudioDevice::RecordingIsInitialized() const {
+  rtc::CritScope cs(&lock_);
+  return recording_initialized_;
+}
+
+int32_t VirtualAudioDevice::StartRecording() {
+  rtc::CritScope cs(&lock_);
+  if (!recording_initialized_)
+    return -1;
+  recording_ = true;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::StopRecording() {
+  rtc::CritScope cs(&lock_);
+  recording_ = false;
+  recording_initialized_ = false;
+  return 0;
+}
+
+bool VirtualAudioDevice::Recording() const {
+  rtc::CritScope cs(&lock_);
+  return recording_;
+}
+
+int32_t VirtualAudioDevice::StereoPlayoutIsAvailable(bool* available) const {
+  *available = num_channels_ == 2;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::SetStereoPlayout(bool enable) {
+  // The channel count is fixed at construction.
+  return enable == (num_channels_ == 2) ? 0 : -1;
+}
+
+int32_t VirtualAudioDevice::StereoPlayout(bool* enabled) const {
+  *enabled = num_channels_ == 2;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::StereoRecordingIsAvailable(bool* available) const {
+  *available = num_channels_ == 2;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::SetStereoRecording(bool enable) {
+  return enable == (num_channels_ == 2) ? 0 : -1;
+}
+
+int32_t VirtualAudioDevice::StereoRecording(bool* enabled) const {
+  *enabled = num_channels_ == 2;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::PlayoutDelay(uint16_t* delay_ms) const {
+  *delay_ms = 0;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::RecordingDelay(uint16_t* delay_ms) const {
+  *delay_ms = 0;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::RecordingSampleRate(
+    uint32_t* samples_per_sec) const {
+  *samples_per_sec = sample_rate_hz_;
+  return 0;
+}
+
+int32_t VirtualAudioDevice::PlayoutSampleRate(uint32_t* samples_per_sec) const {
+  *samples_per_sec = sample_rate_hz_;
+  return 0;
+}
+
+void VirtualAudioDevice::Process10ms() {
+  // The buffers are only used on the scheduler thread. The transport is called
+  // without |lock_| held, like FileAudioDevice does, so that it can't
+  // deadlock against threads calling into the module.
+  AudioTransport* audio_callback;
+  bool recording;
+  bool playing;
+  {
+    rtc::CritScope cs(&lock_);
+    audio_callback = audio_callback_;
+    recording = recording_;
+    playing = playing_;
+    if (!audio_callback)
+      return;
+    if (recording &&
+        (!source_ || !source_->Read(&record_buffer_[0], frames_per_10ms_))) {
+      std::fill(record_buffer_.begin(), record_buffer_.end(), 0);
+    }
+  }
+  const size_t bytes_per_frame = num_channels_ * sizeof(int16_t);
+
+  if (recording) {
+    uint32_t new_mic_level = 0;
+    audio_callback->RecordedDataIsAvailable(
+        &record_buffer_[0], frames_per_10ms_, bytes_per_frame, num_channels_,
+        sample_rate_hz_, 0, 0, 0, false, new_mic_level);
+  }
+
+  if (playing) {
+    size_t frames_out = 0;
+    int64_t elapsed_time_ms = -1;
+    int64_t ntp_time_ms = -1;
+    audio_callback->NeedMorePlayData(
+        frames_per_10ms_, bytes_per_frame, num_channels_, sample_rate_hz_,
+        &playout_buffer_[0], frames_out, &elapsed_time_ms, &ntp_time_ms);
+    rtc::CritScope cs(&lock_);
+    if (sink_)
+      sink_->Write(&playout_buffer_[0], std::min(frames_out, frames_per_10ms_));
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,271 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_AUDIO_DEVICE_VIRTUAL_AUDIO_DEVICE_H
+#define WEBRTC_AUDIO_DEVICE_VIRTUAL_AUDIO_DEVICE_H
+
+#include <string>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_device/include/fake_audio_device.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+class BufferedPcmFileReader;
+class BufferedPcmFileWriter;
+class CriticalSectionWrapper;
+class EventTimerWrapper;
+class ThreadWrapper;
+class VirtualAudioDevice;
+
+// Provides the audio recorded by a VirtualAudioDevice. Implement this
+// interface to feed a device from a callback. Read() is called on the
+// scheduler thread.
+class VirtualAudioSource {
+ public:
+  virtual ~VirtualAudioSource() {}
+
+  // Fills |destination| with |num_frames| frames of interleaved audio in the
+  // format of the device. Returning false records silence.
+  virtual bool Read(int16_t* destination, size_t num_frames) = 0;
+};
+
+// Receives the audio played out by a VirtualAudioDevice. Implement this
+// interface to consume audio from a callback. Write() is called on the
+// scheduler thread.
+class VirtualAudioSink {
+ public:
+  virtual ~VirtualAudioSink() {}
+
+  virtual void Write(const int16_t* source, size_t num_frames) = 0;
+};
+
+// Plays a copy of the given audio in a loop.
+class MemoryAudioSource : public VirtualAudioSource {
+ public:
+  MemoryAudioSource(const int16_t* audio, size_t num_frames, int num_channels);
+
+  bool Read(int16_t* destination, size_t num_frames) override;
+
+ private:
+  const std::vector<int16_t> audio_;
+  const int num_channels_;
+  size_t position_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MemoryAudioSource);
+};
+
+// Collects played out audio in memory, dropping anything past |max_frames|.
+class MemoryAudioSink : public VirtualAudioSink {
+ public:
+  MemoryAudioSink(int num_channels, size_t max_frames);
+
+  void Write(const int16_t* source, size_t num_frames) override;
+
+  // Returns a copy of the audio collected so far.
+  std::vector<int16_t> audio() const;
+  size_t frames_written() const;
+
+ private:
+  const int num_channels_;
+  const size_t max_frames_;
+  mutable rtc::CriticalSection lock_;
+  std::vector<int16_t> audio_ GUARDED_BY(lock_);
+  size_t frames_written_ GUARDED_BY(lock_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MemoryAudioSink);
+};
+
+// Plays a raw PCM or WAV file in a loop, see BufferedPcmFileReader.
+class FileAudioSource : public VirtualAudioSource {
+ public:
+  // Returns NULL if the file can't be opened or has another format.
+  static FileAudioSource* Create(const std::string& filename,
+                                 int sample_rate_hz,
+                                 int num_channels);
+  ~FileAudioSource();
+
+  bool Read(int16_t* destination, size_t num_frames) override;
+
+ private:
+  explicit FileAudioSource(BufferedPcmFileReader* reader);
+
+  rtc::scoped_ptr<BufferedPcmFileReader> reader_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(FileAudioSource);
+};
+
+// Writes played out audio to a raw PCM file.
+class FileAudioSink : public VirtualAudioSink {
+ public:
+  // Returns NULL if the file can't be opened for writing.
+  static FileAudioSink* Create(const std::string& filename,
+                               int sample_rate_hz,
+                               int num_channels);
+  ~FileAudioSink();
+
+  void Write(const int16_t* source, size_t num_frames) override;
+
+ private:
+  explicit FileAudioSink(BufferedPcmFileWriter* writer);
+
+  rtc::scoped_ptr<BufferedPcmFileWriter> writer_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(FileAudioSink);
+};
+
+// Runs the 10 ms recording and playout callbacks of any number of
+// VirtualAudioDevices from one thread. The scheduler must outlive the devices
+// using it.
+class VirtualAudioScheduler {
+ public:
+  struct Stats {
+    Stats()
+        : ticks(0),
+          late_ticks(0),
+          device_ticks(0),
+          total_tick_time_us(0),
+          max_tick_time_us(0) {}
+
+    int64_t ticks;
+    // Ticks that took longer than the 10 ms tick interval to process.
+    int64_t late_ticks;
+    // Sum over all ticks of the number of devices processed.
+    int64_t device_ticks;
+    int64_t total_tick_time_us;
+    int64_t max_tick_time_us;
+  };
+
+  VirtualAudioScheduler();
+  ~VirtualAudioScheduler();
+
+  Stats GetStats() const;
+
+ private:
+  friend class VirtualAudioDevice;
+
+  // After RemoveDevice() has returned, |device| will not be processed again.
+  // RemoveDevice() must not be called on the scheduler thread.
+  void AddDevice(VirtualAudioDevice* device);
+  void RemoveDevice(VirtualAudioDevice* device);
+
+  static bool Run(void* obj);
+  bool Process();
+
+  rtc::scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  rtc::scoped_ptr<EventTimerWrapper> timer_;
+  rtc::scoped_ptr<ThreadWrapper> thread_;
+  std::vector<VirtualAudioDevice*> devices_;
+  // Index into |devices_| of the next device to process in the current tick.
+  size_t next_device_;
+  // The device in Process10ms(), if any. |device_processed_| is signaled when
+  // the call returns.
+  VirtualAudioDevice* processing_device_;
+  rtc::Event device_processed_;
+  Stats stats_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(VirtualAudioScheduler);
+};
+
+// An AudioDeviceModule without audio hardware, for servers terminating many
+// calls with one VoiceEngine per call. Recorded audio is taken from a
+// VirtualAudioSource and played out audio is handed to a VirtualAudioSink,
+// both driven by a shared VirtualAudioScheduler instead of threads of their
+// own. Without a source silence is recorded, and without a sink played out
+// audio is discarded.
+//
+// The AudioTransport is called on the scheduler thread without any lock held,
+// so a tick in progress may still call it right after playout or recording
+// has been stopped or the callback replaced.
+//
+// Unlike AudioDeviceModuleImpl the module is not reference counted; the owner
+// deletes it after the VoiceEngine using it has been terminated.
+class VirtualAudioDevice : public FakeAudioDeviceModule {
+ public:
+  VirtualAudioDevice(VirtualAudioScheduler* scheduler,
+                     int sample_rate_hz,
+                     int num_channels);
+  ~VirtualAudioDevice() override;
+
+  // Take ownership. May be called at any time; NULL removes the current one.
+  void SetSource(VirtualAudioSource* source);
+  void SetSink(VirtualAudioSink* sink);
+
+  int sample_rate_hz() const { return sample_rate_hz_; }
+  int num_channels() const { return num_channels_; }
+
+  // AudioDeviceModule implementation.
+  int64_t TimeUntilNextProcess() override;
+  int32_t RegisterAudioCallback(AudioTransport* audio_callback) override;
+  int32_t Init() override;
+  int32_t Terminate() override;
+  bool Initialized() const override;
+
+  int32_t PlayoutIsAvailable(bool* available) override;
+  int32_t InitPlayout() override;
+  bool PlayoutIsInitialized() const override;
+  int32_t StartPlayout() override;
+  int32_t StopPlayout() override;
+  bool Playing() const override;
+
+  int32_t RecordingIsAvailable(bool* available) override;
+  int32_t InitRecording() override;
+  bool RecordingIsInitialized() const override;
+  int32_t StartRecording() override;
+  int32_t StopRecording() override;
+  bool Recording() const override;
+
+  int32_t StereoPlayoutIsAvailable(bool* available) const override;
+  int32_t SetStereoPlayout(bool enable) override;
+  int32_t StereoPlayout(bool* enabled) const override;
+  int32_t StereoRecordingIsAvailable(bool* available) const override;
+  int32_t SetStereoRecording(bool enable) override;
+  int32_t StereoRecording(bool* enabled) const override;
+
+  int32_t PlayoutDelay(uint16_t* delay_ms) const override;
+  int32_t RecordingDelay(uint16_t* delay_ms) const override;
+  int32_t RecordingSampleRate(uint32_t* samples_per_sec) const override;
+  int32_t PlayoutSampleRate(uint32_t* samples_per_sec) const override;
+
+ private:
+  friend class VirtualAudioScheduler;
+
+  // Called by the scheduler every 10 ms.
+  void Process10ms();
+
+  VirtualAudioScheduler* const scheduler_;
+  const int sample_rate_hz_;
+  const int num_channels_;
+  const size_t frames_per_10ms_;
+
+  // Not held while calling the AudioTransport.
+  mutable rtc::CriticalSection lock_;
+  AudioTransport* audio_callback_ GUARDED_BY(lock_);
+  rtc::scoped_ptr<VirtualAudioSource> source_ GUARDED_BY(lock_);
+  rtc::scoped_ptr<VirtualAudioSink> sink_ GUARDED_BY(lock_);
+  bool initialized_ GUARDED_BY(lock_);
+  bool playout_initialized_ GUARDED_BY(lock_);
+  bool recording_initialized_ GUARDED_BY(lock_);
+  bool playing_ GUARDED_BY(lock_);
+  bool recording_ GUARDED_BY(lock_);
+  // Only used on the scheduler thread.
+  std::vector<int16_t> record_buffer_;
+  std::vector<int16_t> playout_buffer_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(VirtualAudioDevice);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_AUDIO_DEVICE_VIRTUAL_AUDIO_DEVICE_H
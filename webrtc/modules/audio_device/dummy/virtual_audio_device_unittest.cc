@@ -0,0 +1,335 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_device/dummy/virtual_audio_device.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kSampleRate = 16000;
+const size_t kFramesPer10Ms = kSampleRate / 100;
+
+// Remembers the first recorded sample and plays out a constant value.
+class LoopbackTransport : public AudioTransport {
+ public:
+  explicit LoopbackTransport(int16_t playout_value)
+      : playout_value_(playout_value),
+        first_recorded_(0),
+        recorded_(0),
+        played_(0) {}
+
+  int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                  const size_t nSamples,
+                                  const size_t nBytesPerSample,
+                                  const uint8_t nChannels,
+                                  const uint32_t samplesPerSec,
+                                  const uint32_t totalDelayMS,
+                                  const int32_t clockDrift,
+                                  const uint32_t currentMicLevel,
+                                  const bool keyPressed,
+                                  uint32_t& newMicLevel) override {
+    rtc::CritScope cs(&lock_);
+    EXPECT_EQ(kFramesPer10Ms, nSamples);
+    EXPECT_EQ(static_cast<uint32_t>(kSampleRate), samplesPerSec);
+    if (recorded_ == 0)
+      first_recorded_ = static_cast<const int16_t*>(audioSamples)[0];
+    ++recorded_;
+    return 0;
+  }
+
+  int32_t NeedMorePlayData(const size_t nSamples,
+                           const size_t nBytesPerSample,
+                           const uint8_t nChannels,
+                           const uint32_t samplesPerSec,
+                           void* audioSamples,
+                           size_t& nSamplesOut,
+                           int64_t* elapsed_time_ms,
+                           int64_t* ntp_time_ms) override {
+    rtc::CritScope cs(&lock_);
+    int16_t* samples = static_cast<int16_t*>(audioSamples);
+    for (size_t i = 0; i < nSamples * nChannels; ++i)
+      samples[i] = playout_value_;
+    nSamplesOut = nSamples;
+    ++played_;
+    return 0;
+  }
+
+  int16_t first_recorded() const {
+    rtc::CritScope cs(&lock_);
+    return first_recorded_;
+  }
+  int recorded() const {
+    rtc::CritScope cs(&lock_);
+    return recorded_;
+  }
+  int played() const {
+    rtc::CritScope cs(&lock_);
+    return played_;
+  }
+
+ private:
+  const int16_t playout_value_;
+  mutable rtc::CriticalSection lock_;
+  int16_t first_recorded_;
+  int recorded_;
+  int played_;
+};
+
+// Blocks in the first recording callback until released.
+class BlockingTransport : public AudioTransport {
+ public:
+  BlockingTransport()
+      : called_(true, false), released_(true, false), calls_(0) {}
+
+  int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                  const size_t nSamples,
+                                  const size_t nBytesPerSample,
+                                  const uint8_t nChannels,
+                                  const uint32_t samplesPerSec,
+                                  const uint32_t totalDelayMS,
+                                  const int32_t clockDrift,
+                                  const uint32_t currentMicLevel,
+                                  const bool keyPressed,
+                                  uint32_t& newMicLevel) override {
+    {
+      rtc::CritScope cs(&lock_);
+      ++calls_;
+    }
+    called_.Set();
+    EXPECT_TRUE(released_.Wait(1000));
+    return 0;
+  }
+
+  int32_t NeedMorePlayData(const size_t nSamples,
+                           const size_t nBytesPerSample,
+                           const uint8_t nChannels,
+                           const uint32_t samplesPerSec,
+                           void* audioSamples,
+                           size_t& nSamplesOut,
+                           int64_t* elapsed_time_ms,
+                           int64_t* ntp_time_ms) override {
+    nSamplesOut = 0;
+    return 0;
+  }
+
+  bool WaitForCall() { return called_.Wait(1000); }
+  void Release() { released_.Set(); }
+  int calls() const {
+    rtc::CritScope cs(&lock_);
+    return calls_;
+  }
+
+ private:
+  rtc::Event called_;
+  rtc::Event released_;
+  mutable rtc::CriticalSection lock_;
+  int calls_;
+};
+
+bool StartDevice(VirtualAudioDevice* device, AudioTransport* transport) {
+  return device->RegisterAudioCallback(transport) == 0 &&
+         device->Init() == 0 && device->InitPlayout() == 0 &&
+         device->InitRecording() == 0 && device->StartPlayout() == 0 &&
+         device->StartRecording() == 0;
+}
+
+}  // namespace
+
+TEST(VirtualAudioDeviceTest, MemorySourceLoops) {
+  const int16_t kAudio[] = {1, 2, 3, 4, 5, 6};
+  MemoryAudioSource source(kAudio, 3, 2);
+  int16_t read[10];
+  ASSERT_TRUE(source.Read(read, 5));
+  const int16_t kExpected[] = {1, 2, 3, 4, 5, 6, 1, 2, 3, 4};
+  EXPECT_EQ(0, memcmp(kExpected, read, sizeof(read)));
+
+  MemoryAudioSource empty(kAudio, 0, 1);
+  EXPECT_FALSE(empty.Read(read, 1));
+}
+
+TEST(VirtualAudioDeviceTest, MemorySinkStopsCollectingAtLimit) {
+  MemoryAudioSink sink(1, 5);
+  const int16_t kAudio[] = {1, 2, 3, 4};
+  sink.Write(kAudio, 4);
+  sink.Write(kAudio, 4);
+  EXPECT_EQ(8u, sink.frames_written());
+  const int16_t kExpected[] = {1, 2, 3, 4, 1};
+  EXPECT_EQ(std::vector<int16_t>(kExpected, kExpected + 5), sink.audio());
+}
+
+TEST(VirtualAudioDeviceTest, DrivesDevicesFromOneScheduler) {
+  VirtualAudioScheduler scheduler;
+  const int kNumDevices = 3;
+  std::vector<VirtualAudioDevice*> devices;
+  std::vector<LoopbackTransport*> transports;
+  std::vector<MemoryAudioSink*> sinks;
+  for (int i = 0; i < kNumDevices; ++i) {
+    devices.push_back(new VirtualAudioDevice(&scheduler, kSampleRate, 1));
+    transports.push_back(new LoopbackTransport(static_cast<int16_t>(i + 10)));
+    const int16_t source_value = static_cast<int16_t>(i + 100);
+    devices[i]->SetSource(new MemoryAudioSource(&source_value, 1, 1));
+    sinks.push_back(new MemoryAudioSink(1, kSampleRate));
+    devices[i]->SetSink(sinks[i]);
+    ASSERT_TRUE(StartDevice(devices[i], transports[i]));
+  }
+  SleepMs(200);
+
+  for (int i = 0; i < kNumDevices; ++i) {
+    devices[i]->StopRecording();
+    devices[i]->StopPlayout();
+    EXPECT_FALSE(devices[i]->Playing());
+    EXPECT_FALSE(devices[i]->Recording());
+    EXPECT_GT(transports[i]->recorded(), 0);
+    EXPECT_EQ(i + 100, transports[i]->first_recorded());
+    ASSERT_GT(transports[i]->played(), 0);
+    // Everything played out has reached the sink.
+    EXPECT_EQ(transports[i]->played() * kFramesPer10Ms,
+              sinks[i]->frames_written());
+    EXPECT_EQ(i + 10, sinks[i]->audio()[0]);
+  }
+
+  // Stopped devices are no longer called back.
+  const int played = transports[0]->played();
+  SleepMs(50);
+  EXPECT_EQ(played, transports[0]->played());
+  EXPECT_GE(scheduler.GetStats().device_ticks,
+            scheduler.GetStats().ticks * kNumDevices);
+
+  for (int i = 0; i < kNumDevices; ++i) {
+    delete devices[i];
+    delete transports[i];
+  }
+}
+
+TEST(VirtualAudioDeviceTest, RecordsSilenceWithoutSource) {
+  VirtualAudioScheduler scheduler;
+  VirtualAudioDevice device(&scheduler, kSampleRate, 1);
+  LoopbackTransport transport(0);
+  ASSERT_TRUE(StartDevice(&device, &transport));
+  SleepMs(50);
+  device.Terminate();
+  EXPECT_GT(transport.recorded(), 0);
+  EXPECT_EQ(0, transport.first_recorded());
+}
+
+TEST(VirtualAudioDeviceTest, CallsTransportWithoutLocks) {
+  VirtualAudioScheduler scheduler;
+  rtc::scoped_ptr<VirtualAudioDevice> device(
+      new VirtualAudioDevice(&scheduler, kSampleRate, 1));
+  BlockingTransport transport;
+  ASSERT_TRUE(StartDevice(device.get(), &transport));
+  ASSERT_TRUE(transport.WaitForCall());
+
+  // Neither the device nor the scheduler is locked by the blocked callback.
+  EXPECT_EQ(0, device->StopRecording());
+  EXPECT_EQ(0, device->StopPlayout());
+  scheduler.GetStats();
+  EXPECT_EQ(1, transport.calls());
+
+  transport.Release();
+  device.reset();
+  const int calls = transport.calls();
+  SleepMs(50);
+  EXPECT_EQ(calls, transport.calls());
+}
+
+TEST(VirtualAudioDeviceTest, FileSourceAndSink) {
+  const std::string input =
+      test::TempFilename(test::OutputPath(), "virtual_audio_in");
+  {
+    rtc::scoped_ptr<FileAudioSink> sink(
+        FileAudioSink::Create(input, kSampleRate, 1));
+    ASSERT_TRUE(sink.get() != NULL);
+    const int16_t kValue = 42;
+    sink->Write(&kValue, 1);
+  }
+  EXPECT_TRUE(FileAudioSource::Create(input + "_missing", kSampleRate, 1) ==
+              NULL);
+  rtc::scoped_ptr<FileAudioSource> source(
+      FileAudioSource::Create(input, kSampleRate, 1));
+  ASSERT_TRUE(source.get() != NULL);
+  int16_t read[3];
+  ASSERT_TRUE(source->Read(read, 3));
+  EXPECT_EQ(42, read[0]);
+  EXPECT_EQ(42, read[2]);
+  source.reset();
+  remove(input.c_str());
+}
+
+// Runs 1000 devices, as if terminating 1000 calls, from one scheduler thread
+// for a few seconds and prints the time spent per device and tick. Uses a
+// transport that does next to no work, so that the time is the scheduling
+// overhead.
+TEST(VirtualAudioDeviceTest, DISABLED_SchedulingOverheadBenchmark) {
+  const int kNumDevices = 1000;
+  const int kRunTimeMs = 5000;
+  VirtualAudioScheduler scheduler;
+  std::vector<VirtualAudioDevice*> devices;
+  std::vector<LoopbackTransport*> transports;
+  for (int i = 0; i < kNumDevices; ++i) {
+    devices.push_back(new VirtualAudioDevice(&scheduler, kSampleRate, 1));
+    transports.push_back(new LoopbackTransport(0));
+    devices[i]->RegisterAudioCallback(transports[i]);
+    devices[i]->InitPlayout();
+    devices[i]->InitRecording();
+  }
+
+  const VirtualAudioScheduler::Stats start_stats = scheduler.GetStats();
+  const clock_t start_cpu = clock();
+  for (int i = 0; i < kNumDevices; ++i) {
+    devices[i]->StartPlayout();
+    devices[i]->StartRecording();
+  }
+  SleepMs(kRunTimeMs);
+  for (int i = 0; i < kNumDevices; ++i)
+    devices[i]->Terminate();
+  const double cpu_ms = 1000.0 * (clock() - start_cpu) / CLOCKS_PER_SEC;
+  const VirtualAudioScheduler::Stats stats = scheduler.GetStats();
+
+  int callbacks = 0;
+  for (int i = 0; i < kNumDevices; ++i) {
+    callbacks += transports[i]->recorded() + transports[i]->played();
+    delete devices[i];
+    delete transports[i];
+  }
+  const int64_t ticks = stats.ticks - start_stats.ticks;
+  const int64_t device_ticks = stats.device_ticks - start_stats.device_ticks;
+  const int64_t tick_time_us =
+      stats.total_tick_time_us - start_stats.total_tick_time_us;
+  const int expected_callbacks = 2 * kNumDevices * kRunTimeMs / 10;
+  printf("%d devices: %.0f ms CPU time for %d ms of audio, "
+         "%.1f%% of the expected callbacks made.\n",
+         kNumDevices, cpu_ms, kRunTimeMs,
+         100.0 * callbacks / expected_callbacks);
+  printf("%lld ticks, %.2f us per device and tick, %.0f us average and "
+         "%lld us max per tick, %lld late ticks.\n",
+         static_cast<long long>(ticks),
+         device_ticks > 0 ? static_cast<double>(tick_time_us) / device_ticks
+                          : 0.0,
+         ticks > 0 ? static_cast<double>(tick_time_us) / ticks : 0.0,
+         static_cast<long long>(stats.max_tick_time_us),
+         static_cast<long long>(stats.late_ticks - start_stats.late_ticks));
+}
+
+}  // namespace webrtc
@@ -30,8 +30,7 @@ class FineAudioBuffer {
  public:
   // |device_buffer| is a buffer that provides 10ms of audio data.
   // |desired_frame_size_bytes| is the number of bytes of audio data
-  // GetPlayoutData() should return on success. It is also the required size of
-  // each recorded buffer used in DeliverRecordedData() calls.
+  // GetPlayoutData() should return on success.
   // |sample_rate| is the sample rate of the audio data. This is needed because
   // |device_buffer| delivers 10ms of data. Given the sample rate the number
   // of samples can be calculated.
@@ -49,7 +48,8 @@ class FineAudioBuffer {
   void ResetRecord();
 
   // |buffer| must be of equal or greater size than what is returned by
-  // RequiredBufferSize(). This is to avoid unnecessary memcpy.
+  // RequiredBufferSize(). Whole 10ms chunks are written directly to |buffer|
+  // by the WebRTC layer; only audio straddling the end of |buffer| is cached.
   void GetPlayoutData(int8_t* buffer);
 
   // Consumes the audio data in |buffer| and sends it to the WebRTC layer in
@@ -57,10 +57,10 @@ class FineAudioBuffer {
   // |record_delay_ms| are given to the AEC in the audio processing module.
   // They can be fixed values on most platforms and they are ignored if an
   // external (hardware/built-in) AEC is used.
-  // The size of |buffer| is given by |size_in_bytes| and must be equal to
-  // |desired_frame_size_bytes_|. A RTC_CHECK will be hit if this is not the
-  // case.
-  // Example: buffer size is 5ms => call #1 stores 5ms of data, call #2 stores
+  // |size_in_bytes| may differ between calls. 10ms chunks which lie entirely
+  // within |buffer| are delivered without being copied. The remainder is
+  // cached and completed by the next call.
+  // Example: buffer size is 5ms => call #1 caches 5ms of data, call #2 adds
   // 5ms of data and sends a total of 10ms to WebRTC and clears the intenal
   // cache. Call #3 restarts the scheme above.
   void DeliverRecordedData(const int8_t* buffer,
@@ -69,6 +69,13 @@ class FineAudioBuffer {
                            int record_delay_ms);
 
  private:
+  // Asks for 10ms of audio to be written to |buffer|. Returns false if the
+  // WebRTC layer had no audio to give.
+  bool RequestPlayout10Ms(int8_t* buffer);
+  void DeliverRecorded10Ms(const int8_t* buffer,
+                           int playout_delay_ms,
+                           int record_delay_ms);
+
   // Device buffer that works with 10ms chunks of data both for playout and
   // for recording. I.e., the WebRTC side will always be asked for audio to be
   // played out in 10ms chunks and recorded audio will be sent to WebRTC in
@@ -76,8 +83,7 @@ class FineAudioBuffer {
   // class and the owner must ensure that the pointer is valid during the life-
   // time of this object.
   AudioDeviceBuffer* const device_buffer_;
-  // Number of bytes delivered by GetPlayoutData() call and provided to
-  // DeliverRecordedData().
+  // Number of bytes delivered by GetPlayoutData() call.
   const size_t desired_frame_size_bytes_;
   // Sample rate in Hertz.
   const int sample_rate_;
@@ -85,22 +91,18 @@ class FineAudioBuffer {
   const size_t samples_per_10_ms_;
   // Number of audio bytes per 10ms.
   const size_t bytes_per_10_ms_;
-  // Storage for output samples that are not yet asked for.
+  // Storage for output samples that are not yet asked for. Holds at most one
+  // 10ms chunk.
   rtc::scoped_ptr<int8_t[]> playout_cache_buffer_;
   // Location of first unread output sample.
   size_t playout_cached_buffer_start_;
   // Number of bytes stored in output (contain samples to be played out) cache.
   size_t playout_cached_bytes_;
-  // Storage for input samples that are about to be delivered to the WebRTC
-  // ADB or remains from the last successful delivery of a 10ms audio buffer.
+  // Storage for the start of a 10ms chunk of input samples that hasn't been
+  // completely recorded yet.
   rtc::scoped_ptr<int8_t[]> record_cache_buffer_;
-  // Required (max) size in bytes of the |record_cache_buffer_|.
-  const size_t required_record_buffer_size_bytes_;
   // Number of bytes in input (contains recorded samples) cache.
   size_t record_cached_bytes_;
-  // Read and write pointers used in the buffering scheme on the recording side.
-  size_t record_read_pos_;
-  size_t record_write_pos_;
 };
 
 }  // namespace webrtc
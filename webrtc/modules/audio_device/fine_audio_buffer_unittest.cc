@@ -11,17 +11,21 @@
 #include "webrtc/modules/audio_device/fine_audio_buffer.h"
 
 #include <limits.h>
+#include <stdio.h>
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/audio_device/audio_device_buffer.h"
 #include "webrtc/modules/audio_device/mock_audio_device_buffer.h"
 
 using ::testing::_;
 using ::testing::AtLeast;
 using ::testing::InSequence;
-using ::testing::Return;
 
 namespace webrtc {
 
@@ -41,8 +45,8 @@ bool VerifyBuffer(const int8_t* buffer, int buffer_number, int size) {
   return true;
 }
 
-// This function replaces the real AudioDeviceBuffer::GetPlayoutData when it's
-// called (which is done implicitly when calling GetBufferData). It writes the
+// This function replaces the real AudioDeviceBuffer::RequestPlayoutBuffer when
+// it's called (which is done implicitly when calling GetPlayoutData). It writes the
 // sequence 0,1,..SCHAR_MAX-1,0,1,... to the buffer. Note that this is likely a
 // buffer of different size than the one VerifyBuffer verifies.
 // |iteration| is the number of calls made to UpdateBuffer prior to this call.
@@ -91,12 +95,11 @@ void RunFineBufferTest(int sample_rate, int frame_size_in_samples) {
       1 + ((kNumberOfFrames * frame_size_in_samples - 1) / kSamplesPer10Ms);
 
   MockAudioDeviceBuffer audio_device_buffer;
-  EXPECT_CALL(audio_device_buffer, RequestPlayoutData(_))
-      .WillRepeatedly(Return(kSamplesPer10Ms));
   {
     InSequence s;
     for (int i = 0; i < kNumberOfUpdateBufferCalls; ++i) {
-      EXPECT_CALL(audio_device_buffer, GetPlayoutData(_))
+      EXPECT_CALL(audio_device_buffer,
+                  RequestPlayoutBuffer(_, kSamplesPer10Ms))
           .WillOnce(UpdateBuffer(i, kSamplesPer10Ms))
           .RetiresOnSaturation();
     }
@@ -104,16 +107,14 @@ void RunFineBufferTest(int sample_rate, int frame_size_in_samples) {
   {
     InSequence s;
     for (int j = 0; j < kNumberOfUpdateBufferCalls - 1; ++j) {
-      EXPECT_CALL(audio_device_buffer, SetRecordedBuffer(_, kSamplesPer10Ms))
+      EXPECT_CALL(audio_device_buffer,
+                  DeliverRecordedBuffer(_, kSamplesPer10Ms))
           .WillOnce(VerifyInputBuffer(j, kSamplesPer10Ms))
           .RetiresOnSaturation();
     }
   }
   EXPECT_CALL(audio_device_buffer, SetVQEData(_, _, _))
       .Times(kNumberOfUpdateBufferCalls - 1);
-  EXPECT_CALL(audio_device_buffer, DeliverRecordedData())
-      .Times(kNumberOfUpdateBufferCalls - 1)
-      .WillRepeatedly(Return(kSamplesPer10Ms));
 
   FineAudioBuffer fine_buffer(&audio_device_buffer, kFrameSizeBytes,
                               sample_rate);
@@ -144,4 +145,161 @@ TEST(FineBufferTest, GreaterThan10ms) {
   RunFineBufferTest(kSampleRate, kFrameSizeSamples);
 }
 
+TEST(FineBufferTest, IrregularRecordedBufferSizes) {
+  const int kSampleRate = 48000;
+  const int kSamplesPer10Ms = kSampleRate * 10 / 1000;
+  const int kBytesPer10Ms = kSamplesPer10Ms * static_cast<int>(sizeof(int16_t));
+  // Includes buffers smaller than, equal to and spanning several 10ms chunks.
+  const size_t kSizes[] = {100, 1000, 7, 960, 2000, 13, 500};
+  size_t total_bytes = 0;
+  for (size_t i = 0; i < sizeof(kSizes) / sizeof(kSizes[0]); ++i)
+    total_bytes += kSizes[i];
+  const int kNumberOfChunks = static_cast<int>(total_bytes) / kBytesPer10Ms;
+
+  MockAudioDeviceBuffer audio_device_buffer;
+  {
+    InSequence s;
+    for (int j = 0; j < kNumberOfChunks; ++j) {
+      EXPECT_CALL(audio_device_buffer,
+                  DeliverRecordedBuffer(_, kSamplesPer10Ms))
+          .WillOnce(VerifyInputBuffer(j, kSamplesPer10Ms))
+          .RetiresOnSaturation();
+    }
+  }
+  EXPECT_CALL(audio_device_buffer, SetVQEData(_, _, _)).Times(kNumberOfChunks);
+
+  FineAudioBuffer fine_buffer(&audio_device_buffer, kBytesPer10Ms,
+                              kSampleRate);
+  // The input is one continuous ramp, see VerifyBuffer().
+  std::vector<int8_t> input(total_bytes);
+  UpdateInputBuffer(&input[0], 0, static_cast<int>(total_bytes));
+  size_t offset = 0;
+  for (size_t i = 0; i < sizeof(kSizes) / sizeof(kSizes[0]); ++i) {
+    fine_buffer.DeliverRecordedData(&input[offset], kSizes[i], 0, 0);
+    offset += kSizes[i];
+  }
+}
+
+namespace {
+
+// Counts the 10ms chunks exchanged with the AudioDeviceBuffer that were read
+// from or written to the device's buffer in place.
+class InPlaceCountingTransport : public AudioTransport {
+ public:
+  InPlaceCountingTransport()
+      : device_buffer_(NULL),
+        device_buffer_size_(0),
+        chunks_(0),
+        in_place_chunks_(0) {}
+
+  void SetDeviceBuffer(const void* buffer, size_t size) {
+    device_buffer_ = static_cast<const int8_t*>(buffer);
+    device_buffer_size_ = size;
+  }
+
+  int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                  const size_t nSamples,
+                                  const size_t nBytesPerSample,
+                                  const uint8_t nChannels,
+                                  const uint32_t samplesPerSec,
+                                  const uint32_t totalDelayMS,
+                                  const int32_t clockDrift,
+                                  const uint32_t currentMicLevel,
+                                  const bool keyPressed,
+                                  uint32_t& newMicLevel) override {
+    Count(audioSamples);
+    return 0;
+  }
+
+  int32_t NeedMorePlayData(const size_t nSamples,
+                           const size_t nBytesPerSample,
+                           const uint8_t nChannels,
+                           const uint32_t samplesPerSec,
+                           void* audioSamples,
+                           size_t& nSamplesOut,
+                           int64_t* elapsed_time_ms,
+                           int64_t* ntp_time_ms) override {
+    Count(audioSamples);
+    nSamplesOut = nSamples;
+    return 0;
+  }
+
+  int chunks() const { return chunks_; }
+  int in_place_chunks() const { return in_place_chunks_; }
+
+ private:
+  void Count(const void* audio) {
+    const int8_t* data = static_cast<const int8_t*>(audio);
+    ++chunks_;
+    if (data >= device_buffer_ && data < device_buffer_ + device_buffer_size_)
+      ++in_place_chunks_;
+  }
+
+  const int8_t* device_buffer_;
+  size_t device_buffer_size_;
+  int chunks_;
+  int in_place_chunks_;
+};
+
+}  // namespace
+
+// Feeds 48 kHz mono audio through a FineAudioBuffer and a real
+// AudioDeviceBuffer with 10ms, 5.3ms, 20.8ms and irregular device callbacks,
+// and prints the time per callback and the share of 10ms chunks that were
+// passed to or from the AudioTransport without an intermediate copy.
+TEST(FineBufferTest, DISABLED_CallbackSizeBenchmark) {
+  const int kSampleRate = 48000;
+  const size_t kBytesPer10Ms = kSampleRate / 100 * sizeof(int16_t);
+  const int kNumCallbacks = 200000;
+  // Device callback sizes in bytes. 0 means random sizes of up to 20ms for
+  // recording, with 10ms playout callbacks.
+  const size_t kCallbackSizes[] = {kBytesPer10Ms, 512, 2000, 0};
+
+  for (size_t c = 0; c < sizeof(kCallbackSizes) / sizeof(kCallbackSizes[0]);
+       ++c) {
+    const bool irregular = kCallbackSizes[c] == 0;
+    const size_t playout_size = irregular ? kBytesPer10Ms : kCallbackSizes[c];
+    InPlaceCountingTransport transport;
+    AudioDeviceBuffer audio_device_buffer;
+    audio_device_buffer.SetRecordingSampleRate(kSampleRate);
+    audio_device_buffer.SetPlayoutSampleRate(kSampleRate);
+    audio_device_buffer.SetRecordingChannels(1);
+    audio_device_buffer.SetPlayoutChannels(1);
+    audio_device_buffer.RegisterAudioCallback(&transport);
+    FineAudioBuffer fine_buffer(&audio_device_buffer, playout_size,
+                                kSampleRate);
+    std::vector<int8_t> device_buffer(
+        std::max(fine_buffer.RequiredPlayoutBufferSizeBytes(),
+                 2 * kBytesPer10Ms));
+    transport.SetDeviceBuffer(&device_buffer[0], device_buffer.size());
+
+    unsigned int seed = 17;
+    uint64_t playout_ns = 0;
+    uint64_t record_ns = 0;
+    for (int i = 0; i < kNumCallbacks; ++i) {
+      uint64_t start_ns = rtc::TimeNanos();
+      fine_buffer.GetPlayoutData(&device_buffer[0]);
+      playout_ns += rtc::TimeNanos() - start_ns;
+
+      seed = seed * 1103515245 + 12345;
+      const size_t record_size =
+          irregular ? 2 * ((seed >> 8) % kBytesPer10Ms + 1) : playout_size;
+      start_ns = rtc::TimeNanos();
+      fine_buffer.DeliverRecordedData(&device_buffer[0], record_size, 0, 0);
+      record_ns += rtc::TimeNanos() - start_ns;
+    }
+    if (irregular) {
+      printf("Irregular recording sizes: ");
+    } else {
+      printf("%.1f ms callbacks: ",
+             10.0 * kCallbackSizes[c] / kBytesPer10Ms);
+    }
+    printf("%.0f ns playout, %.0f ns recording per callback, "
+           "%.1f%% of 10 ms chunks in place.\n",
+           static_cast<double>(playout_ns) / kNumCallbacks,
+           static_cast<double>(record_ns) / kNumCallbacks,
+           100.0 * transport.in_place_chunks() / transport.chunks());
+  }
+}
+
 }  // namespace webrtc
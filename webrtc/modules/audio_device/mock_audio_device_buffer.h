@@ -27,6 +27,10 @@ class MockAudioDeviceBuffer : public AudioDeviceBuffer {
   MOCK_METHOD3(SetVQEData,
                void(int playDelayMS, int recDelayMS, int clockDrift));
   MOCK_METHOD0(DeliverRecordedData, int32_t());
+  MOCK_METHOD2(DeliverRecordedBuffer,
+               int32_t(const void* audioBuffer, size_t nSamples));
+  MOCK_METHOD2(RequestPlayoutBuffer,
+               int32_t(void* audioBuffer, size_t nSamples));
 };
 
 }  // namespace webrtc
@@ -265,7 +265,7 @@ AecmCore* WebRtcAecm_CreateCore() {
     }
 
     // Init some aecm pointers. 16 and 32 byte alignment is only necessary
-    // for Neon code currently.
+    // for Neon and SSE2 code currently.
     aecm->xBuf = (int16_t*) (((uintptr_t)aecm->xBuf_buf + 31) & ~ 31);
     aecm->dBufClean = (int16_t*) (((uintptr_t)aecm->dBufClean_buf + 31) & ~ 31);
     aecm->dBufNoisy = (int16_t*) (((uintptr_t)aecm->dBufNoisy_buf + 31) & ~ 31);
@@ -360,6 +360,16 @@ static void ResetAdaptiveChannelC(AecmCore* aecm) {
     aecm->channelAdapt32[i] = (int32_t)aecm->channelStored[i] << 16;
 }
 
+// Initialize function pointers for x86 SSE2 platform.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+static void WebRtcAecm_InitSSE2(void)
+{
+  WebRtcAecm_StoreAdaptiveChannel = WebRtcAecm_StoreAdaptiveChannelSSE2;
+  WebRtcAecm_ResetAdaptiveChannel = WebRtcAecm_ResetAdaptiveChannelSSE2;
+  WebRtcAecm_CalcLinearEnergies = WebRtcAecm_CalcLinearEnergiesSSE2;
+}
+#endif
+
 // Initialize function pointers for ARM Neon platform.
 #if (defined WEBRTC_DETECT_NEON || defined WEBRTC_HAS_NEON)
 static void WebRtcAecm_InitNeon(void)
@@ -508,6 +518,13 @@ int WebRtcAecm_InitCore(AecmCore* const aecm, int samplingFreq) {
     WebRtcAecm_StoreAdaptiveChannel = StoreAdaptiveChannelC;
     WebRtcAecm_ResetAdaptiveChannel = ResetAdaptiveChannelC;
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+      WebRtcAecm_InitSSE2();
+    }
+#endif
+
 #ifdef WEBRTC_DETECT_NEON
     uint64_t features = WebRtc_GetCPUFeaturesARM();
     if ((features & kCPUFeatureNEON) != 0)
@@ -74,7 +74,7 @@ typedef struct {
     int16_t echoStoredLogEnergy[MAX_BUF_LEN];
 
     // The extra 16 or 32 bytes in the following buffers are for alignment based
-    // Neon code.
+    // Neon and SSE2 code.
     // It's designed this way since the current GCC compiler can't align a
     // buffer in 16 or 32 byte boundaries properly.
     int16_t channelStored_buf[PART_LEN1 + 8];
@@ -398,8 +398,24 @@ typedef void (*ResetAdaptiveChannel)(AecmCore* aecm);
 extern ResetAdaptiveChannel WebRtcAecm_ResetAdaptiveChannel;
 
 // For the above function pointers, functions for generic platforms are declared
-// and defined as static in file aecm_core.c, while those for ARM Neon platforms
-// are declared below and defined in file aecm_core_neon.c.
+// and defined as static in file aecm_core.c, while those for x86 SSE2 and ARM
+// Neon platforms are declared below and defined in files aecm_core_sse2.c and
+// aecm_core_neon.c.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcAecm_CalcLinearEnergiesSSE2(AecmCore* aecm,
+                                       const uint16_t* far_spectrum,
+                                       int32_t* echo_est,
+                                       uint32_t* far_energy,
+                                       uint32_t* echo_energy_adapt,
+                                       uint32_t* echo_energy_stored);
+
+void WebRtcAecm_StoreAdaptiveChannelSSE2(AecmCore* aecm,
+                                         const uint16_t* far_spectrum,
+                                         int32_t* echo_est);
+
+void WebRtcAecm_ResetAdaptiveChannelSSE2(AecmCore* aecm);
+#endif
+
 #if defined(WEBRTC_DETECT_NEON) || defined(WEBRTC_HAS_NEON)
 void WebRtcAecm_CalcLinearEnergiesNeon(AecmCore* aecm,
                                        const uint16_t* far_spectrum,
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The SSE2 versions of the AECM channel functions, bit-exact with the C
+ * versions in aecm_core.c.
+ *
+ * Based on aecm_core_neon.c.
+ */
+
+#include "webrtc/modules/audio_processing/aecm/aecm_core.h"
+
+#include <assert.h>
+#include <emmintrin.h>
+
+// The products of the signed |channel| and the unsigned |spectrum| samples,
+// as in WEBRTC_SPL_MUL_16_U16(), in |low| and |high|.
+static __inline void MulChannelSpectrum(__m128i channel,
+                                        __m128i spectrum,
+                                        __m128i* low,
+                                        __m128i* high) {
+  // The unsigned high half is off by |spectrum| for negative channel values.
+  const __m128i product_low = _mm_mullo_epi16(channel, spectrum);
+  const __m128i product_high = _mm_sub_epi16(
+      _mm_mulhi_epu16(channel, spectrum),
+      _mm_and_si128(_mm_srai_epi16(channel, 15), spectrum));
+  *low = _mm_unpacklo_epi16(product_low, product_high);
+  *high = _mm_unpackhi_epi16(product_low, product_high);
+}
+
+// Adds up the lanes of |v|.
+static __inline uint32_t AddLanes(__m128i v) {
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (uint32_t)_mm_cvtsi128_si32(v);
+}
+
+void WebRtcAecm_CalcLinearEnergiesSSE2(AecmCore* aecm,
+                                       const uint16_t* far_spectrum,
+                                       int32_t* echo_est,
+                                       uint32_t* far_energy,
+                                       uint32_t* echo_energy_adapt,
+                                       uint32_t* echo_energy_stored) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i far_energy_v = zero;
+  __m128i echo_adapt_v = zero;
+  __m128i echo_stored_v = zero;
+  int i;
+
+  assert((uintptr_t)(aecm->channelStored) % 16 == 0);
+  assert((uintptr_t)(aecm->channelAdapt16) % 16 == 0);
+
+  // Get energy for the delayed far end signal and estimated
+  // echo using both stored and adapted channels.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i spectrum_v =
+        _mm_loadu_si128((const __m128i*)&far_spectrum[i]);
+    const __m128i stored_v =
+        _mm_load_si128((const __m128i*)&aecm->channelStored[i]);
+    const __m128i adapt_v =
+        _mm_load_si128((const __m128i*)&aecm->channelAdapt16[i]);
+    __m128i echo_est_low, echo_est_high, adapt_low, adapt_high;
+
+    MulChannelSpectrum(stored_v, spectrum_v, &echo_est_low, &echo_est_high);
+    _mm_storeu_si128((__m128i*)&echo_est[i], echo_est_low);
+    _mm_storeu_si128((__m128i*)&echo_est[i + 4], echo_est_high);
+    echo_stored_v = _mm_add_epi32(echo_stored_v,
+                                  _mm_add_epi32(echo_est_low, echo_est_high));
+
+    MulChannelSpectrum(adapt_v, spectrum_v, &adapt_low, &adapt_high);
+    echo_adapt_v = _mm_add_epi32(echo_adapt_v,
+                                 _mm_add_epi32(adapt_low, adapt_high));
+
+    far_energy_v = _mm_add_epi32(far_energy_v, _mm_add_epi32(
+        _mm_unpacklo_epi16(spectrum_v, zero),
+        _mm_unpackhi_epi16(spectrum_v, zero)));
+  }
+
+  echo_est[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                             far_spectrum[PART_LEN]);
+  *far_energy += AddLanes(far_energy_v) + (uint32_t)far_spectrum[PART_LEN];
+  *echo_energy_adapt += AddLanes(echo_adapt_v) +
+      aecm->channelAdapt16[PART_LEN] * far_spectrum[PART_LEN];
+  *echo_energy_stored += AddLanes(echo_stored_v) +
+      (uint32_t)echo_est[PART_LEN];
+}
+
+void WebRtcAecm_StoreAdaptiveChannelSSE2(AecmCore* aecm,
+                                         const uint16_t* far_spectrum,
+                                         int32_t* echo_est) {
+  int i;
+
+  assert((uintptr_t)(aecm->channelStored) % 16 == 0);
+  assert((uintptr_t)(aecm->channelAdapt16) % 16 == 0);
+
+  // During startup we store the channel every block, and recalculate the
+  // echo estimate.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i spectrum_v =
+        _mm_loadu_si128((const __m128i*)&far_spectrum[i]);
+    const __m128i adapt_v =
+        _mm_load_si128((const __m128i*)&aecm->channelAdapt16[i]);
+    __m128i echo_est_low, echo_est_high;
+
+    _mm_store_si128((__m128i*)&aecm->channelStored[i], adapt_v);
+    MulChannelSpectrum(adapt_v, spectrum_v, &echo_est_low, &echo_est_high);
+    _mm_storeu_si128((__m128i*)&echo_est[i], echo_est_low);
+    _mm_storeu_si128((__m128i*)&echo_est[i + 4], echo_est_high);
+  }
+  aecm->channelStored[PART_LEN] = aecm->channelAdapt16[PART_LEN];
+  echo_est[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                             far_spectrum[PART_LEN]);
+}
+
+void WebRtcAecm_ResetAdaptiveChannelSSE2(AecmCore* aecm) {
+  const __m128i zero = _mm_setzero_si128();
+  int i;
+
+  assert((uintptr_t)(aecm->channelStored) % 16 == 0);
+  assert((uintptr_t)(aecm->channelAdapt16) % 16 == 0);
+  assert((uintptr_t)(aecm->channelAdapt32) % 32 == 0);
+
+  // Reset the adaptive channel, and restore the W32 channel by putting the
+  // samples in the top halves.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i stored_v =
+        _mm_load_si128((const __m128i*)&aecm->channelStored[i]);
+    _mm_store_si128((__m128i*)&aecm->channelAdapt16[i], stored_v);
+    _mm_store_si128((__m128i*)&aecm->channelAdapt32[i],
+                    _mm_unpacklo_epi16(zero, stored_v));
+    _mm_store_si128((__m128i*)&aecm->channelAdapt32[i + 4],
+                    _mm_unpackhi_epi16(zero, stored_v));
+  }
+  aecm->channelAdapt16[PART_LEN] = aecm->channelStored[PART_LEN];
+  aecm->channelAdapt32[PART_LEN] = (int32_t)aecm->channelStored[PART_LEN] << 16;
+}
@@ -0,0 +1,169 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/aecm/include/echo_control_mobile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+#include "webrtc/modules/audio_processing/aecm/aecm_core.h"
+}
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRates[] = {8000, 16000};
+const int16_t kSoundCardDelayMs = 40;
+
+// Fills the far-end and near-end frames of |num_instances| instances. The
+// near-end is an attenuated and delayed far-end plus some noise.
+void GenerateFrames(size_t num_instances,
+                    size_t samples,
+                    int16_t* const* farend,
+                    int16_t* const* nearend) {
+  for (size_t n = 0; n < num_instances; ++n) {
+    for (size_t i = 0; i < samples; ++i) {
+      const int16_t echo = i >= 8 ? farend[n][i - 8] / 4 : 0;
+      farend[n][i] = static_cast<int16_t>(rand() % 16000 - 8000);
+      nearend[n][i] = static_cast<int16_t>(echo + rand() % 200 - 100);
+    }
+  }
+}
+
+}  // namespace
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+class EchoControlMobileSSE2Test : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    core_ = WebRtcAecm_CreateCore();
+    ASSERT_TRUE(core_ != NULL);
+    ASSERT_EQ(0, WebRtcAecm_InitCore(core_, 16000));
+    srand(42);
+    // Negative channel values don't occur in practice, but are covered for
+    // bit-exactness of the signed products.
+    for (int i = 0; i < PART_LEN1; ++i) {
+      core_->channelStored[i] = static_cast<int16_t>(rand() % 65536 - 32768);
+      core_->channelAdapt16[i] = static_cast<int16_t>(rand() % 65536 - 32768);
+      far_spectrum_[i] = static_cast<uint16_t>(rand() % 65536);
+    }
+  }
+
+  void TearDown() override { WebRtcAecm_FreeCore(core_); }
+
+  AecmCore* core_;
+  uint16_t far_spectrum_[PART_LEN1];
+};
+
+TEST_F(EchoControlMobileSSE2Test, CalcLinearEnergiesIsBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    return;
+  }
+  int32_t echo_est[PART_LEN1];
+  uint32_t far_energy = 1;
+  uint32_t echo_energy_adapt = 2;
+  uint32_t echo_energy_stored = 3;
+  uint32_t expected_far_energy = 1;
+  uint32_t expected_echo_energy_adapt = 2;
+  uint32_t expected_echo_energy_stored = 3;
+  WebRtcAecm_CalcLinearEnergiesSSE2(core_, far_spectrum_, echo_est,
+                                    &far_energy, &echo_energy_adapt,
+                                    &echo_energy_stored);
+  for (int i = 0; i < PART_LEN1; ++i) {
+    const int32_t expected_echo_est =
+        WEBRTC_SPL_MUL_16_U16(core_->channelStored[i], far_spectrum_[i]);
+    EXPECT_EQ(expected_echo_est, echo_est[i]);
+    expected_far_energy += far_spectrum_[i];
+    expected_echo_energy_adapt +=
+        core_->channelAdapt16[i] * far_spectrum_[i];
+    expected_echo_energy_stored += static_cast<uint32_t>(expected_echo_est);
+  }
+  EXPECT_EQ(expected_far_energy, far_energy);
+  EXPECT_EQ(expected_echo_energy_adapt, echo_energy_adapt);
+  EXPECT_EQ(expected_echo_energy_stored, echo_energy_stored);
+}
+
+TEST_F(EchoControlMobileSSE2Test, StoreAdaptiveChannelIsBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    return;
+  }
+  int32_t echo_est[PART_LEN1];
+  WebRtcAecm_StoreAdaptiveChannelSSE2(core_, far_spectrum_, echo_est);
+  for (int i = 0; i < PART_LEN1; ++i) {
+    EXPECT_EQ(core_->channelAdapt16[i], core_->channelStored[i]);
+    EXPECT_EQ(WEBRTC_SPL_MUL_16_U16(core_->channelAdapt16[i],
+                                    far_spectrum_[i]),
+              echo_est[i]);
+  }
+}
+
+TEST_F(EchoControlMobileSSE2Test, ResetAdaptiveChannelIsBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    return;
+  }
+  WebRtcAecm_ResetAdaptiveChannelSSE2(core_);
+  for (int i = 0; i < PART_LEN1; ++i) {
+    EXPECT_EQ(core_->channelStored[i], core_->channelAdapt16[i]);
+    EXPECT_EQ(static_cast<int32_t>(
+                  static_cast<uint32_t>(core_->channelStored[i]) << 16),
+              core_->channelAdapt32[i]);
+  }
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
+// Prints how many instances one core can run in real time.
+TEST(EchoControlMobileTest, DISABLED_InstancesPerCoreBenchmark) {
+  const size_t kNumInstances = 16;
+  const int kNumFrames = 3000;  // 30 seconds.
+  for (size_t r = 0; r < sizeof(kSampleRates) / sizeof(*kSampleRates); ++r) {
+    const size_t samples = static_cast<size_t>(kSampleRates[r] / 100);
+    void* handles[kNumInstances];
+    int16_t farend_data[kNumInstances][160];
+    int16_t nearend_data[kNumInstances][160];
+    int16_t out_data[kNumInstances][160];
+    int16_t* farend[kNumInstances];
+    int16_t* nearend[kNumInstances];
+    int16_t* out[kNumInstances];
+    for (size_t n = 0; n < kNumInstances; ++n) {
+      handles[n] = WebRtcAecm_Create();
+      ASSERT_EQ(0, WebRtcAecm_Init(handles[n], kSampleRates[r]));
+      farend[n] = farend_data[n];
+      nearend[n] = nearend_data[n];
+      out[n] = out_data[n];
+    }
+
+    srand(42);
+    int64_t elapsed_us = 0;
+    for (int frame = 0; frame < kNumFrames; ++frame) {
+      GenerateFrames(kNumInstances, samples, farend, nearend);
+      const TickTime start = TickTime::Now();
+      for (size_t n = 0; n < kNumInstances; ++n) {
+        WebRtcAecm_BufferFarend(handles[n], farend[n], samples);
+        WebRtcAecm_Process(handles[n], nearend[n], NULL, out[n], samples,
+                           kSoundCardDelayMs);
+      }
+      elapsed_us += (TickTime::Now() - start).Microseconds();
+    }
+    printf("%5d Hz: %.1f instances per core\n", kSampleRates[r],
+           kNumInstances * kNumFrames * 10000.0 / elapsed_us);
+
+    for (size_t n = 0; n < kNumInstances; ++n) {
+      WebRtcAecm_Free(handles[n]);
+    }
+  }
+}
+
+}  // namespace webrtc
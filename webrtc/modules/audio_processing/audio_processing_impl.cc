@@ -26,6 +26,7 @@ extern "C" {
 #include "webrtc/modules/audio_processing/audio_buffer.h"
 #include "webrtc/modules/audio_processing/beamformer/nonlinear_beamformer.h"
 #include "webrtc/modules/audio_processing/common.h"
+#include "webrtc/modules/audio_processing/debug_dump_writer.h"
 #include "webrtc/modules/audio_processing/echo_cancellation_impl.h"
 #include "webrtc/modules/audio_processing/echo_control_mobile_impl.h"
 #include "webrtc/modules/audio_processing/gain_control_impl.h"
@@ -192,8 +193,7 @@ AudioProcessingImpl::AudioProcessingImpl(const Config& config,
       voice_detection_(NULL),
       crit_(CriticalSectionWrapper::CreateCriticalSection()),
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-      debug_file_(FileWrapper::Create()),
-      event_msg_(new audioproc::Event()),
+      debug_dump_(new DebugDumpWriter(DebugDumpWriter::kDefaultQueueSize)),
 #endif
       api_format_({{{kSampleRate16kHz, 1, false},
                     {kSampleRate16kHz, 1, false},
@@ -267,8 +267,8 @@ AudioProcessingImpl::~AudioProcessingImpl() {
     }
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-    if (debug_file_->Open()) {
-      debug_file_->CloseFile();
+    if (debug_dump_->started()) {
+      debug_dump_->Stop();
     }
 #endif
   }
@@ -358,7 +358,7 @@ int AudioProcessingImpl::InitializeLocked() {
   InitializeIntelligibility();
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_file_->Open()) {
+  if (debug_dump_->started()) {
     int err = WriteInitMessage();
     if (err != kNoError) {
       return err;
@@ -538,11 +538,11 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
          api_format_.input_stream().num_frames());
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_file_->Open()) {
+  if (debug_dump_->started()) {
     RETURN_ON_ERR(WriteConfigMessage(false));
 
-    event_msg_->set_type(audioproc::Event::STREAM);
-    audioproc::Stream* msg = event_msg_->mutable_stream();
+    debug_dump_->event()->set_type(audioproc::Event::STREAM);
+    audioproc::Stream* msg = debug_dump_->event()->mutable_stream();
     const size_t channel_size =
         sizeof(float) * api_format_.input_stream().num_frames();
     for (int i = 0; i < api_format_.input_stream().num_channels(); ++i)
@@ -555,8 +555,8 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
   capture_audio_->CopyTo(api_format_.output_stream(), dest);
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_file_->Open()) {
-    audioproc::Stream* msg = event_msg_->mutable_stream();
+  if (debug_dump_->started()) {
+    audioproc::Stream* msg = debug_dump_->event()->mutable_stream();
     const size_t channel_size =
         sizeof(float) * api_format_.output_stream().num_frames();
     for (int i = 0; i < api_format_.output_stream().num_channels(); ++i)
@@ -600,9 +600,9 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
   }
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_file_->Open()) {
-    event_msg_->set_type(audioproc::Event::STREAM);
-    audioproc::Stream* msg = event_msg_->mutable_stream();
+  if (debug_dump_->started()) {
+    debug_dump_->event()->set_type(audioproc::Event::STREAM);
+    audioproc::Stream* msg = debug_dump_->event()->mutable_stream();
     const size_t data_size =
         sizeof(int16_t) * frame->samples_per_channel_ * frame->num_channels_;
     msg->set_input_data(frame->data_, data_size);
@@ -614,8 +614,8 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
   capture_audio_->InterleaveTo(frame, output_copy_needed(is_data_processed()));
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_file_->Open()) {
-    audioproc::Stream* msg = event_msg_->mutable_stream();
+  if (debug_dump_->started()) {
+    audioproc::Stream* msg = debug_dump_->event()->mutable_stream();
     const size_t data_size =
         sizeof(int16_t) * frame->samples_per_channel_ * frame->num_channels_;
     msg->set_output_data(frame->data_, data_size);
@@ -628,8 +628,8 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
 
 int AudioProcessingImpl::ProcessStreamLocked() {
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_file_->Open()) {
-    audioproc::Stream* msg = event_msg_->mutable_stream();
+  if (debug_dump_->started()) {
+    audioproc::Stream* msg = debug_dump_->event()->mutable_stream();
     msg->set_delay(stream_delay_ms_);
     msg->set_drift(echo_cancellation_->stream_drift_samples());
     msg->set_level(gain_control()->stream_analog_level());
@@ -759,9 +759,10 @@ int AudioProcessingImpl::AnalyzeReverseStream(
          api_format_.reverse_input_stream().num_frames());
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_file_->Open()) {
-    event_msg_->set_type(audioproc::Event::REVERSE_STREAM);
-    audioproc::ReverseStream* msg = event_msg_->mutable_reverse_stream();
+  if (debug_dump_->started()) {
+    debug_dump_->event()->set_type(audioproc::Event::REVERSE_STREAM);
+    audioproc::ReverseStream* msg =
+        debug_dump_->event()->mutable_reverse_stream();
     const size_t channel_size =
         sizeof(float) * api_format_.reverse_input_stream().num_frames();
     for (int i = 0; i < api_format_.reverse_input_stream().num_channels(); ++i)
@@ -821,9 +822,10 @@ int AudioProcessingImpl::AnalyzeReverseStream(AudioFrame* frame) {
   }
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_file_->Open()) {
-    event_msg_->set_type(audioproc::Event::REVERSE_STREAM);
-    audioproc::ReverseStream* msg = event_msg_->mutable_reverse_stream();
+  if (debug_dump_->started()) {
+    debug_dump_->event()->set_type(audioproc::Event::REVERSE_STREAM);
+    audioproc::ReverseStream* msg =
+        debug_dump_->event()->mutable_reverse_stream();
     const size_t data_size =
         sizeof(int16_t) * frame->samples_per_channel_ * frame->num_channels_;
     msg->set_data(frame->data_, data_size);
@@ -902,6 +904,12 @@ int AudioProcessingImpl::delay_offset_ms() const {
 
 int AudioProcessingImpl::StartDebugRecording(
     const char filename[AudioProcessing::kMaxFilenameSize]) {
+  return StartDebugRecording(filename, -1);
+}
+
+int AudioProcessingImpl::StartDebugRecording(
+    const char filename[AudioProcessing::kMaxFilenameSize],
+    int64_t max_log_size_bytes) {
   CriticalSectionScoped crit_scoped(crit_);
   static_assert(kMaxFilenameSize == FileWrapper::kMaxFileNameSize, "");
 
@@ -911,16 +919,18 @@ int AudioProcessingImpl::StartDebugRecording(
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
   // Stop any ongoing recording.
-  if (debug_file_->Open()) {
-    if (debug_file_->CloseFile() == -1) {
+  if (debug_dump_->started()) {
+    if (!debug_dump_->Stop()) {
       return kFileError;
     }
   }
 
-  if (debug_file_->OpenFile(filename, false) == -1) {
-    debug_file_->CloseFile();
+  rtc::scoped_ptr<FileWrapper> debug_file(FileWrapper::Create());
+  if (debug_file->OpenFile(filename, false) == -1) {
+    debug_file->CloseFile();
     return kFileError;
   }
+  debug_dump_->Start(debug_file.release(), max_log_size_bytes);
 
   RETURN_ON_ERR(WriteConfigMessage(true));
   RETURN_ON_ERR(WriteInitMessage());
@@ -931,6 +941,11 @@ int AudioProcessingImpl::StartDebugRecording(
 }
 
 int AudioProcessingImpl::StartDebugRecording(FILE* handle) {
+  return StartDebugRecording(handle, -1);
+}
+
+int AudioProcessingImpl::StartDebugRecording(FILE* handle,
+                                             int64_t max_log_size_bytes) {
   CriticalSectionScoped crit_scoped(crit_);
 
   if (handle == NULL) {
@@ -939,15 +954,17 @@ int AudioProcessingImpl::StartDebugRecording(FILE* handle) {
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
   // Stop any ongoing recording.
-  if (debug_file_->Open()) {
-    if (debug_file_->CloseFile() == -1) {
+  if (debug_dump_->started()) {
+    if (!debug_dump_->Stop()) {
       return kFileError;
     }
   }
 
-  if (debug_file_->OpenFromFileHandle(handle, true, false) == -1) {
+  rtc::scoped_ptr<FileWrapper> debug_file(FileWrapper::Create());
+  if (debug_file->OpenFromFileHandle(handle, true, false) == -1) {
     return kFileError;
   }
+  debug_dump_->Start(debug_file.release(), max_log_size_bytes);
 
   RETURN_ON_ERR(WriteConfigMessage(true));
   RETURN_ON_ERR(WriteInitMessage());
@@ -968,8 +985,8 @@ int AudioProcessingImpl::StopDebugRecording() {
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
   // We just return if recording hasn't started.
-  if (debug_file_->Open()) {
-    if (debug_file_->CloseFile() == -1) {
+  if (debug_dump_->started()) {
+    if (!debug_dump_->Stop()) {
       return kFileError;
     }
   }
@@ -1181,35 +1198,14 @@ void AudioProcessingImpl::UpdateHistogramsOnCallEnd() {
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
 int AudioProcessingImpl::WriteMessageToDebugFile() {
-  int32_t size = event_msg_->ByteSize();
-  if (size <= 0) {
-    return kUnspecifiedError;
-  }
-#if defined(WEBRTC_ARCH_BIG_ENDIAN)
-// TODO(ajm): Use little-endian "on the wire". For the moment, we can be
-//            pretty safe in assuming little-endian.
-#endif
-
-  if (!event_msg_->SerializeToString(&event_str_)) {
-    return kUnspecifiedError;
-  }
-
-  // Write message preceded by its size.
-  if (!debug_file_->Write(&size, sizeof(int32_t))) {
-    return kFileError;
-  }
-  if (!debug_file_->Write(event_str_.data(), event_str_.length())) {
-    return kFileError;
-  }
-
-  event_msg_->Clear();
-
+  // Serialization and file I/O happen on the writer thread.
+  debug_dump_->QueueEvent();
   return kNoError;
 }
 
 int AudioProcessingImpl::WriteInitMessage() {
-  event_msg_->set_type(audioproc::Event::INIT);
-  audioproc::Init* msg = event_msg_->mutable_init();
+  debug_dump_->event()->set_type(audioproc::Event::INIT);
+  audioproc::Init* msg = debug_dump_->event()->mutable_init();
   msg->set_sample_rate(api_format_.input_stream().sample_rate_hz());
   msg->set_num_input_channels(api_format_.input_stream().num_channels());
   msg->set_num_output_channels(api_format_.output_stream().num_channels());
@@ -1218,7 +1214,7 @@ int AudioProcessingImpl::WriteInitMessage() {
   msg->set_reverse_sample_rate(
       api_format_.reverse_input_stream().sample_rate_hz());
   msg->set_output_sample_rate(api_format_.output_stream().sample_rate_hz());
-  // TODO(ekmeyerson): Add reverse output fields to event_msg_.
+  // TODO(ekmeyerson): Add reverse output fields to the event.
 
   RETURN_ON_ERR(WriteMessageToDebugFile());
   return kNoError;
@@ -1262,8 +1258,8 @@ int AudioProcessingImpl::WriteConfigMessage(bool forced) {
 
   last_serialized_config_ = serialized_config;
 
-  event_msg_->set_type(audioproc::Event::CONFIG);
-  event_msg_->mutable_config()->CopyFrom(config);
+  debug_dump_->event()->set_type(audioproc::Event::CONFIG);
+  debug_dump_->event()->mutable_config()->CopyFrom(config);
 
   RETURN_ON_ERR(WriteMessageToDebugFile());
   return kNoError;
@@ -29,9 +29,9 @@ template<typename T>
 class Beamformer;
 
 class CriticalSectionWrapper;
+class DebugDumpWriter;
 class EchoCancellationImpl;
 class EchoControlMobileImpl;
-class FileWrapper;
 class GainControlImpl;
 class GainControlForNewAgc;
 class HighPassFilterImpl;
@@ -42,14 +42,6 @@ class TransientSuppressor;
 class VoiceDetectionImpl;
 class IntelligibilityEnhancer;
 
-#ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-namespace audioproc {
-
-class Event;
-
-}  // namespace audioproc
-#endif
-
 class AudioProcessingImpl : public AudioProcessing {
  public:
   explicit AudioProcessingImpl(const Config& config);
@@ -103,7 +95,10 @@ class AudioProcessingImpl : public AudioProcessing {
   int delay_offset_ms() const override;
   void set_stream_key_pressed(bool key_pressed) override;
   int StartDebugRecording(const char filename[kMaxFilenameSize]) override;
+  int StartDebugRecording(const char filename[kMaxFilenameSize],
+                          int64_t max_log_size_bytes) override;
   int StartDebugRecording(FILE* handle) override;
+  int StartDebugRecording(FILE* handle, int64_t max_log_size_bytes) override;
   int StartDebugRecordingForPlatformFile(rtc::PlatformFile handle) override;
   int StopDebugRecording() override;
   void UpdateHistogramsOnCallEnd() override;
@@ -168,9 +163,8 @@ class AudioProcessingImpl : public AudioProcessing {
   // regardless of the last saved.
   int WriteConfigMessage(bool forced);
 
-  rtc::scoped_ptr<FileWrapper> debug_file_;
-  rtc::scoped_ptr<audioproc::Event> event_msg_;  // Protobuf message.
-  std::string event_str_;  // Memory for protobuf serialization.
+  // Writes the events to the debug file on a background thread.
+  rtc::scoped_ptr<DebugDumpWriter> debug_dump_;
 
   // Serialized string of last saved APM configuration.
   std::string last_serialized_config_;
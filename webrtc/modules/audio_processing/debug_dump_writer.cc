@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/debug_dump_writer.h"
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/file_wrapper.h"
+#include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+// Files generated at build-time by the protobuf compiler.
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/modules/audio_processing/debug.pb.h"
+#else
+#include "webrtc/audio_processing/debug.pb.h"
+#endif
+
+namespace webrtc {
+namespace {
+
+// The writer thread wakes up at least this often to write queued events. It
+// is woken up earlier when the queue fills up.
+const unsigned long kWriteIntervalMs = 10;
+
+// Whether |event| describes the format or configuration of the streams.
+bool IsSetupEvent(const audioproc::Event& event) {
+  return event.has_type() && (event.type() == audioproc::Event::INIT ||
+                              event.type() == audioproc::Event::CONFIG);
+}
+
+}  // namespace
+
+const size_t DebugDumpWriter::kDefaultQueueSize;
+const size_t DebugDumpWriter::kReservedEvents;
+
+DebugDumpWriter::DebugDumpWriter(size_t queue_size)
+    : queue_size_(queue_size),
+      current_event_(nullptr),
+      write_pos_(0),
+      read_pos_(0),
+      overflowed_(false),
+      dropped_events_(0),
+      wake_event_(EventWrapper::Create()),
+      space_event_(EventWrapper::Create()),
+      max_log_size_bytes_(-1),
+      log_size_bytes_(0),
+      size_limit_reached_(false),
+      write_error_(false) {
+  RTC_DCHECK_GT(queue_size_, kReservedEvents);
+}
+
+DebugDumpWriter::~DebugDumpWriter() {
+  if (started())
+    Stop();
+}
+
+void DebugDumpWriter::Start(FileWrapper* file, int64_t max_log_size_bytes) {
+  RTC_DCHECK(!started());
+  RTC_DCHECK(file);
+  // The messages are allocated on first use, so that instances which never
+  // record don't pay for them.
+  if (events_.empty()) {
+    for (size_t i = 0; i < queue_size_; ++i)
+      events_.push_back(new audioproc::Event());
+    overflow_event_.reset(new audioproc::Event());
+  }
+  file_.reset(file);
+  max_log_size_bytes_ = max_log_size_bytes;
+  log_size_bytes_ = 0;
+  size_limit_reached_ = false;
+  write_error_ = false;
+  overflowed_ = false;
+  dropped_events_ = 0;
+
+  thread_ = ThreadWrapper::CreateThread(&DebugDumpWriter::WriterThread, this,
+                                        "DebugDumpWriter");
+  thread_->Start();
+}
+
+bool DebugDumpWriter::Stop() {
+  RTC_DCHECK(started());
+  wake_event_->Set();
+  thread_->Stop();
+  thread_.reset();
+
+  // The writer thread is gone; write whatever it left behind from here.
+  WriteQueuedEvents();
+  if (current_event_) {
+    // An event that was started but never queued.
+    current_event_->Clear();
+    current_event_ = nullptr;
+  }
+
+  if (overflowed_) {
+    LOG(LS_WARNING) << "Debug dump cut short because the writer fell behind; "
+                    << dropped_events_ << " events were dropped.";
+  }
+  if (size_limit_reached_) {
+    LOG(LS_INFO) << "Debug dump stopped at the size limit of "
+                 << max_log_size_bytes_ << " bytes.";
+  }
+
+  bool success = !write_error_;
+  if (file_->Flush() == -1 || file_->CloseFile() == -1)
+    success = false;
+  file_.reset();
+  return success;
+}
+
+audioproc::Event* DebugDumpWriter::event() {
+  RTC_DCHECK(started());
+  if (!current_event_) {
+    int write_pos = write_pos_;
+    int read_pos = rtc::AtomicOps::AcquireLoad(&read_pos_);
+    if (overflowed_ ||
+        QueuedEvents(read_pos, write_pos) >= queue_size_ - kReservedEvents) {
+      // The type of the event is not known yet. QueueEvent() moves it to the
+      // reserved slots if it turns out to be an INIT or CONFIG event.
+      current_event_ = overflow_event_.get();
+    } else {
+      current_event_ = events_[write_pos % queue_size_];
+    }
+  }
+  return current_event_;
+}
+
+void DebugDumpWriter::QueueEvent() {
+  // Makes sure an event has been picked, even if it was left empty.
+  event();
+
+  if (current_event_ == overflow_event_.get()) {
+    if (overflowed_ || !IsSetupEvent(*overflow_event_)) {
+      overflow_event_->Clear();
+      overflowed_ = true;
+      ++dropped_events_;
+      current_event_ = nullptr;
+      return;
+    }
+    while (QueuedEvents(rtc::AtomicOps::AcquireLoad(&read_pos_),
+                        write_pos_) == queue_size_) {
+      wake_event_->Set();
+      space_event_->Wait(kWriteIntervalMs);
+    }
+    // Swapping keeps the memory of both messages around for reuse.
+    events_[write_pos_ % queue_size_]->Swap(overflow_event_.get());
+  }
+
+  int write_pos = (write_pos_ + 1) % static_cast<int>(2 * queue_size_);
+  rtc::AtomicOps::ReleaseStore(&write_pos_, write_pos);
+  // The writer thread wakes up by itself often enough that it only needs
+  // a nudge when the queue is filling up.
+  int read_pos = rtc::AtomicOps::AcquireLoad(&read_pos_);
+  if (QueuedEvents(read_pos, write_pos) >= queue_size_ / 2)
+    wake_event_->Set();
+  current_event_ = nullptr;
+}
+
+bool DebugDumpWriter::WriterThread(void* obj) {
+  return static_cast<DebugDumpWriter*>(obj)->Process();
+}
+
+bool DebugDumpWriter::Process() {
+  wake_event_->Wait(kWriteIntervalMs);
+  WriteQueuedEvents();
+  space_event_->Set();
+  return true;
+}
+
+void DebugDumpWriter::WriteQueuedEvents() {
+  int read_pos = read_pos_;
+  int write_pos = rtc::AtomicOps::AcquireLoad(&write_pos_);
+  while (read_pos != write_pos) {
+    audioproc::Event* event = events_[read_pos % queue_size_];
+    if (!size_limit_reached_ && !write_error_)
+      write_error_ = !WriteEvent(*event);
+    // Clear() keeps the allocated memory, so that the producer can refill
+    // the message without allocating.
+    event->Clear();
+    read_pos = (read_pos + 1) % static_cast<int>(2 * queue_size_);
+    rtc::AtomicOps::ReleaseStore(&read_pos_, read_pos);
+    if (read_pos == write_pos)
+      write_pos = rtc::AtomicOps::AcquireLoad(&write_pos_);
+  }
+}
+
+bool DebugDumpWriter::WriteEvent(const audioproc::Event& event) {
+  if (!event.SerializeToString(&event_str_))
+    return false;
+  int32_t size = static_cast<int32_t>(event_str_.length());
+  if (size <= 0)
+    return true;
+#if defined(WEBRTC_ARCH_BIG_ENDIAN)
+// TODO(ajm): Use little-endian "on the wire". For the moment, we can be
+//            pretty safe in assuming little-endian.
+#endif
+
+  if (max_log_size_bytes_ >= 0 &&
+      log_size_bytes_ + static_cast<int64_t>(sizeof(size)) + size >
+          max_log_size_bytes_) {
+    size_limit_reached_ = true;
+    return true;
+  }
+
+  // Write message preceded by its size.
+  if (!file_->Write(&size, sizeof(size)) ||
+      !file_->Write(event_str_.data(), event_str_.length())) {
+    return false;
+  }
+  log_size_bytes_ += sizeof(size) + size;
+  return true;
+}
+
+size_t DebugDumpWriter::QueuedEvents(int read_pos, int write_pos) const {
+  const int kRange = static_cast<int>(2 * queue_size_);
+  return static_cast<size_t>((write_pos - read_pos + kRange) % kRange);
+}
+
+}  // namespace webrtc
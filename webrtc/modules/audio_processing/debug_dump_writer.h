@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_DEBUG_DUMP_WRITER_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_DEBUG_DUMP_WRITER_H_
+
+#include <string>
+
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class EventWrapper;
+class FileWrapper;
+class ThreadWrapper;
+
+namespace audioproc {
+
+class Event;
+
+}  // namespace audioproc
+
+// Writes audioproc::Event messages to a debug dump file on a background
+// thread, so that serialization and file I/O stay off the audio threads.
+//
+// Events are passed through a fixed-size ring of preallocated messages. The
+// producer fills the message returned by event() and hands it over with
+// QueueEvent(); neither call allocates once the ring is warm, and stream
+// events never block. The last kReservedEvents slots of the ring are kept
+// for INIT and CONFIG events, which are needed to make sense of the rest of
+// the dump; when even those are taken, QueueEvent() waits for the writer
+// thread. When the writer thread falls behind and a stream event does not
+// fit, the dump is cut short at that point rather than stalling the
+// producer or leaving a gap in the recorded audio: the event and all later
+// ones are dropped and counted.
+//
+// All methods must be called from the producer side, which is expected to
+// be serialized by the owner (AudioProcessingImpl holds its lock).
+class DebugDumpWriter {
+ public:
+  static const size_t kDefaultQueueSize = 1024;
+  static const size_t kReservedEvents = 16;
+
+  // |queue_size| must be larger than kReservedEvents.
+  explicit DebugDumpWriter(size_t queue_size);
+  ~DebugDumpWriter();
+
+  // Starts writing to |file|, which must be open for writing. Takes ownership
+  // of |file|. Writing stops once |max_log_size_bytes| have been written,
+  // unless it is negative. Any ongoing recording must be stopped first.
+  void Start(FileWrapper* file, int64_t max_log_size_bytes);
+
+  // Writes all queued events, then closes the file. Returns false if any
+  // write failed or the file could not be closed.
+  bool Stop();
+
+  bool started() const { return file_.get() != nullptr; }
+
+  // The message to fill in for the next event. The same message is returned
+  // until QueueEvent() is called.
+  audioproc::Event* event();
+
+  // Queues the message returned by event() for writing. Waits for the writer
+  // thread if an INIT or CONFIG event does not fit in the queue.
+  void QueueEvent();
+
+  // Number of events dropped since Start(), because a stream event did not
+  // fit in the queue and the dump was cut short.
+  int dropped_events() const { return dropped_events_; }
+
+ private:
+  static bool WriterThread(void* obj);
+  bool Process();
+
+  // Writes and recycles all events queued so far. Only called by the writer
+  // thread, or after it has been stopped.
+  void WriteQueuedEvents();
+  bool WriteEvent(const audioproc::Event& event);
+
+  // Number of queued events given the read and write positions, which run
+  // modulo 2 * |queue_size_| so that a full queue can be told from an empty
+  // one.
+  size_t QueuedEvents(int read_pos, int write_pos) const;
+
+  const size_t queue_size_;
+  ScopedVector<audioproc::Event> events_;
+  // Takes events while the queue is full. Its contents are discarded, unless
+  // it holds an INIT or CONFIG event, which is moved to the queue once there
+  // is room.
+  rtc::scoped_ptr<audioproc::Event> overflow_event_;
+  audioproc::Event* current_event_;
+
+  // Written by the producer and the writer thread respectively.
+  volatile int write_pos_;
+  volatile int read_pos_;
+  // Set when a stream event is dropped; no events are queued after that.
+  bool overflowed_;
+  int dropped_events_;
+
+  rtc::scoped_ptr<EventWrapper> wake_event_;
+  // Set by the writer thread after it has made room in the queue.
+  rtc::scoped_ptr<EventWrapper> space_event_;
+  rtc::scoped_ptr<ThreadWrapper> thread_;
+
+  // Set by Start() and Stop(); only written to by the writer thread while it
+  // runs.
+  rtc::scoped_ptr<FileWrapper> file_;
+  int64_t max_log_size_bytes_;
+  int64_t log_size_bytes_;
+  bool size_limit_reached_;
+  bool write_error_;
+  std::string event_str_;  // Memory for protobuf serialization.
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_DEBUG_DUMP_WRITER_H_
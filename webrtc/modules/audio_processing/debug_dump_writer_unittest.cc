@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/debug_dump_writer.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_processing/test/protobuf_utils.h"
+#include "webrtc/system_wrappers/interface/file_wrapper.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/modules/audio_processing/debug.pb.h"
+#else
+#include "webrtc/audio_processing/debug.pb.h"
+#endif
+
+namespace webrtc {
+namespace {
+
+const int kNumEvents = 1000;
+
+class DebugDumpWriterTest : public ::testing::Test {
+ protected:
+  DebugDumpWriterTest()
+      : filename_(test::TempFilename(test::OutputPath(), "debug_dump")) {}
+
+  ~DebugDumpWriterTest() { remove(filename_.c_str()); }
+
+  void Start(DebugDumpWriter* writer, int64_t max_log_size_bytes) {
+    rtc::scoped_ptr<FileWrapper> file(FileWrapper::Create());
+    ASSERT_EQ(0, file->OpenFile(filename_.c_str(), false));
+    writer->Start(file.release(), max_log_size_bytes);
+  }
+
+  // Queues |num_events| stream events with increasing delays.
+  static void QueueEvents(DebugDumpWriter* writer, int num_events) {
+    for (int i = 0; i < num_events; ++i) {
+      audioproc::Event* event = writer->event();
+      event->set_type(audioproc::Event::STREAM);
+      event->mutable_stream()->set_delay(i);
+      writer->QueueEvent();
+    }
+  }
+
+  // Reads back the delays of all events in the file, checking that they
+  // follow each other without gaps.
+  int ReadEvents() {
+    FILE* file = fopen(filename_.c_str(), "rb");
+    EXPECT_TRUE(file != NULL);
+    if (!file)
+      return 0;
+    audioproc::Event event;
+    int num_events = 0;
+    int last_delay = -1;
+    while (ReadMessageFromFile(file, &event)) {
+      EXPECT_EQ(audioproc::Event::STREAM, event.type());
+      EXPECT_EQ(last_delay + 1, event.stream().delay());
+      last_delay = event.stream().delay();
+      ++num_events;
+    }
+    fclose(file);
+    return num_events;
+  }
+
+  const std::string filename_;
+};
+
+TEST_F(DebugDumpWriterTest, WritesAllEventsInOrder) {
+  DebugDumpWriter writer(DebugDumpWriter::kDefaultQueueSize);
+  Start(&writer, -1);
+  EXPECT_TRUE(writer.started());
+  for (int i = 0; i < kNumEvents; ++i) {
+    audioproc::Event* event = writer.event();
+    event->set_type(audioproc::Event::STREAM);
+    event->mutable_stream()->set_delay(i);
+    // Filled in two steps, like the capture stream events.
+    EXPECT_EQ(event, writer.event());
+    event->mutable_stream()->set_drift(-i);
+    writer.QueueEvent();
+  }
+  EXPECT_TRUE(writer.Stop());
+  EXPECT_FALSE(writer.started());
+  EXPECT_EQ(0, writer.dropped_events());
+
+  FILE* file = fopen(filename_.c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  audioproc::Event event;
+  for (int i = 0; i < kNumEvents; ++i) {
+    ASSERT_TRUE(ReadMessageFromFile(file, &event));
+    EXPECT_EQ(i, event.stream().delay());
+    EXPECT_EQ(-i, event.stream().drift());
+  }
+  EXPECT_FALSE(ReadMessageFromFile(file, &event));
+  fclose(file);
+}
+
+TEST_F(DebugDumpWriterTest, CanBeRestarted) {
+  DebugDumpWriter writer(DebugDumpWriter::kDefaultQueueSize);
+  Start(&writer, -1);
+  QueueEvents(&writer, kNumEvents);
+  EXPECT_TRUE(writer.Stop());
+
+  // The second recording overwrites the first one.
+  Start(&writer, -1);
+  QueueEvents(&writer, kNumEvents / 2);
+  EXPECT_TRUE(writer.Stop());
+  EXPECT_EQ(kNumEvents / 2, ReadEvents());
+}
+
+TEST_F(DebugDumpWriterTest, StopsAtSizeLimit) {
+  const int64_t kMaxLogSizeBytes = 100;
+  DebugDumpWriter writer(DebugDumpWriter::kDefaultQueueSize);
+  Start(&writer, kMaxLogSizeBytes);
+  QueueEvents(&writer, kNumEvents);
+  EXPECT_TRUE(writer.Stop());
+
+  int num_events = ReadEvents();
+  EXPECT_GT(num_events, 0);
+  EXPECT_LT(num_events, kNumEvents);
+  FILE* file = fopen(filename_.c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  fseek(file, 0, SEEK_END);
+  EXPECT_LE(ftell(file), kMaxLogSizeBytes);
+  fclose(file);
+}
+
+TEST_F(DebugDumpWriterTest, StopsWhenQueueIsFull) {
+  const size_t kQueueSize = DebugDumpWriter::kReservedEvents + 4;
+  DebugDumpWriter writer(kQueueSize);
+  Start(&writer, -1);
+  QueueEvents(&writer, kNumEvents);
+  EXPECT_TRUE(writer.Stop());
+
+  // The file ends where the first event was dropped.
+  EXPECT_EQ(kNumEvents, ReadEvents() + writer.dropped_events());
+}
+
+TEST_F(DebugDumpWriterTest, NeverDropsConfigEvents) {
+  const size_t kQueueSize = DebugDumpWriter::kReservedEvents + 4;
+  const int kNumStreamEvents =
+      static_cast<int>(kQueueSize - DebugDumpWriter::kReservedEvents);
+  DebugDumpWriter writer(kQueueSize);
+  Start(&writer, -1);
+  // Fills the part of the queue that stream events may use, then queues more
+  // config events than there are reserved slots.
+  QueueEvents(&writer, kNumStreamEvents);
+  for (int i = 0; i < kNumEvents; ++i) {
+    audioproc::Event* event = writer.event();
+    event->set_type(audioproc::Event::CONFIG);
+    event->mutable_config()->set_ns_level(i);
+    writer.QueueEvent();
+  }
+  EXPECT_TRUE(writer.Stop());
+  EXPECT_EQ(0, writer.dropped_events());
+
+  FILE* file = fopen(filename_.c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  audioproc::Event event;
+  for (int i = 0; i < kNumStreamEvents; ++i) {
+    ASSERT_TRUE(ReadMessageFromFile(file, &event));
+    EXPECT_EQ(i, event.stream().delay());
+  }
+  for (int i = 0; i < kNumEvents; ++i) {
+    ASSERT_TRUE(ReadMessageFromFile(file, &event));
+    ASSERT_EQ(audioproc::Event::CONFIG, event.type());
+    EXPECT_EQ(i, event.config().ns_level());
+  }
+  EXPECT_FALSE(ReadMessageFromFile(file, &event));
+  fclose(file);
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -252,8 +252,12 @@ class MockAudioProcessing : public AudioProcessing {
       int());
   MOCK_METHOD1(StartDebugRecording,
       int(const char filename[kMaxFilenameSize]));
+  MOCK_METHOD2(StartDebugRecording,
+      int(const char filename[kMaxFilenameSize], int64_t max_log_size_bytes));
   MOCK_METHOD1(StartDebugRecording,
       int(FILE* handle));
+  MOCK_METHOD2(StartDebugRecording,
+      int(FILE* handle, int64_t max_log_size_bytes));
   MOCK_METHOD0(StopDebugRecording,
       int());
   MOCK_METHOD0(UpdateHistogramsOnCallEnd, void());
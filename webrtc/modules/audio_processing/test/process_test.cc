@@ -18,6 +18,7 @@
 #include <algorithm>
 
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/stringencode.h"
 #include "webrtc/common.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/modules/audio_processing/test/protobuf_utils.h"
@@ -115,6 +116,8 @@ void usage() {
   printf("  --no_progress      Suppress progress.\n");
   printf("  --raw_output       Raw output instead of WAV file.\n");
   printf("  --debug_file FILE  Dump a debug recording.\n");
+  printf("  --debug_file_max_size BYTES\n");
+  printf("                     Stop the debug recording at BYTES.\n");
 }
 
 static float MicLevel2Gain(int level) {
@@ -156,6 +159,8 @@ void void_main(int argc, char* argv[]) {
   const char* ns_prob_filename = NULL;
   const char* aecm_echo_path_in_filename = NULL;
   const char* aecm_echo_path_out_filename = NULL;
+  const char* debug_filename = NULL;
+  int64_t debug_file_max_size = -1;
 
   int32_t sample_rate_hz = 16000;
 
@@ -434,13 +439,25 @@ void void_main(int argc, char* argv[]) {
     } else if (strcmp(argv[i], "--debug_file") == 0) {
       i++;
       ASSERT_LT(i, argc) << "Specify filename after --debug_file";
-      ASSERT_EQ(apm->kNoError, apm->StartDebugRecording(argv[i]));
+      debug_filename = argv[i];
+
+    } else if (strcmp(argv[i], "--debug_file_max_size") == 0) {
+      i++;
+      ASSERT_LT(i, argc) << "Specify size after --debug_file_max_size";
+      ASSERT_TRUE(rtc::FromString(argv[i], &debug_file_max_size));
     } else {
       FAIL() << "Unrecognized argument " << argv[i];
     }
   }
   apm->SetExtraOptions(config);
 
+  // The recording is started once all options are known. With --perf, the
+  // timings include the cost of dumping.
+  if (debug_filename) {
+    ASSERT_EQ(apm->kNoError,
+              apm->StartDebugRecording(debug_filename, debug_file_max_size));
+  }
+
   // If we're reading a protobuf file, ensure a simulation hasn't also
   // been requested (which makes no sense...)
   ASSERT_FALSE(pb_filename && simulating);
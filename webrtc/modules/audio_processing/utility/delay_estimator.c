@@ -14,10 +14,7 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Number of right shifts for scaling is linearly depending on number of bits in
-// the far-end binary spectrum.
-static const int kShiftsAtZero = 13;  // Right shifts at zero binary spectrum.
-static const int kShiftsLinearSlope = 3;
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 static const int32_t kProbabilityOffset = 1024;  // 2 in Q9.
 static const int32_t kProbabilityLowerLimit = 8704;  // 17 in Q9.
@@ -59,10 +56,10 @@ static int BitCount(uint32_t u32) {
 //                            row the number of times the matrix row and the
 //                            input vector have the same value
 //
-static void BitCountComparison(uint32_t binary_vector,
-                               const uint32_t* binary_matrix,
-                               int matrix_size,
-                               int32_t* bit_counts) {
+void WebRtc_BitCountComparisonC(uint32_t binary_vector,
+                                const uint32_t* binary_matrix,
+                                int matrix_size,
+                                int32_t* bit_counts) {
   int n = 0;
 
   // Compare |binary_vector| with all rows of the |binary_matrix|
@@ -71,6 +68,120 @@ static void BitCountComparison(uint32_t binary_vector,
   }
 }
 
+void WebRtc_UpdateMeanBitCountsC(const int32_t* bit_counts,
+                                 const int* far_bit_counts,
+                                 int history_size,
+                                 int32_t* mean_bit_counts,
+                                 int* candidate_delay,
+                                 int32_t* value_best_candidate,
+                                 int32_t* value_worst_candidate) {
+  int i = 0;
+
+  // Update |mean_bit_counts|, which is the smoothed version of |bit_counts|.
+  for (i = 0; i < history_size; i++) {
+    // |bit_counts| is constrained to [0, 32], meaning we can smooth with a
+    // factor up to 2^26. We use Q9.
+    int32_t bit_count = (bit_counts[i] << 9);  // Q9.
+
+    // Update |mean_bit_counts| only when far-end signal has something to
+    // contribute. If |far_bit_counts| is zero the far-end signal is weak and
+    // we likely have a poor echo condition, hence don't update.
+    if (far_bit_counts[i] > 0) {
+      // Make number of right shifts piecewise linear w.r.t. |far_bit_counts|.
+      int shifts = kShiftsAtZero;
+      shifts -= (kShiftsLinearSlope * far_bit_counts[i]) >> 4;
+      WebRtc_MeanEstimatorFix(bit_count, shifts, &(mean_bit_counts[i]));
+    }
+  }
+
+  // Find |candidate_delay|, |value_best_candidate| and |value_worst_candidate|
+  // of |mean_bit_counts|.
+  *candidate_delay = -1;
+  *value_best_candidate = kMaxBitCountsQ9;
+  *value_worst_candidate = 0;
+  for (i = 0; i < history_size; i++) {
+    if (mean_bit_counts[i] < *value_best_candidate) {
+      *value_best_candidate = mean_bit_counts[i];
+      *candidate_delay = i;
+    }
+    if (mean_bit_counts[i] > *value_worst_candidate) {
+      *value_worst_candidate = mean_bit_counts[i];
+    }
+  }
+}
+
+void WebRtc_DecreaseHistogramC(float* histogram,
+                               int history_size,
+                               int candidate_delay,
+                               int last_delay,
+                               float decrease_in_last_set,
+                               float valley_depth) {
+  int i = 0;
+
+  for (i = 0; i < history_size; ++i) {
+    int is_in_last_set = (i >= last_delay - 2) &&
+        (i <= last_delay + 1) && (i != candidate_delay);
+    int is_in_candidate_set = (i >= candidate_delay - 2) &&
+        (i <= candidate_delay + 1);
+    histogram[i] -= decrease_in_last_set * is_in_last_set +
+        valley_depth * (!is_in_last_set && !is_in_candidate_set);
+    // No histogram bin can go below 0.
+    if (histogram[i] < 0) {
+      histogram[i] = 0;
+    }
+  }
+}
+
+WebRtcBitCountComparison WebRtc_BitCountComparison;
+WebRtcUpdateMeanBitCounts WebRtc_UpdateMeanBitCounts;
+WebRtcDecreaseHistogram WebRtc_DecreaseHistogram;
+
+static void InitFunctionPointers(void) {
+  WebRtc_BitCountComparison = WebRtc_BitCountComparisonC;
+  WebRtc_UpdateMeanBitCounts = WebRtc_UpdateMeanBitCountsC;
+  WebRtc_DecreaseHistogram = WebRtc_DecreaseHistogramC;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtc_InitDelayEstimator_SSE2();
+  }
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+  WebRtc_InitDelayEstimator_neon();
+#elif defined(WEBRTC_DETECT_NEON)
+  if ((WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) != 0) {
+    WebRtc_InitDelayEstimator_neon();
+  }
+#endif
+}
+
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+
+static void once(void (*func)(void)) {
+  static pthread_once_t lock = PTHREAD_ONCE_INIT;
+  pthread_once(&lock, func);
+}
+
+#elif defined(_WIN32)
+#include <windows.h>
+
+static void once(void (*func)(void)) {
+  // Same as in spl_init.c, as there's no race-free context in which to call
+  // InitializeCriticalSection().
+  static CRITICAL_SECTION lock = {(void *)((size_t)-1), -1, 0, 0, 0, 0};
+  static int done = 0;
+
+  EnterCriticalSection(&lock);
+  if (!done) {
+    func();
+    done = 1;
+  }
+  LeaveCriticalSection(&lock);
+}
+#endif  // WEBRTC_POSIX
+
 // Collects necessary statistics for the HistogramBasedValidation().  This
 // function has to be called prior to calling HistogramBasedValidation().  The
 // statistics updated and used by the HistogramBasedValidation() are:
@@ -96,7 +207,6 @@ static void UpdateRobustValidationStatistics(BinaryDelayEstimator* self,
   float decrease_in_last_set = valley_depth;
   const int max_hits_for_slow_change = (candidate_delay < self->last_delay) ?
       kMaxHitsWhenPossiblyNonCausal : kMaxHitsWhenPossiblyCausal;
-  int i = 0;
 
   assert(self->history_size == self->farend->history_size);
   // Reset |candidate_hits| if we have a new candidate.
@@ -129,20 +239,10 @@ static void UpdateRobustValidationStatistics(BinaryDelayEstimator* self,
         valley_level_q14) * kQ14Scaling;
   }
   // 4. All other bins are decreased with |valley_depth|.
-  // TODO(bjornv): Investigate how to make this loop more efficient.  Split up
-  // the loop?  Remove parts that doesn't add too much.
-  for (i = 0; i < self->history_size; ++i) {
-    int is_in_last_set = (i >= self->last_delay - 2) &&
-        (i <= self->last_delay + 1) && (i != candidate_delay);
-    int is_in_candidate_set = (i >= candidate_delay - 2) &&
-        (i <= candidate_delay + 1);
-    self->histogram[i] -= decrease_in_last_set * is_in_last_set +
-        valley_depth * (!is_in_last_set && !is_in_candidate_set);
-    // 5. No histogram bin can go below 0.
-    if (self->histogram[i] < 0) {
-      self->histogram[i] = 0;
-    }
-  }
+  // 5. No histogram bin can go below 0.
+  WebRtc_DecreaseHistogram(self->histogram, self->history_size,
+                           candidate_delay, self->last_delay,
+                           decrease_in_last_set, valley_depth);
 }
 
 // Validates the |candidate_delay|, estimated in WebRtc_ProcessBinarySpectrum(),
@@ -410,6 +510,8 @@ BinaryDelayEstimator* WebRtc_CreateBinaryDelayEstimator(
     return NULL;
   }
 
+  once(InitFunctionPointers);
+
   self->farend = farend;
   self->near_history_size = max_lookahead + 1;
   self->history_size = 0;
@@ -516,7 +618,6 @@ int WebRtc_SoftResetBinaryDelayEstimator(BinaryDelayEstimator* self,
 
 int WebRtc_ProcessBinarySpectrum(BinaryDelayEstimator* self,
                                  uint32_t binary_near_spectrum) {
-  int i = 0;
   int candidate_delay = -1;
   int valid_candidate = 0;
 
@@ -539,37 +640,17 @@ int WebRtc_ProcessBinarySpectrum(BinaryDelayEstimator* self,
   }
 
   // Compare with delayed spectra and store the |bit_counts| for each delay.
-  BitCountComparison(binary_near_spectrum, self->farend->binary_far_history,
-                     self->history_size, self->bit_counts);
-
-  // Update |mean_bit_counts|, which is the smoothed version of |bit_counts|.
-  for (i = 0; i < self->history_size; i++) {
-    // |bit_counts| is constrained to [0, 32], meaning we can smooth with a
-    // factor up to 2^26. We use Q9.
-    int32_t bit_count = (self->bit_counts[i] << 9);  // Q9.
-
-    // Update |mean_bit_counts| only when far-end signal has something to
-    // contribute. If |far_bit_counts| is zero the far-end signal is weak and
-    // we likely have a poor echo condition, hence don't update.
-    if (self->farend->far_bit_counts[i] > 0) {
-      // Make number of right shifts piecewise linear w.r.t. |far_bit_counts|.
-      int shifts = kShiftsAtZero;
-      shifts -= (kShiftsLinearSlope * self->farend->far_bit_counts[i]) >> 4;
-      WebRtc_MeanEstimatorFix(bit_count, shifts, &(self->mean_bit_counts[i]));
-    }
-  }
-
-  // Find |candidate_delay|, |value_best_candidate| and |value_worst_candidate|
-  // of |mean_bit_counts|.
-  for (i = 0; i < self->history_size; i++) {
-    if (self->mean_bit_counts[i] < value_best_candidate) {
-      value_best_candidate = self->mean_bit_counts[i];
-      candidate_delay = i;
-    }
-    if (self->mean_bit_counts[i] > value_worst_candidate) {
-      value_worst_candidate = self->mean_bit_counts[i];
-    }
-  }
+  WebRtc_BitCountComparison(binary_near_spectrum,
+                            self->farend->binary_far_history,
+                            self->history_size, self->bit_counts);
+
+  // Update |mean_bit_counts|, which is the smoothed version of |bit_counts|,
+  // and find |candidate_delay|, |value_best_candidate| and
+  // |value_worst_candidate| of it.
+  WebRtc_UpdateMeanBitCounts(self->bit_counts, self->farend->far_bit_counts,
+                             self->history_size, self->mean_bit_counts,
+                             &candidate_delay, &value_best_candidate,
+                             &value_worst_candidate);
   valley_depth = value_worst_candidate - value_best_candidate;
 
   // The |value_best_candidate| is a good indicator on the probability of
@@ -18,6 +18,11 @@
 
 static const int32_t kMaxBitCountsQ9 = (32 << 9);  // 32 matching bits in Q9.
 
+// Number of right shifts for scaling is linearly depending on number of bits in
+// the far-end binary spectrum.
+static const int kShiftsAtZero = 13;  // Right shifts at zero binary spectrum.
+static const int kShiftsLinearSlope = 3;
+
 typedef struct {
   // Pointer to bit counts.
   int* far_bit_counts;
@@ -248,4 +253,63 @@ void WebRtc_MeanEstimatorFix(int32_t new_value,
                              int factor,
                              int32_t* mean_value);
 
+// The loops over the history in WebRtc_ProcessBinarySpectrum(...), with SSE2
+// and Neon versions. The pointers are set once, when the first
+// BinaryDelayEstimator is created; the C versions are exposed for testing.
+//
+// Counts, for each of the |matrix_size| rows of |binary_matrix|, the number of
+// bits differing from |binary_vector| into |bit_counts|.
+typedef void (*WebRtcBitCountComparison)(uint32_t binary_vector,
+                                         const uint32_t* binary_matrix,
+                                         int matrix_size,
+                                         int32_t* bit_counts);
+extern WebRtcBitCountComparison WebRtc_BitCountComparison;
+void WebRtc_BitCountComparisonC(uint32_t binary_vector,
+                                const uint32_t* binary_matrix,
+                                int matrix_size,
+                                int32_t* bit_counts);
+// Smooths |bit_counts| into |mean_bit_counts| where the far-end has bits set,
+// and returns the first delay with the smallest mean through
+// |candidate_delay| (-1 if none is below kMaxBitCountsQ9), that mean through
+// |value_best_candidate| and the largest mean through
+// |value_worst_candidate|. All means must be within [0, kMaxBitCountsQ9].
+typedef void (*WebRtcUpdateMeanBitCounts)(const int32_t* bit_counts,
+                                          const int* far_bit_counts,
+                                          int history_size,
+                                          int32_t* mean_bit_counts,
+                                          int* candidate_delay,
+                                          int32_t* value_best_candidate,
+                                          int32_t* value_worst_candidate);
+extern WebRtcUpdateMeanBitCounts WebRtc_UpdateMeanBitCounts;
+void WebRtc_UpdateMeanBitCountsC(const int32_t* bit_counts,
+                                 const int* far_bit_counts,
+                                 int history_size,
+                                 int32_t* mean_bit_counts,
+                                 int* candidate_delay,
+                                 int32_t* value_best_candidate,
+                                 int32_t* value_worst_candidate);
+// Decreases the |histogram| bins around |last_delay|, other than
+// |candidate_delay|, with |decrease_in_last_set| and all the bins outside
+// both neighborhoods with |valley_depth|, without going below zero.
+typedef void (*WebRtcDecreaseHistogram)(float* histogram,
+                                        int history_size,
+                                        int candidate_delay,
+                                        int last_delay,
+                                        float decrease_in_last_set,
+                                        float valley_depth);
+extern WebRtcDecreaseHistogram WebRtc_DecreaseHistogram;
+void WebRtc_DecreaseHistogramC(float* histogram,
+                               int history_size,
+                               int candidate_delay,
+                               int last_delay,
+                               float decrease_in_last_set,
+                               float valley_depth);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtc_InitDelayEstimator_SSE2(void);
+#endif
+#if defined(WEBRTC_DETECT_NEON) || defined(WEBRTC_HAS_NEON)
+void WebRtc_InitDelayEstimator_neon(void);
+#endif
+
 #endif  // WEBRTC_MODULES_AUDIO_PROCESSING_UTILITY_DELAY_ESTIMATOR_H_
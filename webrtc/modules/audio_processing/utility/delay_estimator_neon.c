@@ -0,0 +1,181 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The Neon versions of the loops over the delay history of the binary delay
+ * estimator, bit-exact with the C versions in delay_estimator.c.
+ *
+ * Based on delay_estimator_sse2.c.
+ */
+
+#include <arm_neon.h>
+#include <limits.h>
+
+#include "webrtc/modules/audio_processing/utility/delay_estimator.h"
+
+// The minimum and maximum of the lanes.
+static __inline int32_t HorizontalMin(int32x4_t v) {
+  int32x2_t m = vpmin_s32(vget_low_s32(v), vget_high_s32(v));
+  m = vpmin_s32(m, m);
+  return vget_lane_s32(m, 0);
+}
+
+static __inline int32_t HorizontalMax(int32x4_t v) {
+  int32x2_t m = vpmax_s32(vget_low_s32(v), vget_high_s32(v));
+  m = vpmax_s32(m, m);
+  return vget_lane_s32(m, 0);
+}
+
+static void BitCountComparisonNeon(uint32_t binary_vector,
+                                   const uint32_t* binary_matrix,
+                                   int matrix_size,
+                                   int32_t* bit_counts) {
+  const uint32x4_t vector = vdupq_n_u32(binary_vector);
+  int n = 0;
+
+  for (; n + 4 <= matrix_size; n += 4) {
+    const uint8x16_t bits = vreinterpretq_u8_u32(
+        veorq_u32(vector, vld1q_u32(&binary_matrix[n])));
+    const uint32x4_t counts = vpaddlq_u16(vpaddlq_u8(vcntq_u8(bits)));
+    vst1q_s32(&bit_counts[n], vreinterpretq_s32_u32(counts));
+  }
+  for (; n < matrix_size; n++) {
+    const uint8x8_t bits = vreinterpret_u8_u32(
+        vdup_n_u32(binary_vector ^ binary_matrix[n]));
+    // Both halves hold the same word, so take the count of one of them.
+    const uint32x2_t counts = vpaddl_u16(vpaddl_u8(vcnt_u8(bits)));
+    bit_counts[n] = (int32_t)vget_lane_u32(counts, 0);
+  }
+}
+
+static void UpdateMeanBitCountsNeon(const int32_t* bit_counts,
+                                    const int* far_bit_counts,
+                                    int history_size,
+                                    int32_t* mean_bit_counts,
+                                    int* candidate_delay,
+                                    int32_t* value_best_candidate,
+                                    int32_t* value_worst_candidate) {
+  const int32x4_t zero = vdupq_n_s32(0);
+  int32x4_t best = vdupq_n_s32(kMaxBitCountsQ9);
+  int32x4_t best_delay = vdupq_n_s32(-1);
+  int32x4_t worst = zero;
+  int32x4_t delay = { 0, 1, 2, 3 };
+  int best_candidate = -1;
+  int32_t value_best = kMaxBitCountsQ9;
+  int32_t value_worst = 0;
+  int i = 0;
+
+  for (; i + 4 <= history_size; i += 4) {
+    const int32x4_t far_counts = vld1q_s32((const int32_t*)&far_bit_counts[i]);
+    const int32x4_t bit_count = vshlq_n_s32(vld1q_s32(&bit_counts[i]), 9);
+    int32x4_t mean = vld1q_s32(&mean_bit_counts[i]);
+    const int32x4_t diff = vsubq_s32(bit_count, mean);
+    // A negative shift count shifts to the right.
+    const int32x4_t shifts = vsubq_s32(
+        vshrq_n_s32(vmulq_n_s32(far_counts, kShiftsLinearSlope), 4),
+        vdupq_n_s32(kShiftsAtZero));
+    const int32x4_t step = vshlq_s32(vabsq_s32(diff), shifts);
+    // Only update where the far-end has something to contribute.
+    const uint32x4_t update = vcgtq_s32(far_counts, zero);
+    mean = vaddq_s32(mean, vbslq_s32(
+        update, vbslq_s32(vcltq_s32(diff, zero), vnegq_s32(step), step),
+        zero));
+    vst1q_s32(&mean_bit_counts[i], mean);
+
+    {
+      const uint32x4_t better = vcltq_s32(mean, best);
+      best = vbslq_s32(better, mean, best);
+      best_delay = vbslq_s32(better, delay, best_delay);
+      worst = vmaxq_s32(worst, mean);
+      delay = vaddq_s32(delay, vdupq_n_s32(4));
+    }
+  }
+
+  if (i > 0) {
+    // The first delay among the lanes holding the smallest mean.
+    value_best = HorizontalMin(best);
+    best_candidate = HorizontalMin(vbslq_s32(
+        vceqq_s32(best, vdupq_n_s32(value_best)), best_delay,
+        vdupq_n_s32(INT_MAX)));
+    value_worst = HorizontalMax(worst);
+  }
+
+  for (; i < history_size; i++) {
+    if (far_bit_counts[i] > 0) {
+      int shifts = kShiftsAtZero;
+      shifts -= (kShiftsLinearSlope * far_bit_counts[i]) >> 4;
+      WebRtc_MeanEstimatorFix(bit_counts[i] << 9, shifts, &mean_bit_counts[i]);
+    }
+    if (mean_bit_counts[i] < value_best) {
+      value_best = mean_bit_counts[i];
+      best_candidate = i;
+    }
+    if (mean_bit_counts[i] > value_worst) {
+      value_worst = mean_bit_counts[i];
+    }
+  }
+
+  *candidate_delay = best_candidate;
+  *value_best_candidate = value_best;
+  *value_worst_candidate = value_worst;
+}
+
+static void DecreaseHistogramNeon(float* histogram,
+                                  int history_size,
+                                  int candidate_delay,
+                                  int last_delay,
+                                  float decrease_in_last_set,
+                                  float valley_depth) {
+  const float32x4_t zero = vdupq_n_f32(0.f);
+  const float32x4_t decrease = vdupq_n_f32(decrease_in_last_set);
+  const float32x4_t depth = vdupq_n_f32(valley_depth);
+  const int32x4_t last_low = vdupq_n_s32(last_delay - 2);
+  const int32x4_t last_high = vdupq_n_s32(last_delay + 1);
+  const int32x4_t candidate = vdupq_n_s32(candidate_delay);
+  const int32x4_t candidate_low = vdupq_n_s32(candidate_delay - 2);
+  const int32x4_t candidate_high = vdupq_n_s32(candidate_delay + 1);
+  int32x4_t delay = { 0, 1, 2, 3 };
+  int i = 0;
+
+  for (; i + 4 <= history_size; i += 4) {
+    const uint32x4_t in_last_set = vbicq_u32(
+        vandq_u32(vcgeq_s32(delay, last_low), vcleq_s32(delay, last_high)),
+        vceqq_s32(delay, candidate));
+    const uint32x4_t in_candidate_set = vandq_u32(
+        vcgeq_s32(delay, candidate_low), vcleq_s32(delay, candidate_high));
+    const uint32x4_t in_either = vorrq_u32(in_last_set, in_candidate_set);
+    const float32x4_t decrease_bin = vaddq_f32(
+        vbslq_f32(in_last_set, decrease, zero),
+        vbslq_f32(in_either, zero, depth));
+    float32x4_t bin = vsubq_f32(vld1q_f32(&histogram[i]), decrease_bin);
+    // No histogram bin can go below 0.
+    bin = vbslq_f32(vcltq_f32(bin, zero), zero, bin);
+    vst1q_f32(&histogram[i], bin);
+    delay = vaddq_s32(delay, vdupq_n_s32(4));
+  }
+
+  for (; i < history_size; ++i) {
+    int is_in_last_set = (i >= last_delay - 2) &&
+        (i <= last_delay + 1) && (i != candidate_delay);
+    int is_in_candidate_set = (i >= candidate_delay - 2) &&
+        (i <= candidate_delay + 1);
+    histogram[i] -= decrease_in_last_set * is_in_last_set +
+        valley_depth * (!is_in_last_set && !is_in_candidate_set);
+    if (histogram[i] < 0) {
+      histogram[i] = 0;
+    }
+  }
+}
+
+void WebRtc_InitDelayEstimator_neon(void) {
+  WebRtc_BitCountComparison = BitCountComparisonNeon;
+  WebRtc_UpdateMeanBitCounts = UpdateMeanBitCountsNeon;
+  WebRtc_DecreaseHistogram = DecreaseHistogramNeon;
+}
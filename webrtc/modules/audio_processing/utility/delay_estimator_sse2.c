@@ -0,0 +1,224 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The SSE2 versions of the loops over the delay history of the binary delay
+ * estimator, bit-exact with the C versions in delay_estimator.c.
+ */
+
+#include <emmintrin.h>
+#include <limits.h>
+
+#include "webrtc/modules/audio_processing/utility/delay_estimator.h"
+
+enum { kFloatExponentBias = 127 };
+enum { kFloatExponentShift = 23 };
+
+// Selects |a| in the lanes where |mask| is set and |b| in the others.
+static __inline __m128i Select(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// The minimum of the lanes, in all the lanes.
+static __inline __m128i HorizontalMin(__m128i v) {
+  __m128i w = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+  v = Select(_mm_cmpgt_epi32(v, w), w, v);
+  w = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+  return Select(_mm_cmpgt_epi32(v, w), w, v);
+}
+
+static __inline __m128i HorizontalMax(__m128i v) {
+  __m128i w = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+  v = Select(_mm_cmpgt_epi32(v, w), v, w);
+  w = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+  return Select(_mm_cmpgt_epi32(v, w), v, w);
+}
+
+// Number of set bits in each of the lanes of |v|.
+static __inline __m128i BitCount(__m128i v) {
+  const __m128i m1 = _mm_set1_epi32(0x55555555);
+  const __m128i m2 = _mm_set1_epi32(0x33333333);
+  const __m128i m4 = _mm_set1_epi32(0x0F0F0F0F);
+  v = _mm_sub_epi32(v, _mm_and_si128(_mm_srli_epi32(v, 1), m1));
+  v = _mm_add_epi32(_mm_and_si128(v, m2),
+                    _mm_and_si128(_mm_srli_epi32(v, 2), m2));
+  v = _mm_and_si128(_mm_add_epi32(v, _mm_srli_epi32(v, 4)), m4);
+  // SSE2 has no 32-bit multiplication to add up the bytes with.
+  v = _mm_add_epi32(v, _mm_srli_epi32(v, 8));
+  v = _mm_add_epi32(v, _mm_srli_epi32(v, 16));
+  return _mm_and_si128(v, _mm_set1_epi32(0x3F));
+}
+
+static void BitCountComparisonSSE2(uint32_t binary_vector,
+                                   const uint32_t* binary_matrix,
+                                   int matrix_size,
+                                   int32_t* bit_counts) {
+  const __m128i vector = _mm_set1_epi32((int32_t)binary_vector);
+  int n = 0;
+
+  for (; n + 4 <= matrix_size; n += 4) {
+    const __m128i rows = _mm_loadu_si128((const __m128i*)&binary_matrix[n]);
+    _mm_storeu_si128((__m128i*)&bit_counts[n],
+                     BitCount(_mm_xor_si128(vector, rows)));
+  }
+  if (n < matrix_size) {
+    // Counts the remaining rows padded with zeros.
+    uint32_t rows[4] = { 0 };
+    int32_t counts[4];
+    int k = 0;
+    for (k = 0; n + k < matrix_size; k++) {
+      rows[k] = binary_matrix[n + k];
+    }
+    _mm_storeu_si128((__m128i*)counts, BitCount(
+        _mm_xor_si128(vector, _mm_loadu_si128((const __m128i*)rows))));
+    for (k = 0; n + k < matrix_size; k++) {
+      bit_counts[n + k] = counts[k];
+    }
+  }
+}
+
+static void UpdateMeanBitCountsSSE2(const int32_t* bit_counts,
+                                    const int* far_bit_counts,
+                                    int history_size,
+                                    int32_t* mean_bit_counts,
+                                    int* candidate_delay,
+                                    int32_t* value_best_candidate,
+                                    int32_t* value_worst_candidate) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i exponent_offset =
+      _mm_set1_epi32(kFloatExponentBias + 16 - kShiftsAtZero);
+  __m128i best = _mm_set1_epi32(kMaxBitCountsQ9);
+  __m128i best_delay = _mm_set1_epi32(-1);
+  __m128i worst = zero;
+  __m128i delay = _mm_setr_epi32(0, 1, 2, 3);
+  int best_candidate = -1;
+  int32_t value_best = kMaxBitCountsQ9;
+  int32_t value_worst = 0;
+  int i = 0;
+
+  for (; i + 4 <= history_size; i += 4) {
+    const __m128i far_counts =
+        _mm_loadu_si128((const __m128i*)&far_bit_counts[i]);
+    const __m128i bit_count = _mm_slli_epi32(
+        _mm_loadu_si128((const __m128i*)&bit_counts[i]), 9);  // Q9.
+    __m128i mean = _mm_loadu_si128((const __m128i*)&mean_bit_counts[i]);
+    const __m128i diff = _mm_sub_epi32(bit_count, mean);
+    const __m128i sign = _mm_srai_epi32(diff, 31);
+    const __m128i abs_diff = _mm_sub_epi32(_mm_xor_si128(diff, sign), sign);
+    // The right shift of WebRtc_MeanEstimatorFix() differs between the lanes,
+    // which SSE2 can't do. Instead the absolute difference, which fits in 16
+    // bits, is multiplied by 2^(16 - shifts) and the top half is kept. The
+    // power of two is built in the exponent of a float.
+    const __m128i slope_shifts = _mm_srai_epi32(_mm_mullo_epi16(
+        far_counts, _mm_set1_epi32(kShiftsLinearSlope)), 4);
+    const __m128i scale = _mm_cvttps_epi32(_mm_castsi128_ps(_mm_slli_epi32(
+        _mm_add_epi32(slope_shifts, exponent_offset), kFloatExponentShift)));
+    __m128i step = _mm_srli_epi32(_mm_madd_epi16(abs_diff, scale), 16);
+    step = _mm_sub_epi32(_mm_xor_si128(step, sign), sign);
+    // Only update where the far-end has something to contribute.
+    mean = _mm_add_epi32(mean, _mm_and_si128(
+        _mm_cmpgt_epi32(far_counts, zero), step));
+    _mm_storeu_si128((__m128i*)&mean_bit_counts[i], mean);
+
+    {
+      const __m128i better = _mm_cmplt_epi32(mean, best);
+      best = Select(better, mean, best);
+      best_delay = Select(better, delay, best_delay);
+      worst = Select(_mm_cmpgt_epi32(mean, worst), mean, worst);
+      delay = _mm_add_epi32(delay, _mm_set1_epi32(4));
+    }
+  }
+
+  if (i > 0) {
+    // The first delay among the lanes holding the smallest mean.
+    const __m128i min_best = HorizontalMin(best);
+    const __m128i min_delay = HorizontalMin(Select(
+        _mm_cmpeq_epi32(best, min_best), best_delay, _mm_set1_epi32(INT_MAX)));
+    value_best = _mm_cvtsi128_si32(min_best);
+    best_candidate = _mm_cvtsi128_si32(min_delay);
+    value_worst = _mm_cvtsi128_si32(HorizontalMax(worst));
+  }
+
+  for (; i < history_size; i++) {
+    if (far_bit_counts[i] > 0) {
+      int shifts = kShiftsAtZero;
+      shifts -= (kShiftsLinearSlope * far_bit_counts[i]) >> 4;
+      WebRtc_MeanEstimatorFix(bit_counts[i] << 9, shifts, &mean_bit_counts[i]);
+    }
+    if (mean_bit_counts[i] < value_best) {
+      value_best = mean_bit_counts[i];
+      best_candidate = i;
+    }
+    if (mean_bit_counts[i] > value_worst) {
+      value_worst = mean_bit_counts[i];
+    }
+  }
+
+  *candidate_delay = best_candidate;
+  *value_best_candidate = value_best;
+  *value_worst_candidate = value_worst;
+}
+
+static void DecreaseHistogramSSE2(float* histogram,
+                                  int history_size,
+                                  int candidate_delay,
+                                  int last_delay,
+                                  float decrease_in_last_set,
+                                  float valley_depth) {
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 decrease = _mm_set1_ps(decrease_in_last_set);
+  const __m128 depth = _mm_set1_ps(valley_depth);
+  // The sets are [delay - 2, delay + 1], compared as (delay - 3, delay + 2).
+  const __m128i last_low = _mm_set1_epi32(last_delay - 3);
+  const __m128i last_high = _mm_set1_epi32(last_delay + 2);
+  const __m128i candidate = _mm_set1_epi32(candidate_delay);
+  const __m128i candidate_low = _mm_set1_epi32(candidate_delay - 3);
+  const __m128i candidate_high = _mm_set1_epi32(candidate_delay + 2);
+  __m128i delay = _mm_setr_epi32(0, 1, 2, 3);
+  int i = 0;
+
+  for (; i + 4 <= history_size; i += 4) {
+    const __m128i in_last_set = _mm_andnot_si128(
+        _mm_cmpeq_epi32(delay, candidate),
+        _mm_and_si128(_mm_cmpgt_epi32(delay, last_low),
+                      _mm_cmplt_epi32(delay, last_high)));
+    const __m128i in_candidate_set =
+        _mm_and_si128(_mm_cmpgt_epi32(delay, candidate_low),
+                      _mm_cmplt_epi32(delay, candidate_high));
+    const __m128 in_neither = _mm_castsi128_ps(_mm_cmpeq_epi32(
+        _mm_or_si128(in_last_set, in_candidate_set), _mm_setzero_si128()));
+    const __m128 decrease_bin = _mm_add_ps(
+        _mm_and_ps(_mm_castsi128_ps(in_last_set), decrease),
+        _mm_and_ps(in_neither, depth));
+    __m128 bin = _mm_sub_ps(_mm_loadu_ps(&histogram[i]), decrease_bin);
+    // No histogram bin can go below 0.
+    bin = _mm_andnot_ps(_mm_cmplt_ps(bin, zero), bin);
+    _mm_storeu_ps(&histogram[i], bin);
+    delay = _mm_add_epi32(delay, _mm_set1_epi32(4));
+  }
+
+  for (; i < history_size; ++i) {
+    int is_in_last_set = (i >= last_delay - 2) &&
+        (i <= last_delay + 1) && (i != candidate_delay);
+    int is_in_candidate_set = (i >= candidate_delay - 2) &&
+        (i <= candidate_delay + 1);
+    histogram[i] -= decrease_in_last_set * is_in_last_set +
+        valley_depth * (!is_in_last_set && !is_in_candidate_set);
+    if (histogram[i] < 0) {
+      histogram[i] = 0;
+    }
+  }
+}
+
+void WebRtc_InitDelayEstimator_SSE2(void) {
+  WebRtc_BitCountComparison = BitCountComparisonSSE2;
+  WebRtc_UpdateMeanBitCounts = UpdateMeanBitCountsSSE2;
+  WebRtc_DecreaseHistogram = DecreaseHistogramSSE2;
+}
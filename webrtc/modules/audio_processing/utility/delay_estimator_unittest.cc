@@ -8,6 +8,9 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
 extern "C" {
@@ -15,6 +18,8 @@ extern "C" {
 #include "webrtc/modules/audio_processing/utility/delay_estimator_internal.h"
 #include "webrtc/modules/audio_processing/utility/delay_estimator_wrapper.h"
 }
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/typedefs.h"
 
 namespace {
@@ -616,6 +621,166 @@ TEST_F(DelayEstimatorTest, VerifyHistorySizeIsSetAndKeptAfterInit) {
   EXPECT_EQ(kDifferentHistorySize, WebRtc_history_size(handle_));
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Maximum history size in the SSE2 tests, covering all the tail lengths.
+enum { kMaxTestHistorySize = 67 };
+
+TEST(DelayEstimatorSSE2Test, BitCountComparisonIsBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    return;
+  }
+  uint32_t binary_matrix[kMaxTestHistorySize];
+  int32_t bit_counts_c[kMaxTestHistorySize];
+  int32_t bit_counts_sse2[kMaxTestHistorySize];
+  srand(42);
+  for (int size = 1; size <= kMaxTestHistorySize; ++size) {
+    const uint32_t binary_vector = static_cast<uint32_t>(rand()) << 16 ^ rand();
+    for (int i = 0; i < size; ++i) {
+      binary_matrix[i] = static_cast<uint32_t>(rand()) << 16 ^ rand();
+    }
+    binary_matrix[0] = binary_vector;
+    binary_matrix[size - 1] = ~binary_vector;
+    WebRtc_BitCountComparisonC(binary_vector, binary_matrix, size,
+                               bit_counts_c);
+    WebRtc_InitDelayEstimator_SSE2();
+    WebRtc_BitCountComparison(binary_vector, binary_matrix, size,
+                              bit_counts_sse2);
+    for (int i = 0; i < size; ++i) {
+      EXPECT_EQ(bit_counts_c[i], bit_counts_sse2[i]);
+    }
+  }
+}
+
+TEST(DelayEstimatorSSE2Test, UpdateMeanBitCountsIsBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    return;
+  }
+  int32_t bit_counts[kMaxTestHistorySize];
+  int far_bit_counts[kMaxTestHistorySize];
+  int32_t mean_c[kMaxTestHistorySize];
+  int32_t mean_sse2[kMaxTestHistorySize];
+  WebRtc_InitDelayEstimator_SSE2();
+  srand(42);
+  for (int size = 1; size <= kMaxTestHistorySize; ++size) {
+    // A few values only for the means gives ties in the candidate search,
+    // and with no far-end bits at all none of them is a candidate.
+    for (int round = 0; round < 3; ++round) {
+      for (int i = 0; i < size; ++i) {
+        bit_counts[i] = rand() % 33;
+        far_bit_counts[i] = round == 2 ? 0 : rand() % 33;
+        mean_c[i] = round == 0 ? rand() % (kMaxBitCountsQ9 + 1) :
+            (rand() % 3) * (kMaxBitCountsQ9 / 2);
+        mean_sse2[i] = mean_c[i];
+      }
+      int candidate_c = 0;
+      int candidate_sse2 = 0;
+      int32_t best_c = 0;
+      int32_t best_sse2 = 0;
+      int32_t worst_c = 0;
+      int32_t worst_sse2 = 0;
+      WebRtc_UpdateMeanBitCountsC(bit_counts, far_bit_counts, size, mean_c,
+                                  &candidate_c, &best_c, &worst_c);
+      WebRtc_UpdateMeanBitCounts(bit_counts, far_bit_counts, size, mean_sse2,
+                                 &candidate_sse2, &best_sse2, &worst_sse2);
+      for (int i = 0; i < size; ++i) {
+        EXPECT_EQ(mean_c[i], mean_sse2[i]);
+      }
+      EXPECT_EQ(candidate_c, candidate_sse2);
+      EXPECT_EQ(best_c, best_sse2);
+      EXPECT_EQ(worst_c, worst_sse2);
+    }
+  }
+}
+
+TEST(DelayEstimatorSSE2Test, DecreaseHistogramIsBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    return;
+  }
+  float histogram_c[kMaxTestHistorySize];
+  float histogram_sse2[kMaxTestHistorySize];
+  WebRtc_InitDelayEstimator_SSE2();
+  srand(42);
+  for (int size = 1; size <= kMaxTestHistorySize; ++size) {
+    for (int round = 0; round < 10; ++round) {
+      const int candidate_delay = rand() % (size + 4) - 2;
+      const int last_delay = rand() % (size + 4) - 2;
+      const float decrease_in_last_set = rand() * 2.f / RAND_MAX;
+      const float valley_depth = rand() * 2.f / RAND_MAX;
+      for (int i = 0; i < size; ++i) {
+        histogram_c[i] = rand() * 3.f / RAND_MAX;
+        histogram_sse2[i] = histogram_c[i];
+      }
+      WebRtc_DecreaseHistogramC(histogram_c, size, candidate_delay,
+                                last_delay, decrease_in_last_set,
+                                valley_depth);
+      WebRtc_DecreaseHistogram(histogram_sse2, size, candidate_delay,
+                               last_delay, decrease_in_last_set,
+                               valley_depth);
+      for (int i = 0; i < size; ++i) {
+        EXPECT_EQ(histogram_c[i], histogram_sse2[i]);
+      }
+    }
+  }
+}
+
+// Prints the time spent in the history loops of one call to
+// WebRtc_ProcessBinarySpectrum(...), for the C and SSE2 versions.
+TEST(DelayEstimatorSSE2Test, DISABLED_Benchmark) {
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    return;
+  }
+  const int kHistorySizes[] = { 32, 100, 300, 1000 };
+  const int kNumCalls = 20000;
+  uint32_t binary_matrix[1000];
+  int far_bit_counts[1000];
+  int32_t bit_counts[1000];
+  int32_t mean_bit_counts[1000];
+  float histogram[1000];
+  srand(42);
+  for (int i = 0; i < 1000; ++i) {
+    binary_matrix[i] = static_cast<uint32_t>(rand()) << 16 ^ rand();
+    far_bit_counts[i] = rand() % 33;
+  }
+  for (size_t k = 0; k < sizeof(kHistorySizes) / sizeof(*kHistorySizes); ++k) {
+    const int size = kHistorySizes[k];
+    for (int use_sse2 = 0; use_sse2 <= 1; ++use_sse2) {
+      WebRtcBitCountComparison bit_count_comparison =
+          WebRtc_BitCountComparisonC;
+      WebRtcUpdateMeanBitCounts update_mean_bit_counts =
+          WebRtc_UpdateMeanBitCountsC;
+      WebRtcDecreaseHistogram decrease_histogram = WebRtc_DecreaseHistogramC;
+      if (use_sse2) {
+        WebRtc_InitDelayEstimator_SSE2();
+        bit_count_comparison = WebRtc_BitCountComparison;
+        update_mean_bit_counts = WebRtc_UpdateMeanBitCounts;
+        decrease_histogram = WebRtc_DecreaseHistogram;
+      }
+      for (int i = 0; i < size; ++i) {
+        mean_bit_counts[i] = (20 << 9);
+        histogram[i] = 0.f;
+      }
+      int candidate_delay = 0;
+      int32_t value_best_candidate = 0;
+      int32_t value_worst_candidate = 0;
+      const webrtc::TickTime start = webrtc::TickTime::Now();
+      for (int n = 0; n < kNumCalls; ++n) {
+        bit_count_comparison(binary_matrix[n % size], binary_matrix, size,
+                             bit_counts);
+        update_mean_bit_counts(bit_counts, far_bit_counts, size,
+                               mean_bit_counts, &candidate_delay,
+                               &value_best_candidate, &value_worst_candidate);
+        decrease_histogram(histogram, size, candidate_delay, n % size, 0.5f,
+                           0.25f);
+      }
+      printf("History size %4d, %s: %.3f us per call\n", size,
+             use_sse2 ? "SSE2" : "C   ",
+             (webrtc::TickTime::Now() - start).Microseconds() /
+                 static_cast<double>(kNumCalls));
+    }
+  }
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
 // TODO(bjornv): Add tests for SoftReset...(...).
 
 }  // namespace
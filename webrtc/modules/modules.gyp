@@ -75,6 +75,7 @@
             'pcm16b',  # Needed by NetEq tests.
             'red',
             'remote_bitrate_estimator',
+            'rtp_batch_replayer',
             'rtp_rtcp',
             'video_codecs_test_framework',
             'video_processing',
@@ -100,6 +101,7 @@
             'audio_coding/codecs/cng/audio_encoder_cng_unittest.cc',
             'audio_coding/main/acm2/acm_receiver_unittest.cc',
             'audio_coding/main/acm2/acm_receiver_unittest_oldapi.cc',
+            'audio_coding/main/acm2/acm_resampler_unittest.cc',
             'audio_coding/main/acm2/audio_coding_module_unittest.cc',
             'audio_coding/main/acm2/audio_coding_module_unittest_oldapi.cc',
             'audio_coding/main/acm2/call_statistics_unittest.cc',
@@ -160,9 +162,12 @@
             'audio_coding/neteq/tools/input_audio_file_unittest.cc',
             'audio_coding/neteq/tools/packet_unittest.cc',
             'audio_conference_mixer/test/audio_conference_mixer_unittest.cc',
+            'audio_device/dummy/file_audio_device_unittest.cc',
+            'audio_device/dummy/virtual_audio_device_unittest.cc',
             'audio_device/fine_audio_buffer_unittest.cc',
             'audio_processing/aec/echo_cancellation_unittest.cc',
             'audio_processing/aec/system_delay_unittest.cc',
+            'audio_processing/aecm/echo_control_mobile_unittest.cc',
             'audio_processing/agc/agc_manager_direct_unittest.cc',
             # TODO(ajm): Fix to match new interface.
             # 'audio_processing/agc/agc_unittest.cc',
@@ -262,6 +267,7 @@
             'rtp_rtcp/source/rtp_rtcp_impl_unittest.cc',
             'rtp_rtcp/source/rtp_header_extension_unittest.cc',
             'rtp_rtcp/source/rtp_sender_unittest.cc',
+            'rtp_rtcp/source/tmmbr_help_unittest.cc',
             'rtp_rtcp/source/vp8_partition_aggregator_unittest.cc',
             'rtp_rtcp/test/testAPI/test_api.cc',
             'rtp_rtcp/test/testAPI/test_api.h',
@@ -281,10 +287,12 @@
             'video_coding/codecs/vp8/simulcast_unittest.cc',
             'video_coding/codecs/vp8/simulcast_unittest.h',
             'video_coding/main/interface/mock/mock_vcm_callbacks.h',
+            'video_coding/main/test/batch_replayer_unittest.cc',
             'video_coding/main/source/decoding_state_unittest.cc',
             'video_coding/main/source/jitter_buffer_unittest.cc',
             'video_coding/main/source/jitter_estimator_tests.cc',
             'video_coding/main/source/media_optimization_unittest.cc',
+            'video_coding/main/source/missing_sequence_numbers_unittest.cc',
             'video_coding/main/source/receiver_unittest.cc',
             'video_coding/main/source/session_info_unittest.cc',
             'video_coding/main/source/timing_unittest.cc',
@@ -338,6 +346,7 @@
               ],
               'sources': [
                 'audio_processing/audio_processing_impl_unittest.cc',
+                'audio_processing/debug_dump_writer_unittest.cc',
                 'audio_processing/test/audio_processing_unittest.cc',
                 'audio_processing/test/test_utils.h',
               ],
@@ -72,6 +72,7 @@ class RtpRtcp : public Module {
     BitrateStatisticsObserver* send_bitrate_observer;
     FrameCountObserver* send_frame_count_observer;
     SendSideDelayObserver* send_side_delay_observer;
+    VideoFrameStageObserver* send_frame_stage_observer;
   };
 
   /*
@@ -542,6 +543,9 @@ class RtpRtcp : public Module {
         RtcpStatisticsCallback* callback) = 0;
     virtual RtcpStatisticsCallback*
         GetRtcpStatisticsCallback() = 0;
+    // Called on receipt of an RTCP sender report from the remote SSRC.
+    virtual void RegisterRtcpSenderReportObserver(
+        RtcpSenderReportObserver* observer) = 0;
     // BWE feedback packets.
     virtual bool SendFeedbackPacket(const rtcp::TransportFeedback& packet) = 0;
 
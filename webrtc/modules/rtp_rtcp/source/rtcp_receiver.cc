@@ -66,6 +66,7 @@ RTCPReceiver::RTCPReceiver(
       _lastReceivedRrMs(0),
       _lastIncreasedSequenceNumberMs(0),
       stats_callback_(NULL),
+      sender_report_observer_(NULL),
       packet_type_counter_observer_(packet_type_counter_observer),
       num_skipped_packets_(0),
       last_skipped_packets_warning_(clock->TimeInMilliseconds()) {
@@ -1316,6 +1317,12 @@ RtcpStatisticsCallback* RTCPReceiver::GetRtcpStatisticsCallback() {
   return stats_callback_;
 }
 
+void RTCPReceiver::RegisterRtcpSenderReportObserver(
+    RtcpSenderReportObserver* observer) {
+  CriticalSectionScoped cs(_criticalSectionFeedbacks);
+  sender_report_observer_ = observer;
+}
+
 // Holding no Critical section
 void RTCPReceiver::TriggerCallbacksFromRTCPPacket(
     RTCPPacketInformation& rtcpPacketInformation) {
@@ -1418,6 +1425,15 @@ void RTCPReceiver::TriggerCallbacksFromRTCPPacket(
       }
     }
   }
+
+  if (rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpSr) {
+    CriticalSectionScoped cs(_criticalSectionFeedbacks);
+    if (sender_report_observer_) {
+      sender_report_observer_->OnSenderReport(
+          rtcpPacketInformation.remoteSSRC, rtcpPacketInformation.ntp_secs,
+          rtcpPacketInformation.ntp_frac, rtcpPacketInformation.rtp_timestamp);
+    }
+  }
 }
 
 int32_t RTCPReceiver::CNAME(uint32_t remoteSSRC,
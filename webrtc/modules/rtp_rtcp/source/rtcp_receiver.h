@@ -110,6 +110,8 @@ public:
     void RegisterRtcpStatisticsCallback(RtcpStatisticsCallback* callback);
     RtcpStatisticsCallback* GetRtcpStatisticsCallback();
 
+    void RegisterRtcpSenderReportObserver(RtcpSenderReportObserver* observer);
+
 protected:
  RTCPUtility::RTCPCnameInformation* CreateCnameInformation(uint32_t remoteSSRC);
  RTCPUtility::RTCPCnameInformation* GetCnameInformation(
@@ -313,6 +315,8 @@ protected:
   int64_t _lastIncreasedSequenceNumberMs;
 
   RtcpStatisticsCallback* stats_callback_ GUARDED_BY(_criticalSectionFeedbacks);
+  RtcpSenderReportObserver* sender_report_observer_
+      GUARDED_BY(_criticalSectionFeedbacks);
 
   RtcpPacketTypeCounterObserver* const packet_type_counter_observer_;
   RtcpPacketTypeCounter packet_type_counter_;
@@ -1030,6 +1030,58 @@ TEST_F(RtcpReceiverTest, Callbacks) {
                                kCumulativeLoss, kJitter));
 }
 
+TEST_F(RtcpReceiverTest, SenderReportObserver) {
+  class SenderReportObserverImpl : public RtcpSenderReportObserver {
+   public:
+    SenderReportObserverImpl()
+        : num_reports_(0), ssrc_(0), ntp_secs_(0), ntp_frac_(0),
+          rtp_timestamp_(0) {}
+
+    void OnSenderReport(uint32_t ssrc,
+                        uint32_t ntp_secs,
+                        uint32_t ntp_frac,
+                        uint32_t rtp_timestamp) override {
+      ++num_reports_;
+      ssrc_ = ssrc;
+      ntp_secs_ = ntp_secs;
+      ntp_frac_ = ntp_frac;
+      rtp_timestamp_ = rtp_timestamp;
+    }
+
+    int num_reports_;
+    uint32_t ssrc_;
+    uint32_t ntp_secs_;
+    uint32_t ntp_frac_;
+    uint32_t rtp_timestamp_;
+  } observer;
+
+  rtcp_receiver_->RegisterRtcpSenderReportObserver(&observer);
+
+  const uint32_t kSenderSsrc = 0x10203;
+  rtcp::SenderReport sr;
+  sr.From(kSenderSsrc);
+  sr.WithNtpSec(0x11111111);
+  sr.WithNtpFrac(0x22222222);
+  sr.WithRtpTimestamp(0x33333333);
+  rtc::scoped_ptr<rtcp::RawPacket> packet(sr.Build());
+
+  // Sender reports from other than the expected peer are not reported.
+  EXPECT_EQ(0, InjectRtcpPacket(packet->Buffer(), packet->Length()));
+  EXPECT_EQ(0, observer.num_reports_);
+
+  rtcp_receiver_->SetRemoteSSRC(kSenderSsrc);
+  EXPECT_EQ(0, InjectRtcpPacket(packet->Buffer(), packet->Length()));
+  EXPECT_EQ(1, observer.num_reports_);
+  EXPECT_EQ(kSenderSsrc, observer.ssrc_);
+  EXPECT_EQ(0x11111111u, observer.ntp_secs_);
+  EXPECT_EQ(0x22222222u, observer.ntp_frac_);
+  EXPECT_EQ(0x33333333u, observer.rtp_timestamp_);
+
+  rtcp_receiver_->RegisterRtcpSenderReportObserver(nullptr);
+  EXPECT_EQ(0, InjectRtcpPacket(packet->Buffer(), packet->Length()));
+  EXPECT_EQ(1, observer.num_reports_);
+}
+
 TEST_F(RtcpReceiverTest, ReceivesTransportFeedback) {
   const uint32_t kSenderSsrc = 0x10203;
   const uint32_t kSourceSsrc = 0x123456;
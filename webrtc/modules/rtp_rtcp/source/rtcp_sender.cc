@@ -30,6 +30,15 @@ namespace webrtc {
 
 using RTCPUtility::RTCPCnameInformation;
 
+namespace {
+const size_t kRrHeaderLength = 8;
+const size_t kReportBlockLength = 24;
+// Default IPv4/UDP overhead, as in RTPSender.
+const size_t kIpUdpOverhead = 28;
+// The SRTCP index and a 10 byte HMAC-SHA1-80 authentication tag.
+const size_t kSrtcpOverhead = 4 + 10;
+}  // namespace
+
 NACKStringBuilder::NACKStringBuilder()
     : stream_(""), count_(0), prevNack_(0), consecutive_(false) {
 }
@@ -100,6 +109,15 @@ struct RTCPSender::RtcpContext {
     return ptr;
   }
 
+  // Copies a packet built earlier, if it fits.
+  bool Append(const rtcp::RawPacket& packet) {
+    if (position + packet.Length() > buffer_size)
+      return false;
+    memcpy(&buffer[position], packet.Buffer(), packet.Length());
+    position += packet.Length();
+    return true;
+  }
+
   const FeedbackState& feedback_state;
   int32_t nack_size;
   const uint16_t* nack_list;
@@ -154,6 +172,8 @@ RTCPSender::RTCPSender(
       ssrc_(0),
       remote_ssrc_(0),
       receive_statistics_(receive_statistics),
+      next_report_block_(0),
+      max_packet_length_(IP_PACKET_SIZE - kIpUdpOverhead),
 
       sequence_number_fir_(0),
 
@@ -251,6 +271,7 @@ void RTCPSender::SetREMBData(uint32_t bitrate,
   CriticalSectionScoped lock(critical_section_rtcp_sender_.get());
   remb_bitrate_ = bitrate;
   remb_ssrcs_ = ssrcs;
+  remb_packet_.reset();
 
   if (remb_enabled_)
     SetFlag(kRtcpRemb, false);
@@ -300,6 +321,8 @@ void RTCPSender::SetSSRC(uint32_t ssrc) {
     next_time_to_send_rtcp_ = clock_->TimeInMilliseconds() + 100;
   }
   ssrc_ = ssrc;
+  sdes_packet_.reset();
+  remb_packet_.reset();
 }
 
 void RTCPSender::SetRemoteSSRC(uint32_t ssrc) {
@@ -314,6 +337,7 @@ int32_t RTCPSender::SetCNAME(const char* c_name) {
   RTC_DCHECK_LT(strlen(c_name), static_cast<size_t>(RTCP_CNAME_SIZE));
   CriticalSectionScoped lock(critical_section_rtcp_sender_.get());
   cname_ = c_name;
+  sdes_packet_.reset();
   return 0;
 }
 
@@ -325,6 +349,7 @@ int32_t RTCPSender::AddMixedCNAME(uint32_t SSRC, const char* c_name) {
     return -1;
 
   csrc_cnames_[SSRC] = c_name;
+  sdes_packet_.reset();
   return 0;
 }
 
@@ -336,6 +361,7 @@ int32_t RTCPSender::RemoveMixedCNAME(uint32_t SSRC) {
     return -1;
 
   csrc_cnames_.erase(it);
+  sdes_packet_.reset();
   return 0;
 }
 
@@ -451,21 +477,55 @@ bool RTCPSender::SendTimeOfXrRrReport(uint32_t mid_ntp,
   return true;
 }
 
-int32_t RTCPSender::AddReportBlock(const RTCPReportBlock& report_block) {
-  if (report_blocks_.size() >= RTCP_MAX_REPORT_BLOCKS) {
-    LOG(LS_WARNING) << "Too many report blocks.";
-    return -1;
+void RTCPSender::PrepareReportBlocks(const FeedbackState& feedback_state) {
+  report_blocks_.clear();
+  next_report_block_ = 0;
+  StatisticianMap statisticians =
+      receive_statistics_->GetActiveStatisticians();
+  if (statisticians.empty())
+    return;
+
+  // The delay since the last received SR is the same for all the blocks, so
+  // get our NTP once, after the statistics have been locked in.
+  uint32_t delay_since_last_sr = 0;
+  if ((feedback_state.last_rr_ntp_secs != 0) ||
+      (feedback_state.last_rr_ntp_frac != 0)) {
+    uint32_t ntp_secs;
+    uint32_t ntp_frac;
+    clock_->CurrentNtp(ntp_secs, ntp_frac);
+
+    // Get the 16 lowest bits of seconds and the 16 highest bits of fractions.
+    uint32_t now = ntp_secs & 0x0000FFFF;
+    now <<= 16;
+    now += (ntp_frac & 0xffff0000) >> 16;
+
+    uint32_t receiveTime = feedback_state.last_rr_ntp_secs & 0x0000FFFF;
+    receiveTime <<= 16;
+    receiveTime += (feedback_state.last_rr_ntp_frac & 0xffff0000) >> 16;
+
+    delay_since_last_sr = now - receiveTime;
   }
-  rtcp::ReportBlock* block = &report_blocks_[report_block.remoteSSRC];
-  block->To(report_block.remoteSSRC);
-  block->WithFractionLost(report_block.fractionLost);
-  block->WithCumulativeLost(report_block.cumulativeLost);
-  block->WithExtHighestSeqNum(report_block.extendedHighSeqNum);
-  block->WithJitter(report_block.jitter);
-  block->WithLastSr(report_block.lastSR);
-  block->WithDelayLastSr(report_block.delaySinceLastSR);
 
-  return 0;
+  report_blocks_.reserve(statisticians.size());
+  for (const auto& it : statisticians) {
+    // Do we have receive statistics to send?
+    RtcpStatistics stats;
+    if (!it.second->GetStatistics(&stats, true))
+      continue;
+    report_blocks_.push_back(rtcp::ReportBlock());
+    rtcp::ReportBlock* block = &report_blocks_.back();
+    block->To(it.first);
+    block->WithFractionLost(stats.fraction_lost);
+    block->WithCumulativeLost(stats.cumulative_lost);
+    block->WithExtHighestSeqNum(stats.extended_max_sequence_number);
+    block->WithJitter(stats.jitter);
+    block->WithLastSr(feedback_state.remote_sr);
+    block->WithDelayLastSr(delay_since_last_sr);
+  }
+}
+
+size_t RTCPSender::NextReportBlockCount(size_t max_blocks) const {
+  return std::min(max_blocks, report_blocks_.size() - next_report_block_);
 }
 
 RTCPSender::BuildResult RTCPSender::BuildSR(RtcpContext* ctx) {
@@ -495,29 +555,36 @@ RTCPSender::BuildResult RTCPSender::BuildSR(RtcpContext* ctx) {
   report.WithPacketCount(ctx->feedback_state.packets_sent);
   report.WithOctetCount(ctx->feedback_state.media_bytes_sent);
 
-  for (auto it : report_blocks_)
-    report.WithReportBlock(it.second);
+  const size_t num_blocks = NextReportBlockCount(RTCP_MAX_REPORT_BLOCKS);
+  for (size_t i = 0; i < num_blocks; ++i)
+    report.WithReportBlock(report_blocks_[next_report_block_ + i]);
 
   PacketBuiltCallback callback(ctx);
   if (!callback.BuildPacket(report))
     return BuildResult::kTruncated;
 
-  report_blocks_.clear();
+  next_report_block_ += num_blocks;
   return BuildResult::kSuccess;
 }
 
-RTCPSender::BuildResult RTCPSender::BuildSDES(RtcpContext* ctx) {
-  size_t length_cname = cname_.length();
-  RTC_CHECK_LT(length_cname, static_cast<size_t>(RTCP_CNAME_SIZE));
+const rtcp::RawPacket& RTCPSender::SdesPacket() {
+  if (!sdes_packet_) {
+    size_t length_cname = cname_.length();
+    RTC_CHECK_LT(length_cname, static_cast<size_t>(RTCP_CNAME_SIZE));
 
-  rtcp::Sdes sdes;
-  sdes.WithCName(ssrc_, cname_);
+    rtcp::Sdes sdes;
+    sdes.WithCName(ssrc_, cname_);
 
-  for (const auto it : csrc_cnames_)
-    sdes.WithCName(it.first, it.second);
+    for (const auto it : csrc_cnames_)
+      sdes.WithCName(it.first, it.second);
 
-  PacketBuiltCallback callback(ctx);
-  if (!callback.BuildPacket(sdes))
+    sdes_packet_ = sdes.Build();
+  }
+  return *sdes_packet_;
+}
+
+RTCPSender::BuildResult RTCPSender::BuildSDES(RtcpContext* ctx) {
+  if (!ctx->Append(SdesPacket()))
     return BuildResult::kTruncated;
 
   return BuildResult::kSuccess;
@@ -526,14 +593,15 @@ RTCPSender::BuildResult RTCPSender::BuildSDES(RtcpContext* ctx) {
 RTCPSender::BuildResult RTCPSender::BuildRR(RtcpContext* ctx) {
   rtcp::ReceiverReport report;
   report.From(ssrc_);
-  for (auto it : report_blocks_)
-    report.WithReportBlock(it.second);
+  const size_t num_blocks = NextReportBlockCount(RTCP_MAX_REPORT_BLOCKS);
+  for (size_t i = 0; i < num_blocks; ++i)
+    report.WithReportBlock(report_blocks_[next_report_block_ + i]);
 
   PacketBuiltCallback callback(ctx);
   if (!callback.BuildPacket(report))
     return BuildResult::kTruncated;
 
-  report_blocks_.clear();
+  next_report_block_ += num_blocks;
 
   return BuildResult::kSuccess;
 }
@@ -631,14 +699,16 @@ RTCPSender::BuildResult RTCPSender::BuildRPSI(RtcpContext* ctx) {
 }
 
 RTCPSender::BuildResult RTCPSender::BuildREMB(RtcpContext* ctx) {
-  rtcp::Remb remb;
-  remb.From(ssrc_);
-  for (uint32_t ssrc : remb_ssrcs_)
-    remb.AppliesTo(ssrc);
-  remb.WithBitrateBps(remb_bitrate_);
+  if (!remb_packet_) {
+    rtcp::Remb remb;
+    remb.From(ssrc_);
+    for (uint32_t ssrc : remb_ssrcs_)
+      remb.AppliesTo(ssrc);
+    remb.WithBitrateBps(remb_bitrate_);
+    remb_packet_ = remb.Build();
+  }
 
-  PacketBuiltCallback callback(ctx);
-  if (!callback.BuildPacket(remb))
+  if (!ctx->Append(*remb_packet_))
     return BuildResult::kTruncated;
 
   TRACE_EVENT_INSTANT0(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
@@ -647,6 +717,11 @@ RTCPSender::BuildResult RTCPSender::BuildREMB(RtcpContext* ctx) {
   return BuildResult::kSuccess;
 }
 
+void RTCPSender::SetMaxPacketLength(size_t max_packet_length) {
+  CriticalSectionScoped lock(critical_section_rtcp_sender_.get());
+  max_packet_length_ = max_packet_length;
+}
+
 void RTCPSender::SetTargetBitrate(unsigned int target_bitrate) {
   CriticalSectionScoped lock(critical_section_rtcp_sender_.get());
   tmmbr_send_ = target_bitrate / 1000;
@@ -947,7 +1022,16 @@ int32_t RTCPSender::SendCompoundRTCP(
   if (rtcp_length <= 0)
     return -1;
 
-  return SendToNetwork(rtcp_buffer, static_cast<size_t>(rtcp_length));
+  if (SendToNetwork(rtcp_buffer, static_cast<size_t>(rtcp_length)) != 0)
+    return -1;
+
+  // Send the report blocks that didn't fit, in as few packets as possible.
+  while ((rtcp_length = PrepareAdditionalReports(feedback_state, rtcp_buffer,
+                                                 IP_PACKET_SIZE)) > 0) {
+    if (SendToNetwork(rtcp_buffer, static_cast<size_t>(rtcp_length)) != 0)
+      return -1;
+  }
+  return 0;
 }
 
 int RTCPSender::PrepareRTCP(const FeedbackState& feedback_state,
@@ -1017,17 +1101,7 @@ int RTCPSender::PrepareRTCP(const FeedbackState& feedback_state,
     }
     next_time_to_send_rtcp_ = clock_->TimeInMilliseconds() + timeToNext;
 
-    StatisticianMap statisticians =
-        receive_statistics_->GetActiveStatisticians();
-    if (!statisticians.empty()) {
-      for (auto it = statisticians.begin(); it != statisticians.end(); ++it) {
-        RTCPReportBlock report_block;
-        if (PrepareReport(feedback_state, it->first, it->second,
-                          &report_block)) {
-          AddReportBlock(report_block);
-        }
-      }
-    }
+    PrepareReportBlocks(feedback_state);
   }
 
   auto it = report_flags_.begin();
@@ -1067,45 +1141,48 @@ int RTCPSender::PrepareRTCP(const FeedbackState& feedback_state,
   return context.position;
 }
 
-bool RTCPSender::PrepareReport(const FeedbackState& feedback_state,
-                               uint32_t ssrc,
-                               StreamStatistician* statistician,
-                               RTCPReportBlock* report_block) {
-  // Do we have receive statistics to send?
-  RtcpStatistics stats;
-  if (!statistician->GetStatistics(&stats, true))
-    return false;
-  report_block->fractionLost = stats.fraction_lost;
-  report_block->cumulativeLost = stats.cumulative_lost;
-  report_block->extendedHighSeqNum =
-      stats.extended_max_sequence_number;
-  report_block->jitter = stats.jitter;
-  report_block->remoteSSRC = ssrc;
-
-  // TODO(sprang): Do we really need separate time stamps for each report?
-  // Get our NTP as late as possible to avoid a race.
-  uint32_t ntp_secs;
-  uint32_t ntp_frac;
-  clock_->CurrentNtp(ntp_secs, ntp_frac);
-
-  // Delay since last received report.
-  uint32_t delaySinceLastReceivedSR = 0;
-  if ((feedback_state.last_rr_ntp_secs != 0) ||
-      (feedback_state.last_rr_ntp_frac != 0)) {
-    // Get the 16 lowest bits of seconds and the 16 highest bits of fractions.
-    uint32_t now = ntp_secs & 0x0000FFFF;
-    now <<= 16;
-    now += (ntp_frac & 0xffff0000) >> 16;
+int RTCPSender::PrepareAdditionalReports(const FeedbackState& feedback_state,
+                                         uint8_t* rtcp_buffer,
+                                         int buffer_size) {
+  CriticalSectionScoped lock(critical_section_rtcp_sender_.get());
+  if (next_report_block_ >= report_blocks_.size())
+    return 0;
 
-    uint32_t receiveTime = feedback_state.last_rr_ntp_secs & 0x0000FFFF;
-    receiveTime <<= 16;
-    receiveTime += (feedback_state.last_rr_ntp_frac & 0xffff0000) >> 16;
+  // Leave room for the SRTCP trailer, and for the SDES at the end.
+  const size_t packet_length =
+      std::min(static_cast<size_t>(buffer_size), max_packet_length_) -
+      kSrtcpOverhead;
+  RtcpContext context(feedback_state, 0, nullptr, false, 0, rtcp_buffer,
+                      packet_length);
+  const size_t sdes_length = cname_.empty() ? 0 : SdesPacket().Length();
+
+  const size_t max_length = packet_length - sdes_length;
+  while (next_report_block_ < report_blocks_.size() &&
+         context.position + kRrHeaderLength + kReportBlockLength <=
+             max_length) {
+    const size_t num_blocks = NextReportBlockCount(std::min<size_t>(
+        RTCP_MAX_REPORT_BLOCKS,
+        (max_length - context.position - kRrHeaderLength) /
+            kReportBlockLength));
+    rtcp::ReceiverReport report;
+    report.From(ssrc_);
+    for (size_t i = 0; i < num_blocks; ++i)
+      report.WithReportBlock(report_blocks_[next_report_block_ + i]);
+
+    PacketBuiltCallback callback(&context);
+    if (!callback.BuildPacket(report))
+      break;
+    next_report_block_ += num_blocks;
+  }
 
-    delaySinceLastReceivedSR = now-receiveTime;
+  if (context.position == 0) {
+    // Not even one block fits; give up on the rest.
+    next_report_block_ = report_blocks_.size();
+    return 0;
   }
-  report_block->delaySinceLastSR = delaySinceLastReceivedSR;
-  report_block->lastSR = feedback_state.remote_sr;
-  return true;
+  if (!cname_.empty())
+    context.Append(SdesPacket());
+  return context.position;
 }
 
 int32_t RTCPSender::SendToNetwork(const uint8_t* dataBuffer, size_t length) {
@@ -15,6 +15,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread_annotations.h"
@@ -146,6 +147,12 @@ public:
  void SetCsrcs(const std::vector<uint32_t>& csrcs);
 
  void SetTargetBitrate(unsigned int target_bitrate);
+
+ // Sets the largest packet the transport takes, i.e. the MTU less the
+ // IP/UDP overhead, as used for RTP. The extra compound packets for report
+ // blocks that don't fit in the first one leave room for SRTCP within it.
+ void SetMaxPacketLength(size_t max_packet_length);
+
  bool SendFeedbackPacket(const rtcp::TransportFeedback& packet);
 
 private:
@@ -172,13 +179,14 @@ private:
 
  int32_t SendToNetwork(const uint8_t* dataBuffer, size_t length);
 
- int32_t AddReportBlock(const RTCPReportBlock& report_block)
+ // Replaces |report_blocks_| with a report block for each active receive
+ // stream.
+ void PrepareReportBlocks(const FeedbackState& feedback_state)
      EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
 
- bool PrepareReport(const FeedbackState& feedback_state,
-                    uint32_t ssrc,
-                    StreamStatistician* statistician,
-                    RTCPReportBlock* report_block);
+ // The number of report blocks, up to |max_blocks|, for the next report.
+ size_t NextReportBlockCount(size_t max_blocks) const
+     EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
 
  int PrepareRTCP(const FeedbackState& feedback_state,
                  const std::set<RTCPPacketType>& packetTypes,
@@ -189,6 +197,17 @@ private:
                  uint8_t* rtcp_buffer,
                  int buffer_size);
 
+ // Builds a compound packet of RRs with the report blocks that did not fit
+ // in the previous packets, and an SDES, of at most |max_packet_length_|
+ // less the SRTCP overhead. Returns 0 if there are none left.
+ int PrepareAdditionalReports(const FeedbackState& feedback_state,
+                              uint8_t* rtcp_buffer,
+                              int buffer_size);
+
+ // The SDES, built again if |sdes_packet_| has been reset.
+ const rtcp::RawPacket& SdesPacket()
+     EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
+
  BuildResult BuildSR(RtcpContext* context)
      EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
  BuildResult BuildRR(RtcpContext* context)
@@ -246,10 +265,18 @@ private:
 
  ReceiveStatistics* receive_statistics_
      GUARDED_BY(critical_section_rtcp_sender_);
- std::map<uint32_t, rtcp::ReportBlock> report_blocks_
+ // The report blocks of the current report, which are sent in as many
+ // compound packets as they need, from |next_report_block_| on.
+ std::vector<rtcp::ReportBlock> report_blocks_
      GUARDED_BY(critical_section_rtcp_sender_);
+ size_t next_report_block_ GUARDED_BY(critical_section_rtcp_sender_);
+ size_t max_packet_length_ GUARDED_BY(critical_section_rtcp_sender_);
  std::map<uint32_t, std::string> csrc_cnames_
      GUARDED_BY(critical_section_rtcp_sender_);
+ // The SDES built from |ssrc_|, |cname_| and |csrc_cnames_|, which goes in
+ // every compound packet; reset when they change.
+ rtc::scoped_ptr<rtcp::RawPacket> sdes_packet_
+     GUARDED_BY(critical_section_rtcp_sender_);
 
  // Sent
  uint32_t last_send_report_[RTCP_NUMBER_OF_SR] GUARDED_BY(
@@ -271,6 +298,10 @@ private:
  // REMB
  uint32_t remb_bitrate_ GUARDED_BY(critical_section_rtcp_sender_);
  std::vector<uint32_t> remb_ssrcs_ GUARDED_BY(critical_section_rtcp_sender_);
+ // The REMB built from |remb_bitrate_| and |remb_ssrcs_|; reset when they
+ // change.
+ rtc::scoped_ptr<rtcp::RawPacket> remb_packet_
+     GUARDED_BY(critical_section_rtcp_sender_);
 
  TMMBRHelp tmmbr_help_ GUARDED_BY(critical_section_rtcp_sender_);
  uint32_t tmmbr_send_ GUARDED_BY(critical_section_rtcp_sender_);
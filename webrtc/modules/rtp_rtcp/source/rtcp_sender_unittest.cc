@@ -13,9 +13,14 @@
  * This file includes unit tests for the RTCPSender.
  */
 
+#include <stdio.h>
+
+#include <vector>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_sender.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_impl.h"
@@ -206,6 +211,7 @@ class TestTransport : public Transport,
   }
   bool SendRtcp(const uint8_t* data, size_t len) override {
     parser_.Parse(static_cast<const uint8_t*>(data), len);
+    rtcp_lengths_.push_back(len);
     return true;
   }
   int OnReceivedPayloadData(const uint8_t* payload_data,
@@ -214,6 +220,7 @@ class TestTransport : public Transport,
     return 0;
   }
   test::RtcpPacketParser parser_;
+  std::vector<size_t> rtcp_lengths_;
 };
 
 namespace {
@@ -333,6 +340,45 @@ TEST_F(RtcpSenderTest, SendRrWithTwoReportBlocks) {
   EXPECT_EQ(1, parser()->report_blocks_per_ssrc(kRemoteSsrc + 1));
 }
 
+TEST_F(RtcpSenderTest, SendsReportBlocksThatDontFitInMorePackets) {
+  const int kNumStreams = 100;
+  for (int i = 0; i < kNumStreams; ++i)
+    InsertIncomingPacket(kRemoteSsrc + i, 11111);
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kCompound);
+  EXPECT_EQ(0, rtcp_sender_->SetCNAME("alice@host"));
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpRr));
+  EXPECT_EQ(kNumStreams, parser()->report_block()->num_packets());
+  for (int i = 0; i < kNumStreams; ++i)
+    EXPECT_EQ(1, parser()->report_blocks_per_ssrc(kRemoteSsrc + i));
+  // 31 blocks in the first packet, and the rest in RRs of up to 31 blocks in
+  // packets that leave room for the IP/UDP headers and SRTCP within
+  // IP_PACKET_SIZE. Every packet has an SDES.
+  EXPECT_EQ(4, parser()->receiver_report()->num_packets());
+  EXPECT_EQ(3, parser()->sdes()->num_packets());
+  ASSERT_EQ(3u, test_transport_.rtcp_lengths_.size());
+  for (size_t length : test_transport_.rtcp_lengths_)
+    EXPECT_LE(length, IP_PACKET_SIZE - 28u - 14u);
+}
+
+TEST_F(RtcpSenderTest, ReportBlocksThatDontFitRespectMaxPacketLength) {
+  const size_t kMaxPacketLength = 400;
+  // SRTCP index and authentication tag.
+  const size_t kSrtcpOverhead = 14;
+  const int kNumStreams = 100;
+  for (int i = 0; i < kNumStreams; ++i)
+    InsertIncomingPacket(kRemoteSsrc + i, 11111);
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kCompound);
+  rtcp_sender_->SetMaxPacketLength(kMaxPacketLength);
+  EXPECT_EQ(0, rtcp_sender_->SetCNAME("alice@host"));
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpRr));
+  EXPECT_EQ(kNumStreams, parser()->report_block()->num_packets());
+  // The first packet is built as before; the others are capped.
+  ASSERT_GT(test_transport_.rtcp_lengths_.size(), 3u);
+  for (size_t i = 1; i < test_transport_.rtcp_lengths_.size(); ++i)
+    EXPECT_LE(test_transport_.rtcp_lengths_[i],
+              kMaxPacketLength - kSrtcpOverhead);
+}
+
 TEST_F(RtcpSenderTest, SendSdes) {
   rtcp_sender_->SetRTCPStatus(RtcpMode::kReducedSize);
   EXPECT_EQ(0, rtcp_sender_->SetCNAME("alice@host"));
@@ -505,6 +551,32 @@ TEST_F(RtcpSenderTest, SendRemb) {
               ElementsAre(kRemoteSsrc, kRemoteSsrc + 1));
 }
 
+TEST_F(RtcpSenderTest, SdesAndRembFollowChanges) {
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kReducedSize);
+  std::vector<uint32_t> ssrcs;
+  ssrcs.push_back(kRemoteSsrc);
+  std::set<RTCPPacketType> packet_types;
+  packet_types.insert(kRtcpSdes);
+  packet_types.insert(kRtcpRemb);
+
+  EXPECT_EQ(0, rtcp_sender_->SetCNAME("alice@host"));
+  rtcp_sender_->SetREMBData(1000, ssrcs);
+  EXPECT_EQ(0, rtcp_sender_->SendCompoundRTCP(feedback_state(), packet_types));
+  EXPECT_EQ("alice@host", parser()->sdes_chunk()->Cname());
+  EXPECT_EQ(1000, parser()->remb_item()->last_bitrate_bps());
+
+  EXPECT_EQ(0, rtcp_sender_->SetCNAME("bob@host"));
+  rtcp_sender_->SetREMBData(2000, ssrcs);
+  EXPECT_EQ(0, rtcp_sender_->SendCompoundRTCP(feedback_state(), packet_types));
+  EXPECT_EQ("bob@host", parser()->sdes_chunk()->Cname());
+  EXPECT_EQ(2000, parser()->remb_item()->last_bitrate_bps());
+
+  rtcp_sender_->SetSSRC(kSenderSsrc + 1);
+  EXPECT_EQ(0, rtcp_sender_->SendCompoundRTCP(feedback_state(), packet_types));
+  EXPECT_EQ(kSenderSsrc + 1, parser()->sdes_chunk()->Ssrc());
+  EXPECT_EQ(kSenderSsrc + 1, parser()->psfb_app()->Ssrc());
+}
+
 TEST_F(RtcpSenderTest, RembIncludedInCompoundPacketIfEnabled) {
   const int kBitrate = 261011;
   std::vector<uint32_t> ssrcs;
@@ -761,4 +833,68 @@ TEST_F(RtcpSenderTest, SendCompoundPliRemb) {
   EXPECT_EQ(1, parser()->pli()->num_packets());
 }
 
+// Counts the RTCP packets sent, without parsing them.
+class CountingTransport : public Transport {
+ public:
+  CountingTransport() : packets_(0), bytes_(0) {}
+
+  bool SendRtp(const uint8_t* /*data*/,
+               size_t /*len*/,
+               const PacketOptions& options) override {
+    return false;
+  }
+  bool SendRtcp(const uint8_t* data, size_t len) override {
+    ++packets_;
+    bytes_ += len;
+    return true;
+  }
+
+  int packets_;
+  size_t bytes_;
+};
+
+// Measures the cost of building and sending the regular compound reports of
+// a receiver with REMB, for different numbers of receive streams.
+TEST(RtcpSenderBenchmarkTest, DISABLED_CompoundReportCost) {
+  const int kReports = 1000;
+  const size_t kPacketLength = 100;
+  for (int num_streams : {1, 10, 50, 100, 200, 500}) {
+    SimulatedClock clock(1335900000);
+    rtc::scoped_ptr<ReceiveStatistics> receive_statistics(
+        ReceiveStatistics::Create(&clock));
+    CountingTransport transport;
+    RTCPSender sender(false, &clock, receive_statistics.get(), nullptr,
+                      &transport);
+    sender.SetSSRC(kSenderSsrc);
+    sender.SetRemoteSSRC(kRemoteSsrc);
+    sender.SetCNAME("alice@host");
+    sender.SetRTCPStatus(RtcpMode::kCompound);
+    sender.SetREMBStatus(true);
+    std::vector<uint32_t> ssrcs;
+    for (int i = 0; i < num_streams; ++i)
+      ssrcs.push_back(kRemoteSsrc + i);
+    sender.SetREMBData(1000000, ssrcs);
+
+    RTCPSender::FeedbackState feedback_state;
+    RTPHeader header;
+    header.headerLength = 12;
+    uint64_t elapsed_ns = 0;
+    for (int report = 0; report < kReports; ++report) {
+      for (int i = 0; i < num_streams; ++i) {
+        header.ssrc = kRemoteSsrc + i;
+        header.sequenceNumber = static_cast<uint16_t>(report);
+        receive_statistics->IncomingPacket(header, kPacketLength, false);
+      }
+      clock.AdvanceTimeMilliseconds(10);
+      const uint64_t start_ns = rtc::TimeNanos();
+      EXPECT_EQ(0, sender.SendRTCP(feedback_state, kRtcpReport));
+      elapsed_ns += rtc::TimeNanos() - start_ns;
+    }
+    printf("%3d streams: %6.1f us per report, %.1f packets of %.0f bytes\n",
+           num_streams, elapsed_ns / 1000.0 / kReports,
+           static_cast<double>(transport.packets_) / kReports,
+           static_cast<double>(transport.bytes_) / transport.packets_);
+  }
+}
+
 }  // namespace webrtc
@@ -530,6 +530,109 @@ bool RTCPUtility::RtcpParseCommonHeader(const uint8_t* packet,
   return true;
 }
 
+namespace {
+// Appends up to |count| SSRCs found at the start of each |stride| bytes item
+// in |data|.
+void AppendSsrcs(const uint8_t* data,
+                 size_t size_bytes,
+                 size_t stride,
+                 size_t count,
+                 std::vector<uint32_t>* ssrcs) {
+  for (size_t offset = 0; count > 0 && offset + 4 <= size_bytes;
+       offset += stride, --count) {
+    ssrcs->push_back(ByteReader<uint32_t>::ReadBigEndian(&data[offset]));
+  }
+}
+}  // namespace
+
+bool RTCPUtility::RtcpParseSsrcs(const uint8_t* packet,
+                                 size_t size_bytes,
+                                 std::vector<uint32_t>* ssrcs) {
+  RTC_DCHECK(ssrcs != nullptr);
+  const size_t kReportBlockSize = 24;
+  const size_t kFciEntrySize = 8;
+  const uint8_t kFmtFir = 4;
+  const uint8_t kFmtTmmbr = 3;
+  const uint8_t kFmtTmmbn = 4;
+  const uint8_t kFmtAfb = 15;
+
+  const uint8_t* const end = packet + size_bytes;
+  while (packet < end) {
+    RtcpCommonHeader header;
+    if (!RtcpParseCommonHeader(packet, end - packet, &header))
+      return false;
+    const uint8_t* payload = packet + RtcpCommonHeader::kHeaderSizeBytes;
+    const size_t payload_size = header.payload_size_bytes;
+    packet += header.BlockSize();
+    // All packet types handled below start with the sender SSRC.
+    if (payload_size < 4 || header.packet_type == PT_IJ)
+      continue;
+    switch (header.packet_type) {
+      case PT_SR:
+      case PT_RR: {
+        size_t blocks_offset = header.packet_type == PT_SR ? 24 : 4;
+        AppendSsrcs(payload, payload_size, payload_size, 1, ssrcs);
+        if (payload_size > blocks_offset) {
+          AppendSsrcs(payload + blocks_offset, payload_size - blocks_offset,
+                      kReportBlockSize, header.count_or_format, ssrcs);
+        }
+        break;
+      }
+      case PT_SDES:
+      case PT_APP:
+        AppendSsrcs(payload, payload_size, payload_size, 1, ssrcs);
+        break;
+      case PT_BYE:
+        AppendSsrcs(payload, payload_size, 4, header.count_or_format, ssrcs);
+        break;
+      case PT_RTPFB:
+      case PT_PSFB: {
+        // Sender and media source SSRCs.
+        AppendSsrcs(payload, payload_size, 4, 2, ssrcs);
+        if (payload_size <= 8)
+          break;
+        const uint8_t* fci = payload + 8;
+        const size_t fci_size = payload_size - 8;
+        uint8_t fmt = header.count_or_format;
+        if ((header.packet_type == PT_RTPFB &&
+             (fmt == kFmtTmmbr || fmt == kFmtTmmbn)) ||
+            (header.packet_type == PT_PSFB && fmt == kFmtFir)) {
+          AppendSsrcs(fci, fci_size, kFciEntrySize, fci_size / kFciEntrySize,
+                      ssrcs);
+        } else if (header.packet_type == PT_PSFB && fmt == kFmtAfb &&
+                   fci_size >= 8 && memcmp(fci, "REMB", 4) == 0) {
+          AppendSsrcs(fci + 8, fci_size - 8, 4, fci[4], ssrcs);
+        }
+        break;
+      }
+      case PT_XR: {
+        AppendSsrcs(payload, payload_size, payload_size, 1, ssrcs);
+        size_t offset = 4;
+        while (offset + 4 <= payload_size) {
+          uint8_t block_type = payload[offset];
+          size_t block_size =
+              4 + 4 * ByteReader<uint16_t>::ReadBigEndian(&payload[offset + 2]);
+          if (offset + block_size > payload_size)
+            return false;
+          if (block_type == kBtDlrr) {
+            // Sub-blocks of SSRC, LRR and DLRR.
+            AppendSsrcs(&payload[offset + 4], block_size - 4, 12,
+                        (block_size - 4) / 12, ssrcs);
+          } else if (block_type == kBtVoipMetric) {
+            AppendSsrcs(&payload[offset + 4], block_size - 4, block_size, 1,
+                        ssrcs);
+          }
+          offset += block_size;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
 bool
 RTCPUtility::RTCPParserV2::ParseRR()
 {
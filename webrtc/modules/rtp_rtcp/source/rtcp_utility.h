@@ -13,6 +13,8 @@
 
 #include <stddef.h> // size_t, ptrdiff_t
 
+#include <vector>
+
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_config.h"
@@ -356,6 +358,14 @@ bool RtcpParseCommonHeader(const uint8_t* buffer,
                            size_t size_bytes,
                            RtcpCommonHeader* parsed_header);
 
+// Appends the SSRCs a compound RTCP packet refers to, i.e. the sender SSRCs,
+// the sources of report blocks and the media sources of feedback messages,
+// to |ssrcs|. The same SSRC may be appended more than once.
+// Returns false if the packet could not be parsed.
+bool RtcpParseSsrcs(const uint8_t* packet,
+                    size_t size_bytes,
+                    std::vector<uint32_t>* ssrcs);
+
 class RTCPParserV2 {
  public:
   RTCPParserV2(
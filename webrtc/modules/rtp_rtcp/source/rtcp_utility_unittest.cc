@@ -8,10 +8,12 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 #include "webrtc/base/checks.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
 
 namespace webrtc {
@@ -156,6 +158,93 @@ TEST_F(RtcpParseCommonHeaderTest, FormatAndPayloadType) {
   EXPECT_EQ(kPacketType, header.packet_type);
 }
 
+TEST(RtcpParseSsrcsTest, CompoundReport) {
+  ReportBlock rb1;
+  rb1.To(0x11);
+  ReportBlock rb2;
+  rb2.To(0x12);
+  SenderReport sr;
+  sr.From(0x10);
+  EXPECT_TRUE(sr.WithReportBlock(rb1));
+  EXPECT_TRUE(sr.WithReportBlock(rb2));
+  ReceiverReport rr;
+  rr.From(0x20);
+  ReportBlock rb3;
+  rb3.To(0x21);
+  EXPECT_TRUE(rr.WithReportBlock(rb3));
+  Bye bye;
+  bye.From(0x30);
+  EXPECT_TRUE(bye.WithCsrc(0x31));
+  sr.Append(&rr);
+  sr.Append(&bye);
+  rtc::scoped_ptr<RawPacket> packet(sr.Build());
+
+  std::vector<uint32_t> ssrcs;
+  EXPECT_TRUE(RTCPUtility::RtcpParseSsrcs(packet->Buffer(), packet->Length(),
+                                          &ssrcs));
+  EXPECT_THAT(ssrcs,
+              ::testing::ElementsAre(0x10, 0x11, 0x12, 0x20, 0x21, 0x30, 0x31));
+}
+
+TEST(RtcpParseSsrcsTest, Feedback) {
+  Nack nack;
+  nack.From(0x10);
+  nack.To(0x11);
+  const uint16_t kNackList[] = {1, 2, 3};
+  nack.WithList(kNackList, 3);
+  Fir fir;
+  fir.From(0x20);
+  fir.To(0x21);
+  Remb remb;
+  remb.From(0x30);
+  remb.AppliesTo(0x31);
+  remb.AppliesTo(0x32);
+  remb.WithBitrateBps(300000);
+  Tmmbn tmmbn;
+  tmmbn.From(0x40);
+  EXPECT_TRUE(tmmbn.WithTmmbr(0x41, 100, 40));
+  nack.Append(&fir);
+  nack.Append(&remb);
+  nack.Append(&tmmbn);
+  rtc::scoped_ptr<RawPacket> packet(nack.Build());
+
+  std::vector<uint32_t> ssrcs;
+  EXPECT_TRUE(RTCPUtility::RtcpParseSsrcs(packet->Buffer(), packet->Length(),
+                                          &ssrcs));
+  EXPECT_THAT(ssrcs, ::testing::ElementsAre(0x10, 0x11, 0x20, 0, 0x21, 0x30,
+                                            0, 0x31, 0x32, 0x40, 0, 0x41));
+}
+
+TEST(RtcpParseSsrcsTest, ExtendedReport) {
+  Rrtr rrtr;
+  Dlrr dlrr;
+  EXPECT_TRUE(dlrr.WithDlrrItem(0x11, 1, 2));
+  EXPECT_TRUE(dlrr.WithDlrrItem(0x12, 3, 4));
+  VoipMetric metric;
+  metric.To(0x13);
+  Xr xr;
+  xr.From(0x10);
+  EXPECT_TRUE(xr.WithRrtr(&rrtr));
+  EXPECT_TRUE(xr.WithDlrr(&dlrr));
+  EXPECT_TRUE(xr.WithVoipMetric(&metric));
+  rtc::scoped_ptr<RawPacket> packet(xr.Build());
+
+  std::vector<uint32_t> ssrcs;
+  EXPECT_TRUE(RTCPUtility::RtcpParseSsrcs(packet->Buffer(), packet->Length(),
+                                          &ssrcs));
+  EXPECT_THAT(ssrcs, ::testing::ElementsAre(0x10, 0x11, 0x12, 0x13));
+}
+
+TEST(RtcpParseSsrcsTest, InvalidPacket) {
+  ReceiverReport rr;
+  rr.From(0x10);
+  rtc::scoped_ptr<RawPacket> packet(rr.Build());
+
+  std::vector<uint32_t> ssrcs;
+  EXPECT_FALSE(RTCPUtility::RtcpParseSsrcs(packet->Buffer(),
+                                           packet->Length() - 1, &ssrcs));
+}
+
 }  // namespace rtcp
 }  // namespace webrtc
 
@@ -43,7 +43,8 @@ RtpRtcp::Configuration::Configuration()
       transport_sequence_number_allocator(nullptr),
       send_bitrate_observer(nullptr),
       send_frame_count_observer(nullptr),
-      send_side_delay_observer(nullptr) {}
+      send_side_delay_observer(nullptr),
+      send_frame_stage_observer(nullptr) {}
 
 RtpRtcp* RtpRtcp::CreateRtpRtcp(const RtpRtcp::Configuration& configuration) {
   if (configuration.clock) {
@@ -68,7 +69,8 @@ ModuleRtpRtcpImpl::ModuleRtpRtcpImpl(const Configuration& configuration)
                   configuration.transport_feedback_callback,
                   configuration.send_bitrate_observer,
                   configuration.send_frame_count_observer,
-                  configuration.send_side_delay_observer),
+                  configuration.send_side_delay_observer,
+                  configuration.send_frame_stage_observer),
       rtcp_sender_(configuration.audio,
                    configuration.clock,
                    configuration.receive_statistics,
@@ -465,11 +467,13 @@ int32_t ModuleRtpRtcpImpl::SetTransportOverhead(
 
   uint16_t length =
       rtp_sender_.MaxPayloadLength() - packet_over_head_diff;
+  rtcp_sender_.SetMaxPacketLength(length);
   return rtp_sender_.SetMaxPayloadLength(length, packet_overhead_);
 }
 
 int32_t ModuleRtpRtcpImpl::SetMaxTransferUnit(const uint16_t mtu) {
   RTC_DCHECK_LE(mtu, IP_PACKET_SIZE) << "Invalid mtu: " << mtu;
+  rtcp_sender_.SetMaxPacketLength(mtu - packet_overhead_);
   return rtp_sender_.SetMaxPayloadLength(mtu - packet_overhead_,
                                          packet_overhead_);
 }
@@ -762,6 +766,11 @@ RtcpStatisticsCallback* ModuleRtpRtcpImpl::GetRtcpStatisticsCallback() {
   return rtcp_receiver_.GetRtcpStatisticsCallback();
 }
 
+void ModuleRtpRtcpImpl::RegisterRtcpSenderReportObserver(
+    RtcpSenderReportObserver* observer) {
+  rtcp_receiver_.RegisterRtcpSenderReportObserver(observer);
+}
+
 bool ModuleRtpRtcpImpl::SendFeedbackPacket(
     const rtcp::TransportFeedback& packet) {
   return rtcp_sender_.SendFeedbackPacket(packet);
@@ -227,6 +227,8 @@ class ModuleRtpRtcpImpl : public RtpRtcp {
   void RegisterRtcpStatisticsCallback(
       RtcpStatisticsCallback* callback) override;
   RtcpStatisticsCallback* GetRtcpStatisticsCallback() override;
+  void RegisterRtcpSenderReportObserver(
+      RtcpSenderReportObserver* observer) override;
 
   bool SendFeedbackPacket(const rtcp::TransportFeedback& packet) override;
   // (APP) Application specific data.
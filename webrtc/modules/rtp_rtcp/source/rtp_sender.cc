@@ -119,7 +119,8 @@ RTPSender::RTPSender(
     TransportFeedbackObserver* transport_feedback_observer,
     BitrateStatisticsObserver* bitrate_callback,
     FrameCountObserver* frame_count_observer,
-    SendSideDelayObserver* send_side_delay_observer)
+    SendSideDelayObserver* send_side_delay_observer,
+    VideoFrameStageObserver* frame_stage_observer)
     : clock_(clock),
       // TODO(holmer): Remove this conversion when we remove the use of
       // TickTime.
@@ -157,6 +158,7 @@ RTPSender::RTPSender(
       rtp_stats_callback_(NULL),
       frame_count_observer_(frame_count_observer),
       send_side_delay_observer_(send_side_delay_observer),
+      frame_stage_observer_(frame_stage_observer),
       // RTP variables
       start_timestamp_forced_(false),
       start_timestamp_(0),
@@ -891,11 +893,17 @@ bool RTPSender::TimeToSendPacket(uint16_t sequence_number,
     CriticalSectionScoped lock(send_critsect_.get());
     rtx = rtx_;
   }
-  return PrepareAndSendPacket(data_buffer,
-                              length,
-                              capture_time_ms,
-                              retransmission && (rtx & kRtxRetransmitted) > 0,
-                              retransmission);
+  const bool marker_bit = (data_buffer[1] & 0x80) != 0;
+  bool ret = PrepareAndSendPacket(
+      data_buffer, length, capture_time_ms,
+      retransmission && (rtx & kRtxRetransmitted) > 0, retransmission);
+  // |stored_time_ms| is the capture time in the Clock domain, as opposed to
+  // |capture_time_ms| which has been corrected for the pacer.
+  if (ret && !retransmission && marker_bit && stored_time_ms > 0 &&
+      frame_stage_observer_) {
+    frame_stage_observer_->OnFrameStage(kVideoFrameSent, stored_time_ms);
+  }
+  return ret;
 }
 
 bool RTPSender::PrepareAndSendPacket(uint8_t* buffer,
@@ -1046,6 +1054,12 @@ int32_t RTPSender::SendToNetwork(uint8_t* buffer,
     return -1;
   }
 
+  // The last packet of a frame has been built.
+  const bool report_frame_stage =
+      frame_stage_observer_ && rtp_header.markerBit && capture_time_ms > 0;
+  if (report_frame_stage)
+    frame_stage_observer_->OnFrameStage(kVideoFramePacketized, capture_time_ms);
+
   if (paced_sender_) {
     // Correct offset between implementations of millisecond time stamps in
     // TickTime and Clock.
@@ -1077,6 +1091,8 @@ int32_t RTPSender::SendToNetwork(uint8_t* buffer,
   if (!sent)
     return -1;
 
+  if (report_frame_stage)
+    frame_stage_observer_->OnFrameStage(kVideoFrameSent, capture_time_ms);
   {
     CriticalSectionScoped lock(send_critsect_.get());
     media_has_been_sent_ = true;
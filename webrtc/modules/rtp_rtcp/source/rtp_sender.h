@@ -96,7 +96,8 @@ class RTPSender : public RTPSenderInterface {
             TransportFeedbackObserver* transport_feedback_callback,
             BitrateStatisticsObserver* bitrate_callback,
             FrameCountObserver* frame_count_observer,
-            SendSideDelayObserver* send_side_delay_observer);
+            SendSideDelayObserver* send_side_delay_observer,
+            VideoFrameStageObserver* frame_stage_observer);
   virtual ~RTPSender();
 
   void ProcessBitrate();
@@ -432,6 +433,7 @@ class RTPSender : public RTPSenderInterface {
   StreamDataCountersCallback* rtp_stats_callback_ GUARDED_BY(statistics_crit_);
   FrameCountObserver* const frame_count_observer_;
   SendSideDelayObserver* const send_side_delay_observer_;
+  VideoFrameStageObserver* const frame_stage_observer_;
 
   // RTP variables
   bool start_timestamp_forced_ GUARDED_BY(send_critsect_);
@@ -135,7 +135,7 @@ class RtpSenderTest : public ::testing::Test {
     rtp_sender_.reset(new RTPSender(false, &fake_clock_, &transport_, nullptr,
                                     pacer ? &mock_paced_sender_ : nullptr,
                                     nullptr, nullptr, nullptr, nullptr,
-                                    nullptr));
+                                    nullptr, nullptr));
     rtp_sender_->SetSequenceNumber(kSeqNum);
   }
 
@@ -847,7 +847,7 @@ TEST_F(RtpSenderTest, SendRedundantPayloads) {
   MockTransport transport;
   rtp_sender_.reset(new RTPSender(false, &fake_clock_, &transport, nullptr,
                                   &mock_paced_sender_, nullptr, nullptr,
-                                  nullptr, nullptr, nullptr));
+                                  nullptr, nullptr, nullptr, nullptr));
   rtp_sender_->SetSequenceNumber(kSeqNum);
   rtp_sender_->SetRtxPayloadType(kRtxPayload, kPayload);
   // Make all packets go through the pacer.
@@ -980,7 +980,7 @@ TEST_F(RtpSenderTest, FrameCountCallbacks) {
 
   rtp_sender_.reset(new RTPSender(false, &fake_clock_, &transport_, nullptr,
                                   &mock_paced_sender_, nullptr, nullptr,
-                                  nullptr, &callback, nullptr));
+                                  nullptr, &callback, nullptr, nullptr));
 
   char payload_name[RTP_PAYLOAD_NAME_SIZE] = "GENERIC";
   const uint8_t payload_type = 127;
@@ -1011,6 +1011,51 @@ TEST_F(RtpSenderTest, FrameCountCallbacks) {
   rtp_sender_.reset();
 }
 
+TEST_F(RtpSenderTest, FrameStageCallbacks) {
+  class TestCallback : public VideoFrameStageObserver {
+   public:
+    void OnFrameStage(VideoFrameStage stage, int64_t frame_id) override {
+      stages_.push_back(std::make_pair(stage, frame_id));
+    }
+
+    std::vector<std::pair<VideoFrameStage, int64_t>> stages_;
+  } callback;
+
+  rtp_sender_.reset(new RTPSender(false, &fake_clock_, &transport_, nullptr,
+                                  &mock_paced_sender_, nullptr, nullptr,
+                                  nullptr, nullptr, nullptr, &callback));
+  rtp_sender_->SetSequenceNumber(kSeqNum);
+
+  char payload_name[RTP_PAYLOAD_NAME_SIZE] = "GENERIC";
+  const uint8_t payload_type = 127;
+  ASSERT_EQ(0, rtp_sender_->RegisterPayload(payload_name, payload_type, 90000,
+                                            0, 1500));
+  uint8_t payload[] = {47, 11, 32, 93, 89};
+  rtp_sender_->SetStorePacketsStatus(true, 10);
+
+  const int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  EXPECT_CALL(mock_paced_sender_, InsertPacket(_, _, kSeqNum, _, _, _));
+  ASSERT_EQ(0, rtp_sender_->SendOutgoingData(kVideoFrameKey, payload_type,
+                                             1234, capture_time_ms, payload,
+                                             sizeof(payload), nullptr));
+  ASSERT_EQ(1u, callback.stages_.size());
+  EXPECT_EQ(kVideoFramePacketized, callback.stages_[0].first);
+  EXPECT_EQ(capture_time_ms, callback.stages_[0].second);
+
+  // The pacer uses corrected capture times, the callback does not.
+  fake_clock_.AdvanceTimeMilliseconds(10);
+  rtp_sender_->TimeToSendPacket(kSeqNum, capture_time_ms + 1234, false);
+  ASSERT_EQ(2u, callback.stages_.size());
+  EXPECT_EQ(kVideoFrameSent, callback.stages_[1].first);
+  EXPECT_EQ(capture_time_ms, callback.stages_[1].second);
+
+  // Retransmissions are not reported.
+  rtp_sender_->TimeToSendPacket(kSeqNum, capture_time_ms + 1234, true);
+  EXPECT_EQ(2u, callback.stages_.size());
+
+  rtp_sender_.reset();
+}
+
 TEST_F(RtpSenderTest, BitrateCallbacks) {
   class TestCallback : public BitrateStatisticsObserver {
    public:
@@ -1033,7 +1078,7 @@ TEST_F(RtpSenderTest, BitrateCallbacks) {
   } callback;
   rtp_sender_.reset(new RTPSender(false, &fake_clock_, &transport_, nullptr,
                                   nullptr, nullptr, nullptr, &callback, nullptr,
-                                  nullptr));
+                                  nullptr, nullptr));
 
   // Simulate kNumPackets sent with kPacketInterval ms intervals.
   const uint32_t kNumPackets = 15;
@@ -1092,7 +1137,7 @@ class RtpSenderAudioTest : public RtpSenderTest {
     payload_ = kAudioPayload;
     rtp_sender_.reset(new RTPSender(true, &fake_clock_, &transport_, nullptr,
                                     nullptr, nullptr, nullptr, nullptr, nullptr,
-                                    nullptr));
+                                    nullptr, nullptr));
     rtp_sender_->SetSequenceNumber(kSeqNum);
   }
 };
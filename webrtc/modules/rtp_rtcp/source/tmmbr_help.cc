@@ -11,8 +11,11 @@
 #include "webrtc/modules/rtp_rtcp/source/tmmbr_help.h"
 
 #include <assert.h>
-#include <limits>
 #include <string.h>
+
+#include <algorithm>
+#include <limits>
+
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_config.h"
 
 namespace webrtc {
@@ -102,15 +105,10 @@ TMMBRHelp::TMMBRHelp()
       _candidateSet(),
       _boundingSet(),
       _boundingSetToSend(),
-      _ptrIntersectionBoundingSet(NULL),
-      _ptrMaxPRBoundingSet(NULL) {
+      _numBoundingSet(0) {
 }
 
 TMMBRHelp::~TMMBRHelp() {
-  delete [] _ptrIntersectionBoundingSet;
-  delete [] _ptrMaxPRBoundingSet;
-  _ptrIntersectionBoundingSet = 0;
-  _ptrMaxPRBoundingSet = 0;
   delete _criticalSection;
 }
 
@@ -119,16 +117,11 @@ TMMBRHelp::VerifyAndAllocateBoundingSet(uint32_t minimumSize)
 {
     CriticalSectionScoped lock(_criticalSection);
 
-    if(minimumSize > _boundingSet.sizeOfSet())
+    if(minimumSize > _intersectionBoundingSet.size())
     {
         // make sure that our buffers are big enough
-        if(_ptrIntersectionBoundingSet)
-        {
-            delete [] _ptrIntersectionBoundingSet;
-            delete [] _ptrMaxPRBoundingSet;
-        }
-        _ptrIntersectionBoundingSet = new float[minimumSize];
-        _ptrMaxPRBoundingSet = new float[minimumSize];
+        _intersectionBoundingSet.resize(minimumSize);
+        _maxPRBoundingSet.resize(minimumSize);
     }
     _boundingSet.VerifyAndAllocateSet(minimumSize);
     return &_boundingSet;
@@ -206,238 +199,179 @@ TMMBRHelp::FindTMMBRBoundingSet(TMMBRSet*& boundingSet)
 {
     CriticalSectionScoped lock(_criticalSection);
 
-    // Work on local variable, will be modified
-    TMMBRSet    candidateSet;
-    candidateSet.VerifyAndAllocateSet(_candidateSet.sizeOfSet());
+    // Keep the candidates of the previous call, to find what changed.
+    _candidates.swap(_previousCandidates);
+    _candidates.clear();
 
     // TODO(hta) Figure out if this should be lengthOfSet instead.
     for (uint32_t i = 0; i < _candidateSet.sizeOfSet(); i++)
     {
         if(_candidateSet.Tmmbr(i))
         {
-            candidateSet.AddEntry(_candidateSet.Tmmbr(i),
-                                  _candidateSet.PacketOH(i),
-                                  _candidateSet.Ssrc(i));
+            Candidate candidate = {_candidateSet.Tmmbr(i),
+                                   _candidateSet.PacketOH(i),
+                                   _candidateSet.Ssrc(i),
+                                   static_cast<uint32_t>(_candidates.size())};
+            _candidates.push_back(candidate);
         }
         else
         {
             // make sure this is zero if tmmbr = 0
             assert(_candidateSet.PacketOH(i) == 0);
-            // Old code:
-            // _candidateSet.ptrPacketOHSet[i] = 0;
         }
     }
 
-    // Number of set candidates
-    int32_t numSetCandidates = candidateSet.lengthOfSet();
-    // Find bounding set
-    uint32_t numBoundingSet = 0;
-    if (numSetCandidates > 0)
+    if (_candidates.empty())
     {
-        numBoundingSet =  FindTMMBRBoundingSet(numSetCandidates, candidateSet);
-        if(numBoundingSet < 1 || (numBoundingSet > _candidateSet.sizeOfSet()))
-        {
-            return -1;
-        }
-        boundingSet = &_boundingSet;
+        _sortedCandidates.clear();
+        _numBoundingSet = 0;
+        return 0;
     }
-    return numBoundingSet;
+    // Find bounding set, unless it is the one of the previous call.
+    if (SortCandidates())
+    {
+        _numBoundingSet = FindTMMBRBoundingSetOfSortedCandidates();
+    }
+    boundingSet = &_boundingSet;
+    return _numBoundingSet;
 }
 
+bool TMMBRHelp::CandidateLessThan(const Candidate& a, const Candidate& b) {
+  if (a.packet_oh != b.packet_oh)
+    return a.packet_oh < b.packet_oh;
+  return a.index < b.index;
+}
 
-int32_t
-TMMBRHelp::FindTMMBRBoundingSet(int32_t numCandidates, TMMBRSet& candidateSet)
-{
-    CriticalSectionScoped lock(_criticalSection);
+bool TMMBRHelp::SortCandidates() {
+  if (_candidates.size() == _previousCandidates.size()) {
+    size_t numChanged = 0;
+    size_t changed = 0;
+    for (size_t i = 0; i < _candidates.size(); ++i) {
+      if (_candidates[i].tmmbr != _previousCandidates[i].tmmbr ||
+          _candidates[i].packet_oh != _previousCandidates[i].packet_oh ||
+          _candidates[i].ssrc != _previousCandidates[i].ssrc) {
+        ++numChanged;
+        changed = i;
+      }
+    }
+    if (numChanged == 0)
+      return false;
+    if (numChanged == 1) {
+      // Move the changed candidate to its new place, shifting the ones in
+      // between by one.
+      std::vector<Candidate>::iterator from =
+          std::lower_bound(_sortedCandidates.begin(), _sortedCandidates.end(),
+                           _previousCandidates[changed], CandidateLessThan);
+      std::vector<Candidate>::iterator to =
+          std::lower_bound(_sortedCandidates.begin(), _sortedCandidates.end(),
+                           _candidates[changed], CandidateLessThan);
+      assert(from->index == changed);
+      if (to > from) {
+        std::rotate(from, from + 1, to);
+        *(to - 1) = _candidates[changed];
+      } else {
+        std::rotate(to, from, from + 1);
+        *to = _candidates[changed];
+      }
+      return true;
+    }
+  }
+  _sortedCandidates = _candidates;
+  std::sort(_sortedCandidates.begin(), _sortedCandidates.end(),
+            CandidateLessThan);
+  return true;
+}
 
-    uint32_t numBoundingSet = 0;
-    VerifyAndAllocateBoundingSet(candidateSet.sizeOfSet());
+float TMMBRHelp::IntersectionPacketRate(const Candidate& candidate,
+                                        uint32_t boundingIdx) const {
+  return float(candidate.tmmbr - _boundingSet.Tmmbr(boundingIdx)) * 1000 /
+         (8 * (candidate.packet_oh - _boundingSet.PacketOH(boundingIdx)));
+}
 
-    if (numCandidates == 1)
-    {
-        // TODO(hta): lengthOfSet instead of sizeOfSet?
-        for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
-        {
-            if (candidateSet.Tmmbr(i) > 0)
-            {
-                _boundingSet.AddEntry(candidateSet.Tmmbr(i),
-                                    candidateSet.PacketOH(i),
-                                    candidateSet.Ssrc(i));
-                numBoundingSet++;
-            }
-        }
-        return (numBoundingSet == 1) ? 1 : -1;
+uint32_t TMMBRHelp::FindTMMBRBoundingSetOfSortedCandidates() {
+  const std::vector<Candidate>& candidates = _sortedCandidates;
+  const size_t numCandidates = candidates.size();
+  uint32_t numBoundingSet = 0;
+  VerifyAndAllocateBoundingSet(_candidateSet.sizeOfSet());
+
+  // 1. For tuples with the same OH, only the first one with the lowest
+  //    bitrate is a candidate. The candidates are sorted by OH, so the tuples
+  //    with the same OH are next to each other.
+  // 2. Select the candidate with the lowest bitrate.
+  //    (If more than 1, choose the one w/ highest OH).
+  size_t minIndex = 0;
+  size_t groupMinIndex = 0;
+  size_t i = 0;
+  for (; i < numCandidates; ++i) {
+    if (candidates[i].packet_oh != candidates[groupMinIndex].packet_oh ||
+        candidates[i].tmmbr < candidates[groupMinIndex].tmmbr) {
+      groupMinIndex = i;
     }
-
-    // 1. Sort by increasing packetOH
-    for (int i = candidateSet.sizeOfSet() - 1; i >= 0; i--)
-    {
-        for (int j = 1; j <= i; j++)
-        {
-            if (candidateSet.PacketOH(j-1) > candidateSet.PacketOH(j))
-            {
-                candidateSet.SwapEntries(j-1, j);
-            }
-        }
+    if ((i + 1 == numCandidates ||
+         candidates[i + 1].packet_oh != candidates[i].packet_oh) &&
+        candidates[groupMinIndex].tmmbr <= candidates[minIndex].tmmbr) {
+      minIndex = groupMinIndex;
     }
-    // 2. For tuples with same OH, keep the one w/ the lowest bitrate
-    for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
-    {
-        if (candidateSet.Tmmbr(i) > 0)
-        {
-            // get min bitrate for packets w/ same OH
-            uint32_t currentPacketOH = candidateSet.PacketOH(i);
-            uint32_t currentMinTMMBR = candidateSet.Tmmbr(i);
-            uint32_t currentMinIndexTMMBR = i;
-            for (uint32_t j = i+1; j < candidateSet.sizeOfSet(); j++)
-            {
-                if(candidateSet.PacketOH(j) == currentPacketOH)
-                {
-                    if(candidateSet.Tmmbr(j) < currentMinTMMBR)
-                    {
-                        currentMinTMMBR = candidateSet.Tmmbr(j);
-                        currentMinIndexTMMBR = j;
-                    }
-                }
-            }
-            // keep lowest bitrate
-            for (uint32_t j = 0; j < candidateSet.sizeOfSet(); j++)
-            {
-              if(candidateSet.PacketOH(j) == currentPacketOH
-                  && j != currentMinIndexTMMBR)
-                {
-                    candidateSet.ClearEntry(j);
-                }
-            }
-        }
-    }
-    // 3. Select and remove tuple w/ lowest tmmbr.
-    // (If more than 1, choose the one w/ highest OH).
-    uint32_t minTMMBR = 0;
-    uint32_t minIndexTMMBR = 0;
-    for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
-    {
-        if (candidateSet.Tmmbr(i) > 0)
-        {
-            minTMMBR = candidateSet.Tmmbr(i);
-            minIndexTMMBR = i;
-            break;
-        }
+  }
+  // first member of selected list
+  const Candidate& first = candidates[minIndex];
+  _boundingSet.SetEntry(numBoundingSet, first.tmmbr, first.packet_oh,
+                        first.ssrc);
+  // set intersection value
+  _intersectionBoundingSet[numBoundingSet] = 0;
+  // calculate its maximum packet rate (where its line crosses x-axis)
+  _maxPRBoundingSet[numBoundingSet] =
+      first.tmmbr * 1000 / float(8 * first.packet_oh);
+  numBoundingSet++;
+
+  // 3. The candidates with lower OH are discarded (next tuple must be
+  //    steeper), go through the ones with higher OH in order.
+  for (i = minIndex + 1; i < numCandidates &&
+       candidates[i].packet_oh == first.packet_oh; ++i) {
+  }
+  groupMinIndex = i;
+  for (; i < numCandidates; ++i) {
+    if (candidates[i].packet_oh != candidates[groupMinIndex].packet_oh ||
+        candidates[i].tmmbr < candidates[groupMinIndex].tmmbr) {
+      groupMinIndex = i;
     }
-
-    for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
-    {
-        if (candidateSet.Tmmbr(i) > 0 && candidateSet.Tmmbr(i) <= minTMMBR)
-        {
-            // get min bitrate
-            minTMMBR = candidateSet.Tmmbr(i);
-            minIndexTMMBR = i;
-        }
+    if (i + 1 < numCandidates &&
+        candidates[i + 1].packet_oh == candidates[i].packet_oh) {
+      continue;
     }
-    // first member of selected list
-    _boundingSet.SetEntry(numBoundingSet,
-                          candidateSet.Tmmbr(minIndexTMMBR),
-                          candidateSet.PacketOH(minIndexTMMBR),
-                          candidateSet.Ssrc(minIndexTMMBR));
-
-    // set intersection value
-    _ptrIntersectionBoundingSet[numBoundingSet] = 0;
-    // calculate its maximum packet rate (where its line crosses x-axis)
-    _ptrMaxPRBoundingSet[numBoundingSet]
-        = _boundingSet.Tmmbr(numBoundingSet) * 1000
-        / float(8 * _boundingSet.PacketOH(numBoundingSet));
-    numBoundingSet++;
-    // remove from candidate list
-    candidateSet.ClearEntry(minIndexTMMBR);
-    numCandidates--;
-
-    // 4. Discard from candidate list all tuple w/ lower OH
-    // (next tuple must be steeper)
-    for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
-    {
-        if(candidateSet.Tmmbr(i) > 0
-            && candidateSet.PacketOH(i) < _boundingSet.PacketOH(0))
-        {
-            candidateSet.ClearEntry(i);
-            numCandidates--;
-        }
+    const Candidate& candidate = candidates[groupMinIndex];
+
+    // 4. Calculate packet rate and intersection of the current
+    //    line with line of last tuple in selected list
+    float packetRate = IntersectionPacketRate(candidate, numBoundingSet - 1);
+
+    // 5. If the packet rate is equal or lower than intersection of
+    //    last tuple in selected list,
+    //    remove last tuple in selected list & go back to step 4
+    while (packetRate <= _intersectionBoundingSet[numBoundingSet - 1]) {
+      // The first tuple has the lowest bitrate, so the packet rate at its
+      // intersection is always higher than 0.
+      assert(numBoundingSet > 1);
+      numBoundingSet--;
+      _boundingSet.ClearEntry(numBoundingSet);
+      _intersectionBoundingSet[numBoundingSet] = 0;
+      _maxPRBoundingSet[numBoundingSet] = 0;
+      packetRate = IntersectionPacketRate(candidate, numBoundingSet - 1);
     }
 
-    if (numCandidates == 0)
-    {
-        // Should be true already:_boundingSet.lengthOfSet = numBoundingSet;
-        assert(_boundingSet.lengthOfSet() == numBoundingSet);
-        return numBoundingSet;
+    // 6. If packet rate is lower than maximum packet rate of
+    //    last tuple in selected list, add current tuple to selected
+    //    list
+    if (packetRate < _maxPRBoundingSet[numBoundingSet - 1]) {
+      _boundingSet.SetEntry(numBoundingSet, candidate.tmmbr,
+                            candidate.packet_oh, candidate.ssrc);
+      _intersectionBoundingSet[numBoundingSet] = packetRate;
+      _maxPRBoundingSet[numBoundingSet] =
+          candidate.tmmbr * 1000 / float(8 * candidate.packet_oh);
+      numBoundingSet++;
     }
-
-    bool getNewCandidate = true;
-    int curCandidateTMMBR = 0;
-    int curCandidateIndex = 0;
-    int curCandidatePacketOH = 0;
-    int curCandidateSSRC = 0;
-    do
-    {
-        if (getNewCandidate)
-        {
-            // 5. Remove first remaining tuple from candidate list
-            for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
-            {
-                if (candidateSet.Tmmbr(i) > 0)
-                {
-                    curCandidateTMMBR    = candidateSet.Tmmbr(i);
-                    curCandidatePacketOH = candidateSet.PacketOH(i);
-                    curCandidateSSRC     = candidateSet.Ssrc(i);
-                    curCandidateIndex    = i;
-                    candidateSet.ClearEntry(curCandidateIndex);
-                    break;
-                }
-            }
-        }
-
-        // 6. Calculate packet rate and intersection of the current
-        // line with line of last tuple in selected list
-        float packetRate
-            = float(curCandidateTMMBR
-                    - _boundingSet.Tmmbr(numBoundingSet-1))*1000
-            / (8*(curCandidatePacketOH
-                  - _boundingSet.PacketOH(numBoundingSet-1)));
-
-        // 7. If the packet rate is equal or lower than intersection of
-        //    last tuple in selected list,
-        //    remove last tuple in selected list & go back to step 6
-        if(packetRate <= _ptrIntersectionBoundingSet[numBoundingSet-1])
-        {
-            // remove last tuple and goto step 6
-            numBoundingSet--;
-            _boundingSet.ClearEntry(numBoundingSet);
-            _ptrIntersectionBoundingSet[numBoundingSet] = 0;
-            _ptrMaxPRBoundingSet[numBoundingSet]        = 0;
-            getNewCandidate = false;
-        } else
-        {
-            // 8. If packet rate is lower than maximum packet rate of
-            // last tuple in selected list, add current tuple to selected
-            // list
-            if (packetRate < _ptrMaxPRBoundingSet[numBoundingSet-1])
-            {
-                _boundingSet.SetEntry(numBoundingSet,
-                                      curCandidateTMMBR,
-                                      curCandidatePacketOH,
-                                      curCandidateSSRC);
-                _ptrIntersectionBoundingSet[numBoundingSet] = packetRate;
-                _ptrMaxPRBoundingSet[numBoundingSet]
-                    = _boundingSet.Tmmbr(numBoundingSet)*1000
-                    / float(8*_boundingSet.PacketOH(numBoundingSet));
-                numBoundingSet++;
-            }
-            numCandidates--;
-            getNewCandidate = true;
-        }
-
-        // 9. Go back to step 5 if any tuple remains in candidate list
-    } while (numCandidates > 0);
-
-    return numBoundingSet;
+  }
+  return numBoundingSet;
 }
 
 bool TMMBRHelp::IsOwner(const uint32_t ssrc,
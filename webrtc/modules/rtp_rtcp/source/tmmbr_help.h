@@ -86,6 +86,10 @@ public:
     TMMBRSet* BoundingSetToSend();
 
     TMMBRSet* VerifyAndAllocateCandidateSet(const uint32_t minimumSize);
+    // Finds the bounding set of the candidate set in O(n log n). When the
+    // candidates are the same as in the previous call, the previous bounding
+    // set is kept, and when only one of them changed, it is moved into place
+    // among the sorted candidates instead of sorting them all again.
     int32_t FindTMMBRBoundingSet(TMMBRSet*& boundingSet);
     int32_t SetTMMBRBoundingSetToSend(
         const TMMBRSet* boundingSetToSend,
@@ -99,16 +103,48 @@ protected:
     TMMBRSet*   VerifyAndAllocateBoundingSet(uint32_t minimumSize);
     int32_t VerifyAndAllocateBoundingSetToSend(uint32_t minimumSize);
 
-    int32_t FindTMMBRBoundingSet(int32_t numCandidates, TMMBRSet& candidateSet);
-
 private:
+    // A candidate tuple and its position among the set candidates, which
+    // orders the tuples with the same packet overhead.
+    struct Candidate {
+      uint32_t tmmbr;
+      uint32_t packet_oh;
+      uint32_t ssrc;
+      uint32_t index;
+    };
+
+    // Orders by increasing packet overhead, then by position.
+    static bool CandidateLessThan(const Candidate& a, const Candidate& b);
+
+    // Brings |_sortedCandidates| up to date with |_candidates|, given the
+    // candidates of the previous call in |_previousCandidates|. Returns false
+    // if no candidate changed.
+    bool SortCandidates();
+
+    // Finds the bounding set of |_sortedCandidates|, which must not be empty.
+    uint32_t FindTMMBRBoundingSetOfSortedCandidates();
+
+    // The packet rate where the lines of |candidate| and of the tuple at
+    // |boundingIdx| in the bounding set intersect.
+    float IntersectionPacketRate(const Candidate& candidate,
+                                 uint32_t boundingIdx) const;
+
     CriticalSectionWrapper* _criticalSection;
     TMMBRSet                _candidateSet;
     TMMBRSet                _boundingSet;
     TMMBRSet                _boundingSetToSend;
 
-    float*                  _ptrIntersectionBoundingSet;
-    float*                  _ptrMaxPRBoundingSet;
+    // The set candidates of the last FindTMMBRBoundingSet() call, in the
+    // order of the candidate set, and sorted with CandidateLessThan().
+    std::vector<Candidate>  _candidates;
+    std::vector<Candidate>  _sortedCandidates;
+    // The candidates of the call before, while looking for changes.
+    std::vector<Candidate>  _previousCandidates;
+    // Size of the bounding set found for |_candidates|.
+    uint32_t                _numBoundingSet;
+
+    std::vector<float>      _intersectionBoundingSet;
+    std::vector<float>      _maxPRBoundingSet;
 };
 }  // namespace webrtc
 
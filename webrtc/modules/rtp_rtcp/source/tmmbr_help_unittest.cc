@@ -0,0 +1,314 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/tmmbr_help.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/test/random.h"
+
+namespace webrtc {
+namespace {
+
+struct Tuple {
+  uint32_t tmmbr;
+  uint32_t packet_oh;
+  uint32_t ssrc;
+};
+
+bool operator==(const Tuple& a, const Tuple& b) {
+  return a.tmmbr == b.tmmbr && a.packet_oh == b.packet_oh && a.ssrc == b.ssrc;
+}
+
+::std::ostream& operator<<(::std::ostream& os, const Tuple& tuple) {
+  return os << "(" << tuple.tmmbr << ", " << tuple.packet_oh << ", "
+            << tuple.ssrc << ")";
+}
+
+// The bounding set as TMMBRHelp used to find it, with nested loops over the
+// candidates. It could end with an empty tuple, which is left out.
+std::vector<Tuple> FindBoundingSetWithNestedLoops(
+    std::vector<Tuple> candidates) {
+  if (candidates.size() <= 1)
+    return candidates;
+  const Tuple kCleared = {0, 0, 0};
+  const int size = static_cast<int>(candidates.size());
+  int num_candidates = size;
+
+  // 1. Sort by increasing packet overhead.
+  for (int i = size - 1; i >= 0; --i) {
+    for (int j = 1; j <= i; ++j) {
+      if (candidates[j - 1].packet_oh > candidates[j].packet_oh)
+        std::swap(candidates[j - 1], candidates[j]);
+    }
+  }
+  // 2. For tuples with the same overhead, keep the one with the lowest
+  // bitrate.
+  for (int i = 0; i < size; ++i) {
+    if (candidates[i].tmmbr == 0)
+      continue;
+    const uint32_t packet_oh = candidates[i].packet_oh;
+    int min_index = i;
+    for (int j = i + 1; j < size; ++j) {
+      if (candidates[j].packet_oh == packet_oh &&
+          candidates[j].tmmbr < candidates[min_index].tmmbr) {
+        min_index = j;
+      }
+    }
+    for (int j = 0; j < size; ++j) {
+      if (candidates[j].packet_oh == packet_oh && j != min_index)
+        candidates[j] = kCleared;
+    }
+  }
+  // 3. Select the tuple with the lowest bitrate, and the highest overhead of
+  // those.
+  int min_index = 0;
+  for (int i = 0; i < size; ++i) {
+    if (candidates[i].tmmbr > 0 &&
+        (candidates[min_index].tmmbr == 0 ||
+         candidates[i].tmmbr <= candidates[min_index].tmmbr)) {
+      min_index = i;
+    }
+  }
+  std::vector<Tuple> bounding_set(1, candidates[min_index]);
+  std::vector<float> intersection(1, 0);
+  std::vector<float> max_packet_rate(
+      1, bounding_set[0].tmmbr * 1000 / float(8 * bounding_set[0].packet_oh));
+  candidates[min_index] = kCleared;
+  --num_candidates;
+
+  // 4. Discard the tuples with lower overhead.
+  for (int i = 0; i < size; ++i) {
+    if (candidates[i].tmmbr > 0 &&
+        candidates[i].packet_oh < bounding_set[0].packet_oh) {
+      candidates[i] = kCleared;
+      --num_candidates;
+    }
+  }
+
+  bool get_new_candidate = true;
+  int tmmbr = 0;
+  int packet_oh = 0;
+  int ssrc = 0;
+  while (num_candidates > 0) {
+    // 5. Remove the first remaining tuple.
+    if (get_new_candidate) {
+      for (int i = 0; i < size; ++i) {
+        if (candidates[i].tmmbr > 0) {
+          tmmbr = candidates[i].tmmbr;
+          packet_oh = candidates[i].packet_oh;
+          ssrc = candidates[i].ssrc;
+          candidates[i] = kCleared;
+          break;
+        }
+      }
+    }
+    // 6. Intersect with the last selected tuple.
+    const Tuple& last = bounding_set.back();
+    const float packet_rate = float(tmmbr - last.tmmbr) * 1000 /
+                              (8 * (packet_oh - last.packet_oh));
+    // 7. Remove the last selected tuple if the current one is below it.
+    if (packet_rate <= intersection.back()) {
+      bounding_set.pop_back();
+      intersection.pop_back();
+      max_packet_rate.pop_back();
+      get_new_candidate = false;
+      continue;
+    }
+    // 8. Select the current tuple if it is below the last one somewhere.
+    if (packet_rate < max_packet_rate.back()) {
+      const Tuple tuple = {static_cast<uint32_t>(tmmbr),
+                           static_cast<uint32_t>(packet_oh),
+                           static_cast<uint32_t>(ssrc)};
+      bounding_set.push_back(tuple);
+      intersection.push_back(packet_rate);
+      max_packet_rate.push_back(tuple.tmmbr * 1000 /
+                                float(8 * tuple.packet_oh));
+    }
+    --num_candidates;
+    get_new_candidate = true;
+  }
+  bounding_set.erase(
+      std::remove(bounding_set.begin(), bounding_set.end(), kCleared),
+      bounding_set.end());
+  return bounding_set;
+}
+
+std::vector<Tuple> FindBoundingSet(TMMBRHelp* tmmbr_help,
+                                   const std::vector<Tuple>& candidates) {
+  TMMBRSet* candidate_set =
+      tmmbr_help->VerifyAndAllocateCandidateSet(candidates.size());
+  for (const Tuple& tuple : candidates)
+    candidate_set->AddEntry(tuple.tmmbr, tuple.packet_oh, tuple.ssrc);
+  TMMBRSet* bounding_set = nullptr;
+  const int32_t num_bounding_set =
+      tmmbr_help->FindTMMBRBoundingSet(bounding_set);
+  std::vector<Tuple> tuples;
+  for (int32_t i = 0; i < num_bounding_set; ++i) {
+    const Tuple tuple = {bounding_set->Tmmbr(i), bounding_set->PacketOH(i),
+                         bounding_set->Ssrc(i)};
+    tuples.push_back(tuple);
+  }
+  return tuples;
+}
+
+Tuple RandomTuple(test::Random* random, uint32_t ssrc) {
+  const Tuple tuple = {static_cast<uint32_t>(random->Rand(1, 10000)),
+                       static_cast<uint32_t>(random->Rand(1, 100)), ssrc};
+  return tuple;
+}
+
+std::vector<Tuple> RandomTuples(test::Random* random, int num_tuples) {
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < num_tuples; ++i)
+    tuples.push_back(RandomTuple(random, i + 1));
+  return tuples;
+}
+
+}  // namespace
+
+TEST(TMMBRHelpTest, NoCandidates) {
+  TMMBRHelp tmmbr_help;
+  EXPECT_TRUE(FindBoundingSet(&tmmbr_help, std::vector<Tuple>()).empty());
+}
+
+TEST(TMMBRHelpTest, OneCandidate) {
+  TMMBRHelp tmmbr_help;
+  const std::vector<Tuple> candidates = {{300, 40, 1}};
+  EXPECT_EQ(candidates, FindBoundingSet(&tmmbr_help, candidates));
+  EXPECT_TRUE(tmmbr_help.IsOwner(1, 1));
+  EXPECT_FALSE(tmmbr_help.IsOwner(2, 1));
+}
+
+TEST(TMMBRHelpTest, KeepsTuplesBelowTheOthers) {
+  TMMBRHelp tmmbr_help;
+  const Tuple a = {100, 10, 1};
+  const Tuple b = {300, 40, 2};
+  const Tuple c = {350, 50, 3};
+  const Tuple d = {1000, 60, 4};
+  const Tuple e = {200, 10, 5};
+  // |b| is below |a| at high packet rates, but |c| is lower there.
+  EXPECT_EQ(std::vector<Tuple>({a, b}), FindBoundingSet(&tmmbr_help, {b, a}));
+  EXPECT_EQ(std::vector<Tuple>({a, c}),
+            FindBoundingSet(&tmmbr_help, {e, d, c, b, a}));
+  // A lower bitrate with a higher overhead is lower at any packet rate.
+  const Tuple f = {90, 11, 6};
+  EXPECT_EQ(std::vector<Tuple>({f, c}),
+            FindBoundingSet(&tmmbr_help, {e, d, c, b, a, f}));
+}
+
+TEST(TMMBRHelpTest, KeepsFirstOfEqualTuples) {
+  TMMBRHelp tmmbr_help;
+  const Tuple a = {100, 10, 1};
+  const Tuple b = {100, 10, 2};
+  const Tuple c = {100, 20, 3};
+  EXPECT_EQ(std::vector<Tuple>({a}), FindBoundingSet(&tmmbr_help, {a, b}));
+  EXPECT_EQ(std::vector<Tuple>({b}), FindBoundingSet(&tmmbr_help, {b, a}));
+  // Of the tuples with the lowest bitrate, the one with the highest overhead.
+  EXPECT_EQ(std::vector<Tuple>({c}), FindBoundingSet(&tmmbr_help, {a, c, b}));
+}
+
+TEST(TMMBRHelpTest, IgnoresUnusedCandidates) {
+  TMMBRHelp tmmbr_help;
+  TMMBRSet* candidate_set = tmmbr_help.VerifyAndAllocateCandidateSet(10);
+  candidate_set->SetEntry(3, 300, 40, 1);
+  candidate_set->SetEntry(7, 100, 10, 2);
+  TMMBRSet* bounding_set = nullptr;
+  ASSERT_EQ(2, tmmbr_help.FindTMMBRBoundingSet(bounding_set));
+  EXPECT_EQ(2u, bounding_set->Ssrc(0));
+  EXPECT_EQ(1u, bounding_set->Ssrc(1));
+}
+
+TEST(TMMBRHelpTest, MatchesNestedLoops) {
+  test::Random random(0x1234);
+  TMMBRHelp tmmbr_help;
+  for (int i = 0; i < 2000; ++i) {
+    const std::vector<Tuple> candidates =
+        RandomTuples(&random, random.Rand(1, 200));
+    ASSERT_EQ(FindBoundingSetWithNestedLoops(candidates),
+              FindBoundingSet(&tmmbr_help, candidates));
+  }
+}
+
+TEST(TMMBRHelpTest, MatchesNestedLoopsAfterOneChange) {
+  test::Random random(0x1234);
+  TMMBRHelp tmmbr_help;
+  for (int num_tuples : {2, 10, 100}) {
+    std::vector<Tuple> candidates = RandomTuples(&random, num_tuples);
+    for (int i = 0; i < 1000; ++i) {
+      const int changed = random.Rand(0, num_tuples - 1);
+      candidates[changed] = RandomTuple(&random, candidates[changed].ssrc);
+      // Same overheads and bitrates as other tuples, now and then.
+      if (i % 3 == 0) {
+        const Tuple& other = candidates[random.Rand(0, num_tuples - 1)];
+        candidates[changed].packet_oh = other.packet_oh;
+        if (i % 2 == 0)
+          candidates[changed].tmmbr = other.tmmbr;
+      }
+      ASSERT_EQ(FindBoundingSetWithNestedLoops(candidates),
+                FindBoundingSet(&tmmbr_help, candidates))
+          << num_tuples << " tuples, change " << i;
+      ASSERT_EQ(FindBoundingSetWithNestedLoops(candidates),
+                FindBoundingSet(&tmmbr_help, candidates));
+    }
+  }
+}
+
+// Times finding the bounding set of 1-1000 tuples, as RTCPReceiver does on
+// every received TMMBR, when all the tuples are new, when one of them
+// changed and when none did.
+TEST(TMMBRHelpTest, DISABLED_BoundingSetBenchmark) {
+  const int kNumSets = 16;
+  test::Random random(0x1234);
+  for (int num_tuples : {1, 10, 100, 1000}) {
+    const int iterations = std::max(10, 100000 / num_tuples);
+    std::vector<std::vector<Tuple>> sets;
+    for (int i = 0; i < kNumSets; ++i)
+      sets.push_back(RandomTuples(&random, num_tuples));
+
+    uint64_t start = rtc::TimeNanos();
+    for (int i = 0; i < iterations; ++i)
+      FindBoundingSetWithNestedLoops(sets[i % kNumSets]);
+    const double nested_loops_us =
+        (rtc::TimeNanos() - start) / 1000.0 / iterations;
+
+    TMMBRHelp tmmbr_help;
+    start = rtc::TimeNanos();
+    for (int i = 0; i < iterations; ++i)
+      FindBoundingSet(&tmmbr_help, sets[i % kNumSets]);
+    const double new_us = (rtc::TimeNanos() - start) / 1000.0 / iterations;
+
+    std::vector<Tuple> candidates = sets[0];
+    start = rtc::TimeNanos();
+    for (int i = 0; i < iterations; ++i) {
+      const int changed = i % num_tuples;
+      candidates[changed].tmmbr = sets[i % kNumSets][changed].tmmbr;
+      FindBoundingSet(&tmmbr_help, candidates);
+    }
+    const double changed_us =
+        (rtc::TimeNanos() - start) / 1000.0 / iterations;
+
+    start = rtc::TimeNanos();
+    for (int i = 0; i < iterations; ++i)
+      FindBoundingSet(&tmmbr_help, candidates);
+    const double same_us = (rtc::TimeNanos() - start) / 1000.0 / iterations;
+
+    printf("%4d tuples: nested loops %.2f us, all new %.2f us, one changed "
+           "%.2f us, none changed %.2f us.\n", num_tuples, nested_loops_us,
+           new_us, changed_us, same_us);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_MAIN_INTERFACE_MOCK_MOCK_VIDEO_CODING_MODULE_H_
+#define WEBRTC_MODULES_VIDEO_CODING_MAIN_INTERFACE_MOCK_MOCK_VIDEO_CODING_MODULE_H_
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "webrtc/modules/video_coding/main/interface/video_coding.h"
+
+namespace webrtc {
+
+class MockVideoCodingModule : public VideoCodingModule {
+ public:
+  MOCK_METHOD0(TimeUntilNextProcess, int64_t());
+  MOCK_METHOD0(Process, int32_t());
+
+  MOCK_METHOD3(RegisterSendCodec,
+               int32_t(const VideoCodec* sendCodec,
+                       uint32_t numberOfCores,
+                       uint32_t maxPayloadSize));
+  MOCK_CONST_METHOD0(GetSendCodec, const VideoCodec&());
+  MOCK_CONST_METHOD1(SendCodec, int32_t(VideoCodec* currentSendCodec));
+  MOCK_CONST_METHOD0(SendCodec, VideoCodecType());
+  MOCK_METHOD3(RegisterExternalEncoder,
+               int32_t(VideoEncoder* externalEncoder,
+                       uint8_t payloadType,
+                       bool internalSource));
+  MOCK_METHOD2(CodecConfigParameters, int32_t(uint8_t* buffer, int32_t size));
+  MOCK_CONST_METHOD1(Bitrate, int(unsigned int* bitrate));
+  MOCK_CONST_METHOD1(FrameRate, int(unsigned int* framerate));
+  MOCK_METHOD3(SetChannelParameters,
+               int32_t(uint32_t target_bitrate, uint8_t lossRate, int64_t rtt));
+  MOCK_METHOD1(SetReceiveChannelParameters, int32_t(int64_t rtt));
+  MOCK_METHOD1(RegisterTransportCallback,
+               int32_t(VCMPacketizationCallback* transport));
+  MOCK_METHOD1(RegisterSendStatisticsCallback,
+               int32_t(VCMSendStatisticsCallback* sendStats));
+  MOCK_METHOD1(RegisterProtectionCallback,
+               int32_t(VCMProtectionCallback* protection));
+  MOCK_METHOD2(SetVideoProtection,
+               int32_t(VCMVideoProtection videoProtection, bool enable));
+  MOCK_METHOD3(AddVideoFrame,
+               int32_t(const VideoFrame& videoFrame,
+                       const VideoContentMetrics* contentMetrics,
+                       const CodecSpecificInfo* codecSpecificInfo));
+  MOCK_METHOD1(IntraFrameRequest, int32_t(int stream_index));
+  MOCK_METHOD1(EnableFrameDropper, int32_t(bool enable));
+
+  MOCK_METHOD3(RegisterReceiveCodec,
+               int32_t(const VideoCodec* receiveCodec,
+                       int32_t numberOfCores,
+                       bool requireKeyFrame));
+  MOCK_METHOD3(RegisterExternalDecoder,
+               int32_t(VideoDecoder* externalDecoder,
+                       uint8_t payloadType,
+                       bool internalRenderTiming));
+  MOCK_METHOD1(RegisterReceiveCallback,
+               int32_t(VCMReceiveCallback* receiveCallback));
+  MOCK_METHOD1(RegisterReceiveStatisticsCallback,
+               int32_t(VCMReceiveStatisticsCallback* receiveStats));
+  MOCK_METHOD1(RegisterDecoderTimingCallback,
+               int32_t(VCMDecoderTimingCallback* decoderTiming));
+  MOCK_METHOD1(RegisterFrameTypeCallback,
+               int32_t(VCMFrameTypeCallback* frameTypeCallback));
+  MOCK_METHOD1(RegisterPacketRequestCallback,
+               int32_t(VCMPacketRequestCallback* callback));
+  MOCK_METHOD1(Decode, int32_t(uint16_t maxWaitTimeMs));
+  MOCK_METHOD1(RegisterRenderBufferSizeCallback,
+               int(VCMRenderBufferSizeCallback* callback));
+  MOCK_METHOD0(ResetDecoder, int32_t());
+  MOCK_CONST_METHOD1(ReceiveCodec, int32_t(VideoCodec* currentReceiveCodec));
+  MOCK_CONST_METHOD0(ReceiveCodec, VideoCodecType());
+  MOCK_METHOD3(IncomingPacket,
+               int32_t(const uint8_t* incomingPayload,
+                       size_t payloadLength,
+                       const WebRtcRTPHeader& rtpInfo));
+  MOCK_METHOD1(SetMinimumPlayoutDelay, int32_t(uint32_t minPlayoutDelayMs));
+  MOCK_METHOD1(SetRenderDelay, int32_t(uint32_t timeMS));
+  MOCK_CONST_METHOD0(Delay, int32_t());
+  MOCK_CONST_METHOD0(DiscardedPackets, uint32_t());
+  MOCK_METHOD2(SetReceiverRobustnessMode,
+               int(ReceiverRobustness robustnessMode,
+                   VCMDecodeErrorMode errorMode));
+  MOCK_METHOD1(SetDecodeErrorMode, void(VCMDecodeErrorMode decode_error_mode));
+  MOCK_METHOD3(SetNackSettings,
+               void(size_t max_nack_list_size,
+                    int max_packet_age_to_nack,
+                    int max_incomplete_time_ms));
+  MOCK_METHOD1(SetMinReceiverDelay, int(int desired_delay_ms));
+  MOCK_METHOD0(SuspendBelowMinBitrate, void());
+  MOCK_CONST_METHOD0(VideoSuspended, bool());
+  MOCK_METHOD1(RegisterPreDecodeImageCallback,
+               void(EncodedImageCallback* observer));
+  MOCK_METHOD1(RegisterPostEncodeImageCallback,
+               void(EncodedImageCallback* post_encode_callback));
+  MOCK_METHOD0(TriggerDecoderShutdown, void());
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_MAIN_INTERFACE_MOCK_MOCK_VIDEO_CODING_MODULE_H_
@@ -101,6 +101,8 @@ class VCMReceiveStatisticsCallback {
   virtual void OnReceiveRatesUpdated(uint32_t bitRate, uint32_t frameRate) = 0;
   virtual void OnDiscardedPacketsUpdated(int discarded_packets) = 0;
   virtual void OnFrameCountsUpdated(const FrameCounts& frame_counts) = 0;
+  // Called when the frame with RTP timestamp |rtp_timestamp| reaches |stage|.
+  virtual void OnFrameStage(VideoFrameStage stage, uint32_t rtp_timestamp) {}
 
  protected:
   virtual ~VCMReceiveStatisticsCallback() {
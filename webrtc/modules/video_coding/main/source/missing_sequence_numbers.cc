@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/main/source/missing_sequence_numbers.h"
+
+#include <string.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/interface/module_common_types.h"
+
+namespace webrtc {
+namespace {
+
+// Returns the index of the lowest set bit in |bits|, which must not be 0,
+// using a de Bruijn sequence.
+int LowestSetBit(uint64_t bits) {
+  static const int kIndex[64] = {
+      0,  1,  48, 2,  57, 49, 28, 3,  61, 58, 50, 42, 38, 29, 17, 4,
+      62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+      63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+      46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9,  13, 8,  7,  6};
+  const uint64_t kDeBruijn = 0x03f79d71b4cb0a89ull;
+  return kIndex[((bits & (~bits + 1)) * kDeBruijn) >> 58];
+}
+
+}  // namespace
+
+MissingSequenceNumbers::MissingSequenceNumbers() : size_(0), oldest_(0) {
+  memset(bits_, 0, sizeof(bits_));
+}
+
+uint16_t MissingSequenceNumbers::oldest() const {
+  RTC_DCHECK(!empty());
+  return oldest_;
+}
+
+bool MissingSequenceNumbers::Contains(uint16_t sequence_number) const {
+  return ((bits_[sequence_number / kBitsPerWord] >>
+           (sequence_number % kBitsPerWord)) & 1) != 0;
+}
+
+void MissingSequenceNumbers::AddRange(uint16_t first, uint16_t end) {
+  for (uint16_t sequence_number = first; sequence_number != end;
+       ++sequence_number) {
+    if (Contains(sequence_number))
+      continue;
+    bits_[sequence_number / kBitsPerWord] |=
+        uint64_t{1} << (sequence_number % kBitsPerWord);
+    if (size_ == 0 || IsNewerSequenceNumber(oldest_, sequence_number))
+      oldest_ = sequence_number;
+    ++size_;
+  }
+}
+
+void MissingSequenceNumbers::Remove(uint16_t sequence_number) {
+  if (!Contains(sequence_number))
+    return;
+  bits_[sequence_number / kBitsPerWord] &=
+      ~(uint64_t{1} << (sequence_number % kBitsPerWord));
+  --size_;
+  if (size_ > 0 && sequence_number == oldest_)
+    oldest_ = Next(static_cast<uint16_t>(sequence_number + 1));
+}
+
+void MissingSequenceNumbers::RemoveUpTo(uint16_t sequence_number) {
+  // Stops at the first newer sequence number, or once the set is empty, so
+  // that only the sequence numbers in the set are walked.
+  while (size_ > 0 && !IsNewerSequenceNumber(oldest_, sequence_number)) {
+    Remove(oldest_);
+  }
+}
+
+void MissingSequenceNumbers::Clear() {
+  while (size_ > 0)
+    Remove(oldest_);
+}
+
+void MissingSequenceNumbers::GetSequenceNumbers(
+    std::vector<uint16_t>* sequence_numbers) const {
+  sequence_numbers->reserve(sequence_numbers->size() + size_);
+  uint16_t sequence_number = oldest_;
+  for (size_t i = 0; i < size_; ++i) {
+    sequence_number = Next(sequence_number);
+    sequence_numbers->push_back(sequence_number);
+    ++sequence_number;
+  }
+}
+
+uint16_t MissingSequenceNumbers::Next(uint16_t sequence_number) const {
+  RTC_DCHECK(!empty());
+  while (true) {
+    const uint64_t bits = bits_[sequence_number / kBitsPerWord] >>
+                          (sequence_number % kBitsPerWord);
+    if (bits != 0)
+      return sequence_number + LowestSetBit(bits);
+    // Skip to the start of the next word.
+    sequence_number += kBitsPerWord - sequence_number % kBitsPerWord;
+  }
+}
+
+}  // namespace webrtc
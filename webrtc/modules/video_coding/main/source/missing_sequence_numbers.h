@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_MISSING_SEQUENCE_NUMBERS_H_
+#define WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_MISSING_SEQUENCE_NUMBERS_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// The sequence numbers of missing packets, ordered from oldest to newest
+// with wrap-around, like a std::set ordered by IsNewerSequenceNumber(). The
+// sequence numbers must span less than half the sequence number space.
+//
+// The set is a bitmap over the whole sequence number space, so adding,
+// removing and looking up a sequence number is O(1) and never allocates.
+// Walking the set visits 64 sequence numbers at a time.
+class MissingSequenceNumbers {
+ public:
+  MissingSequenceNumbers();
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  // The oldest sequence number in the set, which must not be empty.
+  uint16_t oldest() const;
+
+  bool Contains(uint16_t sequence_number) const;
+
+  // Adds the sequence numbers from |first| up to, but not including, |end|.
+  void AddRange(uint16_t first, uint16_t end);
+
+  // Removes |sequence_number|, if it is in the set.
+  void Remove(uint16_t sequence_number);
+
+  // Removes |sequence_number| and all older sequence numbers.
+  void RemoveUpTo(uint16_t sequence_number);
+
+  void Clear();
+
+  // Appends the sequence numbers to |sequence_numbers|, oldest first.
+  void GetSequenceNumbers(std::vector<uint16_t>* sequence_numbers) const;
+
+ private:
+  static const int kBitsPerWord = 64;
+  static const int kNumWords = (1 << 16) / kBitsPerWord;
+
+  // Returns the first sequence number in the set, starting at
+  // |sequence_number|. The set must not be empty.
+  uint16_t Next(uint16_t sequence_number) const;
+
+  uint64_t bits_[kNumWords];
+  size_t size_;
+  uint16_t oldest_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MissingSequenceNumbers);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_MISSING_SEQUENCE_NUMBERS_H_
@@ -0,0 +1,284 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/main/source/missing_sequence_numbers.h"
+
+#include <stdio.h>
+
+#include <deque>
+#include <set>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/test/random.h"
+
+namespace webrtc {
+namespace {
+
+// The std::set that MissingSequenceNumbers replaces in VCMJitterBuffer.
+struct SequenceNumberLessThan {
+  bool operator()(uint16_t sequence_number1, uint16_t sequence_number2) const {
+    return IsNewerSequenceNumber(sequence_number2, sequence_number1);
+  }
+};
+typedef std::set<uint16_t, SequenceNumberLessThan> SequenceNumberSet;
+
+std::vector<uint16_t> GetSequenceNumbers(
+    const MissingSequenceNumbers& missing) {
+  std::vector<uint16_t> sequence_numbers;
+  missing.GetSequenceNumbers(&sequence_numbers);
+  return sequence_numbers;
+}
+
+// Applies the operations of a receiver with packet loss and retransmissions
+// to a MissingSequenceNumbers or a SequenceNumberSet, through |Ops|.
+template <typename Ops>
+class LossSimulation {
+ public:
+  LossSimulation(float loss_rate, int retransmission_delay_packets)
+      : loss_rate_(loss_rate),
+        retransmission_delay_packets_(retransmission_delay_packets),
+        random_(0x5eed),
+        sequence_number_(0xff00),  // Wraps around early on.
+        latest_received_(sequence_number_ - 1) {}
+
+  // Sends the next packet, which is lost with probability |loss_rate_|.
+  // Lost packets are retransmitted after |retransmission_delay_packets_|,
+  // and the retransmissions are lost too with the same probability.
+  void SendPacket() {
+    while (!retransmissions_.empty() &&
+           retransmissions_.front().first == sequence_number_) {
+      ReceivePacket(retransmissions_.front().second);
+      retransmissions_.pop_front();
+    }
+    ReceivePacket(sequence_number_);
+    ++sequence_number_;
+  }
+
+  // Drops the sequence numbers older than the decoder's position, which
+  // trails the newest packet by |delay_packets|.
+  void Decode(int delay_packets) {
+    Ops::RemoveUpTo(&missing_, sequence_number_ - delay_packets);
+  }
+
+  void GetNackList(std::vector<uint16_t>* nack_list) const {
+    nack_list->clear();
+    Ops::GetSequenceNumbers(missing_, nack_list);
+  }
+
+ private:
+  void ReceivePacket(uint16_t sequence_number) {
+    if (random_.Rand() < loss_rate_) {
+      retransmissions_.push_back(std::make_pair(
+          static_cast<uint16_t>(sequence_number_ +
+                                retransmission_delay_packets_),
+          sequence_number));
+      return;
+    }
+    if (IsNewerSequenceNumber(sequence_number, latest_received_)) {
+      Ops::AddRange(&missing_, latest_received_ + 1, sequence_number);
+      latest_received_ = sequence_number;
+    } else {
+      Ops::Remove(&missing_, sequence_number);
+    }
+  }
+
+  const float loss_rate_;
+  const int retransmission_delay_packets_;
+  test::Random random_;
+  uint16_t sequence_number_;
+  uint16_t latest_received_;
+  // Sequence number at which to retransmit, and the lost sequence number.
+  std::deque<std::pair<uint16_t, uint16_t>> retransmissions_;
+  typename Ops::Set missing_;
+};
+
+struct BitmapOps {
+  typedef MissingSequenceNumbers Set;
+  static void AddRange(Set* set, uint16_t first, uint16_t end) {
+    set->AddRange(first, end);
+  }
+  static void Remove(Set* set, uint16_t sequence_number) {
+    set->Remove(sequence_number);
+  }
+  static void RemoveUpTo(Set* set, uint16_t sequence_number) {
+    set->RemoveUpTo(sequence_number);
+  }
+  static void GetSequenceNumbers(const Set& set,
+                                 std::vector<uint16_t>* sequence_numbers) {
+    set.GetSequenceNumbers(sequence_numbers);
+  }
+};
+
+struct StdSetOps {
+  typedef SequenceNumberSet Set;
+  static void AddRange(Set* set, uint16_t first, uint16_t end) {
+    for (uint16_t i = first; i != end; ++i)
+      set->insert(set->end(), i);
+  }
+  static void Remove(Set* set, uint16_t sequence_number) {
+    set->erase(sequence_number);
+  }
+  static void RemoveUpTo(Set* set, uint16_t sequence_number) {
+    set->erase(set->begin(), set->upper_bound(sequence_number));
+  }
+  static void GetSequenceNumbers(const Set& set,
+                                 std::vector<uint16_t>* sequence_numbers) {
+    sequence_numbers->assign(set.begin(), set.end());
+  }
+};
+
+// 5000 packets per second, a NACK list every 10 ms, 100 ms RTT and a
+// decoder 200 ms behind.
+const int kPacketsPerSecond = 5000;
+const int kPacketsPerNackList = kPacketsPerSecond / 100;
+const int kRetransmissionDelayPackets = kPacketsPerSecond / 10;
+const int kDecodeDelayPackets = kPacketsPerSecond / 5;
+
+// Does nothing, to measure the cost of the simulation itself.
+struct NullOps {
+  struct Set {};
+  static void AddRange(Set* set, uint16_t first, uint16_t end) {}
+  static void Remove(Set* set, uint16_t sequence_number) {}
+  static void RemoveUpTo(Set* set, uint16_t sequence_number) {}
+  static void GetSequenceNumbers(const Set& set,
+                                 std::vector<uint16_t>* sequence_numbers) {}
+};
+
+// Returns the time in microseconds that the simulation takes per second of
+// media, and the time per NACK list in steady state in |us_per_nack_list|.
+template <typename Ops>
+double MeasureUsPerSecond(float loss_rate,
+                          int seconds,
+                          double* us_per_nack_list) {
+  const int kNackLists = 10000;
+  LossSimulation<Ops> simulation(loss_rate, kRetransmissionDelayPackets);
+  std::vector<uint16_t> nack_list;
+  uint64_t start = rtc::TimeNanos();
+  for (int i = 0; i < seconds * kPacketsPerSecond; ++i) {
+    simulation.SendPacket();
+    if (i % kPacketsPerNackList == 0) {
+      simulation.Decode(kDecodeDelayPackets);
+      simulation.GetNackList(&nack_list);
+    }
+  }
+  const double us_per_second = (rtc::TimeNanos() - start) / 1000.0 / seconds;
+
+  start = rtc::TimeNanos();
+  for (int i = 0; i < kNackLists; ++i)
+    simulation.GetNackList(&nack_list);
+  *us_per_nack_list = (rtc::TimeNanos() - start) / 1000.0 / kNackLists;
+  return us_per_second;
+}
+
+}  // namespace
+
+TEST(MissingSequenceNumbersTest, Empty) {
+  MissingSequenceNumbers missing;
+  EXPECT_TRUE(missing.empty());
+  EXPECT_EQ(0u, missing.size());
+  EXPECT_FALSE(missing.Contains(0));
+  EXPECT_TRUE(GetSequenceNumbers(missing).empty());
+  missing.RemoveUpTo(100);
+  missing.Remove(100);
+  EXPECT_TRUE(missing.empty());
+}
+
+TEST(MissingSequenceNumbersTest, AddAndRemove) {
+  MissingSequenceNumbers missing;
+  missing.AddRange(10, 13);
+  missing.AddRange(200, 201);
+  EXPECT_EQ(4u, missing.size());
+  EXPECT_EQ(10, missing.oldest());
+  EXPECT_TRUE(missing.Contains(11));
+  EXPECT_FALSE(missing.Contains(13));
+  EXPECT_EQ(std::vector<uint16_t>({10, 11, 12, 200}),
+            GetSequenceNumbers(missing));
+
+  missing.Remove(11);
+  missing.Remove(11);
+  missing.Remove(10);
+  EXPECT_EQ(2u, missing.size());
+  EXPECT_EQ(12, missing.oldest());
+  EXPECT_EQ(std::vector<uint16_t>({12, 200}), GetSequenceNumbers(missing));
+
+  missing.Clear();
+  EXPECT_TRUE(missing.empty());
+  EXPECT_FALSE(missing.Contains(200));
+}
+
+TEST(MissingSequenceNumbersTest, OrdersAcrossWrapAround) {
+  MissingSequenceNumbers missing;
+  missing.AddRange(0xfffe, 2);
+  EXPECT_EQ(0xfffe, missing.oldest());
+  EXPECT_EQ(std::vector<uint16_t>({0xfffe, 0xffff, 0, 1}),
+            GetSequenceNumbers(missing));
+
+  missing.RemoveUpTo(0xffff);
+  EXPECT_EQ(std::vector<uint16_t>({0, 1}), GetSequenceNumbers(missing));
+  EXPECT_EQ(0, missing.oldest());
+}
+
+TEST(MissingSequenceNumbersTest, RemoveUpTo) {
+  MissingSequenceNumbers missing;
+  missing.AddRange(100, 110);
+  missing.RemoveUpTo(99);
+  EXPECT_EQ(10u, missing.size());
+  missing.RemoveUpTo(104);
+  EXPECT_EQ(105, missing.oldest());
+  EXPECT_EQ(5u, missing.size());
+  missing.RemoveUpTo(1000);
+  EXPECT_TRUE(missing.empty());
+}
+
+TEST(MissingSequenceNumbersTest, MatchesStdSetUnderLoss) {
+  LossSimulation<BitmapOps> bitmap(0.2f, kRetransmissionDelayPackets);
+  LossSimulation<StdSetOps> std_set(0.2f, kRetransmissionDelayPackets);
+  std::vector<uint16_t> bitmap_list;
+  std::vector<uint16_t> std_set_list;
+  // Long enough for the sequence numbers to wrap around twice.
+  for (int i = 0; i < 150000; ++i) {
+    bitmap.SendPacket();
+    std_set.SendPacket();
+    if (i % kPacketsPerNackList == 0) {
+      bitmap.Decode(kDecodeDelayPackets);
+      std_set.Decode(kDecodeDelayPackets);
+      bitmap.GetNackList(&bitmap_list);
+      std_set.GetNackList(&std_set_list);
+      ASSERT_EQ(std_set_list, bitmap_list) << "After " << i << " packets";
+    }
+  }
+}
+
+TEST(MissingSequenceNumbersTest, DISABLED_NackListBenchmark) {
+  const int kSeconds = 60;
+  printf("Time spent on missing packets at %d packets/s, per second and per "
+         "NACK list:\n", kPacketsPerSecond);
+  for (float loss_rate : {0.01f, 0.05f, 0.1f, 0.2f}) {
+    double unused;
+    const double base_us =
+        MeasureUsPerSecond<NullOps>(loss_rate, kSeconds, &unused);
+    double std_set_list_us;
+    const double std_set_us =
+        MeasureUsPerSecond<StdSetOps>(loss_rate, kSeconds, &std_set_list_us) -
+        base_us;
+    double bitmap_list_us;
+    const double bitmap_us =
+        MeasureUsPerSecond<BitmapOps>(loss_rate, kSeconds, &bitmap_list_us) -
+        base_us;
+    printf("%2.0f%% loss: std::set %.1f us, %.2f us; bitmap %.1f us, "
+           "%.2f us.\n", loss_rate * 100, std_set_us, std_set_list_us,
+           bitmap_us, bitmap_list_us);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Replays a set of RTP captures through the VCM receive pipeline on a
+// simulated clock, decoding as fast as possible on multiple threads, and
+// prints a summary of the per-frame decode times and PSNR.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/base/format_macros.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/video_coding/main/test/batch_replayer.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+
+DEFINE_string(input_files, "",
+              "Comma separated list of rtpdump or pcap files to replay.");
+DEFINE_string(ssrcs, "",
+              "Comma separated list of SSRCs to decode. Decodes all video "
+              "streams if empty.");
+DEFINE_bool(split_streams, false,
+            "Replay every stream of a file as a separate job, so that the "
+            "streams of a file are also decoded in parallel.");
+DEFINE_int32(threads, 0,
+             "Number of files to replay in parallel. Defaults to the number "
+             "of cores.");
+DEFINE_string(out_dir, "",
+              "Directory to write the decoded frames to. Frames are only "
+              "decoded if empty.");
+DEFINE_string(reference_file, "",
+              "I420 file to compute the PSNR of the decoded frames against.");
+DEFINE_int32(width, 352, "Width of the frames in the reference file.");
+DEFINE_int32(height, 288, "Height of the frames in the reference file.");
+DEFINE_string(stats_file, "",
+              "File to write comma separated per-frame statistics to.");
+DEFINE_int64(max_runtime_ms, -1,
+             "Maximum simulated time to play each file for, or -1 to play "
+             "the whole file.");
+DEFINE_int32(vp8_payload_type, 100, "VP8 payload type.");
+DEFINE_int32(vp9_payload_type, 101, "VP9 payload type.");
+DEFINE_int32(red_payload_type, 96, "RED payload type.");
+DEFINE_int32(fec_payload_type, 97, "ULPFEC payload type.");
+
+namespace {
+
+std::vector<std::string> SplitList(const std::string& list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty())
+      items.push_back(item);
+  }
+  return items;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  google::SetUsageMessage(
+      "Replays RTP captures on a simulated clock.\n"
+      "Example: rtp_batch_player --input_files=a.rtp,b.pcap --threads=8");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  std::vector<std::string> input_files = SplitList(FLAGS_input_files);
+  if (input_files.empty()) {
+    fprintf(stderr, "No input files given.\n");
+    return 1;
+  }
+
+  std::set<uint32_t> ssrcs;
+  std::vector<std::string> ssrc_list = SplitList(FLAGS_ssrcs);
+  for (size_t i = 0; i < ssrc_list.size(); ++i) {
+    char* end = NULL;
+    unsigned long ssrc = strtoul(ssrc_list[i].c_str(), &end, 0);
+    if (*end != '\0') {
+      fprintf(stderr, "Invalid SSRC: %s\n", ssrc_list[i].c_str());
+      return 1;
+    }
+    ssrcs.insert(static_cast<uint32_t>(ssrc));
+  }
+
+  webrtc::rtpplayer::ReplayJob settings;
+  settings.ssrcs = ssrcs;
+  settings.reference_filename = FLAGS_reference_file;
+  settings.reference_width = FLAGS_width;
+  settings.reference_height = FLAGS_height;
+  std::vector<webrtc::rtpplayer::ReplayJob> jobs =
+      webrtc::rtpplayer::CreateReplayJobs(input_files, settings, FLAGS_out_dir,
+                                          FLAGS_split_streams);
+
+  webrtc::rtpplayer::PayloadTypes payload_types;
+  payload_types.push_back(webrtc::rtpplayer::PayloadCodecTuple(
+      static_cast<uint8_t>(FLAGS_fec_payload_type), "ULPFEC",
+      webrtc::kVideoCodecULPFEC));
+  payload_types.push_back(webrtc::rtpplayer::PayloadCodecTuple(
+      static_cast<uint8_t>(FLAGS_red_payload_type), "RED",
+      webrtc::kVideoCodecRED));
+  payload_types.push_back(webrtc::rtpplayer::PayloadCodecTuple(
+      static_cast<uint8_t>(FLAGS_vp8_payload_type), "VP8",
+      webrtc::kVideoCodecVP8));
+  payload_types.push_back(webrtc::rtpplayer::PayloadCodecTuple(
+      static_cast<uint8_t>(FLAGS_vp9_payload_type), "VP9",
+      webrtc::kVideoCodecVP9));
+
+  int threads = FLAGS_threads;
+  if (threads <= 0)
+    threads = static_cast<int>(webrtc::CpuInfo::DetectNumberOfCores());
+
+  webrtc::rtpplayer::BatchReplayer replayer(payload_types, threads,
+                                            FLAGS_max_runtime_ms);
+  const uint64_t start_us = rtc::TimeMicros();
+  std::vector<webrtc::rtpplayer::ReplayResult> results = replayer.Run(jobs);
+  const uint64_t elapsed_us = rtc::TimeMicros() - start_us;
+
+  webrtc::rtpplayer::PrintReplaySummary(jobs, results, stdout);
+  printf("Replayed %" PRIuS " jobs on %d threads in %.1f s.\n", jobs.size(),
+         threads, elapsed_us / 1e6);
+
+  if (!FLAGS_stats_file.empty() &&
+      !webrtc::rtpplayer::WriteFrameStats(jobs, results, FLAGS_stats_file)) {
+    fprintf(stderr, "Unable to write %s\n", FLAGS_stats_file.c_str());
+    return 1;
+  }
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (results[i].status < 0)
+      return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,432 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/main/test/batch_replayer.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <map>
+
+#include "webrtc/base/format_macros.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_coding/main/test/vcm_payload_sink_factory.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/test/rtp_file_reader.h"
+#include "webrtc/test/testsupport/frame_reader.h"
+
+namespace webrtc {
+namespace rtpplayer {
+namespace {
+
+const bool kProtectionEnabled = true;
+const VCMVideoProtection kProtectionMethod = kProtectionNack;
+const int64_t kRttMs = 0;
+const uint32_t kRenderDelayMs = 0;
+const uint32_t kMinPlayoutDelayMs = 0;
+// Simulated time to keep decoding after the last packet, so that frames still
+// held by the jitter buffer are released.
+const int64_t kDrainTimeMs = 1000;
+
+// Collects the statistics of every decoded frame of a job and compares the
+// frames against the job's reference file.
+class FrameStatsCollector : public DecodedFrameObserver {
+ public:
+  FrameStatsCollector(const ReplayJob& job,
+                      std::vector<DecodedFrameStats>* frames)
+      : job_(job), frames_(frames) {
+    assert(frames);
+  }
+
+  ~FrameStatsCollector() override {
+    for (ReferenceMap::iterator it = references_.begin();
+         it != references_.end(); ++it) {
+      delete it->second;
+    }
+  }
+
+  void OnDecodedFrame(uint32_t ssrc,
+                      const VideoFrame& frame,
+                      int64_t decode_time_us) override {
+    DecodedFrameStats stats;
+    stats.ssrc = ssrc;
+    stats.timestamp = frame.timestamp();
+    stats.render_time_ms = frame.render_time_ms();
+    stats.width = frame.width();
+    stats.height = frame.height();
+    stats.decode_time_us = decode_time_us;
+    stats.psnr = ComparePsnr(ssrc, frame);
+    frames_->push_back(stats);
+  }
+
+ private:
+  // The reference file is read separately for every stream.
+  struct Reference {
+    Reference(const std::string& filename, size_t frame_length)
+        : reader(filename, frame_length),
+          buffer(new uint8_t[frame_length]),
+          valid(reader.Init()) {}
+
+    test::FrameReaderImpl reader;
+    rtc::scoped_ptr<uint8_t[]> buffer;
+    VideoFrame frame;
+    bool valid;
+  };
+  typedef std::map<uint32_t, Reference*> ReferenceMap;
+
+  double ComparePsnr(uint32_t ssrc, const VideoFrame& frame) {
+    if (job_.reference_filename.empty() ||
+        frame.width() != job_.reference_width ||
+        frame.height() != job_.reference_height) {
+      return -1;
+    }
+    Reference* reference = references_[ssrc];
+    if (reference == NULL) {
+      reference = new Reference(
+          job_.reference_filename,
+          CalcBufferSize(kI420, job_.reference_width, job_.reference_height));
+      references_[ssrc] = reference;
+    }
+    if (!reference->valid)
+      return -1;
+    if (!reference->reader.ReadFrame(reference->buffer.get())) {
+      reference->valid = false;
+      return -1;
+    }
+    if (reference->frame.CreateFrame(reference->buffer.get(),
+                                     job_.reference_width,
+                                     job_.reference_height,
+                                     kVideoRotation_0) < 0) {
+      return -1;
+    }
+    return I420PSNR(&reference->frame, &frame);
+  }
+
+  const ReplayJob& job_;
+  std::vector<DecodedFrameStats>* frames_;
+  ReferenceMap references_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(FrameStatsCollector);
+};
+
+// Returns the |percentile|th smallest of |values|, which is sorted.
+int64_t Percentile(const std::vector<int64_t>& values, int percentile) {
+  if (values.empty())
+    return 0;
+  size_t index = (values.size() - 1) * percentile / 100;
+  return values[index];
+}
+
+void PrintStats(const char* name,
+                const std::vector<DecodedFrameStats>& frames,
+                FILE* file) {
+  std::vector<int64_t> decode_times_us;
+  decode_times_us.reserve(frames.size());
+  int64_t total_decode_time_us = 0;
+  double total_psnr = 0;
+  double min_psnr = 0;
+  int psnr_count = 0;
+  for (size_t i = 0; i < frames.size(); ++i) {
+    decode_times_us.push_back(frames[i].decode_time_us);
+    total_decode_time_us += frames[i].decode_time_us;
+    if (frames[i].psnr >= 0) {
+      if (psnr_count == 0 || frames[i].psnr < min_psnr)
+        min_psnr = frames[i].psnr;
+      total_psnr += frames[i].psnr;
+      ++psnr_count;
+    }
+  }
+  std::sort(decode_times_us.begin(), decode_times_us.end());
+  fprintf(file, "  %s: %" PRIuS " frames", name, frames.size());
+  if (!frames.empty()) {
+    fprintf(file,
+            ", decode time avg %.2f ms, p50 %.2f ms, p95 %.2f ms, "
+            "max %.2f ms",
+            total_decode_time_us / 1000.0 / frames.size(),
+            Percentile(decode_times_us, 50) / 1000.0,
+            Percentile(decode_times_us, 95) / 1000.0,
+            decode_times_us.back() / 1000.0);
+  }
+  if (psnr_count > 0) {
+    fprintf(file, ", PSNR avg %.2f dB, min %.2f dB", total_psnr / psnr_count,
+            min_psnr);
+  }
+  fprintf(file, "\n");
+}
+
+std::string OutputFilename(const std::string& out_dir,
+                           const std::string& input_filename) {
+  std::string::size_type slash = input_filename.find_last_of("/\\");
+  std::string name = slash == std::string::npos
+                         ? input_filename
+                         : input_filename.substr(slash + 1);
+  return out_dir + "/" + name + ".yuv";
+}
+
+const char* StatusName(int status) {
+  switch (status) {
+    case 1:
+      return "Success";
+    case 0:
+      return "Timeout";
+    default:
+      return "Failed";
+  }
+}
+
+}  // namespace
+
+ReplayJob::ReplayJob() : reference_width(0), reference_height(0) {}
+
+ReplayResult::ReplayResult()
+    : status(-1), simulated_time_ms(0), wall_time_ms(0) {}
+
+BatchReplayer::BatchReplayer(const PayloadTypes& payload_types,
+                             int num_threads,
+                             int64_t max_runtime_ms)
+    : payload_types_(payload_types),
+      num_threads_(std::max(num_threads, 1)),
+      max_runtime_ms_(max_runtime_ms),
+      crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      all_done_(EventWrapper::Create()),
+      jobs_(NULL),
+      results_(NULL),
+      next_job_(0),
+      completed_jobs_(0) {}
+
+BatchReplayer::~BatchReplayer() {}
+
+std::vector<ReplayResult> BatchReplayer::Run(
+    const std::vector<ReplayJob>& jobs) {
+  std::vector<ReplayResult> results(jobs.size());
+  const size_t num_threads =
+      std::min(static_cast<size_t>(num_threads_), jobs.size());
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < jobs.size(); ++i)
+      results[i] = RunJob(jobs[i]);
+    return results;
+  }
+
+  jobs_ = &jobs;
+  results_ = &results;
+  next_job_ = 0;
+  completed_jobs_ = 0;
+
+  std::vector<ThreadWrapper*> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    rtc::scoped_ptr<ThreadWrapper> thread(
+        ThreadWrapper::CreateThread(&WorkerThread, this, "BatchReplayer"));
+    thread->Start();
+    threads.push_back(thread.release());
+  }
+  // A ThreadWrapper may be stopped before its run function has returned
+  // false, so wait for all jobs to finish before stopping the threads.
+  all_done_->Wait(WEBRTC_EVENT_INFINITE);
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Stop();
+    delete threads[i];
+  }
+
+  jobs_ = NULL;
+  results_ = NULL;
+  return results;
+}
+
+ReplayResult BatchReplayer::RunJob(const ReplayJob& job) const {
+  ReplayResult result;
+  SimulatedClock clock(0);
+  VcmPayloadSinkFactory factory(job.output_filename, &clock,
+                                kProtectionEnabled, kProtectionMethod, kRttMs,
+                                kRenderDelayMs, kMinPlayoutDelayMs);
+  FrameStatsCollector collector(job, &result.frames);
+  factory.RegisterDecodedFrameObserver(&collector,
+                                       !job.output_filename.empty());
+  rtc::scoped_ptr<RtpPlayerInterface> rtp_player(
+      Create(job.input_filename, &factory, &clock, payload_types_, 0.0f,
+             kRttMs, false, job.ssrcs));
+  if (rtp_player.get() == NULL)
+    return result;
+
+  const uint64_t start_us = rtc::TimeMicros();
+  int ret = 0;
+  while ((ret = rtp_player->NextPacket(clock.TimeInMilliseconds())) == 0) {
+    if (factory.DecodeAndProcessAll(true) < 0) {
+      ret = -1;
+      break;
+    }
+    if (max_runtime_ms_ > -1 &&
+        clock.TimeInMilliseconds() >= max_runtime_ms_) {
+      break;
+    }
+    clock.AdvanceTimeMilliseconds(1);
+  }
+  if (ret == 1) {
+    for (int64_t i = 0; i < kDrainTimeMs; ++i) {
+      if (factory.DecodeAndProcessAll(true) < 0)
+        break;
+      clock.AdvanceTimeMilliseconds(1);
+    }
+  }
+  // The sinks must be destroyed before the factory.
+  rtp_player.reset();
+
+  result.status = ret;
+  result.simulated_time_ms = clock.TimeInMilliseconds();
+  result.wall_time_ms = (rtc::TimeMicros() - start_us) / 1000;
+  return result;
+}
+
+bool BatchReplayer::WorkerThread(void* obj) {
+  return static_cast<BatchReplayer*>(obj)->ProcessNextJob();
+}
+
+bool BatchReplayer::ProcessNextJob() {
+  size_t job;
+  {
+    CriticalSectionScoped cs(crit_sect_.get());
+    if (next_job_ >= jobs_->size())
+      return false;
+    job = next_job_++;
+  }
+  // Every job writes to its own preallocated result.
+  (*results_)[job] = RunJob((*jobs_)[job]);
+
+  CriticalSectionScoped cs(crit_sect_.get());
+  if (++completed_jobs_ == jobs_->size())
+    all_done_->Set();
+  return true;
+}
+
+std::vector<uint32_t> StreamsInFile(const std::string& filename,
+                                    const std::set<uint32_t>& filter) {
+  rtc::scoped_ptr<test::IndexedRtpFileReader> reader(
+      test::IndexedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                         filename));
+  if (reader.get() == NULL) {
+    reader.reset(test::IndexedRtpFileReader::Create(
+        test::RtpFileReader::kPcap, filename));
+  }
+  std::vector<uint32_t> streams;
+  if (reader.get() == NULL)
+    return streams;
+  std::map<uint32_t, size_t> packets_per_ssrc = reader->PacketsPerSsrc();
+  for (std::map<uint32_t, size_t>::const_iterator it =
+           packets_per_ssrc.begin();
+       it != packets_per_ssrc.end(); ++it) {
+    if (filter.empty() || filter.count(it->first) > 0)
+      streams.push_back(it->first);
+  }
+  return streams;
+}
+
+std::vector<ReplayJob> CreateReplayJobs(
+    const std::vector<std::string>& input_files,
+    const ReplayJob& settings,
+    const std::string& out_dir,
+    bool split_streams) {
+  std::vector<ReplayJob> jobs;
+  for (size_t i = 0; i < input_files.size(); ++i) {
+    ReplayJob job = settings;
+    job.input_filename = input_files[i];
+    job.output_filename =
+        out_dir.empty() ? "" : OutputFilename(out_dir, input_files[i]);
+    std::vector<uint32_t> streams;
+    if (split_streams)
+      streams = StreamsInFile(input_files[i], settings.ssrcs);
+    if (streams.empty()) {
+      jobs.push_back(job);
+      continue;
+    }
+    // Other than the SSRC filter, the jobs of a file are identical. The
+    // decoded frames of a stream go to a file named after its SSRC either
+    // way, see FileOutputFrameReceiver.
+    for (size_t j = 0; j < streams.size(); ++j) {
+      job.ssrcs.clear();
+      job.ssrcs.insert(streams[j]);
+      jobs.push_back(job);
+    }
+  }
+  return jobs;
+}
+
+void PrintReplaySummary(const std::vector<ReplayJob>& jobs,
+                        const std::vector<ReplayResult>& results,
+                        FILE* file) {
+  assert(jobs.size() == results.size());
+  std::vector<DecodedFrameStats> all_frames;
+  int64_t total_simulated_time_ms = 0;
+  int64_t total_wall_time_ms = 0;
+  int failed_jobs = 0;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    const ReplayResult& result = results[i];
+    fprintf(file, "%s: %s, %.1f s played in %.1f s",
+            jobs[i].input_filename.c_str(), StatusName(result.status),
+            result.simulated_time_ms / 1000.0, result.wall_time_ms / 1000.0);
+    if (result.wall_time_ms > 0) {
+      fprintf(file, " (%.1fx real time)",
+              static_cast<double>(result.simulated_time_ms) /
+                  result.wall_time_ms);
+    }
+    fprintf(file, "\n");
+
+    // Break the statistics down per stream.
+    std::map<uint32_t, std::vector<DecodedFrameStats> > streams;
+    for (size_t j = 0; j < result.frames.size(); ++j)
+      streams[result.frames[j].ssrc].push_back(result.frames[j]);
+    for (std::map<uint32_t, std::vector<DecodedFrameStats> >::iterator it =
+             streams.begin();
+         it != streams.end(); ++it) {
+      char name[32];
+      snprintf(name, sizeof(name), "SSRC %08x", it->first);
+      PrintStats(name, it->second, file);
+    }
+
+    all_frames.insert(all_frames.end(), result.frames.begin(),
+                      result.frames.end());
+    total_simulated_time_ms += result.simulated_time_ms;
+    total_wall_time_ms += result.wall_time_ms;
+    if (result.status != 1)
+      ++failed_jobs;
+  }
+  fprintf(file, "Total: %" PRIuS " jobs, %d not completed, %.1f s played in %.1f s "
+          "of decoding time\n", jobs.size(), failed_jobs,
+          total_simulated_time_ms / 1000.0, total_wall_time_ms / 1000.0);
+  PrintStats("All streams", all_frames, file);
+}
+
+bool WriteFrameStats(const std::vector<ReplayJob>& jobs,
+                     const std::vector<ReplayResult>& results,
+                     const std::string& filename) {
+  assert(jobs.size() == results.size());
+  FILE* file = fopen(filename.c_str(), "w");
+  if (file == NULL)
+    return false;
+  fprintf(file, "file,ssrc,timestamp,render_time_ms,width,height,"
+          "decode_time_us,psnr\n");
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    for (size_t j = 0; j < results[i].frames.size(); ++j) {
+      const DecodedFrameStats& frame = results[i].frames[j];
+      fprintf(file, "%s,%08x,%u,%lld,%d,%d,%lld,%.2f\n",
+              jobs[i].input_filename.c_str(), frame.ssrc, frame.timestamp,
+              static_cast<long long>(frame.render_time_ms), frame.width,
+              frame.height, static_cast<long long>(frame.decode_time_us),
+              frame.psnr);
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+}  // namespace rtpplayer
+}  // namespace webrtc
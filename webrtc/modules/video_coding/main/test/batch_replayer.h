@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_TEST_BATCH_REPLAYER_H_
+#define WEBRTC_MODULES_VIDEO_CODING_TEST_BATCH_REPLAYER_H_
+
+#include <stdio.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/video_coding/main/test/rtp_player.h"
+
+namespace webrtc {
+class CriticalSectionWrapper;
+class EventWrapper;
+
+namespace rtpplayer {
+
+// An RTP capture to replay.
+struct ReplayJob {
+  ReplayJob();
+
+  std::string input_filename;
+  // Streams to decode. Empty to decode all video streams in the file.
+  std::set<uint32_t> ssrcs;
+  // Base name of the decoded I420 files, see FileOutputFrameReceiver. Empty
+  // to only decode.
+  std::string output_filename;
+  // Optional I420 file to compute the PSNR of the decoded frames against.
+  // Frames are compared in order, so this is only meaningful for streams
+  // decoded without frame drops. Streams of another resolution are skipped.
+  std::string reference_filename;
+  int reference_width;
+  int reference_height;
+};
+
+struct DecodedFrameStats {
+  uint32_t ssrc;
+  uint32_t timestamp;
+  // Render time on the simulated clock.
+  int64_t render_time_ms;
+  int width;
+  int height;
+  // Wall clock time spent decoding the frame.
+  int64_t decode_time_us;
+  // PSNR against the reference file, or -1 if not compared.
+  double psnr;
+};
+
+struct ReplayResult {
+  ReplayResult();
+
+  // As returned by RtpPlayerInterface::NextPacket(): 1 if the whole file was
+  // played, 0 if the job ran into the time limit and -1 on error.
+  int status;
+  int64_t simulated_time_ms;
+  int64_t wall_time_ms;
+  std::vector<DecodedFrameStats> frames;
+};
+
+// Replays RTP captures through the same RTP receiver and VCM pipeline as
+// video_rtp_play.cc, but driven by a simulated clock so that a capture plays
+// as fast as it can be decoded. Every job gets its own clock and VCM
+// instances, which lets independent jobs run in parallel on a pool of
+// threads.
+class BatchReplayer {
+ public:
+  // |max_runtime_ms| limits the simulated duration of each job, or -1 for no
+  // limit.
+  BatchReplayer(const PayloadTypes& payload_types,
+                int num_threads,
+                int64_t max_runtime_ms);
+  ~BatchReplayer();
+
+  // Runs |jobs| on up to |num_threads| threads and returns the results in
+  // the order of |jobs|.
+  std::vector<ReplayResult> Run(const std::vector<ReplayJob>& jobs);
+
+  // Replays a single job on the calling thread.
+  ReplayResult RunJob(const ReplayJob& job) const;
+
+ private:
+  static bool WorkerThread(void* obj);
+  bool ProcessNextJob();
+
+  const PayloadTypes payload_types_;
+  const int num_threads_;
+  const int64_t max_runtime_ms_;
+  rtc::scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  rtc::scoped_ptr<EventWrapper> all_done_;
+  // Valid during Run().
+  const std::vector<ReplayJob>* jobs_;
+  std::vector<ReplayResult>* results_;
+  size_t next_job_;
+  size_t completed_jobs_;
+
+  RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(BatchReplayer);
+};
+
+// Returns the SSRCs of the RTP streams in the rtpdump or pcap file
+// |filename|, restricted to |filter| unless it is empty. Returns no SSRCs if
+// the file can't be read.
+std::vector<uint32_t> StreamsInFile(const std::string& filename,
+                                    const std::set<uint32_t>& filter);
+
+// Creates a job per file in |input_files|, with the SSRC filter and reference
+// of |settings|. The decoded frames of a file go to |out_dir|, unless it is
+// empty. With |split_streams|, every stream of a file becomes a separate job;
+// a file without any matching streams, e.g. one that can't be read, keeps a
+// single job so that its failure is reported.
+std::vector<ReplayJob> CreateReplayJobs(
+    const std::vector<std::string>& input_files,
+    const ReplayJob& settings,
+    const std::string& out_dir,
+    bool split_streams);
+
+// Prints per-job and aggregate decode statistics.
+void PrintReplaySummary(const std::vector<ReplayJob>& jobs,
+                        const std::vector<ReplayResult>& results,
+                        FILE* file);
+
+// Writes one comma separated line per decoded frame. Returns false if the
+// file could not be opened.
+bool WriteFrameStats(const std::vector<ReplayJob>& jobs,
+                     const std::vector<ReplayResult>& results,
+                     const std::string& filename);
+
+}  // namespace rtpplayer
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_TEST_BATCH_REPLAYER_H_
@@ -0,0 +1,200 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/main/test/batch_replayer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/test/rtp_file_writer.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+namespace rtpplayer {
+namespace {
+
+const uint32_t kSsrcs[] = {0x1234, 0x5678};
+const size_t kNumSsrcs = sizeof(kSsrcs) / sizeof(kSsrcs[0]);
+const int kNumPackets = 50;
+const int kPacketIntervalMs = 10;
+// No decoder is registered for this payload type, so the packets are played
+// without decoding any frames.
+const uint8_t kPayloadType = 120;
+
+// Writes an rtpdump with packets cycling through |kSsrcs|.
+void WriteRtpDump(const std::string& filename) {
+  rtc::scoped_ptr<test::RtpFileWriter> writer(
+      test::RtpFileWriter::Create(test::RtpFileWriter::kRtpDump, filename));
+  ASSERT_TRUE(writer.get() != NULL);
+  test::RtpPacket packet;
+  for (int i = 0; i < kNumPackets; ++i) {
+    const uint16_t sequence_number = static_cast<uint16_t>(i / kNumSsrcs);
+    memset(packet.data, 0, 100);
+    packet.data[0] = 0x80;  // Version 2.
+    packet.data[1] = kPayloadType;
+    ByteWriter<uint16_t>::WriteBigEndian(&packet.data[2], sequence_number);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet.data[4],
+                                         sequence_number * 900);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet.data[8],
+                                         kSsrcs[i % kNumSsrcs]);
+    packet.length = 100;
+    packet.original_length = 100;
+    packet.time_ms = i * kPacketIntervalMs;
+    ASSERT_TRUE(writer->WritePacket(&packet));
+  }
+}
+
+}  // namespace
+
+class BatchReplayerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rtpdump_file_ = test::OutputPath() + "batch_replayer.rtp";
+    missing_file_ = test::OutputPath() + "batch_replayer_missing.rtp";
+    WriteRtpDump(rtpdump_file_);
+  }
+
+  void TearDown() override { remove(rtpdump_file_.c_str()); }
+
+  std::string rtpdump_file_;
+  std::string missing_file_;
+};
+
+TEST_F(BatchReplayerTest, StreamsInFile) {
+  std::vector<uint32_t> streams =
+      StreamsInFile(rtpdump_file_, std::set<uint32_t>());
+  ASSERT_EQ(kNumSsrcs, streams.size());
+  EXPECT_EQ(kSsrcs[0], streams[0]);
+  EXPECT_EQ(kSsrcs[1], streams[1]);
+
+  std::set<uint32_t> filter;
+  filter.insert(kSsrcs[1]);
+  filter.insert(0xdead);
+  streams = StreamsInFile(rtpdump_file_, filter);
+  ASSERT_EQ(1u, streams.size());
+  EXPECT_EQ(kSsrcs[1], streams[0]);
+
+  EXPECT_TRUE(StreamsInFile(missing_file_, std::set<uint32_t>()).empty());
+}
+
+TEST_F(BatchReplayerTest, CreatesOneJobPerFile) {
+  std::vector<std::string> files;
+  files.push_back(rtpdump_file_);
+  files.push_back("dir/other.rtp");
+  ReplayJob settings;
+  settings.ssrcs.insert(kSsrcs[0]);
+  settings.reference_filename = "reference.yuv";
+
+  std::vector<ReplayJob> jobs = CreateReplayJobs(files, settings, "", false);
+  ASSERT_EQ(2u, jobs.size());
+  EXPECT_EQ(rtpdump_file_, jobs[0].input_filename);
+  EXPECT_EQ("dir/other.rtp", jobs[1].input_filename);
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    EXPECT_EQ(settings.ssrcs, jobs[i].ssrcs);
+    EXPECT_EQ("reference.yuv", jobs[i].reference_filename);
+    EXPECT_TRUE(jobs[i].output_filename.empty());
+  }
+
+  jobs = CreateReplayJobs(files, settings, "out", false);
+  ASSERT_EQ(2u, jobs.size());
+  EXPECT_EQ("out/other.rtp.yuv", jobs[1].output_filename);
+}
+
+TEST_F(BatchReplayerTest, SplitsStreamsIntoJobs) {
+  std::vector<std::string> files;
+  files.push_back(rtpdump_file_);
+  files.push_back(missing_file_);
+
+  std::vector<ReplayJob> jobs =
+      CreateReplayJobs(files, ReplayJob(), "", true);
+  // One job per stream, and the unreadable file keeps its job.
+  ASSERT_EQ(kNumSsrcs + 1, jobs.size());
+  for (size_t i = 0; i < kNumSsrcs; ++i) {
+    EXPECT_EQ(rtpdump_file_, jobs[i].input_filename);
+    ASSERT_EQ(1u, jobs[i].ssrcs.size());
+    EXPECT_EQ(kSsrcs[i], *jobs[i].ssrcs.begin());
+  }
+  EXPECT_EQ(missing_file_, jobs[kNumSsrcs].input_filename);
+  EXPECT_TRUE(jobs[kNumSsrcs].ssrcs.empty());
+
+  ReplayJob settings;
+  settings.ssrcs.insert(kSsrcs[1]);
+  jobs = CreateReplayJobs(files, settings, "", true);
+  ASSERT_EQ(2u, jobs.size());
+  EXPECT_EQ(settings.ssrcs, jobs[0].ssrcs);
+}
+
+TEST_F(BatchReplayerTest, PlaysFilesAndReportsFailures) {
+  std::vector<std::string> files;
+  files.push_back(missing_file_);
+  files.push_back(rtpdump_file_);
+  files.push_back(missing_file_);
+  std::vector<ReplayJob> jobs =
+      CreateReplayJobs(files, ReplayJob(), "", false);
+
+  for (int threads = 1; threads <= 2; ++threads) {
+    BatchReplayer replayer(PayloadTypes(), threads, -1);
+    std::vector<ReplayResult> results = replayer.Run(jobs);
+    ASSERT_EQ(jobs.size(), results.size());
+    EXPECT_EQ(-1, results[0].status);
+    EXPECT_EQ(1, results[1].status);
+    EXPECT_EQ(-1, results[2].status);
+    // The whole file is played on the simulated clock.
+    EXPECT_GE(results[1].simulated_time_ms,
+              (kNumPackets - 1) * kPacketIntervalMs);
+    EXPECT_TRUE(results[1].frames.empty());
+  }
+
+  // The simulated time of a job is limited by |max_runtime_ms|.
+  BatchReplayer limited(PayloadTypes(), 1, 100);
+  ReplayResult result = limited.RunJob(jobs[1]);
+  EXPECT_EQ(0, result.status);
+  EXPECT_EQ(100, result.simulated_time_ms);
+}
+
+TEST_F(BatchReplayerTest, WritesFrameStats) {
+  std::vector<ReplayJob> jobs(1);
+  jobs[0].input_filename = "a.rtp";
+  std::vector<ReplayResult> results(1);
+  DecodedFrameStats frame;
+  frame.ssrc = 0x1234;
+  frame.timestamp = 9000;
+  frame.render_time_ms = 100;
+  frame.width = 320;
+  frame.height = 240;
+  frame.decode_time_us = 1500;
+  frame.psnr = -1;
+  results[0].frames.push_back(frame);
+
+  const std::string stats_file = test::OutputPath() + "batch_replayer.csv";
+  ASSERT_TRUE(WriteFrameStats(jobs, results, stats_file));
+  FILE* file = fopen(stats_file.c_str(), "r");
+  ASSERT_TRUE(file != NULL);
+  char line[256];
+  ASSERT_TRUE(fgets(line, sizeof(line), file) != NULL);
+  ASSERT_TRUE(fgets(line, sizeof(line), file) != NULL);
+  EXPECT_STREQ("a.rtp,00001234,9000,100,320,240,1500,-1.00\n", line);
+  EXPECT_TRUE(fgets(line, sizeof(line), file) == NULL);
+  fclose(file);
+  remove(stats_file.c_str());
+
+  EXPECT_FALSE(WriteFrameStats(
+      jobs, results, test::OutputPath() + "missing_dir/batch_replayer.csv"));
+}
+
+}  // namespace rtpplayer
+}  // namespace webrtc
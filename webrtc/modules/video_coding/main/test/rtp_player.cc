@@ -366,10 +366,11 @@ class RtpPlayerImpl : public RtpPlayerInterface {
     }
 
     // Send any packets from packet source.
-    if (!end_of_file_ && (TimeUntilNextPacket() == 0 || first_packet_)) {
+    while (!end_of_file_ && (TimeUntilNextPacket() == 0 || first_packet_)) {
       if (first_packet_) {
         if (!packet_source_->NextPacket(&next_packet_))
           return 0;
+        next_rtp_time_ = next_packet_.time_ms;
         first_packet_rtp_time_ = next_packet_.time_ms;
         first_packet_time_ms_ = clock_->TimeInMilliseconds();
         first_packet_ = false;
@@ -396,6 +397,7 @@ class RtpPlayerImpl : public RtpPlayerInterface {
       else if (next_packet_.length == 0) {
         return 0;
       }
+      next_rtp_time_ = next_packet_.time_ms;
     }
 
     if (end_of_file_ && lost_packets_.NumberOfPacketsToResend() == 0) {
@@ -473,12 +475,21 @@ RtpPlayerInterface* Create(const std::string& input_filename,
     PayloadSinkFactoryInterface* payload_sink_factory, Clock* clock,
     const PayloadTypes& payload_types, float loss_rate, int64_t rtt_ms,
     bool reordering) {
+  return Create(input_filename, payload_sink_factory, clock, payload_types,
+                loss_rate, rtt_ms, reordering, std::set<uint32_t>());
+}
+
+RtpPlayerInterface* Create(const std::string& input_filename,
+    PayloadSinkFactoryInterface* payload_sink_factory, Clock* clock,
+    const PayloadTypes& payload_types, float loss_rate, int64_t rtt_ms,
+    bool reordering, const std::set<uint32_t>& ssrc_filter) {
   rtc::scoped_ptr<test::RtpFileReader> packet_source(
       test::RtpFileReader::Create(test::RtpFileReader::kRtpDump,
-                                  input_filename));
+                                  input_filename, ssrc_filter));
   if (packet_source.get() == NULL) {
     packet_source.reset(test::RtpFileReader::Create(test::RtpFileReader::kPcap,
-                                                    input_filename));
+                                                    input_filename,
+                                                    ssrc_filter));
     if (packet_source.get() == NULL) {
       return NULL;
     }
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_TEST_RTP_PLAYER_H_
 #define WEBRTC_MODULES_VIDEO_CODING_TEST_RTP_PLAYER_H_
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -91,6 +92,13 @@ RtpPlayerInterface* Create(const std::string& inputFilename,
     const PayloadTypes& payload_types, float lossRate, int64_t rttMs,
     bool reordering);
 
+// As above, but only plays the RTP packets with one of the SSRCs in
+// |ssrc_filter|. An empty filter plays all streams.
+RtpPlayerInterface* Create(const std::string& input_filename,
+    PayloadSinkFactoryInterface* payload_sink_factory, Clock* clock,
+    const PayloadTypes& payload_types, float loss_rate, int64_t rtt_ms,
+    bool reordering, const std::set<uint32_t>& ssrc_filter);
+
 }  // namespace rtpplayer
 }  // namespace webrtc
 
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp.h"
 #include "webrtc/modules/video_coding/main/test/test_util.h"
 #include "webrtc/system_wrappers/interface/clock.h"
@@ -24,23 +25,31 @@ namespace rtpplayer {
 
 class VcmPayloadSinkFactory::VcmPayloadSink
     : public PayloadSinkInterface,
-      public VCMPacketRequestCallback {
+      public VCMPacketRequestCallback,
+      public VCMReceiveCallback {
  public:
+  // |frame_receiver| may hold NULL, in which case decoded frames are only
+  // reported to |observer|, if any.
   VcmPayloadSink(VcmPayloadSinkFactory* factory,
                  RtpStreamInterface* stream,
                  rtc::scoped_ptr<VideoCodingModule>* vcm,
-                 rtc::scoped_ptr<FileOutputFrameReceiver>* frame_receiver)
-      : factory_(factory), stream_(stream), vcm_(), frame_receiver_() {
+                 rtc::scoped_ptr<FileOutputFrameReceiver>* frame_receiver,
+                 DecodedFrameObserver* observer)
+      : factory_(factory),
+        stream_(stream),
+        vcm_(),
+        frame_receiver_(),
+        observer_(observer),
+        decode_start_us_(0) {
     assert(factory);
     assert(stream);
     assert(vcm);
     assert(vcm->get());
     assert(frame_receiver);
-    assert(frame_receiver->get());
     vcm_.swap(*vcm);
     frame_receiver_.swap(*frame_receiver);
     vcm_->RegisterPacketRequestCallback(this);
-    vcm_->RegisterReceiveCallback(frame_receiver_.get());
+    vcm_->RegisterReceiveCallback(this);
   }
 
   virtual ~VcmPayloadSink() {
@@ -66,8 +75,20 @@ class VcmPayloadSinkFactory::VcmPayloadSink
     return 0;
   }
 
+  // VCMReceiveCallback
+  int32_t FrameToRender(VideoFrame& video_frame) override {
+    if (observer_) {
+      observer_->OnDecodedFrame(stream_->ssrc(), video_frame,
+                                rtc::TimeMicros() - decode_start_us_);
+    }
+    if (frame_receiver_.get())
+      return frame_receiver_->FrameToRender(video_frame);
+    return 0;
+  }
+
   int DecodeAndProcess(bool should_decode, bool decode_dual_frame) {
     if (should_decode) {
+      decode_start_us_ = rtc::TimeMicros();
       if (vcm_->Decode() < 0) {
         return -1;
       }
@@ -85,6 +106,7 @@ class VcmPayloadSinkFactory::VcmPayloadSink
   }
 
   bool Decode() {
+    decode_start_us_ = rtc::TimeMicros();
     vcm_->Decode(10000);
     return true;
   }
@@ -94,6 +116,8 @@ class VcmPayloadSinkFactory::VcmPayloadSink
   RtpStreamInterface* stream_;
   rtc::scoped_ptr<VideoCodingModule> vcm_;
   rtc::scoped_ptr<FileOutputFrameReceiver> frame_receiver_;
+  DecodedFrameObserver* observer_;
+  int64_t decode_start_us_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(VcmPayloadSink);
 };
@@ -113,6 +137,8 @@ VcmPayloadSinkFactory::VcmPayloadSinkFactory(
       rtt_ms_(rtt_ms),
       render_delay_ms_(render_delay_ms),
       min_playout_delay_ms_(min_playout_delay_ms),
+      decoded_frame_observer_(NULL),
+      write_output_(true),
       null_event_factory_(new NullEventFactory()),
       crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
       sinks_() {
@@ -157,15 +183,25 @@ PayloadSinkInterface* VcmPayloadSinkFactory::Create(
   vcm->SetMinimumPlayoutDelay(min_playout_delay_ms_);
   vcm->SetNackSettings(kMaxNackListSize, kMaxPacketAgeToNack, 0);
 
-  rtc::scoped_ptr<FileOutputFrameReceiver> frame_receiver(
-      new FileOutputFrameReceiver(base_out_filename_, stream->ssrc()));
-  rtc::scoped_ptr<VcmPayloadSink> sink(
-      new VcmPayloadSink(this, stream, &vcm, &frame_receiver));
+  rtc::scoped_ptr<FileOutputFrameReceiver> frame_receiver;
+  if (write_output_) {
+    frame_receiver.reset(
+        new FileOutputFrameReceiver(base_out_filename_, stream->ssrc()));
+  }
+  rtc::scoped_ptr<VcmPayloadSink> sink(new VcmPayloadSink(
+      this, stream, &vcm, &frame_receiver, decoded_frame_observer_));
 
   sinks_.push_back(sink.get());
   return sink.release();
 }
 
+void VcmPayloadSinkFactory::RegisterDecodedFrameObserver(
+    DecodedFrameObserver* observer, bool write_output) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  decoded_frame_observer_ = observer;
+  write_output_ = write_output;
+}
+
 int VcmPayloadSinkFactory::DecodeAndProcessAll(bool decode_dual_frame) {
   CriticalSectionScoped cs(crit_sect_.get());
   assert(clock_);
@@ -23,6 +23,20 @@ class Clock;
 class CriticalSectionWrapper;
 
 namespace rtpplayer {
+
+// Notified of every frame decoded by the sinks of a VcmPayloadSinkFactory.
+// Called on the thread driving the factory.
+class DecodedFrameObserver {
+ public:
+  virtual ~DecodedFrameObserver() {}
+
+  // |decode_time_us| is the wall clock time spent in the decode call that
+  // produced |frame|.
+  virtual void OnDecodedFrame(uint32_t ssrc,
+                              const VideoFrame& frame,
+                              int64_t decode_time_us) = 0;
+};
+
 class VcmPayloadSinkFactory : public PayloadSinkFactoryInterface {
  public:
   VcmPayloadSinkFactory(const std::string& base_out_filename,
@@ -35,6 +49,11 @@ class VcmPayloadSinkFactory : public PayloadSinkFactoryInterface {
   // PayloadSinkFactoryInterface
   virtual PayloadSinkInterface* Create(RtpStreamInterface* stream);
 
+  // Registers |observer| for the sinks created after this call. Decoded
+  // frames are only written to file if |write_output| is true.
+  void RegisterDecodedFrameObserver(DecodedFrameObserver* observer,
+                                    bool write_output);
+
   int DecodeAndProcessAll(bool decode_dual_frame);
   bool ProcessAll();
   bool DecodeAll();
@@ -53,6 +72,8 @@ class VcmPayloadSinkFactory : public PayloadSinkFactoryInterface {
   int64_t rtt_ms_;
   uint32_t render_delay_ms_;
   uint32_t min_playout_delay_ms_;
+  DecodedFrameObserver* decoded_frame_observer_;
+  bool write_output_;
   rtc::scoped_ptr<NullEventFactory> null_event_factory_;
   rtc::scoped_ptr<CriticalSectionWrapper> crit_sect_;
   Sinks sinks_;
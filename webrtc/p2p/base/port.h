@@ -23,6 +23,7 @@
 #include "webrtc/p2p/base/stunrequest.h"
 #include "webrtc/p2p/base/transport.h"
 #include "webrtc/base/asyncpacketsocket.h"
+#include "webrtc/base/fastsignal.h"
 #include "webrtc/base/network.h"
 #include "webrtc/base/proxyinfo.h"
 #include "webrtc/base/ratetracker.h"
@@ -474,8 +475,8 @@ class Connection : public rtc::MessageHandler,
   // Error if Send() returns < 0
   virtual int GetError() = 0;
 
-  sigslot::signal4<Connection*, const char*, size_t, const rtc::PacketTime&>
-      SignalReadPacket;
+  sigslot::fast_signal<Connection*, const char*, size_t,
+                       const rtc::PacketTime&> SignalReadPacket;
 
   sigslot::signal1<Connection*> SignalReadyToSend;
 
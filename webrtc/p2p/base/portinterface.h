@@ -15,6 +15,7 @@
 
 #include "webrtc/p2p/base/transport.h"
 #include "webrtc/base/asyncpacketsocket.h"
+#include "webrtc/base/fastsignal.h"
 #include "webrtc/base/socketaddress.h"
 
 namespace rtc {
@@ -110,11 +111,12 @@ class PortInterface {
   // through their respective connection and instead delivers every packet
   // through this port.
   virtual void EnablePortPackets() = 0;
-  sigslot::signal4<PortInterface*, const char*, size_t,
-                   const rtc::SocketAddress&> SignalReadPacket;
+  sigslot::fast_signal<PortInterface*, const char*, size_t,
+                       const rtc::SocketAddress&> SignalReadPacket;
 
   // Emitted each time a packet is sent on this port.
-  sigslot::signal2<PortInterface*, const rtc::SentPacket&> SignalSentPacket;
+  sigslot::fast_signal<PortInterface*, const rtc::SentPacket&>
+      SignalSentPacket;
 
   virtual std::string ToString() const = 0;
 
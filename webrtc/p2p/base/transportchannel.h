@@ -20,6 +20,7 @@
 #include "webrtc/base/asyncpacketsocket.h"
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/dscp.h"
+#include "webrtc/base/fastsignal.h"
 #include "webrtc/base/sigslot.h"
 #include "webrtc/base/socket.h"
 #include "webrtc/base/sslidentity.h"
@@ -131,11 +132,12 @@ class TransportChannel : public sigslot::has_slots<> {
                                     size_t result_len) = 0;
 
   // Signalled each time a packet is received on this channel.
-  sigslot::signal5<TransportChannel*, const char*,
-                   size_t, const rtc::PacketTime&, int> SignalReadPacket;
+  sigslot::fast_signal<TransportChannel*, const char*,
+                       size_t, const rtc::PacketTime&, int> SignalReadPacket;
 
   // Signalled each time a packet is sent on this channel.
-  sigslot::signal2<TransportChannel*, const rtc::SentPacket&> SignalSentPacket;
+  sigslot::fast_signal<TransportChannel*, const rtc::SentPacket&>
+      SignalSentPacket;
 
   // This signal occurs when there is a change in the way that packets are
   // being routed, i.e. to a different remote location. The candidate
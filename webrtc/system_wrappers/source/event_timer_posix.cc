@@ -18,7 +18,12 @@
 #include <sys/time.h>
 #include <unistd.h>
 
+#include <set>
+#include <utility>
+
 #include "webrtc/base/checks.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
 
 namespace webrtc {
 
@@ -30,26 +35,235 @@ EventTimerWrapper* EventTimerWrapper::Create() {
 const long int E6 = 1000000;
 const long int E9 = 1000 * E6;
 
+namespace {
+
+// Initializes |cond| to use the same clock as GetTime().
+void InitCondition(pthread_cond_t* cond) {
+#ifdef WEBRTC_CLOCK_TYPE_REALTIME
+  pthread_cond_init(cond, 0);
+#else
+  pthread_condattr_t cond_attr;
+  pthread_condattr_init(&cond_attr);
+  pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+  pthread_cond_init(cond, &cond_attr);
+  pthread_condattr_destroy(&cond_attr);
+#endif
+}
+
+// The time on the clock that the condition variables wait on.
+void GetTime(timespec* now) {
+#ifndef WEBRTC_MAC
+#ifdef WEBRTC_CLOCK_TYPE_REALTIME
+  clock_gettime(CLOCK_REALTIME, now);
+#else
+  clock_gettime(CLOCK_MONOTONIC, now);
+#endif
+#else
+  timeval value;
+  struct timezone time_zone;
+  time_zone.tz_minuteswest = 0;
+  time_zone.tz_dsttime = 0;
+  gettimeofday(&value, &time_zone);
+  TIMEVAL_TO_TIMESPEC(&value, now);
+#endif
+}
+
+int64_t GetTimeNs() {
+  timespec now;
+  GetTime(&now);
+  return static_cast<int64_t>(now.tv_sec) * E9 + now.tv_nsec;
+}
+
+}  // namespace
+
+// Runs all started timers on one thread. The timers are kept in a set
+// ordered by when they fire next, and the thread sleeps until the first one
+// is due.
+class EventTimerScheduler {
+ public:
+  // Starts |timer|, creating the scheduler for the first started timer.
+  // Returns false if |timer| already runs periodically; a one-shot timer is
+  // restarted with the new time instead.
+  static bool StartTimer(EventTimerPosix* timer, bool periodic,
+                         unsigned long time);
+  // Stops |timer|, which won't be set by the scheduler once this returns.
+  // The scheduler goes away with the last started timer.
+  static void StopTimer(EventTimerPosix* timer);
+
+ private:
+  typedef std::set<std::pair<int64_t, EventTimerPosix*>> TimerSet;
+
+  EventTimerScheduler();
+  ~EventTimerScheduler();
+
+  void Schedule(EventTimerPosix* timer);
+  void Unschedule(EventTimerPosix* timer);
+
+  static bool Run(void* obj);
+  bool Process();
+
+  pthread_mutex_t mutex_;
+  pthread_cond_t cond_;
+  TimerSet timers_;
+  int num_started_timers_;
+  bool stopping_;
+  rtc::scoped_ptr<ThreadWrapper> thread_;
+};
+
+namespace {
+
+// Guards the creation and deletion of |g_scheduler|.
+pthread_mutex_t g_scheduler_lock = PTHREAD_MUTEX_INITIALIZER;
+EventTimerScheduler* g_scheduler = nullptr;
+
+}  // namespace
+
+EventTimerScheduler::EventTimerScheduler()
+    : num_started_timers_(0), stopping_(false) {
+  pthread_mutex_init(&mutex_, 0);
+  InitCondition(&cond_);
+  thread_ = ThreadWrapper::CreateThread(Run, this, "WebRtc_event_timer_thread");
+  thread_->Start();
+  thread_->SetPriority(kRealtimePriority);
+}
+
+EventTimerScheduler::~EventTimerScheduler() {
+  pthread_mutex_lock(&mutex_);
+  stopping_ = true;
+  pthread_cond_signal(&cond_);
+  pthread_mutex_unlock(&mutex_);
+  thread_->Stop();
+  pthread_cond_destroy(&cond_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+bool EventTimerScheduler::StartTimer(EventTimerPosix* timer,
+                                     bool periodic,
+                                     unsigned long time) {
+  pthread_mutex_lock(&g_scheduler_lock);
+  if (!g_scheduler)
+    g_scheduler = new EventTimerScheduler();
+  EventTimerScheduler* scheduler = g_scheduler;
+  pthread_mutex_lock(&scheduler->mutex_);
+  if (timer->started_ && timer->periodic_) {
+    // Timer already started. The scheduler can't be left without timers
+    // here, as this one is started.
+    pthread_mutex_unlock(&scheduler->mutex_);
+    pthread_mutex_unlock(&g_scheduler_lock);
+    return false;
+  }
+  if (!timer->started_) {
+    timer->started_ = true;
+    timer->periodic_ = periodic;
+    ++scheduler->num_started_timers_;
+  }
+  pthread_mutex_unlock(&g_scheduler_lock);
+
+  // (Re)starts counting from now.
+  scheduler->Unschedule(timer);
+  timer->time_ = time;
+  timer->created_at_ns_ = GetTimeNs();
+  timer->count_ = 0;
+  scheduler->Schedule(timer);
+  pthread_mutex_unlock(&scheduler->mutex_);
+  return true;
+}
+
+void EventTimerScheduler::StopTimer(EventTimerPosix* timer) {
+  pthread_mutex_lock(&g_scheduler_lock);
+  EventTimerScheduler* scheduler = g_scheduler;
+  if (!scheduler) {
+    pthread_mutex_unlock(&g_scheduler_lock);
+    return;
+  }
+  pthread_mutex_lock(&scheduler->mutex_);
+  bool last_timer = false;
+  if (timer->started_) {
+    scheduler->Unschedule(timer);
+    timer->started_ = false;
+    timer->count_ = 0;
+    last_timer = --scheduler->num_started_timers_ == 0;
+  }
+  pthread_mutex_unlock(&scheduler->mutex_);
+  if (last_timer) {
+    delete scheduler;
+    g_scheduler = nullptr;
+  }
+  pthread_mutex_unlock(&g_scheduler_lock);
+}
+
+// Must be called with |mutex_| held.
+void EventTimerScheduler::Schedule(EventTimerPosix* timer) {
+  // Computed from the start time rather than the previous expiry, so that
+  // periodic timers don't drift.
+  timer->next_fire_ns_ = timer->created_at_ns_ +
+      static_cast<int64_t>(timer->time_) * ++timer->count_ * E6;
+  timer->scheduled_ = true;
+  bool first = timers_.empty() ||
+      timer->next_fire_ns_ < timers_.begin()->first;
+  timers_.insert(std::make_pair(timer->next_fire_ns_, timer));
+  // Wake up the thread to sleep for less, if it's the first timer now.
+  if (first)
+    pthread_cond_signal(&cond_);
+}
+
+// Must be called with |mutex_| held.
+void EventTimerScheduler::Unschedule(EventTimerPosix* timer) {
+  if (timer->scheduled_) {
+    timers_.erase(std::make_pair(timer->next_fire_ns_, timer));
+    timer->scheduled_ = false;
+  }
+}
+
+bool EventTimerScheduler::Run(void* obj) {
+  return static_cast<EventTimerScheduler*>(obj)->Process();
+}
+
+bool EventTimerScheduler::Process() {
+  pthread_mutex_lock(&mutex_);
+  if (stopping_) {
+    pthread_mutex_unlock(&mutex_);
+    return false;
+  }
+  if (timers_.empty()) {
+    pthread_cond_wait(&cond_, &mutex_);
+  } else {
+    timespec end_at;
+    end_at.tv_sec = timers_.begin()->first / E9;
+    end_at.tv_nsec = timers_.begin()->first % E9;
+    pthread_cond_timedwait(&cond_, &mutex_, &end_at);
+  }
+
+  const int64_t now_ns = GetTimeNs();
+  while (!timers_.empty() && timers_.begin()->first <= now_ns) {
+    EventTimerPosix* timer = timers_.begin()->second;
+    timers_.erase(timers_.begin());
+    timer->scheduled_ = false;
+    timer->Set();
+    // A one-shot timer stays started, but doesn't fire again until it is
+    // restarted. A periodic timer that fell behind fires right away again,
+    // which coalesces with the Set() above.
+    if (timer->periodic_)
+      Schedule(timer);
+  }
+  pthread_mutex_unlock(&mutex_);
+  return true;
+}
+
 EventTimerPosix::EventTimerPosix()
     : event_set_(false),
-      timer_thread_(nullptr),
-      created_at_(),
+      started_(false),
       periodic_(false),
       time_(0),
-      count_(0) {
+      created_at_ns_(0),
+      count_(0),
+      next_fire_ns_(0),
+      scheduled_(false) {
   pthread_mutexattr_t attr;
   pthread_mutexattr_init(&attr);
   pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
   pthread_mutex_init(&mutex_, &attr);
-#ifdef WEBRTC_CLOCK_TYPE_REALTIME
-  pthread_cond_init(&cond_, 0);
-#else
-  pthread_condattr_t cond_attr;
-  pthread_condattr_init(&cond_attr);
-  pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
-  pthread_cond_init(&cond_, &cond_attr);
-  pthread_condattr_destroy(&cond_attr);
-#endif
+  InitCondition(&cond_);
 }
 
 EventTimerPosix::~EventTimerPosix() {
@@ -74,20 +288,7 @@ EventTypeWrapper EventTimerPosix::Wait(unsigned long timeout) {
   if (!event_set_) {
     if (WEBRTC_EVENT_INFINITE != timeout) {
       timespec end_at;
-#ifndef WEBRTC_MAC
-#ifdef WEBRTC_CLOCK_TYPE_REALTIME
-      clock_gettime(CLOCK_REALTIME, &end_at);
-#else
-      clock_gettime(CLOCK_MONOTONIC, &end_at);
-#endif
-#else
-      timeval value;
-      struct timezone time_zone;
-      time_zone.tz_minuteswest = 0;
-      time_zone.tz_dsttime = 0;
-      gettimeofday(&value, &time_zone);
-      TIMEVAL_TO_TIMESPEC(&value, &end_at);
-#endif
+      GetTime(&end_at);
       end_at.tv_sec  += timeout / 1000;
       end_at.tv_nsec += (timeout - (timeout / 1000) * 1000) * E6;
 
@@ -115,116 +316,12 @@ EventTypeWrapper EventTimerPosix::Wait(unsigned long timeout) {
   return ret_val == 0 ? kEventSignaled : kEventTimeout;
 }
 
-EventTypeWrapper EventTimerPosix::Wait(timespec* end_at) {
-  int ret_val = 0;
-  RTC_CHECK_EQ(0, pthread_mutex_lock(&mutex_));
-
-  while (ret_val == 0 && !event_set_)
-    ret_val = pthread_cond_timedwait(&cond_, &mutex_, end_at);
-
-  RTC_DCHECK(ret_val == 0 || ret_val == ETIMEDOUT);
-
-  // Reset and signal if set, regardless of why the thread woke up.
-  if (event_set_) {
-    ret_val = 0;
-    event_set_ = false;
-  }
-  pthread_mutex_unlock(&mutex_);
-
-  return ret_val == 0 ? kEventSignaled : kEventTimeout;
-}
-
 bool EventTimerPosix::StartTimer(bool periodic, unsigned long time) {
-  pthread_mutex_lock(&mutex_);
-  if (timer_thread_) {
-    if (periodic_) {
-      // Timer already started.
-      pthread_mutex_unlock(&mutex_);
-      return false;
-    } else  {
-      // New one shot timer
-      time_ = time;
-      created_at_.tv_sec = 0;
-      timer_event_->Set();
-      pthread_mutex_unlock(&mutex_);
-      return true;
-    }
-  }
-
-  // Start the timer thread
-  timer_event_.reset(new EventTimerPosix());
-  const char* thread_name = "WebRtc_event_timer_thread";
-  timer_thread_ = ThreadWrapper::CreateThread(Run, this, thread_name);
-  periodic_ = periodic;
-  time_ = time;
-  bool started = timer_thread_->Start();
-  timer_thread_->SetPriority(kRealtimePriority);
-  pthread_mutex_unlock(&mutex_);
-
-  return started;
-}
-
-bool EventTimerPosix::Run(void* obj) {
-  return static_cast<EventTimerPosix*>(obj)->Process();
-}
-
-bool EventTimerPosix::Process() {
-  pthread_mutex_lock(&mutex_);
-  if (created_at_.tv_sec == 0) {
-#ifndef WEBRTC_MAC
-#ifdef WEBRTC_CLOCK_TYPE_REALTIME
-    clock_gettime(CLOCK_REALTIME, &created_at_);
-#else
-    clock_gettime(CLOCK_MONOTONIC, &created_at_);
-#endif
-#else
-    timeval value;
-    struct timezone time_zone;
-    time_zone.tz_minuteswest = 0;
-    time_zone.tz_dsttime = 0;
-    gettimeofday(&value, &time_zone);
-    TIMEVAL_TO_TIMESPEC(&value, &created_at_);
-#endif
-    count_ = 0;
-  }
-
-  timespec end_at;
-  unsigned long long time = time_ * ++count_;
-  end_at.tv_sec  = created_at_.tv_sec + time / 1000;
-  end_at.tv_nsec = created_at_.tv_nsec + (time - (time / 1000) * 1000) * E6;
-
-  if (end_at.tv_nsec >= E9) {
-    end_at.tv_sec++;
-    end_at.tv_nsec -= E9;
-  }
-
-  pthread_mutex_unlock(&mutex_);
-  if (timer_event_->Wait(&end_at) == kEventSignaled)
-    return true;
-
-  pthread_mutex_lock(&mutex_);
-  if (periodic_ || count_ == 1)
-    Set();
-  pthread_mutex_unlock(&mutex_);
-
-  return true;
+  return EventTimerScheduler::StartTimer(this, periodic, time);
 }
 
 bool EventTimerPosix::StopTimer() {
-  if (timer_event_) {
-    timer_event_->Set();
-  }
-  if (timer_thread_) {
-    if (!timer_thread_->Stop()) {
-      return false;
-    }
-    timer_thread_.reset();
-  }
-  timer_event_.reset();
-
-  // Set time to zero to force new reference time for the timer.
-  memset(&created_at_, 0, sizeof(created_at_));
-  count_ = 0;
+  EventTimerScheduler::StopTimer(this);
   return true;
 }
 
@@ -16,7 +16,7 @@
 #include <pthread.h>
 #include <time.h>
 
-#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/typedefs.h"
 
 namespace webrtc {
 
@@ -25,6 +25,10 @@ enum State {
   kDown = 2
 };
 
+class EventTimerScheduler;
+
+// The timers of all EventTimerPosix instances are run by one process-wide
+// scheduler thread, which exists while any timer is started.
 class EventTimerPosix : public EventTimerWrapper {
  public:
   EventTimerPosix();
@@ -37,22 +41,20 @@ class EventTimerPosix : public EventTimerWrapper {
   bool StopTimer() override;
 
  private:
-  static bool Run(void* obj);
-  bool Process();
-  EventTypeWrapper Wait(timespec* end_at);
+  friend class EventTimerScheduler;
 
- private:
   pthread_cond_t  cond_;
   pthread_mutex_t mutex_;
   bool event_set_;
 
-  rtc::scoped_ptr<ThreadWrapper> timer_thread_;
-  rtc::scoped_ptr<EventTimerPosix> timer_event_;
-  timespec       created_at_;
-
+  // Guarded by the scheduler.
+  bool          started_;
   bool          periodic_;
   unsigned long time_;  // In ms
+  int64_t       created_at_ns_;
   unsigned long count_;
+  int64_t       next_fire_ns_;  // Valid while the timer is scheduled.
+  bool          scheduled_;
 };
 
 }  // namespace webrtc
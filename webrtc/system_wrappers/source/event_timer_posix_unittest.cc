@@ -0,0 +1,254 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/source/event_timer_posix.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+namespace {
+
+const unsigned long kTimeoutMs = 1000;
+
+// The number of threads in the process, or -1 if it can't be read.
+int CountThreads() {
+  DIR* dir = opendir("/proc/self/task");
+  if (!dir)
+    return -1;
+  int count = 0;
+  while (dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.')
+      ++count;
+  }
+  closedir(dir);
+  return count;
+}
+
+// The number of threads in the process whose name starts with |prefix|, or -1
+// if it can't be read. Names are cut to 15 characters by the kernel.
+int CountThreadsNamed(const char* prefix) {
+  DIR* dir = opendir("/proc/self/task");
+  if (!dir)
+    return -1;
+  int count = 0;
+  while (dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] == '.')
+      continue;
+    const std::string path =
+        std::string("/proc/self/task/") + entry->d_name + "/comm";
+    FILE* file = fopen(path.c_str(), "r");
+    if (!file)
+      continue;  // The thread is gone.
+    char name[32] = {0};
+    if (fgets(name, sizeof(name), file) &&
+        strncmp(name, prefix, strlen(prefix)) == 0) {
+      ++count;
+    }
+    fclose(file);
+  }
+  closedir(dir);
+  return count;
+}
+
+// Waits on a periodic timer, and records how late it wakes up after the end
+// of each period. Periods that end before the waiter wakes up for an earlier
+// one are merged into that wakeup, and counted as missed.
+class PeriodicWaiter {
+ public:
+  PeriodicWaiter(unsigned long period_ms, int periods)
+      : timer_(EventTimerWrapper::Create()),
+        period_ms_(period_ms),
+        periods_left_(periods),
+        max_late_us_(0),
+        sum_late_us_(0),
+        periods_(0),
+        wakeups_(0),
+        missed_periods_(0),
+        done_(EventWrapper::Create()),
+        thread_(ThreadWrapper::CreateThread(Run, this, "PeriodicWaiter")) {}
+
+  void Start() {
+    // The thread waits for the first period to end.
+    thread_->Start();
+    start_us_ = TickTime::MicrosecondTimestamp();
+    timer_->StartTimer(true, period_ms_);
+  }
+
+  // Waits for all the periods to end.
+  void Stop() {
+    done_->Wait(kTimeoutMs * 10);
+    thread_->Stop();
+    timer_->StopTimer();
+  }
+
+  int64_t max_late_us() const { return max_late_us_; }
+  double mean_late_us() const {
+    return wakeups_ > 0 ? static_cast<double>(sum_late_us_) / wakeups_ : 0;
+  }
+  int wakeups() const { return wakeups_; }
+  int missed_periods() const { return missed_periods_; }
+
+ private:
+  static bool Run(void* obj) {
+    return static_cast<PeriodicWaiter*>(obj)->Process();
+  }
+
+  bool Process() {
+    if (periods_left_ == 0)
+      return false;
+    if (timer_->Wait(kTimeoutMs) != kEventSignaled) {
+      done_->Set();
+      return false;
+    }
+    if (--periods_left_ == 0)
+      done_->Set();
+    // Measured against the end of the oldest period not waited for yet.
+    const int64_t period_us = static_cast<int64_t>(period_ms_) * 1000;
+    const int64_t late_us = TickTime::MicrosecondTimestamp() - start_us_ -
+                            period_us * (periods_ + 1);
+    max_late_us_ = std::max(max_late_us_, late_us);
+    sum_late_us_ += late_us;
+    ++wakeups_;
+    const int missed = static_cast<int>(late_us / period_us);
+    missed_periods_ += missed;
+    periods_ += 1 + missed;
+    return true;
+  }
+
+  rtc::scoped_ptr<EventTimerWrapper> timer_;
+  const unsigned long period_ms_;
+  int periods_left_;
+  int64_t start_us_;
+  int64_t max_late_us_;
+  int64_t sum_late_us_;
+  int periods_;  // Ended periods accounted for, waited for or missed.
+  int wakeups_;
+  int missed_periods_;
+  rtc::scoped_ptr<EventWrapper> done_;
+  rtc::scoped_ptr<ThreadWrapper> thread_;
+};
+
+}  // namespace
+
+TEST(EventTimerPosixTest, OneShot) {
+  rtc::scoped_ptr<EventTimerWrapper> timer(EventTimerWrapper::Create());
+  const int64_t start_ms = TickTime::MillisecondTimestamp();
+  EXPECT_TRUE(timer->StartTimer(false, 20));
+  EXPECT_EQ(kEventSignaled, timer->Wait(kTimeoutMs));
+  EXPECT_GE(TickTime::MillisecondTimestamp() - start_ms, 19);
+  // Fires only once.
+  EXPECT_EQ(kEventTimeout, timer->Wait(100));
+  EXPECT_TRUE(timer->StopTimer());
+}
+
+TEST(EventTimerPosixTest, OneShotRestartsWithNewTime) {
+  rtc::scoped_ptr<EventTimerWrapper> timer(EventTimerWrapper::Create());
+  EXPECT_TRUE(timer->StartTimer(false, 10000));
+  EXPECT_TRUE(timer->StartTimer(false, 20));
+  EXPECT_EQ(kEventSignaled, timer->Wait(kTimeoutMs));
+  EXPECT_TRUE(timer->StopTimer());
+}
+
+TEST(EventTimerPosixTest, Periodic) {
+  rtc::scoped_ptr<EventTimerWrapper> timer(EventTimerWrapper::Create());
+  const int64_t start_ms = TickTime::MillisecondTimestamp();
+  EXPECT_TRUE(timer->StartTimer(true, 10));
+  // Can't be restarted while running.
+  EXPECT_FALSE(timer->StartTimer(true, 10));
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(kEventSignaled, timer->Wait(kTimeoutMs));
+  EXPECT_GE(TickTime::MillisecondTimestamp() - start_ms, 99);
+  EXPECT_TRUE(timer->StopTimer());
+}
+
+TEST(EventTimerPosixTest, StopAndRestart) {
+  rtc::scoped_ptr<EventTimerWrapper> timer(EventTimerWrapper::Create());
+  EXPECT_TRUE(timer->StartTimer(true, 10));
+  EXPECT_EQ(kEventSignaled, timer->Wait(kTimeoutMs));
+  EXPECT_TRUE(timer->StopTimer());
+  // A period may have ended between the Wait() and StopTimer().
+  timer->Wait(0);
+  EXPECT_EQ(kEventTimeout, timer->Wait(50));
+
+  EXPECT_TRUE(timer->StartTimer(true, 10));
+  EXPECT_EQ(kEventSignaled, timer->Wait(kTimeoutMs));
+  EXPECT_TRUE(timer->StopTimer());
+}
+
+TEST(EventTimerPosixTest, TimersShareOneThread) {
+  const int kNumTimers = 10;
+  const int threads_before = CountThreads();
+  if (threads_before < 0)
+    return;
+  ScopedVector<EventTimerWrapper> timers;
+  for (int i = 0; i < kNumTimers; ++i) {
+    timers.push_back(EventTimerWrapper::Create());
+    EXPECT_TRUE(timers.back()->StartTimer(true, 10 + i));
+  }
+  EXPECT_EQ(threads_before + 1, CountThreads());
+  for (EventTimerWrapper* timer : timers)
+    EXPECT_EQ(kEventSignaled, timer->Wait(kTimeoutMs));
+  for (EventTimerWrapper* timer : timers)
+    EXPECT_TRUE(timer->StopTimer());
+  // The thread goes away with the last timer.
+  EXPECT_EQ(threads_before, CountThreads());
+}
+
+// Runs many periodic timers, like the ones driving audio devices and
+// pacers, and reports how many threads the timers take and how late the
+// periods end.
+TEST(EventTimerPosixTest, DISABLED_ManyPeriodicTimersBenchmark) {
+  const int kNumTimers = 500;
+  const unsigned long kPeriodMs = 10;
+  const int kPeriods = 500;
+
+  ScopedVector<PeriodicWaiter> waiters;
+  for (int i = 0; i < kNumTimers; ++i)
+    waiters.push_back(new PeriodicWaiter(kPeriodMs, kPeriods));
+  for (PeriodicWaiter* waiter : waiters)
+    waiter->Start();
+  // Counted by name, as the waiting threads come and go on their own. Give
+  // the timer threads a few periods to have named themselves.
+  SleepMs(5 * kPeriodMs);
+  const int timer_threads = CountThreadsNamed("WebRtc_event_t");
+  for (PeriodicWaiter* waiter : waiters)
+    waiter->Stop();
+
+  int64_t max_late_us = 0;
+  double sum_mean_late_us = 0;
+  int wakeups = 0;
+  int missed_periods = 0;
+  for (PeriodicWaiter* waiter : waiters) {
+    max_late_us = std::max(max_late_us, waiter->max_late_us());
+    sum_mean_late_us += waiter->mean_late_us();
+    wakeups += waiter->wakeups();
+    missed_periods += waiter->missed_periods();
+  }
+  printf("%d timers of %lu ms: %d timer threads, %.0f us late on average, "
+         "%lld us at most, %d of %d periods missed.\n", kNumTimers, kPeriodMs,
+         timer_threads, sum_mean_late_us / kNumTimers,
+         static_cast<long long>(max_late_us), missed_periods,
+         wakeups + missed_periods);
+}
+
+}  // namespace webrtc
@@ -23,6 +23,7 @@
         'source/clock_unittest.cc',
         'source/condition_variable_unittest.cc',
         'source/critical_section_unittest.cc',
+        'source/event_timer_posix_unittest.cc',
         'source/event_tracer_unittest.cc',
         'source/logging_unittest.cc',
         'source/data_log_unittest.cc',
@@ -44,7 +45,10 @@
           'sources!': [ 'source/data_log_unittest.cc', ],
         }],
         ['os_posix==0', {
-          'sources!': [ 'source/thread_posix_unittest.cc', ],
+          'sources!': [
+            'source/event_timer_posix_unittest.cc',
+            'source/thread_posix_unittest.cc',
+          ],
         }],
         ['OS=="android"', {
           'dependencies': [
@@ -75,6 +75,18 @@ class FakeVoiceEngine final : public VoiceEngineImpl {
     }
     return stats;
   }
+  const AudioPipelineStatistics& GetRecvAudioPipelineStatistics() const {
+    static AudioPipelineStatistics stats;
+    if (stats.stages[kAudioStageJitterBuffer].num_blocks == 0) {
+      stats.stages[kAudioStageJitterBuffer].num_blocks = 321;
+      stats.stages[kAudioStageJitterBuffer].average_us = 60000;
+      stats.stages[kAudioStageJitterBuffer].max_us = 120000;
+      stats.stages[kAudioStageDecode].num_blocks = 321;
+      stats.stages[kAudioStageDecode].average_us = 54;
+      stats.stages[kAudioStageDecode].max_us = 987;
+    }
+    return stats;
+  }
 
   // VoEBase
   int RegisterVoiceEngineObserver(VoiceEngineObserver& observer) override {
@@ -306,6 +318,13 @@ class FakeVoiceEngine final : public VoiceEngineImpl {
     *stats = GetRecvAudioDecodingCallStats();
     return 0;
   }
+  int GetAudioPipelineStatistics(
+      int channel, AudioPipelineStatistics* stats) const override {
+    EXPECT_EQ(channel, kReceiveChannelId);
+    EXPECT_NE(nullptr, stats);
+    *stats = GetRecvAudioPipelineStatistics();
+    return 0;
+  }
 
   // VoERTP_RTCP
   int SetLocalSSRC(int channel, unsigned int ssrc) override { return -1; }
@@ -11,7 +11,16 @@
 #include "webrtc/test/rtp_file_reader.h"
 
 #include <stdio.h>
+#include <string.h>
 
+#if defined(WEBRTC_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -19,6 +28,7 @@
 #include "webrtc/base/checks.h"
 #include "webrtc/base/format_macros.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 
 namespace webrtc {
@@ -643,9 +653,10 @@ class PcapReader : public RtpFileReaderImpl {
   RTC_DISALLOW_COPY_AND_ASSIGN(PcapReader);
 };
 
-RtpFileReader* RtpFileReader::Create(FileFormat format,
-                                     const std::string& filename,
-                                     const std::set<uint32_t>& ssrc_filter) {
+RtpFileReader* RtpFileReader::CreateStreaming(
+    FileFormat format,
+    const std::string& filename,
+    const std::set<uint32_t>& ssrc_filter) {
   RtpFileReaderImpl* reader = NULL;
   switch (format) {
     case kPcap:
@@ -665,10 +676,496 @@ RtpFileReader* RtpFileReader::Create(FileFormat format,
   return reader;
 }
 
+RtpFileReader* RtpFileReader::Create(FileFormat format,
+                                     const std::string& filename,
+                                     const std::set<uint32_t>& ssrc_filter) {
+  return IndexedRtpFileReader::Create(format, filename, ssrc_filter);
+}
+
 RtpFileReader* RtpFileReader::Create(FileFormat format,
                                      const std::string& filename) {
   return RtpFileReader::Create(format, filename, std::set<uint32_t>());
 }
 
+// Read-only view of a whole file. Uses mmap where available and otherwise
+// reads the file into memory.
+class IndexedRtpFileReader::MappedFile {
+ public:
+  MappedFile() : data_(NULL), size_(0) {}
+
+  ~MappedFile() {
+#if defined(WEBRTC_POSIX)
+    if (size_ > 0)
+      munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+  }
+
+  bool Open(const std::string& filename) {
+#if defined(WEBRTC_POSIX)
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      void* data = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        size_ = 0;
+        close(fd);
+        return false;
+      }
+      // Packets are indexed and typically replayed front to back.
+      madvise(data, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const uint8_t*>(data);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    return true;
+#else
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file == NULL)
+      return false;
+    uint8_t chunk[64 * 1024];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+      buffer_.insert(buffer_.end(), chunk, chunk + read);
+    fclose(file);
+    size_ = buffer_.size();
+    data_ = buffer_.empty() ? NULL : &buffer_[0];
+    return true;
+#endif
+  }
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+#if !defined(WEBRTC_POSIX)
+  std::vector<uint8_t> buffer_;
+#endif
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+namespace {
+
+// Bounds checked reads from a memory buffer.
+class BufferReader {
+ public:
+  BufferReader(const uint8_t* data, size_t size)
+      : data_(data), size_(size), pos_(0) {}
+
+  bool ReadUint32(uint32_t* out, bool big_endian) {
+    if (remaining() < 4)
+      return false;
+    *out = big_endian ? ByteReader<uint32_t>::ReadBigEndian(&data_[pos_])
+                      : ByteReader<uint32_t>::ReadLittleEndian(&data_[pos_]);
+    pos_ += 4;
+    return true;
+  }
+
+  bool ReadUint16(uint16_t* out, bool big_endian) {
+    if (remaining() < 2)
+      return false;
+    *out = big_endian ? ByteReader<uint16_t>::ReadBigEndian(&data_[pos_])
+                      : ByteReader<uint16_t>::ReadLittleEndian(&data_[pos_]);
+    pos_ += 2;
+    return true;
+  }
+
+  bool Skip(size_t count) {
+    if (remaining() < count)
+      return false;
+    pos_ += count;
+    return true;
+  }
+
+  size_t remaining() const { return size_ - pos_; }
+  size_t pos() const { return pos_; }
+  void set_pos(size_t pos) {
+    RTC_DCHECK_LE(pos, size_);
+    pos_ = pos;
+  }
+
+ private:
+  const uint8_t* const data_;
+  const size_t size_;
+  size_t pos_;
+};
+
+// Parses an IPv4 and UDP header, leaving |reader| at the UDP payload.
+bool ParseIpUdpHeaders(BufferReader* reader, uint32_t* payload_length) {
+  uint16_t version;
+  uint16_t length;
+  uint16_t id;
+  uint16_t fragment;
+  uint16_t protocol;
+  uint16_t checksum;
+  uint32_t source_ip;
+  uint32_t dest_ip;
+  TRY(reader->ReadUint16(&version, true));
+  TRY(reader->ReadUint16(&length, true));
+  TRY(reader->ReadUint16(&id, true));
+  TRY(reader->ReadUint16(&fragment, true));
+  TRY(reader->ReadUint16(&protocol, true));
+  TRY(reader->ReadUint16(&checksum, true));
+  TRY(reader->ReadUint32(&source_ip, true));
+  TRY(reader->ReadUint32(&dest_ip, true));
+
+  if (((version >> 12) & 0x000f) != kIpVersion4) {
+    DEBUG_LOG("IP header is not IPv4");
+    return false;
+  }
+  if (fragment != kFragmentOffsetClear &&
+      fragment != kFragmentOffsetDoNotFragment) {
+    DEBUG_LOG("IP fragments cannot be handled");
+    return false;
+  }
+  // Skip remaining fields of IP header.
+  uint16_t header_length = (version & 0x0f00) >> (8 - 2);
+  TRY(header_length >= kMinIpHeaderLength);
+  TRY(reader->Skip(header_length - kMinIpHeaderLength));
+
+  if ((protocol & 0x00ff) != kProtocolUdp) {
+    DEBUG_LOG("Only UDP packets are handled");
+    return false;
+  }
+  uint16_t udp_length;
+  TRY(reader->Skip(4));  // Source and destination port.
+  TRY(reader->ReadUint16(&udp_length, true));
+  TRY(reader->Skip(2));  // Checksum.
+  TRY(udp_length >= kUdpHeaderLength);
+  *payload_length = static_cast<uint32_t>(udp_length - kUdpHeaderLength);
+  TRY(*payload_length <= reader->remaining());
+  return true;
+}
+
+// Locates the UDP payload in a captured frame with either a BSD
+// null/loopback or an Ethernet II link layer header.
+bool ParsePcapFrame(const uint8_t* frame,
+                    size_t size,
+                    size_t* payload_pos,
+                    uint32_t* payload_length) {
+  BufferReader reader(frame, size);
+  // The loopback header is 4 bytes in the capturing host's byte order, so
+  // check for both versions.
+  uint32_t protocol;
+  if (reader.ReadUint32(&protocol, true) &&
+      (protocol == kBsdNullLoopback1 || protocol == kBsdNullLoopback2) &&
+      ParseIpUdpHeaders(&reader, payload_length)) {
+    *payload_pos = reader.pos();
+    return true;
+  }
+
+  reader.set_pos(0);
+  uint16_t type;
+  if (reader.Skip(kEthernetIIHeaderMacSkip) &&
+      reader.ReadUint16(&type, true) && type == kEthertypeIp &&
+      ParseIpUdpHeaders(&reader, payload_length)) {
+    *payload_pos = reader.pos();
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+IndexedRtpFileReader::IndexedRtpFileReader() : next_(0) {}
+
+IndexedRtpFileReader::~IndexedRtpFileReader() {}
+
+IndexedRtpFileReader* IndexedRtpFileReader::Create(
+    FileFormat format,
+    const std::string& filename) {
+  return Create(format, filename, std::set<uint32_t>());
+}
+
+IndexedRtpFileReader* IndexedRtpFileReader::Create(
+    FileFormat format,
+    const std::string& filename,
+    const std::set<uint32_t>& ssrc_filter) {
+  rtc::scoped_ptr<IndexedRtpFileReader> reader(new IndexedRtpFileReader());
+  if (!reader->Init(format, filename))
+    return NULL;
+  reader->SetSsrcFilter(ssrc_filter);
+  return reader.release();
+}
+
+bool IndexedRtpFileReader::Init(FileFormat format,
+                                const std::string& filename) {
+  file_.reset(new MappedFile());
+  if (!file_->Open(filename)) {
+    printf("ERROR: Can't open file: %s\n", filename.c_str());
+    return false;
+  }
+  switch (format) {
+    case kPcap:
+      return IndexPcap();
+    case kRtpDump:
+      return IndexRtpDump();
+    case kLengthPacketInterleaved:
+      return IndexInterleaved();
+  }
+  return false;
+}
+
+bool IndexedRtpFileReader::NextPacket(RtpPacket* packet) {
+  RtpPacketView view;
+  if (!NextPacketView(&view))
+    return false;
+  if (view.length > RtpPacket::kMaxPacketBufferSize) {
+    FATAL() << "Packet is too large to fit: " << view.length << " bytes vs "
+            << RtpPacket::kMaxPacketBufferSize
+            << " bytes allocated. Consider using NextPacketView().";
+  }
+  memcpy(packet->data, view.data, view.length);
+  packet->length = view.length;
+  packet->original_length = view.original_length;
+  packet->time_ms = view.time_ms;
+  return true;
+}
+
+bool IndexedRtpFileReader::NextPacketView(RtpPacketView* packet) {
+  if (next_ >= selected_.size())
+    return false;
+  const PacketInfo& info = index_[selected_[next_++]];
+  packet->data = file_->data() + info.offset;
+  packet->length = info.length;
+  packet->original_length = info.original_length;
+  packet->time_ms = info.time_ms;
+  packet->ssrc = info.ssrc;
+  packet->is_rtcp = info.is_rtcp;
+  return true;
+}
+
+void IndexedRtpFileReader::SetSsrcFilter(
+    const std::set<uint32_t>& ssrc_filter) {
+  selected_.clear();
+  selected_.reserve(index_.size());
+  for (size_t i = 0; i < index_.size(); ++i) {
+    if (ssrc_filter.empty() || index_[i].is_rtcp ||
+        ssrc_filter.find(index_[i].ssrc) != ssrc_filter.end()) {
+      selected_.push_back(static_cast<uint32_t>(i));
+    }
+  }
+  next_ = 0;
+}
+
+void IndexedRtpFileReader::SeekToIndex(size_t index) {
+  next_ = std::min(index, selected_.size());
+}
+
+bool IndexedRtpFileReader::SeekToTime(uint32_t time_ms) {
+  // Packets are stored in capture order, so time stamps are non-decreasing.
+  size_t low = 0;
+  size_t high = selected_.size();
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (index_[selected_[mid]].time_ms < time_ms) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  next_ = low;
+  return next_ < selected_.size();
+}
+
+std::map<uint32_t, size_t> IndexedRtpFileReader::PacketsPerSsrc() const {
+  std::map<uint32_t, size_t> packets_per_ssrc;
+  for (size_t i = 0; i < index_.size(); ++i) {
+    if (!index_[i].is_rtcp)
+      ++packets_per_ssrc[index_[i].ssrc];
+  }
+  return packets_per_ssrc;
+}
+
+void IndexedRtpFileReader::AddPacket(size_t offset,
+                                     uint32_t length,
+                                     uint32_t original_length,
+                                     uint32_t time_ms,
+                                     bool require_valid_header) {
+  const uint8_t* data = file_->data() + offset;
+  PacketInfo info;
+  info.offset = offset;
+  info.length = length;
+  info.original_length = original_length;
+  info.time_ms = time_ms;
+
+  RtpUtility::RtpHeaderParser rtp_parser(data, length);
+  RTPHeader header;
+  info.is_rtcp = rtp_parser.RTCP();
+  bool valid = info.is_rtcp ? rtp_parser.ParseRtcp(&header)
+                            : rtp_parser.Parse(header, NULL);
+  if (valid) {
+    info.ssrc = header.ssrc;
+  } else if (require_valid_header) {
+    DEBUG_LOG("Not recognized as RTP/RTCP");
+    return;
+  } else {
+    // E.g. a header-only dump with a truncated header extension.
+    info.ssrc = length >= 12 ? ByteReader<uint32_t>::ReadBigEndian(data + 8)
+                             : 0;
+  }
+  index_.push_back(info);
+}
+
+bool IndexedRtpFileReader::IndexRtpDump() {
+  const char* text = reinterpret_cast<const char*>(file_->data());
+  // Like fgets(), the first line ends at a newline or after
+  // kFirstLineLength - 1 characters.
+  size_t line_length = 0;
+  while (line_length < file_->size() && line_length < kFirstLineLength - 1) {
+    if (text[line_length++] == '\n')
+      break;
+  }
+  std::string firstline(text ? text : "", line_length);
+  if (firstline.compare(0, 9, "#!rtpplay") == 0) {
+    if (firstline.compare(0, 12, "#!rtpplay1.0") != 0) {
+      DEBUG_LOG("ERROR: wrong rtpplay version, must be 1.0\n");
+      return false;
+    }
+  } else if (firstline.compare(0, 11, "#!RTPencode") == 0) {
+    if (firstline.compare(0, 14, "#!RTPencode1.0") != 0) {
+      DEBUG_LOG("ERROR: wrong RTPencode version, must be 1.0\n");
+      return false;
+    }
+  } else {
+    DEBUG_LOG("ERROR: wrong file format of input file\n");
+    return false;
+  }
+
+  BufferReader reader(file_->data(), file_->size());
+  reader.set_pos(line_length);
+  // start_sec, start_usec, source, port and padding.
+  TRY(reader.Skip(16));
+
+  while (true) {
+    uint16_t len;
+    uint16_t plen;
+    uint32_t offset;
+    if (!reader.ReadUint16(&len, true) || !reader.ReadUint16(&plen, true) ||
+        !reader.ReadUint32(&offset, true)) {
+      break;
+    }
+    if (len < kPacketHeaderSize)
+      break;
+    // Use 'len' here because a 'plen' of 0 specifies rtcp.
+    len -= kPacketHeaderSize;
+    size_t pos = reader.pos();
+    if (!reader.Skip(len))
+      break;
+    AddPacket(pos, len, plen, offset, false);
+  }
+  return true;
+}
+
+bool IndexedRtpFileReader::IndexInterleaved() {
+  BufferReader reader(file_->data(), file_->size());
+  uint32_t time_ms = 0;
+  uint32_t len;
+  while (reader.ReadUint32(&len, true)) {
+    size_t pos = reader.pos();
+    if (!reader.Skip(len))
+      break;
+    AddPacket(pos, len, len, time_ms, false);
+    time_ms += 5;
+  }
+  return true;
+}
+
+bool IndexedRtpFileReader::IndexPcap() {
+  BufferReader reader(file_->data(), file_->size());
+
+  // The global header is written in the byte order of the capturing host,
+  // which is detected from the magic number.
+  uint32_t magic;
+  TRY(reader.ReadUint32(&magic, false));
+  bool big_endian;
+  if (magic == kPcapBOMNoSwapOrder) {
+    big_endian = false;
+  } else if (magic == kPcapBOMSwapOrder) {
+    big_endian = true;
+  } else {
+    return false;
+  }
+
+  uint16_t version_major;
+  uint16_t version_minor;
+  TRY(reader.ReadUint16(&version_major, big_endian));
+  TRY(reader.ReadUint16(&version_minor, big_endian));
+  if (version_major != kPcapVersionMajor ||
+      version_minor != kPcapVersionMinor) {
+    return false;
+  }
+
+  // this_zone, sigfigs and snaplen.
+  TRY(reader.Skip(12));
+  uint32_t network;
+  TRY(reader.ReadUint32(&network, big_endian));
+  // Accept only LINKTYPE_NULL and LINKTYPE_ETHERNET.
+  // See: http://www.tcpdump.org/linktypes.html
+  if (network != kLinktypeNull && network != kLinktypeEthernet)
+    return false;
+
+  int total_packet_count = 0;
+  bool have_start_time = false;
+  uint64_t stream_start_ms = 0;
+  while (reader.remaining() > 0) {
+    uint32_t ts_sec;    // Timestamp seconds.
+    uint32_t ts_usec;   // Timestamp microseconds.
+    uint32_t incl_len;  // Number of octets of packet saved in file.
+    uint32_t orig_len;  // Actual length of packet.
+    if (!reader.ReadUint32(&ts_sec, big_endian) ||
+        !reader.ReadUint32(&ts_usec, big_endian) ||
+        !reader.ReadUint32(&incl_len, big_endian) ||
+        !reader.ReadUint32(&orig_len, big_endian) ||
+        reader.remaining() < incl_len) {
+      printf("Failed reading file!\n");
+      return false;
+    }
+    ++total_packet_count;
+    size_t frame_pos = reader.pos();
+    reader.Skip(incl_len);
+
+    size_t payload_pos;
+    uint32_t payload_length;
+    if (!ParsePcapFrame(file_->data() + frame_pos, incl_len, &payload_pos,
+                        &payload_length)) {
+      continue;
+    }
+
+    // Round to nearest ms.
+    uint64_t time_ms =
+        ((static_cast<uint64_t>(ts_sec) * 1000000) + ts_usec + 500) / 1000;
+    size_t index_size = index_.size();
+    AddPacket(frame_pos + payload_pos, payload_length, payload_length, 0, true);
+    if (index_.size() == index_size)
+      continue;
+    if (!have_start_time) {
+      stream_start_ms = time_ms;
+      have_start_time = true;
+    }
+    index_.back().time_ms = time_ms < stream_start_ms ?
+        0 : static_cast<uint32_t>(time_ms - stream_start_ms);
+  }
+
+  printf("Total packets in file: %d\n", total_packet_count);
+  printf("Total RTP/RTCP packets: %" PRIuS "\n", index_.size());
+  std::map<uint32_t, size_t> packets_per_ssrc = PacketsPerSsrc();
+  for (std::map<uint32_t, size_t>::const_iterator it =
+           packets_per_ssrc.begin();
+       it != packets_per_ssrc.end(); ++it) {
+    printf("SSRC: %08x, %" PRIuS " packets\n", it->first, it->second);
+  }
+  return true;
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -10,9 +10,13 @@
 #ifndef WEBRTC_TEST_RTP_FILE_READER_H_
 #define WEBRTC_TEST_RTP_FILE_READER_H_
 
+#include <map>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_types.h"
 
 namespace webrtc {
@@ -38,12 +42,106 @@ class RtpFileReader {
   virtual ~RtpFileReader() {}
   static RtpFileReader* Create(FileFormat format,
                                const std::string& filename);
+  // Only RTP packets with an SSRC in |ssrc_filter| are returned, for all the
+  // file formats; RTCP packets are always returned. Packet times of pcap files
+  // are relative to the first RTP/RTCP packet in the file, whether or not it
+  // passes the filter.
   static RtpFileReader* Create(FileFormat format,
                                const std::string& filename,
                                const std::set<uint32_t>& ssrc_filter);
 
+  // Creates a reader that reads the file sequentially through stdio instead
+  // of mapping it into memory, for files that don't fit into the address
+  // space. Create() returns an IndexedRtpFileReader. These readers apply
+  // |ssrc_filter| to pcap files only, and pcap packet times are relative to
+  // the first packet that passes the filter.
+  static RtpFileReader* CreateStreaming(FileFormat format,
+                                        const std::string& filename,
+                                        const std::set<uint32_t>& ssrc_filter);
+
   virtual bool NextPacket(RtpPacket* packet) = 0;
 };
+
+// A packet referring directly to the memory of an IndexedRtpFileReader. The
+// data is valid for as long as the reader is alive.
+struct RtpPacketView {
+  const uint8_t* data;
+  size_t length;
+  // The length the packet had on wire, see RtpPacket.
+  size_t original_length;
+  uint32_t time_ms;
+  uint32_t ssrc;
+  bool is_rtcp;
+};
+
+// Reader that maps the whole file into memory and builds an index of all
+// packets once at creation. Packets can then be iterated without copying,
+// restricted to a set of SSRCs and seeked to by index or time.
+class IndexedRtpFileReader : public RtpFileReader {
+ public:
+  struct PacketInfo {
+    size_t offset;  // Byte offset of the RTP/RTCP data in the file.
+    uint32_t length;
+    uint32_t original_length;
+    uint32_t time_ms;
+    uint32_t ssrc;  // Sender SSRC for RTCP packets.
+    bool is_rtcp;
+  };
+
+  static IndexedRtpFileReader* Create(FileFormat format,
+                                      const std::string& filename);
+  static IndexedRtpFileReader* Create(FileFormat format,
+                                      const std::string& filename,
+                                      const std::set<uint32_t>& ssrc_filter);
+  ~IndexedRtpFileReader() override;
+
+  // Copies the next packet into |packet|.
+  bool NextPacket(RtpPacket* packet) override;
+  // Returns the next packet without copying.
+  bool NextPacketView(RtpPacketView* packet);
+
+  // Restricts iteration to RTP packets with one of the given SSRCs. RTCP
+  // packets are always included. An empty set selects all packets. Resets the
+  // read position to the first selected packet.
+  void SetSsrcFilter(const std::set<uint32_t>& ssrc_filter);
+
+  // Number of packets selected by the current SSRC filter.
+  size_t NumPackets() const { return selected_.size(); }
+  // Moves the read position to the |index|th selected packet.
+  void SeekToIndex(size_t index);
+  // Moves the read position to the first selected packet with a time stamp
+  // not earlier than |time_ms|. Returns false if there is no such packet.
+  bool SeekToTime(uint32_t time_ms);
+  size_t position() const { return next_; }
+
+  // All RTP/RTCP packets in the file, regardless of SSRC filter.
+  const std::vector<PacketInfo>& index() const { return index_; }
+  // Number of RTP packets per SSRC in the file.
+  std::map<uint32_t, size_t> PacketsPerSsrc() const;
+
+ private:
+  class MappedFile;
+
+  IndexedRtpFileReader();
+
+  bool Init(FileFormat format, const std::string& filename);
+  bool IndexRtpDump();
+  bool IndexPcap();
+  bool IndexInterleaved();
+  void AddPacket(size_t offset,
+                 uint32_t length,
+                 uint32_t original_length,
+                 uint32_t time_ms,
+                 bool require_valid_header);
+
+  rtc::scoped_ptr<MappedFile> file_;
+  std::vector<PacketInfo> index_;
+  // Indices into |index_| of the packets matching the SSRC filter.
+  std::vector<uint32_t> selected_;
+  size_t next_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(IndexedRtpFileReader);
+};
 }  // namespace test
 }  // namespace webrtc
 #endif  // WEBRTC_TEST_RTP_FILE_READER_H_
@@ -8,12 +8,19 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+#include <string.h>
+
 #include <map>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/test/rtp_file_reader.h"
+#include "webrtc/test/rtp_file_writer.h"
 #include "webrtc/test/testsupport/fileutils.h"
 
 namespace webrtc {
@@ -122,4 +129,279 @@ TEST_F(TestPcapFileReader, TestThreeSsrc) {
   EXPECT_EQ(113, pps[0x59fe6ef0]);
   EXPECT_EQ(61, pps[0xed2bd2ac]);
 }
+
+namespace {
+
+const uint32_t kSsrcs[] = {0x11111111, 0x22222222, 0x33333333};
+const size_t kNumSsrcs = sizeof(kSsrcs) / sizeof(kSsrcs[0]);
+const int kPacketIntervalMs = 10;
+
+// Builds a minimal RTP packet of |length| bytes.
+void BuildRtpPacket(uint16_t sequence_number,
+                    uint32_t ssrc,
+                    size_t length,
+                    uint8_t* data) {
+  memset(data, 0, length);
+  data[0] = 0x80;  // Version 2.
+  data[1] = 100;   // Payload type.
+  ByteWriter<uint16_t>::WriteBigEndian(&data[2], sequence_number);
+  ByteWriter<uint32_t>::WriteBigEndian(&data[4], sequence_number * 90);
+  ByteWriter<uint32_t>::WriteBigEndian(&data[8], ssrc);
+  for (size_t i = 12; i < length; ++i)
+    data[i] = static_cast<uint8_t>(i + sequence_number);
+}
+
+// Writes an rtpdump with packets cycling through |kSsrcs|.
+void WriteRtpDump(const std::string& filename,
+                  int num_packets,
+                  size_t packet_length) {
+  rtc::scoped_ptr<test::RtpFileWriter> writer(
+      test::RtpFileWriter::Create(test::RtpFileWriter::kRtpDump, filename));
+  ASSERT_TRUE(writer.get() != NULL);
+  test::RtpPacket packet;
+  for (int i = 0; i < num_packets; ++i) {
+    BuildRtpPacket(static_cast<uint16_t>(i), kSsrcs[i % kNumSsrcs],
+                   packet_length, packet.data);
+    packet.length = packet_length;
+    packet.original_length = packet_length;
+    packet.time_ms = i * kPacketIntervalMs;
+    ASSERT_TRUE(writer->WritePacket(&packet));
+  }
+}
+
+void WriteLittleEndian32(FILE* file, uint32_t value) {
+  uint8_t buffer[4];
+  ByteWriter<uint32_t>::WriteLittleEndian(buffer, value);
+  fwrite(buffer, 1, sizeof(buffer), file);
+}
+
+// Writes a little-endian pcap with Ethernet II framed UDP packets cycling
+// through |kSsrcs|, preceded by one ARP frame which should be ignored.
+void WritePcap(const std::string& filename, int num_packets) {
+  FILE* file = fopen(filename.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+  WriteLittleEndian32(file, 0xa1b2c3d4);
+  WriteLittleEndian32(file, 2 | (4 << 16));  // Version 2.4.
+  WriteLittleEndian32(file, 0);              // this_zone.
+  WriteLittleEndian32(file, 0);              // sigfigs.
+  WriteLittleEndian32(file, 65535);          // snaplen.
+  WriteLittleEndian32(file, 1);              // LINKTYPE_ETHERNET.
+
+  const size_t kRtpLength = 200;
+  const size_t kFrameLength = 14 + 20 + 8 + kRtpLength;
+  uint8_t frame[kFrameLength];
+  for (int i = -1; i < num_packets; ++i) {
+    memset(frame, 0, sizeof(frame));
+    // Ethertype: ARP for the first frame, otherwise IPv4.
+    ByteWriter<uint16_t>::WriteBigEndian(&frame[12], i < 0 ? 0x0806 : 0x0800);
+    uint8_t* ip = &frame[14];
+    ip[0] = 0x45;  // IPv4, 20 byte header.
+    ByteWriter<uint16_t>::WriteBigEndian(&ip[2], 20 + 8 + kRtpLength);
+    ip[9] = 0x11;  // UDP.
+    uint8_t* udp = &ip[20];
+    ByteWriter<uint16_t>::WriteBigEndian(&udp[4], 8 + kRtpLength);
+    if (i >= 0) {
+      BuildRtpPacket(static_cast<uint16_t>(i), kSsrcs[i % kNumSsrcs],
+                     kRtpLength, &udp[8]);
+    }
+    uint64_t time_us = 1400000000000000ull + (i + 1) * kPacketIntervalMs * 1000;
+    WriteLittleEndian32(file, static_cast<uint32_t>(time_us / 1000000));
+    WriteLittleEndian32(file, static_cast<uint32_t>(time_us % 1000000));
+    WriteLittleEndian32(file, kFrameLength);
+    WriteLittleEndian32(file, kFrameLength);
+    fwrite(frame, 1, sizeof(frame), file);
+  }
+  fclose(file);
+}
+
+void ExpectSamePackets(test::RtpFileReader* expected,
+                       test::RtpFileReader* actual) {
+  test::RtpPacket expected_packet;
+  test::RtpPacket actual_packet;
+  int count = 0;
+  while (expected->NextPacket(&expected_packet)) {
+    ASSERT_TRUE(actual->NextPacket(&actual_packet));
+    ASSERT_EQ(expected_packet.length, actual_packet.length);
+    EXPECT_EQ(expected_packet.original_length, actual_packet.original_length);
+    EXPECT_EQ(expected_packet.time_ms, actual_packet.time_ms);
+    EXPECT_EQ(0, memcmp(expected_packet.data, actual_packet.data,
+                        expected_packet.length));
+    ++count;
+  }
+  EXPECT_FALSE(actual->NextPacket(&actual_packet));
+  EXPECT_GT(count, 0);
+}
+
+}  // namespace
+
+class TestIndexedRtpFileReader : public ::testing::Test {
+ protected:
+  static const int kNumPackets = 90;
+
+  void SetUp() override {
+    rtpdump_file_ = test::OutputPath() + "indexed_rtp_file_reader.rtp";
+    pcap_file_ = test::OutputPath() + "indexed_rtp_file_reader.pcap";
+    WriteRtpDump(rtpdump_file_, kNumPackets, 500);
+    WritePcap(pcap_file_, kNumPackets);
+  }
+
+  void TearDown() override {
+    remove(rtpdump_file_.c_str());
+    remove(pcap_file_.c_str());
+  }
+
+  std::string rtpdump_file_;
+  std::string pcap_file_;
+};
+
+TEST_F(TestIndexedRtpFileReader, MatchesStreamingRtpDump) {
+  rtc::scoped_ptr<test::RtpFileReader> streaming(
+      test::RtpFileReader::CreateStreaming(test::RtpFileReader::kRtpDump,
+                                           rtpdump_file_,
+                                           std::set<uint32_t>()));
+  rtc::scoped_ptr<test::IndexedRtpFileReader> indexed(
+      test::IndexedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                         rtpdump_file_));
+  ASSERT_TRUE(streaming.get() != NULL);
+  ASSERT_TRUE(indexed.get() != NULL);
+  EXPECT_EQ(static_cast<size_t>(kNumPackets), indexed->NumPackets());
+  ExpectSamePackets(streaming.get(), indexed.get());
+}
+
+TEST_F(TestIndexedRtpFileReader, MatchesStreamingPcap) {
+  rtc::scoped_ptr<test::RtpFileReader> streaming(
+      test::RtpFileReader::CreateStreaming(test::RtpFileReader::kPcap,
+                                           pcap_file_, std::set<uint32_t>()));
+  rtc::scoped_ptr<test::IndexedRtpFileReader> indexed(
+      test::IndexedRtpFileReader::Create(test::RtpFileReader::kPcap,
+                                         pcap_file_));
+  ASSERT_TRUE(streaming.get() != NULL);
+  ASSERT_TRUE(indexed.get() != NULL);
+  EXPECT_EQ(static_cast<size_t>(kNumPackets), indexed->NumPackets());
+  ExpectSamePackets(streaming.get(), indexed.get());
+}
+
+TEST_F(TestIndexedRtpFileReader, RejectsWrongFormat) {
+  rtc::scoped_ptr<test::IndexedRtpFileReader> reader(
+      test::IndexedRtpFileReader::Create(test::RtpFileReader::kPcap,
+                                         rtpdump_file_));
+  EXPECT_TRUE(reader.get() == NULL);
+  reader.reset(test::IndexedRtpFileReader::Create(
+      test::RtpFileReader::kRtpDump, pcap_file_));
+  EXPECT_TRUE(reader.get() == NULL);
+}
+
+TEST_F(TestIndexedRtpFileReader, PacketViewsPointIntoFile) {
+  rtc::scoped_ptr<test::IndexedRtpFileReader> reader(
+      test::IndexedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                         rtpdump_file_));
+  ASSERT_TRUE(reader.get() != NULL);
+  test::RtpPacketView first;
+  ASSERT_TRUE(reader->NextPacketView(&first));
+  test::RtpPacketView second;
+  ASSERT_TRUE(reader->NextPacketView(&second));
+  EXPECT_EQ(kSsrcs[0], first.ssrc);
+  EXPECT_EQ(kSsrcs[1], second.ssrc);
+  EXPECT_FALSE(first.is_rtcp);
+  // Consecutive packets are 500 bytes apart plus the rtpdump packet header.
+  EXPECT_EQ(first.data + 500 + 8, second.data);
+  reader->SeekToIndex(0);
+  test::RtpPacketView again;
+  ASSERT_TRUE(reader->NextPacketView(&again));
+  EXPECT_EQ(first.data, again.data);
+}
+
+TEST_F(TestIndexedRtpFileReader, FiltersSsrcs) {
+  std::set<uint32_t> ssrcs;
+  ssrcs.insert(kSsrcs[1]);
+  rtc::scoped_ptr<test::IndexedRtpFileReader> reader(
+      test::IndexedRtpFileReader::Create(test::RtpFileReader::kPcap,
+                                         pcap_file_, ssrcs));
+  ASSERT_TRUE(reader.get() != NULL);
+  EXPECT_EQ(static_cast<size_t>(kNumPackets / kNumSsrcs),
+            reader->NumPackets());
+  test::RtpPacketView packet;
+  while (reader->NextPacketView(&packet))
+    EXPECT_EQ(kSsrcs[1], packet.ssrc);
+
+  std::map<uint32_t, size_t> packets_per_ssrc = reader->PacketsPerSsrc();
+  EXPECT_EQ(kNumSsrcs, packets_per_ssrc.size());
+  for (size_t i = 0; i < kNumSsrcs; ++i)
+    EXPECT_EQ(kNumPackets / kNumSsrcs, packets_per_ssrc[kSsrcs[i]]);
+
+  reader->SetSsrcFilter(std::set<uint32_t>());
+  EXPECT_EQ(static_cast<size_t>(kNumPackets), reader->NumPackets());
+}
+
+TEST_F(TestIndexedRtpFileReader, SeeksToTime) {
+  rtc::scoped_ptr<test::IndexedRtpFileReader> reader(
+      test::IndexedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                         rtpdump_file_));
+  ASSERT_TRUE(reader.get() != NULL);
+  test::RtpPacketView packet;
+  ASSERT_TRUE(reader->SeekToTime(42 * kPacketIntervalMs));
+  EXPECT_EQ(42u, reader->position());
+  ASSERT_TRUE(reader->NextPacketView(&packet));
+  EXPECT_EQ(static_cast<uint32_t>(42 * kPacketIntervalMs), packet.time_ms);
+
+  // Between two packets, seeks to the later one.
+  ASSERT_TRUE(reader->SeekToTime(42 * kPacketIntervalMs + 1));
+  ASSERT_TRUE(reader->NextPacketView(&packet));
+  EXPECT_EQ(static_cast<uint32_t>(43 * kPacketIntervalMs), packet.time_ms);
+
+  EXPECT_FALSE(reader->SeekToTime(kNumPackets * kPacketIntervalMs));
+  EXPECT_FALSE(reader->NextPacketView(&packet));
+}
+
+// Compares read throughput of the streaming and the indexed readers on a
+// ~250 MB rtpdump.
+TEST(RtpFileReaderBenchmark, DISABLED_ReadThroughput) {
+  const int kBenchmarkPackets = 200000;
+  const size_t kPacketLength = 1200;
+  const std::string filename =
+      test::OutputPath() + "rtp_file_reader_benchmark.rtp";
+  WriteRtpDump(filename, kBenchmarkPackets, kPacketLength);
+  const double megabytes =
+      static_cast<double>(kBenchmarkPackets) * kPacketLength / (1 << 20);
+
+  test::RtpPacket packet;
+  int64_t start_us = rtc::TimeMicros();
+  rtc::scoped_ptr<test::RtpFileReader> streaming(
+      test::RtpFileReader::CreateStreaming(test::RtpFileReader::kRtpDump,
+                                           filename, std::set<uint32_t>()));
+  ASSERT_TRUE(streaming.get() != NULL);
+  while (streaming->NextPacket(&packet)) {
+  }
+  double streaming_s = (rtc::TimeMicros() - start_us) / 1e6;
+
+  start_us = rtc::TimeMicros();
+  rtc::scoped_ptr<test::IndexedRtpFileReader> indexed(
+      test::IndexedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                         filename));
+  ASSERT_TRUE(indexed.get() != NULL);
+  double index_s = (rtc::TimeMicros() - start_us) / 1e6;
+
+  start_us = rtc::TimeMicros();
+  while (indexed->NextPacket(&packet)) {
+  }
+  double copy_s = (rtc::TimeMicros() - start_us) / 1e6;
+
+  std::set<uint32_t> ssrcs;
+  ssrcs.insert(kSsrcs[0]);
+  indexed->SetSsrcFilter(ssrcs);
+  start_us = rtc::TimeMicros();
+  test::RtpPacketView view;
+  uint32_t checksum = 0;
+  while (indexed->NextPacketView(&view))
+    checksum += view.data[view.length - 1];
+  double view_s = (rtc::TimeMicros() - start_us) / 1e6;
+
+  printf("Streaming reader: %.1f MB/s\n", megabytes / streaming_s);
+  printf("Indexed reader: index built in %.1f ms, %.1f MB/s copying, "
+         "%.0f packets/s zero-copy with SSRC filter (checksum %u)\n",
+         index_s * 1000, megabytes / copy_s,
+         indexed->NumPackets() / view_s, checksum);
+  remove(filename.c_str());
+}
+
 }  // namespace webrtc
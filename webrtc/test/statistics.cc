@@ -22,6 +22,12 @@ void Statistics::AddSample(double sample) {
   ++count_;
 }
 
+void Statistics::Merge(const Statistics& other) {
+  sum_ += other.sum_;
+  sum_squared_ += other.sum_squared_;
+  count_ += other.count_;
+}
+
 double Statistics::Mean() const {
   if (count_ == 0)
     return 0.0;
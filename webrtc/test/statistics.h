@@ -20,6 +20,8 @@ class Statistics {
   Statistics();
 
   void AddSample(double sample);
+  // Adds all samples of |other|.
+  void Merge(const Statistics& other);
 
   double Mean() const;
   double Variance() const;
@@ -2599,6 +2599,92 @@ TEST_F(EndToEndTest, TestReceivedRtpPacketStats) {
   RunBaseTest(&test);
 }
 
+TEST_F(EndToEndTest, ReportsFrameStageLatencies) {
+  static const int kMinFramesPerStage = 30;
+  static const char* const kStageNames[] = {
+      "captured", "encode_start", "encoded", "packetized", "sent",
+      "received", "complete", "decode_start", "decoded", "rendered"};
+  static_assert(sizeof(kStageNames) / sizeof(kStageNames[0]) ==
+                    kVideoFrameStageCount,
+                "A name is needed for each stage.");
+  class FrameStageLatencyObserver : public test::EndToEndTest {
+   public:
+    FrameStageLatencyObserver()
+        : EndToEndTest(kLongTimeoutMs),
+          send_stream_(nullptr),
+          receive_stream_(nullptr) {}
+
+   private:
+    void OnStreamsCreated(
+        VideoSendStream* send_stream,
+        const std::vector<VideoReceiveStream*>& receive_streams) override {
+      send_stream_ = send_stream;
+      receive_stream_ = receive_streams[0];
+    }
+
+    Action OnSendRtp(const uint8_t* packet, size_t length) override {
+      if (HasFrames(send_stream_->GetStats().frame_stage_latencies,
+                    kVideoFrameSent) &&
+          HasFrames(receive_stream_->GetStats().frame_stage_latencies,
+                    kVideoFrameRendered)) {
+        observation_complete_->Set();
+      }
+      return SEND_PACKET;
+    }
+
+    static bool HasFrames(
+        const std::map<VideoFrameStage, FrameStageLatency>& latencies,
+        VideoFrameStage stage) {
+      std::map<VideoFrameStage, FrameStageLatency>::const_iterator it =
+          latencies.find(stage);
+      return it != latencies.end() &&
+             it->second.num_frames >= kMinFramesPerStage;
+    }
+
+    static void PrintLatencies(
+        const std::string& side,
+        const std::map<VideoFrameStage, FrameStageLatency>& latencies) {
+      for (const auto& it : latencies) {
+        EXPECT_GE(it.second.p95_ms, it.second.median_ms);
+        EXPECT_GE(it.second.max_ms, it.second.p95_ms);
+        const std::string trace = side + "_" + kStageNames[it.first];
+        test::PrintResult("frame_stage_latency_avg", "", trace,
+                          static_cast<size_t>(it.second.avg_ms), "ms", false);
+        test::PrintResult("frame_stage_latency_p95", "", trace,
+                          static_cast<size_t>(it.second.p95_ms), "ms", false);
+      }
+    }
+
+    void PerformTest() override {
+      EXPECT_EQ(kEventSignaled, Wait())
+          << "Timed out waiting for frame stage latencies.";
+      const std::map<VideoFrameStage, FrameStageLatency> send_latencies =
+          send_stream_->GetStats().frame_stage_latencies;
+      const std::map<VideoFrameStage, FrameStageLatency> receive_latencies =
+          receive_stream_->GetStats().frame_stage_latencies;
+      // Every stage on either side is reached by the frames of this call.
+      for (int stage = kVideoFrameEncodeStart; stage <= kVideoFrameSent;
+           ++stage) {
+        EXPECT_EQ(1u, send_latencies.count(static_cast<VideoFrameStage>(stage)))
+            << kStageNames[stage];
+      }
+      for (int stage = kVideoFrameComplete; stage <= kVideoFrameRendered;
+           ++stage) {
+        EXPECT_EQ(1u,
+                  receive_latencies.count(static_cast<VideoFrameStage>(stage)))
+            << kStageNames[stage];
+      }
+      PrintLatencies("send", send_latencies);
+      PrintLatencies("receive", receive_latencies);
+    }
+
+    VideoSendStream* send_stream_;
+    VideoReceiveStream* receive_stream_;
+  } test;
+
+  RunBaseTest(&test);
+}
+
 TEST_F(EndToEndTest, SendsSetSsrc) { TestSendsSetSsrcs(1, false); }
 
 TEST_F(EndToEndTest, SendsSetSimulcastSsrcs) {
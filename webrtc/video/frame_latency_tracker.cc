@@ -0,0 +1,127 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video/frame_latency_tracker.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+
+const int FrameLatencyTracker::kMaxLatencyMs = 2000;
+const size_t FrameLatencyTracker::kMaxPendingFrames = 300;
+
+FrameLatencyTracker::Histogram::Histogram()
+    : num_samples_(0), sum_ms_(0), max_ms_(0) {}
+
+void FrameLatencyTracker::Histogram::Add(int64_t latency_ms) {
+  const int clamped_ms = static_cast<int>(
+      std::min<int64_t>(std::max<int64_t>(latency_ms, 0), kMaxLatencyMs));
+  // The bins only grow to the largest latency seen, so that stages which are
+  // never reached, or are fast, take little memory.
+  if (static_cast<size_t>(clamped_ms) >= bins_.size())
+    bins_.resize(clamped_ms + 1, 0);
+  ++bins_[clamped_ms];
+  ++num_samples_;
+  sum_ms_ += clamped_ms;
+  max_ms_ = std::max(max_ms_, clamped_ms);
+}
+
+FrameStageLatency FrameLatencyTracker::Histogram::Summary() const {
+  FrameStageLatency latency;
+  latency.num_frames = num_samples_;
+  if (num_samples_ == 0)
+    return latency;
+  latency.avg_ms =
+      static_cast<int>((sum_ms_ + num_samples_ / 2) / num_samples_);
+  latency.median_ms = Percentile(50);
+  latency.p95_ms = Percentile(95);
+  latency.max_ms = max_ms_;
+  return latency;
+}
+
+int FrameLatencyTracker::Histogram::Percentile(int percent) const {
+  // Smallest latency such that at least |percent| % of the samples are at or
+  // below it.
+  const int64_t rank = (static_cast<int64_t>(num_samples_) * percent + 99) / 100;
+  int64_t count = 0;
+  for (size_t i = 0; i < bins_.size(); ++i) {
+    count += bins_[i];
+    if (count >= rank)
+      return static_cast<int>(i);
+  }
+  return max_ms_;
+}
+
+FrameLatencyTracker::PendingFrame::PendingFrame() {
+  std::fill(stage_time_ms, stage_time_ms + kVideoFrameStageCount, -1);
+}
+
+FrameLatencyTracker::FrameLatencyTracker(VideoFrameStage first_stage,
+                                         VideoFrameStage last_stage)
+    : first_stage_(first_stage), last_stage_(last_stage) {
+  RTC_DCHECK_LT(first_stage, last_stage);
+}
+
+FrameLatencyTracker::~FrameLatencyTracker() {}
+
+void FrameLatencyTracker::OnFrameStage(VideoFrameStage stage,
+                                       int64_t frame_id,
+                                       int64_t now_ms) {
+  if (stage < first_stage_ || stage > last_stage_)
+    return;
+
+  std::map<int64_t, PendingFrame>::iterator it = pending_frames_.find(frame_id);
+  if (it == pending_frames_.end()) {
+    if (stage == last_stage_)
+      return;  // Nothing to measure against.
+    if (pending_frames_.size() >= kMaxPendingFrames) {
+      pending_frames_.erase(pending_order_.front());
+      pending_order_.pop_front();
+    }
+    it = pending_frames_.insert(std::make_pair(frame_id, PendingFrame())).first;
+    pending_order_.push_back(frame_id);
+  }
+  if (it->second.stage_time_ms[stage] == -1)
+    it->second.stage_time_ms[stage] = now_ms;
+  if (stage != last_stage_)
+    return;
+
+  AccountFrame(it->second);
+  pending_frames_.erase(it);
+  pending_order_.erase(
+      std::find(pending_order_.begin(), pending_order_.end(), frame_id));
+}
+
+void FrameLatencyTracker::AccountFrame(const PendingFrame& frame) {
+  int64_t previous_ms = -1;
+  for (int stage = first_stage_; stage <= last_stage_; ++stage) {
+    const int64_t time_ms = frame.stage_time_ms[stage];
+    if (time_ms == -1)
+      continue;
+    if (previous_ms != -1)
+      histograms_[stage].Add(time_ms - previous_ms);
+    previous_ms = time_ms;
+  }
+}
+
+std::map<VideoFrameStage, FrameStageLatency>
+FrameLatencyTracker::GetLatencies() const {
+  std::map<VideoFrameStage, FrameStageLatency> latencies;
+  for (int stage = first_stage_ + 1; stage <= last_stage_; ++stage) {
+    FrameStageLatency latency = histograms_[stage].Summary();
+    if (latency.num_frames > 0)
+      latencies[static_cast<VideoFrameStage>(stage)] = latency;
+  }
+  return latencies;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_FRAME_LATENCY_TRACKER_H_
+#define WEBRTC_VIDEO_FRAME_LATENCY_TRACKER_H_
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "webrtc/common_types.h"
+
+namespace webrtc {
+
+// Collects the times at which frames reach the stages of one side of the
+// video pipeline, and keeps a histogram per stage of the time frames spent
+// getting there from the previous stage they reached. A frame is accounted
+// for once it reaches |last_stage|; frames that never do are forgotten.
+// Not thread safe.
+class FrameLatencyTracker {
+ public:
+  // Latencies above this are counted as this value.
+  static const int kMaxLatencyMs;
+  // Maximum number of frames tracked at the same time.
+  static const size_t kMaxPendingFrames;
+
+  FrameLatencyTracker(VideoFrameStage first_stage, VideoFrameStage last_stage);
+  ~FrameLatencyTracker();
+
+  // Only the first time a frame reaches a stage is used.
+  void OnFrameStage(VideoFrameStage stage, int64_t frame_id, int64_t now_ms);
+
+  // Returns the latency of the stages at least one frame has reached,
+  // excluding |first_stage|.
+  std::map<VideoFrameStage, FrameStageLatency> GetLatencies() const;
+
+ private:
+  class Histogram {
+   public:
+    Histogram();
+    void Add(int64_t latency_ms);
+    FrameStageLatency Summary() const;
+
+   private:
+    int Percentile(int percent) const;
+
+    // Number of samples per 1 ms of latency, up to |max_ms_|.
+    std::vector<int> bins_;
+    int num_samples_;
+    int64_t sum_ms_;
+    int max_ms_;
+  };
+
+  struct PendingFrame {
+    PendingFrame();
+    int64_t stage_time_ms[kVideoFrameStageCount];
+  };
+
+  void AccountFrame(const PendingFrame& frame);
+
+  const VideoFrameStage first_stage_;
+  const VideoFrameStage last_stage_;
+  std::map<int64_t, PendingFrame> pending_frames_;
+  // Ids of |pending_frames_| in the order they were first seen.
+  std::deque<int64_t> pending_order_;
+  Histogram histograms_[kVideoFrameStageCount];
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_FRAME_LATENCY_TRACKER_H_
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video/frame_latency_tracker.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace webrtc {
+
+TEST(FrameLatencyTrackerTest, NoLatenciesBeforeFramesComplete) {
+  FrameLatencyTracker tracker(kVideoFrameCaptured, kVideoFrameSent);
+  tracker.OnFrameStage(kVideoFrameCaptured, 1, 0);
+  tracker.OnFrameStage(kVideoFrameEncoded, 1, 10);
+  EXPECT_TRUE(tracker.GetLatencies().empty());
+}
+
+TEST(FrameLatencyTrackerTest, AccountsEachStageFromPreviousStage) {
+  FrameLatencyTracker tracker(kVideoFrameCaptured, kVideoFrameSent);
+  tracker.OnFrameStage(kVideoFrameCaptured, 1, 100);
+  tracker.OnFrameStage(kVideoFrameEncodeStart, 1, 105);
+  // Encoded is never reported, packetization is measured from encode start.
+  tracker.OnFrameStage(kVideoFramePacketized, 1, 125);
+  tracker.OnFrameStage(kVideoFrameSent, 1, 128);
+
+  std::map<VideoFrameStage, FrameStageLatency> latencies =
+      tracker.GetLatencies();
+  ASSERT_EQ(3u, latencies.size());
+  EXPECT_EQ(5, latencies[kVideoFrameEncodeStart].avg_ms);
+  EXPECT_EQ(20, latencies[kVideoFramePacketized].avg_ms);
+  EXPECT_EQ(3, latencies[kVideoFrameSent].max_ms);
+  EXPECT_EQ(1, latencies[kVideoFrameSent].num_frames);
+}
+
+TEST(FrameLatencyTrackerTest, FirstTimeAtStageIsUsed) {
+  FrameLatencyTracker tracker(kVideoFrameReceived, kVideoFrameRendered);
+  tracker.OnFrameStage(kVideoFrameReceived, 90000, 0);
+  tracker.OnFrameStage(kVideoFrameReceived, 90000, 30);
+  tracker.OnFrameStage(kVideoFrameRendered, 90000, 40);
+  EXPECT_EQ(40, tracker.GetLatencies()[kVideoFrameRendered].avg_ms);
+}
+
+TEST(FrameLatencyTrackerTest, IgnoresStagesOutsideRange) {
+  FrameLatencyTracker tracker(kVideoFrameReceived, kVideoFrameRendered);
+  tracker.OnFrameStage(kVideoFrameCaptured, 1, 0);
+  tracker.OnFrameStage(kVideoFrameSent, 1, 5);
+  // A frame that is only seen at the last stage can't be measured.
+  tracker.OnFrameStage(kVideoFrameRendered, 1, 10);
+  EXPECT_TRUE(tracker.GetLatencies().empty());
+}
+
+TEST(FrameLatencyTrackerTest, ComputesPercentiles) {
+  FrameLatencyTracker tracker(kVideoFrameReceived, kVideoFrameDecoded);
+  // Latencies 1..100 ms.
+  for (int i = 1; i <= 100; ++i) {
+    tracker.OnFrameStage(kVideoFrameReceived, i, 1000 * i);
+    tracker.OnFrameStage(kVideoFrameDecoded, i, 1000 * i + i);
+  }
+  FrameStageLatency latency = tracker.GetLatencies()[kVideoFrameDecoded];
+  EXPECT_EQ(100, latency.num_frames);
+  EXPECT_EQ(51, latency.avg_ms);
+  EXPECT_EQ(50, latency.median_ms);
+  EXPECT_EQ(95, latency.p95_ms);
+  EXPECT_EQ(100, latency.max_ms);
+}
+
+TEST(FrameLatencyTrackerTest, ClampsLatencies) {
+  FrameLatencyTracker tracker(kVideoFrameReceived, kVideoFrameDecoded);
+  tracker.OnFrameStage(kVideoFrameReceived, 1, 0);
+  tracker.OnFrameStage(kVideoFrameDecoded, 1,
+                       10 * FrameLatencyTracker::kMaxLatencyMs);
+  EXPECT_EQ(FrameLatencyTracker::kMaxLatencyMs,
+            tracker.GetLatencies()[kVideoFrameDecoded].max_ms);
+}
+
+TEST(FrameLatencyTrackerTest, ForgetsOldestIncompleteFrames) {
+  FrameLatencyTracker tracker(kVideoFrameReceived, kVideoFrameDecoded);
+  const int kNumFrames =
+      static_cast<int>(FrameLatencyTracker::kMaxPendingFrames) + 1;
+  for (int i = 0; i < kNumFrames; ++i)
+    tracker.OnFrameStage(kVideoFrameReceived, i, i);
+  // The first frame has been dropped to make room for the last one.
+  tracker.OnFrameStage(kVideoFrameDecoded, 0, 1000);
+  EXPECT_TRUE(tracker.GetLatencies().empty());
+  tracker.OnFrameStage(kVideoFrameDecoded, kNumFrames - 1, kNumFrames + 9);
+  EXPECT_EQ(10, tracker.GetLatencies()[kVideoFrameDecoded].avg_ms);
+}
+
+}  // namespace webrtc
@@ -26,7 +26,8 @@ ReceiveStatisticsProxy::ReceiveStatisticsProxy(uint32_t ssrc, Clock* clock)
       decode_fps_estimator_(1000, 1000),
       renders_fps_estimator_(1000, 1000),
       render_fps_tracker_(100u, 10u),
-      render_pixel_tracker_(100u, 10u) {
+      render_pixel_tracker_(100u, 10u),
+      frame_latency_tracker_(kVideoFrameReceived, kVideoFrameRendered) {
   stats_.ssrc = ssrc;
 }
 
@@ -72,7 +73,9 @@ void ReceiveStatisticsProxy::UpdateHistograms() {
 
 VideoReceiveStream::Stats ReceiveStatisticsProxy::GetStats() const {
   rtc::CritScope lock(&crit_);
-  return stats_;
+  VideoReceiveStream::Stats stats = stats_;
+  stats.frame_stage_latencies = frame_latency_tracker_.GetLatencies();
+  return stats;
 }
 
 void ReceiveStatisticsProxy::OnIncomingPayloadType(int payload_type) {
@@ -185,9 +188,17 @@ void ReceiveStatisticsProxy::OnDiscardedPacketsUpdated(int discarded_packets) {
   stats_.discarded_packets = discarded_packets;
 }
 
+void ReceiveStatisticsProxy::OnFrameStage(VideoFrameStage stage,
+                                          uint32_t rtp_timestamp) {
+  rtc::CritScope lock(&crit_);
+  frame_latency_tracker_.OnFrameStage(stage, rtp_timestamp,
+                                      clock_->TimeInMilliseconds());
+}
+
 void ReceiveStatisticsProxy::OnPreDecode(
     const EncodedImage& encoded_image,
     const CodecSpecificInfo* codec_specific_info) {
+  OnFrameStage(kVideoFrameDecodeStart, encoded_image._timeStamp);
   if (codec_specific_info == nullptr || encoded_image.qp_ == -1) {
     return;
   }
@@ -20,7 +20,6 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/call.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
-#include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
 #include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/sleep.h"
 #include "webrtc/test/encoder_settings.h"
@@ -132,6 +131,10 @@ static std::string DecoderBitstreamFilename() {
 DEFINE_string(codec, "VP8", "Video codec");
 static std::string Codec() { return static_cast<std::string>(FLAGS_codec); }
 
+// Flag for skipping the beginning of the input file.
+DEFINE_int32(start_time_ms, 0, "Start replaying at this offset into the file");
+static int StartTimeMs() { return static_cast<int>(FLAGS_start_time_ms); }
+
 }  // namespace flags
 
 static const uint32_t kReceiverLocalSsrc = 0x123456;
@@ -255,17 +258,18 @@ void RtpReplay() {
   VideoReceiveStream* receive_stream =
       call->CreateVideoReceiveStream(receive_config);
 
-  rtc::scoped_ptr<test::RtpFileReader> rtp_reader(test::RtpFileReader::Create(
-      test::RtpFileReader::kRtpDump, flags::InputFile()));
+  rtc::scoped_ptr<test::IndexedRtpFileReader> rtp_reader(
+      test::IndexedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                         flags::InputFile()));
   if (rtp_reader.get() == nullptr) {
-    rtp_reader.reset(test::RtpFileReader::Create(test::RtpFileReader::kPcap,
-                                                 flags::InputFile()));
+    rtp_reader.reset(test::IndexedRtpFileReader::Create(
+        test::RtpFileReader::kPcap, flags::InputFile()));
     if (rtp_reader.get() == nullptr) {
       fprintf(stderr,
               "Couldn't open input file as either a rtpdump or .pcap. Note "
               "that .pcapng is not supported.\nTrying to interpret the file as "
               "length/packet interleaved.\n");
-      rtp_reader.reset(test::RtpFileReader::Create(
+      rtp_reader.reset(test::IndexedRtpFileReader::Create(
           test::RtpFileReader::kLengthPacketInterleaved, flags::InputFile()));
       if (rtp_reader.get() == nullptr) {
         fprintf(stderr,
@@ -274,14 +278,19 @@ void RtpReplay() {
       }
     }
   }
+  if (flags::StartTimeMs() > 0 &&
+      !rtp_reader->SeekToTime(static_cast<uint32_t>(flags::StartTimeMs()))) {
+    fprintf(stderr, "No packets after %d ms.\n", flags::StartTimeMs());
+    return;
+  }
   receive_stream->Start();
 
   uint32_t last_time_ms = 0;
   int num_packets = 0;
   std::map<uint32_t, int> unknown_packets;
   while (true) {
-    test::RtpPacket packet;
-    if (!rtp_reader->NextPacket(&packet))
+    test::RtpPacketView packet;
+    if (!rtp_reader->NextPacketView(&packet))
       break;
     ++num_packets;
     switch (call->Receiver()->DeliverPacket(webrtc::MediaType::ANY, packet.data,
@@ -289,12 +298,9 @@ void RtpReplay() {
       case PacketReceiver::DELIVERY_OK:
         break;
       case PacketReceiver::DELIVERY_UNKNOWN_SSRC: {
-        RTPHeader header;
-        rtc::scoped_ptr<RtpHeaderParser> parser(RtpHeaderParser::Create());
-        parser->Parse(packet.data, packet.length, &header);
-        if (unknown_packets[header.ssrc] == 0)
-          fprintf(stderr, "Unknown SSRC: %u!\n", header.ssrc);
-        ++unknown_packets[header.ssrc];
+        if (unknown_packets[packet.ssrc] == 0)
+          fprintf(stderr, "Unknown SSRC: %u!\n", packet.ssrc);
+        ++unknown_packets[packet.ssrc];
         break;
       }
       case PacketReceiver::DELIVERY_PACKET_ERROR:
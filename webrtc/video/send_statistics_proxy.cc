@@ -31,7 +31,8 @@ SendStatisticsProxy::SendStatisticsProxy(Clock* clock,
       sent_frame_rate_tracker_(100u, 10u),
       last_sent_frame_timestamp_(0),
       max_sent_width_per_timestamp_(0),
-      max_sent_height_per_timestamp_(0) {
+      max_sent_height_per_timestamp_(0),
+      frame_latency_tracker_(kVideoFrameCaptured, kVideoFrameSent) {
 }
 
 SendStatisticsProxy::~SendStatisticsProxy() {
@@ -117,6 +118,7 @@ VideoSendStream::Stats SendStatisticsProxy::GetStats() {
   PurgeOldStats();
   stats_.input_frame_rate =
       static_cast<int>(input_frame_rate_tracker_.ComputeRate());
+  stats_.frame_stage_latencies = frame_latency_tracker_.GetLatencies();
   return stats_;
 }
 
@@ -181,6 +183,9 @@ void SendStatisticsProxy::OnSendEncodedImage(
   uint32_t ssrc = config_.rtp.ssrcs[simulcast_idx];
 
   rtc::CritScope lock(&crit_);
+  frame_latency_tracker_.OnFrameStage(kVideoFrameEncoded,
+                                      encoded_image.capture_time_ms_,
+                                      clock_->TimeInMilliseconds());
   VideoSendStream::StreamStats* stats = GetStatsEntry(ssrc);
   if (stats == nullptr)
     return;
@@ -309,6 +314,13 @@ void SendStatisticsProxy::SendSideDelayUpdated(int avg_delay_ms,
   stats->max_delay_ms = max_delay_ms;
 }
 
+void SendStatisticsProxy::OnFrameStage(VideoFrameStage stage,
+                                       int64_t capture_time_ms) {
+  rtc::CritScope lock(&crit_);
+  frame_latency_tracker_.OnFrameStage(stage, capture_time_ms,
+                                      clock_->TimeInMilliseconds());
+}
+
 void SendStatisticsProxy::SampleCounter::Add(int sample) {
   sum += sample;
   ++num_samples;
@@ -21,6 +21,7 @@
 #include "webrtc/modules/video_coding/codecs/interface/video_codec_interface.h"
 #include "webrtc/modules/video_coding/main/interface/video_coding_defines.h"
 #include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/video/frame_latency_tracker.h"
 #include "webrtc/video_engine/overuse_frame_detector.h"
 #include "webrtc/video_engine/vie_encoder.h"
 #include "webrtc/video_send_stream.h"
@@ -34,7 +35,8 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
                             public BitrateStatisticsObserver,
                             public FrameCountObserver,
                             public VideoEncoderRateObserver,
-                            public SendSideDelayObserver {
+                            public SendSideDelayObserver,
+                            public VideoFrameStageObserver {
  public:
   static const int kStatsTimeoutMs;
 
@@ -54,6 +56,9 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
   // From VideoEncoderRateObserver.
   void OnSetRates(uint32_t bitrate_bps, int framerate) override;
 
+  // From VideoFrameStageObserver.
+  void OnFrameStage(VideoFrameStage stage, int64_t capture_time_ms) override;
+
   void OnOutgoingRate(uint32_t framerate, uint32_t bitrate);
   void OnSuspendChange(bool is_suspended);
   void OnInactiveSsrc(uint32_t ssrc);
@@ -142,6 +147,7 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
   SampleCounter quality_downscales_counter_ GUARDED_BY(crit_);
   BoolSampleCounter bw_limited_frame_counter_ GUARDED_BY(crit_);
   SampleCounter bw_resolutions_disabled_counter_ GUARDED_BY(crit_);
+  FrameLatencyTracker frame_latency_tracker_ GUARDED_BY(crit_);
 };
 
 }  // namespace webrtc
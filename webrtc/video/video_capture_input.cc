@@ -110,6 +110,8 @@ void VideoCaptureInput::IncomingCapturedFrame(const VideoFrame& video_frame) {
 
   captured_frame_.ShallowCopy(incoming_frame);
   last_captured_timestamp_ = incoming_frame.ntp_time_ms();
+  stats_proxy_->OnFrameStage(kVideoFrameCaptured,
+                             incoming_frame.render_time_ms());
 
   overuse_detector_->FrameCaptured(captured_frame_.width(),
                                    captured_frame_.height(),
@@ -65,7 +65,7 @@ class VideoAnalyzer : public PacketReceiver,
         rtp_timestamp_delta_(0),
         avg_psnr_threshold_(avg_psnr_threshold),
         avg_ssim_threshold_(avg_ssim_threshold),
-        comparison_available_event_(EventWrapper::Create()),
+        next_worker_(0),
         done_(EventWrapper::Create()) {
     // Create thread pool for CPU-expensive PSNR/SSIM calculations.
 
@@ -86,11 +86,12 @@ class VideoAnalyzer : public PacketReceiver,
       num_cores = std::min(num_cores, kMaxComparisonThreads);
     }
 
-    for (uint32_t i = 0; i < num_cores; ++i) {
-      rtc::scoped_ptr<ThreadWrapper> thread =
-          ThreadWrapper::CreateThread(&FrameComparisonThread, this, "Analyzer");
-      EXPECT_TRUE(thread->Start());
-      comparison_thread_pool_.push_back(thread.release());
+    for (uint32_t i = 0; i < num_cores; ++i)
+      comparison_workers_.push_back(new ComparisonWorker(this));
+    for (ComparisonWorker* worker : comparison_workers_) {
+      worker->thread = ThreadWrapper::CreateThread(&FrameComparisonThread,
+                                                   worker, "Analyzer");
+      EXPECT_TRUE(worker->thread->Start());
     }
 
     stats_polling_thread_ =
@@ -99,10 +100,12 @@ class VideoAnalyzer : public PacketReceiver,
   }
 
   ~VideoAnalyzer() {
-    for (ThreadWrapper* thread : comparison_thread_pool_) {
-      EXPECT_TRUE(thread->Stop());
-      delete thread;
-    }
+    // The last thread to finish wakes up the others through their workers,
+    // so none may be deleted before all threads are stopped.
+    for (ComparisonWorker* worker : comparison_workers_)
+      EXPECT_TRUE(worker->thread->Stop());
+    for (ComparisonWorker* worker : comparison_workers_)
+      delete worker;
   }
 
   virtual void SetReceiver(PacketReceiver* receiver) { receiver_ = receiver; }
@@ -172,7 +175,7 @@ class VideoAnalyzer : public PacketReceiver,
   }
 
   void EncodedFrameCallback(const EncodedFrame& frame) override {
-    rtc::CritScope lock(&comparison_lock_);
+    rtc::CritScope lock(&crit_);
     if (frames_recorded_ < frames_to_process_)
       encoded_frame_size_.AddSample(frame.length_);
   }
@@ -312,6 +315,25 @@ class VideoAnalyzer : public PacketReceiver,
     double ssim;
   };
 
+  // A comparison thread with its own queue and results, so that the threads
+  // neither contend with each other nor with the renderer for a shared lock.
+  struct ComparisonWorker {
+    explicit ComparisonWorker(VideoAnalyzer* analyzer)
+        : analyzer(analyzer), comparison_available(EventWrapper::Create()) {}
+
+    VideoAnalyzer* const analyzer;
+    rtc::scoped_ptr<ThreadWrapper> thread;
+    const rtc::scoped_ptr<EventWrapper> comparison_available;
+    rtc::CriticalSection crit;
+    std::deque<FrameComparison> comparisons GUARDED_BY(crit);
+
+    // Only accessed by |thread| until all frames have been processed.
+    test::Statistics psnr;
+    test::Statistics ssim;
+    test::Statistics comparison_time_ms;
+    std::vector<Sample> samples;
+  };
+
   void AddFrameComparison(const VideoFrame& reference,
                           const VideoFrame& render,
                           bool dropped,
@@ -325,16 +347,44 @@ class VideoAnalyzer : public PacketReceiver,
     size_t encoded_size = encoded_frame_sizes_[reference.timestamp()];
     encoded_frame_sizes_.erase(reference.timestamp());
 
-    VideoFrame reference_copy;
-    VideoFrame render_copy;
-    reference_copy.CopyFrame(reference);
-    render_copy.CopyFrame(render);
+    if (frames_recorded_ == frames_to_process_)
+      return;
+    ++frames_recorded_;
 
-    rtc::CritScope crit(&comparison_lock_);
-    comparisons_.push_back(FrameComparison(reference_copy, render_copy, dropped,
-                                           send_time_ms, recv_time_ms,
-                                           render_time_ms, encoded_size));
-    comparison_available_event_->Set();
+    // The frames are shared rather than copied; video frame buffers are
+    // copy-on-write, so neither the capturer nor the decoder will modify them.
+    FrameComparison comparison(reference, render, dropped, send_time_ms,
+                               recv_time_ms, render_time_ms, encoded_size);
+    AddTimingSamples(comparison);
+
+    // All comparisons take about as long, so handing them out in turn keeps
+    // the threads evenly loaded.
+    ComparisonWorker* worker = comparison_workers_[next_worker_];
+    next_worker_ = (next_worker_ + 1) % comparison_workers_.size();
+    {
+      rtc::CritScope crit(&worker->crit);
+      worker->comparisons.push_back(comparison);
+    }
+    worker->comparison_available->Set();
+  }
+
+  // Adds the samples that depend on the order in which frames are rendered.
+  void AddTimingSamples(const FrameComparison& comparison)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    if (comparison.dropped) {
+      ++dropped_frames_;
+      return;
+    }
+    if (last_render_time_ != 0)
+      rendered_delta_.AddSample(comparison.render_time_ms - last_render_time_);
+    last_render_time_ = comparison.render_time_ms;
+
+    int64_t input_time_ms = comparison.reference.ntp_time_ms();
+    sender_time_.AddSample(comparison.send_time_ms - input_time_ms);
+    receiver_time_.AddSample(comparison.render_time_ms -
+                             comparison.recv_time_ms);
+    end_to_end_.AddSample(comparison.render_time_ms - input_time_ms);
+    encoded_frame_size_.AddSample(comparison.encoded_frame_size);
   }
 
   static bool PollStatsThread(void* obj) {
@@ -365,70 +415,53 @@ class VideoAnalyzer : public PacketReceiver,
   }
 
   static bool FrameComparisonThread(void* obj) {
-    return static_cast<VideoAnalyzer*>(obj)->CompareFrames();
+    ComparisonWorker* worker = static_cast<ComparisonWorker*>(obj);
+    return worker->analyzer->CompareFrames(worker);
   }
 
-  bool CompareFrames() {
-    if (AllFramesRecorded())
-      return false;
-
-    VideoFrame reference;
-    VideoFrame render;
+  bool CompareFrames(ComparisonWorker* worker) {
     FrameComparison comparison;
-
-    if (!PopComparison(&comparison)) {
-      // Wait until new comparison task is available, or test is done.
-      // If done, wake up remaining threads waiting.
-      comparison_available_event_->Wait(1000);
-      if (AllFramesRecorded()) {
-        comparison_available_event_->Set();
+    if (!PopComparison(worker, &comparison)) {
+      if (AllFramesProcessed())
         return false;
-      }
+      // Wait until new comparison task is available, or test is done.
+      worker->comparison_available->Wait(1000);
       return true;  // Try again.
     }
 
-    PerformFrameComparison(comparison);
+    PerformFrameComparison(worker, comparison);
 
     if (FrameProcessed()) {
+      MergeResults();
       PrintResults();
       if (graph_data_output_file_)
         PrintSamplesToFile();
+      // Wake up the other threads, so that they exit. This must happen
+      // before |done_| is set, after which the analyzer may be destroyed.
+      for (ComparisonWorker* other : comparison_workers_)
+        other->comparison_available->Set();
       done_->Set();
-      comparison_available_event_->Set();
       return false;
     }
 
     return true;
   }
 
-  bool PopComparison(FrameComparison* comparison) {
-    rtc::CritScope crit(&comparison_lock_);
-    // If AllFramesRecorded() is true, it means we have already popped
-    // frames_to_process_ frames from comparisons_, so there is no more work
-    // for this thread to be done. frames_processed_ might still be lower if
-    // all comparisons are not done, but those frames are currently being
-    // worked on by other threads.
-    if (comparisons_.empty() || AllFramesRecorded())
+  static bool PopComparison(ComparisonWorker* worker,
+                            FrameComparison* comparison) {
+    rtc::CritScope crit(&worker->crit);
+    if (worker->comparisons.empty())
       return false;
 
-    *comparison = comparisons_.front();
-    comparisons_.pop_front();
-
-    FrameRecorded();
+    *comparison = worker->comparisons.front();
+    worker->comparisons.pop_front();
     return true;
   }
 
-  // Increment counter for number of frames received for comparison.
-  void FrameRecorded() {
-    rtc::CritScope crit(&comparison_lock_);
-    ++frames_recorded_;
-  }
-
-  // Returns true if all frames to be compared have been taken from the queue.
-  bool AllFramesRecorded() {
+  // Returns true if all frames to be compared have been processed.
+  bool AllFramesProcessed() {
     rtc::CritScope crit(&comparison_lock_);
-    assert(frames_recorded_ <= frames_to_process_);
-    return frames_recorded_ == frames_to_process_;
+    return frames_processed_ == frames_to_process_;
   }
 
   // Increase count of number of frames processed. Returns true if this was the
@@ -440,7 +473,21 @@ class VideoAnalyzer : public PacketReceiver,
     return frames_processed_ == frames_to_process_;
   }
 
+  // Collects the results of all comparison threads. Only called once all
+  // frames have been processed, when the threads are done with their results.
+  void MergeResults() {
+    rtc::CritScope crit(&comparison_lock_);
+    for (ComparisonWorker* worker : comparison_workers_) {
+      psnr_.Merge(worker->psnr);
+      ssim_.Merge(worker->ssim);
+      comparison_time_ms_.Merge(worker->comparison_time_ms);
+      samples_.insert(samples_.end(), worker->samples.begin(),
+                      worker->samples.end());
+    }
+  }
+
   void PrintResults() {
+    rtc::CritScope lock(&crit_);
     rtc::CritScope crit(&comparison_lock_);
     PrintResult("psnr", psnr_, " dB");
     PrintResult("ssim", ssim_, "");
@@ -455,41 +502,35 @@ class VideoAnalyzer : public PacketReceiver,
     PrintResult("encode_time", encode_time_ms, " ms");
     PrintResult("encode_usage_percent", encode_usage_percent, " percent");
     PrintResult("media_bitrate", media_bitrate_bps, " bps");
+    // How many frames per second the comparison threads can keep up with.
+    PrintResult("comparison_time", comparison_time_ms_, " ms");
+    printf("RESULT analyzer_throughput: %s = %f fps (%" PRIuS " threads)\n",
+           test_label_.c_str(),
+           comparison_workers_.size() * 1000.0 / comparison_time_ms_.Mean(),
+           comparison_workers_.size());
 
     EXPECT_GT(psnr_.Mean(), avg_psnr_threshold_);
     EXPECT_GT(ssim_.Mean(), avg_ssim_threshold_);
   }
 
-  void PerformFrameComparison(const FrameComparison& comparison) {
-    // Perform expensive psnr and ssim calculations while not holding lock.
+  void PerformFrameComparison(ComparisonWorker* worker,
+                              const FrameComparison& comparison) {
+    Clock* clock = Clock::GetRealTimeClock();
+    int64_t start_time_us = clock->TimeInMicroseconds();
     double psnr = I420PSNR(&comparison.reference, &comparison.render);
     double ssim = I420SSIM(&comparison.reference, &comparison.render);
+    worker->comparison_time_ms.AddSample(
+        (clock->TimeInMicroseconds() - start_time_us) / 1000.0);
 
-    int64_t input_time_ms = comparison.reference.ntp_time_ms();
-
-    rtc::CritScope crit(&comparison_lock_);
+    worker->psnr.AddSample(psnr);
+    worker->ssim.AddSample(ssim);
     if (graph_data_output_file_) {
-      samples_.push_back(
-          Sample(comparison.dropped, input_time_ms, comparison.send_time_ms,
-                 comparison.recv_time_ms, comparison.render_time_ms,
-                 comparison.encoded_frame_size, psnr, ssim));
-    }
-    psnr_.AddSample(psnr);
-    ssim_.AddSample(ssim);
-
-    if (comparison.dropped) {
-      ++dropped_frames_;
-      return;
+      worker->samples.push_back(Sample(
+          comparison.dropped, comparison.reference.ntp_time_ms(),
+          comparison.send_time_ms, comparison.recv_time_ms,
+          comparison.render_time_ms, comparison.encoded_frame_size, psnr,
+          ssim));
     }
-    if (last_render_time_ != 0)
-      rendered_delta_.AddSample(comparison.render_time_ms - last_render_time_);
-    last_render_time_ = comparison.render_time_ms;
-
-    sender_time_.AddSample(comparison.send_time_ms - input_time_ms);
-    receiver_time_.AddSample(comparison.render_time_ms -
-                             comparison.recv_time_ms);
-    end_to_end_.AddSample(comparison.render_time_ms - input_time_ms);
-    encoded_frame_size_.AddSample(comparison.encoded_frame_size);
   }
 
   void PrintResult(const char* result_type,
@@ -551,23 +592,24 @@ class VideoAnalyzer : public PacketReceiver,
   FILE* const graph_data_output_file_;
   std::vector<Sample> samples_ GUARDED_BY(comparison_lock_);
   std::map<int64_t, int> samples_encode_time_ms_ GUARDED_BY(comparison_lock_);
-  test::Statistics sender_time_ GUARDED_BY(comparison_lock_);
-  test::Statistics receiver_time_ GUARDED_BY(comparison_lock_);
+  test::Statistics sender_time_ GUARDED_BY(crit_);
+  test::Statistics receiver_time_ GUARDED_BY(crit_);
   test::Statistics psnr_ GUARDED_BY(comparison_lock_);
   test::Statistics ssim_ GUARDED_BY(comparison_lock_);
-  test::Statistics end_to_end_ GUARDED_BY(comparison_lock_);
-  test::Statistics rendered_delta_ GUARDED_BY(comparison_lock_);
-  test::Statistics encoded_frame_size_ GUARDED_BY(comparison_lock_);
+  test::Statistics comparison_time_ms_ GUARDED_BY(comparison_lock_);
+  test::Statistics end_to_end_ GUARDED_BY(crit_);
+  test::Statistics rendered_delta_ GUARDED_BY(crit_);
+  test::Statistics encoded_frame_size_ GUARDED_BY(crit_);
   test::Statistics encode_frame_rate_ GUARDED_BY(comparison_lock_);
   test::Statistics encode_time_ms GUARDED_BY(comparison_lock_);
   test::Statistics encode_usage_percent GUARDED_BY(comparison_lock_);
   test::Statistics media_bitrate_bps GUARDED_BY(comparison_lock_);
 
   const int frames_to_process_;
-  int frames_recorded_;
-  int frames_processed_;
-  int dropped_frames_;
-  int64_t last_render_time_;
+  int frames_recorded_ GUARDED_BY(crit_);
+  int frames_processed_ GUARDED_BY(comparison_lock_);
+  int dropped_frames_ GUARDED_BY(crit_);
+  int64_t last_render_time_ GUARDED_BY(crit_);
   uint32_t rtp_timestamp_delta_;
 
   rtc::CriticalSection crit_;
@@ -581,10 +623,9 @@ class VideoAnalyzer : public PacketReceiver,
   const double avg_ssim_threshold_;
 
   rtc::CriticalSection comparison_lock_;
-  std::vector<ThreadWrapper*> comparison_thread_pool_;
+  std::vector<ComparisonWorker*> comparison_workers_;
+  size_t next_worker_ GUARDED_BY(crit_);
   rtc::scoped_ptr<ThreadWrapper> stats_polling_thread_;
-  const rtc::scoped_ptr<EventWrapper> comparison_available_event_;
-  std::deque<FrameComparison> comparisons_ GUARDED_BY(comparison_lock_);
   const rtc::scoped_ptr<EventWrapper> done_;
 };
 
@@ -21,6 +21,7 @@
 #include "webrtc/system_wrappers/interface/logging.h"
 #include "webrtc/video/receive_statistics_proxy.h"
 #include "webrtc/video_engine/call_stats.h"
+#include "webrtc/video_engine/vie_sync_service.h"
 #include "webrtc/video_receive_stream.h"
 
 namespace webrtc {
@@ -144,13 +145,15 @@ VideoReceiveStream::VideoReceiveStream(
     const VideoReceiveStream::Config& config,
     webrtc::VoiceEngine* voice_engine,
     ProcessThread* process_thread,
-    CallStats* call_stats)
+    CallStats* call_stats,
+    ViESyncService* sync_service)
     : transport_adapter_(config.rtcp_send_transport),
       encoded_frame_proxy_(config.pre_decode_callback),
       config_(config),
       clock_(Clock::GetRealTimeClock()),
       congestion_controller_(congestion_controller),
-      call_stats_(call_stats) {
+      call_stats_(call_stats),
+      sync_service_(sync_service) {
   LOG(LS_INFO) << "VideoReceiveStream: " << config_.ToString();
 
   bool send_side_bwe = UseSendSideBwe(config_.rtp.extensions);
@@ -170,6 +173,7 @@ VideoReceiveStream::VideoReceiveStream(
 
   // Register the channel to receive stats updates.
   call_stats_->RegisterStatsObserver(vie_channel_->GetStatsObserver());
+  sync_service_->AddSyncModule(vie_channel_->GetSyncModule());
 
   // TODO(pbos): This is not fine grained enough...
   vie_channel_->SetProtectionMode(config_.rtp.nack.rtp_history_ms > 0, false,
@@ -291,6 +295,7 @@ VideoReceiveStream::~VideoReceiveStream() {
     vie_channel_->DeRegisterExternalDecoder(config_.decoders[i].payload_type);
 
   call_stats_->DeregisterStatsObserver(vie_channel_->GetStatsObserver());
+  sync_service_->RemoveSyncModule(vie_channel_->GetSyncModule());
   congestion_controller_->SetChannelRembStatus(false, false,
                                                vie_channel_->rtp_rtcp());
 
@@ -359,6 +364,7 @@ int VideoReceiveStream::RenderFrame(const uint32_t /*stream_id*/,
         video_frame.render_time_ms() - clock_->TimeInMilliseconds());
 
   stats_proxy_->OnRenderedFrame(video_frame.width(), video_frame.height());
+  stats_proxy_->OnFrameStage(kVideoFrameRendered, video_frame.timestamp());
 
   return 0;
 }
@@ -30,6 +30,7 @@
 namespace webrtc {
 
 class CallStats;
+class ViESyncService;
 class CongestionController;
 class VoiceEngine;
 
@@ -45,7 +46,8 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
                      const VideoReceiveStream::Config& config,
                      webrtc::VoiceEngine* voice_engine,
                      ProcessThread* process_thread,
-                     CallStats* call_stats);
+                     CallStats* call_stats,
+                     ViESyncService* sync_service);
   ~VideoReceiveStream() override;
 
   // webrtc::ReceiveStream implementation.
@@ -84,6 +86,7 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
 
   CongestionController* const congestion_controller_;
   CallStats* const call_stats_;
+  ViESyncService* const sync_service_;
 
   rtc::scoped_ptr<IncomingVideoStream> incoming_video_stream_;
   rtc::scoped_ptr<ReceiveStatisticsProxy> stats_proxy_;
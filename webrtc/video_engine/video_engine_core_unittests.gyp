@@ -31,6 +31,7 @@
         'stream_synchronization_unittest.cc',
         'vie_codec_unittest.cc',
         'vie_remb_unittest.cc',
+        'vie_sync_service_unittest.cc',
       ],
       'conditions': [
         ['OS=="android"', {
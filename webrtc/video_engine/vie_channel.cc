@@ -132,6 +132,7 @@ ViEChannel::ViEChannel(uint32_t number_of_cores,
                                &send_bitrate_observer_,
                                &send_frame_count_observer_,
                                &send_side_delay_observer_,
+                               &send_frame_stage_observer_,
                                max_rtp_streams)),
       num_active_rtp_rtcp_modules_(1) {
   vie_receiver_.SetRtpRtcpModule(rtp_rtcp_modules_[0]);
@@ -164,7 +165,6 @@ int32_t ViEChannel::Init() {
   vcm_->SetRenderDelay(kViEDefaultRenderDelayMs);
 
   module_process_thread_->RegisterModule(vcm_);
-  module_process_thread_->RegisterModule(&vie_sync_);
 
   return 0;
 }
@@ -175,7 +175,6 @@ ViEChannel::~ViEChannel() {
   module_process_thread_->DeRegisterModule(
       vie_receiver_.GetReceiveStatistics());
   module_process_thread_->DeRegisterModule(vcm_);
-  module_process_thread_->DeRegisterModule(&vie_sync_);
   send_payload_router_->SetSendingRtpModules(std::list<RtpRtcp*>());
   for (size_t i = 0; i < num_active_rtp_rtcp_modules_; ++i)
     packet_router_->RemoveRtpModule(rtp_rtcp_modules_[i]);
@@ -914,6 +913,11 @@ void ViEChannel::RegisterSendSideDelayObserver(
   send_side_delay_observer_.Set(observer);
 }
 
+void ViEChannel::RegisterSendFrameStageObserver(
+    VideoFrameStageObserver* observer) {
+  send_frame_stage_observer_.Set(observer);
+}
+
 void ViEChannel::RegisterSendBitrateObserver(
     BitrateStatisticsObserver* observer) {
   send_bitrate_observer_.Set(observer);
@@ -1001,6 +1005,10 @@ CallStatsObserver* ViEChannel::GetStatsObserver() {
   return stats_observer_.get();
 }
 
+ViESyncModule* ViEChannel::GetSyncModule() {
+  return &vie_sync_;
+}
+
 // Do not acquire the lock of |vcm_| in this function. Decode callback won't
 // necessarily be called from the decoding thread. The decoding thread may have
 // held the lock when calling VideoDecoder::Decode, Reset, or Release. Acquiring
@@ -1008,6 +1016,10 @@ CallStatsObserver* ViEChannel::GetStatsObserver() {
 int32_t ViEChannel::FrameToRender(VideoFrame& video_frame) {  // NOLINT
   CriticalSectionScoped cs(crit_.get());
 
+  if (receive_stats_callback_)
+    receive_stats_callback_->OnFrameStage(kVideoFrameDecoded,
+                                          video_frame.timestamp());
+
   if (pre_render_callback_ != NULL)
     pre_render_callback_->FrameCallback(&video_frame);
 
@@ -1046,6 +1058,12 @@ void ViEChannel::OnFrameCountsUpdated(const FrameCounts& frame_counts) {
     receive_stats_callback_->OnFrameCountsUpdated(frame_counts);
 }
 
+void ViEChannel::OnFrameStage(VideoFrameStage stage, uint32_t rtp_timestamp) {
+  CriticalSectionScoped cs(crit_.get());
+  if (receive_stats_callback_)
+    receive_stats_callback_->OnFrameStage(stage, rtp_timestamp);
+}
+
 void ViEChannel::OnDecoderTiming(int decode_ms,
                                  int max_decode_ms,
                                  int current_delay_ms,
@@ -1134,6 +1152,7 @@ std::vector<RtpRtcp*> ViEChannel::CreateRtpRtcpModules(
     BitrateStatisticsObserver* send_bitrate_observer,
     FrameCountObserver* send_frame_count_observer,
     SendSideDelayObserver* send_side_delay_observer,
+    VideoFrameStageObserver* send_frame_stage_observer,
     size_t num_modules) {
   RTC_DCHECK_GT(num_modules, 0u);
   RtpRtcp::Configuration configuration;
@@ -1152,6 +1171,7 @@ std::vector<RtpRtcp*> ViEChannel::CreateRtpRtcpModules(
   configuration.send_bitrate_observer = send_bitrate_observer;
   configuration.send_frame_count_observer = send_frame_count_observer;
   configuration.send_side_delay_observer = send_side_delay_observer;
+  configuration.send_frame_stage_observer = send_frame_stage_observer;
   configuration.bandwidth_callback = bandwidth_callback;
   configuration.transport_feedback_callback = transport_feedback_callback;
 
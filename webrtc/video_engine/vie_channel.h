@@ -188,6 +188,10 @@ class ViEChannel : public VCMFrameTypeCallback,
 
   void RegisterSendSideDelayObserver(SendSideDelayObserver* observer);
 
+  // Called when the frame with the given capture time has been packetized and
+  // when its last packet has been sent.
+  void RegisterSendFrameStageObserver(VideoFrameStageObserver* observer);
+
   // Called on any new send bitrate estimate.
   void RegisterSendBitrateObserver(BitrateStatisticsObserver* observer);
 
@@ -226,6 +230,10 @@ class ViEChannel : public VCMFrameTypeCallback,
 
   CallStatsObserver* GetStatsObserver();
 
+  // Returns the module syncing this channel with a voice channel, to be
+  // updated by a ViESyncService.
+  ViESyncModule* GetSyncModule();
+
   // Implements VCMReceiveCallback.
   virtual int32_t FrameToRender(VideoFrame& video_frame);  // NOLINT
 
@@ -240,6 +248,7 @@ class ViEChannel : public VCMFrameTypeCallback,
   void OnReceiveRatesUpdated(uint32_t bit_rate, uint32_t frame_rate) override;
   void OnDiscardedPacketsUpdated(int discarded_packets) override;
   void OnFrameCountsUpdated(const FrameCounts& frame_counts) override;
+  void OnFrameStage(VideoFrameStage stage, uint32_t rtp_timestamp) override;
 
   // Implements VCMDecoderTimingCallback.
   virtual void OnDecoderTiming(int decode_ms,
@@ -305,6 +314,7 @@ class ViEChannel : public VCMFrameTypeCallback,
       BitrateStatisticsObserver* send_bitrate_observer,
       FrameCountObserver* send_frame_count_observer,
       SendSideDelayObserver* send_side_delay_observer,
+      VideoFrameStageObserver* send_frame_stage_observer,
       size_t num_modules);
 
   // Assumed to be protected.
@@ -381,6 +391,15 @@ class ViEChannel : public VCMFrameTypeCallback,
     }
   } send_side_delay_observer_;
 
+  class RegisterableVideoFrameStageObserver :
+      public RegisterableCallback<VideoFrameStageObserver> {
+    void OnFrameStage(VideoFrameStage stage, int64_t frame_id) override {
+      CriticalSectionScoped cs(critsect_.get());
+      if (callback_)
+        callback_->OnFrameStage(stage, frame_id);
+    }
+  } send_frame_stage_observer_;
+
   class RegisterableRtcpPacketTypeCounterObserver
       : public RegisterableCallback<RtcpPacketTypeCounterObserver> {
    public:
@@ -432,6 +432,11 @@ void ViEEncoder::DeliverFrame(VideoFrame video_frame) {
   const VideoFrame* output_frame =
       (decimated_frame != NULL) ? decimated_frame : &video_frame;
 
+  if (stats_proxy_ != NULL) {
+    stats_proxy_->OnFrameStage(kVideoFrameEncodeStart,
+                               output_frame->render_time_ms());
+  }
+
 #ifdef VIDEOCODEC_VP8
   if (vcm_->SendCodec() == webrtc::kVideoCodecVP8) {
     webrtc::CodecSpecificInfo codec_specific_info;
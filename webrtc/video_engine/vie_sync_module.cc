@@ -21,31 +21,51 @@
 
 namespace webrtc {
 
+namespace {
+
 int UpdateMeasurements(StreamSynchronization::Measurements* stream,
-                       const RtpRtcp& rtp_rtcp, const RtpReceiver& receiver) {
+                       const RtpReceiver& receiver) {
   if (!receiver.Timestamp(&stream->latest_timestamp))
     return -1;
   if (!receiver.LastReceivedTimeMs(&stream->latest_receive_time_ms))
     return -1;
+  return 0;
+}
 
-  uint32_t ntp_secs = 0;
-  uint32_t ntp_frac = 0;
-  uint32_t rtp_timestamp = 0;
-  if (0 != rtp_rtcp.RemoteNTP(&ntp_secs,
-                              &ntp_frac,
-                              NULL,
-                              NULL,
-                              &rtp_timestamp)) {
-    return -1;
-  }
+}  // namespace
 
-  bool new_rtcp_sr = false;
-  if (!UpdateRtcpList(
-      ntp_secs, ntp_frac, rtp_timestamp, &stream->rtcp, &new_rtcp_sr)) {
-    return -1;
+ViESyncModule::SenderReportCache::SenderReportCache()
+    : ssrc_(0), revision_(0) {}
+
+void ViESyncModule::SenderReportCache::OnSenderReport(uint32_t ssrc,
+                                                      uint32_t ntp_secs,
+                                                      uint32_t ntp_frac,
+                                                      uint32_t rtp_timestamp) {
+  rtc::CritScope lock(&crit_);
+  if (!rtcp_.empty() && ssrc != ssrc_) {
+    rtcp_.clear();
+    ++revision_;
   }
+  ssrc_ = ssrc;
+  bool new_rtcp_sr = false;
+  UpdateRtcpList(ntp_secs, ntp_frac, rtp_timestamp, &rtcp_, &new_rtcp_sr);
+  if (new_rtcp_sr)
+    ++revision_;
+}
 
-  return 0;
+void ViESyncModule::SenderReportCache::GetRtcpList(RtcpList* rtcp,
+                                                   int* revision) const {
+  rtc::CritScope lock(&crit_);
+  if (*revision == revision_)
+    return;
+  *rtcp = rtcp_;
+  *revision = revision_;
+}
+
+void ViESyncModule::SenderReportCache::Clear() {
+  rtc::CritScope lock(&crit_);
+  rtcp_.clear();
+  ++revision_;
 }
 
 ViESyncModule::ViESyncModule(VideoCodingModule* vcm)
@@ -55,11 +75,18 @@ ViESyncModule::ViESyncModule(VideoCodingModule* vcm)
       video_rtp_rtcp_(NULL),
       voe_channel_id_(-1),
       voe_sync_interface_(NULL),
-      last_sync_time_(TickTime::Now()),
-      sync_() {
+      voice_rtp_rtcp_(NULL),
+      sync_(),
+      last_target_audio_delay_ms_(-1),
+      last_target_video_delay_ms_(-1),
+      audio_reports_revision_(-1),
+      video_reports_revision_(-1) {
 }
 
 ViESyncModule::~ViESyncModule() {
+  // The video RTP module is owned by the same channel as this module, and is
+  // deleted first.
+  DeregisterVoiceSenderReports();
 }
 
 int ViESyncModule::ConfigureSync(int voe_channel_id,
@@ -74,12 +101,25 @@ int ViESyncModule::ConfigureSync(int voe_channel_id,
       video_rtp_rtcp_ == video_rtcp_module) {
     return 0;
   }
+  DeregisterVoiceSenderReports();
+  if (video_rtp_rtcp_ != video_rtcp_module) {
+    if (video_rtp_rtcp_)
+      video_rtp_rtcp_->RegisterRtcpSenderReportObserver(NULL);
+    video_reports_.Clear();
+    video_rtcp_module->RegisterRtcpSenderReportObserver(&video_reports_);
+  }
   voe_channel_id_ = voe_channel_id;
   voe_sync_interface_ = voe_sync_interface;
   video_receiver_ = video_receiver;
   video_rtp_rtcp_ = video_rtcp_module;
   sync_.reset(
       new StreamSynchronization(video_rtp_rtcp_->SSRC(), voe_channel_id));
+  audio_measurement_ = StreamSynchronization::Measurements();
+  video_measurement_ = StreamSynchronization::Measurements();
+  audio_reports_revision_ = -1;
+  video_reports_revision_ = -1;
+  last_target_audio_delay_ms_ = -1;
+  last_target_video_delay_ms_ = -1;
 
   if (!voe_sync_interface) {
     voe_channel_id_ = -1;
@@ -89,64 +129,103 @@ int ViESyncModule::ConfigureSync(int voe_channel_id,
     }
     return 0;
   }
+  RtpRtcp* voice_rtp_rtcp = NULL;
+  RtpReceiver* voice_receiver = NULL;
+  if (voe_sync_interface_->GetRtpRtcp(voe_channel_id_, &voice_rtp_rtcp,
+                                      &voice_receiver) == 0) {
+    RegisterVoiceSenderReports(voice_rtp_rtcp);
+  }
   return 0;
 }
 
-int ViESyncModule::VoiceChannel() {
-  return voe_channel_id_;
+void ViESyncModule::RegisterVoiceSenderReports(RtpRtcp* voice_rtp_rtcp) {
+  assert(!voice_rtp_rtcp_);
+  audio_reports_.Clear();
+  voice_rtp_rtcp->RegisterRtcpSenderReportObserver(&audio_reports_);
+  voice_rtp_rtcp_ = voice_rtp_rtcp;
 }
 
-int64_t ViESyncModule::TimeUntilNextProcess() {
-  const int64_t kSyncIntervalMs = 1000;
-  return kSyncIntervalMs - (TickTime::Now() - last_sync_time_).Milliseconds();
+void ViESyncModule::DeregisterVoiceSenderReports() {
+  if (!voice_rtp_rtcp_)
+    return;
+  // The voice channel may have been deleted, only touch its RTP module if it
+  // is still there.
+  RtpRtcp* voice_rtp_rtcp = NULL;
+  RtpReceiver* voice_receiver = NULL;
+  if (voe_sync_interface_->GetRtpRtcp(voe_channel_id_, &voice_rtp_rtcp,
+                                      &voice_receiver) == 0 &&
+      voice_rtp_rtcp == voice_rtp_rtcp_) {
+    voice_rtp_rtcp_->RegisterRtcpSenderReportObserver(NULL);
+  }
+  ForgetVoiceChannel();
 }
 
-int32_t ViESyncModule::Process() {
-  CriticalSectionScoped cs(data_cs_.get());
-  last_sync_time_ = TickTime::Now();
+void ViESyncModule::ForgetVoiceChannel() {
+  voice_rtp_rtcp_ = NULL;
+  audio_reports_.Clear();
+  audio_measurement_ = StreamSynchronization::Measurements();
+  audio_reports_revision_ = -1;
+  last_target_audio_delay_ms_ = -1;
+}
 
-  const int current_video_delay_ms = vcm_->Delay();
+int ViESyncModule::VoiceChannel() {
+  return voe_channel_id_;
+}
 
+void ViESyncModule::UpdateDelays() {
+  CriticalSectionScoped cs(data_cs_.get());
   if (voe_channel_id_ == -1) {
-    return 0;
+    return;
   }
   assert(video_rtp_rtcp_ && voe_sync_interface_);
   assert(sync_.get());
 
+  RtpRtcp* voice_rtp_rtcp = NULL;
+  RtpReceiver* voice_receiver = NULL;
+  if (0 != voe_sync_interface_->GetRtpRtcp(voe_channel_id_, &voice_rtp_rtcp,
+                                           &voice_receiver)) {
+    // The voice channel has been deleted. Don't keep pairing with its RTP
+    // module, which a recreated channel may reuse the address of.
+    ForgetVoiceChannel();
+    return;
+  }
+  assert(voice_rtp_rtcp);
+  assert(voice_receiver);
+  if (voice_rtp_rtcp != voice_rtp_rtcp_) {
+    // The voice channel has been recreated since the sync was configured.
+    ForgetVoiceChannel();
+    RegisterVoiceSenderReports(voice_rtp_rtcp);
+  }
+
+  const int current_video_delay_ms = vcm_->Delay();
+
   int audio_jitter_buffer_delay_ms = 0;
   int playout_buffer_delay_ms = 0;
   if (voe_sync_interface_->GetDelayEstimate(voe_channel_id_,
                                             &audio_jitter_buffer_delay_ms,
                                             &playout_buffer_delay_ms) != 0) {
-    return 0;
+    return;
   }
   const int current_audio_delay_ms = audio_jitter_buffer_delay_ms +
       playout_buffer_delay_ms;
 
-  RtpRtcp* voice_rtp_rtcp = NULL;
-  RtpReceiver* voice_receiver = NULL;
-  if (0 != voe_sync_interface_->GetRtpRtcp(voe_channel_id_, &voice_rtp_rtcp,
-                                           &voice_receiver)) {
-    return 0;
-  }
-  assert(voice_rtp_rtcp);
-  assert(voice_receiver);
-
-  if (UpdateMeasurements(&video_measurement_, *video_rtp_rtcp_,
-                         *video_receiver_) != 0) {
-    return 0;
+  if (UpdateMeasurements(&video_measurement_, *video_receiver_) != 0) {
+    return;
   }
+  video_reports_.GetRtcpList(&video_measurement_.rtcp,
+                             &video_reports_revision_);
 
-  if (UpdateMeasurements(&audio_measurement_, *voice_rtp_rtcp,
-                         *voice_receiver) != 0) {
-    return 0;
+  if (UpdateMeasurements(&audio_measurement_, *voice_receiver) != 0) {
+    return;
   }
+  audio_reports_.GetRtcpList(&audio_measurement_.rtcp,
+                             &audio_reports_revision_);
 
   int relative_delay_ms;
   // Calculate how much later or earlier the audio stream is compared to video.
   if (!sync_->ComputeRelativeDelay(audio_measurement_, video_measurement_,
                                    &relative_delay_ms)) {
-    return 0;
+    return;
   }
 
   TRACE_COUNTER1("webrtc", "SyncCurrentVideoDelay", current_video_delay_ms);
@@ -160,15 +239,21 @@ int32_t ViESyncModule::Process() {
                             current_audio_delay_ms,
                             &target_audio_delay_ms,
                             &target_video_delay_ms)) {
-    return 0;
+    return;
   }
 
-  if (voe_sync_interface_->SetMinimumPlayoutDelay(
-      voe_channel_id_, target_audio_delay_ms) == -1) {
-    LOG(LS_ERROR) << "Error setting voice delay.";
+  if (target_audio_delay_ms != last_target_audio_delay_ms_) {
+    if (voe_sync_interface_->SetMinimumPlayoutDelay(
+        voe_channel_id_, target_audio_delay_ms) == -1) {
+      LOG(LS_ERROR) << "Error setting voice delay.";
+    } else {
+      last_target_audio_delay_ms_ = target_audio_delay_ms;
+    }
+  }
+  if (target_video_delay_ms != last_target_video_delay_ms_) {
+    vcm_->SetMinimumPlayoutDelay(target_video_delay_ms);
+    last_target_video_delay_ms_ = target_video_delay_ms;
   }
-  vcm_->SetMinimumPlayoutDelay(target_video_delay_ms);
-  return 0;
 }
 
 int ViESyncModule::SetTargetBufferingDelay(int target_delay_ms) {
@@ -178,6 +263,8 @@ int ViESyncModule::SetTargetBufferingDelay(int target_delay_ms) {
     return -1;
   }
   sync_->SetTargetBufferingDelay(target_delay_ms);
+  last_target_audio_delay_ms_ = -1;
+  last_target_video_delay_ms_ = -1;
   // Setting initial playout delay to voice engine (video engine is updated via
   // the VCM interface).
   voe_sync_interface_->SetInitialPlayoutDelay(voe_channel_id_,
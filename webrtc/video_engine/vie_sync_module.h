@@ -9,14 +9,16 @@
  */
 
 // ViESyncModule is responsible for synchronization audio and video for a given
-// VoE and ViE channel couple.
+// VoE and ViE channel couple. The delays of all couples of a call are updated
+// together by ViESyncService.
 
 #ifndef WEBRTC_VIDEO_ENGINE_VIE_SYNC_MODULE_H_
 #define WEBRTC_VIDEO_ENGINE_VIE_SYNC_MODULE_H_
 
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/scoped_ptr.h"
-#include "webrtc/modules/interface/module.h"
-#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/common_types.h"
 #include "webrtc/video_engine/stream_synchronization.h"
 #include "webrtc/voice_engine/include/voe_video_sync.h"
 
@@ -28,7 +30,7 @@ class VideoCodingModule;
 class ViEChannel;
 class VoEVideoSync;
 
-class ViESyncModule : public Module {
+class ViESyncModule {
  public:
   explicit ViESyncModule(VideoCodingModule* vcm);
   ~ViESyncModule();
@@ -43,21 +45,67 @@ class ViESyncModule : public Module {
   // Set target delay for buffering mode (0 = real-time mode).
   int SetTargetBufferingDelay(int target_delay_ms);
 
-  // Implements Module.
-  int64_t TimeUntilNextProcess() override;
-  int32_t Process() override;
+  // Computes and sets new audio and video playout delays. Called periodically
+  // by ViESyncService.
+  void UpdateDelays();
 
  private:
+  // Keeps the latest RTCP sender reports of a stream, as they are pushed by
+  // the RTP module receiving them. This saves querying the RTP module for the
+  // last report on each update. The reports are cleared when the sender SSRC
+  // changes.
+  class SenderReportCache : public RtcpSenderReportObserver {
+   public:
+    SenderReportCache();
+
+    void OnSenderReport(uint32_t ssrc,
+                        uint32_t ntp_secs,
+                        uint32_t ntp_frac,
+                        uint32_t rtp_timestamp) override;
+
+    // Copies the reports to |rtcp| unless they are unchanged since revision
+    // |*revision| was copied, and updates |*revision|. Pass a revision of -1
+    // to always copy.
+    void GetRtcpList(RtcpList* rtcp, int* revision) const;
+    void Clear();
+
+   private:
+    mutable rtc::CriticalSection crit_;
+    uint32_t ssrc_ GUARDED_BY(crit_);
+    int revision_ GUARDED_BY(crit_);
+    RtcpList rtcp_ GUARDED_BY(crit_);
+  };
+
+  // Moves the audio sender report cache to the RTP module of the current
+  // voice channel, |voice_rtp_rtcp|.
+  void RegisterVoiceSenderReports(RtpRtcp* voice_rtp_rtcp);
+  // Stops the audio sender reports, if the voice channel still exists, and
+  // forgets the voice channel.
+  void DeregisterVoiceSenderReports();
+  // Drops all state of the voice channel without touching its RTP module, so
+  // that a channel recreated later, even at the same address, starts over.
+  void ForgetVoiceChannel();
+
   rtc::scoped_ptr<CriticalSectionWrapper> data_cs_;
   VideoCodingModule* const vcm_;
   RtpReceiver* video_receiver_;
   RtpRtcp* video_rtp_rtcp_;
   int voe_channel_id_;
   VoEVideoSync* voe_sync_interface_;
-  TickTime last_sync_time_;
+  // The voice RTP module |audio_reports_| is registered with, if any.
+  RtpRtcp* voice_rtp_rtcp_;
   rtc::scoped_ptr<StreamSynchronization> sync_;
   StreamSynchronization::Measurements audio_measurement_;
   StreamSynchronization::Measurements video_measurement_;
+  SenderReportCache audio_reports_;
+  SenderReportCache video_reports_;
+  // The last delays set, to only set them again when they change.
+  int last_target_audio_delay_ms_;
+  int last_target_video_delay_ms_;
+  // The revisions of the reports in |audio_measurement_| and
+  // |video_measurement_|.
+  int audio_reports_revision_;
+  int video_reports_revision_;
 };
 
 }  // namespace webrtc
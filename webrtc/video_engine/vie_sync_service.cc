@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/vie_sync_service.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/video_engine/vie_sync_module.h"
+
+namespace webrtc {
+namespace {
+// Time interval for updating the delays.
+const int64_t kSyncIntervalMs = 1000;
+}  // namespace
+
+ViESyncService::ViESyncService()
+    : last_process_time_ms_(TickTime::MillisecondTimestamp()) {}
+
+ViESyncService::~ViESyncService() {
+  RTC_DCHECK(sync_modules_.empty());
+}
+
+int64_t ViESyncService::TimeUntilNextProcess() {
+  rtc::CritScope lock(&crit_);
+  return last_process_time_ms_ + kSyncIntervalMs -
+      TickTime::MillisecondTimestamp();
+}
+
+int32_t ViESyncService::Process() {
+  rtc::CritScope lock(&crit_);
+  last_process_time_ms_ = TickTime::MillisecondTimestamp();
+  for (ViESyncModule* sync_module : sync_modules_)
+    sync_module->UpdateDelays();
+  return 0;
+}
+
+void ViESyncService::AddSyncModule(ViESyncModule* sync_module) {
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(std::find(sync_modules_.begin(), sync_modules_.end(),
+                       sync_module) == sync_modules_.end());
+  sync_modules_.push_back(sync_module);
+}
+
+void ViESyncService::RemoveSyncModule(ViESyncModule* sync_module) {
+  rtc::CritScope lock(&crit_);
+  auto it = std::find(sync_modules_.begin(), sync_modules_.end(), sync_module);
+  RTC_DCHECK(it != sync_modules_.end());
+  if (it != sync_modules_.end())
+    sync_modules_.erase(it);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_ENGINE_VIE_SYNC_SERVICE_H_
+#define WEBRTC_VIDEO_ENGINE_VIE_SYNC_SERVICE_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/interface/module.h"
+
+namespace webrtc {
+
+class ViESyncModule;
+
+// ViESyncService updates the audio and video delays of all synced stream
+// couples of a call in one pass on the process thread, rather than having each
+// couple be a module of its own.
+class ViESyncService : public Module {
+ public:
+  ViESyncService();
+  ~ViESyncService();
+
+  // Implements Module, to use the process thread.
+  int64_t TimeUntilNextProcess() override;
+  int32_t Process() override;
+
+  // Adds/removes a stream couple to update. |sync_module| must be removed
+  // before it is deleted.
+  void AddSyncModule(ViESyncModule* sync_module);
+  void RemoveSyncModule(ViESyncModule* sync_module);
+
+ private:
+  rtc::CriticalSection crit_;
+  int64_t last_process_time_ms_ GUARDED_BY(crit_);
+  std::vector<ViESyncModule*> sync_modules_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ViESyncService);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENGINE_VIE_SYNC_SERVICE_H_
@@ -0,0 +1,484 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/vie_sync_service.h"
+
+#include <map>
+#include <vector>
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/rtp_rtcp/interface/rtp_receiver.h"
+#include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
+#include "webrtc/modules/video_coding/main/interface/mock/mock_video_coding_module.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/rtp_to_ntp.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/null_transport.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/video_engine/stream_synchronization.h"
+#include "webrtc/video_engine/vie_sync_module.h"
+#include "webrtc/voice_engine/include/voe_video_sync.h"
+
+using ::testing::_;
+using ::testing::NiceMock;
+
+namespace webrtc {
+namespace {
+
+const int kAudioFrequencyKhz = 48;
+const int kVideoFrequencyKhz = 90;
+const uint32_t kNtpSecs = 0x12345678;
+
+class FakeRtpReceiver : public RtpReceiver {
+ public:
+  FakeRtpReceiver() : timestamp_(0), receive_time_ms_(-1) {}
+
+  void SetLatestPacket(uint32_t timestamp, int64_t receive_time_ms) {
+    timestamp_ = timestamp;
+    receive_time_ms_ = receive_time_ms;
+  }
+
+  TelephoneEventHandler* GetTelephoneEventHandler() override { return NULL; }
+  int32_t RegisterReceivePayload(const char payload_name[RTP_PAYLOAD_NAME_SIZE],
+                                 const int8_t payload_type,
+                                 const uint32_t frequency,
+                                 const uint8_t channels,
+                                 const uint32_t rate) override {
+    return -1;
+  }
+  int32_t DeRegisterReceivePayload(const int8_t payload_type) override {
+    return -1;
+  }
+  bool IncomingRtpPacket(const RTPHeader& rtp_header,
+                         const uint8_t* payload,
+                         size_t payload_length,
+                         PayloadUnion payload_specific,
+                         bool in_order) override {
+    return false;
+  }
+  NACKMethod NACK() const override { return kNackOff; }
+  void SetNACKStatus(const NACKMethod method) override {}
+  bool Timestamp(uint32_t* timestamp) const override {
+    if (receive_time_ms_ < 0)
+      return false;
+    *timestamp = timestamp_;
+    return true;
+  }
+  bool LastReceivedTimeMs(int64_t* receive_time_ms) const override {
+    if (receive_time_ms_ < 0)
+      return false;
+    *receive_time_ms = receive_time_ms_;
+    return true;
+  }
+  uint32_t SSRC() const override { return 0; }
+  int32_t CSRCs(uint32_t array_of_csrc[kRtpCsrcSize]) const override {
+    return 0;
+  }
+  int32_t Energy(uint8_t array_of_energy[kRtpCsrcSize]) const override {
+    return 0;
+  }
+
+ private:
+  uint32_t timestamp_;
+  int64_t receive_time_ms_;
+};
+
+class FakeVoEVideoSync : public VoEVideoSync {
+ public:
+  void AddChannel(int channel, RtpRtcp* rtp_rtcp, RtpReceiver* receiver) {
+    channels_[channel].rtp_rtcp = rtp_rtcp;
+    channels_[channel].receiver = receiver;
+  }
+  void RemoveChannel(int channel) { channels_.erase(channel); }
+  int minimum_playout_delay_ms(int channel) {
+    return channels_[channel].minimum_playout_delay_ms;
+  }
+
+  int Release() override { return 0; }
+  int GetPlayoutBufferSize(int& buffer_ms) override { return -1; }
+  int SetMinimumPlayoutDelay(int channel, int delay_ms) override {
+    if (channels_.find(channel) == channels_.end())
+      return -1;
+    channels_[channel].minimum_playout_delay_ms = delay_ms;
+    return 0;
+  }
+  int SetInitialPlayoutDelay(int channel, int delay_ms) override { return -1; }
+  int GetDelayEstimate(int channel,
+                       int* jitter_buffer_delay_ms,
+                       int* playout_buffer_delay_ms) override {
+    if (channels_.find(channel) == channels_.end())
+      return -1;
+    *jitter_buffer_delay_ms = 0;
+    *playout_buffer_delay_ms = 0;
+    return 0;
+  }
+  int GetLeastRequiredDelayMs(int channel) const override { return -1; }
+  int SetInitTimestamp(int channel, unsigned int timestamp) override {
+    return -1;
+  }
+  int SetInitSequenceNumber(int channel, short sequenceNumber) override {
+    return -1;
+  }
+  int GetPlayoutTimestamp(int channel, unsigned int& timestamp) override {
+    return -1;
+  }
+  int GetRtpRtcp(int channel,
+                 RtpRtcp** rtpRtcpModule,
+                 RtpReceiver** rtp_receiver) override {
+    std::map<int, Channel>::const_iterator it = channels_.find(channel);
+    if (it == channels_.end())
+      return -1;
+    *rtpRtcpModule = it->second.rtp_rtcp;
+    *rtp_receiver = it->second.receiver;
+    return 0;
+  }
+
+ private:
+  struct Channel {
+    Channel() : rtp_rtcp(NULL), receiver(NULL), minimum_playout_delay_ms(0) {}
+    RtpRtcp* rtp_rtcp;
+    RtpReceiver* receiver;
+    int minimum_playout_delay_ms;
+  };
+  std::map<int, Channel> channels_;
+};
+
+// A receiving audio or video stream, with a real RTP module getting the
+// sender reports.
+class Stream {
+ public:
+  Stream(Clock* clock, uint32_t remote_ssrc, int frequency_khz)
+      : remote_ssrc_(remote_ssrc), frequency_khz_(frequency_khz) {
+    RtpRtcp::Configuration configuration;
+    configuration.clock = clock;
+    configuration.receiver_only = true;
+    configuration.outgoing_transport = &transport_;
+    rtp_rtcp_.reset(RtpRtcp::CreateRtpRtcp(configuration));
+    rtp_rtcp_->SetSSRC(remote_ssrc + 1);
+    rtp_rtcp_->SetRemoteSSRC(remote_ssrc);
+  }
+
+  // Delivers two sender reports one second apart, and a packet captured
+  // |capture_offset_ms| after the last of them.
+  void ReceiveReportsAndPacket(int capture_offset_ms,
+                               int64_t receive_time_ms) {
+    ReceiveReport(0);
+    ReceiveReport(1);
+    ReceivePacket(capture_offset_ms, receive_time_ms);
+  }
+
+  // Delivers sender report number |index|, sent |index| seconds after the
+  // first.
+  void ReceiveReport(uint32_t index) {
+    rtcp::SenderReport sr;
+    sr.From(remote_ssrc_);
+    sr.WithNtpSec(kNtpSecs + index);
+    sr.WithNtpFrac(0);
+    sr.WithRtpTimestamp(kRtpStart + index * 1000 * frequency_khz_);
+    rtc::scoped_ptr<rtcp::RawPacket> packet(sr.Build());
+    EXPECT_EQ(0, rtp_rtcp_->IncomingRtcpPacket(packet->Buffer(),
+                                               packet->Length()));
+  }
+
+  // Receives a packet captured |capture_offset_ms| after the second sender
+  // report.
+  void ReceivePacket(int capture_offset_ms, int64_t receive_time_ms) {
+    receiver_.SetLatestPacket(
+        kRtpStart + (1000 + capture_offset_ms) * frequency_khz_,
+        receive_time_ms);
+  }
+
+  RtpRtcp* rtp_rtcp() { return rtp_rtcp_.get(); }
+  FakeRtpReceiver* receiver() { return &receiver_; }
+
+ private:
+  static const uint32_t kRtpStart = 1000;
+
+  const uint32_t remote_ssrc_;
+  const int frequency_khz_;
+  test::NullTransport transport_;
+  rtc::scoped_ptr<RtpRtcp> rtp_rtcp_;
+  FakeRtpReceiver receiver_;
+};
+
+// An audio and a video stream to keep in sync.
+class StreamCouple {
+ public:
+  StreamCouple(Clock* clock, int voe_channel, FakeVoEVideoSync* voe_sync)
+      : voe_channel_(voe_channel),
+        audio_(clock, 2 * voe_channel + 100, kAudioFrequencyKhz),
+        video_(clock, 2 * voe_channel + 10000, kVideoFrequencyKhz),
+        sync_module_(&vcm_) {
+    voe_sync->AddChannel(voe_channel, audio_.rtp_rtcp(), audio_.receiver());
+    EXPECT_EQ(0, sync_module_.ConfigureSync(voe_channel, voe_sync,
+                                            video_.rtp_rtcp(),
+                                            video_.receiver()));
+  }
+
+  // Makes the video arrive |video_delay_ms| later than the audio captured at
+  // the same time.
+  void ReceiveMedia(int64_t now_ms, int video_delay_ms) {
+    audio_.ReceiveReportsAndPacket(100, now_ms);
+    video_.ReceiveReportsAndPacket(100, now_ms + video_delay_ms);
+  }
+
+  // Adds the voice channel back to |voe_sync| after it was removed, as if it
+  // were recreated with a new RTP module at the same address.
+  void RecreateVoiceChannel(FakeVoEVideoSync* voe_sync) {
+    audio_.rtp_rtcp()->RegisterRtcpSenderReportObserver(NULL);
+    voe_sync->AddChannel(voe_channel_, audio_.rtp_rtcp(), audio_.receiver());
+  }
+
+  int voe_channel() const { return voe_channel_; }
+  Stream* audio() { return &audio_; }
+  Stream* video() { return &video_; }
+  NiceMock<MockVideoCodingModule>* vcm() { return &vcm_; }
+  ViESyncModule* sync_module() { return &sync_module_; }
+
+ private:
+  const int voe_channel_;
+  Stream audio_;
+  Stream video_;
+  NiceMock<MockVideoCodingModule> vcm_;
+  ViESyncModule sync_module_;
+};
+
+// The update of a couple as each ViESyncModule did it when it was a module of
+// the process thread of its own, for comparison: the last sender reports are
+// queried from both RTP modules and the delays are always set.
+class PerModuleSync {
+ public:
+  PerModuleSync(StreamCouple* couple, FakeVoEVideoSync* voe_sync)
+      : couple_(couple),
+        voe_sync_(voe_sync),
+        sync_(couple->video()->rtp_rtcp()->SSRC(), couple->voe_channel()),
+        last_sync_time_(TickTime::Now()) {}
+
+  int64_t TimeUntilNextProcess() {
+    return 1000 - (TickTime::Now() - last_sync_time_).Milliseconds();
+  }
+
+  // Returns -1 if the delays could not be computed.
+  int32_t Process() {
+    last_sync_time_ = TickTime::Now();
+    const int channel = couple_->voe_channel();
+    const int current_video_delay_ms = couple_->vcm()->Delay();
+    int jitter_buffer_delay_ms = 0;
+    int playout_buffer_delay_ms = 0;
+    if (voe_sync_->GetDelayEstimate(channel, &jitter_buffer_delay_ms,
+                                    &playout_buffer_delay_ms) != 0) {
+      return -1;
+    }
+    RtpRtcp* voice_rtp_rtcp = NULL;
+    RtpReceiver* voice_receiver = NULL;
+    if (voe_sync_->GetRtpRtcp(channel, &voice_rtp_rtcp, &voice_receiver) != 0)
+      return -1;
+    if (!UpdateMeasurements(&video_measurement_, *couple_->video()->rtp_rtcp(),
+                            *couple_->video()->receiver()) ||
+        !UpdateMeasurements(&audio_measurement_, *voice_rtp_rtcp,
+                            *voice_receiver)) {
+      return -1;
+    }
+    int relative_delay_ms;
+    if (!sync_.ComputeRelativeDelay(audio_measurement_, video_measurement_,
+                                    &relative_delay_ms)) {
+      return -1;
+    }
+    int target_audio_delay_ms = 0;
+    int target_video_delay_ms = current_video_delay_ms;
+    if (!sync_.ComputeDelays(relative_delay_ms,
+                             jitter_buffer_delay_ms + playout_buffer_delay_ms,
+                             &target_audio_delay_ms, &target_video_delay_ms)) {
+      return -1;
+    }
+    voe_sync_->SetMinimumPlayoutDelay(channel, target_audio_delay_ms);
+    couple_->vcm()->SetMinimumPlayoutDelay(target_video_delay_ms);
+    return 0;
+  }
+
+ private:
+  static bool UpdateMeasurements(StreamSynchronization::Measurements* stream,
+                                 const RtpRtcp& rtp_rtcp,
+                                 const RtpReceiver& receiver) {
+    if (!receiver.Timestamp(&stream->latest_timestamp) ||
+        !receiver.LastReceivedTimeMs(&stream->latest_receive_time_ms)) {
+      return false;
+    }
+    uint32_t ntp_secs = 0;
+    uint32_t ntp_frac = 0;
+    uint32_t rtp_timestamp = 0;
+    if (rtp_rtcp.RemoteNTP(&ntp_secs, &ntp_frac, NULL, NULL,
+                           &rtp_timestamp) != 0) {
+      return false;
+    }
+    bool new_rtcp_sr = false;
+    return UpdateRtcpList(ntp_secs, ntp_frac, rtp_timestamp, &stream->rtcp,
+                          &new_rtcp_sr);
+  }
+
+  StreamCouple* const couple_;
+  FakeVoEVideoSync* const voe_sync_;
+  StreamSynchronization sync_;
+  StreamSynchronization::Measurements audio_measurement_;
+  StreamSynchronization::Measurements video_measurement_;
+  TickTime last_sync_time_;
+};
+
+}  // namespace
+
+class ViESyncServiceTest : public ::testing::Test {
+ protected:
+  ViESyncServiceTest() : clock_(1234567) {}
+
+  void CreateCouples(int num_couples) {
+    for (int i = 0; i < num_couples; ++i) {
+      couples_.push_back(new StreamCouple(&clock_, i, &voe_sync_));
+      sync_service_.AddSyncModule(couples_.back()->sync_module());
+    }
+  }
+
+  void TearDown() override {
+    for (StreamCouple* couple : couples_) {
+      sync_service_.RemoveSyncModule(couple->sync_module());
+      delete couple;
+    }
+  }
+
+  SimulatedClock clock_;
+  FakeVoEVideoSync voe_sync_;
+  ViESyncService sync_service_;
+  std::vector<StreamCouple*> couples_;
+};
+
+TEST_F(ViESyncServiceTest, UpdatesAllCouplesInOnePass) {
+  CreateCouples(3);
+  for (StreamCouple* couple : couples_)
+    couple->ReceiveMedia(clock_.TimeInMilliseconds(), 200);
+
+  EXPECT_EQ(0, sync_service_.Process());
+  // The video is late, so audio should be delayed.
+  for (StreamCouple* couple : couples_)
+    EXPECT_GT(voe_sync_.minimum_playout_delay_ms(couple->voe_channel()), 0);
+}
+
+TEST_F(ViESyncServiceTest, NoSyncWithoutSenderReports) {
+  CreateCouples(1);
+  couples_[0]->ReceiveMedia(clock_.TimeInMilliseconds(), 200);
+  // A couple created after the reports were received has no reports cached.
+  StreamCouple* late_couple = new StreamCouple(&clock_, 1, &voe_sync_);
+  couples_.push_back(late_couple);
+  sync_service_.AddSyncModule(late_couple->sync_module());
+
+  EXPECT_CALL(*late_couple->vcm(), SetMinimumPlayoutDelay(_)).Times(0);
+  EXPECT_EQ(0, sync_service_.Process());
+  EXPECT_GT(voe_sync_.minimum_playout_delay_ms(0), 0);
+  EXPECT_EQ(0, voe_sync_.minimum_playout_delay_ms(1));
+}
+
+TEST_F(ViESyncServiceTest, RemovedCoupleIsNotUpdated) {
+  CreateCouples(2);
+  for (StreamCouple* couple : couples_)
+    couple->ReceiveMedia(clock_.TimeInMilliseconds(), 200);
+
+  sync_service_.RemoveSyncModule(couples_[1]->sync_module());
+  EXPECT_CALL(*couples_[1]->vcm(), SetMinimumPlayoutDelay(_)).Times(0);
+  EXPECT_EQ(0, sync_service_.Process());
+  EXPECT_GT(voe_sync_.minimum_playout_delay_ms(0), 0);
+  EXPECT_EQ(0, voe_sync_.minimum_playout_delay_ms(1));
+  sync_service_.AddSyncModule(couples_[1]->sync_module());
+}
+
+TEST_F(ViESyncServiceTest, HandlesDeletedVoiceChannel) {
+  CreateCouples(1);
+  couples_[0]->ReceiveMedia(clock_.TimeInMilliseconds(), 200);
+  voe_sync_.RemoveChannel(0);
+
+  EXPECT_CALL(*couples_[0]->vcm(), SetMinimumPlayoutDelay(_)).Times(0);
+  EXPECT_EQ(0, sync_service_.Process());
+}
+
+TEST_F(ViESyncServiceTest, RecreatedVoiceChannelIsPairedAgain) {
+  CreateCouples(1);
+  couples_[0]->ReceiveMedia(clock_.TimeInMilliseconds(), 200);
+  EXPECT_EQ(0, sync_service_.Process());
+  EXPECT_GT(voe_sync_.minimum_playout_delay_ms(0), 0);
+
+  voe_sync_.RemoveChannel(0);
+  EXPECT_EQ(0, sync_service_.Process());
+  couples_[0]->RecreateVoiceChannel(&voe_sync_);
+  // The sender reports of the deleted channel are not used for the new one,
+  // even as the video gets later.
+  couples_[0]->video()->ReceivePacket(100, clock_.TimeInMilliseconds() + 600);
+  EXPECT_EQ(0, sync_service_.Process());
+  EXPECT_EQ(0, voe_sync_.minimum_playout_delay_ms(0));
+  // The sender reports of the new channel are used, and the audio delay is
+  // set on it.
+  couples_[0]->ReceiveMedia(clock_.TimeInMilliseconds(), 200);
+  EXPECT_EQ(0, sync_service_.Process());
+  EXPECT_GT(voe_sync_.minimum_playout_delay_ms(0), 0);
+}
+
+// Prints the time of one update of 500 couples by ViESyncService, and by the
+// couples each being a module of the process thread as before.
+TEST_F(ViESyncServiceTest, DISABLED_ProcessFiveHundredCouples) {
+  const int kNumCouples = 500;
+  const int kNumPasses = 200;
+  CreateCouples(kNumCouples);
+  std::vector<PerModuleSync*> per_module_syncs;
+  for (StreamCouple* couple : couples_)
+    per_module_syncs.push_back(new PerModuleSync(couple, &voe_sync_));
+  // The RTP modules only keep the last sender report, so the per module
+  // updates need to run between the reports to collect the two they need.
+  for (StreamCouple* couple : couples_) {
+    couple->audio()->ReceivePacket(100, clock_.TimeInMilliseconds());
+    couple->video()->ReceivePacket(100, clock_.TimeInMilliseconds() + 200);
+  }
+  for (uint32_t report = 0; report < 2; ++report) {
+    for (StreamCouple* couple : couples_) {
+      couple->audio()->ReceiveReport(report);
+      couple->video()->ReceiveReport(report);
+    }
+    for (PerModuleSync* sync : per_module_syncs)
+      EXPECT_EQ(report == 0 ? -1 : 0, sync->Process());
+  }
+
+  uint64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPasses; ++i)
+    EXPECT_EQ(0, sync_service_.Process());
+  const uint64_t service_time_us = (rtc::TimeMicros() - start_us) / kNumPasses;
+  for (StreamCouple* couple : couples_)
+    EXPECT_GT(voe_sync_.minimum_playout_delay_ms(couple->voe_channel()), 0);
+
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPasses; ++i) {
+    // The process thread asks each module for its next process time after
+    // processing it.
+    for (PerModuleSync* sync : per_module_syncs) {
+      EXPECT_EQ(0, sync->Process());
+      sync->TimeUntilNextProcess();
+    }
+  }
+  const uint64_t per_module_time_us =
+      (rtc::TimeMicros() - start_us) / kNumPasses;
+
+  for (PerModuleSync* sync : per_module_syncs)
+    delete sync;
+  webrtc::test::PrintResult("vie_sync_pass_time", "_service", "500_couples",
+                            static_cast<size_t>(service_time_us), "us", false);
+  webrtc::test::PrintResult("vie_sync_pass_time", "_per_module", "500_couples",
+                            static_cast<size_t>(per_module_time_us), "us",
+                            false);
+}
+
+}  // namespace webrtc
@@ -68,6 +68,9 @@ class VideoReceiveStream : public ReceiveStream {
     int jitter_buffer_ms = 0;
     int min_playout_delay_ms = 0;
     int render_delay_ms = 10;
+    // Time frames spend in each stage of the receive pipeline, see
+    // VideoFrameStage.
+    std::map<VideoFrameStage, FrameStageLatency> frame_stage_latencies;
 
     int current_payload_type = -1;
 
@@ -70,6 +70,9 @@ class VideoSendStream : public SendStream {
     int media_bitrate_bps = 0;
     bool suspended = false;
     std::map<uint32_t, StreamStats> substreams;
+    // Time frames spend in each stage of the send pipeline, see
+    // VideoFrameStage.
+    std::map<VideoFrameStage, FrameStageLatency> frame_stage_latencies;
   };
 
   struct Config {
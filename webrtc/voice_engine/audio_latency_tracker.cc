@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/voice_engine/audio_latency_tracker.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/trace_event.h"
+
+namespace webrtc {
+namespace voe {
+
+namespace {
+
+// Counter names need to be string literals, since the trace keeps the
+// pointers.
+const char* const kTraceCounterNames[] = {
+    "AudioDeviceBuffersUs",     "AudioCaptureProcessingUs",
+    "AudioEncoderBufferUs",     "AudioSendUs",
+    "AudioJitterBufferUs",      "AudioDecodeUs",
+    "AudioPlayoutProcessingUs"};
+static_assert(sizeof(kTraceCounterNames) / sizeof(kTraceCounterNames[0]) ==
+                  kAudioStageCount,
+              "A counter name is needed for each stage.");
+
+}  // namespace
+
+AudioLatencyTracker::AudioLatencyTracker(int id) : id_(id) {}
+
+void AudioLatencyTracker::AddBlock(AudioPipelineStage stage,
+                                   int64_t delay_us) {
+  RTC_DCHECK_GE(stage, 0);
+  RTC_DCHECK_LT(stage, kAudioStageCount);
+  delay_us = std::max<int64_t>(delay_us, 0);
+
+  int64_t interval_average_us = -1;
+  {
+    rtc::CritScope lock(&crit_);
+    StageCounters& counters = stages_[stage];
+    ++counters.num_blocks;
+    counters.total_us += delay_us;
+    counters.max_us = std::max(counters.max_us, delay_us);
+    counters.interval_total_us += delay_us;
+    if (counters.num_blocks % kTraceIntervalBlocks == 0) {
+      interval_average_us = counters.interval_total_us / kTraceIntervalBlocks;
+      counters.interval_total_us = 0;
+    }
+  }
+  if (interval_average_us != -1) {
+    TRACE_COUNTER_ID1(TRACE_DISABLED_BY_DEFAULT("webrtc_audio_latency"),
+                      kTraceCounterNames[stage], id_, interval_average_us);
+  }
+}
+
+void AudioLatencyTracker::GetStatistics(AudioPipelineStatistics* stats) const {
+  rtc::CritScope lock(&crit_);
+  for (int i = 0; i < kAudioStageCount; ++i) {
+    const StageCounters& counters = stages_[i];
+    if (counters.num_blocks == 0)
+      continue;
+    AudioStageDelay& delay = stats->stages[i];
+    delay.num_blocks = counters.num_blocks;
+    delay.average_us = static_cast<int>(
+        (counters.total_us + counters.num_blocks / 2) / counters.num_blocks);
+    delay.max_us = static_cast<int>(counters.max_us);
+  }
+}
+
+}  // namespace voe
+}  // namespace webrtc
@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VOICE_ENGINE_AUDIO_LATENCY_TRACKER_H_
+#define WEBRTC_VOICE_ENGINE_AUDIO_LATENCY_TRACKER_H_
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/common_types.h"
+
+namespace webrtc {
+
+namespace voe {
+
+// Accumulates the time 10 ms blocks of audio spend in the stages of the audio
+// pipeline. Every |kTraceIntervalBlocks| blocks of a stage, the average over
+// those blocks is also written to the trace as a counter, so that the delays
+// can be followed over time. Thread safe.
+class AudioLatencyTracker {
+ public:
+  static const int kTraceIntervalBlocks = 100;
+
+  // |id| tells apart the counters of different trackers in the trace.
+  explicit AudioLatencyTracker(int id);
+  ~AudioLatencyTracker() {}
+
+  // Adds the time one block spent in |stage|. Negative times are counted as 0.
+  void AddBlock(AudioPipelineStage stage, int64_t delay_us);
+
+  // Fills in the stages of |stats| this tracker has measured blocks for, since
+  // it was created. Other stages are left untouched, so that the statistics
+  // of trackers covering different stages can be combined.
+  void GetStatistics(AudioPipelineStatistics* stats) const;
+
+ private:
+  struct StageCounters {
+    StageCounters()
+        : num_blocks(0), total_us(0), max_us(0), interval_total_us(0) {}
+    int num_blocks;
+    int64_t total_us;
+    int64_t max_us;
+    int64_t interval_total_us;
+  };
+
+  const int id_;
+  mutable rtc::CriticalSection crit_;
+  StageCounters stages_[kAudioStageCount] GUARDED_BY(crit_);
+};
+
+}  // namespace voe
+}  // namespace webrtc
+
+#endif  // WEBRTC_VOICE_ENGINE_AUDIO_LATENCY_TRACKER_H_
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/voice_engine/audio_latency_tracker.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace webrtc {
+namespace voe {
+
+TEST(AudioLatencyTrackerTest, NoStatisticsWithoutBlocks) {
+  AudioLatencyTracker tracker(0);
+  AudioPipelineStatistics stats;
+  tracker.GetStatistics(&stats);
+  for (int i = 0; i < kAudioStageCount; ++i) {
+    EXPECT_EQ(0, stats.stages[i].num_blocks);
+    EXPECT_EQ(0, stats.stages[i].average_us);
+    EXPECT_EQ(0, stats.stages[i].max_us);
+  }
+}
+
+TEST(AudioLatencyTrackerTest, ComputesAverageAndMax) {
+  AudioLatencyTracker tracker(0);
+  tracker.AddBlock(kAudioStageDecode, 100);
+  tracker.AddBlock(kAudioStageDecode, 301);
+  tracker.AddBlock(kAudioStageDecode, 200);
+  AudioPipelineStatistics stats;
+  tracker.GetStatistics(&stats);
+  EXPECT_EQ(3, stats.stages[kAudioStageDecode].num_blocks);
+  EXPECT_EQ(200, stats.stages[kAudioStageDecode].average_us);
+  EXPECT_EQ(301, stats.stages[kAudioStageDecode].max_us);
+  EXPECT_EQ(0, stats.stages[kAudioStageSend].num_blocks);
+}
+
+TEST(AudioLatencyTrackerTest, CountsNegativeDelaysAsZero) {
+  AudioLatencyTracker tracker(0);
+  tracker.AddBlock(kAudioStageSend, -500);
+  tracker.AddBlock(kAudioStageSend, 40);
+  AudioPipelineStatistics stats;
+  tracker.GetStatistics(&stats);
+  EXPECT_EQ(2, stats.stages[kAudioStageSend].num_blocks);
+  EXPECT_EQ(20, stats.stages[kAudioStageSend].average_us);
+  EXPECT_EQ(40, stats.stages[kAudioStageSend].max_us);
+}
+
+TEST(AudioLatencyTrackerTest, CombinesStatisticsOfTrackers) {
+  AudioLatencyTracker shared_tracker(-1);
+  AudioLatencyTracker channel_tracker(1);
+  shared_tracker.AddBlock(kAudioStageDeviceBuffers, 40000);
+  channel_tracker.AddBlock(kAudioStageJitterBuffer, 60000);
+
+  AudioPipelineStatistics stats;
+  shared_tracker.GetStatistics(&stats);
+  channel_tracker.GetStatistics(&stats);
+  EXPECT_EQ(40000, stats.stages[kAudioStageDeviceBuffers].average_us);
+  EXPECT_EQ(60000, stats.stages[kAudioStageJitterBuffer].average_us);
+  EXPECT_EQ(0, stats.stages[kAudioStageDecode].num_blocks);
+}
+
+TEST(AudioLatencyTrackerTest, KeepsCountingAcrossTraceIntervals) {
+  AudioLatencyTracker tracker(0);
+  const int kNumBlocks = 2 * AudioLatencyTracker::kTraceIntervalBlocks + 1;
+  for (int i = 0; i < kNumBlocks; ++i)
+    tracker.AddBlock(kAudioStageEncoderBuffer, 10000);
+  AudioPipelineStatistics stats;
+  tracker.GetStatistics(&stats);
+  EXPECT_EQ(kNumBlocks, stats.stages[kAudioStageEncoderBuffer].num_blocks);
+  EXPECT_EQ(10000, stats.stages[kAudioStageEncoderBuffer].average_us);
+}
+
+}  // namespace voe
+}  // namespace webrtc
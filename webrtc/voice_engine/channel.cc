@@ -44,6 +44,16 @@
 namespace webrtc {
 namespace voe {
 
+namespace {
+
+// Longest audio packet that can be encoded, in 10 ms blocks.
+const size_t kMaxEncoderBufferBlocks = 12;
+// Blocks arriving further apart than this mean that the stream of audio to
+// the encoder has been interrupted.
+const uint64_t kMaxBlockIntervalUs = 100000;
+
+}  // namespace
+
 // Extend the default RTCP statistics struct with max_jitter, defined as the
 // maximum jitter value seen in an RTCP report block.
 struct ChannelStatistics : public RtcpStatistics {
@@ -168,6 +178,7 @@ Channel::SendData(FrameType frameType,
     // Push data from ACM to RTP/RTCP-module to deliver audio frame for
     // packetization.
     // This call will trigger Transport::SendPacket() from the RTP/RTCP module.
+    const uint64_t send_start_us = rtc::TimeMicros();
     if (_rtpRtcpModule->SendOutgoingData((FrameType&)frameType,
                                         payloadType,
                                         timeStamp,
@@ -182,9 +193,19 @@ Channel::SendData(FrameType frameType,
         _engineStatisticsPtr->SetLastError(
             VE_RTP_RTCP_MODULE_ERROR, kTraceWarning,
             "Channel::SendData() failed to send data to RTP/RTCP module");
+        encoder_block_times_us_.clear();
         return -1;
     }
 
+    // The packet holds the blocks added to the encoder since the last one.
+    const uint64_t send_time_us = rtc::TimeMicros() - send_start_us;
+    for (uint64_t block_time_us : encoder_block_times_us_) {
+        latency_tracker_.AddBlock(kAudioStageEncoderBuffer,
+                                  send_start_us - block_time_us);
+        latency_tracker_.AddBlock(kAudioStageSend, send_time_us);
+    }
+    encoder_block_times_us_.clear();
+
     _lastLocalTimeStamp = timeStamp;
     _lastPayloadType = payloadType;
 
@@ -427,6 +448,7 @@ int32_t Channel::GetAudioFrame(int32_t id, AudioFrame* audioFrame)
       event_log_->LogAudioPlayout(ssrc);
     }
     // Get 10ms raw PCM data from the ACM (mixer limits output frequency)
+    const uint64_t decode_start_us = rtc::TimeMicros();
     if (audio_coding_->PlayoutData10Ms(audioFrame->sample_rate_hz_,
                                        audioFrame) == -1)
     {
@@ -439,6 +461,11 @@ int32_t Channel::GetAudioFrame(int32_t id, AudioFrame* audioFrame)
         // irrelevant.
         return -1;
     }
+    latency_tracker_.AddBlock(kAudioStageDecode,
+                              rtc::TimeMicros() - decode_start_us);
+    latency_tracker_.AddBlock(
+        kAudioStageJitterBuffer,
+        static_cast<int64_t>(audio_coding_->CurrentDelayMs()) * 1000);
 
     if (_RxVadDetection)
     {
@@ -772,7 +799,8 @@ Channel::Channel(int32_t channelId,
     rtcp_observer_(new VoERtcpObserver(this)),
     network_predictor_(new NetworkPredictor(Clock::GetRealTimeClock())),
     assoc_send_channel_lock_(CriticalSectionWrapper::CreateCriticalSection()),
-    associate_send_channel_(ChannelOwner(nullptr)) {
+    associate_send_channel_(ChannelOwner(nullptr)),
+    latency_tracker_(channelId) {
     WEBRTC_TRACE(kTraceMemory, kTraceVoice, VoEId(_instanceId,_channelId),
                  "Channel::Channel() - ctor");
     AudioCodingModule::Config acm_config;
@@ -943,8 +971,15 @@ Channel::Init()
 
     for (int idx = 0; idx < nSupportedCodecs; idx++)
     {
+        const bool codec_found = (audio_coding_->Codec(idx, &codec) == 0);
+        // Playout is mono or stereo, so multistream codecs are left out.
+        if (codec_found && (codec.channels > 2))
+        {
+            continue;
+        }
+
         // Open up the RTP/RTCP receiver for all supported codecs
-        if ((audio_coding_->Codec(idx, &codec) == -1) ||
+        if (!codec_found ||
             (rtp_receiver_->RegisterReceivePayload(
                 codec.plname,
                 codec.pltype,
@@ -1356,6 +1391,13 @@ Channel::SetRecPayloadType(const CodecInst& codec)
             "SetRecPayloadType() unable to set PT while listening");
         return -1;
     }
+    if (codec.channels > 2)
+    {
+        _engineStatisticsPtr->SetLastError(
+            VE_INVALID_CHANNELS, kTraceError,
+            "SetRecPayloadType() playout supports mono and stereo only");
+        return -1;
+    }
 
     if (codec.pltype == -1)
     {
@@ -3270,6 +3312,16 @@ Channel::EncodeAndSend()
 
     // The ACM resamples internally.
     _audioFrame.timestamp_ = _timeStamp;
+    const uint64_t now_us = rtc::TimeMicros();
+    if (!encoder_block_times_us_.empty() &&
+        (encoder_block_times_us_.size() >= kMaxEncoderBufferBlocks ||
+         now_us - encoder_block_times_us_.back() > kMaxBlockIntervalUs))
+    {
+        // Either nothing has been sent for a while, e.g. during DTX, or
+        // sending was paused. In both cases the buffered blocks won't be sent.
+        encoder_block_times_us_.clear();
+    }
+    encoder_block_times_us_.push_back(now_us);
     // This call will trigger AudioPacketizationCallback::SendData if encoding
     // is done and payload is ready for packetization and transmission.
     // Otherwise, it will return without invoking the callback.
@@ -3277,6 +3329,7 @@ Channel::EncodeAndSend()
     {
         WEBRTC_TRACE(kTraceError, kTraceVoice, VoEId(_instanceId,_channelId),
                      "Channel::EncodeAndSend() ACM encoding failed");
+        encoder_block_times_us_.clear();
         return 0xFFFFFFFF;
     }
 
@@ -3398,6 +3451,11 @@ void Channel::GetDecodingCallStatistics(AudioDecodingCallStats* stats) const {
   audio_coding_->GetDecodingCallStatistics(stats);
 }
 
+void Channel::GetAudioPipelineStatistics(
+    AudioPipelineStatistics* stats) const {
+  latency_tracker_.GetStatistics(stats);
+}
+
 bool Channel::GetDelayEstimate(int* jitter_buffer_delay_ms,
                                int* playout_buffer_delay_ms) const {
   CriticalSectionScoped cs(video_sync_lock_.get());
@@ -3808,8 +3866,15 @@ Channel::RegisterReceiveCodecsToRTPModule()
 
     for (int idx = 0; idx < nSupportedCodecs; idx++)
     {
+        const bool codec_found = (audio_coding_->Codec(idx, &codec) == 0);
+        // Playout is mono or stereo, so multistream codecs are left out.
+        if (codec_found && (codec.channels > 2))
+        {
+            continue;
+        }
+
         // Open up the RTP/RTCP receiver for all supported codecs
-        if ((audio_coding_->Codec(idx, &codec) == -1) ||
+        if (!codec_found ||
             (rtp_receiver_->RegisterReceivePayload(
                 codec.plname,
                 codec.pltype,
@@ -39,6 +39,15 @@ class WEBRTC_DLLEXPORT VoENetEqStats {
       int channel,
       AudioDecodingCallStats* stats) const = 0;
 
+  // Get the time 10 ms blocks of audio spend in each stage of the pipeline,
+  // from the audio device through the send and receive sides of |channel|
+  // and back to the device. Stages the channel does not use, e.g. the send
+  // side stages of a channel that is not sending, have no blocks.
+  // Unlike the network statistics, these are not reset after the query.
+  virtual int GetAudioPipelineStatistics(
+      int channel,
+      AudioPipelineStatistics* stats) const = 0;
+
  protected:
   VoENetEqStats() {}
   virtual ~VoENetEqStats() {}
@@ -15,6 +15,7 @@
 #include "webrtc/modules/audio_device/include/audio_device.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/modules/utility/interface/process_thread.h"
+#include "webrtc/voice_engine/audio_latency_tracker.h"
 #include "webrtc/voice_engine/channel_manager.h"
 #include "webrtc/voice_engine/statistics.h"
 #include "webrtc/voice_engine/voice_engine_defines.h"
@@ -45,6 +46,8 @@ public:
     OutputMixer* output_mixer() { return _outputMixerPtr; }
     CriticalSectionWrapper* crit_sec() { return _apiCritPtr; }
     ProcessThread* process_thread() { return _moduleProcessThreadPtr.get(); }
+    // Delays of the pipeline stages shared by all channels.
+    AudioLatencyTracker& latency_tracker() { return _latencyTracker; }
     AudioDeviceModule::AudioLayer audio_device_layer() const {
       return _audioDeviceLayer;
     }
@@ -73,6 +76,7 @@ protected:
     rtc::scoped_ptr<ProcessThread> _moduleProcessThreadPtr;
 
     AudioDeviceModule::AudioLayer _audioDeviceLayer;
+    AudioLatencyTracker _latencyTracker;
 
     SharedData(const Config& config);
     virtual ~SharedData();
@@ -57,3 +57,33 @@ TEST_F(NetEQStatsTest, ManualPrintStatisticsAfterRunningAWhile) {
   // This is only set to a non-zero value in off-mode.
   EXPECT_EQ(0U, network_statistics.addedSamples);
 }
+
+TEST_F(NetEQStatsTest, ManualPrintAudioPipelineDelaysAfterRunningAWhile) {
+  Sleep(5000);
+
+  webrtc::AudioPipelineStatistics stats;
+  EXPECT_EQ(0, voe_neteq_stats_->GetAudioPipelineStatistics(channel_,
+                                                            &stats));
+
+  // The channel loops back to itself, so both the send and the receive side
+  // stages should have seen blocks.
+  EXPECT_GT(stats.stages[webrtc::kAudioStageEncoderBuffer].num_blocks, 0);
+  EXPECT_GT(stats.stages[webrtc::kAudioStageJitterBuffer].num_blocks, 0);
+  EXPECT_GT(stats.stages[webrtc::kAudioStageDecode].num_blocks, 0);
+
+  const char* const kStageNames[] = {
+      "device buffers    ", "capture processing", "encoder buffer    ",
+      "send              ", "jitter buffer     ", "decode            ",
+      "playout processing"};
+
+  TEST_LOG("Inspect these delays and ensure they make sense.\n");
+  int total_us = 0;
+  for (int i = 0; i < webrtc::kAudioStageCount; ++i) {
+    TEST_LOG("    %s: blocks = %6d, average = %7.3f ms, max = %7.3f ms\n",
+             kStageNames[i], stats.stages[i].num_blocks,
+             stats.stages[i].average_us / 1000.0,
+             stats.stages[i].max_us / 1000.0);
+    total_us += stats.stages[i].average_us;
+  }
+  TEST_LOG("    Estimated end-to-end delay: %.3f ms\n", total_us / 1000.0);
+}
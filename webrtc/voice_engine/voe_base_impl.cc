@@ -11,6 +11,7 @@
 #include "webrtc/voice_engine/voe_base_impl.h"
 
 #include "webrtc/base/format_macros.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/modules/audio_coding/main/interface/audio_coding_module.h"
@@ -773,12 +774,19 @@ int VoEBaseImpl::ProcessRecordedDataWithAPM(
     }
   }
 
+  shared_->latency_tracker().AddBlock(
+      kAudioStageDeviceBuffers,
+      static_cast<int64_t>(audio_delay_milliseconds) * 1000);
+
   // Perform channel-independent operations
   // (APM, mix with file, record to file, mute, etc.)
+  const uint64_t processing_start_us = rtc::TimeMicros();
   shared_->transmit_mixer()->PrepareDemux(
       audio_data, number_of_frames, number_of_channels, sample_rate,
       static_cast<uint16_t>(audio_delay_milliseconds), clock_drift,
       voe_mic_level, key_pressed);
+  shared_->latency_tracker().AddBlock(
+      kAudioStageCaptureProcessing, rtc::TimeMicros() - processing_start_us);
 
   // Copy the audio frame to each sending channel and perform
   // channel-dependent operations (file mixing, mute, etc.), encode and
@@ -820,11 +828,14 @@ void VoEBaseImpl::GetPlayoutData(int sample_rate, int number_of_channels,
   shared_->output_mixer()->MixActiveChannels();
 
   // Additional operations on the combined signal
+  const uint64_t processing_start_us = rtc::TimeMicros();
   shared_->output_mixer()->DoOperationsOnCombinedSignal(feed_data_to_apm);
 
   // Retrieve the final output mix (resampled to match the ADM)
   shared_->output_mixer()->GetMixedAudio(sample_rate, number_of_channels,
                                          &audioFrame_);
+  shared_->latency_tracker().AddBlock(
+      kAudioStagePlayoutProcessing, rtc::TimeMicros() - processing_start_us);
 
   assert(number_of_frames == audioFrame_.samples_per_channel_);
   assert(sample_rate == audioFrame_.sample_rate_hz_);
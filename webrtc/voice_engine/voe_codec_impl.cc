@@ -44,15 +44,36 @@ VoECodecImpl::~VoECodecImpl() {
                "~VoECodecImpl() - dtor");
 }
 
+namespace {
+
+// Gets the codec at |index| among the ACM codecs that can be played out.
+// Playout is mono or stereo, so the multistream codecs are not listed.
+bool GetPlayableCodec(int index, CodecInst* codec) {
+  int playable_index = -1;
+  for (int i = 0; i < AudioCodingModule::NumberOfCodecs(); ++i) {
+    if (AudioCodingModule::Codec(i, codec) == 0 && codec->channels <= 2 &&
+        ++playable_index == index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 int VoECodecImpl::NumOfCodecs() {
-  // Number of supported codecs in the ACM
-  uint8_t nSupportedCodecs = AudioCodingModule::NumberOfCodecs();
-  return (nSupportedCodecs);
+  // Number of supported codecs in the ACM that can be played out.
+  CodecInst acmCodec;
+  int nSupportedCodecs = 0;
+  while (GetPlayableCodec(nSupportedCodecs, &acmCodec)) {
+    ++nSupportedCodecs;
+  }
+  return nSupportedCodecs;
 }
 
 int VoECodecImpl::GetCodec(int index, CodecInst& codec) {
   CodecInst acmCodec;
-  if (AudioCodingModule::Codec(index, &acmCodec) == -1) {
+  if (!GetPlayableCodec(index, &acmCodec)) {
     _shared->SetLastError(VE_INVALID_LISTNR, kTraceError,
                           "GetCodec() invalid index");
     return -1;
@@ -81,6 +81,27 @@ int VoENetEqStatsImpl::GetDecodingCallStatistics(
   return 0;
 }
 
+int VoENetEqStatsImpl::GetAudioPipelineStatistics(
+    int channel, AudioPipelineStatistics* stats) const {
+  if (!_shared->statistics().Initialized()) {
+    _shared->SetLastError(VE_NOT_INITED, kTraceError);
+    return -1;
+  }
+  voe::ChannelOwner ch = _shared->channel_manager().GetChannel(channel);
+  voe::Channel* channelPtr = ch.channel();
+  if (channelPtr == NULL) {
+    _shared->SetLastError(VE_CHANNEL_NOT_VALID, kTraceError,
+                          "GetAudioPipelineStatistics() failed to locate "
+                          "channel");
+    return -1;
+  }
+
+  *stats = AudioPipelineStatistics();
+  _shared->latency_tracker().GetStatistics(stats);
+  channelPtr->GetAudioPipelineStatistics(stats);
+  return 0;
+}
+
 #endif  // #ifdef WEBRTC_VOICE_ENGINE_NETEQ_STATS_API
 
 }  // namespace webrtc
@@ -25,6 +25,9 @@ class VoENetEqStatsImpl : public VoENetEqStats {
   int GetDecodingCallStatistics(int channel,
                                 AudioDecodingCallStats* stats) const override;
 
+  int GetAudioPipelineStatistics(int channel,
+                                 AudioPipelineStatistics* stats) const override;
+
  protected:
   VoENetEqStatsImpl(voe::SharedData* shared);
   ~VoENetEqStatsImpl() override;
@@ -42,6 +42,8 @@
         'include/voe_rtp_rtcp.h',
         'include/voe_video_sync.h',
         'include/voe_volume_control.h',
+        'audio_latency_tracker.cc',
+        'audio_latency_tracker.h',
         'channel.cc',
         'channel.h',
         'channel_manager.cc',
@@ -123,6 +125,7 @@
             '<(webrtc_root)/test/test.gyp:test_support_main',
           ],
           'sources': [
+            'audio_latency_tracker_unittest.cc',
             'channel_unittest.cc',
             'network_predictor_unittest.cc',
             'transmit_mixer_unittest.cc',